@@ -275,9 +275,10 @@ void AnalysisFlowController::stop()
     }
 
     // フォールバック: AnalysisCoordinator::analysisFinished が返らない場合
+    // （再利用できるエンジンは EngineProcessPool へ返し、それ以外は終了させる）
     m_running = false;
     if (m_usi) {
-        m_usi->sendQuitCommand();
+        m_usi->cleanupEngineProcessAndThread(false);
     }
 
     if (m_presenter) {
@@ -399,9 +400,9 @@ void AnalysisFlowController::onAnalysisFinished(AnalysisCoordinator::Mode /*mode
 
     m_running = false;
 
-    // エンジンプロセスを終了させる
+    // エンジンプロセスを手放す（待機状態で EngineProcessPool へ返すか、終了させる）
     if (m_usi) {
-        m_usi->sendQuitCommand();
+        m_usi->cleanupEngineProcessAndThread(false);
     }
 
     if (m_presenter) {
@@ -475,7 +476,7 @@ bool AnalysisFlowController::runWithDialog(const Deps& d, QWidget* parent)
                 QObject::disconnect(m_connUsiError);
                 m_connUsiError = {};
             }
-            m_usi->sendQuitCommand();
+            m_usi->cleanupEngineProcessAndThread(false);
             m_usi->blockSignals(true);
             m_usi->deleteLater();
             m_usi = nullptr;
@@ -0,0 +1,215 @@
+/// @file tsumematesolver.cpp
+/// @brief 内蔵詰み探索ラッパの実装
+
+#include "tsumematesolver.h"
+
+#include "fmvconverter.h"
+#include "fmvlegalcore.h"
+#include "fmvmatesolver.h"
+#include "logcategories.h"
+#include "sfenutils.h"
+
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// スレッドごとのソルバ（置換表サイズが変わったときだけ作り直す）
+fmv::MateSolver& threadSolver(int hashMiB)
+{
+    thread_local std::unique_ptr<fmv::MateSolver> solver;
+    thread_local int solverHashMiB = 0;
+    if (!solver || solverHashMiB != hashMiB) {
+        solver = std::make_unique<fmv::MateSolver>(static_cast<std::size_t>(qMax(1, hashMiB)));
+        solverHashMiB = hashMiB;
+    }
+    return *solver;
+}
+
+/// 局面文字列を解析し、玉方の玉がある局面だけを受け付ける
+bool parseTsumePosition(const QString& position, fmv::EnginePosition& pos, fmv::Color& attacker)
+{
+    if (!TsumeMateSolver::parsePosition(position, pos, attacker)
+        || pos.kingSq[static_cast<int>(fmv::opposite(attacker))] == fmv::kInvalidSquare) {
+        qCDebug(lcAnalysis).noquote() << "TsumeMateSolver: invalid position:" << position;
+        return false;
+    }
+    return true;
+}
+
+void appendUsiPv(QStringList& out, const std::vector<fmv::Move>& pv)
+{
+    out.reserve(static_cast<qsizetype>(pv.size()));
+    for (const fmv::Move& m : pv) {
+        out.append(fmv::Converter::toUsi(m));
+    }
+}
+
+/// 解析済み局面の前判定（玉方に王手 → InvalidPosition、攻方の王手が0手 → NoMate、それ以外は Unknown）
+TsumeMateSolver::Status prefilterParsed(fmv::EnginePosition& pos, fmv::Color attacker)
+{
+    const fmv::LegalCore core;
+    if (core.countChecksToKing(pos, fmv::opposite(attacker)) > 0) {
+        return TsumeMateSolver::Status::InvalidPosition;
+    }
+    fmv::MoveList checks;
+    core.generateCheckMoves(pos, attacker, checks);
+    return checks.size == 0 ? TsumeMateSolver::Status::NoMate : TsumeMateSolver::Status::Unknown;
+}
+
+/// 解析済み局面を df-pn で解く
+TsumeMateSolver::Result solveParsed(const fmv::EnginePosition& pos, fmv::Color attacker,
+                                    const TsumeMateSolver::Limits& limits, const CancelFlag& cancel)
+{
+    TsumeMateSolver::Result result;
+    fmv::MateLimits mateLimits;
+    mateLimits.maxPly = limits.maxPly;
+    mateLimits.timeLimitMs = limits.timeLimitMs;
+    mateLimits.maxNodes = limits.maxNodes;
+    const fmv::MateResult r = threadSolver(limits.hashMiB).solve(pos, attacker, mateLimits, cancel.get());
+
+    switch (r.status) {
+    case fmv::MateStatus::Mate:
+        result.status = TsumeMateSolver::Status::Mate;
+        break;
+    case fmv::MateStatus::NoMate:
+        result.status = TsumeMateSolver::Status::NoMate;
+        break;
+    case fmv::MateStatus::Unknown:
+        result.status = TsumeMateSolver::Status::Unknown;
+        break;
+    }
+    appendUsiPv(result.pv, r.pv);
+    result.nodes = r.nodes;
+    return result;
+}
+
+} // namespace
+
+bool TsumeMateSolver::parsePosition(const QString& position, fmv::EnginePosition& pos, fmv::Color& side)
+{
+    QStringView rest = QStringView(position).trimmed();
+    if (rest.startsWith(QLatin1String("position "))) {
+        rest = rest.mid(9).trimmed();
+    }
+
+    QStringView movesPart;
+    const qsizetype movesAt = rest.indexOf(QLatin1String(" moves"));
+    if (movesAt >= 0) {
+        movesPart = rest.mid(movesAt + 6).trimmed();
+        rest = rest.left(movesAt).trimmed();
+    }
+
+    const QString hirate = SfenUtils::hirateSfen();
+    if (rest == QLatin1String("startpos")) {
+        rest = hirate;
+    } else if (rest.startsWith(QLatin1String("sfen "))) {
+        rest = rest.mid(5).trimmed();
+    }
+    if (!fmv::Converter::fromSfen(pos, side, rest)) {
+        return false;
+    }
+
+    const fmv::LegalCore core;
+    for (const QStringView usi : movesPart.split(QLatin1Char(' '), Qt::SkipEmptyParts)) {
+        fmv::Move m = fmv::Move::none();
+        fmv::UndoState undo;
+        if (!fmv::Converter::fromUsi(m, pos, usi) || !core.tryApplyLegalMove(pos, side, m, undo)) {
+            return false;
+        }
+        side = fmv::opposite(side);
+    }
+    return true;
+}
+
+TsumeMateSolver::Result TsumeMateSolver::solve(const QString& position, const Limits& limits,
+                                               const CancelFlag& cancel)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    fmv::EnginePosition pos;
+    fmv::Color attacker = fmv::Color::Black;
+    if (!parseTsumePosition(position, pos, attacker)) {
+        Result result;
+        result.status = Status::InvalidPosition;
+        return result;
+    }
+
+    Result result = solveParsed(pos, attacker, limits, cancel);
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+TsumeMateSolver::Result TsumeMateSolver::solveExact(const QString& position, const Limits& limits,
+                                                    const CancelFlag& cancel)
+{
+    QElapsedTimer timer;
+    timer.start();
+    Result result;
+
+    fmv::EnginePosition pos;
+    fmv::Color attacker = fmv::Color::Black;
+    if (!parseTsumePosition(position, pos, attacker)) {
+        result.status = Status::InvalidPosition;
+        return result;
+    }
+
+    // 前判定: 手番でない玉方に王手がかかっている局面は不正、攻方に王手がなければ詰まない
+    const Status pre = prefilterParsed(pos, attacker);
+    if (pre != Status::Unknown) {
+        result.status = pre;
+        result.elapsedMs = timer.elapsed();
+        return result;
+    }
+
+    // 1手・3手以内は全幅で読み切る（目標がその手数以内なら判定もここで終わる）
+    const int target = limits.maxPly;
+    const int shortPly = target > 0 && target <= 3 ? target : 3;
+    std::vector<fmv::Move> shortPv;
+    if (fmv::findShortMate(pos, attacker, shortPly, shortPv)) {
+        result.status = Status::Mate;
+        appendUsiPv(result.pv, shortPv);
+        result.elapsedMs = timer.elapsed();
+        return result;
+    }
+    if (target > 0 && target <= 3) {
+        result.status = Status::NoMate;
+        result.elapsedMs = timer.elapsed();
+        return result;
+    }
+
+    // 5手以上 target-2 手以内の詰みを除く。短い詰みがなければ target 手以内の詰みはちょうど target 手
+    if (target > 5) {
+        Limits shorter = limits;
+        shorter.maxPly = target - 2;
+        result = solveParsed(pos, attacker, shorter, cancel);
+        if (result.status != Status::NoMate) {
+            result.elapsedMs = timer.elapsed();
+            return result;
+        }
+    }
+    result = solveParsed(pos, attacker, limits, cancel);
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+TsumeMateSolver::Status TsumeMateSolver::prefilter(const QString& position)
+{
+    fmv::EnginePosition pos;
+    fmv::Color attacker = fmv::Color::Black;
+    if (!parseTsumePosition(position, pos, attacker)) {
+        return Status::InvalidPosition;
+    }
+    return prefilterParsed(pos, attacker);
+}
+
+QFuture<TsumeMateSolver::Result> TsumeMateSolver::solveAsync(const QString& position, const Limits& limits,
+                                                             const CancelFlag& cancel)
+{
+    return QtConcurrent::run([position, limits, cancel]() {
+        return solve(position, limits, cancel);
+    });
+}
@@ -0,0 +1,78 @@
+#ifndef TSUMEMATESOLVER_H
+#define TSUMEMATESOLVER_H
+
+/// @file tsumematesolver.h
+/// @brief 内蔵詰み探索（fmv::MateSolver）の USI 局面向けラッパの定義
+
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+
+#include "fmvposition.h"
+#include "fmvtypes.h"
+#include "threadtypes.h"
+
+/**
+ * @brief USI エンジンを起動せずに詰みを調べる
+ *
+ * `position ...` 文字列（または SFEN）を fmv 局面に復元し、手番側を攻方として
+ * df-pn ソルバで解く。結果の手順は `go mate` の `checkmate` 応答と同じ USI 形式で返す。
+ * 置換表はスレッドごとに1つ確保して使い回す（同じスレッドで続けて解くときに確保し直さない）。
+ */
+class TsumeMateSolver
+{
+public:
+    enum class Status {
+        Mate,            ///< 詰みあり
+        NoMate,          ///< 不詰（手数制限つきなら制限内に詰みなし）
+        Unknown,         ///< ノード数・時間の上限、または中断
+        InvalidPosition  ///< 局面文字列を解釈できない、または玉方の玉がない
+    };
+
+    struct Limits {
+        int maxPly = 0;          ///< 詰み手数の上限（0 = 無制限）
+        int timeLimitMs = 0;     ///< 探索時間の上限(ms)（0 = 無制限）
+        quint64 maxNodes = 0;    ///< 展開ノード数の上限（0 = 無制限）
+        int hashMiB = 16;        ///< 置換表のサイズ(MiB)
+    };
+
+    struct Result {
+        Status status = Status::Unknown;
+        QStringList pv;          ///< USI 形式の詰み手順
+        quint64 nodes = 0;
+        qint64 elapsedMs = 0;
+    };
+
+    /// 呼び出しスレッドで解く（cancel が立つと Unknown で戻る）
+    static Result solve(const QString& position, const Limits& limits, const CancelFlag& cancel = {});
+
+    /**
+     * @brief limits.maxPly 手ちょうどで詰むかを調べる（詰将棋生成の判定用）
+     *
+     * 玉方に王手がかかった局面は InvalidPosition、王手が1つもなければ NoMate として探索を省く。
+     * 1手・3手以内の詰みは fmv::findShortMate の全幅探索で先に確かめ、それより長い短手数の詰みは
+     * 手数制限 maxPly-2 の df-pn で確かめる。短い詰みがあればその手順を Mate で返すので、
+     * 呼び出し側は pv の長さが maxPly と一致するかで判定する。
+     */
+    static Result solveExact(const QString& position, const Limits& limits, const CancelFlag& cancel = {});
+
+    /**
+     * @brief 探索前の安い絞り込み（詰将棋生成で候補局面を solveExact に回す前に使う）
+     *
+     * 玉方に王手がかかった局面は InvalidPosition、攻方の王手になる合法手の数が 0 なら NoMate を返す。
+     * どちらでもなければ Unknown（探索が必要）を返す。
+     */
+    static Status prefilter(const QString& position);
+
+    /// スレッドプールで解く
+    static QFuture<Result> solveAsync(const QString& position, const Limits& limits,
+                                      const CancelFlag& cancel = {});
+
+    /**
+     * @brief `position sfen ... [moves ...]` / `position startpos [moves ...]` / `sfen ...` / SFEN を局面に復元する
+     * @return 構文・指し手が正しければ true（side は最終局面の手番）
+     */
+    static bool parsePosition(const QString& position, fmv::EnginePosition& pos, fmv::Color& side);
+};
+
+#endif // TSUMEMATESOLVER_H
@@ -8,9 +8,14 @@
 #include "tsumeshogisearchdialog.h"
 #include "matchcoordinator.h"
 #include "tsumepositionutil.h"
+#include "tsumematesolver.h"
 
 #include <QObject>
 #include <QDialog>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QMessageBox>
+#include <QProgressDialog>
 #include <QtGlobal>
 
 TsumeSearchFlowController::TsumeSearchFlowController(QObject* parent)
@@ -48,6 +53,16 @@ bool TsumeSearchFlowController::runWithDialog(const Deps& d, QWidget* parent)
         byoyomiMs = dlg.byoyomiSec() * 1000;  // 秒 → ms
     }
 
+    // 内蔵ソルバーはエンジンを起動しない
+    if (engine.builtin) {
+        runBuiltinSolver(pos, byoyomiMs, parent);
+        return false;
+    }
+    if (engine.path.isEmpty()) {
+        if (d.onError) d.onError(QStringLiteral("エンジン「%1」の実行ファイルが設定されていません。").arg(engine.name));
+        return false;
+    }
+
     startAnalysis(d.match, engine.path, engine.name, pos, byoyomiMs);
     return true;
 }
@@ -87,3 +102,50 @@ void TsumeSearchFlowController::startAnalysis(MatchCoordinator* match,
 
     match->startAnalysis(opt);
 }
+
+void TsumeSearchFlowController::runBuiltinSolver(const QString& positionStr, int byoyomiMs, QWidget* parent)
+{
+    TsumeMateSolver::Limits limits;
+    limits.timeLimitMs = byoyomiMs;
+    const CancelFlag cancel = makeCancelFlag();
+
+    QProgressDialog progress(tr("内蔵ソルバーで詰みを探索しています..."), tr("中止"), 0, 0, parent);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(300);
+
+    QFutureWatcher<TsumeMateSolver::Result> watcher;
+    QEventLoop loop;
+    connect(&watcher, &QFutureWatcher<TsumeMateSolver::Result>::finished, &loop, &QEventLoop::quit);
+    connect(&progress, &QProgressDialog::canceled, &loop, &QEventLoop::quit);
+    watcher.setFuture(TsumeMateSolver::solveAsync(positionStr, limits, cancel));
+    if (!watcher.isFinished()) {
+        loop.exec();
+    }
+    if (!watcher.isFinished()) {
+        // 中止: ソルバーに打ち切らせて途中結果を待つ
+        cancel->store(true);
+        watcher.waitForFinished();
+    }
+    progress.reset();
+
+    const TsumeMateSolver::Result r = watcher.result();
+    qCDebug(lcAnalysis).noquote() << "builtin mate solver: status=" << static_cast<int>(r.status)
+                                  << "nodes=" << r.nodes << "elapsedMs=" << r.elapsedMs;
+
+    QString message;
+    switch (r.status) {
+    case TsumeMateSolver::Status::Mate:
+        message = tr("詰みあり（手順 %1 手）").arg(r.pv.size()) + QLatin1Char('\n') + r.pv.join(QLatin1Char(' '));
+        break;
+    case TsumeMateSolver::Status::NoMate:
+        message = tr("詰みなし");
+        break;
+    case TsumeMateSolver::Status::Unknown:
+        message = cancel->load() ? tr("探索を中止しました") : tr("不明（解析不能）");
+        break;
+    case TsumeMateSolver::Status::InvalidPosition:
+        message = tr("詰み探索用の局面を解釈できません。");
+        break;
+    }
+    QMessageBox::information(parent, tr("詰み探索"), message);
+}
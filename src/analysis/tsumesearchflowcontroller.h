@@ -17,6 +17,7 @@ class MatchCoordinator;
  *
  * 探索開始局面を組み立て、ユーザーのダイアログ入力に基づいて
  * MatchCoordinatorへ探索開始を委譲する。
+ * 内蔵ソルバーが選ばれた場合はエンジンを起動せず、その場で解いて結果を表示する。
  *
  */
 class TsumeSearchFlowController : public QObject
@@ -38,7 +39,8 @@ public:
     explicit TsumeSearchFlowController(QObject* parent=nullptr);
 
     /// ダイアログ表示後、詰み探索を開始する
-    /// @return 探索が開始された場合は true、キャンセルやエラーで中止された場合は false
+    /// @return エンジンでの探索が開始された場合は true。キャンセル・エラー、
+    ///         または内蔵ソルバーで解き終えた場合は false
     bool runWithDialog(const Deps& d, QWidget* parent);
 
 private:
@@ -51,6 +53,9 @@ private:
                         const QString& engineName,
                         const QString& positionStr,
                         int byoyomiMs);
+
+    /// 内蔵ソルバーで解き、終わるまで進捗ダイアログを出して結果を表示する
+    void runBuiltinSolver(const QString& positionStr, int byoyomiMs, QWidget* parent);
 };
 
 #endif // TSUMESEARCHFLOWCONTROLLER_H
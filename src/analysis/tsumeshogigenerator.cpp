@@ -30,7 +30,10 @@ QStringList generatePositionBatch(const TsumeshogiPositionGenerator::Settings& s
         TsumeshogiPositionGenerator generator;
         generator.setSettings(settings);
         const QString sfen = generator.generate();
-        if (!sfen.isEmpty()) {
+        // 玉方に王手がかかった局面・攻方に王手がない局面はソルバ（エンジン）に送るまでもない
+        if (!sfen.isEmpty()
+            && TsumeMateSolver::prefilter(QStringLiteral("position sfen ") + sfen)
+                   == TsumeMateSolver::Status::Unknown) {
             result.append(sfen);
         }
     }
@@ -48,6 +51,8 @@ TsumeshogiGenerator::TsumeshogiGenerator(QObject* parent)
     connect(&m_progressTimer, &QTimer::timeout, this, &TsumeshogiGenerator::onProgressTimerTimeout);
     connect(&m_batchWatcher, &QFutureWatcher<QStringList>::finished,
             this, &TsumeshogiGenerator::onBatchReady);
+    connect(&m_solveWatcher, &QFutureWatcher<TsumeMateSolver::Result>::finished,
+            this, &TsumeshogiGenerator::onBuiltinSolveFinished);
 }
 
 TsumeshogiGenerator::~TsumeshogiGenerator()
@@ -67,23 +72,8 @@ void TsumeshogiGenerator::start(const Settings& settings)
 
     m_positionGenerator.setSettings(settings.posGenSettings);
 
-    // Usi インスタンスを作成（モデル不要、ゲームコントローラ不要）
-    m_usi = std::make_unique<Usi>(nullptr, nullptr, nullptr, this);
-
-    // checkmate シグナルを接続
-    connect(m_usi.get(), &Usi::checkmateSolved,
-            this, &TsumeshogiGenerator::onCheckmateSolved);
-    connect(m_usi.get(), &Usi::checkmateNoMate,
-            this, &TsumeshogiGenerator::onCheckmateNoMate);
-    connect(m_usi.get(), &Usi::checkmateNotImplemented,
-            this, &TsumeshogiGenerator::onCheckmateNotImplemented);
-    connect(m_usi.get(), &Usi::checkmateUnknown,
-            this, &TsumeshogiGenerator::onCheckmateUnknown);
-    connect(m_usi.get(), &Usi::errorOccurred,
-            this, &TsumeshogiGenerator::errorOccurred);
-
-    // エンジン起動
-    if (!m_usi->startAndInitializeEngine(settings.enginePath, settings.engineName)) {
+    // 内蔵ソルバはプロセスを持たないので、エンジンの起動・接続を丸ごと省く
+    if (!settings.useBuiltinSolver && !startEngine(settings)) {
         m_phase = Phase::Idle;
         cleanup();
         emit finished();
@@ -99,10 +89,37 @@ void TsumeshogiGenerator::start(const Settings& settings)
     m_elapsedTimer.start();
     m_progressTimer.start(kProgressIntervalMs);
 
+    // 並列モードは各ワーカーが自前で局面を生成するので、共有キューのバッチ生成は使わない
+    if (isParallel()) {
+        startWorkers();
+        return;
+    }
+
     // バッチ生成を開始し、完了後に最初の局面を送信する
     startBatchGeneration();
 }
 
+bool TsumeshogiGenerator::startEngine(const Settings& settings)
+{
+    // Usi インスタンスを作成（モデル不要、ゲームコントローラ不要）
+    m_usi = std::make_unique<Usi>(nullptr, nullptr, nullptr, this);
+
+    // checkmate シグナルを接続
+    connect(m_usi.get(), &Usi::checkmateSolved,
+            this, &TsumeshogiGenerator::onCheckmateSolved);
+    connect(m_usi.get(), &Usi::checkmateNoMate,
+            this, &TsumeshogiGenerator::onCheckmateNoMate);
+    connect(m_usi.get(), &Usi::checkmateNotImplemented,
+            this, &TsumeshogiGenerator::onCheckmateNotImplemented);
+    connect(m_usi.get(), &Usi::checkmateUnknown,
+            this, &TsumeshogiGenerator::onCheckmateUnknown);
+    connect(m_usi.get(), &Usi::errorOccurred,
+            this, &TsumeshogiGenerator::errorOccurred);
+
+    // エンジン起動
+    return m_usi->startAndInitializeEngine(settings.enginePath, settings.engineName);
+}
+
 void TsumeshogiGenerator::stop()
 {
     if (m_phase == Phase::Idle) return;
@@ -212,6 +229,9 @@ void TsumeshogiGenerator::onSafetyTimeout()
 void TsumeshogiGenerator::onProgressTimerTimeout()
 {
     emit progressUpdated(m_triedCount, m_foundCount, m_elapsedTimer.elapsed());
+    if (!m_workers.empty()) {
+        emit workerStatsUpdated(collectWorkerStats());
+    }
 }
 
 // ======================================================================
@@ -238,6 +258,11 @@ void TsumeshogiGenerator::generateAndSendNext()
         startBatchGeneration();
     }
 
+    if (m_settings.useBuiltinSolver) {
+        startBuiltinSolve(m_currentSfen);
+        return;
+    }
+
     // ThinkingInfoPresenter が info 行を処理する際に盤面データが必要
     // ダミーの盤面データ（81マス空欄）を設定してクラッシュを防ぐ
     QList<QChar> dummyBoard(BoardConstants::kNumBoardSquares, QChar(' '));
@@ -287,7 +312,9 @@ void TsumeshogiGenerator::cleanup()
         m_usi.reset();
     }
 
-    // バッチ生成状態をクリア
+    // バッチ生成・並列ワーカーの残りのジョブを止めて状態をクリア
+    // （ワーカーの監視オブジェクトは完了通知の中から呼ばれうるので、次の start() まで残す）
+    if (m_cancelFlag) m_cancelFlag->store(true);
     m_positionQueue.clear();
     m_waitingForPositions = false;
     m_cancelFlag.reset();
@@ -364,6 +391,11 @@ void TsumeshogiGenerator::tryNextTrimCandidate()
 
 void TsumeshogiGenerator::sendTrimmingCheck(const QString& modifiedSfen)
 {
+    if (m_settings.useBuiltinSolver) {
+        startBuiltinSolve(modifiedSfen);
+        return;
+    }
+
     QList<QChar> dummyBoard(BoardConstants::kNumBoardSquares, QChar(' '));
     m_usi->setClonedBoardData(dummyBoard);
 
@@ -380,3 +412,40 @@ void TsumeshogiGenerator::finishTrimmingPhase()
     m_phase = Phase::Searching;
     processResult(true, m_trimBasePv);
 }
+
+// ======================================================================
+// 内蔵ソルバ
+// ======================================================================
+
+void TsumeshogiGenerator::startBuiltinSolve(const QString& sfen)
+{
+    TsumeMateSolver::Limits limits;
+    limits.maxPly = m_settings.targetMoves;
+    limits.timeLimitMs = m_settings.timeoutMs;
+    const QString position = QStringLiteral("position sfen ") + sfen;
+    const auto cancelFlag = m_cancelFlag;
+
+    // 目標より短い詰みがあればその手順が返り、「ちょうどN手」の判定で弾かれる
+    m_solveWatcher.setFuture(QtConcurrent::run([position, limits, cancelFlag]() {
+        return TsumeMateSolver::solveExact(position, limits, cancelFlag);
+    }));
+}
+
+void TsumeshogiGenerator::onBuiltinSolveFinished()
+{
+    if (m_phase == Phase::Idle) return;
+
+    const TsumeMateSolver::Result r = m_solveWatcher.result();
+    switch (r.status) {
+    case TsumeMateSolver::Status::Mate:
+        onCheckmateSolved(r.pv);
+        break;
+    case TsumeMateSolver::Status::NoMate:
+        onCheckmateNoMate();
+        break;
+    case TsumeMateSolver::Status::Unknown:
+    case TsumeMateSolver::Status::InvalidPosition:
+        onCheckmateUnknown();
+        break;
+    }
+}
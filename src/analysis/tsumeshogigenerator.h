@@ -4,6 +4,7 @@
 /// @file tsumeshogigenerator.h
 /// @brief 詰将棋局面自動生成オーケストレータの定義
 
+#include "tsumematesolver.h"
 #include "tsumeshogipositiongenerator.h"
 
 #include <QElapsedTimer>
@@ -13,6 +14,7 @@
 #include <QTimer>
 #include <QList>
 #include <memory>
+#include <vector>
 
 #include "threadtypes.h"
 
@@ -24,6 +26,10 @@ class Usi;
  * ランダム局面生成→エンジン詰み探索→結果フィルタリングのループを制御する。
  * 有効局面発見後は不要駒トリミングを行い、最小限の駒で構成された局面を出力する。
  * Usiインスタンスを直接作成・管理し、signal-drivenループで次々に局面を送信する。
+ * Settings::useBuiltinSolver のときはエンジンを起動せず、内蔵ソルバ（TsumeMateSolver）を
+ * スレッドプールで走らせて同じ応答スロットへ結果を流す。
+ * さらに workerCount が 2 以上なら、生成・前判定・詰み判定・トリミングまでを1つのジョブとして
+ * workerCount 本を並行に回す（tsumeshogigenerator_parallel.cpp）。
  */
 class TsumeshogiGenerator : public QObject
 {
@@ -36,9 +42,18 @@ public:
         int targetMoves = 3;         ///< 目標手数（奇数: 1,3,5,7,...）
         int timeoutMs = 5000;        ///< 1局面あたりの探索時間(ms)
         int maxPositionsToFind = 10; ///< 見つける局面数の上限（0=無制限）
+        bool useBuiltinSolver = false; ///< true ならエンジンの代わりに内蔵ソルバで解く
+        int workerCount = 1;         ///< 内蔵ソルバの並列ワーカー数（1=逐次、エンジン使用時は無視）
         TsumeshogiPositionGenerator::Settings posGenSettings;
     };
 
+    /// 並列ワーカーごとの集計
+    struct WorkerStats {
+        int tried = 0;                 ///< 判定した局面数
+        int found = 0;                 ///< 採用した局面数
+        double positionsPerSec = 0.0;  ///< 判定速度（局面/秒）
+    };
+
     explicit TsumeshogiGenerator(QObject* parent = nullptr);
     ~TsumeshogiGenerator() override;
 
@@ -49,6 +64,7 @@ public:
 signals:
     void positionFound(const QString& sfen, const QStringList& pv);
     void progressUpdated(int tried, int found, qint64 elapsedMs);
+    void workerStatsUpdated(const QList<TsumeshogiGenerator::WorkerStats>& stats);
     void finished();
     void errorOccurred(const QString& message);
 
@@ -60,6 +76,7 @@ private slots:
     void onSafetyTimeout();
     void onProgressTimerTimeout();
     void onBatchReady();
+    void onBuiltinSolveFinished();
 
 private:
     /// 状態機械
@@ -75,6 +92,20 @@ private:
         bool promoted = false;   ///< Board時: 成駒か
     };
 
+    /// 並列ワーカーの1ジョブ分の結果
+    struct WorkerChunk {
+        int tried = 0;           ///< このジョブで判定した局面数
+        QString sfen;            ///< 採用した（トリミング済みの）局面。なければ空
+        QStringList pv;
+    };
+
+    /// 並列ワーカーの状態（GUIスレッドだけが触る）
+    struct Worker {
+        QFutureWatcher<WorkerChunk> watcher;
+        int tried = 0;
+        int found = 0;
+    };
+
     /// SFEN解析結果
     struct ParsedSfen {
         QString cells[9][9];     ///< [rank][file] = "" or "P"/"+R"/"p" etc.
@@ -82,6 +113,9 @@ private:
         int goteHand[7] = {};    ///< P,L,N,S,G,B,R の後手持駒数
     };
 
+    // エンジン起動（シグナル接続を含む）
+    bool startEngine(const Settings& settings);
+
     // バッチ生成
     void startBatchGeneration();
 
@@ -91,23 +125,37 @@ private:
     void cleanup();
 
     // SFEN解析・再構築
-    ParsedSfen parseSfen(const QString& sfen) const;
-    QString buildSfenFromParsed(const ParsedSfen& parsed) const;
+    static ParsedSfen parseSfen(const QString& sfen);
+    static QString buildSfenFromParsed(const ParsedSfen& parsed);
 
     // 駒種変換
     static int pieceCharToIndex(QChar upper);
     static QChar indexToPieceChar(int idx);
 
     // トリミング操作
-    QList<TrimCandidate> enumerateRemovablePieces(const QString& sfen) const;
-    QString removePieceFromSfen(const QString& sfen, const TrimCandidate& candidate) const;
+    static QList<TrimCandidate> enumerateRemovablePieces(const QString& sfen);
+    static QString removePieceFromSfen(const QString& sfen, const TrimCandidate& candidate);
 
     // トリミングフェーズ制御
     void startTrimmingPhase(const QString& sfen, const QStringList& pv);
     void tryNextTrimCandidate();
     void sendTrimmingCheck(const QString& modifiedSfen);
+
+    // 内蔵ソルバ
+    void startBuiltinSolve(const QString& sfen);
     void finishTrimmingPhase();
 
+    // 並列パイプライン（内蔵ソルバ・workerCount >= 2）
+    bool isParallel() const;
+    void startWorkers();
+    void startWorkerChunk(int index);
+    void onWorkerChunkFinished();
+    void handleWorkerChunk(int index);
+    QList<WorkerStats> collectWorkerStats() const;
+    static WorkerChunk runWorkerChunk(const Settings& settings, const CancelFlag& cancelFlag);
+    static void trimInParallel(QString& sfen, QStringList& pv, const Settings& settings,
+                               const CancelFlag& cancelFlag);
+
     std::unique_ptr<Usi> m_usi;
     TsumeshogiPositionGenerator m_positionGenerator;
     Settings m_settings;
@@ -127,6 +175,9 @@ private:
     CancelFlag m_cancelFlag;                     ///< バッチ生成のキャンセルフラグ
     bool m_waitingForPositions = false;          ///< キュー空で生成待ちフラグ
 
+    QFutureWatcher<TsumeMateSolver::Result> m_solveWatcher; ///< 内蔵ソルバの非同期監視
+    std::vector<std::unique_ptr<Worker>> m_workers;         ///< 並列ワーカー（並列モードのみ）
+
     // トリミング用状態
     QString m_trimBaseSfen;                  ///< トリミング元のSFEN
     QStringList m_trimBasePv;                ///< トリミング元のPV
@@ -0,0 +1,192 @@
+/// @file tsumeshogigenerator_parallel.cpp
+/// @brief 詰将棋局面生成の並列パイプライン（内蔵ソルバ・複数ワーカー）
+
+#include "tsumeshogigenerator.h"
+
+#include <QtConcurrent>
+
+namespace {
+/// 1ジョブの目安時間(ms)。超えたら次の局面に進まずに集計を返す（進捗と停止の粒度）
+constexpr qint64 kWorkerChunkMs = 250;
+
+TsumeMateSolver::Limits solverLimits(const TsumeshogiGenerator::Settings& settings)
+{
+    TsumeMateSolver::Limits limits;
+    limits.maxPly = settings.targetMoves;
+    limits.timeLimitMs = settings.timeoutMs;
+    return limits;
+}
+
+QString positionCommand(const QString& sfen)
+{
+    return QStringLiteral("position sfen ") + sfen;
+}
+
+bool isExactMate(const TsumeMateSolver::Result& result, int targetMoves)
+{
+    return result.status == TsumeMateSolver::Status::Mate && result.pv.size() == targetMoves;
+}
+
+bool isCancelled(const CancelFlag& cancelFlag)
+{
+    return cancelFlag && cancelFlag->load();
+}
+} // namespace
+
+bool TsumeshogiGenerator::isParallel() const
+{
+    return m_settings.useBuiltinSolver && m_settings.workerCount > 1;
+}
+
+void TsumeshogiGenerator::startWorkers()
+{
+    m_workers.clear();
+    const int count = qMax(1, m_settings.workerCount);
+    m_workers.reserve(static_cast<std::size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        auto worker = std::make_unique<Worker>();
+        connect(&worker->watcher, &QFutureWatcher<WorkerChunk>::finished,
+                this, &TsumeshogiGenerator::onWorkerChunkFinished);
+        m_workers.push_back(std::move(worker));
+    }
+    for (int i = 0; i < count; ++i) {
+        startWorkerChunk(i);
+    }
+}
+
+void TsumeshogiGenerator::startWorkerChunk(int index)
+{
+    const Settings settings = m_settings;
+    const CancelFlag cancelFlag = m_cancelFlag;
+    m_workers.at(static_cast<std::size_t>(index))->watcher.setFuture(
+        QtConcurrent::run([settings, cancelFlag]() {
+            return runWorkerChunk(settings, cancelFlag);
+        }));
+}
+
+void TsumeshogiGenerator::onWorkerChunkFinished()
+{
+    // 終わったジョブのワーカーを送り元の watcher から探す
+    const QObject* source = sender();
+    for (std::size_t i = 0; i < m_workers.size(); ++i) {
+        if (&m_workers[i]->watcher == source) {
+            handleWorkerChunk(static_cast<int>(i));
+            return;
+        }
+    }
+}
+
+void TsumeshogiGenerator::handleWorkerChunk(int index)
+{
+    if (m_phase == Phase::Idle) return;
+
+    Worker& worker = *m_workers.at(static_cast<std::size_t>(index));
+    const WorkerChunk chunk = worker.watcher.result();
+    worker.tried += chunk.tried;
+    m_triedCount += chunk.tried;
+
+    if (!chunk.sfen.isEmpty()) {
+        ++worker.found;
+        ++m_foundCount;
+        emit positionFound(chunk.sfen, chunk.pv);
+
+        // 上限に達したら他のワーカーの結果は捨てる（cleanup でキャンセルされる）
+        if (m_settings.maxPositionsToFind > 0 && m_foundCount >= m_settings.maxPositionsToFind) {
+            m_phase = Phase::Idle;
+            emit progressUpdated(m_triedCount, m_foundCount, m_elapsedTimer.elapsed());
+            emit workerStatsUpdated(collectWorkerStats());
+            cleanup();
+            emit finished();
+            return;
+        }
+    }
+
+    startWorkerChunk(index);
+}
+
+QList<TsumeshogiGenerator::WorkerStats> TsumeshogiGenerator::collectWorkerStats() const
+{
+    const double elapsedSec = static_cast<double>(m_elapsedTimer.elapsed()) / 1000.0;
+    QList<WorkerStats> stats;
+    stats.reserve(static_cast<qsizetype>(m_workers.size()));
+    for (const auto& worker : m_workers) {
+        WorkerStats s;
+        s.tried = worker->tried;
+        s.found = worker->found;
+        s.positionsPerSec = elapsedSec > 0.0 ? worker->tried / elapsedSec : 0.0;
+        stats.append(s);
+    }
+    return stats;
+}
+
+TsumeshogiGenerator::WorkerChunk TsumeshogiGenerator::runWorkerChunk(const Settings& settings,
+                                                                      const CancelFlag& cancelFlag)
+{
+    WorkerChunk chunk;
+    TsumeshogiPositionGenerator generator;
+    generator.setSettings(settings.posGenSettings);
+    const TsumeMateSolver::Limits limits = solverLimits(settings);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!isCancelled(cancelFlag) && timer.elapsed() < kWorkerChunkMs) {
+        const QString sfen = generator.generate();
+        if (sfen.isEmpty()) {
+            continue;
+        }
+
+        // 王手の有無・攻方の王手数で絞ってから探索に回す（1手/3手詰めの判定は solveExact が先に行う）
+        const QString position = positionCommand(sfen);
+        if (TsumeMateSolver::prefilter(position) != TsumeMateSolver::Status::Unknown) {
+            continue;
+        }
+        ++chunk.tried;
+
+        const TsumeMateSolver::Result r = TsumeMateSolver::solveExact(position, limits, cancelFlag);
+        if (!isExactMate(r, settings.targetMoves)) {
+            continue;
+        }
+
+        chunk.sfen = sfen;
+        chunk.pv = r.pv;
+        trimInParallel(chunk.sfen, chunk.pv, settings, cancelFlag);
+        break;
+    }
+    return chunk;
+}
+
+void TsumeshogiGenerator::trimInParallel(QString& sfen, QStringList& pv, const Settings& settings,
+                                         const CancelFlag& cancelFlag)
+{
+    const TsumeMateSolver::Limits limits = solverLimits(settings);
+    const auto solveTrial = [limits, cancelFlag](const QString& trial) {
+        return TsumeMateSolver::solveExact(positionCommand(trial), limits, cancelFlag);
+    };
+
+    while (!isCancelled(cancelFlag)) {
+        const QList<TrimCandidate> candidates = enumerateRemovablePieces(sfen);
+        QStringList trials;
+        trials.reserve(candidates.size());
+        for (const TrimCandidate& candidate : candidates) {
+            trials.append(removePieceFromSfen(sfen, candidate));
+        }
+
+        // 除去候補をまとめて判定し、逐次版と同じく候補順で最初に成立したものを採る。
+        // 呼び出しスレッドも判定に加わるので、プールが埋まっていても待ち合わせにはならない。
+        const QList<TsumeMateSolver::Result> results =
+            QtConcurrent::blockingMapped<QList<TsumeMateSolver::Result>>(trials, solveTrial);
+
+        qsizetype accepted = -1;
+        for (qsizetype i = 0; i < results.size(); ++i) {
+            if (isExactMate(results.at(i), settings.targetMoves)) {
+                accepted = i;
+                break;
+            }
+        }
+        if (accepted < 0) {
+            return;
+        }
+        sfen = trials.at(accepted);
+        pv = results.at(accepted).pv;
+    }
+}
@@ -7,7 +7,7 @@ namespace {
 constexpr int kPieceTypeCount = 7; // P,L,N,S,G,B,R
 }
 
-TsumeshogiGenerator::ParsedSfen TsumeshogiGenerator::parseSfen(const QString& sfen) const
+TsumeshogiGenerator::ParsedSfen TsumeshogiGenerator::parseSfen(const QString& sfen)
 {
     ParsedSfen result;
 
@@ -77,7 +77,7 @@ TsumeshogiGenerator::ParsedSfen TsumeshogiGenerator::parseSfen(const QString& sf
     return result;
 }
 
-QString TsumeshogiGenerator::buildSfenFromParsed(const ParsedSfen& parsed) const
+QString TsumeshogiGenerator::buildSfenFromParsed(const ParsedSfen& parsed)
 {
     QString board;
     for (int r = 0; r < 9; ++r) {
@@ -164,7 +164,7 @@ QChar TsumeshogiGenerator::indexToPieceChar(int idx)
 }
 
 QList<TsumeshogiGenerator::TrimCandidate>
-TsumeshogiGenerator::enumerateRemovablePieces(const QString& sfen) const
+TsumeshogiGenerator::enumerateRemovablePieces(const QString& sfen)
 {
     QList<TrimCandidate> candidates;
     const ParsedSfen parsed = parseSfen(sfen);
@@ -213,7 +213,7 @@ TsumeshogiGenerator::enumerateRemovablePieces(const QString& sfen) const
 }
 
 QString TsumeshogiGenerator::removePieceFromSfen(
-    const QString& sfen, const TrimCandidate& candidate) const
+    const QString& sfen, const TrimCandidate& candidate)
 {
     ParsedSfen parsed = parseSfen(sfen);
 
@@ -45,6 +45,7 @@ class AnalysisResultsPresenter;
 class GameRecordPresenter;
 class TimeDisplayPresenter;
 class SfenCollectionDialog;
+class KifuDatabaseDialog;
 class GameInfoPaneController;
 class EvaluationGraphController;
 class TimeControlController;
@@ -174,6 +175,8 @@ private:
     CsaGameDialog* m_csaGameDialog = nullptr;
     // Lifecycle: Created once on first dialog open, destroyed with parent
     QPointer<SfenCollectionDialog> m_sfenCollectionDialog;
+    // Lifecycle: Created once on first dialog open, destroyed with parent
+    QPointer<KifuDatabaseDialog> m_kifuDatabaseDialog;
     CsaGameCoordinator* m_csaGameCoordinator = nullptr;
 
     // --- 試合進行 ---
@@ -29,6 +29,8 @@
 #include "timedisplaypresenter.h"
 #include "timecontrolcontroller.h"
 #include "shogiclock.h"
+#include "analysissettings.h"
+#include "engineprocesspool.h"
 
 // Signal wiring
 #include "kifuexportcontroller.h"
@@ -113,7 +115,9 @@ void MainWindow::runLifecycleShutdownInternal(bool& shutdownDone)
         }
     };
     // エンジンが起動していれば終了する（quit コマンドを送信してプロセスを停止）
+    // 先にプールを閉じ、待機中のエンジンも含めて全て終了させる
     steps.destroyEngines = [this]() {
+        EngineProcessPool::instance().shutdown();
         if (m_match) {
             m_match->destroyEngines();
         }
@@ -220,6 +224,11 @@ void MainWindow::initializeEarlyServicesForLifecycle()
     if (m_mw.m_timePresenter && m_mw.m_timeController) {
         m_mw.m_timePresenter->setClock(m_mw.m_timeController->clock());
     }
+
+    // 使い終わったエンジンを待機させるプールの上限
+    EngineProcessPool& pool = EngineProcessPool::instance();
+    pool.setMaxIdlePerEngine(AnalysisSettings::enginePoolIdlePerEngine());
+    pool.setIdleTimeoutMs(AnalysisSettings::enginePoolIdleTimeoutSec() * 1000);
 }
 
 void MainWindow::connectSignalsForLifecycle()
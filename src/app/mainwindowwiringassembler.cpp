@@ -58,6 +58,9 @@ void MainWindowServiceRegistry::initializeDialogLaunchWiring()
     // 局面集ダイアログ
     d.sfenCollectionDialog = &m_mw.m_sfenCollectionDialog;
 
+    // 棋譜データベースダイアログ
+    d.kifuDatabaseDialog = &m_mw.m_kifuDatabaseDialog;
+
     // CSA通信対局のエンジン評価値グラフ用
     d.getCsaGameCoordinator = [this]() { return m_mw.m_csaGameCoordinator; };
 
@@ -72,4 +75,7 @@ void MainWindowServiceRegistry::initializeDialogLaunchWiring()
     m_kifu->ensureKifuFileController();
     QObject::connect(m_mw.m_dialogLaunchWiring, &DialogLaunchWiring::sfenCollectionPositionSelected,
                      m_mw.m_kifuFileController, &KifuFileController::onSfenCollectionPositionSelected);
+    // シグナル中継: 棋譜データベースで選んだ対局の棋譜を開く
+    QObject::connect(m_mw.m_dialogLaunchWiring, &DialogLaunchWiring::kifuDatabaseGameSelected,
+                     m_mw.m_kifuFileController, &KifuFileController::loadKifuFile);
 }
@@ -0,0 +1,77 @@
+/// @file rotatinglogfile.cpp
+/// @brief サイズ上限付きでローテーションするログファイルの実装
+
+#include "rotatinglogfile.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+RotatingLogFile::RotatingLogFile(const QString& filePath, qint64 maxBytes, int maxBackups)
+    : m_filePath(filePath)
+    , m_maxBytes(qMax<qint64>(1, maxBytes))
+    , m_maxBackups(qMax(0, maxBackups))
+    , m_file(filePath)
+{
+}
+
+bool RotatingLogFile::open()
+{
+    if (m_file.isOpen()) return true;
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    return m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+}
+
+bool RotatingLogFile::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+QString RotatingLogFile::filePath() const
+{
+    return m_filePath;
+}
+
+QString RotatingLogFile::errorString() const
+{
+    return m_file.errorString();
+}
+
+QString RotatingLogFile::backupPath(int generation) const
+{
+    return generation == 0 ? m_filePath : m_filePath + QLatin1Char('.') + QString::number(generation);
+}
+
+bool RotatingLogFile::append(const QByteArray& data)
+{
+    if (!m_file.isOpen() || data.isEmpty()) return false;
+
+    if (m_file.write(data) != data.size()) return false;
+    m_file.flush();
+
+    if (m_file.size() >= m_maxBytes) {
+        rotate();
+    }
+    return true;
+}
+
+void RotatingLogFile::rotate()
+{
+    m_file.close();
+
+    if (m_maxBackups == 0) {
+        QFile::remove(m_filePath);
+    } else {
+        // 最古の世代を消してから、新しい順に1つずつずらす
+        QFile::remove(backupPath(m_maxBackups));
+        for (int generation = m_maxBackups - 1; generation >= 0; --generation) {
+            const QString from = backupPath(generation);
+            if (QFile::exists(from)) {
+                QFile::rename(from, backupPath(generation + 1));
+            }
+        }
+    }
+
+    m_file.setFileName(m_filePath);
+    m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
@@ -0,0 +1,51 @@
+#ifndef ROTATINGLOGFILE_H
+#define ROTATINGLOGFILE_H
+
+/// @file rotatinglogfile.h
+/// @brief サイズ上限付きでローテーションするログファイルの定義
+
+#include <QFile>
+#include <QString>
+
+/**
+ * @brief 追記専用のローテーション付きログファイル
+ *
+ * 書き込み後のサイズが maxBytes を超えたら、"name.log" → "name.log.1" → ... と
+ * 世代をずらし、maxBackups を超えた最古の世代は削除する。
+ * 開いた時点の既存ファイルには追記する。
+ */
+class RotatingLogFile
+{
+public:
+    /// 1ファイルの既定の上限（16MB）
+    static constexpr qint64 kDefaultMaxBytes = 16 * 1024 * 1024;
+    /// 既定の保持世代数
+    static constexpr int kDefaultMaxBackups = 5;
+
+    explicit RotatingLogFile(const QString& filePath,
+                             qint64 maxBytes = kDefaultMaxBytes,
+                             int maxBackups = kDefaultMaxBackups);
+
+    /// ファイルを開く（ディレクトリがなければ作る）。失敗時は false
+    bool open();
+
+    bool isOpen() const;
+    QString filePath() const;
+    QString errorString() const;
+
+    /// UTF-8 のバイト列をそのまま追記し、必要ならローテーションする
+    bool append(const QByteArray& data);
+
+    /// 世代番号付きのファイルパス（0 は現行ファイル）
+    QString backupPath(int generation) const;
+
+private:
+    void rotate();
+
+    QString m_filePath;
+    qint64 m_maxBytes;
+    int m_maxBackups;
+    QFile m_file;
+};
+
+#endif // ROTATINGLOGFILE_H
@@ -0,0 +1,66 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+/// @file spscqueue.h
+/// @brief 単一生産者・単一消費者のロックフリー固定長キュー
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 1つのスレッドが積み、別の1つのスレッドが取り出すリングバッファ
+ *
+ * tryPush() は生産者スレッドだけ、tryPop() は消費者スレッドだけが呼ぶ。
+ * 満杯・空のときは待たずに false を返すので、待ち方は呼び出し側が決める。
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(qsizetype capacity)
+        : m_slots(static_cast<std::size_t>(capacity) + 1)
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /// 末尾に積む（成功したときだけ value をムーブする）
+    bool tryPush(T& value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t next = advance(tail);
+        if (next == m_head.load(std::memory_order_acquire)) return false;
+        m_slots[tail] = std::move(value);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /// 先頭を取り出す
+    bool tryPop(T& out)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        out = std::move(m_slots[head]);
+        m_slots[head] = T();
+        m_head.store(advance(head), std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::size_t advance(std::size_t index) const { return (index + 1) % m_slots.size(); }
+
+    std::vector<T> m_slots;                     ///< 1つ余分に確保し、満杯と空を区別する
+    alignas(64) std::atomic<std::size_t> m_head{0}; ///< 消費者が次に読む位置
+    alignas(64) std::atomic<std::size_t> m_tail{0}; ///< 生産者が次に書く位置
+};
+
+#endif // SPSCQUEUE_H
@@ -12,6 +12,25 @@ fmv::LegalCore& legalCore()
     static fmv::LegalCore core;
     return core;
 }
+
+/// pos（手番 turn）で move の不成/成りそれぞれの合法性を判定する
+LegalMoveStatus checkLegal(const fmv::EnginePosition& pos, EngineMoveValidator::Turn turn, const ShogiMove& move)
+{
+    fmv::ConvertedMove cm;
+    if (!fmv::Converter::toEngineMove(cm, turn, pos, move)) {
+        return LegalMoveStatus(false, false);
+    }
+
+    fmv::EnginePosition work = pos;
+    const fmv::Color side = fmv::Converter::toColor(turn);
+
+    bool nonPromoting = legalCore().checkMove(work, side, cm.nonPromote).nonPromotingMoveExists;
+    bool promoting = false;
+    if (cm.hasPromoteVariant) {
+        promoting = legalCore().checkMove(work, side, cm.promote).nonPromotingMoveExists;
+    }
+    return LegalMoveStatus(nonPromoting, promoting);
+}
 } // namespace
 
 bool EngineMoveValidator::syncContext(Context& ctx,
@@ -22,6 +41,9 @@ bool EngineMoveValidator::syncContext(Context& ctx,
     ctx.turn = turn;
     ctx.undoSize = 0;
     ctx.synced = fmv::Converter::toEnginePosition(ctx.pos, boardData, pieceStand);
+    if (ctx.synced) {
+        ctx.pos.zobristKey = ctx.pos.computeZobristKey(fmv::Converter::toColor(turn));
+    }
     return ctx.synced;
 }
 
@@ -30,21 +52,7 @@ LegalMoveStatus EngineMoveValidator::isLegalMove(Context& ctx, ShogiMove& move)
     if (!ctx.synced) {
         return LegalMoveStatus(false, false);
     }
-
-    fmv::ConvertedMove cm;
-    if (!fmv::Converter::toEngineMove(cm, ctx.turn, ctx.pos, move)) {
-        return LegalMoveStatus(false, false);
-    }
-
-    fmv::EnginePosition work = ctx.pos;
-    const fmv::Color side = fmv::Converter::toColor(ctx.turn);
-
-    bool nonPromoting = legalCore().checkMove(work, side, cm.nonPromote).nonPromotingMoveExists;
-    bool promoting = false;
-    if (cm.hasPromoteVariant) {
-        promoting = legalCore().checkMove(work, side, cm.promote).nonPromotingMoveExists;
-    }
-    return LegalMoveStatus(nonPromoting, promoting);
+    return checkLegal(ctx.pos, ctx.turn, move);
 }
 
 int EngineMoveValidator::generateLegalMoves(Context& ctx) const
@@ -102,6 +110,26 @@ bool EngineMoveValidator::undoLastMove(Context& ctx) const
 }
 #endif
 
+// ---- 局面直接参照 ----
+
+LegalMoveStatus EngineMoveValidator::isLegalMove(const Turn& turn,
+                                                  const fmv::EnginePosition& pos,
+                                                  ShogiMove& move) const
+{
+    return checkLegal(pos, turn, move);
+}
+
+int EngineMoveValidator::generateLegalMoves(const Turn& turn, const fmv::EnginePosition& pos) const
+{
+    fmv::EnginePosition work = pos;
+    return legalCore().countLegalMoves(work, fmv::Converter::toColor(turn));
+}
+
+int EngineMoveValidator::checkIfKingInCheck(const Turn& turn, const fmv::EnginePosition& pos) const
+{
+    return legalCore().countChecksToKing(pos, fmv::Converter::toColor(turn));
+}
+
 // ---- 互換ラッパ（毎回Contextを作る） ----
 
 LegalMoveStatus EngineMoveValidator::isLegalMove(const Turn& turn,
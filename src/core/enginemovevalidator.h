@@ -50,6 +50,11 @@ public:
     [[nodiscard]] bool undoLastMove(Context& ctx) const;
 #endif
 
+    // ---- 局面直接参照（ShogiBoard::enginePosition() のミラーを再構築せずに使う） ----
+    LegalMoveStatus isLegalMove(const Turn& turn, const fmv::EnginePosition& pos, ShogiMove& move) const;
+    int generateLegalMoves(const Turn& turn, const fmv::EnginePosition& pos) const;
+    int checkIfKingInCheck(const Turn& turn, const fmv::EnginePosition& pos) const;
+
     // ---- 互換ラッパ ----
     LegalMoveStatus isLegalMove(const Turn& turn,
                                 const QList<Piece>& boardData,
@@ -51,47 +51,6 @@ Square Bitboard81::popFirst() noexcept
     return kInvalidSquare;
 }
 
-Bitboard81 Bitboard81::operator&(const Bitboard81& rhs) const noexcept
-{
-    return {lo & rhs.lo, hi & rhs.hi};
-}
-
-Bitboard81 Bitboard81::operator|(const Bitboard81& rhs) const noexcept
-{
-    return {lo | rhs.lo, hi | rhs.hi};
-}
-
-Bitboard81 Bitboard81::operator~() const noexcept
-{
-    // hi の上位ビット（17ビットのみ使用）をマスク
-    constexpr std::uint64_t kHiMask = (1ULL << 17) - 1;
-    return {~lo, (~hi) & kHiMask};
-}
-
-Bitboard81& Bitboard81::operator|=(const Bitboard81& rhs) noexcept
-{
-    lo |= rhs.lo;
-    hi |= rhs.hi;
-    return *this;
-}
-
-Bitboard81& Bitboard81::operator&=(const Bitboard81& rhs) noexcept
-{
-    lo &= rhs.lo;
-    hi &= rhs.hi;
-    return *this;
-}
-
-bool Bitboard81::operator==(const Bitboard81& rhs) const noexcept
-{
-    return lo == rhs.lo && hi == rhs.hi;
-}
-
-bool Bitboard81::operator!=(const Bitboard81& rhs) const noexcept
-{
-    return !(*this == rhs);
-}
-
 Bitboard81 Bitboard81::squareBit(Square sq) noexcept
 {
     Bitboard81 bb;
@@ -17,6 +17,8 @@ public:
     std::uint64_t lo = 0ULL;
     std::uint64_t hi = 0ULL;
 
+    static constexpr std::uint64_t kHiMask = (1ULL << 17) - 1;
+
     Bitboard81() noexcept = default;
     Bitboard81(std::uint64_t loVal, std::uint64_t hiVal) noexcept
         : lo(loVal), hi(hiVal) {}
@@ -31,15 +33,34 @@ public:
     bool any() const noexcept { return lo != 0ULL || hi != 0ULL; }
     bool none() const noexcept { return !any(); }
 
-    Bitboard81 operator&(const Bitboard81& rhs) const noexcept;
-    Bitboard81 operator|(const Bitboard81& rhs) const noexcept;
-    Bitboard81 operator~() const noexcept;
+    // 演算子は利き計算・指し手生成の内側ループで多用されるためインライン定義する
+    Bitboard81 operator&(const Bitboard81& rhs) const noexcept { return {lo & rhs.lo, hi & rhs.hi}; }
+    Bitboard81 operator|(const Bitboard81& rhs) const noexcept { return {lo | rhs.lo, hi | rhs.hi}; }
+    Bitboard81 operator^(const Bitboard81& rhs) const noexcept { return {lo ^ rhs.lo, hi ^ rhs.hi}; }
+    /// hi の上位ビット（17ビットのみ使用）をマスクした補集合
+    Bitboard81 operator~() const noexcept { return {~lo, (~hi) & kHiMask}; }
 
-    Bitboard81& operator|=(const Bitboard81& rhs) noexcept;
-    Bitboard81& operator&=(const Bitboard81& rhs) noexcept;
+    Bitboard81& operator|=(const Bitboard81& rhs) noexcept
+    {
+        lo |= rhs.lo;
+        hi |= rhs.hi;
+        return *this;
+    }
+    Bitboard81& operator&=(const Bitboard81& rhs) noexcept
+    {
+        lo &= rhs.lo;
+        hi &= rhs.hi;
+        return *this;
+    }
+    Bitboard81& operator^=(const Bitboard81& rhs) noexcept
+    {
+        lo ^= rhs.lo;
+        hi ^= rhs.hi;
+        return *this;
+    }
 
-    bool operator==(const Bitboard81& rhs) const noexcept;
-    bool operator!=(const Bitboard81& rhs) const noexcept;
+    bool operator==(const Bitboard81& rhs) const noexcept { return lo == rhs.lo && hi == rhs.hi; }
+    bool operator!=(const Bitboard81& rhs) const noexcept { return !(*this == rhs); }
 
     static Bitboard81 squareBit(Square sq) noexcept;
 };
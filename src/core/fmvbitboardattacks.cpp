@@ -0,0 +1,478 @@
+/// @file fmvbitboardattacks.cpp
+/// @brief 駒の利きビットボード表の構築と参照
+
+#include "fmvbitboardattacks.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define FMV_HAS_PEXT_TARGET 1
+#else
+#define FMV_HAS_PEXT_TARGET 0
+#endif
+
+namespace fmv {
+namespace attacks {
+
+namespace {
+
+constexpr int kPieceTypeNb = static_cast<int>(PieceType::PieceTypeNb);
+
+/// 占有パターンの索引幅（盤端を除いた最大7マス）
+constexpr int kLineIndexBits = 7;
+constexpr int kLineIndexNb = 1 << kLineIndexBits;
+
+/// レイ方向。前半4つはマス番号が増える向き（最初の遮り駒 = 最下位ビット）、
+/// 後半4つは減る向き（最初の遮り駒 = 最上位ビット）。
+enum Direction : int {
+    East = 0, South, SouthEast, SouthWest,
+    West, North, NorthWest, NorthEast,
+    DirectionNb
+};
+
+constexpr int kDirFile[DirectionNb] = {1, 0, 1, -1, -1, 0, -1, 1};
+constexpr int kDirRank[DirectionNb] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+/// 索引化した1ライン（筋・斜め）の表
+struct LineTable {
+    Bitboard81 mask[kSquareNb];                    ///< 盤端を除く関係マス
+    int loBits[kSquareNb] = {};                    ///< mask.lo のビット数（hi 側索引のシフト量）
+    Bitboard81 attacks[kSquareNb][kLineIndexNb];   ///< 索引 → 利き
+};
+
+struct Tables {
+    Bitboard81 step[2][kPieceTypeNb][kSquareNb];
+    Bitboard81 ray[DirectionNb][kSquareNb];
+    Bitboard81 rankTable[kSquareNb][kLineIndexNb]; ///< 段は連続ビットなのでシフトで索引化できる
+    LineTable fileTable;                         ///< PEXT 用
+    LineTable diagTable[2];                      ///< PEXT 用（0: 左上-右下, 1: 右上-左下）
+    Bitboard81 zone[2];
+    Bitboard81 dead[2][kPieceTypeNb];
+    Bitboard81 fileMasks[kBoardSize];
+    Bitboard81 fileFill[1 << kBoardSize];        ///< 9筋分の有無ビット → 筋マスクの和
+    Bitboard81 betweenTable[kSquareNb][kSquareNb];
+    bool pextSupported = false;
+
+    Tables() noexcept;
+};
+
+std::atomic<bool> g_usePext{false};
+
+bool inBoard(int file, int rank) noexcept
+{
+    return file >= 0 && file < kBoardSize && rank >= 0 && rank < kBoardSize;
+}
+
+/// 表構築用: sq から (df, dr) 方向へ occ の駒に当たるまでの利き（当たった駒を含む）
+Bitboard81 slideAttack(Square sq, int df, int dr, const Bitboard81& occ) noexcept
+{
+    Bitboard81 result;
+    int file = squareFile(sq) + df;
+    int rank = squareRank(sq) + dr;
+    while (inBoard(file, rank)) {
+        Square to = toSquare(file, rank);
+        result.set(to);
+        if (occ.test(to)) {
+            break;
+        }
+        file += df;
+        rank += dr;
+    }
+    return result;
+}
+
+/// 表構築用: ソフトウェア PDEP（index の下位ビットから順に mask の立っているマスへ配る）
+Bitboard81 depositBits(unsigned index, Bitboard81 mask) noexcept
+{
+    Bitboard81 result;
+    for (unsigned bit = 1U; mask.any(); bit <<= 1U) {
+        Square sq = mask.popFirst();
+        if ((index & bit) != 0U) {
+            result.set(sq);
+        }
+    }
+    return result;
+}
+
+void addStep(Bitboard81& bb, Square sq, int df, int dr) noexcept
+{
+    int file = squareFile(sq) + df;
+    int rank = squareRank(sq) + dr;
+    if (inBoard(file, rank)) {
+        bb.set(toSquare(file, rank));
+    }
+}
+
+Bitboard81 buildStep(Color c, PieceType pt, Square sq) noexcept
+{
+    const int f = (c == Color::Black) ? -1 : 1;
+    Bitboard81 bb;
+    switch (pt) {
+    case PieceType::Pawn:
+        addStep(bb, sq, 0, f);
+        break;
+    case PieceType::Knight:
+        addStep(bb, sq, -1, 2 * f);
+        addStep(bb, sq, 1, 2 * f);
+        break;
+    case PieceType::Silver:
+        addStep(bb, sq, -1, f);
+        addStep(bb, sq, 0, f);
+        addStep(bb, sq, 1, f);
+        addStep(bb, sq, -1, -f);
+        addStep(bb, sq, 1, -f);
+        break;
+    case PieceType::Gold:
+    case PieceType::ProPawn:
+    case PieceType::ProLance:
+    case PieceType::ProKnight:
+    case PieceType::ProSilver:
+        addStep(bb, sq, -1, f);
+        addStep(bb, sq, 0, f);
+        addStep(bb, sq, 1, f);
+        addStep(bb, sq, -1, 0);
+        addStep(bb, sq, 1, 0);
+        addStep(bb, sq, 0, -f);
+        break;
+    case PieceType::King:
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int df = -1; df <= 1; ++df) {
+                if (df != 0 || dr != 0) {
+                    addStep(bb, sq, df, dr);
+                }
+            }
+        }
+        break;
+    case PieceType::Horse:
+        addStep(bb, sq, 0, -1);
+        addStep(bb, sq, 0, 1);
+        addStep(bb, sq, -1, 0);
+        addStep(bb, sq, 1, 0);
+        break;
+    case PieceType::Dragon:
+        addStep(bb, sq, -1, -1);
+        addStep(bb, sq, 1, -1);
+        addStep(bb, sq, -1, 1);
+        addStep(bb, sq, 1, 1);
+        break;
+    default:
+        break; // 香・角・飛はステップ利きなし
+    }
+    return bb;
+}
+
+/// ライン表を構築する。dirA/dirB は逆向きの2方向。
+void buildLineTable(LineTable& table, Direction dirA, Direction dirB) noexcept
+{
+    for (int s = 0; s < kSquareNb; ++s) {
+        auto sq = static_cast<Square>(s);
+        // 盤端のマスは遮っても利きが変わらないため索引から外す
+        Bitboard81 mask;
+        for (Direction d : {dirA, dirB}) {
+            int file = squareFile(sq) + kDirFile[d];
+            int rank = squareRank(sq) + kDirRank[d];
+            while (inBoard(file + kDirFile[d], rank + kDirRank[d])) {
+                mask.set(toSquare(file, rank));
+                file += kDirFile[d];
+                rank += kDirRank[d];
+            }
+        }
+        table.mask[s] = mask;
+        table.loBits[s] = __builtin_popcountll(mask.lo);
+
+        const unsigned patterns = 1U << mask.count();
+        for (unsigned index = 0; index < patterns; ++index) {
+            Bitboard81 occ = depositBits(index, mask);
+            table.attacks[s][index] = slideAttack(sq, kDirFile[dirA], kDirRank[dirA], occ)
+                                      | slideAttack(sq, kDirFile[dirB], kDirRank[dirB], occ);
+        }
+    }
+}
+
+bool detectPext() noexcept
+{
+#if FMV_HAS_PEXT_TARGET
+    return __builtin_cpu_supports("bmi2") != 0;
+#else
+    return false;
+#endif
+}
+
+Tables::Tables() noexcept
+{
+    for (int ci = 0; ci < 2; ++ci) {
+        for (int pt = 0; pt < kPieceTypeNb; ++pt) {
+            for (int s = 0; s < kSquareNb; ++s) {
+                step[ci][pt][s] = buildStep(static_cast<Color>(ci), static_cast<PieceType>(pt),
+                                            static_cast<Square>(s));
+            }
+        }
+    }
+
+    const Bitboard81 empty;
+    for (int d = 0; d < DirectionNb; ++d) {
+        for (int s = 0; s < kSquareNb; ++s) {
+            ray[d][s] = slideAttack(static_cast<Square>(s), kDirFile[d], kDirRank[d], empty);
+        }
+    }
+
+    for (int s = 0; s < kSquareNb; ++s) {
+        auto sq = static_cast<Square>(s);
+        const int rowRank = squareRank(sq);
+        for (unsigned index = 0; index < static_cast<unsigned>(kLineIndexNb); ++index) {
+            Bitboard81 occ;
+            for (int file = 1; file <= kLineIndexBits; ++file) {
+                if ((index & (1U << (file - 1))) != 0U) {
+                    occ.set(toSquare(file, rowRank));
+                }
+            }
+            rankTable[s][index] = slideAttack(sq, 1, 0, occ) | slideAttack(sq, -1, 0, occ);
+        }
+    }
+
+    for (int ci = 0; ci < 2; ++ci) {
+        const auto c = static_cast<Color>(ci);
+        for (int s = 0; s < kSquareNb; ++s) {
+            const int r = squareRank(static_cast<Square>(s));
+            // 敵陣: 先手は一〜三段目(rank 0-2)、後手は七〜九段目(rank 6-8)
+            const int relRank = (c == Color::Black) ? r : (kBoardSize - 1 - r);
+            if (relRank <= 2) {
+                zone[ci].set(static_cast<Square>(s));
+            }
+            if (relRank == 0) {
+                dead[ci][static_cast<int>(PieceType::Pawn)].set(static_cast<Square>(s));
+                dead[ci][static_cast<int>(PieceType::Lance)].set(static_cast<Square>(s));
+            }
+            if (relRank <= 1) {
+                dead[ci][static_cast<int>(PieceType::Knight)].set(static_cast<Square>(s));
+            }
+        }
+    }
+
+    for (int s = 0; s < kSquareNb; ++s) {
+        fileMasks[squareFile(static_cast<Square>(s))].set(static_cast<Square>(s));
+    }
+    for (unsigned bits = 0; bits < (1U << kBoardSize); ++bits) {
+        for (int f = 0; f < kBoardSize; ++f) {
+            if ((bits & (1U << f)) != 0U) {
+                fileFill[bits] |= fileMasks[f];
+            }
+        }
+    }
+
+    for (int a = 0; a < kSquareNb; ++a) {
+        for (int d = 0; d < DirectionNb; ++d) {
+            // a から d 方向に進み、通過したマスを「a と到達マスの間」とする
+            Bitboard81 passed;
+            int f = squareFile(static_cast<Square>(a)) + kDirFile[d];
+            int r = squareRank(static_cast<Square>(a)) + kDirRank[d];
+            while (inBoard(f, r)) {
+                const Square b = toSquare(f, r);
+                betweenTable[a][b] = passed;
+                passed.set(b);
+                f += kDirFile[d];
+                r += kDirRank[d];
+            }
+        }
+    }
+
+    pextSupported = detectPext();
+    if (pextSupported) {
+        buildLineTable(fileTable, North, South);
+        buildLineTable(diagTable[0], NorthWest, SouthEast);
+        buildLineTable(diagTable[1], NorthEast, SouthWest);
+    }
+    g_usePext.store(pextSupported, std::memory_order_relaxed);
+}
+
+const Tables& tables() noexcept
+{
+    static const Tables t;
+    return t;
+}
+
+// ---- 共通 ----
+
+/// 段 rank の盤端を除く7マスの占有パターン
+/// （各段の 2〜8 筋は lo/hi の境界（bit 63/64）を跨がない）
+unsigned rankIndex(const Bitboard81& occ, int rank) noexcept
+{
+    const int shift = rank * kBoardSize + 1;
+    const std::uint64_t bits = (shift >= 64) ? (occ.hi >> (shift - 64)) : (occ.lo >> shift);
+    return static_cast<unsigned>(bits) & static_cast<unsigned>(kLineIndexNb - 1);
+}
+
+Bitboard81 rankAttacks(const Tables& t, Square sq, const Bitboard81& occ) noexcept
+{
+    return t.rankTable[sq][rankIndex(occ, squareRank(sq))];
+}
+
+/// 段 rank の9マス分のビット（段7のみ lo/hi を跨ぐ）
+unsigned rowBits(const Bitboard81& bb, int rank) noexcept
+{
+    const int shift = rank * kBoardSize;
+    std::uint64_t bits = 0ULL;
+    if (shift >= 64) {
+        bits = bb.hi >> (shift - 64);
+    } else {
+        bits = bb.lo >> shift;
+        if (shift + kBoardSize > 64) {
+            bits |= bb.hi << (64 - shift);
+        }
+    }
+    return static_cast<unsigned>(bits) & ((1U << kBoardSize) - 1U);
+}
+
+// ---- Classical（レイ + ビットスキャン） ----
+
+Square lowestSquare(const Bitboard81& bb) noexcept
+{
+    if (bb.lo != 0ULL) {
+        return static_cast<Square>(__builtin_ctzll(bb.lo));
+    }
+    return static_cast<Square>(64 + __builtin_ctzll(bb.hi));
+}
+
+Square highestSquare(const Bitboard81& bb) noexcept
+{
+    if (bb.hi != 0ULL) {
+        return static_cast<Square>(127 - __builtin_clzll(bb.hi));
+    }
+    return static_cast<Square>(63 - __builtin_clzll(bb.lo));
+}
+
+Bitboard81 rayAttacks(const Tables& t, Direction d, Square sq, const Bitboard81& occ) noexcept
+{
+    const Bitboard81& ray = t.ray[d][sq];
+    const Bitboard81 blockers = ray & occ;
+    if (blockers.none()) {
+        return ray;
+    }
+    const Square first = (d < West) ? lowestSquare(blockers) : highestSquare(blockers);
+    return ray ^ t.ray[d][first];
+}
+
+// ---- PEXT ----
+
+#if FMV_HAS_PEXT_TARGET
+__attribute__((target("bmi2")))
+const Bitboard81& lineAttacksPext(const LineTable& table, Square sq, const Bitboard81& occ) noexcept
+{
+    const Bitboard81& mask = table.mask[sq];
+    const auto index = _pext_u64(occ.lo, mask.lo) | (_pext_u64(occ.hi, mask.hi) << table.loBits[sq]);
+    return table.attacks[sq][index];
+}
+#else
+const Bitboard81& lineAttacksPext(const LineTable& table, Square sq, const Bitboard81&) noexcept
+{
+    return table.attacks[sq][0]; // 到達しない（pextSupported が常に false）
+}
+#endif
+
+} // namespace
+
+SlidingBackend slidingBackend() noexcept
+{
+    tables();
+    return g_usePext.load(std::memory_order_relaxed) ? SlidingBackend::Pext
+                                                     : SlidingBackend::Classical;
+}
+
+bool setSlidingBackend(SlidingBackend backend) noexcept
+{
+    const Tables& t = tables();
+    if (backend == SlidingBackend::Pext && !t.pextSupported) {
+        return false;
+    }
+    g_usePext.store(backend == SlidingBackend::Pext, std::memory_order_relaxed);
+    return true;
+}
+
+Bitboard81 stepAttacks(Color c, PieceType pt, Square sq) noexcept
+{
+    return tables().step[static_cast<int>(c)][static_cast<int>(pt)][sq];
+}
+
+Bitboard81 lanceAttacks(Color c, Square sq, const Bitboard81& occ) noexcept
+{
+    const Tables& t = tables();
+    const Direction forward = (c == Color::Black) ? North : South;
+    if (g_usePext.load(std::memory_order_relaxed)) {
+        return lineAttacksPext(t.fileTable, sq, occ) & t.ray[forward][sq];
+    }
+    return rayAttacks(t, forward, sq, occ);
+}
+
+Bitboard81 rookAttacks(Square sq, const Bitboard81& occ) noexcept
+{
+    const Tables& t = tables();
+    if (g_usePext.load(std::memory_order_relaxed)) {
+        return lineAttacksPext(t.fileTable, sq, occ) | rankAttacks(t, sq, occ);
+    }
+    return rayAttacks(t, North, sq, occ) | rayAttacks(t, South, sq, occ)
+           | rankAttacks(t, sq, occ);
+}
+
+Bitboard81 bishopAttacks(Square sq, const Bitboard81& occ) noexcept
+{
+    const Tables& t = tables();
+    if (g_usePext.load(std::memory_order_relaxed)) {
+        return lineAttacksPext(t.diagTable[0], sq, occ) | lineAttacksPext(t.diagTable[1], sq, occ);
+    }
+    return rayAttacks(t, NorthWest, sq, occ) | rayAttacks(t, NorthEast, sq, occ)
+           | rayAttacks(t, SouthWest, sq, occ) | rayAttacks(t, SouthEast, sq, occ);
+}
+
+Bitboard81 pieceAttacks(Color c, PieceType pt, Square sq, const Bitboard81& occ) noexcept
+{
+    switch (pt) {
+    case PieceType::Lance:
+        return lanceAttacks(c, sq, occ);
+    case PieceType::Bishop:
+        return bishopAttacks(sq, occ);
+    case PieceType::Rook:
+        return rookAttacks(sq, occ);
+    case PieceType::Horse:
+        return bishopAttacks(sq, occ) | stepAttacks(c, pt, sq);
+    case PieceType::Dragon:
+        return rookAttacks(sq, occ) | stepAttacks(c, pt, sq);
+    default:
+        return stepAttacks(c, pt, sq);
+    }
+}
+
+Bitboard81 promotionZone(Color c) noexcept
+{
+    return tables().zone[static_cast<int>(c)];
+}
+
+Bitboard81 deadSquares(Color c, PieceType pt) noexcept
+{
+    return tables().dead[static_cast<int>(c)][static_cast<int>(pt)];
+}
+
+Bitboard81 fileMask(int file) noexcept
+{
+    return tables().fileMasks[file];
+}
+
+Bitboard81 filesOf(const Bitboard81& bb) noexcept
+{
+    if (bb.none()) {
+        return {};
+    }
+    unsigned files = 0U;
+    for (int rank = 0; rank < kBoardSize; ++rank) {
+        files |= rowBits(bb, rank);
+    }
+    return tables().fileFill[files];
+}
+
+Bitboard81 between(Square a, Square b) noexcept
+{
+    return tables().betweenTable[a][b];
+}
+
+} // namespace attacks
+} // namespace fmv
@@ -0,0 +1,65 @@
+#ifndef FMVBITBOARDATTACKS_H
+#define FMVBITBOARDATTACKS_H
+
+/// @file fmvbitboardattacks.h
+/// @brief 駒の利きビットボード表（ステップ駒の表引き・走り駒の PEXT/レイ表引き）
+
+#include "fmvbitboard81.h"
+#include "fmvtypes.h"
+
+namespace fmv {
+namespace attacks {
+
+/// 走り駒の利き計算方式
+enum class SlidingBackend : std::uint8_t {
+    Pext,       ///< BMI2 PEXT で占有パターンを索引化した表（筋・斜め）
+    Classical   ///< 方向別レイ表 + 最初の遮り駒のビットスキャン（可搬版）
+};
+
+/**
+ * @brief 使用中の走り駒方式
+ *
+ * 初回の表構築時に CPU が BMI2 に対応していれば Pext、それ以外は Classical が選ばれる。
+ */
+SlidingBackend slidingBackend() noexcept;
+
+/**
+ * @brief 走り駒方式を切り替える（テスト・ベンチマーク用）
+ * @return 指定方式が実行環境で使えない場合は false（方式は変わらない）
+ */
+bool setSlidingBackend(SlidingBackend backend) noexcept;
+
+/// 色 c の駒種 pt が sq にあるときのステップ利き（香・角・飛は空、馬・龍は1マス分のみ）
+Bitboard81 stepAttacks(Color c, PieceType pt, Square sq) noexcept;
+
+/// 色 c の香の利き（occ の最初の駒を含む）
+Bitboard81 lanceAttacks(Color c, Square sq, const Bitboard81& occ) noexcept;
+
+/// 飛車の利き（縦横）
+Bitboard81 rookAttacks(Square sq, const Bitboard81& occ) noexcept;
+
+/// 角の利き（斜め）
+Bitboard81 bishopAttacks(Square sq, const Bitboard81& occ) noexcept;
+
+/// 任意の駒の利き（味方駒の除外は呼び出し側で行う）
+Bitboard81 pieceAttacks(Color c, PieceType pt, Square sq, const Bitboard81& occ) noexcept;
+
+/// 色 c の成れる段（敵陣3段）
+Bitboard81 promotionZone(Color c) noexcept;
+
+/// 色 c の駒種 pt が行き所のなくなるマス（不成の移動・打ちが禁じられるマス）
+Bitboard81 deadSquares(Color c, PieceType pt) noexcept;
+
+/// 筋 file（0-8）の全マス
+Bitboard81 fileMask(int file) noexcept;
+
+/// bb の駒がいる筋を全て埋めたマスク（二歩判定用）
+Bitboard81 filesOf(const Bitboard81& bb) noexcept;
+
+/// a と b を結ぶ縦横斜めの直線上で両端を除いたマス（直線上にない・隣接なら空）
+Bitboard81 between(Square a, Square b) noexcept;
+
+} // namespace attacks
+} // namespace fmv
+
+#endif // FMVBITBOARDATTACKS_H
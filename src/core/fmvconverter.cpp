@@ -168,6 +168,33 @@ bool belongsToTurn(const EngineMoveValidator::Turn turn, char c) noexcept
     return c >= 'a' && c <= 'z';
 }
 
+/// SFEN駒文字（'+' 付きは成駒）→ 盤面配列用char。不正なら kEmpty
+char sfenPieceToBoardChar(char c, bool promoted) noexcept
+{
+    Color color{};
+    PieceType type{};
+    if (!mapPieceChar(c, color, type) || type > PieceType::King) {
+        return kEmpty;
+    }
+    if (!promoted) {
+        return c;
+    }
+
+    char upper = kEmpty;
+    switch (type) {
+    case PieceType::Pawn:   upper = 'Q'; break;
+    case PieceType::Lance:  upper = 'M'; break;
+    case PieceType::Knight: upper = 'O'; break;
+    case PieceType::Silver: upper = 'T'; break;
+    case PieceType::Bishop: upper = 'C'; break;
+    case PieceType::Rook:   upper = 'U'; break;
+    default: return kEmpty;
+    }
+    return (color == Color::White)
+               ? static_cast<char>(std::tolower(static_cast<unsigned char>(upper)))
+               : upper;
+}
+
 } // namespace
 
 bool Converter::toEnginePosition(EnginePosition& out,
@@ -268,11 +295,7 @@ bool Converter::toEngineMove(ConvertedMove& out,
             return false;
         }
 
-        out.nonPromote.kind = MoveKind::Drop;
-        out.nonPromote.from = kInvalidSquare;
-        out.nonPromote.to = toSq;
-        out.nonPromote.piece = pt;
-        out.nonPromote.promote = false;
+        out.nonPromote = Move::makeDrop(pt, toSq);
         out.hasPromoteVariant = false;
         return true;
     }
@@ -306,11 +329,7 @@ bool Converter::toEngineMove(ConvertedMove& out,
         return false;
     }
 
-    out.nonPromote.kind = MoveKind::Board;
-    out.nonPromote.from = fromSq;
-    out.nonPromote.to = toSq;
-    out.nonPromote.piece = pieceType;
-    out.nonPromote.promote = false;
+    out.nonPromote = Move::makeBoard(fromSq, toSq, pieceType);
 
     // 成りバリアント
     if (isPromotable(pieceType)) {
@@ -325,8 +344,7 @@ bool Converter::toEngineMove(ConvertedMove& out,
         }
 
         if (inPromotionZone) {
-            out.promote = out.nonPromote;
-            out.promote.promote = true;
+            out.promote = out.nonPromote.withPromote(true);
             // piece は元の駒種のまま（成りフラグで区別）
             out.hasPromoteVariant = true;
         }
@@ -340,4 +358,92 @@ Color Converter::toColor(const EngineMoveValidator::Turn& t) noexcept
     return (t == EngineMoveValidator::BLACK) ? Color::Black : Color::White;
 }
 
+bool Converter::fromSfen(EnginePosition& out, Color& sideToMove, QStringView sfen)
+{
+    out.clear();
+
+    const qsizetype n = sfen.size();
+    qsizetype i = 0;
+
+    // 盤面: 段ごとに9筋分（先頭が9筋）
+    int rank = 0;
+    int file = kBoardSize - 1;
+    bool promoted = false;
+    for (; i < n && sfen[i] != QLatin1Char(' '); ++i) {
+        const char c = sfen[i].toLatin1();
+        if (c == '/') {
+            if (file != -1 || promoted) {
+                return false;
+            }
+            ++rank;
+            file = kBoardSize - 1;
+        } else if (c == '+') {
+            promoted = true;
+        } else if (c >= '1' && c <= '9') {
+            if (promoted) {
+                return false;
+            }
+            file -= c - '0';
+            if (file < -1) {
+                return false;
+            }
+        } else {
+            const char boardChar = sfenPieceToBoardChar(c, promoted);
+            if (boardChar == kEmpty || file < 0 || rank >= kBoardSize) {
+                return false;
+            }
+            out.board[static_cast<std::size_t>(toSquare(file, rank))] = boardChar;
+            promoted = false;
+            --file;
+        }
+    }
+    if (rank != kBoardSize - 1 || file != -1 || promoted) {
+        return false;
+    }
+
+    // 手番
+    if (i + 3 >= n || sfen[i + 2] != QLatin1Char(' ')) {
+        return false;
+    }
+    const QChar turn = sfen[i + 1];
+    if (turn == QLatin1Char('b')) {
+        sideToMove = Color::Black;
+    } else if (turn == QLatin1Char('w')) {
+        sideToMove = Color::White;
+    } else {
+        return false;
+    }
+    i += 3;
+
+    // 持ち駒: "-" または [枚数]駒 の列
+    if (i < n && sfen[i] == QLatin1Char('-')) {
+        ++i;
+    } else {
+        int count = 0;
+        for (; i < n && sfen[i] != QLatin1Char(' '); ++i) {
+            const char c = sfen[i].toLatin1();
+            if (c >= '0' && c <= '9') {
+                count = count * 10 + (c - '0');
+                continue;
+            }
+            Color color{};
+            PieceType type{};
+            const HandType ht = pieceToHandType(c);
+            if (!mapPieceChar(c, color, type) || ht == HandType::HandTypeNb || type > PieceType::Rook) {
+                return false;
+            }
+            out.hand[static_cast<int>(color)][static_cast<std::size_t>(ht)] += (count > 0) ? count : 1;
+            count = 0;
+        }
+        if (count != 0) {
+            return false;
+        }
+    }
+
+    // 手数以降は局面に影響しないため読み飛ばす
+    out.rebuildBitboards();
+    out.zobristKey = out.computeZobristKey(sideToMove);
+    return true;
+}
+
 } // namespace fmv
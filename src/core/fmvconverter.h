@@ -6,6 +6,8 @@
 
 #include <QMap>
 #include <QList>
+#include <QString>
+#include <QStringView>
 
 #include "enginemovevalidator.h"
 #include "fmvposition.h"
@@ -15,8 +17,8 @@
 namespace fmv {
 
 struct ConvertedMove {
-    Move nonPromote{};
-    Move promote{};
+    Move nonPromote = Move::none();
+    Move promote = Move::none();
     bool hasPromoteVariant = false;
 };
 
@@ -33,6 +35,35 @@ public:
                              const ShogiMove& in);
 
     static Color toColor(const EngineMoveValidator::Turn& t) noexcept;
+
+    /**
+     * @brief SFEN文字列から直接エンジン局面を構築する（ShogiBoard を経由しない）
+     * @param out 出力局面（Zobristキーは手番込みで設定される）
+     * @param sideToMove 出力: 手番
+     * @param sfen "board turn hand [moveNum]" 形式。"sfen " 接頭辞は付けない
+     * @return 構文が正しければ true
+     *
+     * 千日手判定や局面キー計算のように、局面ごとに盤面を復元する経路で
+     * QString の分割や一時オブジェクトを作らずに済むよう文字単位で解析する。
+     */
+    static bool fromSfen(EnginePosition& out, Color& sideToMove, QStringView sfen);
+
+    /**
+     * @brief エンジン指し手 → ShogiMove（0-indexed 座標、駒台は 9/10 筋）
+     * @param pos 指す前の局面（動かす駒・取る駒の文字を引く）
+     * @param side 手番
+     */
+    static ShogiMove toShogiMove(const EnginePosition& pos, Color side, const Move& m);
+
+    /// エンジン指し手 → USI 文字列（例: "7g7f", "2b3c+", "P*5e"）
+    static QString toUsi(const Move& m);
+
+    /**
+     * @brief USI 文字列 → エンジン指し手（構文と駒の有無のみ確認。合法性は見ない）
+     * @param pos 指す前の局面（盤上移動の駒種を引く）
+     * @return 構文が正しく、盤上移動なら移動元に駒があれば true
+     */
+    static bool fromUsi(Move& out, const EnginePosition& pos, QStringView usi);
 };
 
 } // namespace fmv
@@ -0,0 +1,118 @@
+/// @file fmvconverter_move.cpp
+/// @brief エンジン指し手 ←→ ShogiMove / USI 文字列の変換
+
+#include "fmvconverter.h"
+#include "fmvlegalcore_internal.h"
+
+namespace fmv {
+
+namespace {
+
+/// 持ち駒の駒種順（HandType と同順）の USI 駒文字
+constexpr char kHandPieceChars[] = {'P', 'L', 'N', 'S', 'G', 'B', 'R'};
+
+/// 打てる駒種のインデックス（HandType 値）。打てない駒種は -1
+int dropIndex(PieceType pt) noexcept
+{
+    return pt <= PieceType::Rook ? static_cast<int>(pt) : -1;
+}
+
+/// USI のマス表記（筋1〜9 + 段a〜i）を解析する
+bool parseUsiSquare(QChar fileCh, QChar rankCh, Square& out) noexcept
+{
+    const int file = fileCh.unicode() - u'1';
+    const int rank = rankCh.unicode() - u'a';
+    if (file < 0 || file >= kBoardSize || rank < 0 || rank >= kBoardSize) {
+        return false;
+    }
+    out = toSquare(file, rank);
+    return true;
+}
+
+void appendUsiSquare(QString& out, Square sq)
+{
+    out.append(QChar(static_cast<char16_t>(u'1' + squareFile(sq))));
+    out.append(QChar(static_cast<char16_t>(u'a' + squareRank(sq))));
+}
+
+} // namespace
+
+ShogiMove Converter::toShogiMove(const EnginePosition& pos, Color side, const Move& m)
+{
+    const QPoint to(squareFile(m.to()), squareRank(m.to()));
+    const auto captured = static_cast<Piece>(pos.board[m.to()]);
+
+    if (m.isDrop()) {
+        // 駒台の段: 先手は歩=0〜飛=6、後手は飛=2〜歩=8（HandType の逆順）
+        const int index = dropIndex(m.piece());
+        const bool black = (side == Color::Black);
+        const QPoint from(black ? EngineMoveValidator::BLACK_HAND_FILE : EngineMoveValidator::WHITE_HAND_FILE,
+                          black ? index : kBoardSize - 1 - index);
+        const char upper = index >= 0 ? kHandPieceChars[index] : ' ';
+        const char c = black ? upper : static_cast<char>(std::tolower(static_cast<unsigned char>(upper)));
+        return ShogiMove(from, to, static_cast<Piece>(c), captured, false);
+    }
+
+    const QPoint from(squareFile(m.from()), squareRank(m.from()));
+    return ShogiMove(from, to, static_cast<Piece>(pos.board[m.from()]), captured, m.promote());
+}
+
+QString Converter::toUsi(const Move& m)
+{
+    QString out;
+    out.reserve(5);
+    if (m.isDrop()) {
+        const int index = dropIndex(m.piece());
+        out.append(QLatin1Char(index >= 0 ? kHandPieceChars[index] : '?'));
+        out.append(QLatin1Char('*'));
+    } else {
+        appendUsiSquare(out, m.from());
+    }
+    appendUsiSquare(out, m.to());
+    if (m.promote()) {
+        out.append(QLatin1Char('+'));
+    }
+    return out;
+}
+
+bool Converter::fromUsi(Move& out, const EnginePosition& pos, QStringView usi)
+{
+    if (usi.size() != 4 && usi.size() != 5) {
+        return false;
+    }
+
+    Square to = kInvalidSquare;
+    if (!parseUsiSquare(usi[2], usi[3], to)) {
+        return false;
+    }
+
+    if (usi[1] == u'*') {
+        if (usi.size() != 4) {
+            return false;
+        }
+        for (int i = 0; i < static_cast<int>(HandType::HandTypeNb); ++i) {
+            if (usi[0] == QLatin1Char(kHandPieceChars[i])) {
+                out = Move::makeDrop(static_cast<PieceType>(i), to);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Square from = kInvalidSquare;
+    if (!parseUsiSquare(usi[0], usi[1], from)) {
+        return false;
+    }
+    const bool promote = (usi.size() == 5);
+    if (promote && usi[4] != u'+') {
+        return false;
+    }
+    const PieceType pt = detail::charToPieceType(pos.board[from]);
+    if (pt == PieceType::PieceTypeNb) {
+        return false;
+    }
+    out = Move::makeBoard(from, to, pt, promote);
+    return true;
+}
+
+} // namespace fmv
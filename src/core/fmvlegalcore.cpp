@@ -4,6 +4,7 @@
 #include "fmvlegalcore.h"
 
 #include "fmvattacks.h"
+#include "fmvbitboardattacks.h"
 #include "fmvlegalcore_internal.h"
 
 #include <cstdlib>
@@ -27,8 +28,11 @@ constexpr char kEmpty = ' ';
 
 LegalMoveStatus LegalCore::checkMove(EnginePosition& pos, Color side, const Move& candidate) const
 {
-    bool ok = isLegalAfterDoUndo(pos, side, candidate);
-    return LegalMoveStatus(ok, false);
+    if (!isPseudoLegal(pos, side, candidate)) {
+        return LegalMoveStatus(false, false);
+    }
+    const CheckInfo info = computeCheckInfo(pos, side);
+    return LegalMoveStatus(isLegalWithCheckInfo(pos, side, candidate, info), false);
 }
 
 int LegalCore::countChecksToKing(const EnginePosition& pos, Color side) const
@@ -66,30 +70,30 @@ bool LegalCore::isPseudoLegal(const EnginePosition& pos, Color side, const Move&
 {
     int ci = static_cast<int>(side);
 
-    if (m.to >= kSquareNb) {
+    if (m.to() >= kSquareNb) {
         return false;
     }
 
     // 移動先に味方駒があれば不可
-    if (pos.colorOcc[ci].test(m.to)) {
+    if (pos.colorOcc[ci].test(m.to())) {
         return false;
     }
 
-    int toRank = squareRank(m.to);
-    int toFile = squareFile(m.to);
+    int toRank = squareRank(m.to());
+    int toFile = squareFile(m.to());
 
-    if (m.kind == MoveKind::Drop) {
-        if (m.promote) {
+    if (m.kind() == MoveKind::Drop) {
+        if (m.promote()) {
             return false;
         }
         // 空きマスのみ
-        if (pos.occupied.test(m.to)) {
+        if (pos.occupied.test(m.to())) {
             return false;
         }
 
         // 持ち駒があるか
         HandType ht = HandType::HandTypeNb;
-        switch (m.piece) {
+        switch (m.piece()) {
         case PieceType::Pawn:   ht = HandType::Pawn;   break;
         case PieceType::Lance:  ht = HandType::Lance;  break;
         case PieceType::Knight: ht = HandType::Knight; break;
@@ -104,12 +108,12 @@ bool LegalCore::isPseudoLegal(const EnginePosition& pos, Color side, const Move&
         }
 
         // 二歩
-        if (m.piece == PieceType::Pawn && detail::hasPawnOnFile(pos, side, toFile)) {
+        if (m.piece() == PieceType::Pawn && detail::hasPawnOnFile(pos, side, toFile)) {
             return false;
         }
 
         // 行き所なし
-        if (isDropDeadSquare(side, m.piece, toRank)) {
+        if (isDropDeadSquare(side, m.piece(), toRank)) {
             return false;
         }
 
@@ -117,36 +121,36 @@ bool LegalCore::isPseudoLegal(const EnginePosition& pos, Color side, const Move&
     }
 
     // 盤上移動
-    if (m.from >= kSquareNb) {
+    if (m.from() >= kSquareNb) {
         return false;
     }
 
     // from に自分の駒があるか
-    char fromChar = pos.board[m.from];
+    char fromChar = pos.board[m.from()];
     if (fromChar == kEmpty) {
         return false;
     }
-    if (!pos.colorOcc[ci].test(m.from)) {
+    if (!pos.colorOcc[ci].test(m.from())) {
         return false;
     }
 
     // 駒種チェック
     PieceType fromType = charToPieceType(fromChar);
-    if (fromType != m.piece) {
+    if (fromType != m.piece()) {
         return false;
     }
 
     // 実際に利きがあるかチェック（attacksSquare相当）
     // 簡易版: from→toの利きチェック
-    int fromFile = squareFile(m.from);
-    int fromRank = squareRank(m.from);
+    int fromFile = squareFile(m.from());
+    int fromRank = squareRank(m.from());
     int df = toFile - fromFile;
     int dr = toRank - fromRank;
     int forward = (side == Color::Black) ? -1 : 1;
 
     bool reachable = false;
 
-    switch (m.piece) {
+    switch (m.piece()) {
     case PieceType::Pawn:
         reachable = (df == 0 && dr == forward);
         break;
@@ -277,13 +281,13 @@ bool LegalCore::isPseudoLegal(const EnginePosition& pos, Color side, const Move&
     }
 
     // 成り可否チェック
-    if (m.promote) {
-        return isPromotable(m.piece)
+    if (m.promote()) {
+        return isPromotable(m.piece())
                && (isPromotionZone(side, fromRank) || isPromotionZone(side, toRank));
     }
 
     // 強制成り
-    if (isMandatoryPromotion(side, m.piece, toRank)) {
+    if (isMandatoryPromotion(side, m.piece(), toRank)) {
         return false;
     }
 
@@ -299,19 +303,85 @@ bool LegalCore::ownKingInCheck(const EnginePosition& pos, Color side) const
     return attackersTo(pos, king, opposite(side)).any();
 }
 
-bool LegalCore::isLegalAfterDoUndo(EnginePosition& pos, Color side, const Move& m) const
+CheckInfo LegalCore::computeCheckInfo(const EnginePosition& pos, Color side) const
+{
+    CheckInfo info;
+    const int ci = static_cast<int>(side);
+    const Square king = pos.kingSq[ci];
+    if (king == kInvalidSquare) {
+        return info;
+    }
+
+    const Color opponent = opposite(side);
+    info.checkers = attackersTo(pos, king, opponent);
+
+    // 空盤面で玉に利く相手の走り駒のうち、間にちょうど1枚だけ自駒があるものがピンの元
+    const auto& enemy = pos.pieceOcc[static_cast<int>(opponent)];
+    auto bb = [&enemy](PieceType pt) -> const Bitboard81& {
+        return enemy[static_cast<int>(pt)];
+    };
+    const Bitboard81 empty;
+    Bitboard81 snipers =
+        (attacks::rookAttacks(king, empty) & (bb(PieceType::Rook) | bb(PieceType::Dragon)))
+        | (attacks::bishopAttacks(king, empty) & (bb(PieceType::Bishop) | bb(PieceType::Horse)))
+        | (attacks::lanceAttacks(side, king, empty) & bb(PieceType::Lance));
+    while (snipers.any()) {
+        const Square sniper = snipers.popFirst();
+        const Bitboard81 blockers = attacks::between(king, sniper) & pos.occupied;
+        if (blockers.count() == 1) {
+            info.pinned |= blockers & pos.colorOcc[ci];
+        }
+    }
+
+    if (info.checkers.count() == 1) {
+        Bitboard81 checker = info.checkers;
+        const Square checkerSq = checker.popFirst();
+        info.evasionTargets = attacks::between(king, checkerSq) | info.checkers;
+    }
+    return info;
+}
+
+bool LegalCore::isLegalWithCheckInfo(EnginePosition& pos, Color side, const Move& m,
+                                     const CheckInfo& info) const
 {
+    if (m.kind() == MoveKind::Board && (m.piece() == PieceType::King || info.pinned.test(m.from()))) {
+        UndoState undo;
+        if (!pos.doMove(m, side, undo)) {
+            return false;
+        }
+        const bool selfCheck = ownKingInCheck(pos, side);
+        pos.undoMove(undo, side);
+        return !selfCheck;
+    }
+    if (info.checkers.none()) {
+        return true;
+    }
+    // 王手中の玉以外の手は、単王手の駒を取るか間に合駒する手のみ
+    return info.evasionTargets.test(m.to());
+}
+
+bool LegalCore::isLegalGenerated(EnginePosition& pos, Color side, const Move& m,
+                                 const CheckInfo& info) const
+{
+    if (!isLegalWithCheckInfo(pos, side, m, info)) {
+        return false;
+    }
+    if (m.kind() != MoveKind::Drop || m.piece() != PieceType::Pawn || !givesDirectPawnCheck(pos, side, m)) {
+        return true;
+    }
+
     UndoState undo;
-    if (!tryApplyLegalMove(pos, side, m, undo)) {
+    if (!pos.doMove(m, side, undo)) {
         return false;
     }
+    const bool pawnDropMate = isPawnDropMate(pos, side, m);
     pos.undoMove(undo, side);
-    return true;
+    return !pawnDropMate;
 }
 
 bool LegalCore::isPawnDropMate(EnginePosition& pos, Color side, const Move& m) const
 {
-    if (m.kind != MoveKind::Drop || m.piece != PieceType::Pawn) {
+    if (m.kind() != MoveKind::Drop || m.piece() != PieceType::Pawn) {
         return false;
     }
 
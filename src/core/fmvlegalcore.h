@@ -10,6 +10,13 @@
 
 namespace fmv {
 
+/// 局面ごとの王手・ピン情報（指し手ごとの do/undo 検証を省くため1回だけ計算する）
+struct CheckInfo {
+    Bitboard81 checkers;        ///< 手番側の玉に王手している相手の駒
+    Bitboard81 pinned;          ///< 手番側の駒のうち、動くと玉が素抜かれうる駒
+    Bitboard81 evasionTargets;  ///< 単王手時の王手駒のマス + 合駒できるマス（それ以外は空）
+};
+
 class LegalCore
 {
 public:
@@ -26,12 +33,22 @@ public:
     // Perft用: 全合法手生成
     void generateLegalMoves(EnginePosition& pos, Color side, MoveList& out) const;
 
+    // 詰み探索用: 相手玉に王手をかける合法手のみ生成（直接王手・開き王手）
+    void generateCheckMoves(EnginePosition& pos, Color side, MoveList& out) const;
+
 private:
     bool isPseudoLegal(const EnginePosition& pos, Color side, const Move& m) const;
     bool ownKingInCheck(const EnginePosition& pos, Color side) const;
-    bool isLegalAfterDoUndo(EnginePosition& pos, Color side, const Move& m) const;
 
-    void generateEvasionMoves(const EnginePosition& pos, Color side, MoveList& out) const;
+    CheckInfo computeCheckInfo(const EnginePosition& pos, Color side) const;
+    // 疑似合法手 m の自玉安全性（打ち歩詰めは含まない）。玉の移動とピン駒の移動のみ do/undo で検証する。
+    bool isLegalWithCheckInfo(EnginePosition& pos, Color side, const Move& m, const CheckInfo& info) const;
+    // 生成した疑似合法手の合法性（打ち歩詰めを含む）
+    bool isLegalGenerated(EnginePosition& pos, Color side, const Move& m, const CheckInfo& info) const;
+
+    void generatePseudoMoves(const EnginePosition& pos, Color side, const CheckInfo& info, MoveList& out) const;
+    // checkers は computeCheckInfo() で求めた王手駒（呼び出し側で非空を保証する）
+    void generateEvasionMoves(const EnginePosition& pos, Color side, Bitboard81 checkers, MoveList& out) const;
     void generateNonEvasionMoves(const EnginePosition& pos, Color side, MoveList& out) const;
     void generateDropMoves(const EnginePosition& pos, Color side, MoveList& out) const;
 
@@ -4,6 +4,7 @@
 /// @file fmvlegalcore_internal.h
 /// @brief 合法手判定 内部ヘルパー（分割ファイル間で共有）
 
+#include "fmvbitboardattacks.h"
 #include "fmvposition.h"
 #include "fmvtypes.h"
 
@@ -82,15 +83,8 @@ inline bool isDropDeadSquare(Color side, PieceType pt, int toRank) noexcept
 /// 指定色の指定筋に歩があるか
 inline bool hasPawnOnFile(const EnginePosition& pos, Color side, int file) noexcept
 {
-    int ci = static_cast<int>(side);
-    Bitboard81 pawnBB = pos.pieceOcc[ci][static_cast<int>(PieceType::Pawn)];
-    while (pawnBB.any()) {
-        Square sq = pawnBB.popFirst();
-        if (squareFile(sq) == file) {
-            return true;
-        }
-    }
-    return false;
+    const Bitboard81& pawns = pos.pieceOcc[static_cast<int>(side)][static_cast<int>(PieceType::Pawn)];
+    return (pawns & attacks::fileMask(file)).any();
 }
 
 /// char → PieceType
@@ -119,7 +113,7 @@ inline PieceType charToPieceType(char c) noexcept
 /// 歩打ちで直接王手になるか
 inline bool givesDirectPawnCheck(const EnginePosition& pos, Color side, const Move& m) noexcept
 {
-    if (m.kind != MoveKind::Drop || m.piece != PieceType::Pawn) {
+    if (m.kind() != MoveKind::Drop || m.piece() != PieceType::Pawn) {
         return false;
     }
 
@@ -130,8 +124,8 @@ inline bool givesDirectPawnCheck(const EnginePosition& pos, Color side, const Mo
     }
 
     int forward = (side == Color::Black) ? -1 : 1;
-    int pawnFile = squareFile(m.to);
-    int pawnRank = squareRank(m.to);
+    int pawnFile = squareFile(m.to());
+    int pawnRank = squareRank(m.to());
     int expectedKingRank = pawnRank + forward;
 
     return squareFile(opKing) == pawnFile && squareRank(opKing) == expectedKingRank;
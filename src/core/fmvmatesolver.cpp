@@ -0,0 +1,463 @@
+/// @file fmvmatesolver.cpp
+/// @brief df-pn 詰将棋ソルバの実装
+
+#include "fmvmatesolver.h"
+
+#include <algorithm>
+
+namespace fmv {
+
+namespace {
+constexpr std::uint32_t kInfinite = 100000000U;
+/// 手数制限なしの探索でも経路がこれを超えたら判定不能として打ち切る
+constexpr int kMaxPly = 250;
+constexpr std::size_t kBucketSize = 4;
+/// 停止フラグ・時間を確認する間隔（ノード数、2のべき乗）。最初のノードでも確認する。
+constexpr std::uint64_t kPollInterval = 1024;
+/// 手順復元中に置換表から消えた部分を再探索してよい回数
+constexpr int kPvResearchLimit = 8;
+
+std::uint32_t saturatingAdd(std::uint32_t a, std::uint32_t b) noexcept
+{
+    const std::uint64_t sum = static_cast<std::uint64_t>(a) + b;
+    return sum >= kInfinite ? kInfinite : static_cast<std::uint32_t>(sum);
+}
+
+/// 子の閾値: parentThreshold - parentValue + childValue（無限大で頭打ち）
+std::uint32_t childThreshold(std::uint32_t parentThreshold, std::uint32_t parentValue,
+                             std::uint32_t childValue) noexcept
+{
+    const std::uint64_t t = static_cast<std::uint64_t>(parentThreshold) - parentValue + childValue;
+    return t >= kInfinite ? kInfinite : static_cast<std::uint32_t>(t);
+}
+} // namespace
+
+struct MateSolver::Entry {
+    std::uint64_t key = 0;
+    std::uint32_t pn = 1;
+    std::uint32_t dn = 1;
+    std::uint32_t searched = 0;     ///< この局面以下で展開したノード数（置き換えの優先度）
+    std::uint16_t mateLen = 0;      ///< 証明済みなら詰みまでの手数
+    std::uint16_t generation = 0;   ///< solve() ごとの世代（0 は未使用）
+    std::uint32_t pathHash = 0;     ///< 経路依存の反証が依存する祖先までの経路のハッシュ（0 は依存なし）
+    std::uint16_t pathDistance = 0; ///< その祖先までの手数
+};
+
+MateSolver::MateSolver(std::size_t hashMiB)
+{
+    const std::size_t bytes = (hashMiB == 0 ? 1 : hashMiB) * 1024 * 1024;
+    std::size_t buckets = 1;
+    while (buckets * 2 * kBucketSize * sizeof(Entry) <= bytes) {
+        buckets *= 2;
+    }
+    m_entries = std::make_unique<Entry[]>(buckets * kBucketSize);
+    m_bucketMask = buckets - 1;
+}
+
+MateSolver::~MateSolver() = default;
+
+MateResult MateSolver::solve(const EnginePosition& root, Color attacker, const MateLimits& limits,
+                             const std::atomic<bool>* stop)
+{
+    // 世代を進めて前回の結果を無効化する（一周したときだけ全消去）
+    if (++m_generation == 0) {
+        std::fill(m_entries.get(), m_entries.get() + (m_bucketMask + 1) * kBucketSize, Entry{});
+        m_generation = 1;
+    }
+    m_limits = limits;
+    m_attacker = attacker;
+    m_stop = stop;
+    m_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.timeLimitMs);
+    m_nodes = 0;
+    m_aborted = false;
+    m_path.clear();
+    m_children.clear();
+
+    EnginePosition pos = root;
+    searchNode(pos, attacker, 0, kInfinite, kInfinite);
+
+    MateResult result;
+    const NodeValue v = lookup(nodeKey(pos.zobristKey, 0));
+    if (v.pn == 0) {
+        result.status = MateStatus::Mate;
+        extractPv(pos, attacker, result.pv);
+    } else if (v.dn == 0 && !m_aborted) {
+        result.status = MateStatus::NoMate;
+    }
+    result.nodes = m_nodes;
+    return result;
+}
+
+std::uint64_t MateSolver::nodeKey(std::uint64_t positionKey, int ply) const noexcept
+{
+    if (m_limits.maxPly <= 0) {
+        return positionKey;
+    }
+    const auto remaining = static_cast<std::uint64_t>(m_limits.maxPly - ply + 1);
+    return positionKey ^ (remaining * 0x9E3779B97F4A7C15ULL);
+}
+
+MateSolver::NodeValue MateSolver::lookup(std::uint64_t key) const noexcept
+{
+    const Entry* bucket = &m_entries[(key & m_bucketMask) * kBucketSize];
+    for (std::size_t i = 0; i < kBucketSize; ++i) {
+        const Entry& e = bucket[i];
+        if (e.generation != m_generation || e.key != key) {
+            continue;
+        }
+        if (e.pathHash == 0) {
+            return {e.pn, e.dn, e.mateLen};
+        }
+        // 依存する祖先までの経路が今の経路と同じときだけ反証を使う
+        const std::size_t distance = e.pathDistance;
+        if (distance <= m_path.size() && pathHash(m_path.size(), distance) == e.pathHash) {
+            return {e.pn, e.dn, e.mateLen, static_cast<int>(m_path.size() - distance)};
+        }
+        return {};
+    }
+    return {};
+}
+
+std::uint32_t MateSolver::pathHash(std::size_t end, std::size_t distance) const noexcept
+{
+    std::uint64_t h = distance;
+    for (std::size_t i = end - distance; i < end; ++i) {
+        h = (h ^ m_path[i]) * 0x9E3779B97F4A7C15ULL;
+    }
+    return static_cast<std::uint32_t>(h >> 32) | 1U;
+}
+
+void MateSolver::store(std::uint64_t key, const NodeValue& v, std::uint32_t searched) noexcept
+{
+    Entry* bucket = &m_entries[(key & m_bucketMask) * kBucketSize];
+    Entry* victim = nullptr;
+    for (std::size_t i = 0; i < kBucketSize; ++i) {
+        Entry& e = bucket[i];
+        if (e.generation != m_generation || e.key == key) {
+            victim = &e;
+            break;
+        }
+        // 探索量の少ない未確定の局面から捨てる（証明・反証済みは残しやすくする）
+        const bool settled = e.pn == 0 || e.dn == 0;
+        const bool victimSettled = victim && (victim->pn == 0 || victim->dn == 0);
+        if (!victim || (victimSettled && !settled)
+            || (victimSettled == settled && e.searched < victim->searched)) {
+            victim = &e;
+        }
+    }
+    victim->key = key;
+    victim->pn = v.pn;
+    victim->dn = v.dn;
+    victim->mateLen = v.mateLen;
+    victim->searched = searched;
+    victim->generation = m_generation;
+
+    // 自分より上の祖先への再到達に依存する反証は、その祖先までの経路とあわせて保存する
+    // （自分自身への再到達は、どの経路から来ても同じく千日手になるので依存しない）
+    const std::size_t self = m_path.empty() ? 0 : m_path.size() - 1;
+    if (v.dn == 0 && v.dependsOn >= 0 && static_cast<std::size_t>(v.dependsOn) < self) {
+        const std::size_t distance = self - static_cast<std::size_t>(v.dependsOn);
+        victim->pathHash = pathHash(self, distance);
+        victim->pathDistance = static_cast<std::uint16_t>(distance);
+    } else {
+        victim->pathHash = 0;
+        victim->pathDistance = 0;
+    }
+}
+
+bool MateSolver::shouldAbort() noexcept
+{
+    if (m_aborted) {
+        return true;
+    }
+    if (m_limits.maxNodes > 0 && m_nodes >= m_limits.maxNodes) {
+        m_aborted = true;
+    } else if (((m_nodes - 1) & (kPollInterval - 1)) == 0) {
+        m_aborted = (m_stop && m_stop->load(std::memory_order_relaxed))
+                    || (m_limits.timeLimitMs > 0 && std::chrono::steady_clock::now() >= m_deadline);
+    }
+    return m_aborted;
+}
+
+int MateSolver::pathIndexOf(std::uint64_t positionKey) const noexcept
+{
+    const auto it = std::find(m_path.begin(), m_path.end(), positionKey);
+    return it == m_path.end() ? -1 : static_cast<int>(it - m_path.begin());
+}
+
+void MateSolver::generateNodeMoves(EnginePosition& pos, Color side, int ply, MoveList& out) const
+{
+    if (side == m_attacker) {
+        // 手数制限に達した攻方は指せない（= 制限内に詰まない）
+        if (m_limits.maxPly <= 0 || ply < m_limits.maxPly) {
+            m_core.generateCheckMoves(pos, side, out);
+        }
+    } else {
+        m_core.generateLegalMoves(pos, side, out);
+    }
+}
+
+void MateSolver::searchNode(EnginePosition& pos, Color side, int ply, std::uint32_t pnThreshold,
+                            std::uint32_t dnThreshold)
+{
+    ++m_nodes;
+    if (shouldAbort()) {
+        return;
+    }
+    if (ply >= kMaxPly) {
+        m_aborted = true;
+        return;
+    }
+
+    const bool orNode = side == m_attacker;
+    const std::uint64_t key = nodeKey(pos.zobristKey, ply);
+    const std::uint64_t nodesBefore = m_nodes;
+
+    // 子の一覧は再帰で積み増す共有スタックに置く（深い手順でもスレッドのスタックを使い切らない）
+    const std::size_t base = m_children.size();
+    {
+        MoveList moves;
+        generateNodeMoves(pos, side, ply, moves);
+        for (const Move& m : moves) {
+            UndoState undo;
+            if (pos.doMove(m, side, undo)) {
+                m_children.push_back({m, pos.zobristKey, {}});
+                pos.undoMove(undo, side);
+            }
+        }
+    }
+    const std::size_t count = m_children.size() - base;
+
+    // 王手がない攻方は不詰、応手がない玉方は詰み。
+    // 手数制限の最終手で玉方に応手があれば、攻方はもう王手できないので不詰。
+    const bool lastPlyEvaded = !orNode && count > 0 && m_limits.maxPly > 0 && ply + 1 >= m_limits.maxPly;
+    if (count == 0 || lastPlyEvaded) {
+        NodeValue v;
+        const bool mated = !orNode && count == 0;
+        v.pn = mated ? 0 : kInfinite;
+        v.dn = mated ? kInfinite : 0;
+        store(key, v, 1);
+        m_children.resize(base);
+        return;
+    }
+
+    // 子の値は最初に一度だけ引き、以降は探索した子だけ引き直す（経路上の子は攻方の失敗で固定）
+    m_path.push_back(pos.zobristKey);
+    for (std::size_t i = base; i < base + count; ++i) {
+        Child& c = m_children[i];
+        const int repeated = pathIndexOf(c.positionKey);
+        c.value = repeated >= 0 ? NodeValue{kInfinite, 0, 0, repeated} : lookup(nodeKey(c.positionKey, ply + 1));
+    }
+
+    const Color next = opposite(side);
+    while (true) {
+        // OR 節点: pn = min(子の pn), dn = Σ子の dn。AND 節点はその逆。
+        NodeValue v;
+        v.pn = orNode ? kInfinite : 0;
+        v.dn = orNode ? 0 : kInfinite;
+        std::uint32_t second = kInfinite;
+        std::size_t best = base;
+        std::uint32_t bestPn = kInfinite;
+        std::uint32_t bestDn = kInfinite;
+        std::uint16_t len = orNode ? 0xFFFF : 0;
+        // 反証の経路依存: OR 節点は全ての子のうち最も浅い祖先、AND 節点は依存の最も浅くない反証の子による
+        int orDependsOn = -1;
+        int andDependsOn = -2;  // -2: 反証済みの子がまだない
+        for (std::size_t i = base; i < base + count; ++i) {
+            const NodeValue& c = m_children[i].value;
+            if (c.dn == 0 && c.dependsOn >= 0) {
+                orDependsOn = orDependsOn < 0 ? c.dependsOn : std::min(orDependsOn, c.dependsOn);
+            }
+            if (c.dn == 0 && andDependsOn != -1) {
+                andDependsOn = c.dependsOn < 0 ? -1 : std::max(andDependsOn, c.dependsOn);
+            }
+            const std::uint32_t value = orNode ? c.pn : c.dn;
+            std::uint32_t& minimum = orNode ? v.pn : v.dn;
+            if (value < minimum) {
+                second = minimum;
+                minimum = value;
+                best = i;
+                bestPn = c.pn;
+                bestDn = c.dn;
+            } else if (value < second) {
+                second = value;
+            }
+            if (orNode) {
+                v.dn = saturatingAdd(v.dn, c.dn);
+                if (c.pn == 0) {
+                    len = std::min(len, c.mateLen);
+                }
+            } else {
+                v.pn = saturatingAdd(v.pn, c.pn);
+                len = std::max(len, c.mateLen);
+            }
+        }
+        if (v.pn == 0) {
+            v.mateLen = static_cast<std::uint16_t>(len + 1);
+        }
+        if (v.dn == 0) {
+            v.dependsOn = orNode ? orDependsOn : andDependsOn;
+        }
+        const std::uint64_t spent = m_nodes - nodesBefore + 1;
+        store(key, v, static_cast<std::uint32_t>(std::min<std::uint64_t>(spent, kInfinite)));
+
+        if (v.pn >= pnThreshold || v.dn >= dnThreshold || m_aborted) {
+            break;
+        }
+
+        std::uint32_t childPn = 0;
+        std::uint32_t childDn = 0;
+        if (orNode) {
+            childPn = std::min(pnThreshold, saturatingAdd(second, 1));
+            childDn = childThreshold(dnThreshold, v.dn, bestDn);
+        } else {
+            childPn = childThreshold(pnThreshold, v.pn, bestPn);
+            childDn = std::min(dnThreshold, saturatingAdd(second, 1));
+        }
+
+        const Move m = m_children[best].move;
+        UndoState undo;
+        if (!pos.doMove(m, side, undo)) {
+            break;
+        }
+        searchNode(pos, next, ply + 1, childPn, childDn);
+        pos.undoMove(undo, side);
+        m_children[best].value = lookup(nodeKey(m_children[best].positionKey, ply + 1));
+    }
+    m_path.pop_back();
+    m_children.resize(base);
+}
+
+void MateSolver::extractPv(EnginePosition& pos, Color attacker, std::vector<Move>& pv)
+{
+    // 攻方は最短、玉方は最長の証明済みの子をたどる
+    Color side = attacker;
+    int researchBudget = kPvResearchLimit;
+    m_path.clear();
+    for (int ply = 0; ply < kMaxPly; ++ply) {
+        MoveList moves;
+        generateNodeMoves(pos, side, ply, moves);
+        if (moves.size == 0) {
+            break;
+        }
+
+        const bool orNode = side == attacker;
+        Move chosen = Move::none();
+        int chosenLen = orNode ? kMaxPly + 1 : -1;
+        bool complete = true;
+        for (const Move& m : moves) {
+            UndoState undo;
+            if (!pos.doMove(m, side, undo)) {
+                continue;
+            }
+            const NodeValue c = lookup(nodeKey(pos.zobristKey, ply + 1));
+            pos.undoMove(undo, side);
+            if (c.pn != 0) {
+                complete = complete && orNode;
+                continue;
+            }
+            if (orNode ? c.mateLen < chosenLen : c.mateLen > chosenLen) {
+                chosen = m;
+                chosenLen = c.mateLen;
+            }
+        }
+
+        // 置換表から証明の一部が追い出されていたら、この局面だけ探索し直す
+        if (chosen == Move::none() || !complete) {
+            if (researchBudget-- <= 0) {
+                break;
+            }
+            m_aborted = false;
+            searchNode(pos, side, ply, kInfinite, kInfinite);
+            --ply;
+            continue;
+        }
+
+        m_path.push_back(pos.zobristKey);
+        UndoState undo;
+        if (!pos.doMove(chosen, side, undo)) {
+            break;
+        }
+        pv.push_back(chosen);
+        side = opposite(side);
+    }
+}
+
+namespace {
+
+/// 1手詰めの王手を探す（なければ Move::none()）
+Move findMateInOne(EnginePosition& pos, Color attacker, const LegalCore& core)
+{
+    MoveList checks;
+    core.generateCheckMoves(pos, attacker, checks);
+    const Color defender = opposite(attacker);
+    for (const Move& m : checks) {
+        UndoState undo;
+        if (!pos.doMove(m, attacker, undo)) {
+            continue;
+        }
+        const bool mated = core.countLegalMoves(pos, defender) == 0;
+        pos.undoMove(undo, attacker);
+        if (mated) {
+            return m;
+        }
+    }
+    return Move::none();
+}
+
+} // namespace
+
+bool findShortMate(EnginePosition& pos, Color attacker, int maxPly, std::vector<Move>& pv)
+{
+    const LegalCore core;
+    pv.clear();
+
+    const Move mateInOne = findMateInOne(pos, attacker, core);
+    if (mateInOne != Move::none()) {
+        pv.push_back(mateInOne);
+        return true;
+    }
+    if (maxPly < 3) {
+        return false;
+    }
+
+    // 3手詰め: どの応手にも1手詰めが残る王手を探す
+    const Color defender = opposite(attacker);
+    MoveList checks;
+    core.generateCheckMoves(pos, attacker, checks);
+    for (const Move& check : checks) {
+        UndoState checkUndo;
+        if (!pos.doMove(check, attacker, checkUndo)) {
+            continue;
+        }
+        MoveList evasions;
+        core.generateLegalMoves(pos, defender, evasions);
+        Move sampleEvasion = Move::none();
+        Move sampleMate = Move::none();
+        bool allMated = evasions.size > 0;
+        for (const Move& evasion : evasions) {
+            UndoState evasionUndo;
+            if (!pos.doMove(evasion, defender, evasionUndo)) {
+                continue;
+            }
+            const Move reply = findMateInOne(pos, attacker, core);
+            pos.undoMove(evasionUndo, defender);
+            if (reply == Move::none()) {
+                allMated = false;
+                break;
+            }
+            if (sampleEvasion == Move::none()) {
+                sampleEvasion = evasion;
+                sampleMate = reply;
+            }
+        }
+        pos.undoMove(checkUndo, attacker);
+        if (allMated && sampleEvasion != Move::none()) {
+            pv = {check, sampleEvasion, sampleMate};
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace fmv
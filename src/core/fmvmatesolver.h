@@ -0,0 +1,126 @@
+#ifndef FMVMATESOLVER_H
+#define FMVMATESOLVER_H
+
+/// @file fmvmatesolver.h
+/// @brief df-pn による詰将棋ソルバ（USI エンジンを使わない詰み探索）
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "fmvlegalcore.h"
+#include "fmvposition.h"
+#include "fmvtypes.h"
+
+namespace fmv {
+
+/// 詰み探索の結果種別
+enum class MateStatus : std::uint8_t {
+    Mate,     ///< 詰みあり（pv に手順）
+    NoMate,   ///< 不詰（手数制限がある場合は制限内に詰みなし）
+    Unknown   ///< ノード数・時間の上限や中断により判定できなかった
+};
+
+/// 詰み探索の打ち切り条件（0 は無制限）
+struct MateLimits {
+    std::uint64_t maxNodes = 0;  ///< 展開ノード数の上限
+    int timeLimitMs = 0;         ///< 探索時間の上限(ms)
+    int maxPly = 0;              ///< 詰み手数の上限（攻方・玉方の手を合わせた手数）
+};
+
+struct MateResult {
+    MateStatus status = MateStatus::Unknown;
+    std::vector<Move> pv;        ///< 詰み手順（攻方の初手から）
+    std::uint64_t nodes = 0;     ///< 展開ノード数
+};
+
+/**
+ * @brief 証明数・反証数による詰み探索（df-pn）
+ *
+ * 攻方の手は generateCheckMoves の王手のみ、玉方の手は全合法手を展開する。
+ * 証明数・反証数は Zobrist キーで引く置換表に保持し、同じ局面への合流を共有する。
+ * 手数制限つきの探索では残り手数をキーに混ぜ、深さの違う合流で結果を取り違えない。
+ * 探索経路上の局面への再到達（千日手）は攻方の失敗として扱う。この反証は経路に依存するので、
+ * 置換表には依存する祖先までの経路のハッシュを添え、経路が一致するときだけ使う
+ * （別の経路から合流したときは探索し直す）。
+ *
+ * スレッドセーフではない（スレッドごとに1インスタンスを使う）。
+ */
+class MateSolver
+{
+public:
+    /// @param hashMiB 置換表のサイズ（MiB）
+    explicit MateSolver(std::size_t hashMiB = 16);
+    ~MateSolver();
+
+    MateSolver(const MateSolver&) = delete;
+    MateSolver& operator=(const MateSolver&) = delete;
+
+    /**
+     * @brief attacker 番の root から詰みを探す
+     * @param stop 非 null なら探索中に定期的に参照し、true で中断する
+     */
+    MateResult solve(const EnginePosition& root, Color attacker, const MateLimits& limits,
+                     const std::atomic<bool>* stop = nullptr);
+
+private:
+    struct Entry;
+    struct NodeValue {
+        std::uint32_t pn = 1;
+        std::uint32_t dn = 1;
+        std::uint16_t mateLen = 0;
+        int dependsOn = -1;  ///< 反証が依存する経路上の祖先（m_path の添字。-1 は経路に依存しない）
+    };
+    struct Child {
+        Move move;
+        std::uint64_t positionKey;  ///< 指した後の局面の Zobrist キー
+        NodeValue value;            ///< 置換表から引いた証明数・反証数
+    };
+
+    std::uint64_t nodeKey(std::uint64_t positionKey, int ply) const noexcept;
+    /// m_path の末尾を親とする局面の値を引く（経路の合わない経路依存の反証は未探索として返す）
+    NodeValue lookup(std::uint64_t key) const noexcept;
+    /// m_path の末尾の局面の値を保存する
+    void store(std::uint64_t key, const NodeValue& v, std::uint32_t searched) noexcept;
+    /// m_path[end - distance, end) のハッシュ（経路依存の反証の照合用。0 にはならない）
+    std::uint32_t pathHash(std::size_t end, std::size_t distance) const noexcept;
+
+    void searchNode(EnginePosition& pos, Color side, int ply, std::uint32_t pnThreshold,
+                    std::uint32_t dnThreshold);
+    void generateNodeMoves(EnginePosition& pos, Color side, int ply, MoveList& out) const;
+    /// 経路上にある局面の m_path での添字（なければ -1）
+    int pathIndexOf(std::uint64_t positionKey) const noexcept;
+    bool shouldAbort() noexcept;
+    void extractPv(EnginePosition& pos, Color attacker, std::vector<Move>& pv);
+
+    std::unique_ptr<Entry[]> m_entries;
+    std::size_t m_bucketMask = 0;
+    std::uint16_t m_generation = 0;
+
+    LegalCore m_core;
+    MateLimits m_limits;
+    Color m_attacker = Color::Black;
+    const std::atomic<bool>* m_stop = nullptr;
+    std::chrono::steady_clock::time_point m_deadline;
+    std::uint64_t m_nodes = 0;
+    bool m_aborted = false;
+    std::vector<std::uint64_t> m_path; ///< 探索経路上の局面キー（千日手検出用）
+    std::vector<Child> m_children;     ///< 経路上の各節点の子（節点ごとに末尾へ積む）
+};
+
+/**
+ * @brief 1手・3手詰めを全幅で調べる（df-pn を起こす前の安価な前判定）
+ *
+ * 置換表を使わず LegalCore の王手生成と応手生成だけで読む。駒の少ない生成局面では
+ * df-pn の初期化や置換表参照より速く、短い詰みのある局面をまとめて弾ける。
+ * @param maxPly 1 または 3（それ以外は 3 とみなす）
+ * @param pv 詰む場合に最短の手順を格納する（3手詰めでは玉方の応手は一例）
+ * @return maxPly 手以内に詰めば true
+ */
+bool findShortMate(EnginePosition& pos, Color attacker, int maxPly, std::vector<Move>& pv);
+
+} // namespace fmv
+
+#endif // FMVMATESOLVER_H
@@ -2,23 +2,17 @@
 /// @brief 合法手生成の実装
 
 #include "fmvlegalcore.h"
-#include "fmvattacks.h"
+#include "fmvbitboardattacks.h"
 #include "fmvlegalcore_internal.h"
 
+#include <array>
+
 namespace fmv {
 
-using detail::charToPieceType;
-using detail::givesDirectPawnCheck;
-using detail::isDropDeadSquare;
-using detail::isMandatoryPromotion;
 using detail::isPromotable;
 using detail::isPromotionZone;
 
 namespace {
-bool inBoard(int file, int rank) noexcept
-{
-    return file >= 0 && file < kBoardSize && rank >= 0 && rank < kBoardSize;
-}
 PieceType handTypeToPieceType(HandType ht) noexcept
 {
     switch (ht) {
@@ -33,151 +27,138 @@ PieceType handTypeToPieceType(HandType ht) noexcept
     }
 }
 
-void addBoardMoves(const EnginePosition& pos, Color side,
-                   Square from, PieceType pt,
-                   int df, int dr, bool isRay,
-                   MoveList& out) noexcept
+PieceType promotedPieceType(PieceType pt) noexcept
 {
-    int ci = static_cast<int>(side);
-    int file = squareFile(from) + df;
-    int rank = squareRank(from) + dr;
+    switch (pt) {
+    case PieceType::Pawn:   return PieceType::ProPawn;
+    case PieceType::Lance:  return PieceType::ProLance;
+    case PieceType::Knight: return PieceType::ProKnight;
+    case PieceType::Silver: return PieceType::ProSilver;
+    case PieceType::Bishop: return PieceType::Horse;
+    case PieceType::Rook:   return PieceType::Dragon;
+    default: return pt;
+    }
+}
 
-    auto addOne = [&](int f, int r) {
-        if (!inBoard(f, r)) {
-            return false;
-        }
-        Square to = toSquare(f, r);
-        // 味方駒がいれば不可
-        if (pos.colorOcc[ci].test(to)) {
-            return false;
-        }
+/// 開き王手の候補: 相手玉と自分の走り駒の間にちょうど1枚ある自駒と、その直線
+struct DiscoveredChecks {
+    Bitboard81 blockers;
+    int count = 0;
+    std::array<Square, 8> from{};     ///< 遮っている自駒のマス
+    std::array<Bitboard81, 8> line{}; ///< 玉と走り駒の間のマス（ここへ動く手は遮ったまま）
+};
 
-        int fromRank = squareRank(from);
-        int toRank = r;
-        bool canPromote = isPromotable(pt)
-                          && (isPromotionZone(side, fromRank) || isPromotionZone(side, toRank));
-        bool mandatory = isMandatoryPromotion(side, pt, toRank);
-
-        if (!mandatory) {
-            Move m;
-            m.kind = MoveKind::Board;
-            m.from = from;
-            m.to = to;
-            m.piece = pt;
-            m.promote = false;
-            out.push(m);
+DiscoveredChecks computeDiscoveredChecks(const EnginePosition& pos, Color side, Square enemyKing) noexcept
+{
+    DiscoveredChecks dc;
+    const auto& own = pos.pieceOcc[static_cast<int>(side)];
+    auto bb = [&own](PieceType pt) -> const Bitboard81& {
+        return own[static_cast<int>(pt)];
+    };
+    // 相手玉から見た向きで引くため、香は相手の色で利きを取る
+    const Bitboard81 empty;
+    Bitboard81 snipers =
+        (attacks::rookAttacks(enemyKing, empty) & (bb(PieceType::Rook) | bb(PieceType::Dragon)))
+        | (attacks::bishopAttacks(enemyKing, empty) & (bb(PieceType::Bishop) | bb(PieceType::Horse)))
+        | (attacks::lanceAttacks(opposite(side), enemyKing, empty) & bb(PieceType::Lance));
+    while (snipers.any() && dc.count < static_cast<int>(dc.from.size())) {
+        const Square sniper = snipers.popFirst();
+        const Bitboard81 line = attacks::between(enemyKing, sniper);
+        Bitboard81 blockers = line & pos.occupied;
+        if (blockers.count() != 1 || (blockers & pos.colorOcc[static_cast<int>(side)]).none()) {
+            continue;
         }
-        if (canPromote) {
-            Move m;
-            m.kind = MoveKind::Board;
-            m.from = from;
-            m.to = to;
-            m.piece = pt;
-            m.promote = true;
-            out.push(m);
+        dc.blockers |= blockers;
+        dc.from[static_cast<std::size_t>(dc.count)] = blockers.popFirst();
+        dc.line[static_cast<std::size_t>(dc.count)] = line;
+        ++dc.count;
+    }
+    return dc;
+}
+
+/// 疑似合法手 m が相手玉 enemyKing に王手をかけるか
+bool givesCheck(const EnginePosition& pos, Color side, const Move& m, Square enemyKing,
+                const DiscoveredChecks& dc) noexcept
+{
+    const PieceType moved = m.promote() ? promotedPieceType(m.piece()) : m.piece();
+    Bitboard81 occ = pos.occupied;
+    if (!m.isDrop()) {
+        occ.clear(m.from());
+    }
+    occ.set(m.to());
+    if (attacks::pieceAttacks(side, moved, m.to(), occ).test(enemyKing)) {
+        return true;
+    }
+    if (m.isDrop() || !dc.blockers.test(m.from())) {
+        return false;
+    }
+    for (int i = 0; i < dc.count; ++i) {
+        const auto idx = static_cast<std::size_t>(i);
+        if (dc.from[idx] == m.from() && !dc.line[idx].test(m.to())) {
+            return true;
         }
+    }
+    return false;
+}
 
-        // レイ走査で相手駒に当たったら停止
-        return pos.occupied.test(to);
-    };
+/// from の駒 pt を targets の各マスへ動かす指し手を追加する。
+/// 成りは敵陣マスク、不成の可否は行き所のないマスのマスクで一括判定する。
+void addBoardMoves(Color side, Square from, PieceType pt,
+                   const Bitboard81& targets, MoveList& out) noexcept
+{
+    Bitboard81 nonPromo = targets & ~attacks::deadSquares(side, pt);
+    while (nonPromo.any()) {
+        out.push(Move::makeBoard(from, nonPromo.popFirst(), pt));
+    }
 
-    if (!isRay) {
-        addOne(file, rank);
-    } else {
-        while (inBoard(file, rank)) {
-            if (addOne(file, rank)) {
-                break;
-            }
-            file += df;
-            rank += dr;
-        }
+    if (!isPromotable(pt)) {
+        return;
+    }
+    Bitboard81 promo = isPromotionZone(side, squareRank(from))
+                           ? targets
+                           : targets & attacks::promotionZone(side);
+    while (promo.any()) {
+        out.push(Move::makeBoard(from, promo.popFirst(), pt, true));
     }
 }
 
-void generatePieceMoves(const EnginePosition& pos, Color side,
-                        Square from, PieceType pt,
-                        MoveList& out) noexcept
+/// 玉以外の全駒について、利き先のうち target に含まれるマスへの指し手を追加する
+void addTargetMoves(const EnginePosition& pos, Color side,
+                    const Bitboard81& target, MoveList& out) noexcept
 {
-    int forward = (side == Color::Black) ? -1 : 1;
+    const int ci = static_cast<int>(side);
+    for (int pti = 0; pti < static_cast<int>(PieceType::PieceTypeNb); ++pti) {
+        const auto pt = static_cast<PieceType>(pti);
+        if (pt == PieceType::King) {
+            continue;
+        }
+        Bitboard81 pieces = pos.pieceOcc[ci][pti];
+        while (pieces.any()) {
+            const Square from = pieces.popFirst();
+            addBoardMoves(side, from, pt,
+                          attacks::pieceAttacks(side, pt, from, pos.occupied) & target, out);
+        }
+    }
+}
 
-    switch (pt) {
-    case PieceType::Pawn:
-        addBoardMoves(pos, side, from, pt, 0, forward, false, out);
-        break;
-    case PieceType::Lance:
-        addBoardMoves(pos, side, from, pt, 0, forward, true, out);
-        break;
-    case PieceType::Knight:
-        addBoardMoves(pos, side, from, pt, -1, 2 * forward, false, out);
-        addBoardMoves(pos, side, from, pt,  1, 2 * forward, false, out);
-        break;
-    case PieceType::Silver:
-        addBoardMoves(pos, side, from, pt, -1, forward, false, out);
-        addBoardMoves(pos, side, from, pt,  0, forward, false, out);
-        addBoardMoves(pos, side, from, pt,  1, forward, false, out);
-        addBoardMoves(pos, side, from, pt, -1, -forward, false, out);
-        addBoardMoves(pos, side, from, pt,  1, -forward, false, out);
-        break;
-    case PieceType::Gold:
-    case PieceType::ProPawn:
-    case PieceType::ProLance:
-    case PieceType::ProKnight:
-    case PieceType::ProSilver:
-        addBoardMoves(pos, side, from, pt, -1, forward, false, out);
-        addBoardMoves(pos, side, from, pt,  0, forward, false, out);
-        addBoardMoves(pos, side, from, pt,  1, forward, false, out);
-        addBoardMoves(pos, side, from, pt, -1, 0, false, out);
-        addBoardMoves(pos, side, from, pt,  1, 0, false, out);
-        addBoardMoves(pos, side, from, pt,  0, -forward, false, out);
-        break;
-    case PieceType::King:
-        for (int dr = -1; dr <= 1; ++dr) {
-            for (int df = -1; df <= 1; ++df) {
-                if (df == 0 && dr == 0) {
-                    continue;
-                }
-                addBoardMoves(pos, side, from, pt, df, dr, false, out);
-            }
+/// 持ち駒を target（空きマス）へ打つ指し手を追加する
+void addDropMoves(const EnginePosition& pos, Color side,
+                  const Bitboard81& target, MoveList& out) noexcept
+{
+    const int ci = static_cast<int>(side);
+    for (int hti = 0; hti < static_cast<int>(HandType::HandTypeNb); ++hti) {
+        if (pos.hand[ci][static_cast<std::size_t>(hti)] <= 0) {
+            continue;
+        }
+        const PieceType pt = handTypeToPieceType(static_cast<HandType>(hti));
+        Bitboard81 to = target & ~attacks::deadSquares(side, pt);
+        if (pt == PieceType::Pawn) {
+            // 二歩: 自分の歩がある筋を丸ごと除く
+            to &= ~attacks::filesOf(pos.pieceOcc[ci][static_cast<int>(PieceType::Pawn)]);
+        }
+        while (to.any()) {
+            out.push(Move::makeDrop(pt, to.popFirst()));
         }
-        break;
-    case PieceType::Bishop:
-        addBoardMoves(pos, side, from, pt, -1, -1, true, out);
-        addBoardMoves(pos, side, from, pt,  1, -1, true, out);
-        addBoardMoves(pos, side, from, pt, -1,  1, true, out);
-        addBoardMoves(pos, side, from, pt,  1,  1, true, out);
-        break;
-    case PieceType::Rook:
-        addBoardMoves(pos, side, from, pt, 0, -1, true, out);
-        addBoardMoves(pos, side, from, pt, 0,  1, true, out);
-        addBoardMoves(pos, side, from, pt, -1, 0, true, out);
-        addBoardMoves(pos, side, from, pt,  1, 0, true, out);
-        break;
-    case PieceType::Horse:
-        // 斜め走り
-        addBoardMoves(pos, side, from, pt, -1, -1, true, out);
-        addBoardMoves(pos, side, from, pt,  1, -1, true, out);
-        addBoardMoves(pos, side, from, pt, -1,  1, true, out);
-        addBoardMoves(pos, side, from, pt,  1,  1, true, out);
-        // 十字ステップ
-        addBoardMoves(pos, side, from, pt,  0, -1, false, out);
-        addBoardMoves(pos, side, from, pt,  0,  1, false, out);
-        addBoardMoves(pos, side, from, pt, -1,  0, false, out);
-        addBoardMoves(pos, side, from, pt,  1,  0, false, out);
-        break;
-    case PieceType::Dragon:
-        // 縦横走り
-        addBoardMoves(pos, side, from, pt, 0, -1, true, out);
-        addBoardMoves(pos, side, from, pt, 0,  1, true, out);
-        addBoardMoves(pos, side, from, pt, -1, 0, true, out);
-        addBoardMoves(pos, side, from, pt,  1, 0, true, out);
-        // 斜めステップ
-        addBoardMoves(pos, side, from, pt, -1, -1, false, out);
-        addBoardMoves(pos, side, from, pt,  1, -1, false, out);
-        addBoardMoves(pos, side, from, pt, -1,  1, false, out);
-        addBoardMoves(pos, side, from, pt,  1,  1, false, out);
-        break;
-    default:
-        break;
     }
 }
 
@@ -185,87 +166,67 @@ void generatePieceMoves(const EnginePosition& pos, Color side,
 
 void LegalCore::generateLegalMoves(EnginePosition& pos, Color side, MoveList& out) const
 {
+    const CheckInfo info = computeCheckInfo(pos, side);
     MoveList pseudo;
-    pseudo.clear();
+    generatePseudoMoves(pos, side, info, pseudo);
 
-    if (ownKingInCheck(pos, side)) {
-        generateEvasionMoves(pos, side, pseudo);
-    } else {
-        generateNonEvasionMoves(pos, side, pseudo);
-        generateDropMoves(pos, side, pseudo);
+    for (int i = 0; i < pseudo.size; ++i) {
+        const Move& m = pseudo.moves[static_cast<std::size_t>(i)];
+        if (isLegalGenerated(pos, side, m, info)) {
+            out.push(m);
+        }
+    }
+}
+
+void LegalCore::generateCheckMoves(EnginePosition& pos, Color side, MoveList& out) const
+{
+    const Square enemyKing = pos.kingSq[static_cast<int>(opposite(side))];
+    if (enemyKing == kInvalidSquare) {
+        return;
     }
+    const CheckInfo info = computeCheckInfo(pos, side);
+    MoveList pseudo;
+    generatePseudoMoves(pos, side, info, pseudo);
 
+    // 王手判定は差分の利き計算だけで済むので、合法性（do/undo を伴いうる）より先に絞る
+    const DiscoveredChecks dc = computeDiscoveredChecks(pos, side, enemyKing);
     for (int i = 0; i < pseudo.size; ++i) {
         const Move& m = pseudo.moves[static_cast<std::size_t>(i)];
-
-        if (m.kind == MoveKind::Drop && m.piece == PieceType::Pawn) {
-            UndoState undo;
-            if (!pos.doMove(m, side, undo)) {
-                continue;
-            }
-            bool selfCheck = ownKingInCheck(pos, side);
-            bool pawnDropMate = false;
-            if (!selfCheck && givesDirectPawnCheck(pos, side, m)) {
-                Color opponent = opposite(side);
-                if (!hasAnyLegalMove(pos, opponent)) {
-                    pawnDropMate = true;
-                }
-            }
-            pos.undoMove(undo, side);
-            if (!selfCheck && !pawnDropMate) {
-                out.push(m);
-            }
-        } else {
-            if (isLegalAfterDoUndo(pos, side, m)) {
-                out.push(m);
-            }
+        if (givesCheck(pos, side, m, enemyKing, dc) && isLegalGenerated(pos, side, m, info)) {
+            out.push(m);
         }
     }
 }
 
 int LegalCore::countLegalMoves(EnginePosition& pos, Color side) const
 {
+    const CheckInfo info = computeCheckInfo(pos, side);
     MoveList pseudo;
-    pseudo.clear();
-
-    if (ownKingInCheck(pos, side)) {
-        generateEvasionMoves(pos, side, pseudo);
-    } else {
-        generateNonEvasionMoves(pos, side, pseudo);
-        generateDropMoves(pos, side, pseudo);
-    }
+    generatePseudoMoves(pos, side, info, pseudo);
 
     int legalCount = 0;
     for (int i = 0; i < pseudo.size; ++i) {
-        const Move& m = pseudo.moves[static_cast<std::size_t>(i)];
-
-        if (m.kind == MoveKind::Drop && m.piece == PieceType::Pawn) {
-            UndoState undo;
-            if (!pos.doMove(m, side, undo)) {
-                continue;
-            }
-            bool selfCheck = ownKingInCheck(pos, side);
-            bool pawnDropMate = false;
-            if (!selfCheck && givesDirectPawnCheck(pos, side, m)) {
-                Color opponent = opposite(side);
-                if (!hasAnyLegalMove(pos, opponent)) {
-                    pawnDropMate = true;
-                }
-            }
-            pos.undoMove(undo, side);
-            if (!selfCheck && !pawnDropMate) {
-                ++legalCount;
-            }
-        } else {
-            if (isLegalAfterDoUndo(pos, side, m)) {
-                ++legalCount;
-            }
+        if (isLegalGenerated(pos, side, pseudo.moves[static_cast<std::size_t>(i)], info)) {
+            ++legalCount;
         }
     }
     return legalCount;
 }
 
-void LegalCore::generateEvasionMoves(const EnginePosition& pos, Color side, MoveList& out) const
+void LegalCore::generatePseudoMoves(const EnginePosition& pos, Color side, const CheckInfo& info,
+                                    MoveList& out) const
+{
+    out.clear();
+    if (info.checkers.any()) {
+        generateEvasionMoves(pos, side, info.checkers, out);
+    } else {
+        generateNonEvasionMoves(pos, side, out);
+        generateDropMoves(pos, side, out);
+    }
+}
+
+void LegalCore::generateEvasionMoves(const EnginePosition& pos, Color side, Bitboard81 checkers,
+                                     MoveList& out) const
 {
     int ci = static_cast<int>(side);
     Square king = pos.kingSq[ci];
@@ -273,216 +234,50 @@ void LegalCore::generateEvasionMoves(const EnginePosition& pos, Color side, Move
         return;
     }
 
-    generatePieceMoves(pos, side, king, PieceType::King, out);
-    Bitboard81 checkers = attackersTo(pos, king, opposite(side));
+    const Bitboard81 notOwn = ~pos.colorOcc[ci];
+    addBoardMoves(side, king, PieceType::King,
+                  attacks::stepAttacks(side, PieceType::King, king) & notOwn, out);
+
     if (checkers.count() != 1) {
         return; // 両王手は玉逃げのみ
     }
 
-    Square checkerSq = checkers.popFirst();
-
-    Bitboard81 myPieces = pos.colorOcc[ci];
-    Bitboard81 tmp = myPieces;
-    while (tmp.any()) {
-        Square from = tmp.popFirst();
-        if (from == king) {
-            continue;
-        }
-        char c = pos.board[from];
-        PieceType pt = charToPieceType(c);
-        if (pt == PieceType::PieceTypeNb) {
-            continue;
-        }
-
-        int fromRank = squareRank(from);
-        int toRank = squareRank(checkerSq);
-        bool canPromote = isPromotable(pt)
-                          && (isPromotionZone(side, fromRank) || isPromotionZone(side, toRank));
-        bool mandatory = isMandatoryPromotion(side, pt, toRank);
-
-        Move capMove;
-        capMove.kind = MoveKind::Board;
-        capMove.from = from;
-        capMove.to = checkerSq;
-        capMove.piece = pt;
-
-        if (!mandatory) {
-            capMove.promote = false;
-            out.push(capMove);
-        }
-        if (canPromote) {
-            capMove.promote = true;
-            out.push(capMove);
-        }
-    }
-
-    PieceType checkerType = charToPieceType(pos.board[checkerSq]);
-    bool isSlider = (checkerType == PieceType::Lance || checkerType == PieceType::Bishop
-                     || checkerType == PieceType::Rook || checkerType == PieceType::Horse
-                     || checkerType == PieceType::Dragon);
-    if (!isSlider) {
-        return;
-    }
-
-    int kf = squareFile(king);
-    int kr = squareRank(king);
-    int cf = squareFile(checkerSq);
-    int cr = squareRank(checkerSq);
-    int stepF = 0;
-    int stepR = 0;
-    if (cf < kf) stepF = 1;
-    else if (cf > kf) stepF = -1;
-    if (cr < kr) stepR = 1;
-    else if (cr > kr) stepR = -1;
-
-    int f = cf + stepF;
-    int r = cr + stepR;
-    while (f != kf || r != kr) {
-        Square between = toSquare(f, r);
-
-        // 盤上駒で合駒
-        Bitboard81 tmp2 = myPieces;
-        while (tmp2.any()) {
-            Square from = tmp2.popFirst();
-            if (from == king) {
-                continue;
-            }
-            char c = pos.board[from];
-            PieceType pt = charToPieceType(c);
-            if (pt == PieceType::PieceTypeNb) {
-                continue;
-            }
-
-            int fromRank = squareRank(from);
-            int toRank = squareRank(between);
-            bool canPromote = isPromotable(pt)
-                              && (isPromotionZone(side, fromRank) || isPromotionZone(side, toRank));
-            bool mandatory = isMandatoryPromotion(side, pt, toRank);
-
-            Move interpose;
-            interpose.kind = MoveKind::Board;
-            interpose.from = from;
-            interpose.to = between;
-            interpose.piece = pt;
-
-            if (!mandatory) {
-                interpose.promote = false;
-                out.push(interpose);
-            }
-            if (canPromote) {
-                interpose.promote = true;
-                out.push(interpose);
-            }
-        }
-
-        // 打ちで合駒
-        for (int hti = 0; hti < static_cast<int>(HandType::HandTypeNb); ++hti) {
-            if (pos.hand[ci][static_cast<std::size_t>(hti)] <= 0) {
-                continue;
-            }
-            PieceType pt = handTypeToPieceType(static_cast<HandType>(hti));
-            if (pt == PieceType::PieceTypeNb) {
-                continue;
-            }
-
-            int toRank = squareRank(between);
-            int toFile = squareFile(between);
-            if (isDropDeadSquare(side, pt, toRank)) {
-                continue;
-            }
-            if (pt == PieceType::Pawn && detail::hasPawnOnFile(pos, side, toFile)) {
-                continue;
-            }
-
-            Move drop;
-            drop.kind = MoveKind::Drop;
-            drop.from = kInvalidSquare;
-            drop.to = between;
-            drop.piece = pt;
-            drop.promote = false;
-            out.push(drop);
-        }
-
-        f += stepF;
-        r += stepR;
+    // 王手駒の捕獲と、走り駒の王手に対する合駒（移動合・打ち合）
+    const Square checkerSq = checkers.popFirst();
+    const Bitboard81 interpose = attacks::between(king, checkerSq);
+    addTargetMoves(pos, side, interpose | Bitboard81::squareBit(checkerSq), out);
+    if (interpose.any()) {
+        addDropMoves(pos, side, interpose, out);
     }
 }
 
 void LegalCore::generateNonEvasionMoves(const EnginePosition& pos, Color side, MoveList& out) const
 {
     int ci = static_cast<int>(side);
-    Bitboard81 myPieces = pos.colorOcc[ci];
-    while (myPieces.any()) {
-        Square from = myPieces.popFirst();
-        char c = pos.board[from];
-        PieceType pt = charToPieceType(c);
-        if (pt == PieceType::PieceTypeNb) {
-            continue;
-        }
-        generatePieceMoves(pos, side, from, pt, out);
+    const Bitboard81 notOwn = ~pos.colorOcc[ci];
+
+    addTargetMoves(pos, side, notOwn, out);
+
+    Square king = pos.kingSq[ci];
+    if (king != kInvalidSquare) {
+        addBoardMoves(side, king, PieceType::King,
+                      attacks::stepAttacks(side, PieceType::King, king) & notOwn, out);
     }
 }
 
 void LegalCore::generateDropMoves(const EnginePosition& pos, Color side, MoveList& out) const
 {
-    int ci = static_cast<int>(side);
-
-    for (int hti = 0; hti < static_cast<int>(HandType::HandTypeNb); ++hti) {
-        if (pos.hand[ci][static_cast<std::size_t>(hti)] <= 0) {
-            continue;
-        }
-        PieceType pt = handTypeToPieceType(static_cast<HandType>(hti));
-        if (pt == PieceType::PieceTypeNb) {
-            continue;
-        }
-
-        for (int sq = 0; sq < kSquareNb; ++sq) {
-            auto s = static_cast<Square>(sq);
-            if (pos.occupied.test(s)) {
-                continue;
-            }
-
-            int toRank = squareRank(s);
-            int toFile = squareFile(s);
-            if (isDropDeadSquare(side, pt, toRank)) {
-                continue;
-            }
-            if (pt == PieceType::Pawn && detail::hasPawnOnFile(pos, side, toFile)) {
-                continue;
-            }
-
-            Move m;
-            m.kind = MoveKind::Drop;
-            m.from = kInvalidSquare;
-            m.to = s;
-            m.piece = pt;
-            m.promote = false;
-            out.push(m);
-        }
-    }
+    addDropMoves(pos, side, ~pos.occupied, out);
 }
 
 bool LegalCore::hasAnyLegalMove(EnginePosition& pos, Color side) const
 {
+    const CheckInfo info = computeCheckInfo(pos, side);
     MoveList pseudo;
-    pseudo.clear();
-
-    if (ownKingInCheck(pos, side)) {
-        generateEvasionMoves(pos, side, pseudo);
-    } else {
-        generateNonEvasionMoves(pos, side, pseudo);
-        generateDropMoves(pos, side, pseudo);
-    }
+    generatePseudoMoves(pos, side, info, pseudo);
 
     for (int i = 0; i < pseudo.size; ++i) {
-        const Move& m = pseudo.moves[static_cast<std::size_t>(i)];
-        UndoState undo;
-        if (!pos.doMove(m, side, undo)) {
-            continue;
-        }
-        bool selfCheck = ownKingInCheck(pos, side);
-        pos.undoMove(undo, side);
-        if (!selfCheck) {
+        if (isLegalWithCheckInfo(pos, side, pseudo.moves[static_cast<std::size_t>(i)], info)) {
             return true;
         }
     }
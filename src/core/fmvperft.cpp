@@ -0,0 +1,79 @@
+/// @file fmvperft.cpp
+/// @brief perft と perft 用置換表の実装
+
+#include "fmvperft.h"
+
+namespace fmv {
+
+namespace {
+constexpr std::uint64_t kDepthMask = 0xFFULL;
+constexpr int kNodeShift = 8;
+} // namespace
+
+PerftTable::PerftTable(std::size_t sizeMiB)
+{
+    const std::size_t bytes = (sizeMiB == 0 ? 1 : sizeMiB) * 1024 * 1024;
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Entry) <= bytes) {
+        count *= 2;
+    }
+    m_entries = std::make_unique<Entry[]>(count);
+    m_mask = count - 1;
+}
+
+bool PerftTable::probe(std::uint64_t key, int depth, std::uint64_t& nodes) const noexcept
+{
+    const Entry& e = m_entries[key & m_mask];
+    const std::uint64_t data = e.data.load(std::memory_order_relaxed);
+    const std::uint64_t check = e.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || (data & kDepthMask) != static_cast<std::uint64_t>(depth)) {
+        return false;
+    }
+    nodes = data >> kNodeShift;
+    return true;
+}
+
+void PerftTable::store(std::uint64_t key, int depth, std::uint64_t nodes) noexcept
+{
+    Entry& e = m_entries[key & m_mask];
+    const std::uint64_t data = (nodes << kNodeShift) | static_cast<std::uint64_t>(depth);
+    e.check.store(key ^ data, std::memory_order_relaxed);
+    e.data.store(data, std::memory_order_relaxed);
+}
+
+std::uint64_t perft(EnginePosition& pos, Color side, const LegalCore& core, int depth,
+                    PerftTable* table)
+{
+    if (depth <= 0) {
+        return 1;
+    }
+
+    // 深さ2以上のみ置換表を引く（深さ1は生成数をそのまま返す方が速い）
+    std::uint64_t nodes = 0;
+    const bool useTable = table != nullptr && depth >= 2;
+    if (useTable && table->probe(pos.zobristKey, depth, nodes)) {
+        return nodes;
+    }
+
+    MoveList moves;
+    core.generateLegalMoves(pos, side, moves);
+    if (depth == 1) {
+        return static_cast<std::uint64_t>(moves.size);
+    }
+
+    const Color next = opposite(side);
+    for (int i = 0; i < moves.size; ++i) {
+        UndoState undo;
+        if (pos.doMove(moves.moves[static_cast<std::size_t>(i)], side, undo)) {
+            nodes += perft(pos, next, core, depth - 1, table);
+            pos.undoMove(undo, side);
+        }
+    }
+
+    if (useTable) {
+        table->store(pos.zobristKey, depth, nodes);
+    }
+    return nodes;
+}
+
+} // namespace fmv
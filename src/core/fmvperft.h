@@ -0,0 +1,51 @@
+#ifndef FMVPERFT_H
+#define FMVPERFT_H
+
+/// @file fmvperft.h
+/// @brief 合法手生成の検証・計測用 perft（置換表つき）
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "fmvlegalcore.h"
+#include "fmvposition.h"
+#include "fmvtypes.h"
+
+namespace fmv {
+
+/**
+ * @brief perft 用の置換表（Zobrist キー + 残り深さ → ノード数）
+ *
+ * 複数スレッドから同時に参照・更新してよい。各エントリは
+ * 「キー ^ データ」と「データ」の2語で保持し、読み出し時に XOR で
+ * 整合性を確認する（書き込みが競合して壊れたエントリは単に外れ扱いになる）。
+ */
+class PerftTable
+{
+public:
+    /// @param sizeMiB 表のサイズ（MiB）。2のべき乗個のエントリに切り下げる。
+    explicit PerftTable(std::size_t sizeMiB);
+
+    bool probe(std::uint64_t key, int depth, std::uint64_t& nodes) const noexcept;
+    void store(std::uint64_t key, int depth, std::uint64_t nodes) noexcept;
+
+    std::size_t entryCount() const noexcept { return m_mask + 1; }
+
+private:
+    struct Entry {
+        std::atomic<std::uint64_t> check{0};   ///< key ^ data
+        std::atomic<std::uint64_t> data{0};    ///< (nodes << 8) | depth
+    };
+
+    std::unique_ptr<Entry[]> m_entries;
+    std::size_t m_mask = 0;
+};
+
+/// pos から depth 手の合法手順数を数える（table が null なら置換表なし）
+std::uint64_t perft(EnginePosition& pos, Color side, const LegalCore& core, int depth,
+                    PerftTable* table = nullptr);
+
+} // namespace fmv
+
+#endif // FMVPERFT_H
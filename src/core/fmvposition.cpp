@@ -3,6 +3,8 @@
 
 #include "fmvposition.h"
 
+#include "fmvzobrist.h"
+
 #include <cctype>
 
 namespace fmv {
@@ -117,6 +119,12 @@ HandType pieceTypeToHandType(PieceType pt) noexcept
     }
 }
 
+/// 持ち駒枚数の変化に応じてZobristキーを差し替える
+void updateHandKey(std::uint64_t& key, Color c, HandType ht, int before, int after) noexcept
+{
+    key ^= zobrist::handKey(c, ht, before) ^ zobrist::handKey(c, ht, after);
+}
+
 } // namespace
 
 void EnginePosition::clear() noexcept
@@ -171,6 +179,77 @@ void EnginePosition::rebuildBitboards() noexcept
             kingSq[ci] = s;
         }
     }
+
+    zobristKey = computeZobristKey(Color::Black);
+}
+
+std::uint64_t EnginePosition::computeZobristKey(Color sideToMove) const noexcept
+{
+    std::uint64_t key = 0ULL;
+
+    for (int sq = 0; sq < kSquareNb; ++sq) {
+        PieceInfo info = charToPieceInfo(board[static_cast<std::size_t>(sq)]);
+        if (info.valid) {
+            key ^= zobrist::boardKey(info.color, info.type, static_cast<Square>(sq));
+        }
+    }
+
+    for (int c = 0; c < 2; ++c) {
+        for (int ht = 0; ht < static_cast<int>(HandType::HandTypeNb); ++ht) {
+            key ^= zobrist::handKey(static_cast<Color>(c), static_cast<HandType>(ht),
+                                    hand[c][static_cast<std::size_t>(ht)]);
+        }
+    }
+
+    if (sideToMove == Color::White) {
+        key ^= zobrist::sideKey();
+    }
+    return key;
+}
+
+void EnginePosition::setSquare(Square sq, char pieceChar) noexcept
+{
+    const char before = board[sq];
+    if (before == pieceChar) {
+        return;
+    }
+
+    const PieceInfo oldInfo = charToPieceInfo(before);
+    if (oldInfo.valid) {
+        const int ci = static_cast<int>(oldInfo.color);
+        occupied.clear(sq);
+        colorOcc[ci].clear(sq);
+        pieceOcc[ci][static_cast<int>(oldInfo.type)].clear(sq);
+        zobristKey ^= zobrist::boardKey(oldInfo.color, oldInfo.type, sq);
+        if (oldInfo.type == PieceType::King && kingSq[ci] == sq) {
+            // 局面編集では玉が複数ありうるので、残っていればそれを玉位置とする
+            Bitboard81 kings = pieceOcc[ci][static_cast<int>(PieceType::King)];
+            kingSq[ci] = kings.popFirst();
+        }
+    }
+
+    const PieceInfo newInfo = charToPieceInfo(pieceChar);
+    if (!newInfo.valid) {
+        board[sq] = kEmpty;
+        return;
+    }
+
+    const int ci = static_cast<int>(newInfo.color);
+    board[sq] = pieceChar;
+    occupied.set(sq);
+    colorOcc[ci].set(sq);
+    pieceOcc[ci][static_cast<int>(newInfo.type)].set(sq);
+    zobristKey ^= zobrist::boardKey(newInfo.color, newInfo.type, sq);
+    if (newInfo.type == PieceType::King) {
+        kingSq[ci] = sq;
+    }
+}
+
+void EnginePosition::setHandCount(Color c, HandType ht, int count) noexcept
+{
+    int& slot = hand[static_cast<int>(c)][static_cast<std::size_t>(ht)];
+    updateHandKey(zobristKey, c, ht, slot, count);
+    slot = count;
 }
 
 bool EnginePosition::doMove(const Move& move, Color side, UndoState& undo) noexcept
@@ -183,33 +262,35 @@ bool EnginePosition::doMove(const Move& move, Color side, UndoState& undo) noexc
     undo.kingSquareBefore[1] = kingSq[1];
     undo.zobristBefore = zobristKey;
 
-    if (move.kind == MoveKind::Drop) {
+    if (move.kind() == MoveKind::Drop) {
         // 打ち
-        Square to = move.to;
+        Square to = move.to();
         undo.movedPieceBefore = kEmpty;
         undo.capturedPiece = kEmpty;
 
         // 持ち駒を減らす
-        HandType ht = pieceTypeToHandType(move.piece);
+        HandType ht = pieceTypeToHandType(move.piece());
         auto hti = static_cast<std::size_t>(ht);
         if (ht == HandType::HandTypeNb || hand[ci][hti] <= 0) {
             return false;
         }
         --hand[ci][hti];
+        updateHandKey(zobristKey, side, ht, hand[ci][hti] + 1, hand[ci][hti]);
 
         // 盤面に配置
-        char pieceChar = pieceInfoToChar(side, move.piece);
+        char pieceChar = pieceInfoToChar(side, move.piece());
         board[to] = pieceChar;
         occupied.set(to);
         colorOcc[ci].set(to);
-        pieceOcc[ci][static_cast<int>(move.piece)].set(to);
+        pieceOcc[ci][static_cast<int>(move.piece())].set(to);
+        zobristKey ^= zobrist::boardKey(side, move.piece(), to) ^ zobrist::sideKey();
 
         return true;
     }
 
     // 盤上移動
-    Square from = move.from;
-    Square to = move.to;
+    Square from = move.from();
+    Square to = move.to();
 
     char movingChar = board[from];
     undo.movedPieceBefore = movingChar;
@@ -226,6 +307,7 @@ bool EnginePosition::doMove(const Move& move, Color side, UndoState& undo) noexc
     occupied.clear(from);
     colorOcc[ci].clear(from);
     pieceOcc[ci][static_cast<int>(movingInfo.type)].clear(from);
+    zobristKey ^= zobrist::boardKey(side, movingInfo.type, from);
 
     // 取る駒の処理
     if (capturedChar != kEmpty) {
@@ -235,18 +317,21 @@ bool EnginePosition::doMove(const Move& move, Color side, UndoState& undo) noexc
             occupied.clear(to);
             colorOcc[oi].clear(to);
             pieceOcc[oi][static_cast<int>(capInfo.type)].clear(to);
+            zobristKey ^= zobrist::boardKey(capInfo.color, capInfo.type, to);
 
             // 持ち駒に追加（成り解除して）
             PieceType basePt = demotePieceType(capInfo.type);
             HandType ht = pieceTypeToHandType(basePt);
             if (ht != HandType::HandTypeNb) {
-                ++hand[ci][static_cast<std::size_t>(ht)];
+                auto hti = static_cast<std::size_t>(ht);
+                ++hand[ci][hti];
+                updateHandKey(zobristKey, side, ht, hand[ci][hti] - 1, hand[ci][hti]);
             }
         }
     }
 
     // 成り処理
-    PieceType placedType = move.promote ? promotePieceType(movingInfo.type) : movingInfo.type;
+    PieceType placedType = move.promote() ? promotePieceType(movingInfo.type) : movingInfo.type;
     char placedChar = pieceInfoToChar(side, placedType);
 
     // 移動先に配置
@@ -254,6 +339,7 @@ bool EnginePosition::doMove(const Move& move, Color side, UndoState& undo) noexc
     occupied.set(to);
     colorOcc[ci].set(to);
     pieceOcc[ci][static_cast<int>(placedType)].set(to);
+    zobristKey ^= zobrist::boardKey(side, placedType, to) ^ zobrist::sideKey();
 
     // 玉の位置更新
     if (movingInfo.type == PieceType::King) {
@@ -268,28 +354,29 @@ void EnginePosition::undoMove(const UndoState& undo, Color side) noexcept
     int ci = static_cast<int>(side);
     const Move& move = undo.move;
 
-    if (move.kind == MoveKind::Drop) {
+    if (move.kind() == MoveKind::Drop) {
         // 打ちの取り消し
-        Square to = move.to;
+        Square to = move.to();
 
         // 盤面から除去
         board[to] = kEmpty;
         occupied.clear(to);
         colorOcc[ci].clear(to);
-        pieceOcc[ci][static_cast<int>(move.piece)].clear(to);
+        pieceOcc[ci][static_cast<int>(move.piece())].clear(to);
 
         // 持ち駒を戻す
-        HandType ht = pieceTypeToHandType(move.piece);
+        HandType ht = pieceTypeToHandType(move.piece());
         if (ht != HandType::HandTypeNb) {
             ++hand[ci][static_cast<std::size_t>(ht)];
         }
 
+        zobristKey = undo.zobristBefore;
         return;
     }
 
     // 盤上移動の取り消し
-    Square from = move.from;
-    Square to = move.to;
+    Square from = move.from();
+    Square to = move.to();
 
     // 現在toにある駒の情報
     char currentPieceChar = board[to];
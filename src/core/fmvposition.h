@@ -13,7 +13,7 @@
 namespace fmv {
 
 struct UndoState {
-    Move move{};
+    Move move = Move::none();
     char movedPieceBefore = ' ';
     char capturedPiece = ' ';
     Square kingSquareBefore[2]{kInvalidSquare, kInvalidSquare};
@@ -41,12 +41,31 @@ public:
     /// 持ち駒配列 [Color][HandType]
     std::array<int, static_cast<int>(HandType::HandTypeNb)> hand[2]{};
 
-    /// Zobristハッシュキー（将来用、現在は0固定）
+    /**
+     * @brief Zobristハッシュキー（盤上駒・持ち駒・手番）
+     *
+     * doMove/undoMove で差分更新される。rebuildBitboards は先手番として再計算するため、
+     * 後手番の局面では呼び出し側が computeZobristKey(Color::White) で設定し直す。
+     */
     std::uint64_t zobristKey = 0ULL;
 
     void clear() noexcept;
     void rebuildBitboards() noexcept;
 
+    /// 盤面配列と持ち駒からZobristキーを全計算する（差分更新の検証用にも使う）
+    [[nodiscard]] std::uint64_t computeZobristKey(Color sideToMove) const noexcept;
+
+    /**
+     * @brief 1マスの駒を置き換える（盤面編集・外部盤面のミラー用）
+     * @param pieceChar 駒char（' ' で空にする）
+     *
+     * ビットボード・玉位置・Zobristキー（先手番基準）を差分更新する。
+     */
+    void setSquare(Square sq, char pieceChar) noexcept;
+
+    /// 持ち駒の枚数を設定し、Zobristキーを差分更新する
+    void setHandCount(Color c, HandType ht, int count) noexcept;
+
     [[nodiscard]] bool doMove(const Move& move, Color side, UndoState& undo) noexcept;
     void undoMove(const UndoState& undo, Color side) noexcept;
 };
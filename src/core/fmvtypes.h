@@ -23,21 +23,79 @@ enum class HandType : std::uint8_t {
 };
 
 using Square = std::uint8_t;
-constexpr Square kInvalidSquare = 0xFF;
+/// 無効マス（Move の7ビットのマス欄に収まる値）
+constexpr Square kInvalidSquare = 0x7F;
 constexpr int kBoardSize = 9;
 constexpr int kSquareNb = 81;
 
-struct Move {
-    Square from = kInvalidSquare;
-    Square to = kInvalidSquare;
-    PieceType piece = PieceType::Pawn;
-    MoveKind kind = MoveKind::Board;
-    bool promote = false;
+/**
+ * @brief 32ビットに詰めた指し手
+ *
+ * ビット配置: to[0-6] from[7-13] promote[14] drop[15] piece[16-19]。
+ * 打ちの from は kInvalidSquare。盤上移動の piece は移動前の駒種。
+ * 既定構築は未初期化（MoveList の格納域をゼロ埋めしないため）なので、
+ * 値が必要な場合は makeBoard / makeDrop / none で作る。
+ */
+class Move
+{
+public:
+    Move() = default;
+
+    static constexpr Move makeBoard(Square from, Square to, PieceType piece, bool promoted = false) noexcept
+    {
+        return Move(static_cast<std::uint32_t>(to)
+                    | (static_cast<std::uint32_t>(from) << kFromShift)
+                    | (promoted ? kPromoteBit : 0U)
+                    | (static_cast<std::uint32_t>(piece) << kPieceShift));
+    }
+
+    static constexpr Move makeDrop(PieceType piece, Square to) noexcept
+    {
+        return Move(static_cast<std::uint32_t>(to)
+                    | (static_cast<std::uint32_t>(kInvalidSquare) << kFromShift)
+                    | kDropBit
+                    | (static_cast<std::uint32_t>(piece) << kPieceShift));
+    }
+
+    /// from/to とも無効マスの指し手（未設定の目印）
+    static constexpr Move none() noexcept { return makeBoard(kInvalidSquare, kInvalidSquare, PieceType::Pawn); }
+
+    static constexpr Move fromRaw(std::uint32_t raw) noexcept { return Move(raw); }
+    constexpr std::uint32_t raw() const noexcept { return m_raw; }
+
+    constexpr Square from() const noexcept { return static_cast<Square>((m_raw >> kFromShift) & kSquareMask); }
+    constexpr Square to() const noexcept { return static_cast<Square>(m_raw & kSquareMask); }
+    constexpr PieceType piece() const noexcept { return static_cast<PieceType>((m_raw >> kPieceShift) & 0xFU); }
+    constexpr bool isDrop() const noexcept { return (m_raw & kDropBit) != 0; }
+    constexpr MoveKind kind() const noexcept { return isDrop() ? MoveKind::Drop : MoveKind::Board; }
+    constexpr bool promote() const noexcept { return (m_raw & kPromoteBit) != 0; }
+
+    /// 成り/不成だけを変えた指し手
+    constexpr Move withPromote(bool promoted) const noexcept
+    {
+        return Move(promoted ? (m_raw | kPromoteBit) : (m_raw & ~kPromoteBit));
+    }
+
+    constexpr bool operator==(const Move& other) const noexcept { return m_raw == other.m_raw; }
+    constexpr bool operator!=(const Move& other) const noexcept { return m_raw != other.m_raw; }
+
+private:
+    constexpr explicit Move(std::uint32_t raw) noexcept : m_raw(raw) {}
+
+    static constexpr std::uint32_t kSquareMask = 0x7FU;
+    static constexpr int kFromShift = 7;
+    static constexpr std::uint32_t kPromoteBit = 1U << 14;
+    static constexpr std::uint32_t kDropBit = 1U << 15;
+    static constexpr int kPieceShift = 16;
+
+    std::uint32_t m_raw;
 };
 
+static_assert(sizeof(Move) == 4, "Move must stay packed into 32 bits");
+
 struct MoveList {
     static constexpr int kMaxMoves = 600;
-    std::array<Move, kMaxMoves> moves{};
+    std::array<Move, kMaxMoves> moves; ///< 先頭 size 件のみ有効（残りは未初期化）
     int size = 0;
 
     void clear() noexcept { size = 0; }
@@ -51,6 +109,10 @@ struct MoveList {
         ++size;
         return true;
     }
+
+    const Move& operator[](int i) const noexcept { return moves[static_cast<std::size_t>(i)]; }
+    const Move* begin() const noexcept { return moves.data(); }
+    const Move* end() const noexcept { return moves.data() + size; }
 };
 
 inline Color opposite(Color c) noexcept
@@ -0,0 +1,88 @@
+#ifndef FMVZOBRIST_H
+#define FMVZOBRIST_H
+
+/// @file fmvzobrist.h
+/// @brief EnginePosition 用 Zobrist ハッシュ乱数表（header-only, コンパイル時生成）
+
+#include <cstdint>
+
+#include "fmvtypes.h"
+
+namespace fmv {
+namespace zobrist {
+
+/// 持ち駒枚数の上限（歩18枚）。これを超える枚数は上限に丸めてハッシュする。
+constexpr int kMaxHandCount = 18;
+
+namespace detail {
+
+constexpr int kColorNb = static_cast<int>(Color::ColorNb);
+constexpr int kPieceTypeNb = static_cast<int>(PieceType::PieceTypeNb);
+constexpr int kHandTypeNb = static_cast<int>(HandType::HandTypeNb);
+
+struct Table {
+    std::uint64_t board[kColorNb][kPieceTypeNb][kSquareNb]{};
+    std::uint64_t hand[kColorNb][kHandTypeNb][kMaxHandCount + 1]{};
+    std::uint64_t side = 0ULL;
+};
+
+/// splitmix64: 実行環境に依存しない決定的な乱数列を得るため自前で実装する
+constexpr std::uint64_t nextRandom(std::uint64_t& state) noexcept
+{
+    state += 0x9E3779B97F4A7C15ULL;
+    std::uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr Table makeTable() noexcept
+{
+    Table t{};
+    std::uint64_t state = 0x5348'4F47'4942'5141ULL; // "SHOGIBQA"
+    for (auto& colorKeys : t.board) {
+        for (auto& pieceKeys : colorKeys) {
+            for (auto& key : pieceKeys) {
+                key = nextRandom(state);
+            }
+        }
+    }
+    for (auto& colorKeys : t.hand) {
+        for (auto& handKeys : colorKeys) {
+            // 枚数0は0固定（持ち駒なしの局面が盤上駒のみで決まるように）
+            for (int n = 1; n <= kMaxHandCount; ++n) {
+                handKeys[n] = nextRandom(state);
+            }
+        }
+    }
+    t.side = nextRandom(state);
+    return t;
+}
+
+inline constexpr Table kTable = makeTable();
+
+} // namespace detail
+
+/// 盤上の駒（色・駒種・マス）のキー
+constexpr std::uint64_t boardKey(Color c, PieceType pt, Square sq) noexcept
+{
+    return detail::kTable.board[static_cast<int>(c)][static_cast<int>(pt)][sq];
+}
+
+/// 持ち駒（色・駒種・枚数）のキー。枚数0のキーは0。
+constexpr std::uint64_t handKey(Color c, HandType ht, int count) noexcept
+{
+    const int n = (count < 0) ? 0 : (count > kMaxHandCount ? kMaxHandCount : count);
+    return detail::kTable.hand[static_cast<int>(c)][static_cast<int>(ht)][n];
+}
+
+/// 後手番の局面に XOR されるキー
+constexpr std::uint64_t sideKey() noexcept
+{
+    return detail::kTable.side;
+}
+
+} // namespace zobrist
+} // namespace fmv
+
+#endif // FMVZOBRIST_H
@@ -7,6 +7,8 @@
 #include "boardconstants.h"
 #include "logcategories.h"
 
+#include <algorithm>
+
 // ============================================================
 // 初期化
 // ============================================================
@@ -37,6 +39,59 @@ void ShogiBoard::initStand()
     for (const Piece& piece : pieces) {
         m_pieceStand.insert(piece, 0);
     }
+    rebuildEnginePosition();
+}
+
+// ============================================================
+// エンジン内部表現のミラー
+// ============================================================
+
+namespace {
+
+/// 駒台の駒 → 持ち駒種（玉など持ち駒にならない駒は HandTypeNb）
+fmv::HandType standPieceToHandType(Piece piece)
+{
+    switch (toBlack(piece)) {
+    case Piece::BlackPawn:   return fmv::HandType::Pawn;
+    case Piece::BlackLance:  return fmv::HandType::Lance;
+    case Piece::BlackKnight: return fmv::HandType::Knight;
+    case Piece::BlackSilver: return fmv::HandType::Silver;
+    case Piece::BlackGold:   return fmv::HandType::Gold;
+    case Piece::BlackBishop: return fmv::HandType::Bishop;
+    case Piece::BlackRook:   return fmv::HandType::Rook;
+    default: return fmv::HandType::HandTypeNb;
+    }
+}
+
+} // namespace
+
+// 駒台の1駒種の枚数をミラーへ反映する。
+void ShogiBoard::syncEngineHand(Piece piece)
+{
+    const fmv::HandType ht = standPieceToHandType(piece);
+    if (ht == fmv::HandType::HandTypeNb) {
+        return;
+    }
+    const fmv::Color color = isBlackPiece(piece) ? fmv::Color::Black : fmv::Color::White;
+    m_enginePos.setHandCount(color, ht, m_pieceStand.value(piece, 0));
+}
+
+// 盤面・駒台をまとめて差し替えた後にミラーを作り直す（SFEN読込・反転・リセット時）。
+void ShogiBoard::rebuildEnginePosition()
+{
+    m_enginePos.clear();
+    const qsizetype count = std::min<qsizetype>(m_boardData.size(), fmv::kSquareNb);
+    for (qsizetype i = 0; i < count; ++i) {
+        m_enginePos.board[static_cast<std::size_t>(i)] = static_cast<char>(m_boardData.at(i));
+    }
+    for (auto it = m_pieceStand.cbegin(); it != m_pieceStand.cend(); ++it) {
+        const fmv::HandType ht = standPieceToHandType(it.key());
+        if (ht != fmv::HandType::HandTypeNb) {
+            const int ci = isBlackPiece(it.key()) ? 0 : 1;
+            m_enginePos.hand[ci][static_cast<std::size_t>(ht)] = std::max(0, it.value());
+        }
+    }
+    m_enginePos.rebuildBitboards();
 }
 
 // ============================================================
@@ -64,6 +119,7 @@ void ShogiBoard::addStandPiece(Piece piece, int delta)
         return;
     }
     m_pieceStand[piece] += delta;
+    syncEngineHand(piece);
 }
 
 bool ShogiBoard::consumeStandPiece(Piece piece)
@@ -72,6 +128,7 @@ bool ShogiBoard::consumeStandPiece(Piece piece)
         return false;
     }
     m_pieceStand[piece]--;
+    syncEngineHand(piece);
     return true;
 }
 
@@ -128,6 +185,7 @@ bool ShogiBoard::setDataInternal(const int file, const int rank, const Piece pie
     if (m_boardData.at(index) == piece) return false;
 
     m_boardData[index] = piece;
+    m_enginePos.setSquare(static_cast<fmv::Square>(index), static_cast<char>(piece));
     return true;
 }
 
@@ -8,6 +8,7 @@
 #include <QList>
 #include <QMap>
 #include <optional>
+#include "fmvposition.h"
 #include "shogitypes.h"
 
 /**
@@ -35,6 +36,14 @@ public:
     /// 駒台データを返す
     const QMap<Piece, int>& pieceStand() const;
 
+    /**
+     * @brief 盤面・駒台のエンジン内部表現（常に最新）
+     *
+     * 駒の移動・駒台操作のたびに差分更新されるため、合法手判定や王手判定で
+     * QList/QMap から局面を組み立て直す必要がない。Zobristキーは先手番基準。
+     */
+    const fmv::EnginePosition& enginePosition() const { return m_enginePos; }
+
     /// 指定駒の駒台枚数を返す（存在しない場合は0）
     int pieceStandCount(Piece piece) const;
 
@@ -130,6 +139,7 @@ private:
     QMap<Piece, int> m_pieceStand;  ///< 駒台データ（駒 → 枚数）
     int m_currentMoveNumber;        ///< SFEN文字列の手数
     Turn m_currentPlayer = Turn::Black; ///< 現在の手番
+    fmv::EnginePosition m_enginePos;  ///< 盤面・駒台のミラー（enginePosition() 参照）
 
     // --- 内部操作 ---
     void setData(const int file, const int rank, const Piece value);
@@ -142,6 +152,8 @@ private:
     Piece convertPieceChar(const Piece c) const;
     Piece convertPromotedPieceToOriginal(const Piece dest) const;
     void setInitialPieceStandValues();
+    void syncEngineHand(Piece piece);
+    void rebuildEnginePosition();
     QString convertPieceToSfen(const Piece piece) const;
 };
 
@@ -48,6 +48,7 @@ void ShogiBoard::resetGameBoard()
 {
     m_boardData.fill(Piece::None, static_cast<qsizetype>(ranks()) * files());
     setInitialPieceStandValues();
+    rebuildEnginePosition();
 }
 
 // 先手の配置を後手の配置に変更し、後手の配置を先手の配置に変更する。
@@ -75,6 +76,7 @@ void ShogiBoard::flipSides()
         Piece flipped = isBlackPiece(it.key()) ? toWhite(it.key()) : toBlack(it.key());
         m_pieceStand[flipped] = it.value();
     }
+    rebuildEnginePosition();
 }
 
 // ============================================================
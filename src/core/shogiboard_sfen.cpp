@@ -253,6 +253,7 @@ void ShogiBoard::setSfen(const QString& sfenStr)
         m_pieceStand = oldPieceStand;
         m_currentPlayer = oldTurn;
         m_currentMoveNumber = oldMoveNumber;
+        rebuildEnginePosition();
         const auto msg = tr("SFEN board parse error: %1").arg(sfenStr.left(80));
         ErrorBus::instance().postMessage(ErrorBus::ErrorLevel::Error, msg);
         return;
@@ -262,6 +263,7 @@ void ShogiBoard::setSfen(const QString& sfenStr)
         m_pieceStand = oldPieceStand;
         m_currentPlayer = oldTurn;
         m_currentMoveNumber = oldMoveNumber;
+        rebuildEnginePosition();
         const auto msg = tr("SFEN piece stand parse error: %1").arg(sfenStr.left(80));
         ErrorBus::instance().postMessage(ErrorBus::ErrorLevel::Error, msg);
         return;
@@ -269,6 +271,7 @@ void ShogiBoard::setSfen(const QString& sfenStr)
 
     m_currentPlayer = parsed->turn;
     m_currentMoveNumber = parsed->moveNumber;
+    rebuildEnginePosition();
 
     // ShogiView::setBoardのconnectで再描画がトリガされる
     emit boardReset();
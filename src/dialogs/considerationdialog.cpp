@@ -71,6 +71,11 @@ void ConsiderationDialog::showEngineSettingsDialog()
         const QString errorText = tr("将棋エンジンが選択されていません。");
         QMessageBox::critical(this, tr("エラー"), errorText);
     }
+    // 内蔵ソルバーの項目の場合
+    else if (m_engineNumber >= 0 && m_engineNumber < m_engineList.size()
+             && m_engineList.at(m_engineNumber).builtin) {
+        QMessageBox::information(this, tr("エンジン設定"), tr("内蔵ソルバーには設定項目がありません。"));
+    }
     // エンジン名が空でない場合
     else {
         // エンジン設定ダイアログを表示する。
@@ -155,6 +160,21 @@ void ConsiderationDialog::readEngineNameAndDir()
     }
 }
 
+// エンジン選択リストの末尾に内蔵ソルバーの項目を追加する。
+void ConsiderationDialog::appendBuiltinEngine(const QString& name)
+{
+    Engine engine;
+    engine.name = name;
+    engine.builtin = true;
+    ui->comboBoxEngine1->addItem(engine.name);
+    m_engineList.append(engine);
+
+    // 内蔵ソルバーの選択は共有のエンジン番号とは別に保存している。
+    if (AnalysisSettings::tsumeSearchBuiltinSolver()) {
+        ui->comboBoxEngine1->setCurrentIndex(ui->comboBoxEngine1->count() - 1);
+    }
+}
+
 // エンジンの名前とディレクトリを格納するリストを取得する。
 const QList<ConsiderationDialog::Engine>& ConsiderationDialog::engineList() const
 {
@@ -228,8 +248,15 @@ void ConsiderationDialog::loadSettings()
 // 設定を保存する
 void ConsiderationDialog::saveSettings()
 {
-    // エンジン番号を保存
-    AnalysisSettings::setConsiderationEngineIndex(m_engineNumber);
+    // エンジン番号を保存（検討ダイアログ・検討タブと共有するので登録エンジンの番号だけを保存する）
+    const bool builtinSelected = m_engineNumber >= 0 && m_engineNumber < m_engineList.size()
+                                 && m_engineList.at(m_engineNumber).builtin;
+    if (!builtinSelected) {
+        AnalysisSettings::setConsiderationEngineIndex(m_engineNumber);
+    }
+    if (!m_engineList.isEmpty() && m_engineList.constLast().builtin) {
+        AnalysisSettings::setTsumeSearchBuiltinSolver(builtinSelected);
+    }
 
     // 時間無制限フラグを保存
     AnalysisSettings::setConsiderationUnlimitedTime(m_unlimitedTimeFlag);
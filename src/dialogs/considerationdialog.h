@@ -44,6 +44,7 @@ public:
     {
         QString name;
         QString path;
+        bool builtin = false;  ///< エンジンを起動しない内蔵ソルバーの項目
     };
 
     // エンジンの名前とディレクトリを格納するリストを取得する。
@@ -51,6 +52,10 @@ public:
 
     bool unlimitedTimeFlag() const;
 
+protected:
+    // エンジン選択リストの末尾に内蔵ソルバーの項目を追加する。
+    void appendBuiltinEngine(const QString& name);
+
 private slots:
     // エンジン設定ボタンが押された場合、エンジン設定ダイアログを表示する。
     void showEngineSettingsDialog();
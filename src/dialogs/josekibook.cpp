@@ -0,0 +1,191 @@
+/// @file josekibook.cpp
+/// @brief バイナリ定跡ファイルの読み取り（メモリマップ）と指し手の符号化
+
+#include "josekibook.h"
+#include "josekiwindow.h"  // JosekiMove 構造体
+#include "josekibookformat.h"
+
+#include <cstring>
+
+using namespace JosekiBookFormat;
+
+namespace {
+
+/// 盤上の升（1a=0 … 9i=80）。範囲外なら -1
+int parseSquare(QChar file, QChar rank)
+{
+    if (file < QLatin1Char('1') || file > QLatin1Char('9') || rank < QLatin1Char('a') || rank > QLatin1Char('i')) {
+        return -1;
+    }
+    return (file.unicode() - '1') * 9 + (rank.unicode() - 'a');
+}
+
+QString squareText(int square)
+{
+    return QString(QLatin1Char(static_cast<char>('1' + square / 9))) + QLatin1Char(static_cast<char>('a' + square % 9));
+}
+
+const char kDropPieces[] = "PLNSGBR";
+
+} // namespace
+
+JosekiBook::JosekiBook()
+    : m_index(kLayout)
+{
+}
+
+JosekiBook::~JosekiBook() = default;
+
+bool JosekiBook::isBookFile(const QString &filePath)
+{
+    return SortedKeyIndex::hasMagic(filePath, kMagic);
+}
+
+bool JosekiBook::hasBookSuffix(const QString &filePath)
+{
+    return filePath.endsWith(QLatin1String(kFileSuffix), Qt::CaseInsensitive);
+}
+
+bool JosekiBook::open(const QString &filePath, QString *errorMessage)
+{
+    return m_index.open(filePath, errorMessage);
+}
+
+int JosekiBook::positionCount() const
+{
+    return static_cast<int>(m_index.recordCount(kPositionTable));
+}
+
+int JosekiBook::moveCount() const
+{
+    return static_cast<int>(m_index.recordCount(kMoveTable));
+}
+
+const uchar *JosekiBook::positionRecord(quint32 index) const
+{
+    return m_index.record(kPositionTable, index);
+}
+
+const uchar *JosekiBook::moveRecord(quint32 index) const
+{
+    return m_index.record(kMoveTable, index);
+}
+
+int JosekiBook::findPosition(const QString &normalizedSfen) const
+{
+    // キーが衝突した局面は正規化SFEN で見分ける
+    const auto [first, last] = m_index.keyRange(positionKey(normalizedSfen));
+    const QByteArray utf8 = normalizedSfen.toUtf8();
+    for (quint32 i = first; i < last; ++i) {
+        const QByteArrayView stored = m_index.poolBytes(readLE<quint32>(positionRecord(i) + kPositionSfen));
+        if (stored.size() == utf8.size() && std::memcmp(stored.data(), utf8.constData(), utf8.size()) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+QString JosekiBook::normalizedSfenAt(int index) const
+{
+    if (index < 0 || index >= positionCount()) return {};
+    return QString::fromUtf8(m_index.poolBytes(readLE<quint32>(positionRecord(quint32(index)) + kPositionSfen)));
+}
+
+QString JosekiBook::sfenWithPlyAt(int index) const
+{
+    const QString normalized = normalizedSfenAt(index);
+    if (normalized.isEmpty()) return {};
+    const qint32 ply = readLE<qint32>(positionRecord(quint32(index)) + kPositionPly);
+    return ply > 0 ? normalized + QLatin1Char(' ') + QString::number(ply) : normalized;
+}
+
+QList<JosekiMove> JosekiBook::movesAt(int index) const
+{
+    QList<JosekiMove> moves;
+    if (index < 0 || index >= positionCount()) return moves;
+
+    const uchar *record = positionRecord(quint32(index));
+    const quint32 first = readLE<quint32>(record + kPositionFirstMove);
+    const quint32 count = readLE<quint16>(record + kPositionMoveCount);
+    const quint32 moveTotal = m_index.recordCount(kMoveTable);
+    if (first > moveTotal || count > moveTotal - first) return moves;
+
+    moves.reserve(count);
+    for (quint32 i = 0; i < count; ++i) {
+        const uchar *m = moveRecord(first + i);
+        JosekiMove move;
+        move.move = decodeMove(readLE<quint16>(m + kMoveCode));
+        move.nextMove = decodeMove(readLE<quint16>(m + kMoveNextCode));
+        move.value = readLE<qint32>(m + kMoveValue);
+        move.depth = readLE<qint32>(m + kMoveDepth);
+        move.frequency = readLE<qint32>(m + kMoveFrequency);
+        move.comment = QString::fromUtf8(m_index.poolBytes(readLE<quint32>(m + kMoveComment)));
+        moves.append(move);
+    }
+    return moves;
+}
+
+quint64 JosekiBook::positionKey(QStringView normalizedSfen)
+{
+    // FNV-1a で混ぜたあと、バケットに使う上位ビットが偏らないよう仕上げをかける
+    quint64 h = 14695981039346656037ULL;
+    for (const QChar c : normalizedSfen) {
+        h ^= c.unicode();
+        h *= 1099511628211ULL;
+    }
+    return mixKey(h);
+}
+
+bool JosekiBook::encodeMove(QStringView usi, quint16 &code)
+{
+    if (usi == QLatin1String("none")) {
+        code = kMoveNone;
+        return true;
+    }
+    if (usi == QLatin1String("resign")) {
+        code = kMoveResign;
+        return true;
+    }
+    if (usi == QLatin1String("win")) {
+        code = kMoveWin;
+        return true;
+    }
+
+    if (usi.size() == 4 && usi.at(1) == QLatin1Char('*')) {
+        const qsizetype piece = QLatin1String(kDropPieces).indexOf(usi.at(0));
+        const int to = parseSquare(usi.at(2), usi.at(3));
+        if (piece < 0 || to < 0) return false;
+        const int from = kDropFromBase + static_cast<int>(piece);
+        code = static_cast<quint16>(to | (from << 7));
+        return true;
+    }
+
+    const bool promote = usi.size() == 5 && usi.at(4) == QLatin1Char('+');
+    if (usi.size() != 4 && !promote) return false;
+    const int from = parseSquare(usi.at(0), usi.at(1));
+    const int to = parseSquare(usi.at(2), usi.at(3));
+    if (from < 0 || to < 0 || from == to) return false;
+    code = static_cast<quint16>(to | (from << 7) | (promote ? kMovePromoteBit : 0));
+    return true;
+}
+
+QString JosekiBook::decodeMove(quint16 code)
+{
+    switch (code) {
+    case kMoveNone: return QStringLiteral("none");
+    case kMoveResign: return QStringLiteral("resign");
+    case kMoveWin: return QStringLiteral("win");
+    default: break;
+    }
+
+    const int to = code & 0x7F;
+    const int from = (code >> 7) & 0x7F;
+    if (to >= kSquareCount) return {};
+    if (from >= kDropFromBase) {
+        if (from - kDropFromBase >= static_cast<int>(sizeof(kDropPieces)) - 1) return {};
+        return QString(QLatin1Char(kDropPieces[from - kDropFromBase])) + QLatin1Char('*') + squareText(to);
+    }
+    QString usi = squareText(from) + squareText(to);
+    if (code & kMovePromoteBit) usi += QLatin1Char('+');
+    return usi;
+}
@@ -0,0 +1,144 @@
+/// @file josekibook.h
+/// @brief メモリマップで読むバイナリ定跡ファイルの定義
+
+#ifndef JOSEKIBOOK_H
+#define JOSEKIBOOK_H
+
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+#include <functional>
+
+#include "josekiioresult.h"
+#include "sortedkeyindex.h"
+
+struct JosekiMove;
+
+/**
+ * @brief バイナリ定跡ファイル（.jbk）の読み取り専用ビュー
+ *
+ * YANEURAOU-DB2016 テキストと同じ内容を、次の順に詰めて1ファイルに収める（数値はすべてリトルエンディアン）。
+ *
+ * | 領域         | 内容                                                                 |
+ * |--------------|----------------------------------------------------------------------|
+ * | ヘッダー     | マジック・版数・各領域のオフセット（64バイト）                       |
+ * | バケット表   | 局面キー上位 bucketBits ビットごとの先頭局面番号（2^bucketBits+1 個）|
+ * | 局面表       | キー昇順の局面レコード（キー・先頭指し手番号・指し手数・SFEN・手数） |
+ * | 指し手表     | 16ビット符号化した指し手・応手と評価値・深さ・頻度・コメント参照     |
+ * | 文字列プール | 長さ付き UTF-8 の正規化SFEN・コメント                                |
+ *
+ * ファイルは open() で読み取り専用にマップするだけで、局面の検索はキーのバケットから
+ * 範囲を絞った二分探索で行う（SortedKeyIndex。棋譜データベースと共通）。
+ * キーが衝突しても正規化SFEN を照合するので取り違えない。
+ * const メンバはマップ領域を読むだけなので、複数スレッドから同時に呼んでよい。
+ *
+ * 編集の保存はブックを書き直さず、変更した局面の内容を隣の追記ジャーナル（<book>-journal）に
+ * 足していく。ジャーナルはブックの指紋を持ち、別のブック用のものは読まない。
+ * ジャーナルが大きくなったら全体を書き直してジャーナルを消す（圧縮）。
+ */
+class JosekiBook
+{
+public:
+    JosekiBook();
+    ~JosekiBook();
+    Q_DISABLE_COPY_MOVE(JosekiBook)
+
+    /// 先頭がバイナリ定跡のマジックかどうか
+    static bool isBookFile(const QString &filePath);
+
+    /// 拡張子がバイナリ定跡（.jbk）かどうか（保存形式の判定用）
+    static bool hasBookSuffix(const QString &filePath);
+
+    /**
+     * @brief ファイルを読み取り専用でマップする
+     * @param filePath ファイルパス
+     * @param errorMessage エラーメッセージ（エラー時に設定される）
+     * @return 形式が正しくマップできた場合 true
+     */
+    [[nodiscard]] bool open(const QString &filePath, QString *errorMessage = nullptr);
+
+    QString filePath() const { return m_index.filePath(); }
+    int positionCount() const;
+    int moveCount() const;
+
+    /// 正規化SFEN の局面番号（なければ -1）
+    int findPosition(const QString &normalizedSfen) const;
+    bool contains(const QString &normalizedSfen) const { return findPosition(normalizedSfen) >= 0; }
+
+    QString normalizedSfenAt(int index) const;
+    /// 手数付きSFEN（手数がなければ正規化SFEN のまま）
+    QString sfenWithPlyAt(int index) const;
+    QList<JosekiMove> movesAt(int index) const;
+
+    /// 正規化SFEN から 64 ビットの局面キーを求める
+    static quint64 positionKey(QStringView normalizedSfen);
+
+    /// USI 指し手を16ビットに符号化する（none/resign/win も扱う）
+    static bool encodeMove(QStringView usi, quint16 &code);
+    static QString decodeMove(quint16 code);
+
+    /// 局面ごとの訪問関数（false を返すと打ち切る）
+    using PositionVisitor = std::function<bool(const QString &normalizedSfen, const QString &sfenWithPly,
+                                               const QList<JosekiMove> &moves)>;
+
+    /**
+     * @brief スナップショットの全局面を訪問する
+     *
+     * book の局面（上書き・削除したものを除く）をキー順に訪れたあと、josekiData を訪れる。
+     * @return 最後まで訪問した場合 true
+     */
+    static bool forEachPosition(const JosekiSnapshot &snapshot, const PositionVisitor &visitor);
+
+    /**
+     * @brief スナップショットをバイナリ定跡として書き出す（ワーカースレッドから呼べる）
+     *
+     * 一時ファイルに書いてから置き換えるので、書き込みに失敗しても元のファイルは残る。
+     * snapshot.book 自身のファイルへの保存は stagedPath() に書き、result.stagedBookPath で知らせる
+     * （マップ中のファイルは置き換えられないため。差し替えは replaceWithStaged で行う）。
+     */
+    [[nodiscard]] static JosekiSaveResult writeToFile(const QString &filePath, const JosekiSnapshot &snapshot);
+
+    /// ブックに対応する追記ジャーナルのパス
+    static QString journalPath(const QString &bookPath);
+
+    /// 開いているブック自身を書き直すときの書き出し先
+    static QString stagedPath(const QString &bookPath);
+
+    /**
+     * @brief stagedPath() に書いたブックで bookPath を置き換え、ジャーナルを消す
+     *
+     * bookPath をマップしている JosekiBook を全て閉じてから呼ぶ。
+     */
+    [[nodiscard]] static bool replaceWithStaged(const QString &bookPath, QString *errorMessage = nullptr);
+
+    /**
+     * @brief スナップショットの変更局面だけをジャーナルに追記する（ワーカースレッドから呼べる）
+     *
+     * snapshot.book が bookPath のファイルで、snapshot.bookFileInSync のときに使う。
+     * 追記でジャーナルが大きくなりすぎる場合は writeToFile で全体を書き直す。
+     */
+    [[nodiscard]] static JosekiSaveResult saveIncremental(const QString &bookPath, const JosekiSnapshot &snapshot);
+
+    /**
+     * @brief ブックのジャーナルを読み、上書き・削除した局面を result に入れる
+     *
+     * ジャーナルがない・別のブック用の場合は何もしない。末尾の壊れたレコードは捨てる。
+     */
+    static void replayJournal(const JosekiBook &book, JosekiLoadResult &result);
+
+    /// YANEURAOU-DB2016 テキストをバイナリ定跡に変換する
+    [[nodiscard]] static JosekiSaveResult convertTextToBook(const QString &textPath, const QString &bookPath);
+
+    /// バイナリ定跡を YANEURAOU-DB2016 テキストに変換する
+    [[nodiscard]] static JosekiSaveResult convertBookToText(const QString &bookPath, const QString &textPath);
+
+private:
+    const uchar *positionRecord(quint32 index) const;
+    const uchar *moveRecord(quint32 index) const;
+
+    SortedKeyIndex m_index;
+};
+
+#endif // JOSEKIBOOK_H
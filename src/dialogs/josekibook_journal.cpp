@@ -0,0 +1,268 @@
+/// @file josekibook_journal.cpp
+/// @brief バイナリ定跡の追記ジャーナル（変更局面の差分保存と読み込み時の再生）
+
+#include "josekibook.h"
+#include "josekibookformat.h"
+#include "josekiwindow.h"  // JosekiMove 構造体
+#include "logcategories.h"
+
+#include <QFileInfo>
+#include <cstring>
+
+using namespace JosekiBookFormat;
+
+namespace {
+
+quint32 fnv1a32(QByteArrayView data)
+{
+    quint32 h = 2166136261u;
+    for (const char c : data) {
+        h ^= static_cast<uchar>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/// ブックのヘッダーとファイルサイズから求める指紋（書き直したブックに古いジャーナルを当てないため）
+quint64 bookFingerprint(QByteArrayView header, qint64 fileSize)
+{
+    quint64 h = 14695981039346656037ULL ^ static_cast<quint64>(fileSize);
+    for (const char c : header) {
+        h ^= static_cast<uchar>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/// ディスク上のブックの指紋（読めなければ 0）
+quint64 fileFingerprint(const QString &bookPath)
+{
+    QFile file(bookPath);
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+    const QByteArray header = file.read(kHeaderSize);
+    if (header.size() != kHeaderSize) return 0;
+    return bookFingerprint(header, file.size());
+}
+
+void appendString(QByteArray &out, const QString &text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    appendLE<quint32>(out, static_cast<quint32>(utf8.size()));
+    out.append(utf8);
+}
+
+/// 局面1つ分のレコードを足す（スナップショットになければ削除レコード）
+void appendRecord(QByteArray &out, const QString &normalizedSfen, const JosekiSnapshot &snapshot)
+{
+    QByteArray payload;
+    const auto it = snapshot.josekiData.constFind(normalizedSfen);
+    const bool put = it != snapshot.josekiData.cend();
+    payload.append(static_cast<char>(put ? kJournalPut : kJournalRemove));
+    appendString(payload, normalizedSfen);
+    if (put) {
+        appendString(payload, snapshot.sfenWithPlyMap.value(normalizedSfen));
+        appendLE<quint32>(payload, static_cast<quint32>(it.value().size()));
+        for (const JosekiMove &move : it.value()) {
+            appendString(payload, move.move);
+            appendString(payload, move.nextMove);
+            appendLE<qint32>(payload, move.value);
+            appendLE<qint32>(payload, move.depth);
+            appendLE<qint32>(payload, move.frequency);
+            appendString(payload, move.comment);
+        }
+    }
+    appendLE<quint32>(out, static_cast<quint32>(payload.size()));
+    appendLE<quint32>(out, fnv1a32(payload));
+    out.append(payload);
+}
+
+/// レコードの内容を先頭から読む（範囲外を読もうとしたら ok が false になる）
+struct PayloadReader {
+    QByteArrayView data;
+    qsizetype pos = 0;
+    bool ok = true;
+
+    template <typename T>
+    T read()
+    {
+        if (!ok || data.size() - pos < static_cast<qsizetype>(sizeof(T))) {
+            ok = false;
+            return T{};
+        }
+        const T value = readLE<T>(reinterpret_cast<const uchar *>(data.data() + pos));
+        pos += static_cast<qsizetype>(sizeof(T));
+        return value;
+    }
+
+    QString readString()
+    {
+        const quint32 length = read<quint32>();
+        if (!ok || quint64(data.size() - pos) < length) {
+            ok = false;
+            return {};
+        }
+        const QString text = QString::fromUtf8(data.sliced(pos, length));
+        pos += length;
+        return text;
+    }
+};
+
+/**
+ * @brief ジャーナルの正しいレコードを先頭から順に visitor に渡す
+ * @return 最後の正しいレコードの直後のオフセット（ヘッダーが合わなければ -1）
+ */
+template <typename Visitor>
+qint64 scanJournal(QByteArrayView journal, quint64 fingerprint, Visitor &&visitor)
+{
+    const auto *data = reinterpret_cast<const uchar *>(journal.data());
+    if (journal.size() < kJournalHeaderSize
+        || std::memcmp(data, kJournalMagic, sizeof(kJournalMagic)) != 0
+        || readLE<quint64>(data + sizeof(kJournalMagic)) != fingerprint) {
+        return -1;
+    }
+    qint64 pos = kJournalHeaderSize;
+    while (journal.size() - pos >= kJournalRecordHeaderSize) {
+        const quint32 length = readLE<quint32>(data + pos);
+        if (quint64(journal.size() - pos - kJournalRecordHeaderSize) < length) break;
+        const QByteArrayView payload = journal.sliced(pos + kJournalRecordHeaderSize, length);
+        if (readLE<quint32>(data + pos + 4) != fnv1a32(payload)) break;
+        visitor(payload);
+        pos += kJournalRecordHeaderSize + length;
+    }
+    return pos;
+}
+
+} // namespace
+
+QString JosekiBook::journalPath(const QString &bookPath)
+{
+    return bookPath + QLatin1String(kJournalSuffix);
+}
+
+JosekiSaveResult JosekiBook::saveIncremental(const QString &bookPath, const JosekiSnapshot &snapshot)
+{
+    JosekiSaveResult result;
+    if (snapshot.dirtyPositions.isEmpty()) {
+        result.success = true;
+        return result;
+    }
+    const quint64 fingerprint = fileFingerprint(bookPath);
+    if (fingerprint == 0) {
+        return writeToFile(bookPath, snapshot);
+    }
+
+    QByteArray records;
+    for (const QString &normalizedSfen : snapshot.dirtyPositions) {
+        appendRecord(records, normalizedSfen, snapshot);
+    }
+
+    QFile journal(journalPath(bookPath));
+    if (!journal.open(QIODevice::ReadWrite)) {
+        result.errorMessage = QStringLiteral("ファイルを保存できませんでした: %1").arg(journal.fileName());
+        return result;
+    }
+
+    // 別のブック用なら作り直し、途中で切れたレコードがあれば正しい末尾まで切り詰めてから足す
+    qint64 validEnd = -1;
+    if (journal.size() >= kJournalHeaderSize) {
+        const qint64 size = journal.size();
+        const auto skip = [](QByteArrayView) {};
+        if (uchar *mapped = journal.map(0, size)) {
+            validEnd = scanJournal(QByteArrayView(reinterpret_cast<const char *>(mapped), size), fingerprint, skip);
+            journal.unmap(mapped);
+        } else {
+            validEnd = scanJournal(journal.readAll(), fingerprint, skip);
+        }
+    }
+    const qint64 journalSize = (validEnd > 0 ? validEnd : kJournalHeaderSize) + records.size();
+    const qint64 compactThreshold = qMax(kJournalMinCompactBytes, QFileInfo(bookPath).size() / kJournalCompactDivisor);
+    if (journalSize > compactThreshold) {
+        journal.close();
+        result = writeToFile(bookPath, snapshot);
+        result.compacted = result.success;
+        if (result.success) {
+            qCInfo(lcUi) << "Compacted joseki book" << bookPath << "with" << result.savedCount << "positions";
+        }
+        return result;
+    }
+
+    bool ok = true;
+    if (validEnd <= 0) {
+        QByteArray header(kJournalMagic, sizeof(kJournalMagic));
+        appendLE<quint64>(header, fingerprint);
+        ok = journal.resize(0) && journal.seek(0) && journal.write(header) == kJournalHeaderSize;
+    } else {
+        ok = journal.resize(validEnd) && journal.seek(validEnd);
+    }
+    ok = ok && journal.write(records) == records.size() && journal.flush();
+    if (!ok) {
+        result.errorMessage = QStringLiteral("ファイル書き込み中にエラーが発生しました: %1").arg(journal.fileName());
+        return result;
+    }
+    result.success = true;
+    result.savedCount = static_cast<int>(snapshot.dirtyPositions.size());
+    return result;
+}
+
+void JosekiBook::replayJournal(const JosekiBook &book, JosekiLoadResult &result)
+{
+    QFile journal(journalPath(book.filePath()));
+    if (!book.m_index.isOpen() || !journal.exists() || !journal.open(QIODevice::ReadOnly)) return;
+
+    const QByteArray data = journal.readAll();
+    const quint64 fingerprint =
+        bookFingerprint(QByteArrayView(reinterpret_cast<const char *>(book.m_index.data()), kHeaderSize),
+                        book.m_index.fileSize());
+    int replayed = 0;
+    const qint64 end = scanJournal(data, fingerprint, [&](QByteArrayView payload) {
+        PayloadReader reader{payload};
+        const quint8 kind = reader.read<quint8>();
+        const QString normalizedSfen = reader.readString();
+        if (kind == kJournalPut) {
+            const QString sfenWithPly = reader.readString();
+            const quint32 count = reader.read<quint32>();
+            QList<JosekiMove> moves;
+            for (quint32 i = 0; i < count && reader.ok; ++i) {
+                JosekiMove move;
+                move.move = reader.readString();
+                move.nextMove = reader.readString();
+                move.value = reader.read<qint32>();
+                move.depth = reader.read<qint32>();
+                move.frequency = reader.read<qint32>();
+                move.comment = reader.readString();
+                moves.append(move);
+            }
+            if (!reader.ok) return;
+            result.josekiData.insert(normalizedSfen, moves);
+            if (sfenWithPly.isEmpty()) {
+                result.sfenWithPlyMap.remove(normalizedSfen);
+            } else {
+                result.sfenWithPlyMap.insert(normalizedSfen, sfenWithPly);
+            }
+            result.removedBookPositions.remove(normalizedSfen);
+        } else {
+            if (!reader.ok) return;
+            result.josekiData.remove(normalizedSfen);
+            result.sfenWithPlyMap.remove(normalizedSfen);
+            if (book.findPosition(normalizedSfen) >= 0) {
+                result.removedBookPositions.insert(normalizedSfen);
+            }
+        }
+        ++replayed;
+    });
+    if (end < 0) {
+        qCWarning(lcUi) << "Ignored journal that does not belong to" << book.filePath();
+        return;
+    }
+    if (end < data.size()) {
+        qCWarning(lcUi) << "Ignored" << data.size() - end << "bytes of incomplete journal records for" << book.filePath();
+    }
+
+    // ブックの局面は上書きしていても1局面として数える
+    int count = book.positionCount() - static_cast<int>(result.removedBookPositions.size());
+    for (auto it = result.josekiData.cbegin(); it != result.josekiData.cend(); ++it) {
+        if (book.findPosition(it.key()) < 0) ++count;
+    }
+    result.positionCount = count;
+    qCInfo(lcUi) << "Replayed" << replayed << "journal records for" << book.filePath();
+}
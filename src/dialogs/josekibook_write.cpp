@@ -0,0 +1,273 @@
+/// @file josekibook_write.cpp
+/// @brief バイナリ定跡ファイルの書き出しと YANEURAOU-DB2016 テキストとの相互変換
+
+#include "josekibook.h"
+#include "josekibookformat.h"
+#include "josekirepository.h"
+#include "josekiwindow.h"  // JosekiMove 構造体
+#include "logcategories.h"
+
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <algorithm>
+#include <vector>
+
+using namespace JosekiBookFormat;
+
+bool JosekiBook::forEachPosition(const JosekiSnapshot &snapshot, const PositionVisitor &visitor)
+{
+    if (const JosekiBook *book = snapshot.book.get()) {
+        for (int i = 0; i < book->positionCount(); ++i) {
+            const QString normalized = book->normalizedSfenAt(i);
+            if (snapshot.josekiData.contains(normalized) || snapshot.removedBookPositions.contains(normalized)) {
+                continue;
+            }
+            if (!visitor(normalized, book->sfenWithPlyAt(i), book->movesAt(i))) return false;
+        }
+    }
+    for (auto it = snapshot.josekiData.cbegin(); it != snapshot.josekiData.cend(); ++it) {
+        if (!visitor(it.key(), snapshot.sfenWithPlyMap.value(it.key()), it.value())) return false;
+    }
+    return true;
+}
+
+JosekiSaveResult JosekiBook::convertTextToBook(const QString &textPath, const QString &bookPath)
+{
+    JosekiLoadResult loaded = JosekiRepository::parseFromFile(textPath);
+    if (!loaded.success) {
+        JosekiSaveResult result;
+        result.errorMessage = loaded.errorMessage;
+        return result;
+    }
+    JosekiSnapshot snapshot;
+    snapshot.josekiData = std::move(loaded.josekiData);
+    snapshot.sfenWithPlyMap = std::move(loaded.sfenWithPlyMap);
+    snapshot.book = std::move(loaded.book);
+    return writeToFile(bookPath, snapshot);
+}
+
+JosekiSaveResult JosekiBook::convertBookToText(const QString &bookPath, const QString &textPath)
+{
+    // ジャーナルの上書きも含めて書き出す
+    JosekiLoadResult loaded = JosekiRepository::parseFromFile(bookPath);
+    if (!loaded.success || !loaded.book) {
+        JosekiSaveResult result;
+        result.errorMessage = loaded.success ? QStringLiteral("バイナリ定跡ファイルではありません: %1").arg(bookPath)
+                                             : loaded.errorMessage;
+        return result;
+    }
+    JosekiSnapshot snapshot;
+    snapshot.josekiData = std::move(loaded.josekiData);
+    snapshot.sfenWithPlyMap = std::move(loaded.sfenWithPlyMap);
+    snapshot.book = std::move(loaded.book);
+    snapshot.removedBookPositions = std::move(loaded.removedBookPositions);
+    return JosekiRepository::serializeSnapshotToFile(textPath, snapshot);
+}
+
+QString JosekiBook::stagedPath(const QString &bookPath)
+{
+    return bookPath + QLatin1String(kStagedSuffix);
+}
+
+bool JosekiBook::replaceWithStaged(const QString &bookPath, QString *errorMessage)
+{
+    const QString staged = stagedPath(bookPath);
+    // 元のブックを消してから名前を変える（失敗しても書き出したブックは staged に残る）
+    if ((QFile::exists(bookPath) && !QFile::remove(bookPath)) || !QFile::rename(staged, bookPath)) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("ファイルを置き換えられませんでした: %1\n\n保存した内容: %2")
+                                .arg(bookPath, staged);
+        }
+        return false;
+    }
+    // 書き直したブックには前のジャーナルの内容も入っている
+    QFile::remove(journalPath(bookPath));
+    return true;
+}
+
+namespace {
+
+/// 書き出す局面（book の局面番号か、スナップショットの編集分を指す）
+struct WriteEntry {
+    quint64 key = 0;
+    int bookIndex = -1;
+    QMap<QString, QList<JosekiMove>>::const_iterator edited;
+    quint32 moveCount = 0;
+};
+
+/// 手数付きSFEN の4番目のフィールド（なければ 0）
+qint32 plyOf(const QString &sfenWithPly)
+{
+    const QStringList parts = sfenWithPly.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    bool ok = false;
+    const int ply = parts.size() >= 4 ? parts.at(3).toInt(&ok) : 0;
+    return ok && ply > 0 ? ply : 0;
+}
+
+bool isEncodableMove(const JosekiMove &move)
+{
+    quint16 code = 0;
+    return JosekiBook::encodeMove(move.move, code);
+}
+
+} // namespace
+
+JosekiSaveResult JosekiBook::writeToFile(const QString &filePath, const JosekiSnapshot &snapshot)
+{
+    JosekiSaveResult result;
+    const QString writeError = QStringLiteral("ファイル書き込み中にエラーが発生しました: %1").arg(filePath);
+    const JosekiBook *book = snapshot.book.get();
+
+    // 1. 書き出す局面を集めてキー順に並べる
+    std::vector<WriteEntry> entries;
+    QSet<int> hiddenBookPositions;
+    if (book) {
+        for (const QString &normalizedSfen : snapshot.removedBookPositions) {
+            hiddenBookPositions.insert(book->findPosition(normalizedSfen));
+        }
+        for (auto it = snapshot.josekiData.cbegin(); it != snapshot.josekiData.cend(); ++it) {
+            hiddenBookPositions.insert(book->findPosition(it.key()));
+        }
+        entries.reserve(static_cast<std::size_t>(book->positionCount()));
+        for (int i = 0; i < book->positionCount(); ++i) {
+            if (hiddenBookPositions.contains(i)) continue;
+            const uchar *record = book->positionRecord(quint32(i));
+            const quint32 first = readLE<quint32>(record + kPositionFirstMove);
+            WriteEntry entry;
+            entry.key = book->m_index.keyAt(quint32(i));
+            entry.bookIndex = i;
+            entry.moveCount = readLE<quint16>(record + kPositionMoveCount);
+            const quint32 bookMoveCount = book->m_index.recordCount(kMoveTable);
+            if (first > bookMoveCount || entry.moveCount > bookMoveCount - first) {
+                entry.moveCount = 0;  // 壊れたレコードの指し手は写さない
+            }
+            entries.push_back(entry);
+        }
+    }
+    int skippedMoves = 0;
+    for (auto it = snapshot.josekiData.cbegin(); it != snapshot.josekiData.cend(); ++it) {
+        WriteEntry entry;
+        entry.key = positionKey(it.key());
+        entry.edited = it;
+        entry.moveCount = static_cast<quint32>(std::count_if(it.value().cbegin(), it.value().cend(), isEncodableMove));
+        skippedMoves += static_cast<int>(it.value().size()) - static_cast<int>(entry.moveCount);
+        if (entry.moveCount > 0xFFFF) {
+            result.errorMessage = QStringLiteral("1局面の指し手が多すぎるため保存できません: %1").arg(it.key());
+            return result;
+        }
+        entries.push_back(entry);
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const WriteEntry &a, const WriteEntry &b) { return a.key < b.key; });
+
+    const quint32 bucketBits = bucketBitsFor(entries.size());
+
+    // 2. バケット表・局面表・SFEN を組み立てる
+    QByteArray buckets = bucketTable(entries, bucketBits, [](const WriteEntry &entry) { return entry.key; });
+    QByteArray positions;
+    QByteArray pool;
+    positions.reserve(static_cast<qsizetype>(entries.size() * kPositionRecordSize));
+    quint64 moveTotal = 0;
+    for (const WriteEntry &entry : entries) {
+        quint32 sfenOffset = 0;
+        qint32 ply = 0;
+        if (entry.bookIndex >= 0) {
+            const uchar *record = book->positionRecord(quint32(entry.bookIndex));
+            sfenOffset = appendPoolString(pool, book->m_index.poolBytes(readLE<quint32>(record + kPositionSfen)));
+            ply = readLE<qint32>(record + kPositionPly);
+        } else {
+            sfenOffset = appendPoolString(pool, entry.edited.key().toUtf8());
+            ply = plyOf(snapshot.sfenWithPlyMap.value(entry.edited.key()));
+        }
+        appendLE<quint64>(positions, entry.key);
+        appendLE<quint32>(positions, static_cast<quint32>(moveTotal));
+        appendLE<quint32>(positions, sfenOffset);
+        appendLE<quint16>(positions, static_cast<quint16>(entry.moveCount));
+        appendLE<quint16>(positions, 0);
+        appendLE<qint32>(positions, ply);
+        moveTotal += entry.moveCount;
+    }
+    if (moveTotal > 0xFFFFFFFFu) {
+        result.errorMessage = QStringLiteral("指し手が多すぎるため保存できません: %1").arg(filePath);
+        return result;
+    }
+
+    // マップ中のブック自身は置き換えられないので、隣に書いて差し替えはメインスレッドに任せる
+    const bool ontoMappedBook = book && QFileInfo(book->filePath()) == QFileInfo(filePath);
+    QSaveFile file(ontoMappedBook ? stagedPath(filePath) : filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        result.errorMessage = QStringLiteral("ファイルを保存できませんでした: %1").arg(file.fileName());
+        return result;
+    }
+    bool ok = file.write(QByteArray(kHeaderSize, '\0')) == kHeaderSize
+              && file.write(buckets) == buckets.size()
+              && file.write(positions) == positions.size();
+    buckets = QByteArray();
+    positions = QByteArray();
+
+    // 3. 指し手表を書きながらコメントをプールに足す（book の指し手はレコードを写す）
+    QByteArray chunk;
+    chunk.reserve(kWriteChunkSize + kMoveRecordSize);
+    const auto flushChunk = [&]() {
+        ok = ok && file.write(chunk) == chunk.size();
+        chunk.clear();
+    };
+    for (const WriteEntry &entry : entries) {
+        if (entry.bookIndex >= 0) {
+            const uchar *record = book->positionRecord(quint32(entry.bookIndex));
+            const quint32 first = readLE<quint32>(record + kPositionFirstMove);
+            for (quint32 i = 0; i < entry.moveCount; ++i) {
+                const uchar *m = book->moveRecord(first + i);
+                const quint32 commentOffset = readLE<quint32>(m + kMoveComment);
+                chunk.append(reinterpret_cast<const char *>(m), kMoveComment);
+                appendLE<quint32>(chunk, commentOffset == kNoString
+                                             ? kNoString
+                                             : appendPoolString(pool, book->m_index.poolBytes(commentOffset)));
+            }
+        } else {
+            for (const JosekiMove &move : entry.edited.value()) {
+                quint16 code = 0;
+                quint16 nextCode = kMoveNone;
+                if (!encodeMove(move.move, code)) continue;
+                (void)encodeMove(move.nextMove, nextCode);
+                appendLE<quint16>(chunk, code);
+                appendLE<quint16>(chunk, nextCode);
+                appendLE<qint32>(chunk, move.value);
+                appendLE<qint32>(chunk, move.depth);
+                appendLE<qint32>(chunk, move.frequency);
+                appendLE<quint32>(chunk, move.comment.isEmpty() ? kNoString
+                                                                : appendPoolString(pool, move.comment.toUtf8()));
+            }
+        }
+        if (chunk.size() >= kWriteChunkSize) flushChunk();
+    }
+    flushChunk();
+    if (quint64(pool.size()) >= kNoString) {
+        result.errorMessage = QStringLiteral("コメントが多すぎるため保存できません: %1").arg(filePath);
+        return result;
+    }
+    ok = ok && file.write(pool) == pool.size();
+
+    // 4. ヘッダーを書き戻して置き換える
+    const quint32 recordCount[kTableCount] = {static_cast<quint32>(entries.size()), static_cast<quint32>(moveTotal)};
+    const QByteArray header = headerBytes(kLayout, bucketBits, recordCount, quint64(pool.size()));
+    ok = ok && file.seek(0) && file.write(header) == kHeaderSize;
+    if (!ok || !file.commit()) {
+        result.errorMessage = writeError;
+        return result;
+    }
+    if (ontoMappedBook) {
+        result.stagedBookPath = file.fileName();
+    } else {
+        // 書き直したブックには前のジャーナルの内容も入っている
+        QFile::remove(journalPath(filePath));
+    }
+
+    if (skippedMoves > 0) {
+        qCWarning(lcUi) << skippedMoves << "moves could not be encoded and were not saved to" << filePath;
+    }
+    result.success = true;
+    result.savedCount = static_cast<int>(entries.size());
+    return result;
+}
@@ -0,0 +1,70 @@
+/// @file josekibookformat.h
+/// @brief バイナリ定跡ファイルのレイアウト定数と読み書きヘルパー（josekibook*.cpp 専用）
+
+#ifndef JOSEKIBOOKFORMAT_H
+#define JOSEKIBOOKFORMAT_H
+
+#include "sortedkeyindexformat.h"
+
+/// 数値はすべてリトルエンディアン。領域の並びは JosekiBook のクラスコメントを参照
+namespace JosekiBookFormat {
+
+// ヘッダー・バケット表・文字列プールと読み書きヘルパーは棋譜データベースと共通
+using namespace SortedKeyIndexFormat;
+
+inline constexpr char kMagic[8] = {'J', 'O', 'S', 'E', 'K', 'I', 'B', 'K'};
+inline constexpr char kFileSuffix[] = ".jbk";
+inline constexpr quint32 kVersion = 1;
+
+// 表0が局面表（キー順）、表1が指し手表
+inline constexpr int kPositionTable = 0;
+inline constexpr int kMoveTable = 1;
+
+// 局面レコード（24バイト）: キー・先頭指し手番号・SFEN の文字列参照・指し手数・予備・手数
+inline constexpr qint64 kPositionRecordSize = 24;
+inline constexpr int kPositionKey = 0;
+inline constexpr int kPositionFirstMove = 8;
+inline constexpr int kPositionSfen = 12;
+inline constexpr int kPositionMoveCount = 16;
+inline constexpr int kPositionPly = 20;
+
+// 指し手レコード（20バイト）: 指し手・応手・評価値・深さ・頻度・コメントの文字列参照
+inline constexpr qint64 kMoveRecordSize = 20;
+inline constexpr int kMoveCode = 0;
+inline constexpr int kMoveNextCode = 2;
+inline constexpr int kMoveValue = 4;
+inline constexpr int kMoveDepth = 8;
+inline constexpr int kMoveFrequency = 12;
+inline constexpr int kMoveComment = 16;
+
+// 指し手の16ビット符号: 移動先(7) | 移動元(7, 駒打ちは 81+駒種) << 7 | 成り << 14。
+// 移動元と移動先が同じ符号は指し手にならないので特別な手に使う。
+inline constexpr int kSquareCount = 81;
+inline constexpr int kDropFromBase = kSquareCount;
+inline constexpr quint16 kMovePromoteBit = 1 << 14;
+inline constexpr quint16 kMoveNone = 0;
+inline constexpr quint16 kMoveResign = (2 << 7) | 2;
+inline constexpr quint16 kMoveWin = (3 << 7) | 3;
+
+inline constexpr Layout kLayout{kMagic, kVersion, {kPositionRecordSize, kMoveRecordSize}, kPositionTable,
+                                "バイナリ定跡ファイル"};
+
+// 開いている（マップ中の）ブック自身を書き直すときの書き出し先（<book>-staged）。
+// マップ中のファイルは Windows では置き換えられないので、ブックを閉じてから差し替える。
+inline constexpr char kStagedSuffix[] = "-staged";
+
+// 追記ジャーナル（<book>-journal）: マジック(8) | ブックの指紋(8) のあとにレコードを並べる。
+// レコードは 内容の長さ(4) | 内容の FNV-1a(4) | 内容。途中で切れたレコード以降は読まない。
+inline constexpr char kJournalMagic[8] = {'J', 'O', 'S', 'E', 'K', 'I', 'J', 'L'};
+inline constexpr char kJournalSuffix[] = "-journal";
+inline constexpr qint64 kJournalHeaderSize = 16;
+inline constexpr qint64 kJournalRecordHeaderSize = 8;
+inline constexpr quint8 kJournalRemove = 0;
+inline constexpr quint8 kJournalPut = 1;
+/// ジャーナルがブックの 1/kJournalCompactDivisor（最低 kJournalMinCompactBytes）を超えたらブックを書き直す
+inline constexpr qint64 kJournalCompactDivisor = 4;
+inline constexpr qint64 kJournalMinCompactBytes = 256 * 1024;
+
+} // namespace JosekiBookFormat
+
+#endif // JOSEKIBOOKFORMAT_H
@@ -0,0 +1,141 @@
+/// @file josekicorpusbuilddialog.cpp
+/// @brief 棋譜フォルダからの定跡一括作成の条件入力ダイアログの実装
+
+#include "josekicorpusbuilddialog.h"
+
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QDir>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QRegularExpression>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+JosekiCorpusBuildDialog::JosekiCorpusBuildDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setupUi();
+}
+
+void JosekiCorpusBuildDialog::setupUi()
+{
+    setWindowTitle(tr("棋譜フォルダから定跡を一括作成"));
+    setMinimumWidth(520);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    // === 対象 ===
+    QGroupBox *sourceGroup = new QGroupBox(tr("対象の棋譜"), this);
+    QVBoxLayout *sourceLayout = new QVBoxLayout(sourceGroup);
+    QHBoxLayout *pathLayout = new QHBoxLayout();
+    m_sourceEdit = new QLineEdit(this);
+    m_sourceEdit->setPlaceholderText(tr("フォルダ、または *.csa などのワイルドカード付きパス"));
+    m_sourceEdit->setToolTip(tr("KIF/KI2/CSA/JKF/USEN/USI 形式の棋譜ファイルを読み込みます。"));
+    pathLayout->addWidget(m_sourceEdit, 1);
+    QPushButton *browseButton = new QPushButton(tr("参照..."), this);
+    pathLayout->addWidget(browseButton);
+    sourceLayout->addLayout(pathLayout);
+    m_recursiveCheck = new QCheckBox(tr("サブフォルダも含める"), this);
+    m_recursiveCheck->setChecked(true);
+    sourceLayout->addWidget(m_recursiveCheck);
+    mainLayout->addWidget(sourceGroup);
+
+    // === 集計条件 ===
+    QGroupBox *filterGroup = new QGroupBox(tr("集計条件"), this);
+    QFormLayout *filterLayout = new QFormLayout(filterGroup);
+
+    QHBoxLayout *plyLayout = new QHBoxLayout();
+    m_minPlySpin = new QSpinBox(this);
+    m_minPlySpin->setRange(1, 999);
+    m_minPlySpin->setValue(1);
+    m_maxPlySpin = new QSpinBox(this);
+    m_maxPlySpin->setRange(0, 999);
+    m_maxPlySpin->setValue(40);
+    m_maxPlySpin->setSpecialValueText(tr("終局まで"));
+    plyLayout->addWidget(m_minPlySpin);
+    plyLayout->addWidget(new QLabel(tr("手目 〜"), this));
+    plyLayout->addWidget(m_maxPlySpin);
+    plyLayout->addWidget(new QLabel(tr("手目"), this));
+    plyLayout->addStretch();
+    filterLayout->addRow(tr("手数:"), plyLayout);
+
+    m_minRatingSpin = new QSpinBox(this);
+    m_minRatingSpin->setRange(0, 9999);
+    m_minRatingSpin->setSingleStep(100);
+    m_minRatingSpin->setSpecialValueText(tr("指定なし"));
+    m_minRatingSpin->setToolTip(tr("両対局者のレーティングがこの値以上の対局だけを集計します。\n"
+                                   "レーティングが記録されていない対局は除きます。"));
+    filterLayout->addRow(tr("最低レーティング:"), m_minRatingSpin);
+
+    m_playersEdit = new QLineEdit(this);
+    m_playersEdit->setPlaceholderText(tr("カンマ区切りで複数指定（部分一致）"));
+    filterLayout->addRow(tr("対局者名:"), m_playersEdit);
+
+    m_playerMovesOnlyCheck = new QCheckBox(tr("指定した対局者の指し手だけを数える"), this);
+    filterLayout->addRow(QString(), m_playerMovesOnlyCheck);
+
+    m_variationsCheck = new QCheckBox(tr("変化の指し手も数える"), this);
+    filterLayout->addRow(QString(), m_variationsCheck);
+    mainLayout->addWidget(filterGroup);
+
+    m_buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    m_buttonBox->button(QDialogButtonBox::Ok)->setText(tr("作成"));
+    mainLayout->addWidget(m_buttonBox);
+
+    connect(browseButton, &QPushButton::clicked, this, &JosekiCorpusBuildDialog::onBrowseClicked);
+    connect(m_sourceEdit, &QLineEdit::textChanged, this, &JosekiCorpusBuildDialog::updateOkButton);
+    connect(m_playersEdit, &QLineEdit::textChanged, this, &JosekiCorpusBuildDialog::updateOkButton);
+    connect(m_buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(m_buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    updateOkButton();
+}
+
+void JosekiCorpusBuildDialog::onBrowseClicked()
+{
+    const QString current = sourcePath();
+    const QString dir = QFileDialog::getExistingDirectory(
+        this, tr("棋譜フォルダを選択"), current.isEmpty() ? QDir::homePath() : current);
+    if (!dir.isEmpty()) m_sourceEdit->setText(QDir::toNativeSeparators(dir));
+}
+
+void JosekiCorpusBuildDialog::updateOkButton()
+{
+    m_buttonBox->button(QDialogButtonBox::Ok)->setEnabled(!sourcePath().isEmpty());
+    m_playerMovesOnlyCheck->setEnabled(!m_playersEdit->text().trimmed().isEmpty());
+}
+
+QString JosekiCorpusBuildDialog::sourcePath() const
+{
+    return QDir::fromNativeSeparators(m_sourceEdit->text().trimmed());
+}
+
+void JosekiCorpusBuildDialog::setSourcePath(const QString &path)
+{
+    m_sourceEdit->setText(QDir::toNativeSeparators(path));
+}
+
+bool JosekiCorpusBuildDialog::recursive() const
+{
+    return m_recursiveCheck->isChecked();
+}
+
+JosekiCorpusBuilder::Options JosekiCorpusBuildDialog::options() const
+{
+    JosekiCorpusBuilder::Options options;
+    options.minPly = m_minPlySpin->value();
+    options.maxPly = m_maxPlySpin->value();
+    options.minRating = m_minRatingSpin->value();
+    static const QRegularExpression separators(QStringLiteral("[,、，]"));
+    for (const QString &name : m_playersEdit->text().split(separators, Qt::SkipEmptyParts)) {
+        if (!name.trimmed().isEmpty()) options.players.append(name.trimmed());
+    }
+    options.playerMovesOnly = m_playerMovesOnlyCheck->isEnabled() && m_playerMovesOnlyCheck->isChecked();
+    options.includeVariations = m_variationsCheck->isChecked();
+    return options;
+}
@@ -0,0 +1,58 @@
+#ifndef JOSEKICORPUSBUILDDIALOG_H
+#define JOSEKICORPUSBUILDDIALOG_H
+
+/// @file josekicorpusbuilddialog.h
+/// @brief 棋譜フォルダからの定跡一括作成の条件入力ダイアログの定義
+
+#include <QDialog>
+
+#include "josekicorpusbuilder.h"
+
+class QCheckBox;
+class QDialogButtonBox;
+class QLineEdit;
+class QSpinBox;
+
+/**
+ * @brief 棋譜フォルダからの定跡一括作成ダイアログ
+ *
+ * 対象の棋譜フォルダ（またはワイルドカード付きのパス）と、
+ * 手数範囲・レーティング・対局者名の集計条件を入力する。
+ */
+class JosekiCorpusBuildDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit JosekiCorpusBuildDialog(QWidget *parent = nullptr);
+    ~JosekiCorpusBuildDialog() override = default;
+
+    /// 棋譜フォルダ、またはワイルドカードを含むパス
+    QString sourcePath() const;
+    void setSourcePath(const QString &path);
+
+    /// サブフォルダも探すか
+    bool recursive() const;
+
+    /// 入力された集計条件
+    JosekiCorpusBuilder::Options options() const;
+
+private slots:
+    void onBrowseClicked();
+    void updateOkButton();
+
+private:
+    void setupUi();
+
+    QLineEdit *m_sourceEdit = nullptr;
+    QCheckBox *m_recursiveCheck = nullptr;
+    QSpinBox *m_minPlySpin = nullptr;
+    QSpinBox *m_maxPlySpin = nullptr;
+    QSpinBox *m_minRatingSpin = nullptr;
+    QLineEdit *m_playersEdit = nullptr;
+    QCheckBox *m_playerMovesOnlyCheck = nullptr;
+    QCheckBox *m_variationsCheck = nullptr;
+    QDialogButtonBox *m_buttonBox = nullptr;
+};
+
+#endif // JOSEKICORPUSBUILDDIALOG_H
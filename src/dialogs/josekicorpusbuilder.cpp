@@ -0,0 +1,183 @@
+/// @file josekicorpusbuilder.cpp
+/// @brief 棋譜ファイル群から定跡の指し手出現数を集計するビルダーの実装
+
+#include "josekicorpusbuilder.h"
+#include "gameinfokeys.h"
+#include "kifparsetypes.h"
+#include "kifucorpusbatch.h"
+#include "kifucorpusfiles.h"
+#include "sfenpositiontracer.h"
+#include "logcategories.h"
+
+#include <QElapsedTimer>
+
+#include <climits>
+
+namespace {
+
+using KifuCorpusFiles::gameInfoValue;
+
+bool nameMatches(const QString &name, const QStringList &players)
+{
+    for (const QString &player : players) {
+        if (name.contains(player, Qt::CaseInsensitive)) return true;
+    }
+    return false;
+}
+
+bool ratingAtLeast(const QString &rating, int minRating)
+{
+    bool ok = false;
+    const double value = rating.toDouble(&ok);
+    return ok && value >= minRating;
+}
+
+/// 1本の手順を辿り、数える手数・手番の指し手を集計に足す
+void tallyLine(const KifLine &line, int firstPly, const JosekiCorpusBuilder::Options &options, bool countBlack,
+               bool countWhite, JosekiCorpusTally &tally, qint64 &moveCount)
+{
+    SfenPositionTracer tracer;
+    if (line.baseSfen.isEmpty()) {
+        tracer.resetToStartpos();
+    } else if (!tracer.setFromSfen(line.baseSfen)) {
+        return;
+    }
+
+    const int lastPly = options.maxPly > 0 ? options.maxPly : INT_MAX;
+    for (qsizetype i = 0; i < line.usiMoves.size(); ++i) {
+        const int ply = firstPly + static_cast<int>(i);
+        if (ply > lastPly) break;
+
+        const QString &usi = line.usiMoves.at(i);
+        const bool count = ply >= options.minPly && (tracer.blackToMove() ? countBlack : countWhite);
+        const QString sfen = count ? tracer.toSfenString() : QString();
+        if (!tracer.applyUsiMove(usi)) break;
+        if (!count) continue;
+
+        // 正規化SFEN は手数を除いた先頭3フィールド
+        JosekiPositionTally &position = tally[sfen.left(sfen.lastIndexOf(QLatin1Char(' ')))];
+        if (position.sfenWithPly.isEmpty()) position.sfenWithPly = sfen;
+        ++position.moveCounts[usi];
+        ++moveCount;
+    }
+}
+
+/// from の集計を into に足す
+void mergeTally(JosekiCorpusTally &into, JosekiCorpusTally &&from)
+{
+    if (into.isEmpty()) {
+        into = std::move(from);
+        return;
+    }
+    into.reserve(into.size() + from.size());
+    for (auto it = from.begin(); it != from.end(); ++it) {
+        auto dst = into.find(it.key());
+        if (dst == into.end()) {
+            into.insert(it.key(), std::move(it.value()));
+            continue;
+        }
+        for (auto m = it.value().moveCounts.cbegin(); m != it.value().moveCounts.cend(); ++m) {
+            dst.value().moveCounts[m.key()] += m.value();
+        }
+    }
+}
+
+/// スレッド1本分の集計
+struct PartialTally {
+    JosekiCorpusTally tally;
+    JosekiCorpusBuilder::Stats stats;
+};
+
+} // namespace
+
+double JosekiCorpusBuilder::Stats::gamesPerSecond() const
+{
+    return elapsedMs > 0 ? gameCount * 1000.0 / elapsedMs : 0.0;
+}
+
+double JosekiCorpusBuilder::Stats::positionsPerSecond() const
+{
+    return elapsedMs > 0 ? moveCount * 1000.0 / elapsedMs : 0.0;
+}
+
+bool JosekiCorpusBuilder::tallyGame(const KifParseResult &game, const Options &options, JosekiCorpusTally &tally,
+                                    qint64 &moveCount)
+{
+    if (game.mainline.usiMoves.isEmpty()) return false;
+
+    // 駒落ちでは下手が先手・上手が後手
+    const QString black = gameInfoValue(game.gameInfo, GameInfoKeys::kBlackPlayer, QStringLiteral("下手"));
+    const QString white = gameInfoValue(game.gameInfo, GameInfoKeys::kWhitePlayer, QStringLiteral("上手"));
+
+    if (options.minRating > 0
+        && !(ratingAtLeast(gameInfoValue(game.gameInfo, GameInfoKeys::kBlackRating), options.minRating)
+             && ratingAtLeast(gameInfoValue(game.gameInfo, GameInfoKeys::kWhiteRating), options.minRating))) {
+        return false;
+    }
+
+    bool countBlack = true;
+    bool countWhite = true;
+    if (!options.players.isEmpty()) {
+        const bool blackMatches = nameMatches(black, options.players);
+        const bool whiteMatches = nameMatches(white, options.players);
+        if (!blackMatches && !whiteMatches) return false;
+        if (options.playerMovesOnly) {
+            countBlack = blackMatches;
+            countWhite = whiteMatches;
+        }
+    }
+
+    tallyLine(game.mainline, game.mainline.startPly, options, countBlack, countWhite, tally, moveCount);
+    if (options.includeVariations) {
+        for (const KifVariation &variation : game.variations) {
+            if (variation.line.baseSfen.isEmpty()) continue;
+            tallyLine(variation.line, variation.startPly, options, countBlack, countWhite, tally, moveCount);
+        }
+    }
+    return true;
+}
+
+JosekiCorpusBuilder::Result JosekiCorpusBuilder::build(const QStringList &files, const Options &options,
+                                                       const ProgressCallback &progress)
+{
+    Result result;
+    result.stats.fileCount = static_cast<int>(files.size());
+    QElapsedTimer timer;
+    timer.start();
+
+    // 範囲ごとに別々の集計を作り（ロック不要）、ファイル順に足し合わせる
+    const auto readRange = [&](qsizetype begin, qsizetype end) {
+        PartialTally partial;
+        for (qsizetype i = begin; i < end; ++i) {
+            KifParseResult game;
+            QString warn;
+            if (!KifuCorpusFiles::parseFile(files.at(i), game, &warn)) {
+                ++partial.stats.failedCount;
+                continue;
+            }
+            if (tallyGame(game, options, partial.tally, partial.stats.moveCount)) {
+                ++partial.stats.gameCount;
+            } else {
+                ++partial.stats.filteredCount;
+            }
+        }
+        return partial;
+    };
+    const auto merge = [&](PartialTally &partial) {
+        mergeTally(result.tally, std::move(partial.tally));
+        result.stats.gameCount += partial.stats.gameCount;
+        result.stats.filteredCount += partial.stats.filteredCount;
+        result.stats.failedCount += partial.stats.failedCount;
+        result.stats.moveCount += partial.stats.moveCount;
+    };
+    if (!KifuCorpusFiles::processInBatches(files.size(), readRange, merge, progress)) {
+        result.tally.clear();
+        result.cancelled = true;
+    }
+
+    result.stats.positionCount = static_cast<int>(result.tally.size());
+    result.stats.elapsedMs = timer.elapsed();
+    qCInfo(lcUi) << "Joseki corpus build:" << result.stats.gameCount << "games," << result.stats.moveCount
+                 << "moves," << result.stats.positionCount << "positions in" << result.stats.elapsedMs << "ms";
+    return result;
+}
@@ -0,0 +1,76 @@
+/// @file josekicorpusbuilder.h
+/// @brief 棋譜ファイル群から定跡の指し手出現数を集計するビルダーの定義
+
+#ifndef JOSEKICORPUSBUILDER_H
+#define JOSEKICORPUSBUILDER_H
+
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+#include "josekiioresult.h"
+
+struct KifParseResult;
+
+/**
+ * @brief 棋譜フォルダから定跡を一括作成するための集計処理（UI に依存しない）
+ *
+ * KIF/KI2/CSA/JKF/USEN/USI の棋譜ファイル（KifuCorpusFiles::collectFiles で集める）をワーカースレッドで並列に読み、
+ * 指定手数までの局面と指し手を数える。スレッドごとの集計を最後に1つにまとめるので、
+ * 数万局の棋譜でもメインスレッドのリポジトリへは JosekiRepository::mergeCorpusTally の1回で反映できる。
+ */
+class JosekiCorpusBuilder
+{
+public:
+    /// 集計条件
+    struct Options {
+        int minPly = 1;                  ///< 数え始める手数
+        int maxPly = 40;                 ///< 数える最後の手数（0 なら終局まで）
+        int minRating = 0;               ///< 両対局者に求める最低レーティング（0 なら条件なし）
+        QStringList players;             ///< どちらかの対局者名に含まれるべき文字列（空なら条件なし）
+        bool playerMovesOnly = false;    ///< players に合う対局者の指し手だけを数える
+        bool includeVariations = false;  ///< 変化の指し手も数える
+    };
+
+    /// 集計の統計（スループット報告用）
+    struct Stats {
+        int fileCount = 0;       ///< 対象ファイル数
+        int gameCount = 0;       ///< 集計した対局数
+        int filteredCount = 0;   ///< 条件に合わず除いた対局数
+        int failedCount = 0;     ///< 読めなかったファイル数
+        qint64 moveCount = 0;    ///< 数えた指し手（局面）の延べ数
+        int positionCount = 0;   ///< 異なる局面の数
+        qint64 elapsedMs = 0;    ///< 経過時間（ミリ秒）
+
+        double gamesPerSecond() const;
+        double positionsPerSecond() const;
+    };
+
+    /// 集計結果
+    struct Result {
+        JosekiCorpusTally tally;
+        Stats stats;
+        bool cancelled = false;
+    };
+
+    /// 進捗通知（0〜100。false を返すと中断する）。build を呼んだスレッドで呼ばれる
+    using ProgressCallback = std::function<bool(int percent)>;
+
+    /**
+     * @brief 棋譜ファイル群を集計する（ワーカースレッドから呼ぶ）
+     *
+     * ファイルを一定数ずつ区切り、区切りごとにスレッドプールで並列に読んで集計をまとめる。
+     * 中断した場合は cancelled を立て、空の集計を返す。
+     */
+    static Result build(const QStringList &files, const Options &options, const ProgressCallback &progress = {});
+
+    /**
+     * @brief 読み込んだ1局を集計に足す
+     * @return 条件に合って集計した場合 true（moveCount に数えた指し手数を足す）
+     */
+    static bool tallyGame(const KifParseResult &game, const Options &options, JosekiCorpusTally &tally,
+                          qint64 &moveCount);
+};
+
+#endif // JOSEKICORPUSBUILDER_H
@@ -4,11 +4,16 @@
 #ifndef JOSEKIIORESULT_H
 #define JOSEKIIORESULT_H
 
+#include <QHash>
 #include <QMap>
 #include <QList>
+#include <QSet>
 #include <QString>
 
+#include <memory>
+
 struct JosekiMove;
+class JosekiBook;
 
 /**
  * @brief 定跡ファイル読み込み結果（値型）
@@ -25,10 +30,46 @@ struct JosekiLoadResult {
     /// 元のSFEN（手数付き）マップ
     QMap<QString, QString> sfenWithPlyMap;
 
+    /// バイナリ定跡を開いた場合のブック（josekiData にはジャーナルで上書きした局面だけが入る）
+    std::shared_ptr<const JosekiBook> book;
+
+    /// ジャーナルで book から削除した局面（正規化SFEN）
+    QSet<QString> removedBookPositions;
+
     /// 読み込んだ局面数
     int positionCount = 0;
 };
 
+/**
+ * @brief 保存用の定跡データのスナップショット（値型）
+ *
+ * book があれば book の局面に josekiData を上書きしたものが全体になる。
+ * book は読み取り専用なのでワーカースレッドと共有してよい。
+ */
+struct JosekiSnapshot {
+    /// 定跡データ（book があれば編集した局面だけ）
+    QMap<QString, QList<JosekiMove>> josekiData;
+
+    /// 元のSFEN（手数付き）マップ
+    QMap<QString, QString> sfenWithPlyMap;
+
+    /// 開いているバイナリ定跡（なければ null）
+    std::shared_ptr<const JosekiBook> book;
+
+    /// book から削除した局面（正規化SFEN）
+    QSet<QString> removedBookPositions;
+
+    /// 最後の保存から変更した局面（正規化SFEN。josekiData になければ削除された局面）
+    QSet<QString> dirtyPositions;
+
+    /// スナップショット時点の編集番号（保存完了時に JosekiRepository::markSaved へ渡す）
+    quint64 editSerial = 0;
+
+    /// book のファイル（とジャーナル）が dirtyPositions 以外は josekiData と一致しているか。
+    /// true のときだけ、book 自身への保存を変更局面のジャーナル追記で済ませられる
+    bool bookFileInSync = false;
+};
+
 /**
  * @brief 定跡ファイル保存結果（値型）
  */
@@ -36,6 +77,27 @@ struct JosekiSaveResult {
     bool success = false;
     QString errorMessage;
     int savedCount = 0;
+
+    /// ジャーナルが大きくなったためバイナリ定跡全体を書き直した
+    bool compacted = false;
+
+    /// 開いているブック自身を書き直した場合の新しいブックのパス（空でなければ、メインスレッドで
+    /// JosekiRepository::installStagedBook によりブックを閉じてから差し替える）
+    QString stagedBookPath;
 };
 
+/**
+ * @brief 棋譜から数えた1局面分の指し手の出現数（値型）
+ */
+struct JosekiPositionTally {
+    /// 最初に数えたときの手数付きSFEN
+    QString sfenWithPly;
+
+    /// USI指し手 → 出現数
+    QHash<QString, int> moveCounts;
+};
+
+/// 棋譜集計の結果（正規化SFEN → 局面ごとの出現数）
+using JosekiCorpusTally = QHash<QString, JosekiPositionTally>;
+
 #endif // JOSEKIIORESULT_H
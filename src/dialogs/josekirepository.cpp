@@ -2,13 +2,36 @@
 /// @brief 定跡データのファイルI/Oを担当するリポジトリクラスの実装
 
 #include "josekirepository.h"
+#include "josekibook.h"
 #include "josekiwindow.h"  // JosekiMove 構造体
 #include "logcategories.h"
 
-#include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QStringView>
 
+#include <algorithm>
+
+namespace {
+
+/// テキスト保存で一度に書き出す量の目安
+constexpr qsizetype kWriteBufferSize = 1 << 20;
+
+/// ' ' 区切りの空でないフィールド数
+qsizetype fieldCount(QStringView text)
+{
+    qsizetype count = 0;
+    bool inField = false;
+    for (const QChar c : text) {
+        const bool space = c == QLatin1Char(' ');
+        if (!space && !inField) ++count;
+        inField = !space;
+    }
+    return count;
+}
+
+} // namespace
+
 const QList<JosekiMove> JosekiRepository::s_emptyMoves;
 
 void JosekiRepository::clear()
@@ -16,11 +39,61 @@ void JosekiRepository::clear()
     m_josekiData.clear();
     m_sfenWithPlyMap.clear();
     m_mergeRegisteredMoves.clear();
+    m_book.reset();
+    m_removedBookPositions.clear();
+    m_dirtyPositions.clear();
+    m_bookFileInSync = false;
+    m_bookCacheSfen.clear();
+    m_bookCacheMoves.clear();
+}
+
+void JosekiRepository::markDirty(const QString &normalizedSfen)
+{
+    m_dirtyPositions.insert(normalizedSfen, ++m_editSerial);
+}
+
+bool JosekiRepository::isOpenBookFile(const QString &filePath) const
+{
+    return m_book && QFileInfo(m_book->filePath()) == QFileInfo(filePath);
+}
+
+int JosekiRepository::bookPosition(const QString &normalizedSfen) const
+{
+    if (!m_book || m_removedBookPositions.contains(normalizedSfen)) return -1;
+    return m_book->findPosition(normalizedSfen);
+}
+
+QList<JosekiMove> &JosekiRepository::editableMoves(const QString &normalizedSfen)
+{
+    markDirty(normalizedSfen);
+    auto it = m_josekiData.find(normalizedSfen);
+    if (it != m_josekiData.end()) {
+        return it.value();
+    }
+    QList<JosekiMove> moves;
+    const int index = bookPosition(normalizedSfen);
+    if (index >= 0) {
+        moves = m_book->movesAt(index);
+        ensureSfenWithPly(normalizedSfen, m_book->sfenWithPlyAt(index));
+    }
+    return m_josekiData.insert(normalizedSfen, moves).value();
+}
+
+int JosekiRepository::positionCount() const
+{
+    if (!m_book) return static_cast<int>(m_josekiData.size());
+
+    // ブックの局面は上書きしていても1局面として数える
+    int count = m_book->positionCount() - static_cast<int>(m_removedBookPositions.size());
+    for (auto it = m_josekiData.cbegin(); it != m_josekiData.cend(); ++it) {
+        if (bookPosition(it.key()) < 0) ++count;
+    }
+    return count;
 }
 
 bool JosekiRepository::containsPosition(const QString &normalizedSfen) const
 {
-    return m_josekiData.contains(normalizedSfen);
+    return m_josekiData.contains(normalizedSfen) || bookPosition(normalizedSfen) >= 0;
 }
 
 const QList<JosekiMove> &JosekiRepository::movesForPosition(const QString &normalizedSfen) const
@@ -29,20 +102,28 @@ const QList<JosekiMove> &JosekiRepository::movesForPosition(const QString &norma
     if (it != m_josekiData.constEnd()) {
         return it.value();
     }
-    return s_emptyMoves;
+    const int index = bookPosition(normalizedSfen);
+    if (index < 0) {
+        return s_emptyMoves;
+    }
+    if (m_bookCacheSfen != normalizedSfen) {
+        m_bookCacheMoves = m_book->movesAt(index);
+        m_bookCacheSfen = normalizedSfen;
+    }
+    return m_bookCacheMoves;
 }
 
 void JosekiRepository::addMove(const QString &normalizedSfen, const JosekiMove &move)
 {
-    m_josekiData[normalizedSfen].append(move);
+    editableMoves(normalizedSfen).append(move);
 }
 
 void JosekiRepository::updateMove(const QString &normalizedSfen, const QString &usiMove,
                                    int value, int depth, int frequency, const QString &comment)
 {
-    if (!m_josekiData.contains(normalizedSfen)) return;
+    if (!containsPosition(normalizedSfen)) return;
 
-    QList<JosekiMove> &moves = m_josekiData[normalizedSfen];
+    QList<JosekiMove> &moves = editableMoves(normalizedSfen);
     for (int i = 0; i < moves.size(); ++i) {
         if (moves[i].move == usiMove) {
             moves[i].value = value;
@@ -56,15 +137,18 @@ void JosekiRepository::updateMove(const QString &normalizedSfen, const QString &
 
 void JosekiRepository::deleteMove(const QString &normalizedSfen, int index)
 {
-    if (!m_josekiData.contains(normalizedSfen)) return;
+    if (!containsPosition(normalizedSfen)) return;
 
-    QList<JosekiMove> &moves = m_josekiData[normalizedSfen];
+    QList<JosekiMove> &moves = editableMoves(normalizedSfen);
     if (index < 0 || index >= moves.size()) return;
 
     moves.removeAt(index);
 
-    // この局面の定跡手がなくなった場合はエントリも削除
+    // この局面の定跡手がなくなった場合はエントリも削除（ブックの局面は削除済みとして覚える）
     if (moves.isEmpty()) {
+        if (bookPosition(normalizedSfen) >= 0) {
+            m_removedBookPositions.insert(normalizedSfen);
+        }
         m_josekiData.remove(normalizedSfen);
         m_sfenWithPlyMap.remove(normalizedSfen);
     }
@@ -72,9 +156,9 @@ void JosekiRepository::deleteMove(const QString &normalizedSfen, int index)
 
 void JosekiRepository::removeMoveByUsi(const QString &normalizedSfen, const QString &usiMove)
 {
-    if (!m_josekiData.contains(normalizedSfen)) return;
+    if (!containsPosition(normalizedSfen)) return;
 
-    QList<JosekiMove> &moves = m_josekiData[normalizedSfen];
+    QList<JosekiMove> &moves = editableMoves(normalizedSfen);
     for (int i = 0; i < moves.size(); ++i) {
         if (moves[i].move == usiMove) {
             moves.removeAt(i);
@@ -91,8 +175,8 @@ void JosekiRepository::registerMergeMove(const QString &normalizedSfen, const QS
     m_mergeRegisteredMoves.insert(key);
 
     // 既存の定跡手があるか確認
-    if (m_josekiData.contains(normalizedSfen)) {
-        QList<JosekiMove> &moves = m_josekiData[normalizedSfen];
+    if (containsPosition(normalizedSfen)) {
+        QList<JosekiMove> &moves = editableMoves(normalizedSfen);
 
         // 同じ指し手が既にあるか確認
         for (int i = 0; i < moves.size(); ++i) {
@@ -125,6 +209,7 @@ void JosekiRepository::registerMergeMove(const QString &normalizedSfen, const QS
         QList<JosekiMove> moves;
         moves.append(newMove);
         m_josekiData[normalizedSfen] = moves;
+        markDirty(normalizedSfen);
 
         // 手数付きSFENも保存
         ensureSfenWithPly(normalizedSfen, sfenWithPly);
@@ -133,6 +218,45 @@ void JosekiRepository::registerMergeMove(const QString &normalizedSfen, const QS
     }
 }
 
+int JosekiRepository::mergeCorpusTally(const JosekiCorpusTally &tally)
+{
+    int merged = 0;
+    for (auto it = tally.cbegin(); it != tally.cend(); ++it) {
+        const QHash<QString, int> &counts = it.value().moveCounts;
+        if (counts.isEmpty()) continue;
+
+        QList<JosekiMove> &moves = editableMoves(it.key());
+        ensureSfenWithPly(it.key(), it.value().sfenWithPly);
+
+        // 既存の指し手は頻度を足し、残りは出現数の多い順に追加する
+        QList<QPair<QString, int>> added;
+        for (auto c = counts.cbegin(); c != counts.cend(); ++c) {
+            auto existing = std::find_if(moves.begin(), moves.end(),
+                                         [&](const JosekiMove &move) { return move.move == c.key(); });
+            if (existing != moves.end()) {
+                existing->frequency += c.value();
+            } else {
+                added.append({c.key(), c.value()});
+            }
+        }
+        std::sort(added.begin(), added.end(), [](const QPair<QString, int> &a, const QPair<QString, int> &b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        });
+        for (const auto &[usiMove, count] : std::as_const(added)) {
+            JosekiMove newMove;
+            newMove.move = usiMove;
+            newMove.nextMove = QStringLiteral("none");
+            newMove.value = 0;
+            newMove.depth = 0;
+            newMove.frequency = count;
+            moves.append(newMove);
+        }
+        ++merged;
+    }
+    qCDebug(lcUi) << "Merged corpus tally into" << merged << "positions";
+    return merged;
+}
+
 void JosekiRepository::ensureSfenWithPly(const QString &normalizedSfen, const QString &sfenWithPly)
 {
     if (!m_sfenWithPlyMap.contains(normalizedSfen)) {
@@ -142,233 +266,142 @@ void JosekiRepository::ensureSfenWithPly(const QString &normalizedSfen, const QS
 
 QString JosekiRepository::sfenWithPly(const QString &normalizedSfen) const
 {
-    return m_sfenWithPlyMap.value(normalizedSfen);
+    auto it = m_sfenWithPlyMap.constFind(normalizedSfen);
+    if (it != m_sfenWithPlyMap.constEnd()) {
+        return it.value();
+    }
+    const int index = m_josekiData.contains(normalizedSfen) ? -1 : bookPosition(normalizedSfen);
+    return index >= 0 ? m_book->sfenWithPlyAt(index) : QString();
+}
+
+JosekiSaveResult JosekiRepository::serializeToFile(
+    const QString &filePath,
+    const QMap<QString, QList<JosekiMove>> &josekiData,
+    const QMap<QString, QString> &sfenWithPlyMap)
+{
+    JosekiSnapshot snapshot;
+    snapshot.josekiData = josekiData;
+    snapshot.sfenWithPlyMap = sfenWithPlyMap;
+    return serializeSnapshotToFile(filePath, snapshot);
 }
 
-JosekiLoadResult JosekiRepository::parseFromFile(const QString &filePath)
+JosekiSaveResult JosekiRepository::serializeSnapshotToFile(const QString &filePath, const JosekiSnapshot &snapshot)
 {
-    JosekiLoadResult result;
+    JosekiSaveResult result;
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        result.errorMessage = QStringLiteral("ファイルを開けませんでした: %1").arg(filePath);
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        result.errorMessage = QStringLiteral("ファイルを保存できませんでした: %1").arg(filePath);
         return result;
     }
 
-    QTextStream in(&file);
-    QString line;
-    QString currentSfen;
-    QString normalizedSfen;
-
-    bool hasValidHeader = false;
-    bool hasSfenLine = false;
-    bool hasMoveLine = false;
-    int lineNumber = 0;
-    int invalidMoveLineCount = 0;
-
-    while (!in.atEnd()) {
-        line = in.readLine().trimmed();
-        lineNumber++;
-
-        line.remove(QLatin1Char('\r'));
-
-        if (line.isEmpty()) {
-            continue;
-        }
-
-        if (line.startsWith(QLatin1Char('#'))) {
-            if (line.contains(QStringLiteral("YANEURAOU")) ||
-                line.contains(QStringLiteral("yaneuraou"))) {
-                hasValidHeader = true;
-                continue;
-            }
-
-            if (!normalizedSfen.isEmpty() && result.josekiData.contains(normalizedSfen)) {
-                QList<JosekiMove> &moves = result.josekiData[normalizedSfen];
-                if (!moves.isEmpty()) {
-                    QString commentText = line.mid(1);
-                    if (!moves.last().comment.isEmpty()) {
-                        moves.last().comment += QStringLiteral(" ") + commentText;
-                    } else {
-                        moves.last().comment = commentText;
-                    }
-                }
-            }
-            continue;
+    // 局面ごとに UTF-8 で組み立て、たまった分だけ書き出す（全体をメモリに持たない）
+    QByteArray buffer;
+    buffer.reserve(kWriteBufferSize + 4096);
+    buffer += "#YANEURAOU-DB2016 1.00\n";
+
+    bool ok = true;
+    int savedCount = 0;
+    JosekiBook::forEachPosition(snapshot, [&](const QString &normalizedSfen, const QString &sfenWithPly,
+                                              const QList<JosekiMove> &moves) {
+        const QString &sfenToWrite = sfenWithPly.isEmpty() ? normalizedSfen : sfenWithPly;
+        buffer += "sfen ";
+        buffer += sfenToWrite.toUtf8();
+        if (fieldCount(sfenToWrite) == 3) {
+            buffer += " 1";
         }
+        buffer += '\n';
+
+        for (const JosekiMove &move : moves) {
+            buffer += move.move.toUtf8();
+            buffer += ' ';
+            buffer += move.nextMove.toUtf8();
+            buffer += ' ';
+            buffer += QByteArray::number(move.value);
+            buffer += ' ';
+            buffer += QByteArray::number(move.depth);
+            buffer += ' ';
+            buffer += QByteArray::number(move.frequency);
+            buffer += '\n';
 
-        if (line.startsWith(QStringLiteral("sfen "))) {
-            currentSfen = line.mid(5).trimmed();
-            currentSfen.remove(QLatin1Char('\r'));
-            const QStringList sfenParts = currentSfen.split(QLatin1Char(' '), Qt::SkipEmptyParts);
-            if (sfenParts.size() >= 3) {
-                normalizedSfen = sfenParts[0] + QLatin1Char(' ') + sfenParts[1] + QLatin1Char(' ') + sfenParts[2];
-            } else {
-                normalizedSfen = currentSfen;
-            }
-            if (!result.sfenWithPlyMap.contains(normalizedSfen)) {
-                result.sfenWithPlyMap[normalizedSfen] = currentSfen;
+            if (!move.comment.isEmpty()) {
+                buffer += '#';
+                buffer += move.comment.toUtf8();
+                buffer += '\n';
             }
-            hasSfenLine = true;
-            continue;
         }
+        ++savedCount;
 
-        if (!normalizedSfen.isEmpty()) {
-            const QStringList parts = line.split(QLatin1Char(' '), Qt::SkipEmptyParts);
-            if (parts.size() >= 5) {
-                const QString &moveStr = parts[0];
-                bool validMove = false;
-
-                if (moveStr.size() >= 4 && moveStr.at(1) == QLatin1Char('*')) {
-                    QChar piece = moveStr.at(0).toUpper();
-                    if (QString("PLNSGBR").contains(piece)) {
-                        validMove = true;
-                    }
-                }
-                else if (moveStr.size() >= 4) {
-                    bool validFormat = true;
-                    if (moveStr.at(0) < QLatin1Char('1') || moveStr.at(0) > QLatin1Char('9')) validFormat = false;
-                    if (moveStr.at(1) < QLatin1Char('a') || moveStr.at(1) > QLatin1Char('i')) validFormat = false;
-                    if (moveStr.at(2) < QLatin1Char('1') || moveStr.at(2) > QLatin1Char('9')) validFormat = false;
-                    if (moveStr.at(3) < QLatin1Char('a') || moveStr.at(3) > QLatin1Char('i')) validFormat = false;
-                    validMove = validFormat;
-                }
-
-                if (!validMove) {
-                    invalidMoveLineCount++;
-                    qCWarning(lcUi) << "Invalid move format at line" << lineNumber << ":" << moveStr;
-                }
-
-                JosekiMove move;
-                move.move = parts[0];
-                move.nextMove = parts[1];
-                move.value = parts[2].toInt();
-                move.depth = parts[3].toInt();
-                move.frequency = parts[4].toInt();
-
-                if (parts.size() > 5) {
-                    QStringList commentParts;
-                    for (int i = 5; i < parts.size(); ++i) {
-                        commentParts.append(parts[i]);
-                    }
-                    move.comment = commentParts.join(QLatin1Char(' '));
-                }
-
-                result.josekiData[normalizedSfen].append(move);
-                hasMoveLine = true;
-            } else if (!parts.empty()) {
-                invalidMoveLineCount++;
-                qCWarning(lcUi) << "Invalid line format at line" << lineNumber
-                                << ": expected 5+ fields, got" << parts.size();
-            }
+        if (buffer.size() >= kWriteBufferSize) {
+            ok = file.write(buffer) == buffer.size();
+            buffer.resize(0);
         }
-    }
-
-    file.close();
-
-    if (!hasValidHeader) {
-        result.errorMessage = QStringLiteral(
-            "このファイルはやねうら王定跡フォーマット(YANEURAOU-DB2016)ではありません。\n"
-            "ヘッダー行（#YANEURAOU-DB2016 等）が見つかりませんでした。\n\n"
-            "ファイル: %1").arg(filePath);
-        return result;
-    }
-
-    if (!hasSfenLine) {
-        result.errorMessage = QStringLiteral(
-            "定跡ファイルにSFEN行が見つかりませんでした。\n\n"
-            "やねうら王定跡フォーマットでは「sfen 」で始まる局面行が必要です。\n\n"
-            "ファイル: %1").arg(filePath);
-        return result;
-    }
+        return ok;
+    });
 
-    if (!hasMoveLine) {
-        result.errorMessage = QStringLiteral(
-            "定跡ファイルに有効な指し手行が見つかりませんでした。\n\n"
-            "やねうら王定跡フォーマットでは指し手行に少なくとも5つのフィールド\n"
-            "（指し手 予想応手 評価値 深さ 出現頻度）が必要です。\n\n"
-            "ファイル: %1").arg(filePath);
+    ok = ok && file.write(buffer) == buffer.size();
+    if (!ok || !file.commit()) {
+        result.errorMessage = QStringLiteral("ファイル書き込み中にエラーが発生しました: %1").arg(filePath);
         return result;
     }
 
     result.success = true;
-    result.positionCount = static_cast<int>(result.josekiData.size());
+    result.savedCount = savedCount;
+    return result;
+}
 
-    qCInfo(lcUi) << "Parsed" << result.positionCount << "positions from" << filePath;
-    if (invalidMoveLineCount > 0) {
-        qCWarning(lcUi) << invalidMoveLineCount << "lines had invalid format";
+JosekiSaveResult JosekiRepository::saveSnapshot(const QString &filePath, const JosekiSnapshot &snapshot)
+{
+    // 開いているブック自身への保存も、マップ中のファイルを切り詰めないようバイナリ（一時ファイル経由）で書く
+    const bool ontoOpenBook = snapshot.book && QFileInfo(snapshot.book->filePath()) == QFileInfo(filePath);
+    if (ontoOpenBook && snapshot.bookFileInSync) {
+        return JosekiBook::saveIncremental(filePath, snapshot);
     }
-
-    QString hirate = QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL b -");
-    if (result.josekiData.contains(hirate)) {
-        qCDebug(lcUi) << "Hirate position has" << result.josekiData[hirate].size() << "moves";
+    if (JosekiBook::hasBookSuffix(filePath) || ontoOpenBook) {
+        return JosekiBook::writeToFile(filePath, snapshot);
     }
-
-    return result;
+    return serializeSnapshotToFile(filePath, snapshot);
 }
 
-JosekiSaveResult JosekiRepository::serializeToFile(
-    const QString &filePath,
-    const QMap<QString, QList<JosekiMove>> &josekiData,
-    const QMap<QString, QString> &sfenWithPlyMap)
+JosekiSnapshot JosekiRepository::snapshot() const
 {
-    JosekiSaveResult result;
-
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        result.errorMessage = QStringLiteral("ファイルを保存できませんでした: %1").arg(filePath);
-        return result;
+    JosekiSnapshot snapshot;
+    snapshot.josekiData = m_josekiData;
+    snapshot.sfenWithPlyMap = m_sfenWithPlyMap;
+    snapshot.book = m_book;
+    snapshot.removedBookPositions = m_removedBookPositions;
+    snapshot.dirtyPositions.reserve(m_dirtyPositions.size());
+    for (auto it = m_dirtyPositions.cbegin(); it != m_dirtyPositions.cend(); ++it) {
+        snapshot.dirtyPositions.insert(it.key());
     }
+    snapshot.editSerial = m_editSerial;
+    snapshot.bookFileInSync = m_bookFileInSync;
+    return snapshot;
+}
 
-    QTextStream out(&file);
-
-    out << QStringLiteral("#YANEURAOU-DB2016 1.00\n");
-
-    QMapIterator<QString, QList<JosekiMove>> it(josekiData);
-    while (it.hasNext()) {
-        it.next();
-        const QString &normalizedSfen = it.key();
-        const QList<JosekiMove> &moves = it.value();
-
-        QString sfenToWrite;
-        if (sfenWithPlyMap.contains(normalizedSfen)) {
-            sfenToWrite = sfenWithPlyMap[normalizedSfen];
-        } else {
-            sfenToWrite = normalizedSfen;
-        }
-
-        const QStringList parts = sfenToWrite.split(QLatin1Char(' '), Qt::SkipEmptyParts);
-        if (parts.size() == 3) {
-            sfenToWrite += QStringLiteral(" 1");
-        }
-
-        out << QStringLiteral("sfen ") << sfenToWrite << QStringLiteral("\n");
-
-        for (const JosekiMove &move : std::as_const(moves)) {
-            out << move.move << QStringLiteral(" ")
-                << move.nextMove << QStringLiteral(" ")
-                << move.value << QStringLiteral(" ")
-                << move.depth << QStringLiteral(" ")
-                << move.frequency
-                << QStringLiteral("\n");
-
-            if (!move.comment.isEmpty()) {
-                out << QStringLiteral("#") << move.comment << QStringLiteral("\n");
-            }
-        }
-    }
+void JosekiRepository::markSaved(const QString &filePath, quint64 editSerial)
+{
+    m_dirtyPositions.removeIf([editSerial](const QHash<QString, quint64>::iterator &it) {
+        return it.value() <= editSerial;
+    });
+    // 別のファイルに保存したあとは、ブックのファイルとの差分がわからなくなる
+    m_bookFileInSync = isOpenBookFile(filePath);
+}
 
-    out.flush();
-    if (out.status() != QTextStream::Ok) {
-        result.errorMessage = QStringLiteral("ファイル書き込み中にエラーが発生しました: %1").arg(filePath);
-        file.close();
-        return result;
+bool JosekiRepository::installStagedBook(const QString &bookPath, QString *errorMessage)
+{
+    // 局面番号が変わるので引いた指し手のキャッシュも捨てる。編集分は josekiData に残っている
+    m_book.reset();
+    m_bookCacheSfen.clear();
+    m_bookCacheMoves.clear();
+
+    const bool replaced = JosekiBook::replaceWithStaged(bookPath, errorMessage);
+    auto book = std::make_shared<JosekiBook>();
+    // 置き換えに失敗しても、元のブックか書き出したブックのどちらかを開いて内容を失わないようにする
+    if (book->open(bookPath) || book->open(JosekiBook::stagedPath(bookPath))) {
+        m_book = std::move(book);
     }
-
-    file.close();
-    result.success = true;
-    result.savedCount = static_cast<int>(josekiData.size());
-    return result;
+    return replaced && m_book;
 }
 
 void JosekiRepository::applyLoadResult(JosekiLoadResult &&result)
@@ -376,6 +409,12 @@ void JosekiRepository::applyLoadResult(JosekiLoadResult &&result)
     m_josekiData = std::move(result.josekiData);
     m_sfenWithPlyMap = std::move(result.sfenWithPlyMap);
     m_mergeRegisteredMoves.clear();
+    m_book = std::move(result.book);
+    m_removedBookPositions = std::move(result.removedBookPositions);
+    m_dirtyPositions.clear();
+    m_bookFileInSync = m_book != nullptr;
+    m_bookCacheSfen.clear();
+    m_bookCacheMoves.clear();
 }
 
 bool JosekiRepository::loadFromFile(const QString &filePath, QString *errorMessage)
@@ -391,14 +430,21 @@ bool JosekiRepository::loadFromFile(const QString &filePath, QString *errorMessa
     return true;
 }
 
-bool JosekiRepository::saveToFile(const QString &filePath, QString *errorMessage) const
+bool JosekiRepository::saveToFile(const QString &filePath, QString *errorMessage)
 {
-    JosekiSaveResult result = serializeToFile(filePath, m_josekiData, m_sfenWithPlyMap);
+    JosekiSnapshot current = snapshot();
+    const quint64 editSerial = current.editSerial;
+    JosekiSaveResult result = saveSnapshot(filePath, current);
+    current = JosekiSnapshot();  // ブックの差し替え前にマップへの参照を手放す
     if (!result.success) {
         if (errorMessage) {
             *errorMessage = result.errorMessage;
         }
         return false;
     }
+    if (!result.stagedBookPath.isEmpty() && !installStagedBook(filePath, errorMessage)) {
+        return false;
+    }
+    markSaved(filePath, editSerial);
     return true;
 }
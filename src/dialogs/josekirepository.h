@@ -4,20 +4,31 @@
 #ifndef JOSEKIREPOSITORY_H
 #define JOSEKIREPOSITORY_H
 
+#include <QHash>
 #include <QMap>
 #include <QList>
 #include <QString>
 #include <QSet>
 
+#include <functional>
+#include <memory>
+
 #include "josekiioresult.h"
 
 struct JosekiMove;
+class JosekiBook;
 
 /**
  * @brief 定跡ファイルの読み書きとデータ保持を担当するリポジトリ
  *
  * YANEURAOU-DB2016 形式の定跡ファイルを読み込み・保存する。
  * 定跡データのインメモリ管理も行う。
+ *
+ * バイナリ定跡（JosekiBook）を開いた場合は全体を読み込まず、局面ごとにブックを引く。
+ * 編集した局面だけをブックから josekiData に写して上書きし、保存時に合わせて書き出す。
+ *
+ * 最後の保存から変更した局面を編集番号つきで覚えておき、開いているブック自身への保存は
+ * その局面だけをジャーナルに追記する。保存中に編集した局面は保存後も未保存のまま残る。
  */
 class JosekiRepository
 {
@@ -27,7 +38,7 @@ public:
     // --- ファイルI/O ---
 
     /**
-     * @brief 定跡ファイルを読み込む
+     * @brief 定跡ファイルを読み込む（バイナリ定跡ならマップするだけ）
      * @param filePath ファイルパス
      * @param errorMessage エラーメッセージ（エラー時に設定される）
      * @return 読み込み成功時 true
@@ -35,21 +46,34 @@ public:
     [[nodiscard]] bool loadFromFile(const QString &filePath, QString *errorMessage = nullptr);
 
     /**
-     * @brief 定跡データをファイルに保存する
+     * @brief 定跡データをファイルに保存し、保存済みとして記録する（拡張子 .jbk ならバイナリ定跡）
      * @param filePath 保存先ファイルパス
      * @param errorMessage エラーメッセージ（エラー時に設定される）
      * @return 保存成功時 true
      */
-    [[nodiscard]] bool saveToFile(const QString &filePath, QString *errorMessage = nullptr) const;
+    [[nodiscard]] bool saveToFile(const QString &filePath, QString *errorMessage = nullptr);
 
     // --- スレッドセーフなファイルI/O（static） ---
 
+    /**
+     * @brief 読み込みの進捗（0〜100）を受け取る関数。false を返すと読み込みを中断する
+     *
+     * 解析中はスレッドプールの各スレッドから同時に呼ばれることがある。
+     */
+    using ProgressCallback = std::function<bool(int percent)>;
+
     /**
      * @brief ファイルをパースして結果を返す（UIアクセスなし、ワーカースレッドから呼べる）
+     *
+     * テキストはメモリマップし、sfen 行の先頭で区切ったチャンクをスレッドプールで並列に
+     * 解析してから1つのマップに併合する。バイナリ定跡は解析せずにマップし、result.book に入れて返す。
+     * 中断した場合は success も errorMessage も設定しない。
      * @param filePath ファイルパス
+     * @param progress 進捗の通知先（省略可）
      * @return パース結果
      */
-    [[nodiscard]] static JosekiLoadResult parseFromFile(const QString &filePath);
+    [[nodiscard]] static JosekiLoadResult parseFromFile(const QString &filePath,
+                                                        const ProgressCallback &progress = {});
 
     /**
      * @brief データをファイルに書き出す（UIアクセスなし、ワーカースレッドから呼べる）
@@ -63,6 +87,51 @@ public:
         const QMap<QString, QList<JosekiMove>> &josekiData,
         const QMap<QString, QString> &sfenWithPlyMap);
 
+    /**
+     * @brief スナップショットを YANEURAOU-DB2016 テキストとして書き出す（ワーカースレッドから呼べる）
+     *
+     * 一時ファイルに UTF-8 のまま少しずつ書き、最後に置き換える。
+     * @param filePath 保存先ファイルパス
+     * @param snapshot 保存するデータ
+     * @return 保存結果
+     */
+    [[nodiscard]] static JosekiSaveResult serializeSnapshotToFile(const QString &filePath,
+                                                                  const JosekiSnapshot &snapshot);
+
+    /**
+     * @brief スナップショットを拡張子に応じた形式で書き出す（ワーカースレッドから呼べる）
+     *
+     * 開いているブック自身への保存で snapshot.bookFileInSync なら、変更局面のジャーナル追記で済ませる。
+     * @param filePath 保存先ファイルパス（.jbk ならバイナリ定跡、それ以外はテキスト）
+     * @param snapshot 保存するデータ
+     * @return 保存結果
+     */
+    [[nodiscard]] static JosekiSaveResult saveSnapshot(const QString &filePath, const JosekiSnapshot &snapshot);
+
+    /** @brief 保存用のスナップショット（データは暗黙共有なのでコピーは軽い） */
+    JosekiSnapshot snapshot() const;
+
+    /**
+     * @brief 保存の完了を記録する（メインスレッドで呼ぶ）
+     * @param filePath 保存したファイルパス
+     * @param editSerial 保存したスナップショットの editSerial（これより後の編集は未保存のまま）
+     */
+    void markSaved(const QString &filePath, quint64 editSerial);
+
+    /**
+     * @brief 開いているブック自身を書き直した保存の仕上げ（メインスレッドで markSaved の前に呼ぶ）
+     *
+     * ブックを閉じて JosekiSaveResult::stagedBookPath のファイルに差し替え、開き直す。
+     * 保存に渡したスナップショットは先に破棄しておくこと（ブックのマップが残ると置き換えられない）。
+     * @param bookPath 保存したブックのパス
+     * @param errorMessage エラーメッセージ（エラー時に設定される）
+     * @return 差し替えて開き直せた場合 true
+     */
+    [[nodiscard]] bool installStagedBook(const QString &bookPath, QString *errorMessage = nullptr);
+
+    /** @brief 最後の保存から変更した局面があるかどうか */
+    bool hasUnsavedChanges() const { return !m_dirtyPositions.isEmpty(); }
+
     /**
      * @brief パース結果をリポジトリに適用する（メインスレッドで呼ぶ）
      * @param result パース結果
@@ -71,13 +140,11 @@ public:
 
     // --- データアクセス ---
 
-    /** @brief 定跡データ全体への参照 */
+    /** @brief 定跡データへの参照（バイナリ定跡を開いていれば編集した局面だけ。変更は各メソッドで行う） */
     const QMap<QString, QList<JosekiMove>> &josekiData() const { return m_josekiData; }
-    QMap<QString, QList<JosekiMove>> &josekiData() { return m_josekiData; }
 
     /** @brief 元のSFEN（手数付き）マップへの参照 */
     const QMap<QString, QString> &sfenWithPlyMap() const { return m_sfenWithPlyMap; }
-    QMap<QString, QString> &sfenWithPlyMap() { return m_sfenWithPlyMap; }
 
     /** @brief マージ登録済み指し手セットへの参照 */
     const QSet<QString> &mergeRegisteredMoves() const { return m_mergeRegisteredMoves; }
@@ -86,11 +153,14 @@ public:
     /** @brief 全データをクリアする */
     void clear();
 
+    /** @brief バイナリ定跡を開いているかどうか */
+    bool hasBook() const { return m_book != nullptr; }
+
     /** @brief 定跡データが空かどうか */
-    bool isEmpty() const { return m_josekiData.isEmpty(); }
+    bool isEmpty() const { return positionCount() == 0; }
 
-    /** @brief 局面数を返す */
-    int positionCount() const { return static_cast<int>(m_josekiData.size()); }
+    /** @brief 局面数を返す（バイナリ定跡の局面を含む） */
+    int positionCount() const;
 
     /** @brief 指定局面の定跡手を検索する */
     bool containsPosition(const QString &normalizedSfen) const;
@@ -120,6 +190,13 @@ public:
     void registerMergeMove(const QString &normalizedSfen, const QString &sfenWithPly,
                            const QString &usiMove);
 
+    /**
+     * @brief 棋譜集計をまとめて取り込む（既存の指し手は頻度を足し、ない指し手は追加する）
+     * @param tally JosekiCorpusBuilder の集計結果
+     * @return 取り込んだ局面数
+     */
+    int mergeCorpusTally(const JosekiCorpusTally &tally);
+
     /**
      * @brief 手数付きSFENを登録する（未登録時のみ）
      * @param normalizedSfen 正規化SFEN
@@ -135,6 +212,18 @@ public:
     QString sfenWithPly(const QString &normalizedSfen) const;
 
 private:
+    /// バイナリ定跡上の局面番号（削除済み・未収録なら -1）
+    int bookPosition(const QString &normalizedSfen) const;
+
+    /// 編集用の指し手リスト（バイナリ定跡の局面なら josekiData に写してから返す）。局面を変更済みにする
+    QList<JosekiMove> &editableMoves(const QString &normalizedSfen);
+
+    /// 局面を最後の保存から変更したものとして記録する
+    void markDirty(const QString &normalizedSfen);
+
+    /// 開いているバイナリ定跡と同じファイルかどうか
+    bool isOpenBookFile(const QString &filePath) const;
+
     /// 定跡データ（正規化SFEN → 指し手リスト）
     QMap<QString, QList<JosekiMove>> m_josekiData;
 
@@ -144,6 +233,25 @@ private:
     /// マージダイアログで登録済みの指し手セット（「正規化SFEN:USI指し手」形式）
     QSet<QString> m_mergeRegisteredMoves;
 
+    /// 開いているバイナリ定跡（なければ null）
+    std::shared_ptr<const JosekiBook> m_book;
+
+    /// バイナリ定跡から削除した局面（正規化SFEN）
+    QSet<QString> m_removedBookPositions;
+
+    /// 最後の保存から変更した局面（正規化SFEN → 最後に変更したときの編集番号）
+    QHash<QString, quint64> m_dirtyPositions;
+
+    /// 編集のたびに増える番号
+    quint64 m_editSerial = 0;
+
+    /// バイナリ定跡のファイル（とジャーナル）が m_dirtyPositions 以外は一致しているか
+    bool m_bookFileInSync = false;
+
+    /// 直前にバイナリ定跡から引いた局面（movesForPosition の参照返却用）
+    mutable QString m_bookCacheSfen;
+    mutable QList<JosekiMove> m_bookCacheMoves;
+
     /// 空の定跡手リスト（参照返却のフォールバック用）
     static const QList<JosekiMove> s_emptyMoves;
 };
@@ -0,0 +1,353 @@
+/// @file josekirepository_parse.cpp
+/// @brief YANEURAOU-DB2016 定跡ファイルの並列パーサ（JosekiRepository::parseFromFile）
+
+#include "josekirepository.h"
+#include "josekibook.h"
+#include "josekiwindow.h"  // JosekiMove 構造体
+#include "logcategories.h"
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+namespace {
+
+/// チャンクの最小サイズ（小さいファイルは分割しない）
+constexpr qsizetype kMinChunkBytes = 1 << 20;
+/// スレッドあたりのチャンク数（チャンクごとの重さの偏りをならす）
+constexpr int kChunksPerThread = 4;
+/// 中断を確かめる行間隔
+constexpr qsizetype kCancelCheckLines = 4096;
+/// 行番号つきでログに出す不正行の上限
+constexpr int kMaxLoggedInvalidLines = 20;
+/// 全チャンクの解析が終わった時点の進捗（残りはマージ）
+constexpr int kParsedPercent = 90;
+
+/// sfen 行1つとそれに続く指し手行
+struct ParsedRecord {
+    QString normalizedSfen;
+    QString sfenWithPly;
+    QList<JosekiMove> moves;
+};
+
+struct ChunkResult {
+    /// 正規化SFEN 順（同じ局面は出現順に1つへまとめる）
+    std::vector<ParsedRecord> records;
+    bool hasValidHeader = false;
+    bool hasSfenLine = false;
+    bool hasMoveLine = false;
+    qsizetype lineCount = 0;
+    int invalidLineCount = 0;
+    /// （チャンク内の行番号, 内容）
+    QList<QPair<qsizetype, QString>> invalidLines;
+};
+
+/// ' ' 区切りで空要素を除いて分割する（parts は呼び出し側で使い回す）
+void splitTokens(QByteArrayView line, std::vector<QByteArrayView> &parts)
+{
+    parts.clear();
+    qsizetype pos = 0;
+    while (pos < line.size()) {
+        qsizetype end = line.indexOf(' ', pos);
+        if (end < 0) end = line.size();
+        if (end > pos) parts.push_back(line.sliced(pos, end - pos));
+        pos = end + 1;
+    }
+}
+
+bool isValidMoveToken(QByteArrayView move)
+{
+    if (move.size() < 4) return false;
+    if (move.at(1) == '*') {
+        return QByteArrayView("PLNSGBR").contains(static_cast<char>(QChar::toUpper(uchar(move.at(0)))));
+    }
+    return move.at(0) >= '1' && move.at(0) <= '9' && move.at(1) >= 'a' && move.at(1) <= 'i'
+           && move.at(2) >= '1' && move.at(2) <= '9' && move.at(3) >= 'a' && move.at(3) <= 'i';
+}
+
+void addInvalidLine(ChunkResult &result, QString message)
+{
+    ++result.invalidLineCount;
+    if (result.invalidLines.size() < kMaxLoggedInvalidLines) {
+        result.invalidLines.append({result.lineCount, std::move(message)});
+    }
+}
+
+/// 1チャンクを解析する。チャンクは sfen 行の先頭で区切るので、前のチャンクの状態を引き継がない
+ChunkResult parseChunk(QByteArrayView chunk, const std::atomic_bool &cancelled)
+{
+    ChunkResult result;
+    std::vector<QByteArrayView> parts;
+    ParsedRecord *current = nullptr;
+
+    qsizetype pos = 0;
+    while (pos < chunk.size()) {
+        qsizetype end = chunk.indexOf('\n', pos);
+        if (end < 0) end = chunk.size();
+        const QByteArrayView line = chunk.sliced(pos, end - pos).trimmed();
+        pos = end + 1;
+        ++result.lineCount;
+
+        if (result.lineCount % kCancelCheckLines == 0 && cancelled.load(std::memory_order_relaxed)) {
+            return {};
+        }
+        if (line.isEmpty()) continue;
+
+        if (line.front() == '#') {
+            if (line.contains("YANEURAOU") || line.contains("yaneuraou")) {
+                result.hasValidHeader = true;
+            } else if (current && !current->moves.isEmpty()) {
+                JosekiMove &last = current->moves.last();
+                const QString commentText = QString::fromUtf8(line.sliced(1));
+                last.comment = last.comment.isEmpty() ? commentText : last.comment + QLatin1Char(' ') + commentText;
+            }
+            continue;
+        }
+
+        if (line.startsWith("sfen ")) {
+            const QByteArrayView sfen = line.sliced(5).trimmed();
+            splitTokens(sfen, parts);
+            ParsedRecord record;
+            record.sfenWithPly = QString::fromUtf8(sfen);
+            record.normalizedSfen = parts.size() >= 3
+                ? QString::fromUtf8(parts[0]) + QLatin1Char(' ') + QString::fromUtf8(parts[1])
+                      + QLatin1Char(' ') + QString::fromUtf8(parts[2])
+                : record.sfenWithPly;
+            result.records.push_back(std::move(record));
+            current = &result.records.back();
+            result.hasSfenLine = true;
+            continue;
+        }
+
+        if (!current) continue;
+
+        splitTokens(line, parts);
+        if (parts.size() >= 5) {
+            if (!isValidMoveToken(parts[0])) {
+                addInvalidLine(result, QStringLiteral("invalid move format: ") + QString::fromUtf8(parts[0]));
+            }
+
+            JosekiMove move;
+            move.move = QString::fromUtf8(parts[0]);
+            move.nextMove = QString::fromUtf8(parts[1]);
+            move.value = parts[2].toInt();
+            move.depth = parts[3].toInt();
+            move.frequency = parts[4].toInt();
+            if (parts.size() > 5) {
+                // 6番目以降のトークンは空白1つで連結する（連続した空白がなければ行の残りそのまま）
+                const QByteArrayView rest(parts[5].data(), parts.back().data() + parts.back().size() - parts[5].data());
+                if (!rest.contains("  ")) {
+                    move.comment = QString::fromUtf8(rest);
+                } else {
+                    QByteArray joined = parts[5].toByteArray();
+                    for (std::size_t i = 6; i < parts.size(); ++i) {
+                        joined += ' ';
+                        joined += parts[i];
+                    }
+                    move.comment = QString::fromUtf8(joined);
+                }
+            }
+            current->moves.append(move);
+            result.hasMoveLine = true;
+        } else if (!parts.empty()) {
+            addInvalidLine(result, QStringLiteral("expected 5+ fields, got %1").arg(parts.size()));
+        }
+    }
+
+    // 正規化SFEN 順に並べ、同じ局面の記録は出現順に1つへまとめる
+    std::stable_sort(result.records.begin(), result.records.end(),
+                     [](const ParsedRecord &a, const ParsedRecord &b) { return a.normalizedSfen < b.normalizedSfen; });
+    std::vector<ParsedRecord> merged;
+    merged.reserve(result.records.size());
+    for (ParsedRecord &record : result.records) {
+        if (!merged.empty() && merged.back().normalizedSfen == record.normalizedSfen) {
+            merged.back().moves.append(record.moves);
+        } else {
+            merged.push_back(std::move(record));
+        }
+    }
+    result.records = std::move(merged);
+    return result;
+}
+
+/// sfen 行の先頭でファイルを chunkCount 個程度に分ける
+QList<QByteArrayView> splitIntoChunks(QByteArrayView data, int chunkCount)
+{
+    QList<QByteArrayView> chunks;
+    const qsizetype target = qMax(kMinChunkBytes, data.size() / qMax(1, chunkCount) + 1);
+    qsizetype begin = 0;
+    while (begin < data.size()) {
+        qsizetype cut = data.size();
+        if (begin + target < data.size()) {
+            const qsizetype next = data.indexOf("\nsfen ", begin + target - 1);
+            if (next >= 0) cut = next + 1;
+        }
+        chunks.append(data.sliced(begin, cut - begin));
+        begin = cut;
+    }
+    return chunks;
+}
+
+/// 各チャンクの整列済み記録を正規化SFEN 順に併合して結果のマップを作る（同じ局面はファイル順に連結）
+void mergeChunks(std::vector<ChunkResult> &chunks, JosekiLoadResult &result)
+{
+    struct Head {
+        std::size_t chunk;
+        std::size_t index;
+    };
+    const auto keyOf = [&chunks](const Head &h) -> const QString & {
+        return chunks[h.chunk].records[h.index].normalizedSfen;
+    };
+    const auto later = [&keyOf](const Head &a, const Head &b) {
+        const int cmp = keyOf(a).compare(keyOf(b));
+        return cmp != 0 ? cmp > 0 : a.chunk > b.chunk;
+    };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        if (!chunks[i].records.empty()) heads.push({i, 0});
+    }
+
+    // キーは昇順に出てくるので、末尾を指定した挿入で木をたどらずに済む
+    auto lastData = result.josekiData.end();
+    while (!heads.empty()) {
+        const Head head = heads.top();
+        heads.pop();
+        ParsedRecord &record = chunks[head.chunk].records[head.index];
+        if (head.index + 1 < chunks[head.chunk].records.size()) {
+            heads.push({head.chunk, head.index + 1});
+        }
+
+        const bool seen = !result.sfenWithPlyMap.isEmpty()
+                          && std::prev(result.sfenWithPlyMap.cend()).key() == record.normalizedSfen;
+        if (!seen) {
+            result.sfenWithPlyMap.insert(result.sfenWithPlyMap.cend(), record.normalizedSfen, record.sfenWithPly);
+        }
+        if (record.moves.isEmpty()) continue;
+        if (lastData != result.josekiData.end() && lastData.key() == record.normalizedSfen) {
+            lastData.value().append(record.moves);
+        } else {
+            lastData = result.josekiData.insert(result.josekiData.cend(), record.normalizedSfen, record.moves);
+        }
+        record = ParsedRecord();
+    }
+}
+
+} // namespace
+
+JosekiLoadResult JosekiRepository::parseFromFile(const QString &filePath, const ProgressCallback &progress)
+{
+    JosekiLoadResult result;
+
+    if (JosekiBook::isBookFile(filePath)) {
+        auto book = std::make_shared<JosekiBook>();
+        if (!book->open(filePath, &result.errorMessage)) {
+            return result;
+        }
+        result.positionCount = book->positionCount();
+        JosekiBook::replayJournal(*book, result);
+        result.book = std::move(book);
+        result.success = true;
+        qCInfo(lcUi) << "Mapped" << result.positionCount << "positions from" << filePath;
+        return result;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.errorMessage = QStringLiteral("ファイルを開けませんでした: %1").arg(filePath);
+        return result;
+    }
+
+    // 読み取り専用でマップする（できない場合だけ読み込む）
+    QByteArray fallback;
+    QByteArrayView data;
+    if (const uchar *mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr) {
+        data = QByteArrayView(reinterpret_cast<const char *>(mapped), file.size());
+    } else {
+        fallback = file.readAll();
+        data = fallback;
+    }
+    if (data.startsWith("\xEF\xBB\xBF")) {
+        data = data.sliced(3);  // UTF-8 BOM
+    }
+
+    const int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+    const QList<QByteArrayView> chunkViews = splitIntoChunks(data, threadCount * kChunksPerThread);
+    std::vector<ChunkResult> chunks(static_cast<std::size_t>(chunkViews.size()));
+    QList<int> indices(chunkViews.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::atomic_bool cancelled{false};
+    std::atomic<qint64> parsedBytes{0};
+    const qint64 totalBytes = qMax<qint64>(1, data.size());
+    QtConcurrent::blockingMap(indices, [&](int index) {
+        if (cancelled.load(std::memory_order_relaxed)) return;
+        chunks[static_cast<std::size_t>(index)] = parseChunk(chunkViews.at(index), cancelled);
+        const qint64 done = parsedBytes.fetch_add(chunkViews.at(index).size()) + chunkViews.at(index).size();
+        if (progress && !progress(static_cast<int>(done * kParsedPercent / totalBytes))) {
+            cancelled.store(true);
+        }
+    });
+    if (cancelled.load()) {
+        qCInfo(lcUi) << "Parsing cancelled:" << filePath;
+        return result;
+    }
+
+    bool hasValidHeader = false;
+    bool hasSfenLine = false;
+    bool hasMoveLine = false;
+    int invalidLineCount = 0;
+    qsizetype lineOffset = 0;
+    for (const ChunkResult &chunk : chunks) {
+        hasValidHeader = hasValidHeader || chunk.hasValidHeader;
+        hasSfenLine = hasSfenLine || chunk.hasSfenLine;
+        hasMoveLine = hasMoveLine || chunk.hasMoveLine;
+        invalidLineCount += chunk.invalidLineCount;
+        for (const auto &invalid : chunk.invalidLines) {
+            qCWarning(lcUi).noquote() << "Invalid line" << lineOffset + invalid.first << ":" << invalid.second;
+        }
+        lineOffset += chunk.lineCount;
+    }
+
+    if (!hasValidHeader) {
+        result.errorMessage = QStringLiteral(
+            "このファイルはやねうら王定跡フォーマット(YANEURAOU-DB2016)ではありません。\n"
+            "ヘッダー行（#YANEURAOU-DB2016 等）が見つかりませんでした。\n\n"
+            "ファイル: %1").arg(filePath);
+        return result;
+    }
+
+    if (!hasSfenLine) {
+        result.errorMessage = QStringLiteral(
+            "定跡ファイルにSFEN行が見つかりませんでした。\n\n"
+            "やねうら王定跡フォーマットでは「sfen 」で始まる局面行が必要です。\n\n"
+            "ファイル: %1").arg(filePath);
+        return result;
+    }
+
+    if (!hasMoveLine) {
+        result.errorMessage = QStringLiteral(
+            "定跡ファイルに有効な指し手行が見つかりませんでした。\n\n"
+            "やねうら王定跡フォーマットでは指し手行に少なくとも5つのフィールド\n"
+            "（指し手 予想応手 評価値 深さ 出現頻度）が必要です。\n\n"
+            "ファイル: %1").arg(filePath);
+        return result;
+    }
+
+    mergeChunks(chunks, result);
+    result.success = true;
+    result.positionCount = static_cast<int>(result.josekiData.size());
+    if (progress) progress(100);
+
+    qCInfo(lcUi) << "Parsed" << result.positionCount << "positions from" << filePath
+                 << "in" << chunkViews.size() << "chunks";
+    if (invalidLineCount > 0) {
+        qCWarning(lcUi) << invalidLineCount << "lines had invalid format";
+    }
+    return result;
+}
@@ -39,12 +39,19 @@ JosekiWindow::JosekiWindow(QWidget *parent)
 
     connect(&m_loadWatcher, &QFutureWatcher<JosekiLoadResult>::finished,
             this, &JosekiWindow::onAsyncLoadFinished);
+    connect(&m_loadWatcher, &QFutureWatcher<JosekiLoadResult>::progressValueChanged,
+            this, &JosekiWindow::onAsyncLoadProgress);
     connect(&m_saveWatcher, &QFutureWatcher<JosekiSaveResult>::finished,
             this, &JosekiWindow::onAsyncSaveFinished);
+    connect(&m_corpusWatcher, &QFutureWatcher<JosekiCorpusBuilder::Result>::finished,
+            this, &JosekiWindow::onCorpusBuildFinished);
+    connect(&m_corpusWatcher, &QFutureWatcher<JosekiCorpusBuilder::Result>::progressValueChanged,
+            this, &JosekiWindow::onCorpusBuildProgress);
 }
 
 JosekiWindow::~JosekiWindow()
 {
+    cancelAsyncLoad();
     if (m_ioBusy) {
         QApplication::restoreOverrideCursor();
         m_ioBusy = false;
@@ -84,6 +91,7 @@ bool JosekiWindow::eventFilter(QObject *obj, QEvent *event)
 void JosekiWindow::closeEvent(QCloseEvent *event)
 {
     if (!confirmDiscardChanges()) { event->ignore(); return; }
+    cancelAsyncLoad();
     saveSettings();
     QWidget::closeEvent(event);
 }
@@ -104,66 +112,6 @@ void JosekiWindow::onFontSizeDecrease()
     if (m_fontHelper.decrease()) applyFontSize();
 }
 
-// ============================================================
-// ファイル操作スロット
-// ============================================================
-
-void JosekiWindow::onOpenButtonClicked()
-{
-    if (isIoBusy()) return;
-    if (!confirmDiscardChanges()) return;
-
-    QString startDir;
-    if (!m_currentFilePath.isEmpty()) startDir = QFileInfo(m_currentFilePath).absolutePath();
-
-    QString filePath = QFileDialog::getOpenFileName(
-        this, tr("定跡ファイルを開く"), startDir,
-        tr("定跡ファイル (*.db);;すべてのファイル (*)"));
-
-    if (!filePath.isEmpty()) {
-        addToRecentFiles(filePath);
-        saveSettings();
-        loadAndApplyFileAsync(filePath);
-    }
-}
-
-void JosekiWindow::onNewButtonClicked()
-{
-    if (!confirmDiscardChanges()) return;
-    m_repository->clear();
-    m_currentFilePath.clear();
-    m_filePathLabel->setText(tr("新規ファイル（未保存）"));
-    m_filePathLabel->setStyleSheet(QStringLiteral("color: blue;"));
-    setModified(false);
-    updateStatusDisplay();
-    updateJosekiDisplay();
-}
-
-void JosekiWindow::onSaveButtonClicked()
-{
-    if (isIoBusy()) return;
-    if (m_currentFilePath.isEmpty()) { onSaveAsButtonClicked(); return; }
-    saveToFileAsync(m_currentFilePath);
-}
-
-void JosekiWindow::onSaveAsButtonClicked()
-{
-    if (isIoBusy()) return;
-
-    QString startDir;
-    if (!m_currentFilePath.isEmpty()) startDir = QFileInfo(m_currentFilePath).absolutePath();
-
-    QString filePath = QFileDialog::getSaveFileName(
-        this, tr("定跡ファイルを保存"), startDir,
-        tr("定跡ファイル (*.db);;すべてのファイル (*)"));
-    if (filePath.isEmpty()) return;
-
-    if (!filePath.endsWith(QStringLiteral(".db"), Qt::CaseInsensitive))
-        filePath += QStringLiteral(".db");
-
-    saveToFileAsync(filePath);
-}
-
 // ============================================================
 // 最近使ったファイル
 // ============================================================
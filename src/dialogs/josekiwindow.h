@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "fontsizehelper.h"
+#include "josekicorpusbuilder.h"
 #include "josekiioresult.h"
 
 // 前方宣言
@@ -97,6 +98,7 @@ private slots:
     void onRecentFileClicked();
     void onMergeFromCurrentKifu();
     void onMergeFromKifuFile();
+    void onBuildFromKifuFolder();
     void onTableDoubleClicked(int row, int column);
     void onTableContextMenu(const QPoint &pos);
     void onContextMenuPlay();
@@ -106,7 +108,10 @@ private slots:
     void onMergeRegisterMove(const QString &sfen, const QString &sfenWithPly, const QString &usiMove);
     void onRestoreStatusDisplay();
     void onAsyncLoadFinished();
+    void onAsyncLoadProgress(int percent);
     void onAsyncSaveFinished();
+    void onCorpusBuildFinished();
+    void onCorpusBuildProgress(int percent);
 
 protected:
     void closeEvent(QCloseEvent *event) override;
@@ -129,6 +134,7 @@ private:
     void updateRecentFilesMenu();
     bool loadAndApplyFile(const QString &filePath);
     void loadAndApplyFileAsync(const QString &filePath);
+    void cancelAsyncLoad();
     bool saveToFile(const QString &filePath);
     void saveToFileAsync(const QString &filePath);
     bool ensureFilePath();
@@ -201,7 +207,10 @@ private:
     /// 非同期I/O
     QFutureWatcher<JosekiLoadResult> m_loadWatcher;
     QFutureWatcher<JosekiSaveResult> m_saveWatcher;
+    QFutureWatcher<JosekiCorpusBuilder::Result> m_corpusWatcher;
     QString       m_pendingSaveFilePath;
+    quint64       m_pendingSaveEditSerial = 0;
+    QString       m_corpusSourcePath;
     bool          m_ioBusy = false;
 
     /// 親ドックウィジェット
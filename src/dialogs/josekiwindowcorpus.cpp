@@ -0,0 +1,93 @@
+/// @file josekiwindowcorpus.cpp
+/// @brief JosekiWindow の棋譜フォルダからの定跡一括作成
+
+#include "josekiwindow.h"
+#include "josekicorpusbuilddialog.h"
+#include "josekirepository.h"
+#include "kifucorpusfiles.h"
+
+#include <QMessageBox>
+#include <QtConcurrent>
+
+void JosekiWindow::onBuildFromKifuFolder()
+{
+    if (isIoBusy()) return;
+
+    JosekiCorpusBuildDialog dialog(this);
+    dialog.setSourcePath(m_corpusSourcePath);
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    m_corpusSourcePath = dialog.sourcePath();
+    const QString source = m_corpusSourcePath;
+    const bool recursive = dialog.recursive();
+    const JosekiCorpusBuilder::Options options = dialog.options();
+
+    setIoBusy(true);
+    if (m_statusLabel) {
+        m_statusLabel->setText(tr("棋譜を集計中..."));
+    }
+
+    // ファイルの列挙も棋譜の読み込みもワーカーで行い、結果の取り込みだけをメインスレッドで行う
+    m_corpusWatcher.setFuture(QtConcurrent::run(
+        [source, recursive, options](QPromise<JosekiCorpusBuilder::Result> &promise) {
+            promise.setProgressRange(0, 100);
+            const QStringList files = KifuCorpusFiles::collectFiles(source, recursive);
+            JosekiCorpusBuilder::Result result = JosekiCorpusBuilder::build(files, options, [&promise](int percent) {
+                promise.setProgressValue(percent);
+                return !promise.isCanceled();
+            });
+            promise.addResult(std::move(result));
+        }));
+}
+
+void JosekiWindow::onCorpusBuildProgress(int percent)
+{
+    if (m_statusLabel && m_ioBusy) {
+        m_statusLabel->setText(tr("棋譜を集計中... %1%").arg(percent));
+    }
+}
+
+void JosekiWindow::onCorpusBuildFinished()
+{
+    JosekiCorpusBuilder::Result result;
+    const bool completed = !m_corpusWatcher.isCanceled() && m_corpusWatcher.future().resultCount() > 0;
+    if (completed) {
+        result = m_corpusWatcher.result();
+    }
+    setIoBusy(false);
+
+    if (!completed || result.cancelled) {
+        updateStatusDisplay();
+        return;
+    }
+
+    const JosekiCorpusBuilder::Stats &stats = result.stats;
+    if (stats.fileCount == 0) {
+        updateStatusDisplay();
+        QMessageBox::information(this, tr("情報"), tr("棋譜ファイルが見つかりませんでした。\n%1").arg(m_corpusSourcePath));
+        return;
+    }
+
+    if (!result.tally.isEmpty()) {
+        m_repository->mergeCorpusTally(result.tally);
+        setModified(true);
+        updateJosekiDisplay();
+    }
+    updateStatusDisplay();
+
+    QMessageBox::information(
+        this, tr("定跡の一括作成"),
+        tr("%1 ファイルを読み込みました。\n\n"
+           "集計した対局: %2 局（条件外 %3 局、読み込み失敗 %4 件）\n"
+           "登録した局面: %5 局面（延べ %6 手）\n\n"
+           "処理時間: %7 秒（%8 局/秒、%9 局面/秒）")
+            .arg(stats.fileCount)
+            .arg(stats.gameCount)
+            .arg(stats.filteredCount)
+            .arg(stats.failedCount)
+            .arg(stats.positionCount)
+            .arg(stats.moveCount)
+            .arg(stats.elapsedMs / 1000.0, 0, 'f', 1)
+            .arg(stats.gamesPerSecond(), 0, 'f', 0)
+            .arg(stats.positionsPerSecond(), 0, 'f', 0));
+}
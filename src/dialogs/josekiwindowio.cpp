@@ -2,6 +2,7 @@
 /// @brief JosekiWindow のファイルI/O・非同期処理メソッド群
 
 #include "josekiwindow.h"
+#include "josekibook.h"
 #include "josekirepository.h"
 
 #include <QFileDialog>
@@ -11,6 +12,66 @@
 #include <QApplication>
 #include <QtConcurrent>
 
+// ============================================================
+// ファイル操作スロット
+// ============================================================
+
+void JosekiWindow::onOpenButtonClicked()
+{
+    if (isIoBusy()) return;
+    if (!confirmDiscardChanges()) return;
+
+    QString startDir;
+    if (!m_currentFilePath.isEmpty()) startDir = QFileInfo(m_currentFilePath).absolutePath();
+
+    QString filePath = QFileDialog::getOpenFileName(
+        this, tr("定跡ファイルを開く"), startDir,
+        tr("定跡ファイル (*.db *.jbk);;すべてのファイル (*)"));
+
+    if (!filePath.isEmpty()) {
+        addToRecentFiles(filePath);
+        saveSettings();
+        loadAndApplyFileAsync(filePath);
+    }
+}
+
+void JosekiWindow::onNewButtonClicked()
+{
+    if (!confirmDiscardChanges()) return;
+    m_repository->clear();
+    m_currentFilePath.clear();
+    m_filePathLabel->setText(tr("新規ファイル（未保存）"));
+    m_filePathLabel->setStyleSheet(QStringLiteral("color: blue;"));
+    setModified(false);
+    updateStatusDisplay();
+    updateJosekiDisplay();
+}
+
+void JosekiWindow::onSaveButtonClicked()
+{
+    if (isIoBusy()) return;
+    if (m_currentFilePath.isEmpty()) { onSaveAsButtonClicked(); return; }
+    saveToFileAsync(m_currentFilePath);
+}
+
+void JosekiWindow::onSaveAsButtonClicked()
+{
+    if (isIoBusy()) return;
+
+    QString startDir;
+    if (!m_currentFilePath.isEmpty()) startDir = QFileInfo(m_currentFilePath).absolutePath();
+
+    QString filePath = QFileDialog::getSaveFileName(
+        this, tr("定跡ファイルを保存"), startDir,
+        tr("定跡ファイル (*.db);;バイナリ定跡ファイル (*.jbk);;すべてのファイル (*)"));
+    if (filePath.isEmpty()) return;
+
+    if (!filePath.endsWith(QStringLiteral(".db"), Qt::CaseInsensitive) && !JosekiBook::hasBookSuffix(filePath))
+        filePath += QStringLiteral(".db");
+
+    saveToFileAsync(filePath);
+}
+
 // ============================================================
 // ファイル操作ヘルパー（同期）
 // ============================================================
@@ -52,10 +113,10 @@ bool JosekiWindow::ensureFilePath()
 
     QString filePath = QFileDialog::getSaveFileName(
         this, tr("定跡ファイルの保存先を指定"), QDir::homePath(),
-        tr("定跡ファイル (*.db);;すべてのファイル (*)"));
+        tr("定跡ファイル (*.db);;バイナリ定跡ファイル (*.jbk);;すべてのファイル (*)"));
     if (filePath.isEmpty()) return false;
 
-    if (!filePath.endsWith(QStringLiteral(".db"), Qt::CaseInsensitive))
+    if (!filePath.endsWith(QStringLiteral(".db"), Qt::CaseInsensitive) && !JosekiBook::hasBookSuffix(filePath))
         filePath += QStringLiteral(".db");
 
     m_currentFilePath = filePath;
@@ -111,12 +172,41 @@ void JosekiWindow::loadAndApplyFileAsync(const QString &filePath)
         m_statusLabel->setText(tr("読み込み中..."));
     }
 
-    m_loadWatcher.setFuture(QtConcurrent::run(&JosekiRepository::parseFromFile, filePath));
+    // 進捗は m_loadWatcher の progressValueChanged、中断は m_loadWatcher.cancel() で伝わる
+    m_loadWatcher.setFuture(QtConcurrent::run([filePath](QPromise<JosekiLoadResult> &promise) {
+        promise.setProgressRange(0, 100);
+        JosekiLoadResult result = JosekiRepository::parseFromFile(filePath, [&promise](int percent) {
+            promise.setProgressValue(percent);
+            return !promise.isCanceled();
+        });
+        promise.addResult(std::move(result));
+    }));
+}
+
+void JosekiWindow::cancelAsyncLoad()
+{
+    if (m_loadWatcher.isRunning()) {
+        m_loadWatcher.cancel();
+    }
+    if (m_corpusWatcher.isRunning()) {
+        m_corpusWatcher.cancel();
+    }
+}
+
+void JosekiWindow::onAsyncLoadProgress(int percent)
+{
+    if (m_statusLabel && m_ioBusy) {
+        m_statusLabel->setText(tr("読み込み中... %1%").arg(percent));
+    }
 }
 
 void JosekiWindow::onAsyncLoadFinished()
 {
-    JosekiLoadResult result = m_loadWatcher.result();
+    // 中断した読み込みは結果を持たないので、エラー表示なしの失敗として扱う
+    JosekiLoadResult result;
+    if (!m_loadWatcher.isCanceled() && m_loadWatcher.future().resultCount() > 0) {
+        result = m_loadWatcher.result();
+    }
     setIoBusy(false);
 
     if (!result.success) {
@@ -148,12 +238,16 @@ void JosekiWindow::saveToFileAsync(const QString &filePath)
         m_statusLabel->setText(tr("保存中..."));
     }
 
-    // スナップショットをコピーしてワーカーに渡す
-    const QMap<QString, QList<JosekiMove>> dataCopy = m_repository->josekiData();
-    const QMap<QString, QString> sfenCopy = m_repository->sfenWithPlyMap();
-
-    m_saveWatcher.setFuture(
-        QtConcurrent::run(&JosekiRepository::serializeToFile, filePath, dataCopy, sfenCopy));
+    // スナップショットをワーカーに渡す（バイナリ定跡は共有するだけで読み込まない）
+    JosekiSnapshot snapshot = m_repository->snapshot();
+    m_pendingSaveEditSerial = snapshot.editSerial;
+    // 完了通知より前にスナップショット（ブックのマップへの参照）を手放す。開いているブック自身を
+    // 書き直した場合は、onAsyncSaveFinished でブックを閉じてから差し替えるため
+    m_saveWatcher.setFuture(QtConcurrent::run([filePath, snapshot = std::move(snapshot)]() mutable {
+        const JosekiSaveResult result = JosekiRepository::saveSnapshot(filePath, snapshot);
+        snapshot = JosekiSnapshot();
+        return result;
+    }));
 }
 
 void JosekiWindow::onAsyncSaveFinished()
@@ -167,7 +261,17 @@ void JosekiWindow::onAsyncSaveFinished()
         return;
     }
 
-    setModified(false);
+    QString installError;
+    if (!result.stagedBookPath.isEmpty() && !m_repository->installStagedBook(m_pendingSaveFilePath, &installError)) {
+        QMessageBox::warning(this, tr("エラー"), installError);
+        updateStatusDisplay();
+        updateJosekiDisplay();
+        return;
+    }
+
+    // 保存中に編集した局面があれば変更ありのまま
+    m_repository->markSaved(m_pendingSaveFilePath, m_pendingSaveEditSerial);
+    setModified(m_repository->hasUnsavedChanges());
 
     // 名前を付けて保存の場合にファイルパスを更新
     if (!m_pendingSaveFilePath.isEmpty() && m_pendingSaveFilePath != m_currentFilePath) {
@@ -71,7 +71,7 @@ void JosekiWindow::setupUi()
     fileGroupLayout->addWidget(m_newButton);
 
     m_openButton = new QPushButton(tr("開く"), this);
-    m_openButton->setToolTip(tr("定跡ファイル(.db)を開く"));
+    m_openButton->setToolTip(tr("定跡ファイル(.db/.jbk)を開く"));
     m_openButton->setIcon(style()->standardIcon(QStyle::SP_DialogOpenButton));
     m_openButton->setStyleSheet(fileBtnStyle);
     fileGroupLayout->addWidget(m_openButton);
@@ -139,6 +139,8 @@ void JosekiWindow::setupUi()
     m_mergeMenu = new QMenu(this);
     m_mergeMenu->addAction(tr("現在の棋譜から"), this, &JosekiWindow::onMergeFromCurrentKifu);
     m_mergeMenu->addAction(tr("棋譜ファイルから"), this, &JosekiWindow::onMergeFromKifuFile);
+    m_mergeMenu->addSeparator();
+    m_mergeMenu->addAction(tr("棋譜フォルダから一括作成..."), this, &JosekiWindow::onBuildFromKifuFolder);
     m_mergeButton->setMenu(m_mergeMenu);
     operationGroupLayout->addWidget(m_mergeButton);
 
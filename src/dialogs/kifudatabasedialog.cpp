@@ -0,0 +1,356 @@
+/// @file kifudatabasedialog.cpp
+/// @brief 棋譜データベースダイアログクラスの実装
+
+#include "kifudatabasedialog.h"
+#include "kifucorpusfiles.h"
+#include "gamesettings.h"
+#include "dialogutils.h"
+
+#include <QCloseEvent>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <QtConcurrent>
+
+namespace {
+constexpr QSize kMinimumSize{560, 400};
+
+/// 一覧に表示する対局数の上限（勝敗の内訳は全件で数える）
+constexpr int kMaxListedGames = 2000;
+
+enum Column { ColDate, ColBlack, ColWhite, ColEvent, ColPly, ColResult, ColumnCount };
+
+QString resultText(KifuDatabase::GameResult result)
+{
+    switch (result) {
+    case KifuDatabase::GameResult::BlackWin: return QObject::tr("先手勝ち");
+    case KifuDatabase::GameResult::WhiteWin: return QObject::tr("後手勝ち");
+    case KifuDatabase::GameResult::Draw: return QObject::tr("引き分け");
+    default: return QObject::tr("不明");
+    }
+}
+
+QString percentText(int count, int total)
+{
+    return total > 0 ? QString::number(count * 100.0 / total, 'f', 1) : QStringLiteral("-");
+}
+} // namespace
+
+KifuDatabaseDialog::KifuDatabaseDialog(QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("棋譜データベース"));
+    setMinimumSize(kMinimumSize);
+    DialogUtils::restoreDialogSize(this, GameSettings::kifuDatabaseDialogSize());
+
+    buildUi();
+
+    connect(&m_buildWatcher, &QFutureWatcher<KifuDatabase::BuildResult>::progressValueChanged,
+            this, &KifuDatabaseDialog::onBuildProgress);
+    connect(&m_buildWatcher, &QFutureWatcher<KifuDatabase::BuildResult>::finished,
+            this, &KifuDatabaseDialog::onBuildFinished);
+
+    // 前回のデータベースを黙って開き直す（なくなっていれば何もしない）
+    const QString lastPath = GameSettings::kifuDatabasePath();
+    if (!lastPath.isEmpty() && QFileInfo::exists(lastPath)) {
+        QString error;
+        if (m_database.open(lastPath, &error)) {
+            m_databaseEdit->setText(QDir::toNativeSeparators(lastPath));
+        }
+    }
+    updateDatabaseLabel();
+    updateButtonStates();
+}
+
+KifuDatabaseDialog::~KifuDatabaseDialog()
+{
+    // 作成中に閉じた場合は中断を待つ（書きかけのファイルは置き換えない）
+    if (m_buildWatcher.isRunning()) {
+        m_buildWatcher.cancel();
+        m_buildWatcher.waitForFinished();
+    }
+}
+
+void KifuDatabaseDialog::buildUi()
+{
+    auto* mainLayout = new QVBoxLayout(this);
+
+    // === データベース ===
+    auto* databaseLayout = new QHBoxLayout();
+    databaseLayout->addWidget(new QLabel(tr("データベース:"), this));
+    m_databaseEdit = new QLineEdit(this);
+    m_databaseEdit->setReadOnly(true);
+    m_databaseEdit->setPlaceholderText(tr("棋譜データベース（*.kdb）を開くか、棋譜フォルダから作成してください"));
+    databaseLayout->addWidget(m_databaseEdit, 1);
+    m_openButton = new QPushButton(tr("開く..."), this);
+    databaseLayout->addWidget(m_openButton);
+    m_buildButton = new QPushButton(tr("棋譜フォルダから作成..."), this);
+    m_buildButton->setToolTip(tr("KIF/KI2/CSA/JKF/USEN/USI 形式の棋譜ファイルを読み込み、\n"
+                                 "本譜に現れた局面の索引を作ります。"));
+    databaseLayout->addWidget(m_buildButton);
+    mainLayout->addLayout(databaseLayout);
+
+    m_databaseInfoLabel = new QLabel(this);
+    mainLayout->addWidget(m_databaseInfoLabel);
+
+    // === 検索 ===
+    auto* searchLayout = new QHBoxLayout();
+    m_searchButton = new QPushButton(tr("現在の局面で検索"), this);
+    searchLayout->addWidget(m_searchButton);
+    m_statsLabel = new QLabel(this);
+    m_statsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    searchLayout->addWidget(m_statsLabel, 1);
+    mainLayout->addLayout(searchLayout);
+
+    m_gameTable = new QTableWidget(0, ColumnCount, this);
+    m_gameTable->setHorizontalHeaderLabels(
+        {tr("日時"), tr("先手"), tr("後手"), tr("棋戦"), tr("手数"), tr("結果")});
+    m_gameTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_gameTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_gameTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_gameTable->verticalHeader()->setVisible(false);
+    m_gameTable->horizontalHeader()->setSectionResizeMode(ColEvent, QHeaderView::Stretch);
+    mainLayout->addWidget(m_gameTable, 1);
+
+    auto* buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+    m_openGameButton = new QPushButton(tr("棋譜を開く"), this);
+    buttonLayout->addWidget(m_openGameButton);
+    auto* closeButton = new QPushButton(tr("閉じる"), this);
+    buttonLayout->addWidget(closeButton);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(m_openButton, &QPushButton::clicked, this, &KifuDatabaseDialog::onOpenDatabaseClicked);
+    connect(m_buildButton, &QPushButton::clicked, this, &KifuDatabaseDialog::onBuildDatabaseClicked);
+    connect(m_searchButton, &QPushButton::clicked, this, &KifuDatabaseDialog::searchCurrentPosition);
+    connect(m_openGameButton, &QPushButton::clicked, this, &KifuDatabaseDialog::onOpenGameClicked);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+    connect(m_gameTable, &QTableWidget::cellDoubleClicked, this, &KifuDatabaseDialog::onGameActivated);
+    connect(m_gameTable, &QTableWidget::itemSelectionChanged, this, &KifuDatabaseDialog::updateButtonStates);
+}
+
+void KifuDatabaseDialog::setCurrentSfenProvider(std::function<QString()> provider)
+{
+    m_currentSfen = std::move(provider);
+    updateButtonStates();
+}
+
+bool KifuDatabaseDialog::openDatabase(const QString& filePath)
+{
+    QString error;
+    if (!m_database.open(filePath, &error)) {
+        QMessageBox::warning(this, tr("エラー"), error);
+        m_databaseEdit->clear();
+        updateDatabaseLabel();
+        updateButtonStates();
+        return false;
+    }
+    m_databaseEdit->setText(QDir::toNativeSeparators(filePath));
+    GameSettings::setKifuDatabasePath(filePath);
+    m_gameTable->setRowCount(0);
+    m_statsLabel->clear();
+    updateDatabaseLabel();
+    updateButtonStates();
+    return true;
+}
+
+void KifuDatabaseDialog::onOpenDatabaseClicked()
+{
+    const QString current = m_database.isOpen() ? QFileInfo(m_database.filePath()).absolutePath() : QDir::homePath();
+    const QString filePath = QFileDialog::getOpenFileName(this, tr("棋譜データベースを開く"), current,
+                                                          tr("棋譜データベース (*.kdb);;すべてのファイル (*)"));
+    if (filePath.isEmpty()) return;
+    if (openDatabase(filePath)) searchCurrentPosition();
+}
+
+void KifuDatabaseDialog::onBuildDatabaseClicked()
+{
+    if (m_buildWatcher.isRunning()) return;
+
+    QString sourceDir = GameSettings::kifuDatabaseSourceDirectory();
+    sourceDir = QFileDialog::getExistingDirectory(this, tr("棋譜フォルダを選択"),
+                                                  sourceDir.isEmpty() ? QDir::homePath() : sourceDir);
+    if (sourceDir.isEmpty()) return;
+    GameSettings::setKifuDatabaseSourceDirectory(sourceDir);
+
+    const QString defaultPath = QDir(sourceDir).filePath(QDir(sourceDir).dirName() + QStringLiteral(".kdb"));
+    const QString outputPath = QFileDialog::getSaveFileName(this, tr("棋譜データベースの保存先"), defaultPath,
+                                                            tr("棋譜データベース (*.kdb)"));
+    if (outputPath.isEmpty()) return;
+
+    // 置き換えるファイルのマップを外しておく（Windows ではマップ中のファイルを置き換えられない）
+    if (m_database.isOpen() && QFileInfo(m_database.filePath()) == QFileInfo(outputPath)) {
+        m_database.close();
+        m_databaseEdit->clear();
+    }
+
+    m_buildOutputPath = outputPath;
+    m_statsLabel->setText(tr("棋譜を読み込み中..."));
+    updateButtonStates();
+
+    // ファイルの列挙もワーカーで行う
+    m_buildWatcher.setFuture(QtConcurrent::run(
+        [sourceDir, outputPath](QPromise<KifuDatabase::BuildResult>& promise) {
+            promise.setProgressRange(0, 100);
+            const QStringList files = KifuCorpusFiles::collectFiles(sourceDir, true);
+            KifuDatabase::BuildResult result = KifuDatabase::build(files, outputPath, [&promise](int percent) {
+                promise.setProgressValue(percent);
+                return !promise.isCanceled();
+            });
+            promise.addResult(std::move(result));
+        }));
+    updateButtonStates();
+}
+
+void KifuDatabaseDialog::onBuildProgress(int percent)
+{
+    if (m_buildWatcher.isRunning()) {
+        m_statsLabel->setText(tr("棋譜を読み込み中... %1%").arg(percent));
+    }
+}
+
+void KifuDatabaseDialog::onBuildFinished()
+{
+    KifuDatabase::BuildResult result;
+    const bool completed = !m_buildWatcher.isCanceled() && m_buildWatcher.future().resultCount() > 0;
+    if (completed) {
+        result = m_buildWatcher.result();
+    }
+    m_statsLabel->clear();
+    updateButtonStates();
+
+    if (!completed || result.cancelled) return;
+    if (!result.success) {
+        QMessageBox::warning(this, tr("エラー"), result.errorMessage);
+        return;
+    }
+    if (result.stats.fileCount == 0) {
+        QMessageBox::information(this, tr("情報"), tr("棋譜ファイルが見つかりませんでした。"));
+    }
+    if (!openDatabase(m_buildOutputPath)) return;
+
+    const KifuDatabase::BuildStats& stats = result.stats;
+    QMessageBox::information(
+        this, tr("棋譜データベースの作成"),
+        tr("%1 ファイルを読み込みました。\n\n"
+           "登録した対局: %2 局（読み込み失敗 %3 件）\n"
+           "登録した局面: 延べ %4 局面\n\n"
+           "処理時間: %5 秒（%6 局/秒）")
+            .arg(stats.fileCount)
+            .arg(stats.gameCount)
+            .arg(stats.failedCount)
+            .arg(stats.postingCount)
+            .arg(stats.elapsedMs / 1000.0, 0, 'f', 1)
+            .arg(stats.gamesPerSecond(), 0, 'f', 0));
+    searchCurrentPosition();
+}
+
+void KifuDatabaseDialog::searchCurrentPosition()
+{
+    if (!m_database.isOpen() || !m_currentSfen) return;
+
+    const QString sfen = m_currentSfen();
+    QElapsedTimer timer;
+    timer.start();
+    const QList<KifuDatabase::Hit> hits = m_database.findGames(sfen, kMaxListedGames);
+    const KifuDatabase::PositionStats stats = m_database.positionStats(sfen);
+    showHits(hits, stats, timer.nsecsElapsed() / 1000);
+}
+
+void KifuDatabaseDialog::showHits(const QList<KifuDatabase::Hit>& hits, const KifuDatabase::PositionStats& stats,
+                                  qint64 elapsedUs)
+{
+    m_gameTable->setSortingEnabled(false);
+    m_gameTable->setRowCount(static_cast<int>(hits.size()));
+    for (int row = 0; row < hits.size(); ++row) {
+        const KifuDatabase::Hit& hit = hits.at(row);
+        const KifuDatabase::GameSummary game = m_database.gameAt(hit.game);
+        const auto setText = [&](int column, const QString& text) {
+            auto* item = new QTableWidgetItem(text);
+            item->setData(Qt::UserRole, game.filePath);
+            item->setToolTip(QDir::toNativeSeparators(game.filePath));
+            m_gameTable->setItem(row, column, item);
+        };
+        setText(ColDate, game.date);
+        setText(ColBlack, game.blackPlayer);
+        setText(ColWhite, game.whitePlayer);
+        setText(ColEvent, game.event.isEmpty() ? QFileInfo(game.filePath).fileName() : game.event);
+        setText(ColPly, tr("%1 / %2").arg(hit.ply).arg(game.plyCount));
+        setText(ColResult, resultText(game.result));
+    }
+    m_gameTable->resizeColumnsToContents();
+    m_gameTable->horizontalHeader()->setSectionResizeMode(ColEvent, QHeaderView::Stretch);
+
+    if (stats.games == 0) {
+        m_statsLabel->setText(tr("この局面を通った対局はありません（%1 ms）").arg(elapsedUs / 1000.0, 0, 'f', 1));
+    } else {
+        const int decided = stats.blackWins + stats.whiteWins;
+        QString text = tr("%1 局: 先手 %2 勝（%3%）・後手 %4 勝（%5%）・引き分け %6・不明 %7（%8 ms）")
+                           .arg(stats.games)
+                           .arg(stats.blackWins)
+                           .arg(percentText(stats.blackWins, decided))
+                           .arg(stats.whiteWins)
+                           .arg(percentText(stats.whiteWins, decided))
+                           .arg(stats.draws)
+                           .arg(stats.unknown)
+                           .arg(elapsedUs / 1000.0, 0, 'f', 1);
+        if (stats.games > hits.size()) {
+            text += tr("　※先頭 %1 局を表示").arg(hits.size());
+        }
+        m_statsLabel->setText(text);
+    }
+    updateButtonStates();
+}
+
+void KifuDatabaseDialog::onGameActivated(int row, int column)
+{
+    Q_UNUSED(column)
+    const QTableWidgetItem* item = m_gameTable->item(row, ColDate);
+    if (!item) return;
+    const QString filePath = item->data(Qt::UserRole).toString();
+    if (!QFileInfo::exists(filePath)) {
+        QMessageBox::warning(this, tr("エラー"),
+                             tr("棋譜ファイルが見つかりません。\n%1").arg(QDir::toNativeSeparators(filePath)));
+        return;
+    }
+    emit gameSelected(filePath);
+}
+
+void KifuDatabaseDialog::onOpenGameClicked()
+{
+    onGameActivated(m_gameTable->currentRow());
+}
+
+void KifuDatabaseDialog::updateButtonStates()
+{
+    const bool building = m_buildWatcher.isRunning();
+    m_openButton->setEnabled(!building);
+    m_buildButton->setEnabled(!building);
+    m_searchButton->setEnabled(!building && m_database.isOpen() && m_currentSfen);
+    m_openGameButton->setEnabled(m_gameTable->currentRow() >= 0 && !m_gameTable->selectedItems().isEmpty());
+}
+
+void KifuDatabaseDialog::updateDatabaseLabel()
+{
+    if (!m_database.isOpen()) {
+        m_databaseInfoLabel->clear();
+        return;
+    }
+    m_databaseInfoLabel->setText(
+        tr("%1 局・延べ %2 局面").arg(m_database.gameCount()).arg(m_database.postingCount()));
+}
+
+void KifuDatabaseDialog::closeEvent(QCloseEvent* event)
+{
+    DialogUtils::saveDialogSize(this, GameSettings::setKifuDatabaseDialogSize);
+    QDialog::closeEvent(event);
+}
@@ -0,0 +1,80 @@
+#ifndef KIFUDATABASEDIALOG_H
+#define KIFUDATABASEDIALOG_H
+
+/// @file kifudatabasedialog.h
+/// @brief 棋譜データベースダイアログクラスの定義
+
+#include <QDialog>
+#include <QFutureWatcher>
+
+#include <functional>
+
+#include "kifudatabase.h"
+
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QTableWidget;
+
+/**
+ * @brief 棋譜データベースダイアログ
+ *
+ * 棋譜フォルダから棋譜データベース（.kdb）を作成・開き、
+ * 現在の局面を通った対局の一覧と勝敗の内訳を表示する。
+ * 一覧の対局をダブルクリックすると、その棋譜ファイルをメインGUIで開く。
+ */
+class KifuDatabaseDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit KifuDatabaseDialog(QWidget* parent = nullptr);
+    ~KifuDatabaseDialog() override;
+
+    /// 検索に使う現在局面のSFENを返す関数を設定する
+    void setCurrentSfenProvider(std::function<QString()> provider);
+
+signals:
+    /// 一覧で選択された対局の棋譜ファイルを発行
+    void gameSelected(const QString& filePath);
+
+public slots:
+    /// 現在の局面を通った対局を検索する
+    void searchCurrentPosition();
+
+private slots:
+    void onOpenDatabaseClicked();
+    void onBuildDatabaseClicked();
+    void onBuildProgress(int percent);
+    void onBuildFinished();
+    void onGameActivated(int row, int column = 0);
+    void onOpenGameClicked();
+
+protected:
+    void closeEvent(QCloseEvent* event) override;
+
+private:
+    void buildUi();
+    /// データベースを開き、表示を更新する（失敗時はメッセージを出す）
+    bool openDatabase(const QString& filePath);
+    void showHits(const QList<KifuDatabase::Hit>& hits, const KifuDatabase::PositionStats& stats,
+                  qint64 elapsedUs);
+    void updateButtonStates();
+    void updateDatabaseLabel();
+
+    KifuDatabase m_database;
+    std::function<QString()> m_currentSfen;
+    QFutureWatcher<KifuDatabase::BuildResult> m_buildWatcher;
+    QString m_buildOutputPath;
+
+    QLineEdit* m_databaseEdit = nullptr;
+    QLabel* m_databaseInfoLabel = nullptr;
+    QPushButton* m_openButton = nullptr;
+    QPushButton* m_buildButton = nullptr;
+    QPushButton* m_searchButton = nullptr;
+    QPushButton* m_openGameButton = nullptr;
+    QLabel* m_statsLabel = nullptr;
+    QTableWidget* m_gameTable = nullptr;
+};
+
+#endif // KIFUDATABASEDIALOG_H
@@ -30,6 +30,7 @@
 #include <QStyledItemDelegate>
 #include <QTableWidget>
 #include <QTextStream>
+#include <QThread>
 #include <QToolButton>
 #include <QVBoxLayout>
 
@@ -142,6 +143,11 @@ void TsumeshogiGeneratorDialog::buildFormSection(QVBoxLayout* mainLayout)
     m_spinMaxPositions->setValue(10);
     m_spinMaxPositions->setSpecialValueText(tr("無制限"));
     formLayout->addRow(tr("生成上限:"), m_spinMaxPositions);
+    m_spinWorkers = new QSpinBox(this);
+    m_spinWorkers->setRange(1, qMax(1, QThread::idealThreadCount()));
+    m_spinWorkers->setValue(1);
+    m_spinWorkers->setToolTip(tr("内蔵ソルバー選択時に、局面生成と詰み判定を並行して行う数"));
+    formLayout->addRow(tr("並列数:"), m_spinWorkers);
     mainLayout->addLayout(formLayout);
 
     // --- 制御ボタン ---
@@ -160,6 +166,9 @@ void TsumeshogiGeneratorDialog::buildFormSection(QVBoxLayout* mainLayout)
     mainLayout->addWidget(m_labelProgress);
     m_labelElapsed = new QLabel(tr("経過時間: 00:00:00"), this);
     mainLayout->addWidget(m_labelElapsed);
+    m_labelWorkers = new QLabel(this);
+    m_labelWorkers->setVisible(false);
+    mainLayout->addWidget(m_labelWorkers);
 }
 
 void TsumeshogiGeneratorDialog::buildResultsSection(QVBoxLayout* mainLayout)
@@ -243,6 +252,13 @@ void TsumeshogiGeneratorDialog::readEngineNameAndDir()
         m_comboEngine->addItem(engine.name);
         m_engineList.append(engine);
     }
+
+    // 末尾に内蔵ソルバを置く。登録済みエンジンの番号はずらさない。
+    Engine builtin;
+    builtin.name = tr("内蔵ソルバー（エンジン不要）");
+    builtin.builtin = true;
+    m_comboEngine->addItem(builtin.name);
+    m_engineList.append(builtin);
 }
 
 void TsumeshogiGeneratorDialog::loadSettings()
@@ -258,6 +274,7 @@ void TsumeshogiGeneratorDialog::loadSettings()
     m_spinAttackRange->setValue(TsumeshogiSettings::tsumeshogiGeneratorAttackRange());
     m_spinTimeout->setValue(TsumeshogiSettings::tsumeshogiGeneratorTimeoutSec());
     m_spinMaxPositions->setValue(TsumeshogiSettings::tsumeshogiGeneratorMaxPositions());
+    m_spinWorkers->setValue(TsumeshogiSettings::tsumeshogiGeneratorWorkerCount());
 }
 
 void TsumeshogiGeneratorDialog::saveSettings()
@@ -271,6 +288,7 @@ void TsumeshogiGeneratorDialog::saveSettings()
     TsumeshogiSettings::setTsumeshogiGeneratorAttackRange(m_spinAttackRange->value());
     TsumeshogiSettings::setTsumeshogiGeneratorTimeoutSec(m_spinTimeout->value());
     TsumeshogiSettings::setTsumeshogiGeneratorMaxPositions(m_spinMaxPositions->value());
+    TsumeshogiSettings::setTsumeshogiGeneratorWorkerCount(m_spinWorkers->value());
 }
 
 void TsumeshogiGeneratorDialog::onStartClicked()
@@ -280,6 +298,12 @@ void TsumeshogiGeneratorDialog::onStartClicked()
         QMessageBox::critical(this, tr("エラー"), tr("将棋エンジンが選択されていません。"));
         return;
     }
+    const Engine& engine = m_engineList.at(engineIndex);
+    if (!engine.builtin && engine.path.isEmpty()) {
+        QMessageBox::critical(this, tr("エラー"),
+                              tr("エンジン「%1」の実行ファイルが設定されていません。").arg(engine.name));
+        return;
+    }
 
     // ジェネレータを作成
     m_generator = std::make_unique<TsumeshogiGenerator>(this);
@@ -291,20 +315,26 @@ void TsumeshogiGeneratorDialog::onStartClicked()
             this, &TsumeshogiGeneratorDialog::onGeneratorFinished);
     connect(m_generator.get(), &TsumeshogiGenerator::errorOccurred,
             this, &TsumeshogiGeneratorDialog::onGeneratorError);
+    connect(m_generator.get(), &TsumeshogiGenerator::workerStatsUpdated,
+            this, &TsumeshogiGeneratorDialog::onWorkerStatsUpdated);
 
     // 設定を構築
     TsumeshogiGenerator::Settings settings;
-    settings.enginePath = m_engineList.at(engineIndex).path;
-    settings.engineName = m_engineList.at(engineIndex).name;
+    settings.enginePath = engine.path;
+    settings.engineName = engine.name;
+    settings.useBuiltinSolver = engine.builtin;
     settings.targetMoves = m_spinTargetMoves->value();
     settings.timeoutMs = m_spinTimeout->value() * 1000;
     settings.maxPositionsToFind = m_spinMaxPositions->value();
+    settings.workerCount = m_spinWorkers->value();
     settings.posGenSettings.maxAttackPieces = m_spinMaxAttack->value();
     settings.posGenSettings.maxDefendPieces = m_spinMaxDefend->value();
     settings.posGenSettings.attackRange = m_spinAttackRange->value();
 
     // 結果テーブルをクリア
     m_tableResults->setRowCount(0);
+    m_labelWorkers->clear();
+    m_labelWorkers->setVisible(false);
 
     setRunningState(true);
     m_generator->start(settings);
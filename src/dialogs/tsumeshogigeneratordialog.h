@@ -9,6 +9,7 @@
 #include <memory>
 
 #include "fontsizehelper.h"
+#include "tsumeshogigenerator.h"
 
 class QComboBox;
 class QLabel;
@@ -17,7 +18,6 @@ class QSpinBox;
 class QTableWidget;
 class QToolButton;
 class QVBoxLayout;
-class TsumeshogiGenerator;
 
 /**
  * @brief 詰将棋局面生成ダイアログ
@@ -40,6 +40,7 @@ private slots:
     void onProgressUpdated(int tried, int found, qint64 elapsedMs);
     void onGeneratorFinished();
     void onGeneratorError(const QString& message);
+    void onWorkerStatsUpdated(const QList<TsumeshogiGenerator::WorkerStats>& stats);
     void onSaveToFile();
     void onCopySelected();
     void onCopyAll();
@@ -55,6 +56,7 @@ private:
         QString name;
         QString path;
         QString author;
+        bool builtin = false;  ///< エンジンを起動しない内蔵ソルバーの項目
     };
 
     void setupUi();
@@ -80,6 +82,7 @@ private:
     QSpinBox* m_spinAttackRange = nullptr;
     QSpinBox* m_spinTimeout = nullptr;
     QSpinBox* m_spinMaxPositions = nullptr;
+    QSpinBox* m_spinWorkers = nullptr;
 
     // 制御ボタン
     QPushButton* m_btnStart = nullptr;
@@ -88,6 +91,7 @@ private:
     // プログレス表示
     QLabel* m_labelProgress = nullptr;
     QLabel* m_labelElapsed = nullptr;
+    QLabel* m_labelWorkers = nullptr;  ///< 並列ワーカーごとの集計（内蔵ソルバ並列時のみ）
 
     // 結果テーブル
     QTableWidget* m_tableResults = nullptr;
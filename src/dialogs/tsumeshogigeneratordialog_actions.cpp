@@ -14,6 +14,7 @@
 #include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QLabel>
 #include <QMessageBox>
 #include <QSpinBox>
 #include <QTableWidget>
@@ -60,6 +61,20 @@ void TsumeshogiGeneratorDialog::onGeneratorError(const QString& message)
     setRunningState(false);
 }
 
+void TsumeshogiGeneratorDialog::onWorkerStatsUpdated(const QList<TsumeshogiGenerator::WorkerStats>& stats)
+{
+    QStringList lines;
+    for (qsizetype i = 0; i < stats.size(); ++i) {
+        lines.append(tr("ワーカー%1: 探索 %2 / 発見 %3 / %4 局面/秒")
+                         .arg(i + 1)
+                         .arg(stats.at(i).tried)
+                         .arg(stats.at(i).found)
+                         .arg(stats.at(i).positionsPerSec, 0, 'f', 1));
+    }
+    m_labelWorkers->setText(lines.join(QLatin1Char('\n')));
+    m_labelWorkers->setVisible(!lines.isEmpty());
+}
+
 void TsumeshogiGeneratorDialog::onSaveToFile()
 {
     if (m_tableResults->rowCount() == 0) return;
@@ -133,6 +148,7 @@ void TsumeshogiGeneratorDialog::onRestoreDefaults()
     m_spinAttackRange->setValue(3);
     m_spinTimeout->setValue(5);
     m_spinMaxPositions->setValue(10);
+    m_spinWorkers->setValue(1);
 }
 
 void TsumeshogiGeneratorDialog::onResultTableClicked(const QModelIndex& index)
@@ -160,6 +176,10 @@ void TsumeshogiGeneratorDialog::showEngineSettingsDialog()
         QMessageBox::critical(this, tr("エラー"), tr("将棋エンジンが選択されていません。"));
         return;
     }
+    if (m_engineList.at(engineIndex).builtin) {
+        QMessageBox::information(this, tr("エンジン設定"), tr("内蔵ソルバーには設定項目がありません。"));
+        return;
+    }
 
     ChangeEngineSettingsDialog dialog(this);
     dialog.setEngineNumber(engineIndex);
@@ -223,6 +243,7 @@ void TsumeshogiGeneratorDialog::setRunningState(bool running)
     m_spinAttackRange->setEnabled(!running);
     m_spinTimeout->setEnabled(!running);
     m_spinMaxPositions->setEnabled(!running);
+    m_spinWorkers->setEnabled(!running);
 }
 
 QString TsumeshogiGeneratorDialog::formatElapsedTime(qint64 ms) const
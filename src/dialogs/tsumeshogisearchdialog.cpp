@@ -9,6 +9,9 @@ TsumeShogiSearchDialog::TsumeShogiSearchDialog(QWidget *parent)
 {
     // ウィンドウタイトルを「詰み探索」に設定する。
     setWindowTitle(tr("詰み探索"));
+
+    // エンジンを起動せずに解く内蔵ソルバーを選択肢に加える。
+    appendBuiltinEngine(tr("内蔵ソルバー（エンジン不要）"));
 }
 
 TsumeShogiSearchDialog::~TsumeShogiSearchDialog()
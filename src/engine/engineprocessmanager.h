@@ -46,6 +46,13 @@ public:
     [[nodiscard]] bool startProcess(const QString& engineFile);
 
     void stopProcess();
+
+    /// プロセスの所有権を手放す（シグナル接続を外す。EngineProcessPool への返却用）
+    [[nodiscard]] std::unique_ptr<QProcess> takeProcess();
+
+    /// 起動済みのプロセスを引き取り、シグナル接続を行う（EngineProcessPool からの貸出用）
+    [[nodiscard]] bool adoptProcess(std::unique_ptr<QProcess> process, const QString& engineFile);
+
     bool isRunning() const;
     QProcess::ProcessState state() const;
     QString currentEnginePath() const { return m_currentEnginePath; }
@@ -131,6 +138,12 @@ private:
 
     /// 未読データが残っている場合にイベントループ経由で再読み取りを予約
     void scheduleMoreReading();
+
+    /// m_process のシグナルをこのオブジェクトへ接続
+    void connectProcessSignals();
+
+    /// プロセス解放後の状態を初期値へ戻す
+    void resetProcessState();
 };
 
 #endif // ENGINEPROCESSMANAGER_H
@@ -213,14 +213,7 @@ bool EngineProcessManager::startProcess(const QString& engineFile)
         QFileInfo engineFileInfo(engineFile);
         m_process->setWorkingDirectory(engineFileInfo.absolutePath());
 
-        connect(m_process.get(), &QProcess::readyReadStandardOutput,
-                this, &EngineProcessManager::onReadyReadStdout);
-        connect(m_process.get(), &QProcess::readyReadStandardError,
-                this, &EngineProcessManager::onReadyReadStderr);
-        connect(m_process.get(), &QProcess::errorOccurred,
-                this, &EngineProcessManager::onProcessError);
-        connect(m_process.get(), QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-                this, &EngineProcessManager::onProcessFinished);
+        connectProcessSignals();
 
         m_process->start(engineFile, QStringList(), QIODevice::ReadWrite);
 
@@ -274,7 +267,56 @@ void EngineProcessManager::stopProcess()
     }
 
     m_process.reset();
+    resetProcessState();
+}
+
+std::unique_ptr<QProcess> EngineProcessManager::takeProcess()
+{
+    if (m_transitionInProgress || !m_process) {
+        return nullptr;
+    }
+
+    disconnect(m_process.get(), nullptr, this, nullptr);
+    std::unique_ptr<QProcess> process = std::move(m_process);
+    resetProcessState();
+    return process;
+}
 
+bool EngineProcessManager::adoptProcess(std::unique_ptr<QProcess> process, const QString& engineFile)
+{
+    if (m_transitionInProgress || !process || process->state() != QProcess::Running) {
+        return false;
+    }
+    if (m_process) {
+        stopProcess();
+    }
+
+    m_process = std::move(process);
+    m_currentEnginePath = engineFile;
+    connectProcessSignals();
+
+    // 待機中に溜まった出力（停止後の info 行など）は前の利用者のものなので捨てる
+    discardStdout();
+    discardStderr();
+
+    m_shutdownState = ShutdownState::Running;
+    return true;
+}
+
+void EngineProcessManager::connectProcessSignals()
+{
+    connect(m_process.get(), &QProcess::readyReadStandardOutput,
+            this, &EngineProcessManager::onReadyReadStdout);
+    connect(m_process.get(), &QProcess::readyReadStandardError,
+            this, &EngineProcessManager::onReadyReadStderr);
+    connect(m_process.get(), &QProcess::errorOccurred,
+            this, &EngineProcessManager::onProcessError);
+    connect(m_process.get(), QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &EngineProcessManager::onProcessFinished);
+}
+
+void EngineProcessManager::resetProcessState()
+{
     m_shutdownState = ShutdownState::Running;
     m_postQuitInfoStringLinesLeft = 0;
     m_currentEnginePath.clear();
@@ -0,0 +1,271 @@
+/// @file engineprocesspool.cpp
+/// @brief 初期化済みUSIエンジンプロセスを使い回すプールの実装
+
+#include "engineprocesspool.h"
+#include "engineprocessmanager.h"
+#include "logcategories.h"
+
+namespace {
+constexpr int kSweepIntervalMs = 30 * 1000;
+
+bool sameConfig(const EngineProcessPool::WarmEngine& engine,
+                const QString& enginePath, const QString& engineName)
+{
+    return engine.enginePath == enginePath && engine.engineName == engineName;
+}
+} // anonymous namespace
+
+EngineProcessPool& EngineProcessPool::instance()
+{
+    static EngineProcessPool inst;
+    return inst;
+}
+
+EngineProcessPool::EngineProcessPool(QObject* parent)
+    : QObject(parent)
+{
+    m_sweepTimer.setInterval(kSweepIntervalMs);
+    connect(&m_sweepTimer, &QTimer::timeout, this, &EngineProcessPool::evictExpired);
+    m_settleTimer.setSingleShot(true);
+    connect(&m_settleTimer, &QTimer::timeout, this, &EngineProcessPool::evictExpired);
+}
+
+EngineProcessPool::~EngineProcessPool()
+{
+    clear();
+}
+
+// ============================================================
+// 設定
+// ============================================================
+
+int EngineProcessPool::maxIdlePerEngine() const
+{
+    return m_maxIdlePerEngine;
+}
+
+void EngineProcessPool::setMaxIdlePerEngine(int count)
+{
+    m_maxIdlePerEngine = qMax(0, count);
+
+    // 上限を下げた分は古いものから終了させる
+    for (auto it = m_idle.begin(); it != m_idle.end();) {
+        if (idleCount(it->enginePath, it->engineName) > m_maxIdlePerEngine) {
+            terminate(*it);
+            it = m_idle.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    updateSweepTimer();
+}
+
+int EngineProcessPool::idleTimeoutMs() const
+{
+    return m_idleTimeoutMs;
+}
+
+void EngineProcessPool::setIdleTimeoutMs(int ms)
+{
+    m_idleTimeoutMs = qMax(0, ms);
+    evictExpired();
+}
+
+int EngineProcessPool::settleTimeoutMs() const
+{
+    return m_settleTimeoutMs;
+}
+
+void EngineProcessPool::setSettleTimeoutMs(int ms)
+{
+    m_settleTimeoutMs = qMax(0, ms);
+    evictExpired();
+}
+
+// ============================================================
+// 貸出・返却
+// ============================================================
+
+bool EngineProcessPool::accepts(const QString& enginePath, const QString& engineName) const
+{
+    if (m_maxIdlePerEngine <= 0 || enginePath.isEmpty() || engineName.isEmpty()) {
+        return false;
+    }
+    return idleCount(enginePath, engineName) < m_maxIdlePerEngine;
+}
+
+std::optional<EngineProcessPool::WarmEngine> EngineProcessPool::lease(const QString& enginePath,
+                                                                     const QString& engineName)
+{
+    // 最後に返されたもの（キャッシュが温まっているもの）から貸し出す
+    for (size_t i = m_idle.size(); i-- > 0;) {
+        if (!sameConfig(m_idle[i], enginePath, engineName)) continue;
+        // stop の応答がまだなら少しだけ待つ。来なければ貸さずに残す（期限切れで終了させる）
+        if (m_idle[i].settling && !settle(m_idle[i], kLeaseSettleWaitMs)) continue;
+
+        WarmEngine engine = std::move(m_idle[i]);
+        m_idle.erase(m_idle.begin() + static_cast<std::ptrdiff_t>(i));
+        if (!isAlive(engine)) {
+            qCInfo(lcEngine) << "待機中に終了していたエンジンを破棄:" << engineName;
+            terminate(engine);
+            continue;
+        }
+
+        updateSweepTimer();
+        qCInfo(lcEngine) << "待機中のエンジンを貸出:" << engineName
+                         << "待機" << engine.idleTimer.elapsed() << "ms";
+        return engine;
+    }
+    updateSweepTimer();
+    return std::nullopt;
+}
+
+bool EngineProcessPool::release(WarmEngine engine)
+{
+    if (!isAlive(engine) || !accepts(engine.enginePath, engine.engineName)) {
+        terminate(engine);
+        return false;
+    }
+
+    engine.idleTimer.start();
+    if (engine.settling) {
+        // 探索を止めた直後のエンジン。bestmove/checkmate が届くまで出力を読み捨てる
+        connect(engine.process.get(), &QProcess::readyReadStandardOutput,
+                this, &EngineProcessPool::onSettlingOutput);
+        (void)settle(engine, 0);
+    }
+    qCInfo(lcEngine) << "エンジンを待機状態で保持:" << engine.engineName
+                     << (engine.settling ? "（stop の応答待ち）" : "");
+    m_idle.push_back(std::move(engine));
+    updateSweepTimer();
+    return true;
+}
+
+int EngineProcessPool::idleCount() const
+{
+    return static_cast<int>(m_idle.size());
+}
+
+int EngineProcessPool::idleCount(const QString& enginePath, const QString& engineName) const
+{
+    int count = 0;
+    for (const WarmEngine& engine : m_idle) {
+        if (sameConfig(engine, enginePath, engineName)) ++count;
+    }
+    return count;
+}
+
+void EngineProcessPool::clear()
+{
+    for (WarmEngine& engine : m_idle) {
+        terminate(engine);
+    }
+    m_idle.clear();
+    updateSweepTimer();
+}
+
+void EngineProcessPool::shutdown()
+{
+    m_maxIdlePerEngine = 0;
+    clear();
+}
+
+// ============================================================
+// 内部
+// ============================================================
+
+void EngineProcessPool::evictExpired()
+{
+    for (auto it = m_idle.begin(); it != m_idle.end();) {
+        if (it->settling && it->idleTimer.elapsed() >= m_settleTimeoutMs) {
+            qCWarning(lcEngine) << "stop に応答しない待機中のエンジンを終了:" << it->engineName;
+            terminate(*it);
+            it = m_idle.erase(it);
+        } else if (!isAlive(*it) || it->idleTimer.elapsed() >= m_idleTimeoutMs) {
+            qCInfo(lcEngine) << "待機中のエンジンを終了:" << it->engineName;
+            terminate(*it);
+            it = m_idle.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    updateSweepTimer();
+}
+
+bool EngineProcessPool::isAlive(const WarmEngine& engine)
+{
+    return engine.process && engine.process->state() == QProcess::Running;
+}
+
+void EngineProcessPool::onSettlingOutput()
+{
+    const auto* process = qobject_cast<QProcess*>(sender());
+    for (WarmEngine& engine : m_idle) {
+        if (engine.process.get() == process && engine.settling && settle(engine, 0)) {
+            qCInfo(lcEngine) << "stop の応答を受信、貸出可能:" << engine.engineName;
+        }
+    }
+    updateSweepTimer();
+}
+
+bool EngineProcessPool::settle(WarmEngine& engine, int waitMs)
+{
+    QProcess* process = engine.process.get();
+    if (!process) return false;
+
+    // waitForReadyRead() 中の readyRead で onSettlingOutput() が先に読み捨てることもある
+    QElapsedTimer waited;
+    waited.start();
+    while (engine.settling) {
+        while (process->canReadLine()) {
+            const QByteArray line = process->readLine().trimmed();
+            if (line.startsWith("bestmove") || line.startsWith("checkmate")) {
+                disconnect(process, nullptr, this, nullptr);
+                engine.settling = false;
+                engine.idleTimer.start();
+                return true;
+            }
+        }
+        const qint64 remaining = waitMs - waited.elapsed();
+        if (remaining <= 0 || !process->waitForReadyRead(static_cast<int>(remaining))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EngineProcessPool::terminate(WarmEngine& engine)
+{
+    if (!engine.process) return;
+    engine.process->disconnect();
+
+    // EngineProcessManager に引き取らせ、quit → 終了待ち → 強制終了の通常手順で止める
+    EngineProcessManager manager;
+    if (manager.adoptProcess(std::move(engine.process), engine.enginePath)) {
+        manager.sendCommand(QStringLiteral("quit"));
+        manager.closeWriteChannel();
+    }
+    manager.stopProcess();
+}
+
+void EngineProcessPool::updateSweepTimer()
+{
+    if (m_idle.empty()) {
+        m_sweepTimer.stop();
+    } else if (!m_sweepTimer.isActive()) {
+        m_sweepTimer.start();
+    }
+
+    // 最も早く期限の来る stop 応答待ちに合わせて単発タイマーを掛け直す
+    qint64 settleRemaining = -1;
+    for (const WarmEngine& engine : m_idle) {
+        if (!engine.settling) continue;
+        const qint64 remaining = qMax<qint64>(0, m_settleTimeoutMs - engine.idleTimer.elapsed());
+        settleRemaining = settleRemaining < 0 ? remaining : qMin(settleRemaining, remaining);
+    }
+    if (settleRemaining < 0) {
+        m_settleTimer.stop();
+    } else {
+        m_settleTimer.start(static_cast<int>(settleRemaining));
+    }
+}
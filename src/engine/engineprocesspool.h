@@ -0,0 +1,120 @@
+#ifndef ENGINEPROCESSPOOL_H
+#define ENGINEPROCESSPOOL_H
+
+/// @file engineprocesspool.h
+/// @brief 初期化済みUSIエンジンプロセスを使い回すプールの定義
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QObject>
+#include <QProcess>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <memory>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief usiok/readyok まで済んだ待機中のエンジンプロセスを保持するシングルトン
+ *
+ * Usi が使い終えたエンジンを quit せずに返却し、同じ構成（実行ファイル + エンジン名）の
+ * 次の Usi がそれを借りることで、プロセス起動と usi ハンドシェイクを省く。
+ * 検討 ⇔ 棋譜解析の切り替えや詰み探索の連続実行で、評価関数の再読み込みを待たずに済む。
+ *
+ * - 構成ごとの保持数は maxIdlePerEngine() まで（0 でプール無効、返却分は通常どおり終了）
+ * - idleTimeoutMs() を超えて使われなかったエンジンは終了させる
+ * - 探索中に返されたエンジン（stop 送信済み）は、bestmove/checkmate を読み捨てるまで貸し出さない。
+ *   settleTimeoutMs() 以内に応答がなければ終了させる
+ * - 停止済みのプロセスは貸し出さない（readyok による生存確認は借りた側が行う）
+ *
+ * GUIスレッド専用。
+ */
+class EngineProcessPool final : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// 待機中のエンジン1つ分
+    struct WarmEngine {
+        std::unique_ptr<QProcess> process;          ///< readyok 済みのプロセス
+        QString enginePath;                         ///< 実行ファイルのパス
+        QString engineName;                         ///< 設定上のエンジン名（オプション配列のキー）
+        QSet<QString> reportedOptions;              ///< エンジンが報告したオプション名
+        QMap<QString, QString> appliedOptions;      ///< 送信済みの setoption（オプション名 → コマンド）
+        QElapsedTimer idleTimer;                    ///< 返却されてからの経過時間
+        bool settling = false;                      ///< stop への bestmove/checkmate を待っている
+    };
+
+    /// 構成ごとの既定の保持数
+    static constexpr int kDefaultMaxIdlePerEngine = 1;
+    /// 既定の待機期限（10分）
+    static constexpr int kDefaultIdleTimeoutMs = 10 * 60 * 1000;
+    /// 既定の stop 応答待ちの期限
+    static constexpr int kDefaultSettleTimeoutMs = 2000;
+    /// 借りるときに stop の応答を待つ上限（起動し直すより十分短い）
+    static constexpr int kLeaseSettleWaitMs = 200;
+
+    /// シングルトンインスタンスを返す
+    static EngineProcessPool& instance();
+
+    ~EngineProcessPool() override;
+
+    /// 構成ごとの保持数の上限（0 でプール無効）
+    int maxIdlePerEngine() const;
+    void setMaxIdlePerEngine(int count);
+
+    /// 待機期限（これを超えた待機中エンジンは終了させる）
+    int idleTimeoutMs() const;
+    void setIdleTimeoutMs(int ms);
+
+    /// stop 応答待ちの期限（これを過ぎても bestmove/checkmate が来ないエンジンは終了させる）
+    int settleTimeoutMs() const;
+    void setSettleTimeoutMs(int ms);
+
+    /// 返却を受け付けるか（無効時・上限到達時は false）
+    bool accepts(const QString& enginePath, const QString& engineName) const;
+
+    /// 同じ構成の待機中エンジンを借りる（なければ std::nullopt）
+    std::optional<WarmEngine> lease(const QString& enginePath, const QString& engineName);
+
+    /// 使い終わったエンジンを返す。受け付けなかった場合はここで終了させて false を返す
+    /// settling なら出力を監視し、bestmove/checkmate を受け取るまで貸し出さない（ここでは待たない）
+    bool release(WarmEngine engine);
+
+    /// 待機中のエンジン数
+    int idleCount() const;
+    int idleCount(const QString& enginePath, const QString& engineName) const;
+
+    /// 待機中のエンジンを全て終了させる
+    void clear();
+
+    /// アプリ終了時：以降の返却を断り、待機中のエンジンを全て終了させる
+    void shutdown();
+
+private slots:
+    /// 待機期限切れ・stop 応答待ちの期限切れ・停止済みのエンジンを取り除く
+    void evictExpired();
+    /// stop 応答待ちのエンジンの出力を読み捨てる
+    void onSettlingOutput();
+
+private:
+    explicit EngineProcessPool(QObject* parent = nullptr);
+    Q_DISABLE_COPY_MOVE(EngineProcessPool)
+
+    static bool isAlive(const WarmEngine& engine);
+    static void terminate(WarmEngine& engine);
+
+    /// 出力を bestmove/checkmate まで読み捨て、届いたら貸出可能にする（waitMs まで待つ）
+    bool settle(WarmEngine& engine, int waitMs);
+    void updateSweepTimer();
+
+    std::vector<WarmEngine> m_idle;                 ///< 待機中のエンジン（古い順）
+    QTimer m_sweepTimer;                            ///< 待機期限の確認タイマー
+    QTimer m_settleTimer;                           ///< stop 応答待ちの期限タイマー（単発）
+    int m_maxIdlePerEngine = kDefaultMaxIdlePerEngine;
+    int m_idleTimeoutMs = kDefaultIdleTimeoutMs;
+    int m_settleTimeoutMs = kDefaultSettleTimeoutMs;
+};
+
+#endif // ENGINEPROCESSPOOL_H
@@ -0,0 +1,118 @@
+/// @file infoconversionworker.cpp
+/// @brief info行の解析・漢字読み筋変換ワーカークラスの実装
+
+#include "infoconversionworker.h"
+#include "shogigamecontroller.h"
+
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+#include <QThread>
+
+InfoConversionWorker::InfoConversionWorker(QObject* parent)
+    : QObject(parent)
+    , m_parser(std::make_unique<ShogiEngineInfoParser>())
+    , m_converted(kQueueCapacity)
+{
+    qRegisterMetaType<InfoConversionBatch>("InfoConversionBatch");
+}
+
+InfoConversionWorker::~InfoConversionWorker() = default;
+
+ConvertedInfo InfoConversionWorker::convertLine(ShogiEngineInfoParser& parser, const QString& line,
+                                                const InfoConversionContext& context)
+{
+    parser.setPreviousFileTo(context.previousFileTo);
+    parser.setPreviousRankTo(context.previousRankTo);
+
+    // 思考開始時の手番で▲△を決める（bestmove後の局面更新の影響を受けないようにする）
+    parser.setThinkingStartPlayer(context.startPlayerIsP1 ? ShogiGameController::Player1
+                                                          : ShogiGameController::Player2);
+
+    // 盤面は読み筋のシミュレーション用に複製してから使うので、スナップショットをそのまま渡せる
+    parser.parseEngineOutputAndUpdateState(line, context.boardData, context.ponderEnabled);
+
+    ConvertedInfo info;
+    info.usi = parser.usiInfo();
+    info.searchedHand = parser.searchedHand();
+    info.pvKanjiStr = parser.pvKanjiStr();
+    if (info.usi.pvTruncated && info.usi.pvRestOffset >= 0) {
+        // 固定長の配列に入りきらなかった手は元の行の文字列のまま渡す
+        info.pvUsiRest = line.mid(info.usi.pvRestOffset).trimmed();
+    }
+
+    // 反映は後（GUIスレッドの次のイベント）になるので、表示の基準も投入時の値を持たせる
+    info.baseSfen = context.baseSfen;
+    info.scoreSign = context.scoreSign;
+    info.showScoreBound = context.showScoreBound;
+    return info;
+}
+
+// ============================================================
+// GUIスレッド側
+// ============================================================
+
+void InfoConversionWorker::beginBatch()
+{
+    const QMutexLocker locker(&m_idleMutex);
+    ++m_pendingBatches;
+}
+
+QList<ConvertedInfo> InfoConversionWorker::takeConverted()
+{
+    // 先に通知済みフラグを下ろし、取り出し中に積まれた行は次の通知で拾う
+    m_notifyPending.store(false, std::memory_order_release);
+
+    QList<ConvertedInfo> records;
+    ConvertedInfo info;
+    while (m_converted.tryPop(info)) {
+        records.append(std::move(info));
+    }
+    return records;
+}
+
+bool InfoConversionWorker::waitForIdle(int timeoutMs)
+{
+    QDeadlineTimer deadline(timeoutMs);
+    const QMutexLocker locker(&m_idleMutex);
+    while (m_pendingBatches > 0) {
+        if (!m_idleCondition.wait(&m_idleMutex, deadline)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================
+// ワーカースレッド側
+// ============================================================
+
+void InfoConversionWorker::convertBatch(const InfoConversionBatch& batch)
+{
+    for (const QString& line : std::as_const(batch.lines)) {
+        ConvertedInfo info = convertLine(*m_parser, line, batch.context);
+        info.generation = batch.generation;
+        pushConverted(info);
+    }
+
+    const QMutexLocker locker(&m_idleMutex);
+    --m_pendingBatches;
+    m_idleCondition.wakeAll();
+}
+
+void InfoConversionWorker::pushConverted(ConvertedInfo& info)
+{
+    // 満杯ならGUIが取り出すまで待つ（終了要求が来たら捨てる）
+    while (!m_converted.tryPush(info)) {
+        notifyConverted();
+        if (QThread::currentThread()->isInterruptionRequested()) return;
+        QThread::msleep(1);
+    }
+    notifyConverted();
+}
+
+void InfoConversionWorker::notifyConverted()
+{
+    if (!m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        emit convertedReady();
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef INFOCONVERSIONWORKER_H
+#define INFOCONVERSIONWORKER_H
+
+/// @file infoconversionworker.h
+/// @brief info行の解析・漢字読み筋変換ワーカークラスの定義
+
+
+#include <QList>
+#include <QMetaType>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+
+#include "shogiengineinfoparser.h"
+#include "spscqueue.h"
+#include "threadtypes.h"
+#include "usiinfo.h"
+
+/// 読み筋変換の基準となる思考開始時の状態（GUIスレッドでスナップショットを取る）
+struct InfoConversionContext {
+    QList<QChar> boardData;             ///< 思考開始局面の盤面データ
+    int previousFileTo = 0;             ///< 前回の指し手の筋（「同」の判定用）
+    int previousRankTo = 0;             ///< 前回の指し手の段
+    bool startPlayerIsP1 = true;        ///< 思考開始時の手番
+    bool ponderEnabled = false;         ///< ponderモード
+    QString baseSfen;                   ///< 思考開始局面のSFEN（思考タブの行に添える）
+    int scoreSign = 1;                  ///< 評価値の符号（棋譜解析モードで後手番なら -1）
+    bool showScoreBound = false;        ///< 評価値に lowerbound/upperbound の印（++/--）を付ける
+};
+
+/// ワーカーへ渡すinfo行のまとまり
+struct InfoConversionBatch {
+    JobGeneration generation = 0;       ///< 投入時の世代（クリア後の古い結果を捨てる）
+    InfoConversionContext context;      ///< 変換の基準
+    QStringList lines;                  ///< 間引き済みのinfo行
+};
+
+Q_DECLARE_METATYPE(InfoConversionBatch)
+
+/// 表示用に解析・変換済みのinfo行1行分
+struct ConvertedInfo {
+    JobGeneration generation = 0;       ///< 元のバッチの世代
+    UsiInfo usi;                        ///< 型付きの解析結果（文字列への整形は表示時に行う）
+    QString score;                      ///< 表示用の評価値文字列（GUIスレッドで設定）
+    QString searchedHand;               ///< 探索手（currmove / 読み筋先頭手の漢字表記）
+    QString pvKanjiStr;                 ///< 漢字表記の読み筋
+    QString pvUsiRest;                  ///< 切り詰めた読み筋の残り（USI形式。切り詰めたときだけ）
+    QString baseSfen;                   ///< 変換時の思考開始局面のSFEN
+    int scoreSign = 1;                  ///< 変換時の評価値の符号
+    bool showScoreBound = false;        ///< 変換時の評価値の印の有無
+};
+
+/**
+ * @brief エンジン1つ分のinfo行をワーカースレッドで解析・漢字変換するワーカー
+ *
+ * QThread に moveToThread() して使用する。convertBatch() スロットで受け取った行を
+ * 1行ずつ ConvertedInfo に変換し、ロックフリーの SPSC キューへ積む。
+ * GUIスレッドは convertedReady() を受けて takeConverted() で取り出す。
+ * 通知は取り出されるまで1回にまとめるので、キューが溜まってもイベントは増えない。
+ */
+class InfoConversionWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// 変換済みキューの容量（満杯ならGUIが取り出すまでワーカーが待つ）
+    static constexpr qsizetype kQueueCapacity = 256;
+
+    explicit InfoConversionWorker(QObject* parent = nullptr);
+    ~InfoConversionWorker() override;
+
+    /// info行1行を解析・変換する（ワーカー・GUIスレッド共通）
+    static ConvertedInfo convertLine(ShogiEngineInfoParser& parser, const QString& line,
+                                     const InfoConversionContext& context);
+
+    // --- GUIスレッドから呼ぶ ---
+
+    /// バッチを投入する直前に呼ぶ（waitForIdle() の対象に数える）
+    void beginBatch();
+
+    /// 変換済みの行を全て取り出す
+    QList<ConvertedInfo> takeConverted();
+
+    /// 投入済みのバッチが全て変換されるまで最大 timeoutMs 待つ
+    bool waitForIdle(int timeoutMs);
+
+public slots:
+    /// バッチを変換する（ワーカースレッドで実行される）
+    void convertBatch(const InfoConversionBatch& batch);
+
+signals:
+    /// 変換済みの行がキューに入った（→ ThinkingInfoPresenter::drainConvertedInfo）
+    void convertedReady();
+
+private:
+    void pushConverted(ConvertedInfo& info);
+    void notifyConverted();
+
+    std::unique_ptr<ShogiEngineInfoParser> m_parser; ///< ワーカースレッド専用のパーサ
+    SpscQueue<ConvertedInfo> m_converted;           ///< ワーカー → GUI の変換済みキュー
+    std::atomic_bool m_notifyPending{false};        ///< convertedReady() 送出済みで未取り出し
+
+    QMutex m_idleMutex;                             ///< m_pendingBatches を守る
+    QWaitCondition m_idleCondition;                 ///< 全バッチの変換完了
+    int m_pendingBatches = 0;                       ///< 投入済みで未変換のバッチ数
+};
+
+#endif // INFOCONVERSIONWORKER_H
@@ -0,0 +1,124 @@
+/// @file infolinecoalescer.cpp
+/// @brief USI info行の間引きクラスの実装
+
+#include "infolinecoalescer.h"
+
+namespace {
+
+/// 走査中に次のトークンとして期待するもの
+enum class Expect {
+    Key,          ///< info のキーワード
+    MultipvValue, ///< multipv の値
+    ScoreType,    ///< cp / mate
+    CpValue,      ///< cp の値
+    MateValue,    ///< mate の値
+    Bound         ///< lowerbound / upperbound（省略可）
+};
+
+} // namespace
+
+InfoLineCoalescer::Summary InfoLineCoalescer::scan(QStringView line)
+{
+    Summary summary;
+    Expect expect = Expect::Key;
+
+    for (const QStringView token : line.tokenize(u' ', Qt::SkipEmptyParts)) {
+        switch (expect) {
+        case Expect::MultipvValue:
+            summary.multipv = qMax(1, token.toInt());
+            expect = Expect::Key;
+            continue;
+        case Expect::ScoreType:
+            expect = (token == u"cp") ? Expect::CpValue
+                   : (token == u"mate") ? Expect::MateValue
+                                        : Expect::Key;
+            continue;
+        case Expect::CpValue:
+            summary.scoreKind = ScoreKind::Exact;
+            expect = Expect::Bound;
+            continue;
+        case Expect::MateValue:
+            // "mate +" / "mate -" / "mate 5" / "mate -3"
+            summary.scoreKind = token.startsWith(u'-') ? ScoreKind::MateLoss : ScoreKind::MateWin;
+            expect = Expect::Key;
+            continue;
+        case Expect::Bound:
+            expect = Expect::Key;
+            if (token == u"lowerbound") {
+                summary.scoreKind = ScoreKind::LowerBound;
+                continue;
+            }
+            if (token == u"upperbound") {
+                summary.scoreKind = ScoreKind::UpperBound;
+                continue;
+            }
+            break;
+        case Expect::Key:
+            break;
+        }
+
+        // pv / string 以降は指し手や自由文なので読まない
+        if (token == u"pv") {
+            summary.hasPv = true;
+            break;
+        }
+        if (token == u"string") {
+            summary.isString = true;
+            break;
+        }
+        if (token == u"multipv") {
+            expect = Expect::MultipvValue;
+        } else if (token == u"score") {
+            expect = Expect::ScoreType;
+        }
+    }
+    return summary;
+}
+
+QList<qsizetype> InfoLineCoalescer::select(const QStringList& batch)
+{
+    const qsizetype count = batch.size();
+    QList<bool> keep(count, false);
+    QHash<int, qsizetype> lastPvLine;   // multipv → 最後の読み筋の行
+    qsizetype lastLine = -1;
+
+    for (qsizetype i = 0; i < count; ++i) {
+        if (batch.at(i).isEmpty()) continue;
+        lastLine = i;
+
+        const Summary summary = scan(batch.at(i));
+        if (summary.isString) {
+            keep[i] = true;
+            continue;
+        }
+        if (!summary.hasPv && summary.scoreKind == ScoreKind::None) continue;
+
+        // 境界値 ⇔ 確定値、詰みの出現・消失は途中の行でも表示に残す
+        if (summary.scoreKind != ScoreKind::None) {
+            const ScoreKind previous = m_lastScoreKind.value(summary.multipv, ScoreKind::None);
+            if (previous != ScoreKind::None && previous != summary.scoreKind) {
+                keep[i] = true;
+            }
+            m_lastScoreKind.insert(summary.multipv, summary.scoreKind);
+        }
+        lastPvLine.insert(summary.multipv, i);
+    }
+
+    for (const qsizetype index : std::as_const(lastPvLine)) {
+        keep[index] = true;
+    }
+    if (lastLine >= 0) {
+        keep[lastLine] = true;
+    }
+
+    QList<qsizetype> selected;
+    for (qsizetype i = 0; i < count; ++i) {
+        if (keep.at(i)) selected.append(i);
+    }
+    return selected;
+}
+
+void InfoLineCoalescer::reset()
+{
+    m_lastScoreKind.clear();
+}
@@ -0,0 +1,60 @@
+#ifndef INFOLINECOALESCER_H
+#define INFOLINECOALESCER_H
+
+/// @file infolinecoalescer.h
+/// @brief USI info行の間引き（multipv ごとに最新の読み筋だけを残す）クラスの定義
+
+
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QStringView>
+
+/**
+ * @brief info行のバッチから、漢字変換して表示する行だけを選ぶ
+ *
+ * 強いエンジンは MultiPV で毎秒数千行の info を出すが、同じ multipv の読み筋は
+ * すぐ次の行で上書きされる。各行を depth / multipv / score のトークンだけで軽く走査し、
+ * 次の行を残す（元の順序のまま）:
+ * - multipv ごとの最後の読み筋（score / pv を含む行）
+ * - 評価値の種類が変わった行（確定値 ⇔ 下限値・上限値、詰みの出現・消失）
+ * - info string 行
+ * - バッチ最後の行（深さ・ノード数・NPS の表示を最新にする）
+ *
+ * 評価値の種類はバッチをまたいで multipv ごとに覚えるので、探索開始時に reset() を呼ぶ。
+ */
+class InfoLineCoalescer
+{
+public:
+    /// 評価値の種類
+    enum class ScoreKind : quint8 {
+        None,       ///< score なし
+        Exact,      ///< score cp（確定値）
+        LowerBound, ///< score cp ... lowerbound
+        UpperBound, ///< score cp ... upperbound
+        MateWin,    ///< score mate 正 / +
+        MateLoss    ///< score mate 負 / -
+    };
+
+    /// 1行分の軽量走査の結果
+    struct Summary {
+        int multipv = 1;                    ///< MultiPV番号（省略時は1）
+        ScoreKind scoreKind = ScoreKind::None; ///< 評価値の種類
+        bool hasPv = false;                 ///< pv トークンを含む
+        bool isString = false;              ///< info string 行
+    };
+
+    /// pv / string 以降は読まずに、multipv と評価値の種類だけを取り出す
+    static Summary scan(QStringView line);
+
+    /// 表示する行の添字を昇順で返す（空行は含めない）
+    QList<qsizetype> select(const QStringList& batch);
+
+    /// 探索開始時に評価値の種類の履歴を消す
+    void reset();
+
+private:
+    QHash<int, ScoreKind> m_lastScoreKind; ///< multipv ごとの直前の評価値の種類
+};
+
+#endif // INFOLINECOALESCER_H
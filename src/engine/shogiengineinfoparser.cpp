@@ -40,66 +40,11 @@ QString ShogiEngineInfoParser::searchedHand() const
     return m_searchedHand;
 }
 
-void ShogiEngineInfoParser::setScoreMate(const QString& newScoremate)
-{
-    m_scoreMate = newScoremate;
-}
-
-QString ShogiEngineInfoParser::hashfull() const
-{
-    return m_hashfull;
-}
-
 QString ShogiEngineInfoParser::pvKanjiStr() const
 {
     return m_pvKanjiStr;
 }
 
-QString ShogiEngineInfoParser::pvUsiStr() const
-{
-    return m_pvUsiStr;
-}
-
-QString ShogiEngineInfoParser::scoreMate() const
-{
-    return m_scoreMate;
-}
-
-QString ShogiEngineInfoParser::scoreCp() const
-{
-    return m_scoreCp;
-}
-
-QString ShogiEngineInfoParser::time() const
-{
-    return m_time;
-}
-
-QString ShogiEngineInfoParser::nps() const
-{
-    return m_nps;
-}
-
-QString ShogiEngineInfoParser::nodes() const
-{
-    return m_nodes;
-}
-
-QString ShogiEngineInfoParser::multipv() const
-{
-    return m_multipv;
-}
-
-QString ShogiEngineInfoParser::seldepth() const
-{
-    return m_seldepth;
-}
-
-QString ShogiEngineInfoParser::depth() const
-{
-    return m_depth;
-}
-
 // ============================================================
 // 指し手の漢字変換
 // ============================================================
@@ -199,17 +144,12 @@ ShogiGameController::Player ShogiEngineInfoParser::thinkingStartPlayer() const
 // info行解析
 // ============================================================
 
-QString ShogiEngineInfoParser::convertCurrMoveToKanjiNotation(const QString& str, const ShogiGameController* algorithm, QList<QChar>& clonedBoardData,
+QString ShogiEngineInfoParser::convertCurrMoveToKanjiNotation(quint32 move, const QList<QChar>& clonedBoardData,
                                                               const bool isPondering)
 {
     int fileFrom = 0, rankFrom = 0, fileTo = 0, rankTo = 0;
     bool promote = false;
-
-    const int rc = parseMoveString(str, fileFrom, rankFrom, fileTo, rankTo, promote);
-    if (rc < 0) {
-        return QString();
-    }
-    if (rc == INFO_STRING_SPECIAL_CASE) {
+    if (!decodePackedMove(move, fileFrom, rankFrom, fileTo, rankTo, promote)) {
         return QString();
     }
 
@@ -219,140 +159,45 @@ QString ShogiEngineInfoParser::convertCurrMoveToKanjiNotation(const QString& str
         return QString();
     }
 
-    return convertMoveToShogiString(kanjiMovePiece, fileFrom, rankFrom, fileTo, rankTo, promote, algorithm, 0, isPondering);
+    return convertMoveToShogiString(kanjiMovePiece, fileFrom, rankFrom, fileTo, rankTo, promote, nullptr, 0, isPondering);
 }
 
-void ShogiEngineInfoParser::parseEngineInfoTokens(const QStringList& tokens, const ShogiGameController* algorithm, QList<QChar>& clonedBoardData,
-                                                  const bool isPondering)
+void ShogiEngineInfoParser::parseEngineOutputAndUpdateState(QStringView line, const QList<QChar>& clonedBoardData,
+                                                            const bool isPondering)
 {
-    for (int i = 0; i < tokens.count() - 1; i++) {
-        const QString& token = tokens.at(i);
-        const QString& nextToken = tokens.at(i + 1);
-
-        if (token == "depth") {
-            m_depth = nextToken;
-        } else if (token == "seldepth") {
-            m_seldepth = nextToken;
-        } else if (token == "multipv") {
-            m_multipv = nextToken;
-        } else if (token == "nodes") {
-            m_nodes = nextToken;
-        } else if (token == "nps") {
-            m_nps = nextToken;
-        } else if (token == "time") {
-            m_time = nextToken;
-        } else if (token == "hashfull") {
-            m_hashfull = nextToken;
-        } else if (token == "currmove") {
-            m_searchedHand =  convertCurrMoveToKanjiNotation(nextToken, algorithm, clonedBoardData, isPondering);
-        } else if (token == "score") {
-            parseScore(tokens, i);
-        }
-    }
-}
+    clearParsedInfo();
 
-void ShogiEngineInfoParser::parseScore(const QStringList &tokens, int index)
-{
-    if (index + 2 >= tokens.count()) {
+    // info行を型付きの UsiInfo に解析（例: "info depth 4 seldepth 4 ... pv 8e8f 8g8f 8b8f P*8g"）
+    if (!UsiInfoParser::parse(line, m_usiInfo)) {
         return;
     }
 
-    const QString& type = tokens.at(index + 1);
-    const QString& value = tokens.at(index + 2);
-
-    if (type == "cp") {
-        m_scoreCp = value;
-        m_evaluationBound = EvaluationBound::None;
-        if (index + 3 < tokens.count()) {
-            const QString& boundType = tokens.at(index + 3);
-            if (boundType == "lowerbound") {
-                setEvaluationBound(EvaluationBound::LowerBound);
-            } else if (boundType == "upperbound") {
-                setEvaluationBound(EvaluationBound::UpperBound);
-            }
-        }
-    } else if (type == "mate") {
-        m_scoreMate = value;
+    if (m_usiInfo.has(UsiInfo::Currmove)) {
+        m_searchedHand = convertCurrMoveToKanjiNotation(m_usiInfo.currmove, clonedBoardData, isPondering);
     }
-}
-
-ShogiEngineInfoParser::EvaluationBound ShogiEngineInfoParser::evaluationBound() const
-{
-    return m_evaluationBound;
-}
-
-void ShogiEngineInfoParser::setEvaluationBound(EvaluationBound newEvaluationBound)
-{
-    m_evaluationBound = newEvaluationBound;
-}
-
-// ============================================================
-// メインエントリ: info行全体の解析
-// ============================================================
-
-void ShogiEngineInfoParser::parseEngineOutputAndUpdateState(const QString& line, const ShogiGameController* algorithm,
-                                                            QList<QChar>& clonedBoardData, const bool isPondering)
-{
-    clearParsedInfo();
 
-    QString normalizedLine = line;
-    while (!normalizedLine.isEmpty()) {
-        const QChar tail = normalizedLine.back();
-        if (tail == QLatin1Char('\n') || tail == QLatin1Char('\r')) {
-            normalizedLine.chop(1);
-            continue;
-        }
-        break;
-    }
-
-    // info行を空白で分割（例: "info depth 4 seldepth 4 ... pv 8e8f 8g8f 8b8f P*8g"）
-    const QStringList tokens = normalizedLine.split(QLatin1Char(' '), Qt::SkipEmptyParts);
-    if (tokens.isEmpty()) {
+    if (m_usiInfo.pvLength == 0) {
+        // pvが含まれていない場合（info stringなど）は読み筋として表示しない
         return;
     }
 
-    parseEngineInfoTokens(tokens, algorithm, clonedBoardData, isPondering);
+    QList<QChar> pvBoardCopy = clonedBoardData;
+    const bool simulated = simulatePvMoves(pvBoardCopy, isPondering);
 
-    const qsizetype pvIndex = tokens.indexOf(QStringLiteral("pv"));
-    if (pvIndex < 0 || pvIndex + 1 >= tokens.size()) {
-        // pvが含まれていない場合（info stringなど）は読み筋として表示しない
-        return;
+    // 切り詰めた読み筋は続きがあることを示す
+    if (simulated && m_usiInfo.pvTruncated) {
+        m_pvKanjiStr += QStringLiteral(" …");
     }
 
-    const QStringList pvTokens = tokens.mid(pvIndex + 1);
-    QList<QChar> pvBoardCopy = clonedBoardData;
-    parsePvAndSimulateMoves(pvTokens, algorithm, pvBoardCopy, isPondering);
+    // 末尾の "(57.54%)" 等はそのまま付加する
+    if (simulated && m_usiInfo.pvTailOffset >= 0) {
+        m_pvKanjiStr += QLatin1Char(' ') + line.sliced(m_usiInfo.pvTailOffset, m_usiInfo.pvTailLength).toString();
+    }
 }
 
 void ShogiEngineInfoParser::clearParsedInfo()
 {
-    m_depth.clear();
-    m_seldepth.clear();
-    m_multipv.clear();
-    m_nodes.clear();
-    m_nps.clear();
-    m_time.clear();
-    m_score.clear();
-    m_string.clear();
-    m_scoreCp.clear();
-    m_scoreMate.clear();
+    m_usiInfo.clear();
     m_pvKanjiStr.clear();
-    m_pvUsiStr.clear();
-    m_hashfull.clear();
     m_searchedHand.clear();
-    m_evaluationBound = EvaluationBound::None;
-}
-
-// ============================================================
-// 評価値
-// ============================================================
-
-void ShogiEngineInfoParser::setScore(const QString &newScore)
-{
-    m_score = newScore;
-}
-
-QString ShogiEngineInfoParser::score() const
-{
-    return m_score;
 }
@@ -10,12 +10,13 @@
 #include <optional>
 #include "shogigamecontroller.h"
 #include "boardconstants.h"
+#include "usiinfo.h"
 
 /**
  * @brief USIエンジンが出力するinfo行を解析し、読み筋を漢字表記に変換するクラス
  *
- * info行のサブコマンド（depth, score cp, pv等）を解析し、
- * 盤面コピー上で指し手をシミュレートして漢字表記の読み筋文字列を生成する。
+ * info行は UsiInfoParser で型付きの UsiInfo に解析し（ヒープ確保なし）、
+ * 盤面コピー上で読み筋の指し手をシミュレートして漢字表記の読み筋文字列を生成する。
  *
  */
 class ShogiEngineInfoParser : public QObject
@@ -25,16 +26,6 @@ class ShogiEngineInfoParser : public QObject
 public:
     ShogiEngineInfoParser();
 
-    /// 評価値の境界を表す列挙型
-    enum class EvaluationBound {
-        None,       ///< 境界なし（確定値）
-        LowerBound, ///< 下限値（実際にはその値を上回る可能性がある）
-        UpperBound  ///< 上限値（実際にはその値を下回る可能性がある）
-    };
-
-    EvaluationBound evaluationBound() const;
-    void setEvaluationBound(EvaluationBound newEvaluationBound);
-
     static constexpr int BOARD_SIZE = BoardConstants::kBoardSize;                       ///< 盤面の1辺のマス数
     static constexpr int NUM_BOARD_SQUARES = BoardConstants::kNumBoardSquares; ///< 将棋盤の総マス数
     static constexpr int STAND_FILE = 99;                   ///< 駒台を示す筋番号
@@ -51,42 +42,22 @@ public:
      * USI形式の読み筋（例: "7g7h 2f2e 8e8f"）を解析し、
      * 漢字表記（例: "△７八馬(77)▲２五歩(26)△８六歩(85)"）に変換する。
      */
-    void parseEngineOutputAndUpdateState(const QString& line, const ShogiGameController* algorithm,  QList<QChar>& clonedBoardData,
-                                         const bool isPondering);
+    void parseEngineOutputAndUpdateState(QStringView line, const QList<QChar>& clonedBoardData, const bool isPondering);
 
     void setThinkingStartPlayer(ShogiGameController::Player player);
     ShogiGameController::Player thinkingStartPlayer() const;
 
     // --- 解析結果アクセサ ---
 
-    QString depth() const;
-    QString seldepth() const;
-
-    /// pvで初手の異なる複数の読み筋のうち、何番目に良い読み筋かを返す
-    QString multipv() const;
-
-    QString nodes() const;
-    QString nps() const;
-    QString time() const;
-    QString scoreCp() const;
-    QString scoreMate() const;
+    /// 型付きの解析結果（深さ・ノード数・評価値・読み筋の指し手など）
+    const UsiInfo& usiInfo() const { return m_usiInfo; }
 
     /// 漢字表記の読み筋文字列を返す
     QString pvKanjiStr() const;
 
-    /// USI形式のスペース区切り読み筋文字列を返す
-    QString pvUsiStr() const;
-
-    /// 現在思考中の手（currmoveの漢字変換結果）
-    QString currmove() const;
-
-    QString hashfull() const;
-
     /// GUIの「探索手」欄に表示する読み筋の先頭手
     QString searchedHand() const;
 
-    void setScoreMate(const QString& newScoremate);
-
     /// bestmoveの予想手を漢字表記に変換する
     QString convertPredictedMoveToKanjiString(const ShogiGameController* algorithm, QString& predictedOpponentMove, QList<QChar>& clonedBoardData);
 
@@ -96,23 +67,9 @@ public:
     /// 盤面データをデバッグ出力する
     void printShogiBoard(const QList<QChar>& boardData) const;
 
-    void setScore(const QString& newScore);
-    QString score() const;
-
 private:
-    QString m_depth;            ///< 探索深さ
-    QString m_seldepth;         ///< 選択的探索深さ
-    QString m_multipv;          ///< MultiPVのインデックス
-    QString m_nodes;            ///< 探索ノード数
-    QString m_nps;              ///< 1秒あたりの探索局面数
-    QString m_time;             ///< 思考開始からの経過時間（ミリ秒）
-    QString m_score;            ///< 評価値文字列
-    QString m_string;           ///< info stringサブコマンドの値
-    QString m_scoreCp;          ///< 評価値（centipawn）
-    QString m_scoreMate;        ///< 詰み手数
+    UsiInfo m_usiInfo;          ///< 型付きの解析結果（行ごとに上書き）
     QString m_pvKanjiStr;       ///< 漢字表記の読み筋文字列
-    QString m_pvUsiStr;         ///< USI形式の読み筋文字列
-    QString m_hashfull;         ///< ハッシュ使用率（千分率）
     QString m_searchedHand;     ///< 探索手（読み筋の先頭手）
     int m_previousFileTo = 0;   ///< 直前の指し手の筋
     int m_previousRankTo = 0;   ///< 直前の指し手の段
@@ -122,8 +79,6 @@ private:
     QMap<QChar, int> m_pieceCharToIntMap;   ///< 駒文字 → 駒台の段番号
     QMap<QChar, QString> m_pieceMapping;    ///< 駒文字 → 漢字の駒名
 
-    EvaluationBound m_evaluationBound = EvaluationBound::None; ///< 評価値の境界種別
-
     /// 思考開始時の手番（info処理中は局面更新の影響を受けない）
     ShogiGameController::Player m_thinkingStartPlayer = ShogiGameController::Player1;
 
@@ -168,20 +123,14 @@ private:
     /// 駒を移動して盤面コピーを更新する
     void movePieceToSquare(QList<QChar>& boardData, QChar movingPiece, int fileFrom, int rankFrom, int fileTo, int rankTo, bool promote) const;
 
-    /// info行のトークンを順に解析し、各サブコマンドの値を取得する
-    void parseEngineInfoTokens(const QStringList& tokens, const ShogiGameController* algorithm, QList<QChar>& clonedBoardData,
-                               const bool isPondering);
-
-    /// pvトークンを順に解析し、盤面コピー上で指し手をシミュレートする
-    int parsePvAndSimulateMoves(const QStringList& pvstr, const ShogiGameController* m_algorithm, QList<QChar>& copyBoardData,
-                                const bool isPondering);
+    /// UsiPackedMove をマス座標と成フラグに戻す（駒打ちは fileFrom=STAND_FILE）
+    bool decodePackedMove(quint32 move, int& fileFrom, int& rankFrom, int& fileTo, int& rankTo, bool& promote);
 
-    /// score cp / score mate / lowerbound / upperbound を解析する
-    void parseScore(const QStringList& tokens, int index);
+    /// 読み筋を盤面コピー上でシミュレートし、漢字表記を組み立てる（途中で変換できなければ false）
+    bool simulatePvMoves(QList<QChar>& boardData, const bool isPondering);
 
-    /// currmoveサブコマンドの指し手を漢字表記に変換する
-    QString convertCurrMoveToKanjiNotation(const QString& str, const ShogiGameController* algorithm, QList<QChar>& clonedBoardData,
-                                           const bool isPondering);
+    /// currmoveの指し手を漢字表記に変換する
+    QString convertCurrMoveToKanjiNotation(quint32 move, const QList<QChar>& clonedBoardData, const bool isPondering);
 
     /// 1行ごとの解析結果を初期化する（再利用時の状態リーク防止）
     void clearParsedInfo();
@@ -211,45 +211,49 @@ void ShogiEngineInfoParser::movePieceToSquare(QList<QChar>& boardData, QChar mov
 // PV解析・盤面シミュレーション
 // ============================================================
 
-int ShogiEngineInfoParser::parsePvAndSimulateMoves(const QStringList& pvTokens, const ShogiGameController* algorithm, QList<QChar>& clonedBoardData,
-                                                   const bool isPondering)
+bool ShogiEngineInfoParser::decodePackedMove(quint32 move, int& fileFrom, int& rankFrom, int& fileTo, int& rankTo,
+                                             bool& promote)
+{
+    fileTo = UsiPackedMove::fileTo(move);
+    rankTo = UsiPackedMove::rankTo(move);
+    promote = UsiPackedMove::isPromotion(move);
+
+    if (!UsiPackedMove::isDrop(move)) {
+        fileFrom = UsiPackedMove::fileFrom(move);
+        rankFrom = UsiPackedMove::rankFrom(move);
+        return move != 0;
+    }
+
+    // 駒打ち（例: "G*5b"）は駒台の段番号で表す
+    const auto standPieceNumber = convertPieceToStandRank(QChar::fromLatin1(UsiPackedMove::dropPiece(move)));
+    if (!standPieceNumber.has_value()) {
+        return false;
+    }
+    fileFrom = STAND_FILE;
+    rankFrom = *standPieceNumber;
+    return true;
+}
+
+bool ShogiEngineInfoParser::simulatePvMoves(QList<QChar>& boardData, const bool isPondering)
 {
     int fileFrom = 0, rankFrom = 0, fileTo = 0, rankTo = 0;
     bool promote = false;
 
     m_pvKanjiStr.clear();
-    m_pvUsiStr.clear();
-
-    QStringList validUsiMoves;
-    for (qsizetype i = 0; i < pvTokens.size(); ++i) {
-        const QString& token = pvTokens.at(i);
-
-        const int rc = parseMoveString(token, fileFrom, rankFrom, fileTo, rankTo, promote);
-        if (rc == INFO_STRING_SPECIAL_CASE) {
-            if (i == pvTokens.size() - 1) {
-                // 末尾の "(57.54%)" 等はそのまま付加して終了
-                m_pvKanjiStr += " " + token;
-                // m_pvUsiStr には非指し手トークンを含めない
-                m_pvUsiStr = validUsiMoves.join(QStringLiteral(" "));
-                return 0;
-            }
-            m_pvUsiStr = validUsiMoves.join(QStringLiteral(" "));
-            return -1;
-        }
-        if (rc < 0) {
-            m_pvUsiStr = validUsiMoves.join(QStringLiteral(" "));
-            return -1;
+
+    for (int i = 0; i < m_usiInfo.pvLength; ++i) {
+        if (!decodePackedMove(m_usiInfo.pv[i], fileFrom, rankFrom, fileTo, rankTo, promote)) {
+            return false;
         }
-        validUsiMoves.append(token);
 
-        const QChar movingPiece = pieceCharacter(clonedBoardData, fileFrom, rankFrom);
+        const QChar movingPiece = pieceCharacter(boardData, fileFrom, rankFrom);
         const QString kanjiMovePiece = pieceKanjiName(movingPiece);
         if (kanjiMovePiece.isEmpty()) {
-            return -1;
+            return false;
         }
 
-        const QString shogiStr = convertMoveToShogiString(kanjiMovePiece, fileFrom, rankFrom, fileTo, rankTo, promote,
-                                                          algorithm, static_cast<int>(i), isPondering);
+        const QString shogiStr =
+            convertMoveToShogiString(kanjiMovePiece, fileFrom, rankFrom, fileTo, rankTo, promote, nullptr, i, isPondering);
 
         setPreviousFileTo(fileTo);
         setPreviousRankTo(rankTo);
@@ -258,11 +262,10 @@ int ShogiEngineInfoParser::parsePvAndSimulateMoves(const QStringList& pvTokens,
 
         if (i == 0) m_searchedHand = shogiStr;
 
-        movePieceToSquare(clonedBoardData, movingPiece, fileFrom, rankFrom, fileTo, rankTo, promote);
+        movePieceToSquare(boardData, movingPiece, fileFrom, rankFrom, fileTo, rankTo, promote);
     }
 
-    m_pvUsiStr = validUsiMoves.join(QStringLiteral(" "));
-    return 0;
+    return true;
 }
 
 void ShogiEngineInfoParser::parseAndApplyMoveToClonedBoard(const QString& str, QList<QChar>& clonedBoardData)
@@ -6,6 +6,7 @@
 #include "shogiengineinfoparser.h"
 #include "shogigamecontroller.h"
 
+#include <QThread>
 #include <QTimer>
 #include <memory>
 #include <utility>
@@ -17,7 +18,15 @@ ThinkingInfoPresenter::ThinkingInfoPresenter(QObject* parent)
 {
 }
 
-ThinkingInfoPresenter::~ThinkingInfoPresenter() = default;
+ThinkingInfoPresenter::~ThinkingInfoPresenter()
+{
+    if (m_conversionThread) {
+        m_conversionThread->requestInterruption();
+        m_conversionThread->quit();
+        m_conversionThread->wait();
+        m_conversionWorker.reset();
+    }
+}
 
 // ============================================================
 // 依存関係設定
@@ -83,62 +92,139 @@ QString ThinkingInfoPresenter::baseSfen() const
 void ThinkingInfoPresenter::onInfoReceived(const QString& line)
 {
     m_infoBuffer.append(line);
+    ++m_infoLinesReceived;
 
     if (!m_flushScheduled) {
         m_flushScheduled = true;
-        QTimer::singleShot(50, this, &ThinkingInfoPresenter::flushInfoBuffer);
+        QTimer::singleShot(50, this, &ThinkingInfoPresenter::submitInfoBuffer);
     }
 }
 
-void ThinkingInfoPresenter::flushInfoBuffer()
+QStringList ThinkingInfoPresenter::takeCoalescedLines()
 {
-    m_flushScheduled = false;
-
     QStringList batch;
     batch.swap(m_infoBuffer);
 
-    for (const QString& line : std::as_const(batch)) {
-        if (!line.isEmpty()) {
-            processInfoLineInternal(line);
+    // 同じ multipv の読み筋はすぐ次の行で上書きされるので、残す行だけを漢字変換する
+    const QList<qsizetype> selected = m_coalescer.select(batch);
+    QStringList lines;
+    lines.reserve(selected.size());
+    for (const qsizetype index : selected) {
+        lines.append(batch.at(index));
+    }
+
+    qCDebug(lcEngine) << "takeCoalescedLines: batch=" << batch.size() << "selected=" << lines.size()
+                      << "total received=" << m_infoLinesReceived << "rendered=" << m_infoLinesRendered;
+    return lines;
+}
+
+InfoConversionContext ThinkingInfoPresenter::conversionContext() const
+{
+    InfoConversionContext context;
+    context.boardData = m_clonedBoardData;
+    context.previousFileTo = m_previousFileTo;
+    context.previousRankTo = m_previousRankTo;
+    context.startPlayerIsP1 = m_thinkingStartPlayerIsP1;
+    context.ponderEnabled = m_ponderEnabled;
+    context.baseSfen = m_baseSfen;
+
+    // 棋譜解析モードでは先手から見た評価値にそろえる（手番はこの時点の局面で決める）
+    if (m_gameController && m_analysisMode) {
+        context.scoreSign = m_gameController->currentPlayer() == ShogiGameController::Player2 ? -1 : 1;
+    }
+    context.showScoreBound = m_gameController && !m_analysisMode;
+    return context;
+}
+
+void ThinkingInfoPresenter::ensureConversionWorker()
+{
+    if (m_conversionThread) return;
+
+    m_conversionThread = new QThread(this);
+    m_conversionWorker = std::make_unique<InfoConversionWorker>();
+    m_conversionWorker->moveToThread(m_conversionThread);
+
+    connect(this, &ThinkingInfoPresenter::infoBatchSubmitted,
+            m_conversionWorker.get(), &InfoConversionWorker::convertBatch,
+            Qt::QueuedConnection);
+    connect(m_conversionWorker.get(), &InfoConversionWorker::convertedReady,
+            this, &ThinkingInfoPresenter::drainConvertedInfo,
+            Qt::QueuedConnection);
+
+    m_conversionThread->start();
+}
+
+void ThinkingInfoPresenter::submitInfoBuffer()
+{
+    m_flushScheduled = false;
+
+    const QStringList lines = takeCoalescedLines();
+    if (lines.isEmpty()) return;
+
+    // 解析と漢字変換はワーカースレッドで行い、結果は drainConvertedInfo() で反映する
+    ensureConversionWorker();
+    InfoConversionBatch batch;
+    batch.generation = m_generation;
+    batch.context = conversionContext();
+    batch.lines = lines;
+    m_conversionWorker->beginBatch();
+    emit infoBatchSubmitted(batch);
+}
+
+void ThinkingInfoPresenter::drainConvertedInfo()
+{
+    if (!m_conversionWorker) return;
+
+    QList<ConvertedInfo> records = m_conversionWorker->takeConverted();
+    for (ConvertedInfo& info : records) {
+        // クリア前に投入したバッチの結果は捨てる
+        if (info.generation != m_generation) continue;
+        applyConvertedInfo(info);
+    }
+}
+
+void ThinkingInfoPresenter::flushInfoBuffer()
+{
+    // 処理フロー（評価値グラフ等が直後に lastScoreCp() を読むため同期で反映する）:
+    // 1. 投入済みのバッチの変換完了を待ち、到着順に反映する
+    //    （待機中もキューを取り出し、ワーカーが満杯で止まらないようにする）
+    // 2. 未投入の行はこのスレッドで変換して反映する
+    m_flushScheduled = false;
+
+    if (m_conversionWorker) {
+        while (!m_conversionWorker->waitForIdle(kFlushWaitSliceMs)) {
+            drainConvertedInfo();
         }
+        drainConvertedInfo();
+    }
+
+    const QStringList lines = takeCoalescedLines();
+    const InfoConversionContext context = conversionContext();
+    for (const QString& line : lines) {
+        ConvertedInfo info = InfoConversionWorker::convertLine(*m_infoParser, line, context);
+        applyConvertedInfo(info);
     }
 }
 
 void ThinkingInfoPresenter::processInfoLine(const QString& line)
 {
-    processInfoLineInternal(line);
+    ConvertedInfo info = InfoConversionWorker::convertLine(*m_infoParser, line, conversionContext());
+    applyConvertedInfo(info);
 }
 
-void ThinkingInfoPresenter::processInfoLineInternal(const QString& line)
+void ThinkingInfoPresenter::applyConvertedInfo(ConvertedInfo& info)
 {
     // 処理フロー:
-    // 1. ShogiEngineInfoParserを生成し、前回指し手・手番を設定
-    // 2. info行をパースして盤面情報と合わせて解析
-    // 3. 探索手・深さ・ノード数・NPS・ハッシュ使用率のシグナルを発行
-    // 4. 評価値/詰み手数を更新
-    // 5. 有効な情報があれば思考タブ向けの統合シグナルを発行
+    // 1. 探索手・深さ・ノード数・NPS・ハッシュ使用率のシグナルを発行
+    // 2. 評価値/詰み手数を更新
+    // 3. 有効な情報があれば思考タブ向けの統合シグナルを発行
 
-    qCDebug(lcEngine) << "processInfoLine: boardSize=" << m_clonedBoardData.size()
-                      << "isP1=" << m_thinkingStartPlayerIsP1
-                      << "prevFile=" << m_previousFileTo << "prevRank=" << m_previousRankTo;
+    qCDebug(lcEngine) << "applyConvertedInfo: isP1=" << m_thinkingStartPlayerIsP1
+                      << "multipv=" << info.usi.multipv << "depth=" << info.usi.depth;
 
+    ++m_infoLinesRendered;
     int scoreInt = 0;
 
-    ShogiEngineInfoParser* info = m_infoParser.get();
-    if (!info) {
-        return;
-    }
-
-    info->setPreviousFileTo(m_previousFileTo);
-    info->setPreviousRankTo(m_previousRankTo);
-    
-    // 思考開始時の手番を設定（bestmove後の局面更新の影響を受けないようにする）
-    ShogiGameController::Player startPlayer = m_thinkingStartPlayerIsP1 
-        ? ShogiGameController::Player1 
-        : ShogiGameController::Player2;
-    info->setThinkingStartPlayer(startPlayer);
-    info->parseEngineOutputAndUpdateState(line, m_gameController, m_clonedBoardData, m_ponderEnabled);
-
     // シグナル経由でGUI項目を更新
     emitSearchedHand(info);
     emitDepth(info);
@@ -150,21 +236,22 @@ void ThinkingInfoPresenter::processInfoLineInternal(const QString& line)
     updateEvaluationInfo(info, scoreInt);
 
     // 思考タブへ追記するシグナルを発行
-    if (!info->time().isEmpty() || !info->depth().isEmpty() ||
-        !info->nodes().isEmpty() || !info->score().isEmpty() ||
-        !info->pvKanjiStr().isEmpty()) {
-
-        // multipv値を取得（空の場合は1とみなす）
-        int multipv = 1;
-        if (!info->multipv().isEmpty()) {
-            multipv = info->multipv().toInt();
-            if (multipv < 1) multipv = 1;
-        }
-
-        emit thinkingInfoUpdated(info->time(), info->depth(),
-                                 info->nodes(), info->score(),
-                                 info->pvKanjiStr(), info->pvUsiStr(),
-                                 m_baseSfen, multipv, scoreInt);
+    // 数値の文字列化はここ（間引き後に表示する行）でだけ行う
+    const UsiInfo& usi = info.usi;
+    if (usi.has(UsiInfo::Time) || usi.has(UsiInfo::Depth) ||
+        usi.has(UsiInfo::Nodes) || !info.score.isEmpty() ||
+        !info.pvKanjiStr.isEmpty()) {
+
+        // 切り詰めた読み筋は元の行の残りをつないで全手を渡す
+        const QString pvUsi = info.pvUsiRest.isEmpty() ? usi.pvUsiString()
+                                                       : usi.pvUsiString() + QLatin1Char(' ') + info.pvUsiRest;
+        // multipv値（省略時は1）はパーサで補正済み
+        emit thinkingInfoUpdated(usi.has(UsiInfo::Time) ? QString::number(usi.time) : QString(),
+                                 usi.has(UsiInfo::Depth) ? QString::number(usi.depth) : QString(),
+                                 usi.has(UsiInfo::Nodes) ? QString::number(usi.nodes) : QString(),
+                                 info.score,
+                                 info.pvKanjiStr, pvUsi,
+                                 info.baseSfen, usi.multipv, scoreInt);
     }
 }
 
@@ -172,6 +259,8 @@ void ThinkingInfoPresenter::requestClearThinkingInfo()
 {
     qCDebug(lcEngine) << "requestClearThinkingInfo";
     m_infoBuffer.clear();
+    m_coalescer.reset();
+    ++m_generation;
     emit clearThinkingInfoRequested();
 }
 
@@ -217,49 +306,44 @@ void ThinkingInfoPresenter::logStderrData(const QString& prefix, const QString&
 // シグナル発行ヘルパメソッド
 // ============================================================
 
-void ThinkingInfoPresenter::emitSearchedHand(const ShogiEngineInfoParser* info)
+void ThinkingInfoPresenter::emitSearchedHand(const ConvertedInfo& info)
 {
-    if (!info->searchedHand().isEmpty()) {
-        emit searchedMoveUpdated(info->searchedHand());
+    if (!info.searchedHand.isEmpty()) {
+        emit searchedMoveUpdated(info.searchedHand);
     }
 }
 
-void ThinkingInfoPresenter::emitDepth(const ShogiEngineInfoParser* info)
+void ThinkingInfoPresenter::emitDepth(const ConvertedInfo& info)
 {
-    if (info->depth().isEmpty()) return;
+    if (!info.usi.has(UsiInfo::Depth)) return;
 
-    QString depthStr;
-    if (info->seldepth().isEmpty()) {
-        depthStr = info->depth();
-    } else {
-        depthStr = info->depth() + "/" + info->seldepth();
+    QString depthStr = QString::number(info.usi.depth);
+    if (info.usi.has(UsiInfo::Seldepth)) {
+        depthStr += "/" + QString::number(info.usi.seldepth);
     }
     emit searchDepthUpdated(depthStr);
 }
 
-void ThinkingInfoPresenter::emitNodes(const ShogiEngineInfoParser* info)
+void ThinkingInfoPresenter::emitNodes(const ConvertedInfo& info)
 {
-    if (info->nodes().isEmpty()) return;
+    if (!info.usi.has(UsiInfo::Nodes)) return;
 
-    unsigned long long nodes = info->nodes().toULongLong();
-    emit nodeCountUpdated(m_locale.toString(nodes));
+    emit nodeCountUpdated(m_locale.toString(info.usi.nodes));
 }
 
-void ThinkingInfoPresenter::emitNps(const ShogiEngineInfoParser* info)
+void ThinkingInfoPresenter::emitNps(const ConvertedInfo& info)
 {
-    if (info->nps().isEmpty()) return;
+    if (!info.usi.has(UsiInfo::Nps)) return;
 
-    unsigned long long nps = info->nps().toULongLong();
-    emit npsUpdated(m_locale.toString(nps));
+    emit npsUpdated(m_locale.toString(info.usi.nps));
 }
 
-void ThinkingInfoPresenter::emitHashfull(const ShogiEngineInfoParser* info)
+void ThinkingInfoPresenter::emitHashfull(const ConvertedInfo& info)
 {
-    if (info->hashfull().isEmpty()) {
+    if (!info.usi.has(UsiInfo::Hashfull)) {
         emit hashUsageUpdated("");
     } else {
-        unsigned long long hash = info->hashfull().toULongLong() / 10;
-        emit hashUsageUpdated(QString::number(hash) + "%");
+        emit hashUsageUpdated(QString::number(info.usi.hashfull / 10) + "%");
     }
 }
 
@@ -271,47 +355,33 @@ void ThinkingInfoPresenter::emitHashfull(const ShogiEngineInfoParser* info)
 // VALUE_SUPERIOR == 28000, PawnValue == 90, centi-pawn換算で100/90倍 → 約31111
 static constexpr int SCORE_MATE_VALUE = 31111;
 
-int ThinkingInfoPresenter::calculateScoreInt(const ShogiEngineInfoParser* info) const
+int ThinkingInfoPresenter::calculateScoreInt(const ConvertedInfo& info) const
 {
     int scoreInt = 0;
 
-    // score mate の値がプラス（勝ち）または "+" の場合
-    if ((info->scoreMate().toLongLong() > 0) || (info->scoreMate() == "+")) {
+    // score mate の値がプラス（勝ち）または "+" の場合（"+" は scoreValue = 1）
+    if (info.usi.scoreValue > 0) {
         scoreInt = SCORE_MATE_VALUE;
     }
     // score mate の値がマイナス（負け）または "-" の場合
-    else if ((info->scoreMate().toLongLong() < 0) || (info->scoreMate() == "-")) {
+    else if (info.usi.scoreValue < 0) {
         scoreInt = -SCORE_MATE_VALUE;
     }
 
     return scoreInt;
 }
 
-void ThinkingInfoPresenter::updateAnalysisModeAndScore(const ShogiEngineInfoParser* info, int& scoreInt)
+void ThinkingInfoPresenter::updateAnalysisModeAndScore(const ConvertedInfo& info, int& scoreInt)
 {
-    if (!m_gameController) {
-        m_scoreStr = info->scoreCp();
-        scoreInt = m_scoreStr.toInt();
-        return;
-    }
-
-    if (m_analysisMode) {
-        if (m_gameController->currentPlayer() == ShogiGameController::Player1) {
-            scoreInt = info->scoreCp().toInt();
-            m_scoreStr = info->scoreCp();
-        } else if (m_gameController->currentPlayer() == ShogiGameController::Player2) {
-            scoreInt = -info->scoreCp().toInt();
-            m_scoreStr = QString::number(scoreInt);
-        }
-    } else {
-        m_scoreStr = info->scoreCp();
-        scoreInt = m_scoreStr.toInt();
-
-        if (info->evaluationBound() == ShogiEngineInfoParser::EvaluationBound::LowerBound) {
-            m_scoreStr += "++";
-        } else if (info->evaluationBound() == ShogiEngineInfoParser::EvaluationBound::UpperBound) {
-            m_scoreStr += "--";
-        }
+    // 符号と印は変換を投入した時点の状態（ConvertedInfo）に従う
+    scoreInt = info.scoreSign * info.usi.scoreValue;
+    m_scoreStr = QString::number(scoreInt);
+
+    if (!info.showScoreBound) return;
+    if (info.usi.bound == UsiInfo::Bound::Lower) {
+        m_scoreStr += "++";
+    } else if (info.usi.bound == UsiInfo::Bound::Upper) {
+        m_scoreStr += "--";
     }
 }
 
@@ -335,61 +405,58 @@ void ThinkingInfoPresenter::updateLastScore(int scoreInt)
 
 }
 
-void ThinkingInfoPresenter::updateEvaluationInfo(ShogiEngineInfoParser* info, int& scoreInt)
+void ThinkingInfoPresenter::updateEvaluationInfo(ConvertedInfo& info, int& scoreInt)
 {
     // 処理フロー:
     // 1. multipv番号を確認し、1（または空）のみグラフ更新対象とする
-    // 2. scoreCpが空の場合 → scoreMateを確認し詰み評価値を計算
-    //    - scoreMateも空なら何もしない
+    // 2. score cp がない場合 → score mate を確認し詰み評価値を計算
+    //    - score mate もなければ何もしない
     //    - 詰み表示文字列を生成し、multipv1ならグラフ更新
-    // 3. scoreCpがある場合 → 解析モードに応じて符号反転し評価値を算出
+    // 3. score cp がある場合 → 解析モードに応じて符号反転し評価値を算出
     //    - multipv1ならグラフ・PV文字列を更新
 
     // multipv 1（1行目）の場合のみ評価値グラフを更新
     // multipvが空の場合も更新（単一PVモードの場合）
-    const QString multipv = info->multipv();
-    const QString scoreCp = info->scoreCp();
+    const UsiInfo& usi = info.usi;
+    const int multipv = usi.multipv;
     
     qCDebug(lcEngine) << "updateEvaluationInfo: multipv=" << multipv
-                      << "scoreCp=" << scoreCp
+                      << "scoreValue=" << usi.scoreValue
                       << "before=" << m_lastScoreCp;
     
     // multipv 2以降の場合は、思考タブの表示用にscoreをセットするが、
     // 評価値グラフ（m_lastScoreCp）は更新しない
-    const bool isMultipv1 = multipv.isEmpty() || multipv == "1";
+    const bool isMultipv1 = multipv == 1;
     
-    if (info->scoreCp().isEmpty()) {
+    if (usi.scoreKind == UsiInfo::ScoreKind::None) {
+        // スコア情報がない場合は何もしない
+        return;
+    }
+
+    if (usi.scoreKind == UsiInfo::ScoreKind::Mate) {
         // score mate の場合
-        if (info->scoreMate().isEmpty()) {
-            // スコア情報がない場合は何もしない
-            return;
-        }
-        
         scoreInt = calculateScoreInt(info);
         
-        QString scoreMate = info->scoreMate();
-        if ((scoreMate == "+") || (scoreMate == "-")) {
-            scoreMate = "詰";
+        if (usi.mateDistanceUnknown) {
+            info.score = "詰";
         } else {
-            scoreMate += "手詰";
+            info.score = usi.mateText() + "手詰";
         }
         
-        info->setScore(scoreMate);
-        
         // multipv 1 の場合のみ評価値グラフを更新
         if (isMultipv1) {
-            m_scoreStr = info->scoreMate();
+            m_scoreStr = usi.mateText();
             m_lastScoreCp = scoreInt;
         
         }
     } else {
         // score cp の場合
         updateAnalysisModeAndScore(info, scoreInt);
-        info->setScore(m_scoreStr);
+        info.score = m_scoreStr;
         
         // multipv 1 の場合のみ評価値グラフを更新
         if (isMultipv1) {
-            m_pvKanjiStr = info->pvKanjiStr();
+            m_pvKanjiStr = info.pvKanjiStr;
             qCDebug(lcEngine) << "評価値更新: scoreInt=" << scoreInt << "scoreStr=" << m_scoreStr;
             updateLastScore(scoreInt);
         } else {
@@ -12,6 +12,11 @@
 #include <QPointer>
 #include <memory>
 
+#include "infoconversionworker.h"
+#include "infolinecoalescer.h"
+#include "threadtypes.h"
+
+class QThread;
 class ShogiEngineInfoParser;
 class ShogiGameController;
 
@@ -20,6 +25,7 @@ class ShogiGameController;
  *
  * 責務:
  * - info行の解析結果をシグナルで通知
+ * - info行の解析・漢字読み筋変換をワーカースレッドへ委譲（InfoConversionWorker）
  * - 評価値の計算と更新
  * - 思考情報の通知
  * - USI通信ログの通知
@@ -71,7 +77,7 @@ public:
     /// 思考情報のクリアをリクエスト
     void requestClearThinkingInfo();
     
-    /// バッファリングされたinfo行をフラッシュ
+    /// バッファリングされたinfo行をフラッシュ（変換中の行も含めて同期で反映）
     void flushInfoBuffer();
 
     // --- 通信ログ ---
@@ -96,6 +102,14 @@ public:
     /// 漢字PV文字列を取得
     QString pvKanjiStr() const { return m_pvKanjiStr; }
 
+    // --- 間引き統計 ---
+
+    /// 受信したinfo行数（バッファ経由のみ）
+    qint64 infoLinesReceived() const { return m_infoLinesReceived; }
+
+    /// 間引き後に表示したinfo行数
+    qint64 infoLinesRendered() const { return m_infoLinesRendered; }
+
 public slots:
     /// info行を受信（バッファリング）
     void onInfoReceived(const QString& line);
@@ -114,6 +128,9 @@ signals:
                              const QString& pvKanjiStr, const QString& usiPv,
                              const QString& baseSfen, int multipv, int scoreCp);
     
+    /// 変換待ちのinfo行の投入（→ InfoConversionWorker::convertBatch）
+    void infoBatchSubmitted(const InfoConversionBatch& batch);
+
     /// 思考情報クリアリクエストシグナル（→ Usi::onClearThinkingInfoRequested）
     void clearThinkingInfoRequested();
     
@@ -141,22 +158,41 @@ signals:
     /// 通信ログ追加シグナル（→ Usi::onCommLogAppended）
     void commLogAppended(const QString& log);
 
+private slots:
+    /// バッファの行を間引いてワーカーへ投入する（50ms ごと）
+    void submitInfoBuffer();
+
+    /// ワーカーが変換した行を取り出して反映する
+    void drainConvertedInfo();
+
 private:
-    /// info行を処理する内部メソッド
-    void processInfoLineInternal(const QString& line);
+    /// フラッシュ時に変換完了を待つ1回あたりの時間（ミリ秒）
+    static constexpr int kFlushWaitSliceMs = 5;
+
+    /// バッファを取り出し、表示する行だけを残す
+    QStringList takeCoalescedLines();
+
+    /// 現在の思考開始状態のスナップショット
+    InfoConversionContext conversionContext() const;
+
+    /// 変換ワーカースレッドを必要になった時点で起動する
+    void ensureConversionWorker();
+
+    /// 変換済みの1行をシグナルで通知する
+    void applyConvertedInfo(ConvertedInfo& info);
 
     /// シグナル発行ヘルパメソッド
-    void emitSearchedHand(const ShogiEngineInfoParser* info);
-    void emitDepth(const ShogiEngineInfoParser* info);
-    void emitNodes(const ShogiEngineInfoParser* info);
-    void emitNps(const ShogiEngineInfoParser* info);
-    void emitHashfull(const ShogiEngineInfoParser* info);
+    void emitSearchedHand(const ConvertedInfo& info);
+    void emitDepth(const ConvertedInfo& info);
+    void emitNodes(const ConvertedInfo& info);
+    void emitNps(const ConvertedInfo& info);
+    void emitHashfull(const ConvertedInfo& info);
 
     /// 評価値計算
-    int calculateScoreInt(const ShogiEngineInfoParser* info) const;
-    void updateAnalysisModeAndScore(const ShogiEngineInfoParser* info, int& scoreInt);
+    int calculateScoreInt(const ConvertedInfo& info) const;
+    void updateAnalysisModeAndScore(const ConvertedInfo& info, int& scoreInt);
     void updateLastScore(int scoreInt);
-    void updateEvaluationInfo(ShogiEngineInfoParser* info, int& scoreInt);
+    void updateEvaluationInfo(ConvertedInfo& info, int& scoreInt);
 
 private:
     ShogiGameController* m_gameController = nullptr; ///< 非所有。ゲームコントローラ参照
@@ -180,7 +216,14 @@ private:
 
     QStringList m_infoBuffer;           ///< info行バッファ
     bool m_flushScheduled = false;      ///< フラッシュ予約済みフラグ
-    std::unique_ptr<ShogiEngineInfoParser> m_infoParser; ///< 再利用するinfoパーサ
+    InfoLineCoalescer m_coalescer;      ///< multipv ごとに最新の読み筋だけを残す
+    qint64 m_infoLinesReceived = 0;     ///< 受信したinfo行数
+    qint64 m_infoLinesRendered = 0;     ///< 表示したinfo行数
+    std::unique_ptr<ShogiEngineInfoParser> m_infoParser; ///< 同期フラッシュ用のinfoパーサ
+
+    QThread* m_conversionThread = nullptr;            ///< 変換ワーカースレッド（this所有）
+    std::unique_ptr<InfoConversionWorker> m_conversionWorker; ///< 変換ワーカー（スレッド停止後に破棄）
+    JobGeneration m_generation = 0;                   ///< クリアごとに進める世代
 };
 
 #endif // THINKINGINFOPRESENTER_H
@@ -3,6 +3,7 @@
 
 #include "usi.h"
 #include "usimatchhandler.h"
+#include "engineprocesspool.h"
 
 #include <QTimer>
 
@@ -287,36 +288,92 @@ void Usi::initializeAndStartEngineCommunication(QString& engineFile, QString& en
 
 bool Usi::startAndInitializeEngine(const QString& engineFile, const QString& enginename)
 {
+    m_pooledEngineName.clear();
+
+    // オプション読み込み
+    m_protocolHandler->loadEngineOptions(enginename);
+
+    // 待機中の同じエンジンがあれば、プロセス起動と usi を省く
+    if (adoptWarmEngine(engineFile, enginename)) {
+        m_pooledEngineName = enginename;
+        return true;
+    }
+
     // プロセス起動
     if (!m_processManager->startProcess(engineFile)) {
         cleanupEngineProcessAndThread();
         return false;
     }
 
-    // オプション読み込み
-    m_protocolHandler->loadEngineOptions(enginename);
-
     // 初期化シーケンス実行
     if (!m_protocolHandler->initializeEngine(enginename)) {
         cleanupEngineProcessAndThread();
         return false;
     }
 
+    m_pooledEngineName = enginename;
     return true;
 }
 
 void Usi::cleanupEngineProcessAndThread(bool clearThinking)
 {
-    // エンジンプロセスが実行中の場合は quit コマンドを送信してから停止
-    if (m_processManager->isRunning()) {
-        m_protocolHandler->sendQuit();
+    // 再利用できる状態ならプールへ返し、そうでなければ quit コマンドを送信してから停止
+    if (!releaseToPool()) {
+        if (m_processManager->isRunning()) {
+            m_protocolHandler->sendQuit();
+        }
+        m_processManager->stopProcess();
     }
-    m_processManager->stopProcess();
+    m_pooledEngineName.clear();
     if (clearThinking) {
         m_presenter->requestClearThinkingInfo();
     }
 }
 
+bool Usi::adoptWarmEngine(const QString& engineFile, const QString& enginename)
+{
+    std::optional<EngineProcessPool::WarmEngine> warm =
+        EngineProcessPool::instance().lease(engineFile, enginename);
+    if (!warm) return false;
+
+    if (!m_processManager->adoptProcess(std::move(warm->process), engineFile)) {
+        return false;
+    }
+    // 前回と値の違う setoption だけを送り、readyok で生存を確認する
+    if (!m_protocolHandler->initializeWarmEngine(warm->reportedOptions, warm->appliedOptions)) {
+        qCWarning(lcEngine) << "待機中のエンジンを使えないため再起動します:" << enginename;
+        m_processManager->stopProcess();
+        return false;
+    }
+    return true;
+}
+
+bool Usi::releaseToPool()
+{
+    EngineProcessPool& pool = EngineProcessPool::instance();
+    const QString enginePath = m_processManager->currentEnginePath();
+    if (m_pooledEngineName.isEmpty() || !pool.accepts(enginePath, m_pooledEngineName)) {
+        return false;
+    }
+    // 探索中なら stop だけ送って返し、bestmove/checkmate の読み捨てはプールに任せる
+    // （生存確認は次に借りるときの readyok で行う）
+    if (!m_protocolHandler->prepareForReuse()) {
+        return false;
+    }
+
+    EngineProcessPool::WarmEngine warm;
+    warm.enginePath = enginePath;
+    warm.engineName = m_pooledEngineName;
+    warm.reportedOptions = m_protocolHandler->reportedOptions();
+    warm.appliedOptions = m_protocolHandler->appliedOptions();
+    warm.settling = m_protocolHandler->searchOutstanding();
+    warm.process = m_processManager->takeProcess();
+    if (!warm.process) return false;
+
+    (void)pool.release(std::move(warm));
+    return true;
+}
+
 // ============================================================
 // コマンド送信
 // ============================================================
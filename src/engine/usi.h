@@ -226,6 +226,7 @@ private:
     QPointer<ShogiEngineThinkingModel> m_considerationModel; ///< 検討タブ用モデルへの参照（非所有）
     int m_considerationMaxMultiPV = 1;               ///< 検討タブの最大MultiPV値
     QTimer* m_analysisStopTimer = nullptr;           ///< 検討停止タイマー（所有、動的生成）
+    QString m_pooledEngineName;                      ///< 初期化済みエンジンの設定名（空ならプールへ返さない）
 
     // --- プライベートメソッド ---
 
@@ -233,6 +234,11 @@ private:
     void resetAnalysisStopTimer();
     void prepareAnalysisSession(const QString& positionStr, int multiPV);
 
+    /// EngineProcessPool の待機中エンジンを引き継ぐ（なければ/応答しない・オプションを戻せなければ false）
+    bool adoptWarmEngine(const QString& engineFile, const QString& enginename);
+    /// 探索を終えたエンジンを EngineProcessPool へ返す（探索中など返せなければ false。待機はしない）
+    bool releaseToPool();
+
 private slots:
     /// エンジンプロセスエラー時のクリーンアップ処理
     void onProcessError(QProcess::ProcessError error, const QString& message);
@@ -0,0 +1,339 @@
+/// @file usiinfo.cpp
+/// @brief USI info行の型付きレコードと、ヒープ確保なしのパーサの実装
+
+#include "usiinfo.h"
+
+#include <limits>
+
+// ============================================================
+// UsiPackedMove
+// ============================================================
+
+QString UsiPackedMove::toUsi(quint32 move)
+{
+    if (move == 0) return QString();
+
+    QString usi;
+    usi.reserve(5);
+    if (isDrop(move)) {
+        usi += QLatin1Char(dropPiece(move));
+        usi += QLatin1Char('*');
+    } else {
+        usi += QLatin1Char(char('0' + fileFrom(move)));
+        usi += QLatin1Char(char('a' + rankFrom(move) - 1));
+    }
+    usi += QLatin1Char(char('0' + fileTo(move)));
+    usi += QLatin1Char(char('a' + rankTo(move) - 1));
+    if (isPromotion(move)) usi += QLatin1Char('+');
+    return usi;
+}
+
+// ============================================================
+// UsiInfo
+// ============================================================
+
+void UsiInfo::clear()
+{
+    // pv 配列は pvLength までしか読まないので消さない
+    fields = 0;
+    depth = seldepth = hashfull = 0;
+    multipv = 1;
+    nodes = nps = time = 0;
+    scoreKind = ScoreKind::None;
+    bound = Bound::Exact;
+    scoreValue = 0;
+    mateDistanceUnknown = false;
+    currmove = 0;
+    pvLength = 0;
+    pvTruncated = false;
+    pvRestOffset = -1;
+    pvTailOffset = -1;
+    pvTailLength = 0;
+    stringOffset = -1;
+}
+
+QString UsiInfo::mateText() const
+{
+    if (scoreKind != ScoreKind::Mate) return QString();
+    if (mateDistanceUnknown) return scoreValue < 0 ? QStringLiteral("-") : QStringLiteral("+");
+    return QString::number(scoreValue);
+}
+
+QString UsiInfo::pvUsiString() const
+{
+    QString text;
+    text.reserve(pvLength * 6);
+    for (int i = 0; i < pvLength; ++i) {
+        if (i > 0) text += QLatin1Char(' ');
+        text += UsiPackedMove::toUsi(pv[i]);
+    }
+    return text;
+}
+
+// ============================================================
+// UsiInfoParser
+// ============================================================
+
+namespace {
+
+inline char16_t codeOf(char c) { return char16_t(uchar(c)); }
+inline char16_t codeOf(QChar c) { return c.unicode(); }
+
+inline bool isSpace(char16_t c)
+{
+    return c == u' ' || c == u'\t' || c == u'\r' || c == u'\n';
+}
+
+/// 空白区切りのトークンを順に返す（位置は元の行の添字）
+template <typename View>
+class Tokenizer
+{
+public:
+    explicit Tokenizer(View line) : m_line(line) {}
+
+    bool next(View& token)
+    {
+        const qsizetype size = m_line.size();
+        while (m_pos < size && isSpace(codeOf(m_line[m_pos]))) ++m_pos;
+        if (m_pos >= size) return false;
+
+        const qsizetype begin = m_pos;
+        while (m_pos < size && !isSpace(codeOf(m_line[m_pos]))) ++m_pos;
+        m_tokenBegin = begin;
+        token = m_line.sliced(begin, m_pos - begin);
+        return true;
+    }
+
+    /// 次のトークンを読まずに覗く
+    bool peek(View& token)
+    {
+        const qsizetype savedPos = m_pos;
+        const qsizetype savedBegin = m_tokenBegin;
+        const bool found = next(token);
+        m_pos = savedPos;
+        m_tokenBegin = savedBegin;
+        return found;
+    }
+
+    /// 直前に返したトークンの開始位置
+    qsizetype tokenBegin() const { return m_tokenBegin; }
+
+    /// 直前に返したトークンより後ろの本文の開始位置
+    qsizetype restBegin() const
+    {
+        qsizetype pos = m_pos;
+        while (pos < m_line.size() && isSpace(codeOf(m_line[pos]))) ++pos;
+        return pos;
+    }
+
+private:
+    View m_line;
+    qsizetype m_pos = 0;
+    qsizetype m_tokenBegin = 0;
+};
+
+template <typename View>
+bool equals(View token, const char* keyword)
+{
+    qsizetype i = 0;
+    for (; keyword[i] != '\0'; ++i) {
+        if (i >= token.size() || codeOf(token[i]) != char16_t(keyword[i])) return false;
+    }
+    return i == token.size();
+}
+
+/// 符号付き10進整数を読む（範囲外・数字以外を含むなら false）
+template <typename View>
+bool toInteger(View token, qint64& value)
+{
+    qsizetype i = 0;
+    bool negative = false;
+    if (i < token.size() && (codeOf(token[i]) == u'-' || codeOf(token[i]) == u'+')) {
+        negative = codeOf(token[i]) == u'-';
+        ++i;
+    }
+    if (i >= token.size()) return false;
+
+    qint64 result = 0;
+    for (; i < token.size(); ++i) {
+        const char16_t c = codeOf(token[i]);
+        if (c < u'0' || c > u'9') return false;
+        if (result > (std::numeric_limits<qint64>::max() - 9) / 10) return false;
+        result = result * 10 + (c - u'0');
+    }
+    value = negative ? -result : result;
+    return true;
+}
+
+/// 数値項目を読み、読めたら fields に印を付ける
+template <typename View, typename T>
+void readField(Tokenizer<View>& tokens, T& target, UsiInfo::Field field, UsiInfo& out)
+{
+    View token;
+    qint64 value = 0;
+    if (!tokens.next(token) || !toInteger(token, value)) return;
+    target = T(value);
+    out.fields |= field;
+}
+
+inline int boardFile(char16_t c) { return (c >= u'1' && c <= u'9') ? int(c - u'0') : 0; }
+inline int boardRank(char16_t c) { return (c >= u'a' && c <= u'i') ? int(c - u'a') + 1 : 0; }
+
+inline bool isDropPiece(char16_t c)
+{
+    return c == u'P' || c == u'L' || c == u'N' || c == u'S' || c == u'G' || c == u'B' || c == u'R';
+}
+
+template <typename View>
+quint32 parseMoveToken(View token)
+{
+    if (token.size() < 4 || token.size() > 5) return 0;
+
+    const int toFile = boardFile(codeOf(token[2]));
+    const int toRank = boardRank(codeOf(token[3]));
+    if (toFile == 0 || toRank == 0) return 0;
+
+    const char16_t first = codeOf(token[0]);
+    if (codeOf(token[1]) == u'*') {
+        if (!isDropPiece(first) || token.size() != 4) return 0;
+        return UsiPackedMove::packDrop(char(first), toFile, toRank);
+    }
+
+    const int fromFile = boardFile(first);
+    const int fromRank = boardRank(codeOf(token[1]));
+    if (fromFile == 0 || fromRank == 0) return 0;
+
+    bool promote = false;
+    if (token.size() == 5) {
+        if (codeOf(token[4]) != u'+') return 0;
+        promote = true;
+    }
+    return UsiPackedMove::pack(fromFile, fromRank, toFile, toRank, promote);
+}
+
+/// "score cp 10 [lowerbound|upperbound]" / "score mate 5|-3|+|-"
+template <typename View>
+void parseScore(Tokenizer<View>& tokens, UsiInfo& out)
+{
+    View kind;
+    View value;
+    if (!tokens.next(kind) || !tokens.next(value)) return;
+
+    qint64 number = 0;
+    if (equals(kind, "cp")) {
+        if (!toInteger(value, number)) return;
+        out.scoreKind = UsiInfo::ScoreKind::Cp;
+        out.scoreValue = int(number);
+
+        View bound;
+        if (tokens.peek(bound)) {
+            if (equals(bound, "lowerbound")) {
+                out.bound = UsiInfo::Bound::Lower;
+                tokens.next(bound);
+            } else if (equals(bound, "upperbound")) {
+                out.bound = UsiInfo::Bound::Upper;
+                tokens.next(bound);
+            }
+        }
+    } else if (equals(kind, "mate")) {
+        out.scoreKind = UsiInfo::ScoreKind::Mate;
+        if (equals(value, "+") || equals(value, "-")) {
+            out.mateDistanceUnknown = true;
+            out.scoreValue = equals(value, "-") ? -1 : 1;
+        } else if (toInteger(value, number)) {
+            out.scoreValue = int(number);
+        } else {
+            out.scoreKind = UsiInfo::ScoreKind::None;
+        }
+    }
+}
+
+/// pv 以降の指し手を詰める。末尾の非指し手トークンは範囲だけ覚える
+template <typename View>
+void parsePv(Tokenizer<View>& tokens, UsiInfo& out)
+{
+    View token;
+    while (tokens.next(token)) {
+        const quint32 move = parseMoveToken(token);
+        if (move == 0) {
+            View rest;
+            const qsizetype begin = tokens.tokenBegin();
+            if (!tokens.peek(rest) && !isDropPiece(codeOf(token[0])) && boardFile(codeOf(token[0])) == 0) {
+                out.pvTailOffset = int(begin);
+                out.pvTailLength = int(token.size());
+            }
+            return;
+        }
+        if (out.pvLength >= UsiInfo::kMaxPvMoves) {
+            out.pvTruncated = true;
+            out.pvRestOffset = int(tokens.tokenBegin());
+            return;
+        }
+        out.pv[out.pvLength++] = move;
+    }
+}
+
+template <typename View>
+bool parseLine(View line, UsiInfo& out)
+{
+    out.clear();
+    Tokenizer<View> tokens(line);
+    View token;
+
+    while (tokens.next(token)) {
+        if (equals(token, "info")) {
+            continue;
+        } else if (equals(token, "depth")) {
+            readField(tokens, out.depth, UsiInfo::Depth, out);
+        } else if (equals(token, "seldepth")) {
+            readField(tokens, out.seldepth, UsiInfo::Seldepth, out);
+        } else if (equals(token, "multipv")) {
+            readField(tokens, out.multipv, UsiInfo::Multipv, out);
+            out.multipv = qMax(1, out.multipv);
+        } else if (equals(token, "nodes")) {
+            readField(tokens, out.nodes, UsiInfo::Nodes, out);
+        } else if (equals(token, "nps")) {
+            readField(tokens, out.nps, UsiInfo::Nps, out);
+        } else if (equals(token, "time")) {
+            readField(tokens, out.time, UsiInfo::Time, out);
+        } else if (equals(token, "hashfull")) {
+            readField(tokens, out.hashfull, UsiInfo::Hashfull, out);
+        } else if (equals(token, "currmove")) {
+            View move;
+            if (tokens.next(move)) out.currmove = parseMoveToken(move);
+            if (out.currmove != 0) out.fields |= UsiInfo::Currmove;
+        } else if (equals(token, "score")) {
+            parseScore(tokens, out);
+        } else if (equals(token, "pv")) {
+            parsePv(tokens, out);
+            break;
+        } else if (equals(token, "string")) {
+            // info string 以降は自由文
+            out.stringOffset = int(tokens.restBegin());
+            out.fields |= UsiInfo::String;
+            break;
+        }
+    }
+    return out.fields != 0 || out.scoreKind != UsiInfo::ScoreKind::None || out.pvLength > 0;
+}
+
+} // namespace
+
+namespace UsiInfoParser {
+
+bool parse(QByteArrayView line, UsiInfo& out)
+{
+    return parseLine(line, out);
+}
+
+bool parse(QStringView line, UsiInfo& out)
+{
+    return parseLine(line, out);
+}
+
+quint32 parseMove(QStringView token)
+{
+    return parseMoveToken(token);
+}
+
+} // namespace UsiInfoParser
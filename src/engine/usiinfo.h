@@ -0,0 +1,136 @@
+#ifndef USIINFO_H
+#define USIINFO_H
+
+/// @file usiinfo.h
+/// @brief USI info行の型付きレコードと、ヒープ確保なしのパーサの定義
+
+
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+#include <array>
+
+/**
+ * @brief USIの指し手1手を32bitに詰めた表現
+ *
+ * ビット配置: [0-3] 移動先の筋 / [4-7] 移動先の段 / [8-11] 移動元の筋（駒打ちは0）/
+ * [12-15] 移動元の段 / [16-23] 打つ駒の文字（'P' など、盤上の移動は0）/ [24] 成り
+ * 0 は無効な指し手を表す。
+ */
+namespace UsiPackedMove {
+
+constexpr quint32 pack(int fileFrom, int rankFrom, int fileTo, int rankTo, bool promote)
+{
+    return quint32(fileTo) | (quint32(rankTo) << 4) | (quint32(fileFrom) << 8) | (quint32(rankFrom) << 12)
+           | (promote ? (1u << 24) : 0u);
+}
+
+constexpr quint32 packDrop(char piece, int fileTo, int rankTo)
+{
+    return quint32(fileTo) | (quint32(rankTo) << 4) | (quint32(quint8(piece)) << 16);
+}
+
+constexpr int fileTo(quint32 move) { return int(move & 0xF); }
+constexpr int rankTo(quint32 move) { return int((move >> 4) & 0xF); }
+constexpr int fileFrom(quint32 move) { return int((move >> 8) & 0xF); }
+constexpr int rankFrom(quint32 move) { return int((move >> 12) & 0xF); }
+constexpr char dropPiece(quint32 move) { return char((move >> 16) & 0xFF); }
+constexpr bool isDrop(quint32 move) { return dropPiece(move) != 0; }
+constexpr bool isPromotion(quint32 move) { return (move >> 24) & 1u; }
+
+/// USI形式の文字列（"7g7f" / "P*5e" / "8h2b+"）に戻す
+QString toUsi(quint32 move);
+
+} // namespace UsiPackedMove
+
+/**
+ * @brief info行1行分の解析結果（整数・列挙値のみで、ヒープを使わない）
+ *
+ * 数値は行にあったときだけ有効で、has() で確かめる。文字列への整形は表示する時点で行う。
+ * info string の本文と読み筋末尾の非指し手（"(57.54%)" など）は元の行の範囲で持つ。
+ */
+struct UsiInfo
+{
+    /// 保持できる読み筋の最大手数。長手数の詰みの読み筋も収まるよう大きめに取る
+    /// （超えた分は pvTruncated を立て、pvRestOffset に残りの位置だけ覚える）
+    static constexpr int kMaxPvMoves = 512;
+
+    /// 行に含まれていた項目
+    enum Field : quint16 {
+        Depth    = 1 << 0,
+        Seldepth = 1 << 1,
+        Multipv  = 1 << 2,
+        Nodes    = 1 << 3,
+        Nps      = 1 << 4,
+        Time     = 1 << 5,
+        Hashfull = 1 << 6,
+        Currmove = 1 << 7,
+        String   = 1 << 8
+    };
+
+    /// 評価値の種類
+    enum class ScoreKind : quint8 {
+        None, ///< score なし
+        Cp,   ///< score cp（scoreValue はセンチポーン）
+        Mate  ///< score mate（scoreValue は手数。負なら詰まされる）
+    };
+
+    /// score cp の境界
+    enum class Bound : quint8 {
+        Exact, ///< 確定値
+        Lower, ///< lowerbound
+        Upper  ///< upperbound
+    };
+
+    quint16 fields = 0;                 ///< Field の論理和
+    int depth = 0;                      ///< 探索深さ
+    int seldepth = 0;                   ///< 選択的探索深さ
+    int multipv = 1;                    ///< MultiPV番号（省略時は1）
+    int hashfull = 0;                   ///< ハッシュ使用率（千分率）
+    qint64 nodes = 0;                   ///< 探索ノード数
+    qint64 nps = 0;                     ///< 1秒あたりの探索局面数
+    qint64 time = 0;                    ///< 経過時間（ミリ秒）
+
+    ScoreKind scoreKind = ScoreKind::None; ///< 評価値の種類
+    Bound bound = Bound::Exact;         ///< score cp の境界
+    int scoreValue = 0;                 ///< 評価値または詰み手数
+    bool mateDistanceUnknown = false;   ///< "mate +" / "mate -"（scoreValue は ±1）
+
+    quint32 currmove = 0;               ///< 探索中の手
+    int pvLength = 0;                   ///< 読み筋の手数
+    bool pvTruncated = false;           ///< kMaxPvMoves を超えて切り詰めた
+    int pvRestOffset = -1;              ///< 切り詰めた残りの読み筋の位置（なければ-1）
+    int pvTailOffset = -1;              ///< 読み筋末尾の非指し手トークンの位置（なければ-1）
+    int pvTailLength = 0;               ///< 同トークンの長さ
+    int stringOffset = -1;              ///< info string 本文の位置（なければ-1）
+    std::array<quint32, kMaxPvMoves> pv{}; ///< 読み筋（UsiPackedMove）
+
+    bool has(Field field) const { return (fields & field) != 0; }
+
+    /// 次の行の解析前に初期状態へ戻す
+    void clear();
+
+    /// 詰み評価値の表示用テキスト（"+" / "-" / "5" / "-3"）
+    QString mateText() const;
+
+    /// 読み筋をUSI形式のスペース区切り文字列に整形する
+    QString pvUsiString() const;
+};
+
+/**
+ * @brief info行を UsiInfo に解析する（ヒープ確保なし）
+ *
+ * 行は QByteArrayView（パイプから読んだバイト列）でも QStringView でも渡せる。
+ * 先頭の "info" は省略可。解析できる項目が1つもなければ false を返す。
+ */
+namespace UsiInfoParser {
+
+bool parse(QByteArrayView line, UsiInfo& out);
+bool parse(QStringView line, UsiInfo& out);
+
+/// USI形式の指し手1手を解析する（不正なら0）
+quint32 parseMove(QStringView token);
+
+} // namespace UsiInfoParser
+
+#endif // USIINFO_H
@@ -80,6 +80,7 @@ void UsiProtocolHandler::setGameController(ShogiGameController* controller)
 bool UsiProtocolHandler::initializeEngine(const QString& /*engineName*/)
 {
     m_reportedOptions.clear();
+    m_appliedOptions.clear();
 
     sendUsi();
     if (!waitForUsiOk(5000)) {
@@ -87,37 +88,10 @@ bool UsiProtocolHandler::initializeEngine(const QString& /*engineName*/)
         return false;
     }
 
-    // エンジンが報告したオプションのみ送信する。
-    // 設定ファイルに保存されていてもエンジンが対応していないオプションは送信しない。
-    for (const QString& cmd : std::as_const(m_setOptionCommands)) {
-        // "setoption name <name> value ..." または "setoption name <name>" から名前を抽出
-        static const QString prefix = QStringLiteral("setoption name ");
-        if (cmd.startsWith(prefix)) {
-            qsizetype valuePos = cmd.indexOf(QStringLiteral(" value "), prefix.length());
-            QString optName = (valuePos > 0)
-                ? cmd.mid(prefix.length(), valuePos - prefix.length())
-                : cmd.mid(prefix.length());
-            if (!m_reportedOptions.contains(optName)) {
-                qCDebug(lcEngine) << "Skipping unsupported option:" << optName;
-                continue;
-            }
-        }
-        sendCommand(cmd);
-    }
-
-    // エンジンがUSI_Ponderを報告していない場合はponderを無効にする
-    if (m_isPonderEnabled && !m_reportedOptions.contains(QStringLiteral("USI_Ponder"))) {
-        m_isPonderEnabled = false;
-    }
-
-    sendIsReady();
-    if (!waitForReadyOk(5000)) {
+    if (!sendOptionsAndWaitReady()) {
         emit errorOccurred(tr("Timeout waiting for readyok"));
         return false;
     }
-
-    sendUsiNewGame();
-
     return true;
 }
 
@@ -163,6 +137,7 @@ void UsiProtocolHandler::sendCommand(const QString& command)
     if (m_processManager) {
         m_processManager->sendCommand(command);
     }
+    trackSentCommand(command);
 }
 
 void UsiProtocolHandler::sendUsi()
@@ -195,6 +170,7 @@ void UsiProtocolHandler::beginMainSearch()
 {
     m_activeSearchSeq = beginOperationContext();
     m_bestMoveReceived = false;
+    m_searchOutstanding = true;
     m_specialMove = SpecialMove::None;
     m_predictedOpponentMove.clear();
 
@@ -227,6 +203,7 @@ void UsiProtocolHandler::sendGoPonder()
 {
     m_activeSearchSeq = beginOperationContext();
     m_bestMoveReceived = false;
+    m_searchOutstanding = true;
     m_specialMove = SpecialMove::None;
     m_predictedOpponentMove.clear();
 
@@ -242,6 +219,7 @@ void UsiProtocolHandler::sendGoMate(int timeMs, bool infinite)
 {
     m_activeSearchSeq = beginOperationContext();
     m_bestMoveReceived = false;
+    m_searchOutstanding = true;
     m_specialMove = SpecialMove::None;
     m_predictedOpponentMove.clear();
 
@@ -388,11 +366,13 @@ void UsiProtocolHandler::onDataReceived(const QString& line)
     }
 
     if (line.startsWith(QStringLiteral("checkmate"))) {
+        m_searchOutstanding = false;
         handleCheckmateLine(line);
         return;
     }
 
     if (line.startsWith(QStringLiteral("bestmove"))) {
+        m_searchOutstanding = false;
         if (handleBestMoveLine(line)) {
             m_bestMoveReceived = true;
             emit bestMoveReceived();
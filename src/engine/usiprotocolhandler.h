@@ -61,6 +61,38 @@ public:
     /// 設定ファイルからオプションを読み込み
     void loadEngineOptions(const QString& engineName);
 
+    // --- 再利用（EngineProcessPool） ---
+
+    /// 待機中のエンジンを引き継いで初期化する（usi を省き、前回と値の違う setoption だけ送る）
+    /// 設定にないオプションが変更済みで戻せない場合も失敗とする。
+    /// 失敗しても errorOccurred は発行しない（呼び出し側が通常起動へ切り替える）
+    [[nodiscard]] bool initializeWarmEngine(const QSet<QString>& reportedOptions,
+                                            const QMap<QString, QString>& appliedOptions);
+
+    /// 操作状態を捨てて再利用できる状態にする（待機しない）
+    /// 探索中（bestmove/checkmate 未受信）なら stop を送る。応答は待たないので searchOutstanding() は
+    /// true のまま残り、読み捨ては引き取る側（EngineProcessPool）が行う。
+    /// 終了処理中なら false（呼び出し側でエンジンを終了する）
+    [[nodiscard]] bool prepareForReuse();
+
+    /// go 送信後、bestmove/checkmate をまだ受け取っていないか
+    bool searchOutstanding() const { return m_searchOutstanding; }
+
+    /// エンジンが報告したオプション名（usi〜usiok間）
+    QSet<QString> reportedOptions() const { return m_reportedOptions; }
+
+    /// 送信済みの setoption（オプション名 → コマンド。button 型は含まない）
+    QMap<QString, QString> appliedOptions() const { return m_appliedOptions; }
+
+    /// setoption コマンド群のうち、エンジンが対応していて送信済みの値と異なるものを返す
+    static QStringList optionCommandsToSend(const QStringList& commands,
+                                            const QSet<QString>& reportedOptions,
+                                            const QMap<QString, QString>& appliedOptions);
+
+    /// 送信済みのオプションのうち、setoption コマンド群に含まれず元の値へ戻せないものの名前
+    static QStringList unrestorableOptions(const QStringList& commands,
+                                           const QMap<QString, QString>& appliedOptions);
+
     // --- USIコマンド送信 ---
     
     void sendUsi();
@@ -166,9 +198,13 @@ public slots:
     void onDataReceived(const QString& line);
 
 private:
-    /// コマンド送信（内部）
+    /// コマンド送信（内部）。sendRaw を含むすべての送信が通る
     void sendCommand(const QString& command);
 
+    /// 送信したコマンドを状態に反映する
+    /// （go は探索中に、setoption は m_appliedOptions に。button 型は記録しない）
+    void trackSentCommand(const QString& command);
+
     /// bestmove行の処理（有効な行を処理した場合true）
     [[nodiscard]] bool handleBestMoveLine(const QString& line);
     
@@ -181,6 +217,9 @@ private:
     /// go本探索の共通前処理
     void beginMainSearch();
 
+    /// 設定済みの setoption を送り、isready/readyok を待つ（初期化の後半）
+    bool sendOptionsAndWaitReady();
+
     /// 待機メソッドの共通実装
     bool waitForResponseFlag(bool& flag, void(UsiProtocolHandler::*signal)(), int timeoutMs);
 
@@ -207,6 +246,7 @@ private:
     // --- 設定 ---
     QStringList m_setOptionCommands;   ///< 初期化時に送信するsetoptionコマンド群
     QSet<QString> m_reportedOptions;   ///< エンジンが報告したオプション名（usi〜usiok間）
+    QMap<QString, QString> m_appliedOptions; ///< 送信済みの setoption（オプション名 → コマンド）
 
     // --- 計測 ---
     QElapsedTimer m_goTimer;           ///< go送信からbestmoveまでの経過時間計測
@@ -224,6 +264,7 @@ private:
     bool m_timeoutDeclared = false;    ///< ハードタイムアウト宣言済み
     bool m_modeTsume = false;          ///< 詰将棋探索モード
     bool m_stopOrPonderhitPending = false; ///< stop/ponderhit送信通知のラッチ
+    bool m_searchOutstanding = false;  ///< go 送信後 bestmove/checkmate 未受信（破棄された応答も含む）
 
     // --- オペレーションコンテキスト ---
     QPointer<QObject> m_opCtx { nullptr }; ///< 現在のオペレーション（所有、キャンセル時にdelete）
@@ -1,9 +1,26 @@
 /// @file usiprotocolhandler_ops.cpp
-/// @brief UsiProtocolHandler の局所操作（checkmate/座標変換/operation context）実装
+/// @brief UsiProtocolHandler の局所操作（checkmate/座標変換/operation context/再利用とオプション記録）実装
 
 #include "usiprotocolhandler.h"
 #include "usimovecoordinateconverter.h"
 #include "shogigamecontroller.h"
+#include "logcategories.h"
+
+namespace {
+const QString kSetOptionPrefix = QStringLiteral("setoption name ");
+
+/// "setoption name <name> value ..." または "setoption name <name>" から名前を抽出
+QString optionNameOf(const QString& cmd)
+{
+    if (!cmd.startsWith(kSetOptionPrefix)) {
+        return QString();
+    }
+    const qsizetype valuePos = cmd.indexOf(QStringLiteral(" value "), kSetOptionPrefix.size());
+    return (valuePos > 0)
+        ? cmd.mid(kSetOptionPrefix.size(), valuePos - kSetOptionPrefix.size())
+        : cmd.mid(kSetOptionPrefix.size());
+}
+} // anonymous namespace
 
 void UsiProtocolHandler::handleCheckmateLine(const QString& line)
 {
@@ -114,3 +131,115 @@ void UsiProtocolHandler::cancelCurrentOperation()
     m_modeTsume = false;
     ++m_seq;
 }
+
+bool UsiProtocolHandler::initializeWarmEngine(const QSet<QString>& reportedOptions,
+                                              const QMap<QString, QString>& appliedOptions)
+{
+    // 前の利用者が設定にないオプション（検討の MultiPV など）を変えていたら、既定値を知らないので戻せない
+    const QStringList stale = unrestorableOptions(m_setOptionCommands, appliedOptions);
+    if (!stale.isEmpty()) {
+        qCInfo(lcEngine) << "Warm engine has options that cannot be restored:" << stale;
+        return false;
+    }
+
+    m_reportedOptions = reportedOptions;
+    m_appliedOptions = appliedOptions;
+
+    // readyok が返らなければ待機中に壊れたエンジンとみなす（ヘルスチェックを兼ねる）
+    return sendOptionsAndWaitReady();
+}
+
+bool UsiProtocolHandler::sendOptionsAndWaitReady()
+{
+    const QStringList commands =
+        optionCommandsToSend(m_setOptionCommands, m_reportedOptions, m_appliedOptions);
+    for (const QString& cmd : commands) {
+        sendCommand(cmd);
+    }
+
+    // エンジンがUSI_Ponderを報告していない場合はponderを無効にする
+    if (m_isPonderEnabled && !m_reportedOptions.contains(QStringLiteral("USI_Ponder"))) {
+        m_isPonderEnabled = false;
+    }
+
+    sendIsReady();
+    if (!waitForReadyOk(5000)) {
+        return false;
+    }
+
+    sendUsiNewGame();
+
+    return true;
+}
+
+bool UsiProtocolHandler::prepareForReuse()
+{
+    if (shouldAbortWait()) return false;
+
+    // 探索が残っていると次の利用者の go に古い bestmove が混ざるので止める。
+    // 待つと呼び出し元（終了処理）を止めてしまうので、応答の読み捨てはプールに任せる
+    if (m_searchOutstanding) {
+        qCDebug(lcEngine) << "prepareForReuse: stopping outstanding search";
+        sendCommand("stop");
+    }
+
+    cancelCurrentOperation();
+    m_activeSearchSeq = 0;
+    m_phase = SearchPhase::Idle;
+    return true;
+}
+
+void UsiProtocolHandler::trackSentCommand(const QString& command)
+{
+    // 検討の go infinite など sendRaw で送った探索も、bestmove/checkmate までは探索中とみなす
+    if (command == QLatin1String("go") || command.startsWith(QLatin1String("go "))) {
+        m_searchOutstanding = true;
+        return;
+    }
+
+    // 検討の MultiPV など設定以外から送ったオプションも、再利用時に差分を判定できるよう記録する
+    const QString name = optionNameOf(command);
+    // button 型（value なし）は押すたびに送るものなので記録しない
+    if (!name.isEmpty() && command.size() > kSetOptionPrefix.size() + name.size()) {
+        m_appliedOptions.insert(name, command);
+    }
+}
+
+QStringList UsiProtocolHandler::optionCommandsToSend(const QStringList& commands,
+                                                     const QSet<QString>& reportedOptions,
+                                                     const QMap<QString, QString>& appliedOptions)
+{
+    QStringList result;
+    for (const QString& cmd : commands) {
+        const QString name = optionNameOf(cmd);
+        if (!name.isEmpty()) {
+            // 設定ファイルに保存されていてもエンジンが対応していないオプションは送信しない
+            if (!reportedOptions.contains(name)) {
+                qCDebug(lcEngine) << "Skipping unsupported option:" << name;
+                continue;
+            }
+            // 再利用したエンジンに同じ値を送り直さない（button 型は毎回送る）
+            if (appliedOptions.value(name) == cmd) {
+                continue;
+            }
+        }
+        result.append(cmd);
+    }
+    return result;
+}
+
+QStringList UsiProtocolHandler::unrestorableOptions(const QStringList& commands,
+                                                    const QMap<QString, QString>& appliedOptions)
+{
+    QSet<QString> configured;
+    for (const QString& cmd : commands) {
+        configured.insert(optionNameOf(cmd));
+    }
+    QStringList result;
+    for (auto it = appliedOptions.cbegin(); it != appliedOptions.cend(); ++it) {
+        if (!configured.contains(it.key())) {
+            result.append(it.key());
+        }
+    }
+    return result;
+}
@@ -6,7 +6,6 @@
 #include "shogiclock.h"
 #include "usi.h"
 #include "enginegameovernotifier.h"
-#include "sennichitedetector.h"
 #include "enginevsenginestrategy.h"
 #include "logcategories.h"
 
@@ -368,7 +367,12 @@ bool GameEndHandler::checkAndHandleSennichite()
     }
     if (!rec || rec->size() < 4) return false;
 
-    const auto result = SennichiteDetector::check(*rec);
+    // EvE 用の履歴と通常の履歴が入れ替わったら、前の履歴の局面を持ち越さないよう作り直す
+    if (rec != m_sennichiteSource) {
+        m_sennichite.clear();
+        m_sennichiteSource = rec;
+    }
+    const auto result = m_sennichite.syncTo(*rec);
     switch (result) {
     case SennichiteDetector::Result::None:
         return false;
@@ -484,6 +488,10 @@ void GameEndHandler::clearGameOverState()
 {
     const bool wasOver = m_refs.gameOver->isOver;
     *m_refs.gameOver = GameOverState{};
+
+    // 対局開始時に呼ばれる。前の対局の局面を新しい対局の履歴に持ち越さない
+    m_sennichite.clear();
+    m_sennichiteSource = nullptr;
     if (wasOver) {
         emit gameOverStateChanged(*m_refs.gameOver);
         qCDebug(lcGame) << "clearGameOverState()";
@@ -11,6 +11,7 @@
 #include <functional>
 
 #include "matchcoordinator.h"
+#include "sennichitetracker.h"
 
 class ShogiGameController;
 class ShogiClock;
@@ -128,6 +129,8 @@ private:
 
     Refs m_refs;
     Hooks m_hooks;
+    SennichiteTracker m_sennichite;  ///< 局面ハッシュによる千日手の差分判定
+    const QStringList* m_sennichiteSource = nullptr;  ///< m_sennichite が同期している履歴リスト
 };
 
 #endif // GAMEENDHANDLER_H
@@ -11,7 +11,8 @@
  *
  * SFEN履歴から千日手を判定する。通常の千日手（引き分け）と
  * 連続王手の千日手（反則負け）を区別して報告する。
- * 状態を持たないstaticメソッドのみのクラス。
+ * 状態を持たないstaticメソッドのみのクラス。履歴全体を毎回走査するため、
+ * 対局中に1手ごと判定する場合は差分更新型の SennichiteTracker を使う。
  */
 class SennichiteDetector {
 public:
@@ -36,18 +37,6 @@ public:
      * @return "board turn hand" 部分（手数を除く）
      */
     static QString positionKey(const QString& sfen);
-
-private:
-    /**
-     * @brief 連続王手判定（3回目と4回目の出現の間の手順を調べる）
-     * @param sfenRecord SFEN履歴
-     * @param thirdIdx 3回目の出現インデックス
-     * @param fourthIdx 4回目の出現インデックス（= sfenRecord末尾）
-     * @return 連続王手があれば該当する Result、なければ Result::Draw
-     */
-    static Result checkContinuousCheck(const QStringList& sfenRecord,
-                                       int thirdIdx,
-                                       int fourthIdx);
 };
 
 #endif // SENNICHITEDETECTOR_H
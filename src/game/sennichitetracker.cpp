@@ -0,0 +1,119 @@
+/// @file sennichitetracker.cpp
+/// @brief 局面ハッシュによる差分更新型の千日手トラッカーの実装
+
+#include "sennichitetracker.h"
+
+#include "fmvconverter.h"
+#include "fmvlegalcore.h"
+#include "logcategories.h"
+
+namespace {
+const fmv::LegalCore& legalCore()
+{
+    static const fmv::LegalCore core;
+    return core;
+}
+} // namespace
+
+bool SennichiteTracker::pushPosition(const QString& sfen)
+{
+    Ply ply;
+    ply.sfen = sfen;
+    if (!m_plies.isEmpty()) {
+        const Ply& prev = m_plies.constLast();
+        ply.p1Moves = prev.p1Moves;
+        ply.p1Checks = prev.p1Checks;
+        ply.p2Moves = prev.p2Moves;
+        ply.p2Checks = prev.p2Checks;
+    }
+
+    fmv::EnginePosition pos;
+    fmv::Color sideToMove = fmv::Color::Black;
+    ply.valid = fmv::Converter::fromSfen(pos, sideToMove, sfen);
+
+    const int index = size();
+    if (ply.valid) {
+        ply.key = pos.zobristKey;
+        m_occurrences[ply.key].append(index);
+
+        // 手番側の玉が王手されている = 直前の相手の手が王手
+        const bool inCheck = legalCore().countChecksToKing(pos, sideToMove) > 0;
+        if (index > 0) {
+            if (sideToMove == fmv::Color::White) {
+                ++ply.p1Moves;
+                if (inCheck) ++ply.p1Checks;
+            } else {
+                ++ply.p2Moves;
+                if (inCheck) ++ply.p2Checks;
+            }
+        }
+    }
+
+    m_plies.append(ply);
+    return ply.valid;
+}
+
+void SennichiteTracker::popPosition()
+{
+    if (m_plies.isEmpty()) return;
+
+    const Ply& last = m_plies.constLast();
+    if (last.valid) {
+        auto it = m_occurrences.find(last.key);
+        if (it != m_occurrences.end()) {
+            it->removeLast();
+            if (it->isEmpty()) m_occurrences.erase(it);
+        }
+    }
+    m_plies.removeLast();
+}
+
+void SennichiteTracker::clear()
+{
+    m_plies.clear();
+    m_occurrences.clear();
+}
+
+SennichiteTracker::Result SennichiteTracker::result() const
+{
+    if (m_plies.size() < 4) return Result::None;
+
+    const Ply& current = m_plies.constLast();
+    if (!current.valid) return Result::None;
+
+    const auto it = m_occurrences.constFind(current.key);
+    if (it == m_occurrences.constEnd() || it->size() < 4) return Result::None;
+
+    // 3回目と4回目の出現の間（thirdIdx+1 〜 fourthIdx）の手順を累積カウントの差で調べる
+    const Ply& third = m_plies.at(it->at(it->size() - 2));
+    const int p1Moves = current.p1Moves - third.p1Moves;
+    const int p2Moves = current.p2Moves - third.p2Moves;
+
+    // 一方の指し手が全て王手なら連続王手の千日手
+    if (p1Moves > 0 && current.p1Checks - third.p1Checks == p1Moves) {
+        qCInfo(lcGame) << "Sennichite: continuous check by P1 (sente)";
+        return Result::ContinuousCheckByP1;
+    }
+    if (p2Moves > 0 && current.p2Checks - third.p2Checks == p2Moves) {
+        qCInfo(lcGame) << "Sennichite: continuous check by P2 (gote)";
+        return Result::ContinuousCheckByP2;
+    }
+
+    qCInfo(lcGame) << "Sennichite: draw by repetition";
+    return Result::Draw;
+}
+
+SennichiteTracker::Result SennichiteTracker::syncTo(const QStringList& sfenRecord)
+{
+    // 待った・末尾の食い違い: 履歴と一致する末尾まで巻き戻す
+    while (!m_plies.isEmpty()
+           && (size() > sfenRecord.size() || m_plies.constLast().sfen != sfenRecord.at(size() - 1))) {
+        popPosition();
+    }
+
+    for (qsizetype i = size(); i < sfenRecord.size(); ++i) {
+        pushPosition(sfenRecord.at(i));
+    }
+
+    return result();
+}
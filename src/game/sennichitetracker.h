@@ -0,0 +1,74 @@
+#ifndef SENNICHITETRACKER_H
+#define SENNICHITETRACKER_H
+
+/// @file sennichitetracker.h
+/// @brief 局面ハッシュによる差分更新型の千日手トラッカーの定義
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "sennichitedetector.h"
+
+/**
+ * @brief 局面を1手ずつ積み上げて千日手を O(1) で判定するトラッカー
+ *
+ * 各局面の 64bit Zobrist キー → 出現インデックス列のマップと、
+ * 「直前の手が王手だったか」の累積カウントを保持する。
+ * 着手ごとに pushPosition()、待ったで popPosition() を呼べば、
+ * 履歴全体を再走査せずに result() で判定できる。
+ *
+ * syncTo() は同じ SFEN 履歴リストの伸び縮み（着手・待った）を検出して自動的に
+ * push/pop する。照合するのは末尾局面だけなので、別の対局や別の履歴リストに
+ * 切り替えるときは先に clear() すること。
+ */
+class SennichiteTracker
+{
+public:
+    using Result = SennichiteDetector::Result;
+
+    /**
+     * @brief 局面を1つ追加する
+     * @param sfen "board turn hand moveNum" 形式のSFEN
+     * @return SFENの解析に成功したら true（失敗時も手数の整合のため枠は追加される）
+     */
+    bool pushPosition(const QString& sfen);
+
+    /// 最後に追加した局面を取り除く（待った用）
+    void popPosition();
+
+    /// 全局面を破棄する
+    void clear();
+
+    /// 追跡中の局面数
+    int size() const { return static_cast<int>(m_plies.size()); }
+
+    /// 最新局面の千日手判定結果
+    Result result() const;
+
+    /**
+     * @brief SFEN履歴と同期し、最新局面の判定結果を返す
+     *
+     * 既に取り込んだ末尾局面が履歴と一致する限り、新しく増えた分だけを取り込む。
+     * 履歴が短くなった（待った）場合や末尾が食い違う場合は一致する位置まで巻き戻す。
+     * 途中の局面は照合しないため、別の履歴に切り替える前に clear() を呼ぶ。
+     */
+    Result syncTo(const QStringList& sfenRecord);
+
+private:
+    struct Ply {
+        QString sfen;            ///< 同期判定用（履歴リストと暗黙共有されるためコピーは発生しない）
+        quint64 key = 0;         ///< 手番込み Zobrist キー
+        bool valid = false;      ///< SFEN解析に成功したか
+        int p1Moves = 0;         ///< 先頭からこの局面までの「先手が指した直後の局面」数（累積）
+        int p1Checks = 0;        ///< うち後手玉に王手がかかっていた数（累積）
+        int p2Moves = 0;         ///< 「後手が指した直後の局面」数（累積）
+        int p2Checks = 0;        ///< うち先手玉に王手がかかっていた数（累積）
+    };
+
+    QList<Ply> m_plies;                         ///< 手数順の局面情報
+    QHash<quint64, QList<int>> m_occurrences;   ///< 局面キー → 出現インデックス（昇順）
+};
+
+#endif // SENNICHITETRACKER_H
@@ -225,7 +225,7 @@ bool ShogiGameController::decidePromotion(PlayMode& playMode, EngineMoveValidato
     if (isCurrentPlayerHumanControlled(playMode)) {
         currentMove.isPromotion = false;
 
-        LegalMoveStatus legalMoveStatus = validator.isLegalMove(turnMove, board()->boardData(), board()->pieceStand(), currentMove);
+        LegalMoveStatus legalMoveStatus = validator.isLegalMove(turnMove, board()->enginePosition(), currentMove);
 
         bool canMoveWithoutPromotion = legalMoveStatus.nonPromotingMoveExists;
         bool canMoveWithPromotion = legalMoveStatus.promotingMoveExists;
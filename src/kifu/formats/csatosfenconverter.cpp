@@ -24,7 +24,12 @@ bool CsaToSfenConverter::readAllLinesDetectEncoding(const QString& path, QString
         return false;
     }
 
-    const QByteArray raw = f.readAll();
+    decodeLines(f.readAll(), outLines);
+    return true;
+}
+
+void CsaToSfenConverter::decodeLines(const QByteArray& raw, QStringList& outLines)
+{
     const QByteArray head = raw.left(128);
     const bool utf8Header  = head.contains("CSA encoding=UTF-8")
                           || head.contains("'encoding=UTF-8");
@@ -65,7 +70,6 @@ bool CsaToSfenConverter::readAllLinesDetectEncoding(const QString& path, QString
     text.replace("\r\n", "\n");
     text.replace("\r", "\n");
     outLines = text.split('\n', Qt::KeepEmptyParts);
-    return true;
 }
 
 // ============================================================
@@ -74,12 +78,15 @@ bool CsaToSfenConverter::readAllLinesDetectEncoding(const QString& path, QString
 
 QList<KifGameInfoItem> CsaToSfenConverter::extractGameInfo(const QString& filePath)
 {
-    QList<KifGameInfoItem> items;
     QStringList lines;
     QString warn;
+    if (!readAllLinesDetectEncoding(filePath, lines, &warn)) return {};
+    return extractGameInfoFromLines(lines);
+}
 
-    if (!readAllLinesDetectEncoding(filePath, lines, &warn)) return items;
-
+QList<KifGameInfoItem> CsaToSfenConverter::extractGameInfoFromLines(const QStringList& lines)
+{
+    QList<KifGameInfoItem> items;
     for (const QString& rawLine : std::as_const(lines)) {
         const QString line = rawLine.trimmed();
         if (line.isEmpty()) continue;
@@ -115,6 +122,11 @@ QList<KifGameInfoItem> CsaToSfenConverter::extractGameInfo(const QString& filePa
 
                 items.append({ key, val });
             }
+        } else if (line.startsWith(QLatin1String("'black_rate:")) || line.startsWith(QLatin1String("'white_rate:"))) {
+            // floodgate のレーティング行（'black_rate:名前:2500.0）
+            const QString rate = line.mid(line.lastIndexOf(QLatin1Char(':')) + 1).trimmed();
+            items.append({ line.at(1) == QLatin1Char('b') ? QStringLiteral("先手レーティング")
+                                                           : QStringLiteral("後手レーティング"), rate });
         } else if (line.startsWith(QLatin1Char('V'))) {
             items.append({ QStringLiteral("バージョン"), line });
         }
@@ -242,11 +254,13 @@ bool CsaToSfenConverter::parse(const QString& filePath, KifParseResult& out, QSt
 {
     QStringList lines;
     if (!readAllLinesDetectEncoding(filePath, lines, warn)) return false;
+    return parseLines(lines, out, warn);
+}
 
-    out.mainline.baseSfen.clear();
-    out.mainline.usiMoves.clear();
-    out.mainline.disp.clear();
-    out.variations.clear();
+bool CsaToSfenConverter::parseLines(const QStringList& lines, KifParseResult& out, QString* warn)
+{
+    out = KifParseResult{};
+    out.gameInfo = extractGameInfoFromLines(lines);
 
     int   idx  = 0;
     CsaLexer::Color stm  = CsaLexer::Black;
@@ -7,6 +7,7 @@
 #include "csalexer.h"
 #include "kifparsetypes.h"
 
+#include <QByteArray>
 #include <QString>
 #include <QStringList>
 
@@ -53,6 +54,14 @@ public:
     [[nodiscard]] static bool parse(const QString& filePath, KifParseResult& out, QString* warn);
     static QList<KifGameInfoItem> extractGameInfo(const QString& filePath);
 
+    // --- 一括API（ファイルの読み込みは呼び出し側で1度だけ行う） ---
+
+    /// ヘッダの encoding 指定（なければ UTF-8 → Shift_JIS の順）でデコードして行に分割する
+    static void decodeLines(const QByteArray& raw, QStringList& outLines);
+    /// デコード済みの行から開始局面・対局情報・本譜を1回で抽出（mainline.baseSfen が開始局面）
+    [[nodiscard]] static bool parseLines(const QStringList& lines, KifParseResult& out, QString* warn);
+    static QList<KifGameInfoItem> extractGameInfoFromLines(const QStringList& lines);
+
 private:
     static bool readAllLinesDetectEncoding(const QString& path, QStringList& outLines, QString* warn);
 };
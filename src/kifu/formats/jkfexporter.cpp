@@ -151,7 +151,7 @@ static QJsonArray buildJkfForkMovesFromNode(KifuBranchNode* node, QSet<int>& vis
         }
 
         if (current->hasBranch()) {
-            const QList<KifuBranchNode*>& children = current->children();
+            const QList<KifuBranchNode*> children = current->children();
             if (children.size() > 1) {
                 QJsonArray childForks;
                 for (int i = 1; i < children.size(); ++i) {
@@ -192,7 +192,7 @@ static void addJkfForksFromTree(QJsonArray& movesArray, const KifuBranchTree* tr
             continue;
         }
 
-        const QList<KifuBranchNode*>& children = node->children();
+        const QList<KifuBranchNode*> children = node->children();
 
         if (children.size() <= 1) {
             continue;
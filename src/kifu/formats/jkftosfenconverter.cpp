@@ -204,10 +204,42 @@ bool JkfToSfenConverter::parseWithVariations(const QString& jkfPath,
     if (!loadJsonFile(jkfPath, root, errorMessage)) {
         return false;
     }
+    return parseRoot(root, out, errorMessage);
+}
+
+bool JkfToSfenConverter::parseJson(const QByteArray& data, KifParseResult& out, QString* errorMessage)
+{
+    out = KifParseResult{};
+
+    QJsonObject root;
+    if (!parseJsonObject(data, root, errorMessage)) {
+        return false;
+    }
+    return parseRoot(root, out, errorMessage);
+}
+
+QList<KifGameInfoItem> JkfToSfenConverter::extractGameInfo(const QString& filePath)
+{
+    QJsonObject root;
+    QString warn;
+    if (!loadJsonFile(filePath, root, &warn)) {
+        return {};
+    }
+    return gameInfoFromRoot(root);
+}
+
+QMap<QString, QString> JkfToSfenConverter::extractGameInfoMap(const QString& filePath)
+{
+    return KifuParseCommon::toGameInfoMap(extractGameInfo(filePath));
+}
+
+// ========== private ヘルパ ==========
 
-    QString detectedLabel;
-    out.mainline.baseSfen = buildInitialSfen(root, &detectedLabel);
+bool JkfToSfenConverter::parseRoot(const QJsonObject& root, KifParseResult& out, QString* errorMessage)
+{
+    out.mainline.baseSfen = buildInitialSfen(root, &out.teaiLabel);
     out.mainline.startPly = 1;
+    out.gameInfo = gameInfoFromRoot(root);
 
     if (!root.contains(QStringLiteral("moves"))) {
         if (errorMessage) *errorMessage = QStringLiteral("JKF: 'moves' array not found");
@@ -220,16 +252,9 @@ bool JkfToSfenConverter::parseWithVariations(const QString& jkfPath,
     return true;
 }
 
-QList<KifGameInfoItem> JkfToSfenConverter::extractGameInfo(const QString& filePath)
+QList<KifGameInfoItem> JkfToSfenConverter::gameInfoFromRoot(const QJsonObject& root)
 {
     QList<KifGameInfoItem> ordered;
-
-    QJsonObject root;
-    QString warn;
-    if (!loadJsonFile(filePath, root, &warn)) {
-        return ordered;
-    }
-
     if (!root.contains(QStringLiteral("header"))) {
         return ordered;
     }
@@ -245,13 +270,6 @@ QList<KifGameInfoItem> JkfToSfenConverter::extractGameInfo(const QString& filePa
     return ordered;
 }
 
-QMap<QString, QString> JkfToSfenConverter::extractGameInfoMap(const QString& filePath)
-{
-    return KifuParseCommon::toGameInfoMap(extractGameInfo(filePath));
-}
-
-// ========== private ヘルパ ==========
-
 bool JkfToSfenConverter::loadJsonFile(const QString& filePath, QJsonObject& root, QString* warn)
 {
     QFile file(filePath);
@@ -262,7 +280,11 @@ bool JkfToSfenConverter::loadJsonFile(const QString& filePath, QJsonObject& root
 
     const QByteArray data = file.readAll();
     file.close();
+    return parseJsonObject(data, root, warn);
+}
 
+bool JkfToSfenConverter::parseJsonObject(const QByteArray& data, QJsonObject& root, QString* warn)
+{
     QJsonParseError parseError;
     const QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
 
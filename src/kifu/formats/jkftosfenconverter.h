@@ -4,6 +4,7 @@
 /// @file jkftosfenconverter.h
 /// @brief JKF形式棋譜コンバータクラスの定義
 
+#include <QByteArray>
 #include <QString>
 #include <QStringList>
 #include <QList>
@@ -29,12 +30,17 @@ public:
     static QStringList convertFile(const QString& jkfPath, QString* errorMessage = nullptr);
     static QList<KifDisplayItem> extractMovesWithTimes(const QString& jkfPath, QString* errorMessage = nullptr);
     [[nodiscard]] static bool parseWithVariations(const QString& jkfPath, KifParseResult& out, QString* errorMessage = nullptr);
+    /// 読み込み済みの JSON から初期局面・手合割・対局情報・本譜・変化を1回で抽出
+    [[nodiscard]] static bool parseJson(const QByteArray& data, KifParseResult& out, QString* errorMessage = nullptr);
     static QList<KifGameInfoItem> extractGameInfo(const QString& filePath);
     static QMap<QString, QString> extractGameInfoMap(const QString& filePath);
     static QString mapPresetToSfen(const QString& preset);
 
 private:
     static bool loadJsonFile(const QString& filePath, QJsonObject& root, QString* warn);
+    static bool parseJsonObject(const QByteArray& data, QJsonObject& root, QString* warn);
+    static bool parseRoot(const QJsonObject& root, KifParseResult& out, QString* errorMessage);
+    static QList<KifGameInfoItem> gameInfoFromRoot(const QJsonObject& root);
     static QString buildInitialSfen(const QJsonObject& root, QString* detectedLabel = nullptr);
     static void parseMovesArray(const QJsonArray& movesArray,
                                 const QString& baseSfen,
@@ -218,15 +218,20 @@ void Ki2ToSfenConverter::applyMoveToBoard(const QString& usi,
 
 QStringList Ki2ToSfenConverter::convertFile(const QString& ki2Path, QString* errorMessage)
 {
-    QStringList out;
     QString usedEnc;
     QStringList lines;
-    if (!KifReader::readLinesAuto(ki2Path, lines, &usedEnc, errorMessage)) return out;
+    if (!KifReader::readLinesAuto(ki2Path, lines, &usedEnc, errorMessage)) return {};
 
     qCDebug(lcKifu).noquote() << QStringLiteral("convertFile: encoding = %1 , lines = %2")
                                     .arg(usedEnc).arg(lines.size());
 
-    const QString initialSfen = detectInitialSfenFromFile(ki2Path);
+    return convertLines(lines, KifToSfenConverter::detectInitialSfenFromLines(lines), errorMessage);
+}
+
+QStringList Ki2ToSfenConverter::convertLines(const QStringList& lines, const QString& initialSfen,
+                                             QString* errorMessage)
+{
+    QStringList out;
     QString boardState[9][9];
     QMap<Piece, int> blackHands, whiteHands;
     initBoardFromSfen(initialSfen, boardState, blackHands, whiteHands);
@@ -270,19 +275,23 @@ QStringList Ki2ToSfenConverter::convertFile(const QString& ki2Path, QString* err
         }
     }
 
-    qCDebug(lcKifu).noquote() << QStringLiteral("convertFile: moves = %1").arg(out.size());
+    qCDebug(lcKifu).noquote() << QStringLiteral("convertLines: moves = %1").arg(out.size());
     return out;
 }
 
 QList<KifDisplayItem> Ki2ToSfenConverter::extractMovesWithTimes(const QString& ki2Path,
                                                                  QString* errorMessage)
 {
-    QList<KifDisplayItem> out;
     QString usedEnc;
     QStringList lines;
-    if (!KifReader::readLinesAuto(ki2Path, lines, &usedEnc, errorMessage)) return out;
+    if (!KifReader::readLinesAuto(ki2Path, lines, &usedEnc, errorMessage)) return {};
+    return extractMovesWithTimesFromLines(lines, KifToSfenConverter::detectInitialSfenFromLines(lines));
+}
 
-    const QString initialSfen = detectInitialSfenFromFile(ki2Path);
+QList<KifDisplayItem> Ki2ToSfenConverter::extractMovesWithTimesFromLines(const QStringList& lines,
+                                                                          const QString& initialSfen)
+{
+    QList<KifDisplayItem> out;
     QString boardState[9][9];
     QMap<Piece, int> blackHands, whiteHands;
     initBoardFromSfen(initialSfen, boardState, blackHands, whiteHands);
@@ -359,10 +368,19 @@ bool Ki2ToSfenConverter::parseWithVariations(const QString& ki2Path,
                                               QString* errorMessage)
 {
     out = KifParseResult{};
-    QString teai;
-    out.mainline.baseSfen = detectInitialSfenFromFile(ki2Path, &teai);
-    out.mainline.disp = extractMovesWithTimes(ki2Path, errorMessage);
-    out.mainline.usiMoves = convertFile(ki2Path, errorMessage);
+    QString usedEnc;
+    QStringList lines;
+    if (!KifReader::readLinesAuto(ki2Path, lines, &usedEnc, errorMessage)) return false;
+    return parseLines(lines, out, errorMessage);
+}
+
+bool Ki2ToSfenConverter::parseLines(const QStringList& lines, KifParseResult& out, QString* errorMessage)
+{
+    out = KifParseResult{};
+    out.mainline.baseSfen = KifToSfenConverter::detectInitialSfenFromLines(lines, &out.teaiLabel);
+    out.mainline.disp = extractMovesWithTimesFromLines(lines, out.mainline.baseSfen);
+    out.mainline.usiMoves = convertLines(lines, out.mainline.baseSfen, errorMessage);
+    out.gameInfo = extractGameInfoFromLines(lines);
     return true;
 }
 
@@ -376,7 +394,11 @@ QList<KifGameInfoItem> Ki2ToSfenConverter::extractGameInfo(const QString& filePa
         qCWarning(lcKifu).noquote() << "read failed:" << filePath << "warn:" << warn;
         return {};
     }
+    return extractGameInfoFromLines(lines);
+}
 
+QList<KifGameInfoItem> Ki2ToSfenConverter::extractGameInfoFromLines(const QStringList& lines)
+{
     return KifuParseCommon::extractHeaderGameInfo(lines, [](const QString& t) {
         return Ki2Lexer::isKi2MoveLine(t);
     });
@@ -26,9 +26,13 @@ public:
     static QString detectInitialSfenFromFile(const QString& ki2Path, QString* detectedLabel = nullptr);
     static QStringList convertFile(const QString& ki2Path, QString* errorMessage = nullptr);
     static QList<KifDisplayItem> extractMovesWithTimes(const QString& ki2Path, QString* errorMessage = nullptr);
+    /// 本譜＋変化をまとめて抽出する。ファイルを読めなければ errorMessage を設定して false を返す（KIF 版と同じ）
     [[nodiscard]] static bool parseWithVariations(const QString& ki2Path, KifParseResult& out, QString* errorMessage = nullptr);
+    /// デコード済みの行から初期局面・手合割・対局情報・本譜を1回で抽出（KifToSfenConverter::parseLines と同じ契約）
+    [[nodiscard]] static bool parseLines(const QStringList& lines, KifParseResult& out, QString* errorMessage = nullptr);
     static QString mapHandicapToSfen(const QString& label);
     static QList<KifGameInfoItem> extractGameInfo(const QString& filePath);
+    static QList<KifGameInfoItem> extractGameInfoFromLines(const QStringList& lines);
     static QMap<QString, QString> extractGameInfoMap(const QString& filePath);
     [[nodiscard]] static bool buildInitialSfenFromBod(const QStringList& lines, QString& outSfen,
                                         QString* detectedLabel = nullptr, QString* warn = nullptr);
@@ -54,6 +58,12 @@ public:
         int& prevToFile, int& prevToRank);
 
 private:
+    // 行ベース版（初期局面は呼び出し側で判定済みのものを受け取る）
+    static QStringList convertLines(const QStringList& lines, const QString& initialSfen,
+                                    QString* errorMessage);
+    static QList<KifDisplayItem> extractMovesWithTimesFromLines(const QStringList& lines,
+                                                                const QString& initialSfen);
+
     static QString generateModifier(
         const QList<Ki2Lexer::Candidate>& candidates,
         int srcFile, int srcRank,
@@ -205,9 +205,7 @@ static QString buildEndingLine(int lastActualMoveNo, const QString& terminalMove
 static bool hasNextSibling(KifuBranchNode* node)
 {
     if (node == nullptr || node->parent() == nullptr) return false;
-    const QList<KifuBranchNode*>& siblings = node->parent()->children();
-    const auto myIndex = siblings.indexOf(node);
-    return myIndex >= 0 && myIndex < siblings.size() - 1;
+    return node->nextSibling() != nullptr;
 }
 
 // ヘルパ関数: KIF形式の指し手行を生成
@@ -25,8 +25,13 @@ QString KifToSfenConverter::detectInitialSfenFromFile(const QString& kifPath, QS
         if (detectedLabel) *detectedLabel = QStringLiteral("平手(既定)");
         return NotationUtils::mapHandicapToSfen(QStringLiteral("平手"));
     }
+    return detectInitialSfenFromLines(lines, detectedLabel);
+}
 
+QString KifToSfenConverter::detectInitialSfenFromLines(const QStringList& lines, QString* detectedLabel)
+{
     // 先に BOD を試す
+    QString warn;
     QString bodSfen;
     if (buildInitialSfenFromBod(lines, bodSfen, detectedLabel, &warn)) {
         qCDebug(lcKifu).noquote() << "BOD detected. sfen =" << bodSfen;
@@ -57,11 +62,15 @@ QString KifToSfenConverter::detectInitialSfenFromFile(const QString& kifPath, QS
 QList<KifDisplayItem> KifToSfenConverter::extractMovesWithTimes(const QString& kifPath,
                                                                 QString* errorMessage)
 {
-    QList<KifDisplayItem> out;
     QString usedEnc;
     QStringList lines;
-    if (!KifReader::readLinesAuto(kifPath, lines, &usedEnc, errorMessage)) return out;
+    if (!KifReader::readLinesAuto(kifPath, lines, &usedEnc, errorMessage)) return {};
+    return extractMovesWithTimesFromLines(lines);
+}
 
+QList<KifDisplayItem> KifToSfenConverter::extractMovesWithTimesFromLines(const QStringList& lines)
+{
+    QList<KifDisplayItem> out;
     QString openingCommentBuf;
     QString openingBookmarkBuf;
     QString commentBuf;
@@ -140,11 +149,15 @@ QList<KifDisplayItem> KifToSfenConverter::extractMovesWithTimes(const QString& k
 
 QStringList KifToSfenConverter::convertFile(const QString& kifPath, QString* errorMessage)
 {
-    QStringList out;
     QString usedEnc;
     QStringList lines;
-    if (!KifReader::readLinesAuto(kifPath, lines, &usedEnc, errorMessage)) return out;
+    if (!KifReader::readLinesAuto(kifPath, lines, &usedEnc, errorMessage)) return {};
+    return convertLines(lines, errorMessage);
+}
 
+QStringList KifToSfenConverter::convertLines(const QStringList& lines, QString* errorMessage)
+{
+    QStringList out;
     int prevToFile = 0, prevToRank = 0;
 
     for (const QString& raw : std::as_const(lines)) {
@@ -198,17 +211,23 @@ bool KifToSfenConverter::parseWithVariations(const QString& kifPath,
 {
     out = KifParseResult{};
 
-    // フェーズ1: 本譜抽出
-    extractMainLine(kifPath, out, errorMessage);
-
-    // フェーズ2: 変化抽出用にファイル読み込み
     QString usedEnc;
     QStringList lines;
     if (!KifReader::readLinesAuto(kifPath, lines, &usedEnc, errorMessage)) {
         return false;
     }
+    return parseLines(lines, out, errorMessage);
+}
+
+bool KifToSfenConverter::parseLines(const QStringList& lines, KifParseResult& out, QString* errorMessage)
+{
+    out = KifParseResult{};
 
-    // フェーズ3: 変化ブロックの収集と解析
+    // フェーズ1: 本譜抽出（初期局面・指し手・表示データ）とヘッダ
+    extractMainLine(lines, out, errorMessage);
+    out.gameInfo = extractGameInfoFromLines(lines);
+
+    // フェーズ2: 変化ブロックの収集と解析
     QList<KifVariation> vars;
     int i = 0;
 
@@ -243,14 +262,13 @@ bool KifToSfenConverter::parseWithVariations(const QString& kifPath,
     return true;
 }
 
-void KifToSfenConverter::extractMainLine(const QString& kifPath,
+void KifToSfenConverter::extractMainLine(const QStringList& lines,
                                           KifParseResult& out,
                                           QString* errorMessage)
 {
-    QString teai;
-    out.mainline.baseSfen = detectInitialSfenFromFile(kifPath, &teai);
-    out.mainline.disp     = extractMovesWithTimes(kifPath, errorMessage);
-    out.mainline.usiMoves = convertFile(kifPath, errorMessage);
+    out.mainline.baseSfen = detectInitialSfenFromLines(lines, &out.teaiLabel);
+    out.mainline.disp     = extractMovesWithTimesFromLines(lines);
+    out.mainline.usiMoves = convertLines(lines, errorMessage);
 
     out.mainline.sfenList = SfenPositionTracer::buildSfenRecord(
         out.mainline.baseSfen, out.mainline.usiMoves, false);
@@ -405,7 +423,11 @@ QList<KifGameInfoItem> KifToSfenConverter::extractGameInfo(const QString& filePa
         qCWarning(lcKifu).noquote() << "read failed:" << filePath << "warn:" << warn;
         return {};
     }
+    return extractGameInfoFromLines(lines);
+}
 
+QList<KifGameInfoItem> KifToSfenConverter::extractGameInfoFromLines(const QStringList& lines)
+{
     static const QRegularExpression kLineLooksLikeMoveNo(
         QStringLiteral("^\\s*[0-9０-９]+\\s")
     );
@@ -455,37 +477,3 @@ bool KifToSfenConverter::buildInitialSfenFromBod(const QStringList& lines,
 
     return true;
 }
-
-QString KifToSfenConverter::extractOpeningComment(const QString& filePath)
-{
-    QString usedEnc, warn;
-    QStringList lines;
-    if (!KifReader::readLinesAuto(filePath, lines, &usedEnc, &warn)) {
-        qCWarning(lcKifu).noquote() << "read failed for opening comment:" << filePath << "warn:" << warn;
-        return QString();
-    }
-
-    QString buf;
-
-    for (const QString& raw : std::as_const(lines)) {
-        const QString t = raw.trimmed();
-        if (t.isEmpty()) continue;
-        if (KifuParseCommon::isKifSkippableHeaderLine(t)
-            || KifuParseCommon::isBoardHeaderOrFrame(t)) continue;
-
-        if (KifLexer::startsWithMoveNumber(t).has_value()) break;
-        if (KifLexer::variationHeaderRe().match(t).hasMatch()) break;
-
-        if (t.startsWith(QChar(u'*')) || t.startsWith(QChar(u'＊'))) {
-            const QString c = t.mid(1).trimmed();
-            if (!c.isEmpty()) {
-                if (!buf.isEmpty()) buf += QLatin1Char('\n');
-                buf += c;
-            }
-            continue;
-        }
-
-        if (t.startsWith(QLatin1Char('&'))) continue;
-    }
-    return buf;
-}
@@ -27,6 +27,16 @@ public:
     // 新API：本譜＋全変化をまとめて抽出（コメントも格納）
     [[nodiscard]] static bool parseWithVariations(const QString& kifPath, KifParseResult& out, QString* errorMessage = nullptr);
 
+    // 一括API：デコード済みの行から初期局面・手合割・対局情報・本譜・変化を1回で抽出
+    //   （ファイルの読み込みと文字コード判定は呼び出し側で1度だけ行う）
+    [[nodiscard]] static bool parseLines(const QStringList& lines, KifParseResult& out, QString* errorMessage = nullptr);
+
+    // 行ベース版（ファイル版はこれらに委譲する）
+    static QString detectInitialSfenFromLines(const QStringList& lines, QString* detectedLabel = nullptr);
+    static QStringList convertLines(const QStringList& lines, QString* errorMessage = nullptr);
+    static QList<KifDisplayItem> extractMovesWithTimesFromLines(const QStringList& lines);
+    static QList<KifGameInfoItem> extractGameInfoFromLines(const QStringList& lines);
+
     // 手合→初期SFEN（ユーザー提供のマップ）
     static QString mapHandicapToSfen(const QString& label);
 
@@ -43,10 +53,8 @@ public:
                                         QString* detectedLabel = nullptr, QString* warn = nullptr);
 
 private:
-    static QString extractOpeningComment(const QString& filePath);
-
     // ---------- parseWithVariations ヘルパ ----------
-    static void extractMainLine(const QString& kifPath, KifParseResult& out, QString* errorMessage);
+    static void extractMainLine(const QStringList& lines, KifParseResult& out, QString* errorMessage);
     static QString findBranchBaseSfen(const QList<KifVariation>& vars,
                                       const KifLine& mainLine,
                                       int branchPointPly);
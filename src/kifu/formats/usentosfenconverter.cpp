@@ -20,7 +20,11 @@ QString UsenToSfenConverter::detectInitialSfenFromFile(const QString& usenPath,
         if (detectedLabel) *detectedLabel = QStringLiteral("平手(既定)");
         return SfenUtils::hirateSfen();
     }
+    return detectInitialSfenFromContent(content, detectedLabel);
+}
 
+QString UsenToSfenConverter::detectInitialSfenFromContent(const QString& content, QString* detectedLabel)
+{
     // ~ の位置を探す
     const qsizetype tildePos = content.indexOf(QChar('~'));
     if (tildePos < 0) {
@@ -75,7 +79,7 @@ QList<KifDisplayItem> UsenToSfenConverter::extractMovesWithTimes(const QString&
     }
 
     // 初期局面を取得
-    const QString initialSfen = detectInitialSfenFromFile(usenPath, nullptr);
+    const QString initialSfen = detectInitialSfenFromContent(content, nullptr);
 
     QString terminalCode;
     const QStringList usiMoves = decodeUsenMoves(content, &terminalCode);
@@ -105,9 +109,20 @@ bool UsenToSfenConverter::parseWithVariations(const QString& usenPath,
     if (!readUsenFile(usenPath, content, errorMessage)) {
         return false;
     }
+    return parseContent(content, out, errorMessage);
+}
+
+bool UsenToSfenConverter::parseContent(const QString& content, KifParseResult& out, QString* errorMessage)
+{
+    out = KifParseResult{};
+
+    if (content.isEmpty()) {
+        if (errorMessage) *errorMessage = QStringLiteral("ファイルが空です");
+        return false;
+    }
 
     // 初期局面を取得
-    const QString initialSfen = detectInitialSfenFromFile(usenPath, nullptr);
+    const QString initialSfen = detectInitialSfenFromContent(content, &out.teaiLabel);
 
     // 本譜と分岐を分離
     QString mainlineUsen;
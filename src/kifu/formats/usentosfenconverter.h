@@ -47,6 +47,9 @@ public:
     // 新API: 本譜＋全変化をまとめて抽出（コメントも格納）
     [[nodiscard]] static bool parseWithVariations(const QString& usenPath, KifParseResult& out, QString* errorMessage = nullptr);
 
+    // 一括API: 読み込み済みのUSEN文字列（前後の空白は除去済み）から初期局面・手合割・本譜・変化を1回で抽出
+    [[nodiscard]] static bool parseContent(const QString& content, KifParseResult& out, QString* errorMessage = nullptr);
+
     // USENファイルから「対局情報」を抽出して順序付きで返す
     // 注意: USENは基本的にメタ情報を含まないため、ファイル名から推測するか空を返す
     static QList<KifGameInfoItem> extractGameInfo(const QString& filePath);
@@ -69,6 +72,9 @@ private:
     // USENファイルを読み込み文字列を返す
     static bool readUsenFile(const QString& filePath, QString& content, QString* warn);
 
+    // USEN文字列の「~」より前から初期局面SFENを求める
+    static QString detectInitialSfenFromContent(const QString& content, QString* detectedLabel);
+
     // USEN文字列を解析して本譜と分岐に分割
     static bool parseUsenString(const QString& usen, 
                                 QString& mainlineUsen,
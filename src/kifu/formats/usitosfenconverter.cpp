@@ -209,8 +209,20 @@ bool UsiToSfenConverter::parseWithVariations(const QString& usiPath,
 {
     out = KifParseResult{};
 
+    QStringList lines;
+    QString usedEnc;
+    if (!KifReader::readAllLinesAuto(usiPath, lines, &usedEnc, errorMessage)) {
+        return false;
+    }
+    return parseLines(lines, out, errorMessage);
+}
+
+bool UsiToSfenConverter::parseLines(const QStringList& lines, KifParseResult& out, QString* errorMessage)
+{
+    out = KifParseResult{};
+
     QString content;
-    if (!readUsiFile(usiPath, content, errorMessage)) {
+    if (!firstNonEmptyLine(lines, content, errorMessage)) {
         return false;
     }
 
@@ -224,6 +236,7 @@ bool UsiToSfenConverter::parseWithVariations(const QString& usiPath,
 
     // 本譜のメタデータを設定
     out.mainline.baseSfen = baseSfen;
+    out.teaiLabel = (baseSfen == SfenUtils::hirateSfen()) ? QStringLiteral("平手") : QStringLiteral("局面指定");
     out.mainline.startPly = 1;
     out.mainline.usiMoves = usiMoves;
 
@@ -282,7 +295,11 @@ bool UsiToSfenConverter::readUsiFile(const QString& filePath, QString& content,
     if (!KifReader::readAllLinesAuto(filePath, lines, &usedEnc, warn)) {
         return false;
     }
+    return firstNonEmptyLine(lines, content, warn);
+}
 
+bool UsiToSfenConverter::firstNonEmptyLine(const QStringList& lines, QString& content, QString* warn)
+{
     // 複数行を連結（空行や空白のみの行は無視）
     QStringList nonEmptyLines;
     for (const QString& line : std::as_const(lines)) {
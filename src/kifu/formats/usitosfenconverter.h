@@ -52,6 +52,9 @@ public:
     // 新API: 本譜＋全変化をまとめて抽出（コメントも格納）
     [[nodiscard]] static bool parseWithVariations(const QString& usiPath, KifParseResult& out, QString* errorMessage = nullptr);
 
+    // 一括API: デコード済みの行（最初の非空行を使用）から初期局面・手合割・本譜を1回で抽出
+    [[nodiscard]] static bool parseLines(const QStringList& lines, KifParseResult& out, QString* errorMessage = nullptr);
+
     // USIファイルから「対局情報」を抽出して順序付きで返す
     // 注意: USIは基本的にメタ情報を含まないため、ファイル名から推測するか空を返す
     static QList<KifGameInfoItem> extractGameInfo(const QString& filePath);
@@ -68,6 +71,9 @@ private:
     // USIファイルを読み込み文字列を返す
     static bool readUsiFile(const QString& filePath, QString& content, QString* warn);
 
+    // 行リストから最初の非空行（前後の空白を除去）を取り出す
+    static bool firstNonEmptyLine(const QStringList& lines, QString& content, QString* warn);
+
     // ---- USI 文字列解析 ----
 
     // USI position コマンド文字列を解析して初期局面SFENと指し手列を取得
@@ -14,6 +14,8 @@ inline const QString kStartDateTime = QStringLiteral("開始日時");
 inline const QString kEndDateTime = QStringLiteral("終了日時");
 inline const QString kBlackPlayer = QStringLiteral("先手");
 inline const QString kWhitePlayer = QStringLiteral("後手");
+inline const QString kBlackRating = QStringLiteral("先手レーティング");
+inline const QString kWhiteRating = QStringLiteral("後手レーティング");
 inline const QString kHandicap = QStringLiteral("手合割");
 inline const QString kTimeControl = QStringLiteral("持ち時間");
 
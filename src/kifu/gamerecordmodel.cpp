@@ -11,7 +11,6 @@
 #include "usenexporter.h"
 #include "usiexporter.h"
 
-#include <QTableWidget>
 #include <QDateTime>
 #include "logcategories.h"
 
@@ -300,17 +299,12 @@ QList<KifGameInfoItem> GameRecordModel::collectGameInfo(const ExportContext& ctx
 {
     QList<KifGameInfoItem> items;
 
-    // a) 既存の「対局情報」テーブルがあれば採用
-    if (ctx.gameInfoTable && ctx.gameInfoTable->rowCount() > 0) {
-        const int rows = ctx.gameInfoTable->rowCount();
-        for (int r = 0; r < rows; ++r) {
-            const QTableWidgetItem* keyItem   = ctx.gameInfoTable->item(r, 0);
-            const QTableWidgetItem* valueItem = ctx.gameInfoTable->item(r, 1);
-            if (!keyItem) continue;
-            const QString key = keyItem->text().trimmed();
-            const QString val = valueItem ? valueItem->text().trimmed() : QString();
+    // a) 既存の対局情報（「対局情報」タブの内容や読み込んだ棋譜のヘッダ）があれば採用
+    if (!ctx.gameInfo.isEmpty()) {
+        for (const KifGameInfoItem& item : ctx.gameInfo) {
+            const QString key = item.key.trimmed();
             if (!key.isEmpty()) {
-                items.push_back({key, val});
+                items.push_back({key, item.value.trimmed()});
             }
         }
         return items;
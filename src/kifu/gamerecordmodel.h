@@ -17,7 +17,6 @@
 #include "kifubranchtree.h"
 #include "playmode.h"
 
-class QTableWidget;
 class KifuRecordListModel;
 class KifuNavigationState;
 
@@ -154,7 +153,7 @@ public:
      * @brief 出力に必要なコンテキスト情報
      */
     struct ExportContext {
-        const QTableWidget* gameInfoTable = nullptr;
+        QList<KifGameInfoItem> gameInfo;    ///< 対局情報（空なら対局者名などから自動生成）
         const KifuRecordListModel* recordModel = nullptr;
         QString startSfen;
         PlayMode playMode = PlayMode::NotStarted;
@@ -51,8 +51,10 @@ struct KifVariation {
  *
  */
 struct KifParseResult {
-    KifLine mainline;                  ///< 本譜
+    KifLine mainline;                  ///< 本譜（mainline.baseSfen が初期局面）
     QList<KifVariation> variations;  ///< 変化リスト
+    QString teaiLabel;                 ///< 手合割の表示名（空なら未判定）
+    QList<KifGameInfoItem> gameInfo;   ///< 対局情報（ヘッダを持たない形式では空）
 };
 
 #endif // KIFPARSETYPES_H
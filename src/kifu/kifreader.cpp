@@ -113,8 +113,15 @@ bool readAllLinesAuto(const QString& filePath,
         if (warn) *warn += QStringLiteral("open failed: %1\n").arg(filePath);
         return false;
     }
-    const QByteArray bytes = f.readAll();
+    decodeLinesAuto(f.readAll(), outLines, usedEncoding, warn);
+    return true;
+}
 
+void decodeLinesAuto(const QByteArray& bytes,
+                     QStringList& outLines,
+                     QString* usedEncoding,
+                     QString* warn)
+{
     QString text;
     // 1) BOM 優先
     if (!decodeByBom(bytes, text, usedEncoding)) {
@@ -149,13 +156,12 @@ bool readAllLinesAuto(const QString& filePath,
     }
 
     if (usedEncoding) {
-        qCDebug(lcKifu).noquote() << QStringLiteral("readAllLinesAuto: encoding = %1, bytes = %2")
+        qCDebug(lcKifu).noquote() << QStringLiteral("decodeLinesAuto: encoding = %1, bytes = %2")
                                           .arg(*usedEncoding)
                                           .arg(bytes.size());
     }
 
     splitByNewlines(text, outLines);
-    return true;
 }
 
 } // namespace KifReader
@@ -4,6 +4,7 @@
 /// @file kifreader.h
 /// @brief 棋譜ファイルの文字コード自動判別読み込み機能の定義
 
+#include <QByteArray>
 #include <QString>
 #include <QStringList>
 
@@ -29,6 +30,20 @@ bool readAllLinesAuto(const QString& filePath,
                       QString* usedEncoding = nullptr,
                       QString* warn = nullptr);
 
+/**
+ * @brief 読み込み済みのバイト列を readAllLinesAuto() と同じ手順で判別・デコードして行に分割する
+ *
+ * 棋譜読み込みでファイルを1度だけ読み、ワーカースレッドでデコードするときに使う。
+ * @param bytes ファイルの内容
+ * @param outLines 出力先の行リスト
+ * @param usedEncoding 実際に使われたエンコーディング名
+ * @param warn デコード中の注意点を追記する先
+ */
+void decodeLinesAuto(const QByteArray& bytes,
+                     QStringList& outLines,
+                     QString* usedEncoding = nullptr,
+                     QString* warn = nullptr);
+
 /// 互換API（旧名）: 既存コードが KifReader::readLinesAuto() を呼んでいても動作する
 inline bool readLinesAuto(const QString& filePath,
                           QStringList& outLines,
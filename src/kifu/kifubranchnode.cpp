@@ -2,6 +2,7 @@
 /// @brief 分岐ツリーノードクラスの実装
 
 #include "kifubranchnode.h"
+#include "kifupositioncache.h"
 
 // ============================================================
 // 自由関数
@@ -34,24 +35,74 @@ KifuBranchNode::~KifuBranchNode()
     // 子ノードは所有しない（KifuBranchTreeが一括管理）
 }
 
+// ============================================================
+// 局面・指し手
+// ============================================================
+
+QString KifuBranchNode::sfen() const
+{
+    if (m_positionSource == PositionSource::Anchor || m_positionCache == nullptr) {
+        return m_sfen;
+    }
+    return m_positionCache->sfenOf(this);
+}
+
+ShogiMove KifuBranchNode::move() const
+{
+    return ShogiMove(QPoint(m_move.fromX, m_move.fromY), QPoint(m_move.toX, m_move.toY),
+                     m_move.movingPiece, m_move.capturedPiece, m_move.promotion);
+}
+
+void KifuBranchNode::setMove(const ShogiMove& move)
+{
+    m_move.fromX = static_cast<qint8>(move.fromSquare.x());
+    m_move.fromY = static_cast<qint8>(move.fromSquare.y());
+    m_move.toX = static_cast<qint8>(move.toSquare.x());
+    m_move.toY = static_cast<qint8>(move.toSquare.y());
+    m_move.movingPiece = move.movingPiece;
+    m_move.capturedPiece = move.capturedPiece;
+    m_move.promotion = move.isPromotion;
+}
+
 // ============================================================
 // ツリー構造操作
 // ============================================================
 
+QList<KifuBranchNode*> KifuBranchNode::children() const
+{
+    QList<KifuBranchNode*> result;
+    result.reserve(m_childCount);
+    for (KifuBranchNode* child = m_firstChild; child != nullptr; child = child->m_nextSibling) {
+        result.append(child);
+    }
+    return result;
+}
+
 void KifuBranchNode::addChild(KifuBranchNode* child)
 {
-    if (child && !m_children.contains(child)) {
-        m_children.append(child);
-        child->setParent(this);
+    if (child == nullptr || child->m_parent == this) {
+        return;
     }
+    if (m_lastChild != nullptr) {
+        m_lastChild->m_nextSibling = child;
+    } else {
+        m_firstChild = child;
+    }
+    m_lastChild = child;
+    ++m_childCount;
+    child->setParent(this);
 }
 
 KifuBranchNode* KifuBranchNode::childAt(int index) const
 {
-    if (index >= 0 && index < m_children.size()) {
-        return m_children.at(index);
+    if (index < 0 || index >= m_childCount) {
+        return nullptr;
+    }
+    KifuBranchNode* child = m_firstChild;
+    for (int i = 0; i < index; ++i) {
+        child = child->m_nextSibling;
     }
-    return nullptr;
+    return child;
 }
 
 // ============================================================
@@ -64,8 +115,7 @@ bool KifuBranchNode::isMainLine() const
         return true;
     }
     // 親の最初の子が自分なら本譜
-    const auto& siblings = m_parent->children();
-    return !siblings.isEmpty() && siblings.first() == this;
+    return m_parent->m_firstChild == this;
 }
 
 QString KifuBranchNode::lineName() const
@@ -94,9 +144,10 @@ int KifuBranchNode::lineIndex() const
         const KifuBranchNode* next = path.at(i + 1);
 
         if (current->childCount() > 1) {
-            const auto& children = current->children();
-            for (int j = 0; j < children.size(); ++j) {
-                if (children.at(j) == next) {
+            int j = 0;
+            for (const KifuBranchNode* child = current->m_firstChild; child != nullptr;
+                 child = child->m_nextSibling, ++j) {
+                if (child == next) {
                     return j;
                 }
             }
@@ -113,7 +164,7 @@ QList<KifuBranchNode*> KifuBranchNode::siblings() const
         return result;
     }
 
-    for (KifuBranchNode* child : std::as_const(m_parent->m_children)) {
+    for (KifuBranchNode* child = m_parent->m_firstChild; child != nullptr; child = child->m_nextSibling) {
         if (child != this) {
             result.append(child);
         }
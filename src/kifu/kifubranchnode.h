@@ -9,6 +9,8 @@
 
 #include "shogimove.h"
 
+class KifuPositionCache;
+
 /**
  * @brief 終局手の種類
  *
@@ -39,7 +41,10 @@ TerminalType detectTerminalType(const QString& displayText);
  *
  * 棋譜の1手（または開始局面）を表すノード。
  * ツリー構造で分岐を表現し、KifuBranchTreeが所有する。
+ * 子は最初の子／次の兄弟のリンクで辿る（ノード自体はツリーのアリーナに並ぶ）。
  *
+ * 局面SFENは原則として保持せず、親局面と自分の指し手から KifuPositionCache が
+ * 必要なときに復元する。指し手で再現できない局面だけをアンカーとして文字列で持つ。
  */
 class KifuBranchNode
 {
@@ -59,24 +64,26 @@ public:
     void setPly(int ply) { m_ply = ply; }
 
     /// 表示テキストを取得（例: "▲７六歩(77)"）
-    QString displayText() const { return m_displayText; }
+    const QString& displayText() const { return m_displayText; }
     void setDisplayText(const QString& text) { m_displayText = text; }
 
-    /// この局面のSFENを取得
-    QString sfen() const { return m_sfen; }
-    void setSfen(const QString& sfen) { m_sfen = sfen; }
+    /// この局面のSFENを取得（アンカー以外は祖先からの再生で復元する）
+    QString sfen() const;
+
+    /// 手数を除いた局面の64ビットキー（局面未設定なら0）
+    quint64 positionKey() const { return m_positionKey; }
 
     /// この手を表すShogiMoveを取得（ply=0や終局手は無効）
-    ShogiMove move() const { return m_move; }
-    void setMove(const ShogiMove& move) { m_move = move; }
+    ShogiMove move() const;
+    void setMove(const ShogiMove& move);
 
-    QString comment() const { return m_comment; }
+    const QString& comment() const { return m_comment; }
     void setComment(const QString& comment) { m_comment = comment; }
 
-    QString bookmark() const { return m_bookmark; }
+    const QString& bookmark() const { return m_bookmark; }
     void setBookmark(const QString& bookmark) { m_bookmark = bookmark; }
 
-    QString timeText() const { return m_timeText; }
+    const QString& timeText() const { return m_timeText; }
     void setTimeText(const QString& time) { m_timeText = time; }
 
     TerminalType terminalType() const { return m_terminalType; }
@@ -88,12 +95,18 @@ public:
     KifuBranchNode* parent() const { return m_parent; }
     void setParent(KifuBranchNode* parent) { m_parent = parent; }
 
-    /// 子ノード（分岐）を取得
-    const QList<KifuBranchNode*>& children() const { return m_children; }
+    /// 子ノード（分岐）を取得（兄弟リンクから組み立てる）
+    QList<KifuBranchNode*> children() const;
     void addChild(KifuBranchNode* child);
-    int childCount() const { return static_cast<int>(m_children.size()); }
+    int childCount() const { return m_childCount; }
     KifuBranchNode* childAt(int index) const;
 
+    /// 最初の子（本譜側）。子がなければnullptr
+    KifuBranchNode* firstChild() const { return m_firstChild; }
+
+    /// 同じ親の次の子（次の分岐）。末尾ならnullptr
+    KifuBranchNode* nextSibling() const { return m_nextSibling; }
+
     // --- クエリ ---
 
     /// 本譜かどうか（親の最初の子であるかどうかで判定）
@@ -112,24 +125,53 @@ public:
     bool isActualMove() const { return !isTerminal() && m_ply > 0; }
 
     /// 分岐があるかどうか（子が2つ以上）
-    bool hasBranch() const { return m_children.size() > 1; }
+    bool hasBranch() const { return m_childCount > 1; }
 
     /// このノードの兄弟ノードを取得（自分を除く）
     QList<KifuBranchNode*> siblings() const;
 
 private:
+    friend class KifuBranchTree;
+    friend class KifuPositionCache;
+
+    /// 局面の求め方
+    enum class PositionSource : quint8 {
+        Anchor,      ///< m_sfen をそのまま使う
+        ParentMove,  ///< 親局面に m_move を適用する
+        Parent       ///< 親局面と同じ（終局手）
+    };
+
+    /// 指し手の詰め込み表現（座標は ShogiMove と同じ 0-indexed、駒台は 9/10）
+    struct PackedMove {
+        qint8 fromX = 0;
+        qint8 fromY = 0;
+        qint8 toX = 0;
+        qint8 toY = 0;
+        Piece movingPiece = Piece::None;
+        Piece capturedPiece = Piece::None;
+        bool promotion = false;
+    };
+
     int m_nodeId = -1;                                  ///< ノードID（ツリー内で一意）
     int m_ply = 0;                                      ///< 手数（0=開始局面）
     QString m_displayText;                              ///< 表示テキスト
-    QString m_sfen;                                     ///< この局面のSFEN
-    ShogiMove m_move;                                   ///< 指し手データ
+    QString m_sfen;                                     ///< アンカー局面のSFEN（それ以外は空）
+    quint64 m_positionKey = 0;                          ///< 手数を除いた局面のキー
+    KifuPositionCache* m_positionCache = nullptr;       ///< 局面の復元元（非所有）
+    PositionSource m_positionSource = PositionSource::Anchor; ///< 局面の求め方
+    PackedMove m_move;                                  ///< 指し手データ
     QString m_comment;                                  ///< コメント
     QString m_bookmark;                                 ///< しおり
     QString m_timeText;                                 ///< 消費時間テキスト
     TerminalType m_terminalType = TerminalType::None;   ///< 終局手の種類
 
     KifuBranchNode* m_parent = nullptr;                 ///< 親ノード（非所有）
-    QList<KifuBranchNode*> m_children;                ///< 子ノードリスト（非所有、KifuBranchTreeが所有）
+    KifuBranchNode* m_firstChild = nullptr;             ///< 最初の子（非所有、KifuBranchTreeが所有）
+    KifuBranchNode* m_lastChild = nullptr;              ///< 最後の子（追加をO(1)にする）
+    KifuBranchNode* m_nextSibling = nullptr;            ///< 次の兄弟
+    int m_childCount = 0;                               ///< 子の数
+    int m_lineFirst = 0;                                ///< このノードを通る最初のラインのインデックス
+    int m_lineSpan = 1;                                 ///< このノードを通るライン数（部分木の葉の数）
 };
 
 #endif // KIFUBRANCHNODE_H
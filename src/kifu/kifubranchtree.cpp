@@ -16,9 +16,7 @@ KifuBranchTree::~KifuBranchTree()
     // 破棄中は受信側が無効な状態である可能性があるため、
     // シグナルなしで直接クリーンアップする。
     m_linesCache.clear();  // ダングリングポインタ防止
-    qDeleteAll(m_nodeById);
-    m_nodeById.clear();
-    m_root = nullptr;
+    releaseNodes();
 }
 
 void KifuBranchTree::clear()
@@ -30,8 +28,15 @@ void KifuBranchTree::clear()
     // 呼び出し側が必要に応じてシグナルを発行する。
     m_linesCache.clear();  // メモリ解放 + ダングリングポインタ防止
     m_linesCacheDirty = true;
-    qDeleteAll(m_nodeById);
-    m_nodeById.clear();
+    releaseNodes();
+}
+
+void KifuBranchTree::releaseNodes()
+{
+    // ノードを1つずつ delete せず、ブロック単位でまとめて解放する
+    m_nodesByPositionKey.clear();
+    m_positionCache.clear();
+    m_nodeBlocks.clear();
     m_root = nullptr;
     m_nextNodeId = 1;
 }
@@ -43,20 +48,33 @@ void KifuBranchTree::setRootSfen(const QString& sfen)
     m_root = createNode();
     m_root->setPly(0);
     m_root->setDisplayText(tr("開始局面"));
-    m_root->setSfen(sfen);
+    m_positionCache.attach(m_root, sfen);
+    indexPosition(m_root);
 
     emit treeChanged();
 }
 
 KifuBranchNode* KifuBranchTree::createNode()
 {
-    auto* node = new KifuBranchNode();
+    // ノードID n はアリーナの (n - 1) 番目に置く
+    const int index = m_nextNodeId - 1;
+    const auto block = static_cast<size_t>(index / kNodeBlockSize);
+    if (block == m_nodeBlocks.size()) {
+        m_nodeBlocks.push_back(std::make_unique<KifuBranchNode[]>(kNodeBlockSize));
+    }
+    KifuBranchNode* node = &m_nodeBlocks[block][index % kNodeBlockSize];
     node->setNodeId(m_nextNodeId);
-    m_nodeById.insert(m_nextNodeId, node);
     m_nextNodeId++;
     return node;
 }
 
+void KifuBranchTree::indexPosition(KifuBranchNode* node)
+{
+    if (node->positionKey() != 0) {
+        m_nodesByPositionKey.insert(node->positionKey(), node);
+    }
+}
+
 KifuBranchNode* KifuBranchTree::addMove(KifuBranchNode* parent,
                                         const ShogiMove& move,
                                         const QString& displayText,
@@ -75,7 +93,6 @@ KifuBranchNode* KifuBranchTree::addMove(KifuBranchNode* parent,
     auto* node = createNode();
     node->setPly(parent->ply() + 1);
     node->setDisplayText(displayText);
-    node->setSfen(sfen);
     node->setMove(move);
     node->setTimeText(timeText);
 
@@ -84,7 +101,9 @@ KifuBranchNode* KifuBranchTree::addMove(KifuBranchNode* parent,
     node->setTerminalType(termType);
 
     parent->addChild(node);
-    invalidateLineCache();
+    m_positionCache.attach(node, sfen);
+    indexPosition(node);
+    updateLinesForNewNode(node);
 
     emit treeChanged();
 
@@ -108,12 +127,13 @@ KifuBranchNode* KifuBranchTree::addTerminalMove(KifuBranchNode* parent,
     auto* node = createNode();
     node->setPly(parent->ply() + 1);
     node->setDisplayText(displayText);
-    node->setSfen(parent->sfen());  // 終局手は盤面変化なし
     node->setTimeText(timeText);
     node->setTerminalType(type);
 
     parent->addChild(node);
-    invalidateLineCache();
+    m_positionCache.attachSameAsParent(node);  // 終局手は盤面変化なし
+    indexPosition(node);
+    updateLinesForNewNode(node);
 
     emit treeChanged();
 
@@ -138,7 +158,6 @@ KifuBranchNode* KifuBranchTree::addMoveQuiet(KifuBranchNode* parent,
     auto* node = createNode();
     node->setPly(parent->ply() + 1);
     node->setDisplayText(displayText);
-    node->setSfen(sfen);
     node->setMove(move);
     node->setTimeText(timeText);
 
@@ -147,14 +166,20 @@ KifuBranchNode* KifuBranchTree::addMoveQuiet(KifuBranchNode* parent,
     node->setTerminalType(termType);
 
     parent->addChild(node);
-    invalidateLineCache();
+    m_positionCache.attach(node, sfen);
+    indexPosition(node);
+    updateLinesForNewNode(node);
 
     return node;
 }
 
 KifuBranchNode* KifuBranchTree::nodeAt(int nodeId) const
 {
-    return m_nodeById.value(nodeId, nullptr);
+    if (nodeId < 1 || nodeId >= m_nextNodeId) {
+        return nullptr;
+    }
+    const int index = nodeId - 1;
+    return &m_nodeBlocks[static_cast<size_t>(index / kNodeBlockSize)][index % kNodeBlockSize];
 }
 
 KifuBranchNode* KifuBranchTree::findByPlyOnLine(KifuBranchNode* lineEnd, int ply) const
@@ -196,47 +221,25 @@ KifuBranchNode* KifuBranchTree::findByPlyOnMainLine(int ply) const
 
 KifuBranchNode* KifuBranchTree::findBySfen(const QString& sfen) const
 {
-    if (sfen.isEmpty()) {
+    const quint64 key = KifuPositionCache::positionKey(sfen);
+    if (key == 0) {
         return nullptr;
     }
 
-    // 入力SFENから手数部分を除去
-    QString targetSfen = sfen;
-    qsizetype lastSpace = targetSfen.lastIndexOf(QLatin1Char(' '));
-    if (lastSpace > 0) {
-        // 最後のスペース以降が数字のみなら手数部分として除去
-        QString suffix = targetSfen.mid(lastSpace + 1);
-        bool isNumber = false;
-        suffix.toInt(&isNumber);
-        if (isNumber) {
-            targetSfen = targetSfen.left(lastSpace);
-        }
-    }
-
-    // 全ノードを検索
-    for (KifuBranchNode* node : std::as_const(m_nodeById)) {
-        QString nodeSfen = node->sfen();
-        if (nodeSfen.isEmpty()) {
+    // キーの衝突に備えて、手数を除いたSFENが一致することを確かめる
+    const QStringView targetSfen = KifuPositionCache::stripPly(sfen);
+    KifuBranchNode* found = nullptr;
+    for (auto it = m_nodesByPositionKey.constFind(key); it != m_nodesByPositionKey.cend() && it.key() == key; ++it) {
+        KifuBranchNode* node = it.value();
+        if (found != nullptr && found->nodeId() < node->nodeId()) {
             continue;
         }
-
-        // ノードのSFENからも手数部分を除去して比較
-        qsizetype nodeLastSpace = nodeSfen.lastIndexOf(QLatin1Char(' '));
-        if (nodeLastSpace > 0) {
-            QString nodeSuffix = nodeSfen.mid(nodeLastSpace + 1);
-            bool isNumber = false;
-            nodeSuffix.toInt(&isNumber);
-            if (isNumber) {
-                nodeSfen = nodeSfen.left(nodeLastSpace);
-            }
-        }
-
-        if (nodeSfen == targetSfen) {
-            return node;
+        const QString nodeSfen = node->sfen();
+        if (KifuPositionCache::stripPly(nodeSfen) == targetSfen) {
+            found = node;
         }
     }
-
-    return nullptr;
+    return found;
 }
 
 QList<KifuBranchNode*> KifuBranchTree::mainLine() const
@@ -270,28 +273,113 @@ QList<KifuBranchNode*> KifuBranchTree::pathToNode(KifuBranchNode* node) const
 }
 
 QList<BranchLine> KifuBranchTree::allLines() const
+{
+    return cachedLines();
+}
+
+const QList<BranchLine>& KifuBranchTree::cachedLines() const
 {
     if (!m_linesCacheDirty) {
         return m_linesCache;
     }
 
     m_linesCache.clear();
-    if (m_root == nullptr) {
-        m_linesCacheDirty = false;
-        return m_linesCache;
+    if (m_root != nullptr) {
+        QList<KifuBranchNode*> currentPath;
+        int lineIndex = 0;
+        collectLinesRecursive(m_root, currentPath, m_linesCache, lineIndex);
     }
 
-    QList<KifuBranchNode*> currentPath;
-    int lineIndex = 0;
-    collectLinesRecursive(m_root, currentPath, m_linesCache, lineIndex);
-
     m_linesCacheDirty = false;
     return m_linesCache;
 }
 
-void KifuBranchTree::invalidateLineCache()
+BranchLine KifuBranchTree::makeBranchLine(const QList<KifuBranchNode*>& path, int lineIndex)
 {
-    m_linesCacheDirty = true;
+    BranchLine line;
+    line.lineIndex = lineIndex;
+    line.nodes = path;
+
+    if (lineIndex == 0) {
+        line.name = QStringLiteral("本譜");
+        line.branchPly = 0;
+        line.branchPoint = nullptr;
+    } else {
+        line.name = QStringLiteral("分岐%1").arg(lineIndex);
+        // 分岐点を探す（最後に見つかった分岐点を使用）
+        // 例: Line 2 (７七角分岐) の場合、3手目で本譜から分岐し、
+        // さらに5手目でLine 1から分岐する。この場合、branchPointは
+        // 5手目の親（4手目の「△８四歩」）であるべき。
+        for (KifuBranchNode* n : path) {
+            if (n->parent() != nullptr && n->parent()->childCount() > 1) {
+                // このノードの親が分岐点
+                if (!n->isMainLine()) {
+                    line.branchPly = n->ply();
+                    line.branchPoint = n->parent();
+                    // breakしない: 最後に見つかった分岐点を使う
+                }
+            }
+        }
+    }
+    return line;
+}
+
+void KifuBranchTree::updateLinesForNewNode(KifuBranchNode* node)
+{
+    // ライン表が未構築なら範囲も次の cachedLines() でまとめて求める（棋譜読み込み中はここで戻る）
+    if (m_linesCacheDirty) {
+        return;
+    }
+
+    KifuBranchNode* parent = node->parent();
+    node->m_lineSpan = 1;
+
+    if (parent->childCount() == 1) {
+        // 葉だった親を延長するだけなのでライン数は変わらない
+        node->m_lineFirst = parent->m_lineFirst;
+        m_linesCache[node->m_lineFirst].nodes.append(node);
+        return;
+    }
+
+    // 新しい分岐: 親の範囲の末尾（最後の子の位置）にラインを1本差し込む。
+    // ずれるのは、祖先ごとに経路より後ろの兄弟の部分木に含まれるノードだけ。
+    // 費用は O(深さ + 後ろの兄弟の部分木のノード数 + 後ろのライン数) で、
+    // 本譜の序盤に分岐を足すと木のほぼ全体をたどる
+    const int insertAt = parent->m_lineFirst + parent->m_lineSpan;
+    for (KifuBranchNode* child = parent; child != nullptr; child = child->parent()) {
+        ++child->m_lineSpan;
+        for (KifuBranchNode* later = child->nextSibling(); later != nullptr; later = later->nextSibling()) {
+            shiftLineFirst(later);
+        }
+    }
+    node->m_lineFirst = insertAt;
+
+    m_linesCache.insert(insertAt, makeBranchLine(pathToNode(node), insertAt));
+    for (qsizetype i = insertAt + 1; i < m_linesCache.size(); ++i) {
+        BranchLine& line = m_linesCache[i];
+        line.lineIndex = static_cast<int>(i);
+        line.name = QStringLiteral("分岐%1").arg(i);
+    }
+}
+
+void KifuBranchTree::shiftLineFirst(KifuBranchNode* subtreeRoot)
+{
+    std::vector<KifuBranchNode*> stack{subtreeRoot};
+    while (!stack.empty()) {
+        KifuBranchNode* n = stack.back();
+        stack.pop_back();
+        ++n->m_lineFirst;
+        for (KifuBranchNode* child = n->firstChild(); child != nullptr; child = child->nextSibling()) {
+            stack.push_back(child);
+        }
+    }
+}
+
+void KifuBranchTree::ensureLineRanges() const
+{
+    if (m_linesCacheDirty) {
+        cachedLines();
+    }
 }
 
 void KifuBranchTree::collectLinesRecursive(KifuBranchNode* node,
@@ -300,53 +388,28 @@ void KifuBranchTree::collectLinesRecursive(KifuBranchNode* node,
                                            int& lineIndex) const
 {
     currentPath.append(node);
+    node->m_lineFirst = lineIndex;
 
     if (node->childCount() == 0) {
         // 葉ノード - このパスを1つのラインとして記録
-        BranchLine line;
-        line.lineIndex = lineIndex;
-        line.nodes = currentPath;
-
-        if (lineIndex == 0) {
-            line.name = QStringLiteral("本譜");
-            line.branchPly = 0;
-            line.branchPoint = nullptr;
-        } else {
-            line.name = QStringLiteral("分岐%1").arg(lineIndex);
-            // 分岐点を探す（最後に見つかった分岐点を使用）
-            // 例: Line 2 (７七角分岐) の場合、3手目で本譜から分岐し、
-            // さらに5手目でLine 1から分岐する。この場合、branchPointは
-            // 5手目の親（4手目の「△８四歩」）であるべき。
-            for (int i = 0; i < currentPath.size(); ++i) {
-                KifuBranchNode* n = currentPath.at(i);
-                if (n->parent() != nullptr && n->parent()->childCount() > 1) {
-                    // このノードの親が分岐点
-                    if (!n->isMainLine()) {
-                        line.branchPly = n->ply();
-                        line.branchPoint = n->parent();
-                        // breakしない: 最後に見つかった分岐点を使う
-                    }
-                }
-            }
-        }
-
-        lines.append(line);
+        lines.append(makeBranchLine(currentPath, lineIndex));
         lineIndex++;
     } else {
         // 子ノードを再帰的に処理
         // 最初の子（本譜）を先に処理
-        for (int i = 0; i < node->childCount(); ++i) {
-            KifuBranchNode* child = node->childAt(i);
+        for (KifuBranchNode* child = node->firstChild(); child != nullptr; child = child->nextSibling()) {
             collectLinesRecursive(child, currentPath, lines, lineIndex);
         }
     }
 
+    node->m_lineSpan = lineIndex - node->m_lineFirst;
     currentPath.removeLast();
 }
 
 int KifuBranchTree::lineCount() const
 {
-    return static_cast<int>(allLines().size());
+    ensureLineRanges();
+    return m_root != nullptr ? m_root->m_lineSpan : 0;
 }
 
 bool KifuBranchTree::hasBranch(KifuBranchNode* node) const
@@ -371,47 +434,39 @@ QSet<int> KifuBranchTree::branchablePlysOnLine(const BranchLine& line) const
 
 std::optional<int> KifuBranchTree::findLineIndexForNode(KifuBranchNode* node) const
 {
-    if (node == nullptr) {
+    if (!ownsNode(node)) {
         return std::nullopt;
     }
 
-    QList<BranchLine> lines = allLines();
-
-    // まず、このノードが終端であるラインを探す（子がないノード）
-    if (node->childCount() == 0) {
-        for (const BranchLine& line : std::as_const(lines)) {
-            if (!line.nodes.isEmpty() && line.nodes.last() == node) {
-                return line.lineIndex;
-            }
-        }
-    }
+    // 終端ならそのノードで終わるライン、途中なら最初の子を辿った終端のライン。
+    // どちらもこのノードを通る最初のラインに一致する。
+    ensureLineRanges();
+    return node->m_lineFirst;
+}
 
-    // 次に、このノードの後に分岐があるかチェック
-    // ノードから終端までのパスを辿り、その終端が属するラインを返す
-    KifuBranchNode* current = node;
-    while (current->childCount() > 0) {
-        // 最初の子を辿る（このノードが属する「主要な」パス）
-        current = current->childAt(0);
-    }
+bool KifuBranchTree::isNodeOnLine(const KifuBranchNode* node, int lineIndex) const
+{
+    ensureLineRanges();
+    return ownsNode(node) && lineIndex >= node->m_lineFirst
+           && lineIndex < node->m_lineFirst + node->m_lineSpan;
+}
 
-    // 終端ノードが属するラインを探す
-    for (const BranchLine& line : std::as_const(lines)) {
-        if (!line.nodes.isEmpty() && line.nodes.last() == current) {
-            // このラインに対象ノードが含まれているか確認
-            if (line.nodes.contains(node)) {
-                return line.lineIndex;
-            }
-        }
+KifuBranchNode* KifuBranchTree::childOnLine(const KifuBranchNode* node, int lineIndex) const
+{
+    if (!isNodeOnLine(node, lineIndex)) {
+        return nullptr;
     }
-
-    // フォールバック: ノードを含む最初のラインを返す
-    for (const BranchLine& line : std::as_const(lines)) {
-        if (line.nodes.contains(node)) {
-            return line.lineIndex;
+    for (KifuBranchNode* child = node->firstChild(); child != nullptr; child = child->nextSibling()) {
+        if (lineIndex < child->m_lineFirst + child->m_lineSpan) {
+            return child;
         }
     }
+    return nullptr;
+}
 
-    return std::nullopt;
+bool KifuBranchTree::ownsNode(const KifuBranchNode* node) const
+{
+    return node != nullptr && nodeAt(node->nodeId()) == node;
 }
 
 void KifuBranchTree::setComment(int nodeId, const QString& comment)
@@ -428,12 +483,13 @@ QList<KifDisplayItem> KifuBranchTree::displayItemsForLine(int lineIndex) const
 {
     QList<KifDisplayItem> result;
 
-    QList<BranchLine> lines = allLines();
+    const QList<BranchLine>& lines = cachedLines();
     if (lineIndex < 0 || lineIndex >= lines.size()) {
         return result;
     }
 
     const BranchLine& line = lines.at(lineIndex);
+    result.reserve(line.nodes.size());
     for (KifuBranchNode* node : std::as_const(line.nodes)) {
         KifDisplayItem item;
         item.prettyMove = node->displayText();
@@ -449,18 +505,12 @@ QList<KifDisplayItem> KifuBranchTree::displayItemsForLine(int lineIndex) const
 
 QStringList KifuBranchTree::sfenListForLine(int lineIndex) const
 {
-    QStringList result;
-
-    QList<BranchLine> lines = allLines();
+    const QList<BranchLine>& lines = cachedLines();
     if (lineIndex < 0 || lineIndex >= lines.size()) {
-        return result;
+        return QStringList();
     }
 
-    const BranchLine& line = lines.at(lineIndex);
-    for (KifuBranchNode* node : std::as_const(line.nodes)) {
-        result.append(node->sfen());
-    }
-
-    return result;
+    // ノードごとに祖先から再生せず、ラインを先頭から1手ずつ辿る
+    return m_positionCache.sfenListForPath(lines.at(lineIndex).nodes);
 }
 
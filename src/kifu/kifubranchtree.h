@@ -8,11 +8,15 @@
 #include <QObject>
 #include <QHash>
 #include <QList>
+#include <QMultiHash>
 #include <QSet>
+#include <memory>
 #include <optional>
+#include <vector>
 
 #include "kifubranchnode.h"
 #include "kifdisplayitem.h"
+#include "kifupositioncache.h"
 
 class KifuBranchTree;
 
@@ -32,6 +36,16 @@ struct BranchLine {
  *
  * 棋譜の分岐構造をツリーで管理する。
  * UIとは独立したデータモデル。
+ *
+ * ラインの一覧（allLines()）はキャッシュし、指し手の追加時に差分で更新する。
+ * 各ノードは自分を通るラインの範囲 [最初のライン, 最初のライン + ライン数) を持ち、
+ * 部分木の葉の並びがそのままラインの並び（DFS順）になるので、所属判定は O(1) で済む。
+ *
+ * ノードはノードID順に固定長ブロックのアリーナへ並べて確保し、clear() ではブロック単位で解放する。
+ * ブロックは移動しないため、KifuBranchNode* はツリーをクリアするまで有効。
+ *
+ * 各ノードの局面SFENは KifuPositionCache が指し手の再生で復元し、
+ * 局面の検索は手数を除いたSFENの64ビットキーで索引を引く。
  */
 class KifuBranchTree : public QObject
 {
@@ -120,7 +134,7 @@ public:
     /**
      * @brief SFENで一致するノードを探す
      * @param sfen 検索するSFEN（手数部分は除いて比較）
-     * @return 見つかったノード、見つからない場合はnullptr
+     * @return 見つかったノード（複数あればノードIDの最も小さいもの）、見つからない場合はnullptr
      */
     KifuBranchNode* findBySfen(const QString& sfen) const;
 
@@ -132,7 +146,7 @@ public:
     /**
      * @brief ノード数を取得
      */
-    int nodeCount() const { return static_cast<int>(m_nodeById.size()); }
+    int nodeCount() const { return m_nextNodeId - 1; }
 
     // === ライン操作 ===
 
@@ -179,6 +193,17 @@ public:
      */
     std::optional<int> findLineIndexForNode(KifuBranchNode* node) const;
 
+    /**
+     * @brief 指定ノードが指定ラインに含まれるか（O(1)）
+     */
+    bool isNodeOnLine(const KifuBranchNode* node, int lineIndex) const;
+
+    /**
+     * @brief 指定ラインに沿って進むときの子ノードを取得
+     * @return 指定ラインに含まれる子（ノードがそのラインに含まれない、または終端ならnullptr）
+     */
+    KifuBranchNode* childOnLine(const KifuBranchNode* node, int lineIndex) const;
+
     // === コメント ===
 
     /**
@@ -210,14 +235,29 @@ signals:
 
 private:
     KifuBranchNode* createNode();
+    void indexPosition(KifuBranchNode* node);
     void collectLinesRecursive(KifuBranchNode* node,
                                QList<KifuBranchNode*>& currentPath,
                                QList<BranchLine>& lines,
                                int& lineIndex) const;
-    void invalidateLineCache();
+    static BranchLine makeBranchLine(const QList<KifuBranchNode*>& path, int lineIndex);
+    const QList<BranchLine>& cachedLines() const;
+    /// 構築済みのライン表に新しいノードを反映する（後ろの兄弟の部分木の全ノードをずらす）
+    void updateLinesForNewNode(KifuBranchNode* node);
+    /// 部分木の全ノードのライン範囲を1本後ろにずらす
+    static void shiftLineFirst(KifuBranchNode* subtreeRoot);
+    /// ライン表が未構築ならノードのライン範囲とあわせて作り直す
+    void ensureLineRanges() const;
+    bool ownsNode(const KifuBranchNode* node) const;
+    void releaseNodes();
+
+    /// アリーナの1ブロックに並べるノード数
+    static constexpr int kNodeBlockSize = 256;
 
     KifuBranchNode* m_root = nullptr;
-    QHash<int, KifuBranchNode*> m_nodeById;
+    std::vector<std::unique_ptr<KifuBranchNode[]>> m_nodeBlocks;  ///< ノードのアリーナ（ID順）
+    QMultiHash<quint64, KifuBranchNode*> m_nodesByPositionKey;  ///< 局面キー → ノード
+    KifuPositionCache m_positionCache;                            ///< ノード局面の復元
     int m_nextNodeId = 1;
 
     mutable QList<BranchLine> m_linesCache;
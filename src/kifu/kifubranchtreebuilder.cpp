@@ -7,6 +7,7 @@
 #include "kifparsetypes.h"
 #include "kifdisplayitem.h"
 #include "logcategories.h"
+#include "sfenpositiontracer.h"
 
 KifuBranchTree* KifuBranchTreeBuilder::fromKifParseResult(const KifParseResult& result,
                                                           const QString& startSfen)
@@ -37,6 +38,32 @@ void KifuBranchTreeBuilder::buildFromKifParseResult(KifuBranchTree* tree,
     }
 }
 
+void KifuBranchTreeBuilder::completeSfenLists(KifParseResult& result, const std::atomic_bool* cancel)
+{
+    if (result.mainline.sfenList.isEmpty() && !result.mainline.usiMoves.isEmpty()) {
+        result.mainline.sfenList = SfenPositionTracer::buildSfenRecord(
+            result.mainline.baseSfen, result.mainline.usiMoves, false);
+    }
+    for (KifVariation& var : result.variations) {
+        if (cancel != nullptr && cancel->load()) {
+            return;
+        }
+        if (!var.line.sfenList.isEmpty() || var.line.usiMoves.isEmpty()) {
+            continue;
+        }
+        if (var.line.baseSfen.isEmpty() && !result.mainline.sfenList.isEmpty()) {
+            const int branchPly = var.startPly - 1;
+            if (branchPly >= 0 && branchPly < result.mainline.sfenList.size()) {
+                var.line.baseSfen = result.mainline.sfenList.at(branchPly);
+            }
+        }
+        if (!var.line.baseSfen.isEmpty()) {
+            var.line.sfenList = SfenPositionTracer::buildSfenRecord(
+                var.line.baseSfen, var.line.usiMoves, var.line.endsWithTerminal);
+        }
+    }
+}
+
 void KifuBranchTreeBuilder::addKifLineToTree(KifuBranchTree* tree,
                                              const KifLine& line,
                                              int startPly)
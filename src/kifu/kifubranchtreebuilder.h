@@ -8,6 +8,8 @@
 #include <QString>
 #include <QList>
 
+#include <atomic>
+
 class KifuBranchTree;
 struct KifParseResult;
 struct KifLine;
@@ -39,6 +41,15 @@ public:
                                         const KifParseResult& result,
                                         const QString& startSfen);
 
+    /**
+     * @brief sfenList が未生成の本譜・変化を baseSfen + usiMoves から補完する
+     * @param result パース結果（その場で補完する）
+     * @param cancel 中断フラグ（true になった時点で打ち切る。nullptr なら中断しない）
+     *
+     * ツリー構築前に呼ぶ。ワーカースレッドから呼んでよい。
+     */
+    static void completeSfenLists(KifParseResult& result, const std::atomic_bool* cancel = nullptr);
+
 private:
     KifuBranchTreeBuilder() = default;
 
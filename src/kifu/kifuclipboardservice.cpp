@@ -8,7 +8,6 @@
 
 #include <QApplication>
 #include <QClipboard>
-#include <QTableWidget>
 
 namespace KifuClipboardService {
 
@@ -18,7 +17,7 @@ namespace {
 GameRecordModel::ExportContext buildModelContext(const ExportContext& ctx)
 {
     GameRecordModel::ExportContext modelCtx;
-    modelCtx.gameInfoTable = ctx.gameInfoTable;
+    modelCtx.gameInfo      = ctx.gameInfo;
     modelCtx.recordModel   = ctx.recordModel;
     modelCtx.startSfen     = ctx.startSfen;
     modelCtx.playMode      = ctx.playMode;
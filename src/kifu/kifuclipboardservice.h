@@ -9,10 +9,10 @@
 #include <QStringList>
 #include <QList>
 
+#include "kifparsetypes.h"
 #include "playmode.h"
 
 class QWidget;
-class QTableWidget;
 class KifuRecordListModel;
 class GameRecordModel;
 struct ShogiMove;
@@ -29,7 +29,7 @@ namespace KifuClipboardService {
 
 /// エクスポートに必要なコンテキスト情報
 struct ExportContext {
-    QTableWidget*       gameInfoTable = nullptr;
+    QList<KifGameInfoItem> gameInfo;
     KifuRecordListModel* recordModel   = nullptr;
     GameRecordModel*    gameRecord    = nullptr;
     QString             startSfen;
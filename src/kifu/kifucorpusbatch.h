@@ -0,0 +1,57 @@
+/// @file kifucorpusbatch.h
+/// @brief 棋譜ファイル群を区切りごとに並列に読む処理（定跡の一括作成・棋譜データベースで共通）
+
+#ifndef KIFUCORPUSBATCH_H
+#define KIFUCORPUSBATCH_H
+
+#include <QList>
+#include <QPair>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <functional>
+#include <type_traits>
+
+namespace KifuCorpusFiles {
+
+/// 1回の並列処理で読むファイル数（スレッド1本あたり）。進捗と中断の細かさを決める
+inline constexpr int kFilesPerThreadBatch = 64;
+
+/**
+ * @brief ファイル番号 [0, fileCount) を区切りごとに並列に処理する
+ *
+ * 区切り（スレッド数 × kFilesPerThreadBatch 件）をスレッドごとの範囲に分け、範囲ごとに
+ * readRange(begin, end) で別々の部分結果を作る（ロック不要）。部分結果はファイル順に
+ * 呼び出し元のスレッドで merge に渡す。区切りごとに progress（0〜100）を呼び、false なら打ち切る。
+ * @return 最後まで処理した場合 true
+ */
+template <typename ReadRange, typename Merge>
+bool processInBatches(qsizetype fileCount, ReadRange readRange, Merge merge,
+                      const std::function<bool(int percent)> &progress)
+{
+    using Partial = std::invoke_result_t<ReadRange &, qsizetype, qsizetype>;
+
+    const int threads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    const qsizetype batchSize = qsizetype(threads) * kFilesPerThreadBatch;
+
+    for (qsizetype batchBegin = 0; batchBegin < fileCount; batchBegin += batchSize) {
+        const qsizetype batchEnd = qMin(fileCount, batchBegin + batchSize);
+
+        QList<QPair<qsizetype, qsizetype>> ranges;
+        for (qsizetype begin = batchBegin; begin < batchEnd; begin += kFilesPerThreadBatch) {
+            ranges.append({begin, qMin(batchEnd, begin + kFilesPerThreadBatch)});
+        }
+        QList<Partial> partials =
+            QtConcurrent::blockingMapped<QList<Partial>>(ranges, [&](const QPair<qsizetype, qsizetype> &range) {
+                return readRange(range.first, range.second);
+            });
+        for (Partial &partial : partials) merge(partial);
+
+        if (progress && !progress(static_cast<int>(batchEnd * 100 / fileCount))) return false;
+    }
+    return true;
+}
+
+} // namespace KifuCorpusFiles
+
+#endif // KIFUCORPUSBATCH_H
@@ -0,0 +1,104 @@
+/// @file kifucorpusfiles.cpp
+/// @brief 棋譜フォルダの列挙と、拡張子に応じた棋譜ファイルの読み込みの実装
+
+#include "kifucorpusfiles.h"
+#include "csatosfenconverter.h"
+#include "jkftosfenconverter.h"
+#include "ki2tosfenconverter.h"
+#include "kifparsetypes.h"
+#include "kifreader.h"
+#include "kiftosfenconverter.h"
+#include "usentosfenconverter.h"
+#include "usitosfenconverter.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+
+namespace KifuCorpusFiles {
+
+const QStringList &nameFilters()
+{
+    static const QStringList filters = {
+        QStringLiteral("*.kif"), QStringLiteral("*.kifu"), QStringLiteral("*.ki2"), QStringLiteral("*.ki2u"),
+        QStringLiteral("*.csa"), QStringLiteral("*.jkf"), QStringLiteral("*.usen"), QStringLiteral("*.usi"),
+    };
+    return filters;
+}
+
+bool isKifuFile(const QString &filePath)
+{
+    const QString name = QFileInfo(filePath).fileName();
+    for (const QString &filter : nameFilters()) {
+        if (name.endsWith(QStringView(filter).mid(1), Qt::CaseInsensitive)) return true;
+    }
+    return false;
+}
+
+QStringList collectFiles(const QString &source, bool recursive)
+{
+    QStringList files;
+    const QFileInfo info(source);
+    if (info.isDir()) {
+        QDirIterator it(source, nameFilters(), QDir::Files | QDir::Readable,
+                        recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+        while (it.hasNext()) {
+            files.append(it.next());
+        }
+    } else if (source.contains(QLatin1Char('*')) || source.contains(QLatin1Char('?'))) {
+        const QDir dir = info.dir();
+        const QStringList names = dir.entryList(QStringList{info.fileName()}, QDir::Files | QDir::Readable);
+        for (const QString &name : names) {
+            const QString path = dir.filePath(name);
+            if (isKifuFile(path)) files.append(path);
+        }
+    } else if (info.isFile() && isKifuFile(source)) {
+        files.append(source);
+    }
+    files.sort();
+    return files;
+}
+
+bool parseFile(const QString &filePath, KifParseResult &result, QString *errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = QStringLiteral("ファイルを開けませんでした: %1").arg(filePath);
+        return false;
+    }
+    const QByteArray bytes = file.readAll();
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+
+    if (suffix == QLatin1String("csa")) {
+        QStringList lines;
+        CsaToSfenConverter::decodeLines(bytes, lines);
+        return CsaToSfenConverter::parseLines(lines, result, errorMessage);
+    }
+    if (suffix == QLatin1String("jkf")) {
+        return JkfToSfenConverter::parseJson(bytes, result, errorMessage);
+    }
+    if (suffix == QLatin1String("usen")) {
+        return UsenToSfenConverter::parseContent(QString::fromUtf8(bytes).trimmed(), result, errorMessage);
+    }
+
+    QStringList lines;
+    KifReader::decodeLinesAuto(bytes, lines, nullptr, errorMessage);
+    if (suffix == QLatin1String("ki2") || suffix == QLatin1String("ki2u")) {
+        return Ki2ToSfenConverter::parseLines(lines, result, errorMessage);
+    }
+    if (suffix == QLatin1String("usi")) {
+        return UsiToSfenConverter::parseLines(lines, result, errorMessage);
+    }
+    return KifToSfenConverter::parseLines(lines, result, errorMessage);
+}
+
+QString gameInfoValue(const QList<KifGameInfoItem> &info, const QString &key, const QString &altKey)
+{
+    for (const KifGameInfoItem &item : info) {
+        if (item.key == key || (!altKey.isEmpty() && item.key == altKey)) return item.value.trimmed();
+    }
+    return {};
+}
+
+} // namespace KifuCorpusFiles
@@ -0,0 +1,40 @@
+/// @file kifucorpusfiles.h
+/// @brief 棋譜フォルダの列挙と、拡張子に応じた棋譜ファイルの読み込み
+
+#ifndef KIFUCORPUSFILES_H
+#define KIFUCORPUSFILES_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+struct KifGameInfoItem;
+struct KifParseResult;
+
+/// 棋譜フォルダ単位の処理（定跡の一括作成・棋譜データベース）で共通に使うファイル操作。
+/// GUI に依存しないので、ワーカースレッドから呼んでよい。
+namespace KifuCorpusFiles {
+
+/// 棋譜として読む拡張子のフィルタ（"*.kif" など）
+const QStringList &nameFilters();
+
+/// 棋譜として読める拡張子か
+bool isKifuFile(const QString &filePath);
+
+/**
+ * @brief 対象の棋譜ファイルを集める
+ * @param source フォルダ、またはワイルドカードを含むパス（例: "/data/floodgate/2024*.csa"）
+ * @param recursive フォルダ指定のときサブフォルダも探す
+ * @return 棋譜ファイルのパス（名前順）
+ */
+QStringList collectFiles(const QString &source, bool recursive);
+
+/// 棋譜ファイルを拡張子に応じた形式で読む
+[[nodiscard]] bool parseFile(const QString &filePath, KifParseResult &result, QString *errorMessage = nullptr);
+
+/// 対局情報から最初に見つかったキー（key または altKey）の値を返す（前後の空白は除く）
+QString gameInfoValue(const QList<KifGameInfoItem> &info, const QString &key, const QString &altKey = {});
+
+} // namespace KifuCorpusFiles
+
+#endif // KIFUCORPUSFILES_H
@@ -0,0 +1,145 @@
+/// @file kifudatabase.cpp
+/// @brief 棋譜データベースファイルの読み取り（メモリマップ）と局面の検索
+
+#include "kifudatabase.h"
+#include "kifudatabaseformat.h"
+#include "kifupositioncache.h"
+#include "sfenpositiontracer.h"
+
+using namespace KifuDatabaseFormat;
+
+KifuDatabase::KifuDatabase()
+    : m_index(kLayout)
+{
+}
+
+KifuDatabase::~KifuDatabase() = default;
+
+double KifuDatabase::BuildStats::gamesPerSecond() const
+{
+    return elapsedMs > 0 ? gameCount * 1000.0 / elapsedMs : 0.0;
+}
+
+bool KifuDatabase::isDatabaseFile(const QString &filePath)
+{
+    return SortedKeyIndex::hasMagic(filePath, kMagic);
+}
+
+void KifuDatabase::close()
+{
+    m_index.close();
+}
+
+bool KifuDatabase::open(const QString &filePath, QString *errorMessage)
+{
+    return m_index.open(filePath, errorMessage);
+}
+
+int KifuDatabase::gameCount() const
+{
+    return static_cast<int>(m_index.recordCount(kGameTable));
+}
+
+qint64 KifuDatabase::postingCount() const
+{
+    return m_index.recordCount(kPostingTable);
+}
+
+const uchar *KifuDatabase::gameRecord(quint32 index) const
+{
+    return m_index.record(kGameTable, index);
+}
+
+const uchar *KifuDatabase::postingRecord(quint32 index) const
+{
+    return m_index.record(kPostingTable, index);
+}
+
+KifuDatabase::GameSummary KifuDatabase::gameAt(int index) const
+{
+    GameSummary game;
+    if (index < 0 || index >= gameCount()) return game;
+
+    const uchar *record = gameRecord(quint32(index));
+    const auto text = [&](int field) { return QString::fromUtf8(m_index.poolBytes(readLE<quint32>(record + field))); };
+    game.filePath = text(kGamePath);
+    game.blackPlayer = text(kGameBlack);
+    game.whitePlayer = text(kGameWhite);
+    game.date = text(kGameDate);
+    game.event = text(kGameEvent);
+    game.plyCount = static_cast<int>(readLE<quint32>(record + kGamePlyCount));
+    const quint8 result = record[kGameResult];
+    game.result = result <= quint8(GameResult::Draw) ? static_cast<GameResult>(result) : GameResult::Unknown;
+
+    // 対局情報は「キー<TAB>値」を改行で区切って持つ
+    const QString info = text(kGameInfo);
+    for (const QStringView line : QStringView(info).split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        const qsizetype tab = line.indexOf(QLatin1Char('\t'));
+        if (tab < 0) continue;
+        game.gameInfo.append({line.left(tab).toString(), line.mid(tab + 1).toString()});
+    }
+    return game;
+}
+
+QList<KifuDatabase::Hit> KifuDatabase::findGames(const QString &sfen, int limit) const
+{
+    QList<Hit> hits;
+    const QString normalized = normalizedSfen(sfen);
+    if (normalized.isEmpty()) return hits;
+
+    const auto [first, last] = m_index.keyRange(positionKey(normalized));
+    const quint32 count = limit >= 0 ? qMin(last - first, quint32(limit)) : last - first;
+    hits.reserve(count);
+    for (quint32 i = first; i < first + count; ++i) {
+        const uchar *record = postingRecord(i);
+        const quint32 game = readLE<quint32>(record + kPostingGame);
+        if (game >= quint32(gameCount())) continue;
+        hits.append({static_cast<int>(game), static_cast<int>(readLE<quint32>(record + kPostingPly))});
+    }
+    return hits;
+}
+
+KifuDatabase::PositionStats KifuDatabase::positionStats(const QString &sfen) const
+{
+    PositionStats stats;
+    const QString normalized = normalizedSfen(sfen);
+    if (normalized.isEmpty()) return stats;
+
+    // 勝敗は対局レコードの1バイトだけを読む（文字列は復元しない）
+    const auto [first, last] = m_index.keyRange(positionKey(normalized));
+    for (quint32 i = first; i < last; ++i) {
+        const quint32 game = readLE<quint32>(postingRecord(i) + kPostingGame);
+        if (game >= quint32(gameCount())) continue;
+        ++stats.games;
+        switch (static_cast<GameResult>(gameRecord(game)[kGameResult])) {
+        case GameResult::BlackWin: ++stats.blackWins; break;
+        case GameResult::WhiteWin: ++stats.whiteWins; break;
+        case GameResult::Draw: ++stats.draws; break;
+        default: ++stats.unknown; break;
+        }
+    }
+    return stats;
+}
+
+QString KifuDatabase::normalizedSfen(const QString &sfen)
+{
+    QString text = sfen.trimmed();
+    if (text.startsWith(QLatin1String("position "))) text = text.mid(9).trimmed();
+    if (text.startsWith(QLatin1String("sfen "))) text = text.mid(5).trimmed();
+
+    // 盤面の書き方の揺れ（空き升の数え方など）をなくすため、トレーサで書き直す
+    SfenPositionTracer tracer;
+    if (text == QLatin1String("startpos")) {
+        tracer.resetToStartpos();
+    } else {
+        if (text.count(QLatin1Char(' ')) == 2) text += QLatin1String(" 1");
+        if (!tracer.setFromSfen(text)) return {};
+    }
+    return KifuPositionCache::stripPly(tracer.toSfenString()).toString();
+}
+
+quint64 KifuDatabase::positionKey(QStringView normalizedSfen)
+{
+    // FNV-1a に、バケットに使う上位ビットが偏らないよう仕上げをかける
+    return mixKey(KifuPositionCache::positionKey(normalizedSfen));
+}
@@ -0,0 +1,157 @@
+/// @file kifudatabase.h
+/// @brief 局面から対局を引ける棋譜データベース（メモリマップの索引ファイル）の定義
+
+#ifndef KIFUDATABASE_H
+#define KIFUDATABASE_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+#include <functional>
+
+#include "kifparsetypes.h"
+#include "sortedkeyindex.h"
+
+/**
+ * @brief 棋譜データベースファイル（.kdb）の読み取り専用ビュー
+ *
+ * 棋譜フォルダの全対局の本譜を再生し、現れた局面から対局を引く転置索引を1ファイルに収める
+ * （数値はすべてリトルエンディアン）。
+ *
+ * | 領域         | 内容                                                                   |
+ * |--------------|------------------------------------------------------------------------|
+ * | ヘッダー     | マジック・版数・各領域のオフセット（64バイト）                         |
+ * | バケット表   | 局面キー上位 bucketBits ビットごとの先頭出現番号（2^bucketBits+1 個）  |
+ * | 対局表       | 対局ごとのファイルパス・対局者・日時・棋戦・対局情報・総手数・勝敗     |
+ * | 出現表       | キー → 対局番号 → 手数の昇順に並べた（局面キー, 対局番号, 手数）       |
+ * | 文字列プール | 長さ付き UTF-8 の文字列                                                |
+ *
+ * ヘッダー・バケット表・文字列プールと局面の検索（キーのバケットで範囲を絞った二分探索）は
+ * JosekiBook と共通の SortedKeyIndex で行う。
+ * 出現表は1局につき同じ局面を最初の1回だけ持つので、該当範囲がそのまま対局の一覧になる。
+ * 局面は64ビットキーだけで照合する（SFEN は持たない）。
+ *
+ * ファイルは build() で作り直すだけで、追記はしない。
+ * const メンバはマップ領域を読むだけなので、複数スレッドから同時に呼んでよい。
+ */
+class KifuDatabase
+{
+public:
+    /// 対局の勝敗
+    enum class GameResult : quint8 {
+        Unknown = 0,  ///< 不明（中断・勝敗の書かれていない棋譜など）
+        BlackWin = 1, ///< 先手（下手）勝ち
+        WhiteWin = 2, ///< 後手（上手）勝ち
+        Draw = 3      ///< 千日手・持将棋
+    };
+
+    /// 対局1局分の情報
+    struct GameSummary {
+        QString filePath;                ///< 棋譜ファイルのパス
+        QString blackPlayer;             ///< 先手（駒落ちでは下手）
+        QString whitePlayer;             ///< 後手（駒落ちでは上手）
+        QString date;                    ///< 開始日時（なければ対局日）
+        QString event;                   ///< 棋戦
+        QList<KifGameInfoItem> gameInfo; ///< 棋譜の対局情報すべて
+        int plyCount = 0;                ///< 本譜の手数
+        GameResult result = GameResult::Unknown;
+    };
+
+    /// 局面が現れた対局
+    struct Hit {
+        int game = -1; ///< 対局番号
+        int ply = 0;   ///< 局面が最初に現れた手数（0 = 開始局面）
+    };
+
+    /// 局面を通った対局の勝敗の内訳
+    struct PositionStats {
+        int games = 0;
+        int blackWins = 0;
+        int whiteWins = 0;
+        int draws = 0;
+        int unknown = 0;
+    };
+
+    /// 作成の統計
+    struct BuildStats {
+        int fileCount = 0;        ///< 対象ファイル数
+        int gameCount = 0;        ///< 登録した対局数
+        int failedCount = 0;      ///< 読み込みに失敗したファイル数
+        qint64 postingCount = 0;  ///< 登録した（局面, 対局）の組の数
+        qint64 elapsedMs = 0;     ///< 処理時間
+        double gamesPerSecond() const;
+    };
+
+    /// 作成結果
+    struct BuildResult {
+        bool success = false;
+        bool cancelled = false;
+        QString errorMessage;
+        BuildStats stats;
+    };
+
+    /// 進捗通知（0〜100）。false を返すと中断する
+    using ProgressCallback = std::function<bool(int percent)>;
+
+    KifuDatabase();
+    ~KifuDatabase();
+    Q_DISABLE_COPY_MOVE(KifuDatabase)
+
+    /// 先頭が棋譜データベースのマジックかどうか
+    static bool isDatabaseFile(const QString &filePath);
+
+    /**
+     * @brief ファイルを読み取り専用でマップする
+     * @param filePath ファイルパス
+     * @param errorMessage エラーメッセージ（エラー時に設定される）
+     * @return 形式が正しくマップできた場合 true
+     */
+    [[nodiscard]] bool open(const QString &filePath, QString *errorMessage = nullptr);
+    void close();
+
+    bool isOpen() const { return m_index.isOpen(); }
+    QString filePath() const { return m_index.filePath(); }
+    int gameCount() const;
+    qint64 postingCount() const;
+
+    /// 対局番号の情報（範囲外なら空）
+    GameSummary gameAt(int index) const;
+
+    /**
+     * @brief 局面が現れた対局を対局番号順に返す
+     * @param sfen 局面のSFEN（手数の有無は問わない。"startpos" も可）
+     * @param limit 返す件数の上限（負なら全件）
+     */
+    QList<Hit> findGames(const QString &sfen, int limit = -1) const;
+
+    /// 局面を通った対局の勝敗の内訳（全件を数える）
+    PositionStats positionStats(const QString &sfen) const;
+
+    /// 局面を照合用の形（トレーサで書き直し、手数を除いたSFEN）にする。解釈できなければ空
+    static QString normalizedSfen(const QString &sfen);
+
+    /// 正規化SFEN から 64 ビットの局面キーを求める
+    static quint64 positionKey(QStringView normalizedSfen);
+
+    /// 本譜の終局表示と手番記号から勝敗を判定する
+    static GameResult resultOf(const KifLine &mainline);
+
+    /**
+     * @brief 棋譜ファイル群からデータベースを作る（ワーカースレッドから呼べる）
+     *
+     * 棋譜を並列に読み、本譜の各局面を登録する。中断した場合や失敗した場合、
+     * 既存の outputPath は変更しない。
+     */
+    [[nodiscard]] static BuildResult build(const QStringList &files, const QString &outputPath,
+                                           const ProgressCallback &progress = {});
+
+private:
+    const uchar *gameRecord(quint32 index) const;
+    const uchar *postingRecord(quint32 index) const;
+
+    SortedKeyIndex m_index;
+};
+
+#endif // KIFUDATABASE_H
@@ -0,0 +1,254 @@
+/// @file kifudatabase_build.cpp
+/// @brief 棋譜ファイル群からの棋譜データベースの作成と勝敗の判定
+
+#include "kifudatabase.h"
+#include "kifudatabaseformat.h"
+#include "gameinfokeys.h"
+#include "kifdisplayitem.h"
+#include "kifubranchnode.h"
+#include "kifucorpusbatch.h"
+#include "kifucorpusfiles.h"
+#include "sfenpositiontracer.h"
+#include "logcategories.h"
+
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QSet>
+
+#include <algorithm>
+#include <vector>
+
+using namespace KifuDatabaseFormat;
+
+namespace {
+
+/// 読み込んで局面キーまで求めた1局分
+struct IndexedGame {
+    KifuDatabase::GameSummary summary;
+    std::vector<std::pair<quint64, quint32>> positions;  ///< (局面キー, 最初に現れた手数)
+};
+
+/// スレッド1本分の読み込み結果（ファイル順）
+struct PartialIndex {
+    QList<IndexedGame> games;
+    int failedCount = 0;
+};
+
+struct Posting {
+    quint64 key = 0;
+    quint32 game = 0;
+    quint32 ply = 0;
+};
+
+using KifuCorpusFiles::gameInfoValue;
+
+/// 対局情報を「キー<TAB>値」の行にまとめる（値の改行は空白にする）
+QString gameInfoText(const QList<KifGameInfoItem> &info)
+{
+    QString text;
+    for (const KifGameInfoItem &item : info) {
+        QString value = item.value;
+        value.replace(QLatin1Char('\n'), QLatin1Char(' '));
+        text += item.key + QLatin1Char('\t') + value + QLatin1Char('\n');
+    }
+    return text;
+}
+
+/// 本譜を再生し、局面ごとに最初に現れた手数を集める
+bool indexGame(const QString &filePath, const KifParseResult &game, IndexedGame &out)
+{
+    const KifLine &mainline = game.mainline;
+    if (mainline.usiMoves.isEmpty()) return false;
+
+    SfenPositionTracer tracer;
+    if (mainline.baseSfen.isEmpty()) {
+        tracer.resetToStartpos();
+    } else if (!tracer.setFromSfen(mainline.baseSfen)) {
+        return false;
+    }
+
+    // 駒落ちでは下手が先手・上手が後手
+    KifuDatabase::GameSummary &summary = out.summary;
+    summary.filePath = filePath;
+    summary.blackPlayer = gameInfoValue(game.gameInfo, GameInfoKeys::kBlackPlayer, QStringLiteral("下手"));
+    summary.whitePlayer = gameInfoValue(game.gameInfo, GameInfoKeys::kWhitePlayer, QStringLiteral("上手"));
+    summary.date = gameInfoValue(game.gameInfo, GameInfoKeys::kStartDateTime, GameInfoKeys::kGameDate);
+    summary.event = gameInfoValue(game.gameInfo, QStringLiteral("棋戦"));
+    summary.gameInfo = game.gameInfo;
+    summary.plyCount = static_cast<int>(mainline.usiMoves.size());
+    summary.result = KifuDatabase::resultOf(mainline);
+
+    // 同じ局面に戻っても最初の手数だけを登録する
+    QSet<quint64> seen;
+    out.positions.reserve(static_cast<std::size_t>(mainline.usiMoves.size()) + 1);
+    const auto addPosition = [&](int ply) {
+        const QString sfen = tracer.toSfenString();
+        const quint64 key = KifuDatabase::positionKey(sfen.left(sfen.lastIndexOf(QLatin1Char(' '))));
+        if (!seen.contains(key)) {
+            seen.insert(key);
+            out.positions.emplace_back(key, static_cast<quint32>(qMax(0, ply)));
+        }
+    };
+    const int basePly = mainline.startPly - 1;
+    addPosition(basePly);
+    for (qsizetype i = 0; i < mainline.usiMoves.size(); ++i) {
+        if (!tracer.applyUsiMove(mainline.usiMoves.at(i))) break;
+        addPosition(basePly + static_cast<int>(i) + 1);
+    }
+    return true;
+}
+
+/// 文字列プールに追加し、そのオフセットを返す（空文字列は kNoString）
+quint32 appendPoolText(QByteArray &pool, const QString &text)
+{
+    return text.isEmpty() ? kNoString : appendPoolString(pool, text.toUtf8());
+}
+
+/// 対局レコードを追加し、文字列をプールに足す
+void appendGameRecord(QByteArray &games, QByteArray &pool, const KifuDatabase::GameSummary &summary)
+{
+    appendLE<quint32>(games, appendPoolText(pool, summary.filePath));
+    appendLE<quint32>(games, appendPoolText(pool, summary.blackPlayer));
+    appendLE<quint32>(games, appendPoolText(pool, summary.whitePlayer));
+    appendLE<quint32>(games, appendPoolText(pool, summary.date));
+    appendLE<quint32>(games, appendPoolText(pool, summary.event));
+    appendLE<quint32>(games, appendPoolText(pool, gameInfoText(summary.gameInfo)));
+    appendLE<quint32>(games, static_cast<quint32>(summary.plyCount));
+    appendLE<quint8>(games, static_cast<quint8>(summary.result));
+    appendLE<quint8>(games, 0);
+    appendLE<quint16>(games, 0);
+}
+
+} // namespace
+
+KifuDatabase::GameResult KifuDatabase::resultOf(const KifLine &mainline)
+{
+    if (mainline.disp.isEmpty()) return GameResult::Unknown;
+
+    // 終局表示の手番記号は終局手を指した側（投了した側など）を表す
+    const QString text = mainline.disp.constLast().prettyMove.trimmed();
+    bool moverWins = false;
+    switch (detectTerminalType(text)) {
+    case TerminalType::Repetition:
+    case TerminalType::Impasse:
+        return GameResult::Draw;
+    case TerminalType::Resign:
+    case TerminalType::Checkmate:
+    case TerminalType::Timeout:
+    case TerminalType::IllegalLoss:
+        moverWins = false;
+        break;
+    case TerminalType::IllegalWin:
+        moverWins = true;
+        break;
+    case TerminalType::Forfeit:
+        moverWins = text.contains(QStringLiteral("不戦勝"));
+        break;
+    default:
+        return GameResult::Unknown;
+    }
+
+    bool moverIsBlack = false;
+    if (text.startsWith(QStringLiteral("▲")) || text.startsWith(QStringLiteral("☗"))) {
+        moverIsBlack = true;
+    } else if (!text.startsWith(QStringLiteral("△")) && !text.startsWith(QStringLiteral("☖"))) {
+        return GameResult::Unknown;
+    }
+    return moverIsBlack == moverWins ? GameResult::BlackWin : GameResult::WhiteWin;
+}
+
+KifuDatabase::BuildResult KifuDatabase::build(const QStringList &files, const QString &outputPath,
+                                              const ProgressCallback &progress)
+{
+    BuildResult result;
+    result.stats.fileCount = static_cast<int>(files.size());
+    QElapsedTimer timer;
+    timer.start();
+
+    // 1. 棋譜を並列に読み、対局表と文字列プールを組み立てながら出現を集める
+    QByteArray games;
+    QByteArray pool;
+    std::vector<Posting> postings;
+
+    const auto readRange = [&](qsizetype begin, qsizetype end) {
+        PartialIndex partial;
+        for (qsizetype i = begin; i < end; ++i) {
+            KifParseResult game;
+            QString warn;
+            IndexedGame indexed;
+            if (!KifuCorpusFiles::parseFile(files.at(i), game, &warn) || !indexGame(files.at(i), game, indexed)) {
+                ++partial.failedCount;
+                continue;
+            }
+            partial.games.append(std::move(indexed));
+        }
+        return partial;
+    };
+    // 対局番号はファイル名順に振る（範囲の並びと範囲内の順がそのままファイル順）
+    const auto merge = [&](PartialIndex &partial) {
+        result.stats.failedCount += partial.failedCount;
+        for (const IndexedGame &game : std::as_const(partial.games)) {
+            const auto gameIndex = static_cast<quint32>(result.stats.gameCount++);
+            appendGameRecord(games, pool, game.summary);
+            for (const auto &[key, ply] : game.positions) {
+                postings.push_back({key, gameIndex, ply});
+            }
+        }
+    };
+    if (!KifuCorpusFiles::processInBatches(files.size(), readRange, merge, progress)) {
+        result.cancelled = true;
+        return result;
+    }
+
+    if (postings.size() >= 0xFFFFFFFFu || quint64(pool.size()) >= kNoString) {
+        result.errorMessage = QStringLiteral("棋譜が多すぎるためデータベースを作成できません: %1").arg(outputPath);
+        return result;
+    }
+
+    // 2. 出現をキー順に並べ、バケット表を作る（同じキーの中は対局番号順）
+    std::sort(postings.begin(), postings.end(), [](const Posting &a, const Posting &b) {
+        return a.key != b.key ? a.key < b.key : a.game < b.game;
+    });
+    const quint32 bucketBits = bucketBitsFor(postings.size());
+    const QByteArray buckets = bucketTable(postings, bucketBits, [](const Posting &posting) { return posting.key; });
+
+    // 3. 書き出す（一時ファイルに書いてから置き換える）
+    QSaveFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        result.errorMessage = QStringLiteral("ファイルを保存できませんでした: %1").arg(outputPath);
+        return result;
+    }
+    bool ok = file.write(QByteArray(kHeaderSize, '\0')) == kHeaderSize
+              && file.write(buckets) == buckets.size()
+              && file.write(games) == games.size();
+
+    QByteArray chunk;
+    chunk.reserve(kWriteChunkSize + kPostingRecordSize);
+    for (const Posting &posting : postings) {
+        appendLE<quint64>(chunk, posting.key);
+        appendLE<quint32>(chunk, posting.game);
+        appendLE<quint32>(chunk, posting.ply);
+        if (chunk.size() >= kWriteChunkSize) {
+            ok = ok && file.write(chunk) == chunk.size();
+            chunk.clear();
+        }
+    }
+    ok = ok && file.write(chunk) == chunk.size();
+    ok = ok && file.write(pool) == pool.size();
+
+    const quint32 recordCount[kTableCount] = {static_cast<quint32>(result.stats.gameCount),
+                                              static_cast<quint32>(postings.size())};
+    const QByteArray header = headerBytes(kLayout, bucketBits, recordCount, quint64(pool.size()));
+    ok = ok && file.seek(0) && file.write(header) == kHeaderSize;
+    if (!ok || !file.commit()) {
+        result.errorMessage = QStringLiteral("ファイル書き込み中にエラーが発生しました: %1").arg(outputPath);
+        return result;
+    }
+
+    result.success = true;
+    result.stats.postingCount = static_cast<qint64>(postings.size());
+    result.stats.elapsedMs = timer.elapsed();
+    qCInfo(lcKifu) << "Kifu database build:" << result.stats.gameCount << "games," << result.stats.postingCount
+                   << "positions in" << result.stats.elapsedMs << "ms";
+    return result;
+}
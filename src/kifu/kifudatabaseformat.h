@@ -0,0 +1,45 @@
+/// @file kifudatabaseformat.h
+/// @brief 棋譜データベースファイルのレイアウト定数（kifudatabase*.cpp 専用）
+
+#ifndef KIFUDATABASEFORMAT_H
+#define KIFUDATABASEFORMAT_H
+
+#include "sortedkeyindexformat.h"
+
+/// 数値はすべてリトルエンディアン。領域の並びは KifuDatabase のクラスコメントを参照
+namespace KifuDatabaseFormat {
+
+// ヘッダー・バケット表・文字列プールと読み書きヘルパーはバイナリ定跡と共通
+using namespace SortedKeyIndexFormat;
+
+inline constexpr char kMagic[8] = {'K', 'I', 'F', 'U', 'D', 'B', '0', '1'};
+inline constexpr char kFileSuffix[] = ".kdb";
+inline constexpr quint32 kVersion = 1;
+
+// 表0が対局表、表1が出現表（キー順）
+inline constexpr int kGameTable = 0;
+inline constexpr int kPostingTable = 1;
+
+// 対局レコード（32バイト）: パス・先手・後手・日時・棋戦・対局情報の文字列参照、総手数、勝敗、予備
+inline constexpr qint64 kGameRecordSize = 32;
+inline constexpr int kGamePath = 0;
+inline constexpr int kGameBlack = 4;
+inline constexpr int kGameWhite = 8;
+inline constexpr int kGameDate = 12;
+inline constexpr int kGameEvent = 16;
+inline constexpr int kGameInfo = 20;
+inline constexpr int kGamePlyCount = 24;
+inline constexpr int kGameResult = 28;
+
+// 出現レコード（16バイト）: 局面キー・対局番号・手数。キー → 対局番号 → 手数の昇順に並べる
+inline constexpr qint64 kPostingRecordSize = 16;
+inline constexpr int kPostingKey = 0;
+inline constexpr int kPostingGame = 8;
+inline constexpr int kPostingPly = 12;
+
+inline constexpr Layout kLayout{kMagic, kVersion, {kGameRecordSize, kPostingRecordSize}, kPostingTable,
+                                "棋譜データベース"};
+
+} // namespace KifuDatabaseFormat
+
+#endif // KIFUDATABASEFORMAT_H
@@ -69,7 +69,9 @@ QStringList KifuExportClipboard::resolveUsiMoves() const
 GameRecordModel::ExportContext KifuExportClipboard::buildExportContext() const
 {
     GameRecordModel::ExportContext ctx;
-    ctx.gameInfoTable = m_deps.gameInfoController ? m_deps.gameInfoController->tableWidget() : nullptr;
+    if (m_deps.gameInfoController) {
+        ctx.gameInfo = m_deps.gameInfoController->gameInfo();
+    }
     ctx.recordModel = m_deps.kifuRecordModel;
     ctx.startSfen = m_deps.startSfenStr;
     ctx.playMode = m_deps.playMode;
@@ -172,7 +174,9 @@ QString KifuExportClipboard::generateBodText(const PositionData& pos) const
 KifuClipboardService::ExportContext KifuExportClipboard::buildClipboardContext() const
 {
     KifuClipboardService::ExportContext ctx;
-    ctx.gameInfoTable = m_deps.gameInfoController ? m_deps.gameInfoController->tableWidget() : nullptr;
+    if (m_deps.gameInfoController) {
+        ctx.gameInfo = m_deps.gameInfoController->gameInfo();
+    }
     ctx.recordModel = m_deps.kifuRecordModel;
     ctx.gameRecord = m_deps.gameRecord;
     ctx.startSfen = m_deps.startSfenStr;
@@ -125,7 +125,9 @@ QStringList KifuExportController::resolveUsiMoves() const
 GameRecordModel::ExportContext KifuExportController::buildExportContext() const
 {
     GameRecordModel::ExportContext ctx;
-    ctx.gameInfoTable = m_deps.gameInfoController ? m_deps.gameInfoController->tableWidget() : nullptr;
+    if (m_deps.gameInfoController) {
+        ctx.gameInfo = m_deps.gameInfoController->gameInfo();
+    }
     ctx.recordModel = m_deps.kifuRecordModel;
     ctx.startSfen = m_deps.startSfenStr;
     ctx.playMode = m_deps.playMode;
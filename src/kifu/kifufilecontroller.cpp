@@ -41,6 +41,16 @@ void KifuFileController::chooseAndLoadKifuFile()
 
     if (filePath.isEmpty()) return;
 
+    // 2) 選択したファイルを読み込む
+    loadKifuFile(filePath);
+
+    qCDebug(lcApp) << "chooseAndLoadKifuFile LEAVE";
+}
+
+void KifuFileController::loadKifuFile(const QString& filePath)
+{
+    if (filePath.isEmpty()) return;
+
     // 選択したファイルのディレクトリを保存
     QFileInfo fileInfo(filePath);
     GameSettings::setLastKifuDirectory(fileInfo.absolutePath());
@@ -49,13 +59,11 @@ void KifuFileController::chooseAndLoadKifuFile()
     if (m_deps.clearUiBeforeKifuLoad) m_deps.clearUiBeforeKifuLoad();
     if (m_deps.ensurePlayerInfoAndGameInfo) m_deps.ensurePlayerInfoAndGameInfo();
 
-    // 2) KifuLoadCoordinator の作成・配線・読み込み実行
+    // KifuLoadCoordinator の作成・配線・読み込み実行
     if (m_deps.createAndWireKifuLoadCoordinator) m_deps.createAndWireKifuLoadCoordinator();
 
-    qCDebug(lcApp) << "chooseAndLoadKifuFile: loading file=" << filePath;
+    qCDebug(lcApp) << "loadKifuFile: loading file=" << filePath;
     dispatchKifuLoad(filePath);
-
-    qCDebug(lcApp) << "chooseAndLoadKifuFile LEAVE";
 }
 
 void KifuFileController::saveKifuToFile()
@@ -118,13 +126,12 @@ void KifuFileController::onKifuPasteImportRequested(const QString& content)
 
     auto* klc = m_deps.getKifuLoadCoordinator ? m_deps.getKifuLoadCoordinator() : nullptr;
     if (klc) {
-        const bool success = klc->loadKifuFromString(content);
-        if (m_deps.statusBar) {
-            if (success) {
-                m_deps.statusBar->showMessage(tr("棋譜を取り込みました"), 3000);
-            } else {
-                m_deps.statusBar->showMessage(tr("棋譜の取り込みに失敗しました"), 3000);
-            }
+        // 解析はワーカーで行われるので、結果の表示は kifuLoadFinished を受けてから行う
+        connect(klc, &KifuLoadCoordinator::kifuLoadFinished,
+                this, &KifuFileController::onPastedKifuLoadFinished, Qt::UniqueConnection);
+        m_pasteImportPending = true;
+        if (!klc->loadKifuFromString(content)) {
+            onPastedKifuLoadFinished(false);
         }
     } else {
         qCWarning(lcApp) << "onKifuPasteImportRequested: KifuLoadCoordinator is null";
@@ -134,6 +141,20 @@ void KifuFileController::onKifuPasteImportRequested(const QString& content)
     }
 }
 
+void KifuFileController::onPastedKifuLoadFinished(bool success)
+{
+    if (!m_pasteImportPending) return;
+    m_pasteImportPending = false;
+
+    if (m_deps.statusBar) {
+        if (success) {
+            m_deps.statusBar->showMessage(tr("棋譜を取り込みました"), 3000);
+        } else {
+            m_deps.statusBar->showMessage(tr("棋譜の取り込みに失敗しました"), 3000);
+        }
+    }
+}
+
 void KifuFileController::onSfenCollectionPositionSelected(const QString& sfen)
 {
     if (m_deps.clearUiBeforeKifuLoad) m_deps.clearUiBeforeKifuLoad();
@@ -187,6 +208,9 @@ void KifuFileController::autoSaveKifuToFile(const QString& saveDir, PlayMode pla
 
 void KifuFileController::dispatchKifuLoad(const QString& filePath)
 {
+    // 貼り付けの解析中にファイルを開いた場合、貼り付け側の読み込みは取り消される
+    m_pasteImportPending = false;
+
     auto* klc = m_deps.getKifuLoadCoordinator ? m_deps.getKifuLoadCoordinator() : nullptr;
     if (!klc) return;
 
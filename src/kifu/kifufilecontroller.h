@@ -57,6 +57,8 @@ public:
 public slots:
     /// 棋譜ファイルを選択して開く
     void chooseAndLoadKifuFile();
+    /// 指定した棋譜ファイルを開く（棋譜データベースからの選択など）
+    void loadKifuFile(const QString& filePath);
     /// 名前を付けて保存
     void saveKifuToFile();
     /// 上書き保存
@@ -74,11 +76,16 @@ public:
                             const QString& humanName1, const QString& humanName2,
                             const QString& engineName1, const QString& engineName2);
 
+private slots:
+    /// 貼り付けた棋譜の読み込み完了（ワーカーでの解析後）に結果をステータスバーへ表示する
+    void onPastedKifuLoadFinished(bool success);
+
 private:
     void dispatchKifuLoad(const QString& filePath);
 
     Deps m_deps;
     QPointer<KifuPasteDialog> m_kifuPasteDialog;
+    bool m_pasteImportPending = false;   ///< 貼り付けた棋譜の読み込み完了待ち
 };
 
 #endif // KIFUFILECONTROLLER_H
@@ -0,0 +1,91 @@
+/// @file kifuformatconverter.cpp
+/// @brief 棋譜ファイルの形式変換の実装
+
+#include "kifuformatconverter.h"
+#include "gamerecordmodel.h"
+#include "kifparsetypes.h"
+#include "kifubranchtree.h"
+#include "kifubranchtreebuilder.h"
+#include "kifucorpusfiles.h"
+#include "kifuioservice.h"
+#include "sfenutils.h"
+
+#include <QFileInfo>
+
+namespace KifuFormatConverter {
+
+const QStringList &outputSuffixes()
+{
+    static const QStringList suffixes = {
+        QStringLiteral("kif"), QStringLiteral("kifu"), QStringLiteral("ki2"), QStringLiteral("ki2u"),
+        QStringLiteral("csa"), QStringLiteral("jkf"), QStringLiteral("usen"), QStringLiteral("usi"),
+    };
+    return suffixes;
+}
+
+bool isOutputSuffix(const QString &suffix)
+{
+    return outputSuffixes().contains(suffix, Qt::CaseInsensitive);
+}
+
+QStringList exportLines(KifParseResult &result, const QString &suffix)
+{
+    const QString format = suffix.toLower();
+    if (!isOutputSuffix(format)) return {};
+
+    // 読み込み時と同じく、分岐ツリーを組む前に各手順の局面列を揃える
+    KifuBranchTreeBuilder::completeSfenLists(result);
+
+    // 初期局面（手合割）は本譜の開始局面。形式が持たない場合は平手
+    QString startSfen = result.mainline.baseSfen;
+    if (startSfen.isEmpty()) startSfen = SfenUtils::hirateSfen();
+
+    KifuBranchTree tree;
+    KifuBranchTreeBuilder::buildFromKifParseResult(&tree, result, startSfen);
+    GameRecordModel model;
+    model.setBranchTree(&tree);
+
+    GameRecordModel::ExportContext ctx;
+    ctx.gameInfo = result.gameInfo;
+    ctx.startSfen = startSfen;
+
+    const QStringList &usiMoves = result.mainline.usiMoves;
+    if (format == QLatin1String("kif") || format == QLatin1String("kifu")) return model.toKifLines(ctx);
+    if (format == QLatin1String("ki2") || format == QLatin1String("ki2u")) return model.toKi2Lines(ctx);
+    if (format == QLatin1String("csa")) return model.toCsaLines(ctx, usiMoves);
+    if (format == QLatin1String("jkf")) return model.toJkfLines(ctx);
+    if (format == QLatin1String("usen")) return model.toUsenLines(ctx, usiMoves);
+    return model.toUsiLines(ctx, usiMoves);
+}
+
+bool convertFile(const QString &inputPath, const QString &suffix, QStringList &lines, QString *errorMessage)
+{
+    lines.clear();
+    if (!isOutputSuffix(suffix)) {
+        if (errorMessage) *errorMessage = QStringLiteral("対応していない出力形式です: %1").arg(suffix);
+        return false;
+    }
+
+    KifParseResult result;
+    if (!KifuCorpusFiles::parseFile(inputPath, result, errorMessage)) return false;
+    if (result.mainline.usiMoves.isEmpty() && result.mainline.disp.size() <= 1) {
+        if (errorMessage) *errorMessage = QStringLiteral("指し手を取得できませんでした: %1").arg(inputPath);
+        return false;
+    }
+
+    lines = exportLines(result, suffix);
+    return true;
+}
+
+bool writeFile(const QString &outputPath, QStringList lines, QString *errorMessage)
+{
+    // 「名前を付けて保存」と同じく、.kif / .ki2 は Shift_JIS で書き、ヘッダの文字コード宣言も合わせる
+    const QString suffix = QFileInfo(outputPath).suffix().toLower();
+    const bool shiftJis = suffix == QLatin1String("kif") || suffix == QLatin1String("ki2");
+    if (shiftJis && !lines.isEmpty() && lines.first().contains(QLatin1String("encoding=UTF-8"))) {
+        lines.first().replace(QLatin1String("encoding=UTF-8"), QLatin1String("encoding=Shift_JIS"));
+    }
+    return KifuIoService::writeKifuFile(outputPath, lines, errorMessage, shiftJis);
+}
+
+} // namespace KifuFormatConverter
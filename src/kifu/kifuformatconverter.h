@@ -0,0 +1,50 @@
+/// @file kifuformatconverter.h
+/// @brief 棋譜ファイルの形式変換（読み込み → 分岐ツリー → 各形式エクスポータ）
+
+#ifndef KIFUFORMATCONVERTER_H
+#define KIFUFORMATCONVERTER_H
+
+#include <QString>
+#include <QStringList>
+
+struct KifParseResult;
+
+/// GUI を介さずに棋譜を別の形式へ変換する（棋譜の一括変換ツール shogiboardq-convert 用）。
+/// 出力は「名前を付けて保存」と同じエクスポータで作るので、GUI で保存した棋譜と同じ内容になる。
+/// 状態を持たないので、ワーカースレッドから並行に呼んでよい。
+namespace KifuFormatConverter {
+
+/// 出力できる形式の拡張子（"kif", "kifu", "ki2", "ki2u", "csa", "jkf", "usen", "usi"）
+const QStringList &outputSuffixes();
+
+/// 出力できる形式の拡張子か（大文字小文字は区別しない）
+bool isOutputSuffix(const QString &suffix);
+
+/**
+ * @brief 解析済みの棋譜を指定形式の行リストにする
+ * @param result 棋譜の解析結果（sfenList が未生成なら補完する）
+ * @param suffix 出力形式の拡張子（outputSuffixes() のいずれか）
+ * @return 出力形式の行リスト（未対応の拡張子なら空）
+ */
+QStringList exportLines(KifParseResult &result, const QString &suffix);
+
+/**
+ * @brief 棋譜ファイルを読み、指定形式の行リストにする
+ * @param inputPath 入力の棋譜ファイル（形式は拡張子で判断する）
+ * @param suffix 出力形式の拡張子
+ * @param lines 出力形式の行リスト
+ * @param errorMessage 失敗時のエラーメッセージ（nullptr 可）
+ */
+[[nodiscard]] bool convertFile(const QString &inputPath, const QString &suffix, QStringList &lines,
+                               QString *errorMessage = nullptr);
+
+/**
+ * @brief 行リストを出力先の拡張子に合った文字コードで書き出す
+ *
+ * .kif / .ki2 は Shift_JIS（ヘッダの encoding 行も差し替える）、それ以外は UTF-8 で書く。
+ */
+[[nodiscard]] bool writeFile(const QString &outputPath, QStringList lines, QString *errorMessage = nullptr);
+
+} // namespace KifuFormatConverter
+
+#endif // KIFUFORMATCONVERTER_H
@@ -4,8 +4,8 @@
 #include "kifuloadcoordinator.h"
 #include "kifuapplyservice.h"
 #include "kifufilereader.h"
+#include "kifreader.h"
 #include "kiftosfenconverter.h"
-#include "sfenpositiontracer.h"
 #include "recordpane.h"
 #include "kifurecordlistmodel.h"
 #include "kifubranchlistmodel.h"
@@ -15,6 +15,7 @@
 #include "usentosfenconverter.h"
 #include "usitosfenconverter.h"
 #include "kifubranchtree.h"
+#include "kifubranchtreebuilder.h"
 #include "kifunavigationstate.h"
 #include "sfenutils.h"
 
@@ -25,14 +26,9 @@
 #include <QFile>
 #include <QTextStream>
 #include <QTableWidget>
-#include <QPainter>
 #include <QFileInfo>
 #include <QDir>
-#include <QElapsedTimer>
-
-namespace {
-const QColor kBranchHighlightColor(255, 220, 160);
-} // namespace
+#include <QtConcurrent>
 
 KifuLoadCoordinator::KifuLoadCoordinator(QList<ShogiMove>& gameMoves,
                                          QStringList& positionStrList,
@@ -62,6 +58,8 @@ KifuLoadCoordinator::KifuLoadCoordinator(QList<ShogiMove>& gameMoves,
     , m_kifuBranchModel(kifuBranchModel)
 {
     initApplyService();
+    connect(&m_loadWatcher, &QFutureWatcher<ParseOutcome>::finished,
+            this, &KifuLoadCoordinator::onKifuParseFinished);
 }
 
 void KifuLoadCoordinator::initApplyService()
@@ -154,97 +152,111 @@ static void dumpVariationsDebug(const KifParseResult& res)
 // 棋譜読み込み共通処理
 // ============================================================
 
+KifuLoadCoordinator::~KifuLoadCoordinator()
+{
+    // 解析中のワーカーは結果を捨てて早めに終わらせる（ワーカーは this を参照しない）
+    if (m_loadCancel) {
+        m_loadCancel->store(true);
+    }
+}
+
 void KifuLoadCoordinator::loadKifuCommon(
     const QString& filePath,
     const char* funcName,
     const KifuParseFunc& parseFunc,
-    const KifuDetectSfenFunc& detectSfenFunc,
-    const KifuExtractGameInfoFunc& extractGameInfoFunc,
+    bool applyGameInfo,
     bool dumpVariations)
 {
-    QElapsedTimer totalTimer;
-    totalTimer.start();
-    QElapsedTimer stepTimer;
-    auto logStep = [&](const char* stepName) {
-        qCDebug(lcKifu).noquote() << QStringLiteral("%1: %2 ms").arg(stepName).arg(stepTimer.elapsed());
-        stepTimer.restart();
-    };
-    stepTimer.start();
-
     qCDebug(lcKifu).noquote() << funcName << "IN file=" << filePath;
 
     m_loadingKifu = true;
 
-    // 1) 初期局面（手合割）を決定
-    QString teaiLabel;
-    QString initialSfen;
-    if (detectSfenFunc) {
-        initialSfen = detectSfenFunc(filePath, &teaiLabel);
-        if (initialSfen.isEmpty()) {
-            initialSfen = SfenUtils::hirateSfen();
-            teaiLabel = QStringLiteral("平手(既定)");
+    // 1) ファイルは GUI スレッドで1度だけ読む（貼り付け用の一時ファイルは戻った直後に消される）
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(lcKifu).noquote() << "open failed:" << filePath;
+        emit errorOccurred(tr("棋譜ファイルの読み込みに失敗しました: %1")
+                               .arg(QFileInfo(filePath).fileName()));
+        m_loadingKifu = false;
+        emit kifuLoadFinished(false);
+        return;
+    }
+    const QByteArray bytes = file.readAll();
+    file.close();
+
+    // 2) 前の読み込みが残っていれば取り消し、デコード・解析・SFEN補完をワーカーで行う
+    if (m_loadCancel) {
+        m_loadCancel->store(true);
+    }
+    m_loadCancel = makeCancelFlag();
+    m_pendingLoad = PendingLoad{filePath, funcName, applyGameInfo, dumpVariations};
+    m_loadTimer.start();
+
+    const CancelFlag cancel = m_loadCancel;
+    m_loadWatcher.setFuture(QtConcurrent::run([bytes, parseFunc, cancel]() {
+        ParseOutcome outcome;
+        outcome.ok = parseFunc(bytes, outcome.res, &outcome.warn);
+        if (outcome.ok && !cancel->load()) {
+            KifuBranchTreeBuilder::completeSfenLists(outcome.res, cancel.get());
         }
-    } else {
-        initialSfen = prepareInitialSfen(filePath, teaiLabel);
+        outcome.cancelled = cancel->load();
+        return outcome;
+    }));
+    // 3) 以降（初期局面の決定・対局情報・結果適用）は onKifuParseFinished() で行う
+}
+
+void KifuLoadCoordinator::onKifuParseFinished()
+{
+    ParseOutcome outcome = m_loadWatcher.result();
+    if (outcome.cancelled) {
+        qCDebug(lcKifu).noquote() << m_pendingLoad.funcName << "OUT (cancelled)";
+        return;
     }
-    logStep("detectInitialSfen");
 
-    // 2) 解析（本譜＋分岐＋コメント）を一括取得
-    KifParseResult res;
-    QString parseWarn;
-    if (!parseFunc(filePath, res, &parseWarn)) {
+    const QString& filePath = m_pendingLoad.filePath;
+    const char* funcName = m_pendingLoad.funcName;
+    KifParseResult& res = outcome.res;
+    const QString& parseWarn = outcome.warn;
+    qCDebug(lcKifu).noquote() << QStringLiteral("parse (worker): %1 ms").arg(m_loadTimer.elapsed());
+
+    if (!outcome.ok) {
         qCWarning(lcKifu).noquote() << "parse failed:" << filePath << parseWarn;
         QString detail = parseWarn.isEmpty() ? QString() : QStringLiteral("\n") + parseWarn;
         emit errorOccurred(tr("棋譜ファイルの読み込みに失敗しました: %1%2")
                                .arg(QFileInfo(filePath).fileName(), detail));
         m_loadingKifu = false;
+        emit kifuLoadFinished(false);
         return;
     }
     if (!parseWarn.isEmpty()) {
         qCWarning(lcKifu).noquote() << "parse warn:" << parseWarn;
         emit errorOccurred(tr("棋譜の読み込みで警告があります:\n%1").arg(parseWarn));
     }
-    logStep("parseFunc");
 
-    // 2.5) sfenList が未生成の場合は baseSfen + usiMoves から補完
-    if (res.mainline.sfenList.isEmpty() && !res.mainline.usiMoves.isEmpty()) {
-        res.mainline.sfenList = SfenPositionTracer::buildSfenRecord(
-            res.mainline.baseSfen, res.mainline.usiMoves, false);
-    }
-    for (KifVariation& var : res.variations) {
-        if (!var.line.sfenList.isEmpty() || var.line.usiMoves.isEmpty()) {
-            continue;
-        }
-        if (var.line.baseSfen.isEmpty() && !res.mainline.sfenList.isEmpty()) {
-            const int branchPly = var.startPly - 1;
-            if (branchPly >= 0 && branchPly < res.mainline.sfenList.size()) {
-                var.line.baseSfen = res.mainline.sfenList.at(branchPly);
-            }
-        }
-        if (!var.line.baseSfen.isEmpty()) {
-            var.line.sfenList = SfenPositionTracer::buildSfenRecord(
-                var.line.baseSfen, var.line.usiMoves, var.line.endsWithTerminal);
-        }
+    // 初期局面（手合割）は解析結果の本譜の開始局面
+    QString initialSfen = res.mainline.baseSfen;
+    QString teaiLabel = res.teaiLabel;
+    if (initialSfen.isEmpty()) {
+        initialSfen = SfenUtils::hirateSfen();
+        teaiLabel = QStringLiteral("平手(既定)");
     }
 
-    // 3) デバッグ出力
+    // デバッグ出力
     dumpMainline(res, parseWarn);
-    if (dumpVariations) {
+    if (m_pendingLoad.dumpVariations) {
         dumpVariationsDebug(res);
     }
-    logStep("dumpMainline/Variations");
 
-    // 4) 先手/後手名などヘッダ反映
-    if (extractGameInfoFunc) {
-        const QList<KifGameInfoItem> infoItems = extractGameInfoFunc(filePath);
-        m_applyService->populateGameInfo(infoItems);
-        m_applyService->applyPlayersFromGameInfo(infoItems);
+    // 先手/後手名などヘッダ反映
+    if (m_pendingLoad.applyGameInfo) {
+        m_applyService->populateGameInfo(res.gameInfo);
+        m_applyService->applyPlayersFromGameInfo(res.gameInfo);
     }
-    logStep("extractGameInfo");
 
-    // 5) 共通の後処理（KifuApplyService に委譲）
+    // 共通の後処理（KifuApplyService に委譲）
     m_applyService->applyParsedResult(filePath, initialSfen, teaiLabel, res, parseWarn, funcName);
-    qCDebug(lcKifu).noquote() << QStringLiteral("loadKifuCommon TOTAL: %1 ms").arg(totalTimer.elapsed());
+    qCDebug(lcKifu).noquote() << QStringLiteral("loadKifuCommon TOTAL: %1 ms").arg(m_loadTimer.elapsed());
+    emit kifuLoadFinished(true);
 }
 
 // ============================================================
@@ -256,13 +268,12 @@ void KifuLoadCoordinator::loadKi2FromFile(const QString& filePath)
     loadKifuCommon(
         filePath,
         "loadKi2FromFile",
-        [](const QString& path, KifParseResult& res, QString* warn) {
-            return Ki2ToSfenConverter::parseWithVariations(path, res, warn);
-        },
-        KifuDetectSfenFunc(),
-        [](const QString& path) {
-            return CsaToSfenConverter::extractGameInfo(path);
+        [](const QByteArray& bytes, KifParseResult& res, QString* warn) {
+            QStringList lines;
+            KifReader::decodeLinesAuto(bytes, lines, nullptr, warn);
+            return Ki2ToSfenConverter::parseLines(lines, res, warn);
         },
+        true,
         false
     );
 }
@@ -272,13 +283,12 @@ void KifuLoadCoordinator::loadCsaFromFile(const QString& filePath)
     loadKifuCommon(
         filePath,
         "loadCsaFromFile",
-        [](const QString& path, KifParseResult& res, QString* warn) {
-            return CsaToSfenConverter::parse(path, res, warn);
-        },
-        KifuDetectSfenFunc(),
-        [](const QString& path) {
-            return CsaToSfenConverter::extractGameInfo(path);
+        [](const QByteArray& bytes, KifParseResult& res, QString* warn) {
+            QStringList lines;
+            CsaToSfenConverter::decodeLines(bytes, lines);
+            return CsaToSfenConverter::parseLines(lines, res, warn);
         },
+        true,
         false
     );
 }
@@ -288,15 +298,10 @@ void KifuLoadCoordinator::loadJkfFromFile(const QString& filePath)
     loadKifuCommon(
         filePath,
         "loadJkfFromFile",
-        [](const QString& path, KifParseResult& res, QString* warn) {
-            return JkfToSfenConverter::parseWithVariations(path, res, warn);
-        },
-        [](const QString& path, QString* label) {
-            return JkfToSfenConverter::detectInitialSfenFromFile(path, label);
-        },
-        [](const QString& path) {
-            return JkfToSfenConverter::extractGameInfo(path);
+        [](const QByteArray& bytes, KifParseResult& res, QString* warn) {
+            return JkfToSfenConverter::parseJson(bytes, res, warn);
         },
+        true,
         true
     );
 }
@@ -306,13 +311,12 @@ void KifuLoadCoordinator::loadKifuFromFile(const QString& filePath)
     loadKifuCommon(
         filePath,
         "loadKifuFromFile",
-        [](const QString& path, KifParseResult& res, QString* warn) {
-            return KifToSfenConverter::parseWithVariations(path, res, warn);
-        },
-        KifuDetectSfenFunc(),
-        [](const QString& path) {
-            return KifToSfenConverter::extractGameInfo(path);
+        [](const QByteArray& bytes, KifParseResult& res, QString* warn) {
+            QStringList lines;
+            KifReader::decodeLinesAuto(bytes, lines, nullptr, warn);
+            return KifToSfenConverter::parseLines(lines, res, warn);
         },
+        true,
         true
     );
 }
@@ -322,15 +326,10 @@ void KifuLoadCoordinator::loadUsenFromFile(const QString& filePath)
     loadKifuCommon(
         filePath,
         "loadUsenFromFile",
-        [](const QString& path, KifParseResult& res, QString* warn) {
-            return UsenToSfenConverter::parseWithVariations(path, res, warn);
-        },
-        [](const QString& path, QString* label) {
-            return UsenToSfenConverter::detectInitialSfenFromFile(path, label);
-        },
-        [](const QString& path) {
-            return UsenToSfenConverter::extractGameInfo(path);
+        [](const QByteArray& bytes, KifParseResult& res, QString* warn) {
+            return UsenToSfenConverter::parseContent(QString::fromUtf8(bytes).trimmed(), res, warn);
         },
+        true,
         true
     );
 }
@@ -340,13 +339,12 @@ void KifuLoadCoordinator::loadUsiFromFile(const QString& filePath)
     loadKifuCommon(
         filePath,
         "loadUsiFromFile",
-        [](const QString& path, KifParseResult& res, QString* warn) {
-            return UsiToSfenConverter::parseWithVariations(path, res, warn);
+        [](const QByteArray& bytes, KifParseResult& res, QString* warn) {
+            QStringList lines;
+            KifReader::decodeLinesAuto(bytes, lines, nullptr, warn);
+            return UsiToSfenConverter::parseLines(lines, res, warn);
         },
-        [](const QString& path, QString* label) {
-            return UsiToSfenConverter::detectInitialSfenFromFile(path, label);
-        },
-        KifuExtractGameInfoFunc(),
+        false,
         false
     );
 }
@@ -368,11 +366,12 @@ bool KifuLoadCoordinator::loadKifuFromString(const QString& content)
     const auto fmt = KifuFileReader::detectFormat(content);
 
     // SFEN/BOD は適用層で直接処理
-    if (fmt == KifuFileReader::KifuFormat::SFEN) {
-        return m_applyService->loadPositionFromSfen(content.trimmed());
-    }
-    if (fmt == KifuFileReader::KifuFormat::BOD) {
-        return m_applyService->loadPositionFromBod(content);
+    if (fmt == KifuFileReader::KifuFormat::SFEN || fmt == KifuFileReader::KifuFormat::BOD) {
+        const bool ok = fmt == KifuFileReader::KifuFormat::SFEN
+                            ? m_applyService->loadPositionFromSfen(content.trimmed())
+                            : m_applyService->loadPositionFromBod(content);
+        emit kifuLoadFinished(ok);
+        return ok;
     }
 
     // 一時ファイルを作成して読み込み
@@ -414,84 +413,6 @@ bool KifuLoadCoordinator::loadPositionFromBod(const QString& bodStr)
     return m_applyService->loadPositionFromBod(bodStr);
 }
 
-// ============================================================
-// 初期SFEN検出
-// ============================================================
-
-QString KifuLoadCoordinator::prepareInitialSfen(const QString& filePath, QString& teaiLabel) const
-{
-    const QString sfen = KifToSfenConverter::detectInitialSfenFromFile(filePath, &teaiLabel);
-    return sfen.isEmpty()
-               ? SfenUtils::hirateSfen()
-               : sfen;
-}
-
-// ============================================================
-// 分岐マーカー描画
-// ============================================================
-
-void KifuLoadCoordinator::updateKifuBranchMarkersForActiveRow()
-{
-    m_branchablePlySet.clear();
-
-    QTableView* view = (m_recordPane ? m_recordPane->kifuView() : nullptr);
-
-    if (m_branchTree != nullptr && !m_branchTree->isEmpty()) {
-        QList<BranchLine> lines = m_branchTree->allLines();
-        const int nLines = static_cast<int>(lines.size());
-        const int currentLineIdx = (m_navState != nullptr) ? m_navState->currentLineIndex() : 0;
-        const int active = (nLines == 0) ? 0 : qBound(0, currentLineIdx, nLines - 1);
-
-        if (active >= 0 && active < nLines) {
-            const BranchLine& line = lines.at(active);
-            m_branchablePlySet = m_branchTree->branchablePlysOnLine(line);
-        }
-    }
-
-    ensureBranchRowDelegateInstalled();
-
-    if (view && view->viewport()) view->viewport()->update();
-}
-
-void KifuLoadCoordinator::ensureBranchRowDelegateInstalled()
-{
-    QTableView* view = (m_recordPane ? m_recordPane->kifuView() : nullptr);
-    if (!view) return;
-
-    if (!m_branchRowDelegate) {
-        m_branchRowDelegate = new BranchRowDelegate(view);
-        view->setItemDelegate(m_branchRowDelegate);
-    } else {
-        if (m_branchRowDelegate->parent() != view) {
-            m_branchRowDelegate->setParent(view);
-            view->setItemDelegate(m_branchRowDelegate);
-        }
-    }
-
-    m_branchRowDelegate->setMarkers(&m_branchablePlySet);
-}
-
-KifuLoadCoordinator::BranchRowDelegate::BranchRowDelegate(QObject* parent)
-    : QStyledItemDelegate(parent) {}
-
-KifuLoadCoordinator::BranchRowDelegate::~BranchRowDelegate() = default;
-
-void KifuLoadCoordinator::BranchRowDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
-{
-    QStyleOptionViewItem opt(option);
-    QStyledItemDelegate::initStyleOption(&opt, index);
-
-    const bool isBranchable = (m_marks && m_marks->contains(index.row()));
-
-    if (isBranchable && !(opt.state & QStyle::State_Selected)) {
-        painter->save();
-        painter->fillRect(opt.rect, kBranchHighlightColor);
-        painter->restore();
-    }
-
-    QStyledItemDelegate::paint(painter, opt, index);
-}
-
 // ============================================================
 // 外部オブジェクト設定
 // ============================================================
@@ -9,6 +9,8 @@
 #include <QTableWidget>
 #include <QDockWidget>
 #include <QStyledItemDelegate>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <functional>
 
 #include "logcategories.h"
@@ -17,6 +19,7 @@
 #include "shogiview.h"
 #include "recordpane.h"
 #include "kifurecordlistmodel.h"
+#include "threadtypes.h"
 
 class KifuBranchTree;
 class KifuNavigationState;
@@ -31,6 +34,8 @@ class KifuApplyService;
  *
  * I/O層は KifuFileReader、適用層は KifuApplyService に委譲し、
  * 本クラスは解析→データ構築→UI反映の3段パイプラインの調整役に専念する。
+ * ファイルは1度だけ読み、デコードと解析はワーカースレッドで行って結果だけを GUI スレッドで反映する
+ * （続けて読み込むと前の解析は取り消される）。
  */
 class KifuLoadCoordinator : public QObject
 {
@@ -50,6 +55,7 @@ public:
                         KifuRecordListModel* kifuRecordModel,
                         KifuBranchListModel* kifuBranchModel,
                         QObject* parent=nullptr);
+    ~KifuLoadCoordinator() override;
 
     // --- 装飾（棋譜テーブル マーカー描画） ---
 
@@ -88,6 +94,7 @@ public:
     // --- テキスト・局面読み込み ---
 
     /// 文字列から棋譜を読み込む（棋譜貼り付け機能用、形式を自動判定）
+    /// @return 読み込みを開始できたか。棋譜の解析はワーカーで行われ、成否は kifuLoadFinished で通知する
     [[nodiscard]] bool loadKifuFromString(const QString& content);
 
     /// SFEN形式の局面を読み込む
@@ -141,6 +148,9 @@ signals:
     /// 分岐ツリーの構築が完了した時に通知する
     void branchTreeBuilt();
 
+    /// 棋譜・局面の読み込みが完了した時に通知する（解析失敗時は false。取り消された読み込みでは通知しない）
+    void kifuLoadFinished(bool success);
+
 private:
     void initApplyService();
 
@@ -186,21 +196,43 @@ private:
     KifuApplyService* m_applyService = nullptr; ///< 適用層サービス（Qt parent所有）
 
     // --- 内部ヘルパ ---
-    QString prepareInitialSfen(const QString& filePath, QString& teaiLabel) const;
     void updateKifuBranchMarkersForActiveRow();
     void ensureBranchRowDelegateInstalled();
 
     // --- 棋譜読み込み共通ロジック ---
-    using KifuParseFunc = std::function<bool(const QString&, KifParseResult&, QString*)>;
-    using KifuDetectSfenFunc = std::function<QString(const QString&, QString*)>;
-    using KifuExtractGameInfoFunc = std::function<QList<KifGameInfoItem>(const QString&)>;
 
-    /// 棋譜読み込みの共通フロー（解析→データ構築→UI反映）
+    /// 読み込み済みのファイル内容から KifParseResult を組み立てる（ワーカースレッドで呼ばれる）
+    using KifuParseFunc = std::function<bool(const QByteArray&, KifParseResult&, QString*)>;
+
+    /// ワーカースレッドでの解析結果
+    struct ParseOutcome {
+        bool ok = false;          ///< parseFunc の戻り値
+        bool cancelled = false;   ///< 後続の読み込みで取り消された
+        KifParseResult res;       ///< 解析結果（sfenList 補完済み）
+        QString warn;             ///< 解析中の警告
+    };
+
+    /// 解析中の読み込み要求（完了時に GUI スレッドで参照する）
+    struct PendingLoad {
+        QString filePath;
+        const char* funcName = "";
+        bool applyGameInfo = false;
+        bool dumpVariations = false;
+    };
+
+    PendingLoad m_pendingLoad;                     ///< 解析中の読み込み要求
+    QFutureWatcher<ParseOutcome> m_loadWatcher;    ///< ワーカーでの解析の完了通知
+    CancelFlag m_loadCancel;                       ///< 解析中の読み込みの取り消しフラグ
+    QElapsedTimer m_loadTimer;                     ///< 読み込み開始からの経過時間（ログ用）
+
+    /// 棋譜読み込みの共通フロー（読み込み→ワーカーで解析→onKifuParseFinished で反映）
     void loadKifuCommon(const QString& filePath, const char* funcName,
                          const KifuParseFunc& parseFunc,
-                         const KifuDetectSfenFunc& detectSfenFunc,
-                         const KifuExtractGameInfoFunc& extractGameInfoFunc,
+                         bool applyGameInfo,
                          bool dumpVariations);
+
+    /// ワーカーでの解析完了時に初期局面・対局情報・解析結果を反映する
+    void onKifuParseFinished();
 };
 
 #endif // KIFULOADCOORDINATOR_H
@@ -0,0 +1,202 @@
+/// @file kifupositioncache.cpp
+/// @brief 分岐ツリーノードの局面を指し手の再生で復元するキャッシュの実装
+
+#include "kifupositioncache.h"
+#include "kifubranchnode.h"
+
+KifuPositionCache::KifuPositionCache(int capacity)
+    : m_decoded(capacity)
+{
+}
+
+void KifuPositionCache::attach(KifuBranchNode* node, const QString& sfen)
+{
+    if (node == nullptr) {
+        return;
+    }
+    node->m_positionCache = this;
+    node->m_positionKey = positionKey(sfen);
+
+    // 親局面に指し手を適用して sfen を完全に再現できる場合だけ文字列を捨てる
+    const QString usi = usiMoveOf(node);
+    SfenPositionTracer tracer;
+    if (node->m_parent != nullptr && !usi.isEmpty() && traceTo(node->m_parent, tracer)
+        && tracer.applyUsiMove(usi) && tracer.toSfenString() == sfen) {
+        node->m_positionSource = KifuBranchNode::PositionSource::ParentMove;
+        node->m_sfen.clear();
+        // 直後に子が追加されることが多いので復元済みとして残す
+        m_decoded.insert(node->nodeId(), new SfenPositionTracer(tracer));
+        return;
+    }
+
+    node->m_positionSource = KifuBranchNode::PositionSource::Anchor;
+    node->m_sfen = sfen;
+}
+
+void KifuPositionCache::attachSameAsParent(KifuBranchNode* node)
+{
+    if (node == nullptr) {
+        return;
+    }
+    if (node->m_parent == nullptr) {
+        attach(node, QString());
+        return;
+    }
+    node->m_positionCache = this;
+    node->m_positionKey = node->m_parent->m_positionKey;
+    node->m_positionSource = KifuBranchNode::PositionSource::Parent;
+    node->m_sfen.clear();
+}
+
+QString KifuPositionCache::sfenOf(const KifuBranchNode* node)
+{
+    if (node == nullptr) {
+        return QString();
+    }
+    if (node->m_positionSource == KifuBranchNode::PositionSource::Anchor) {
+        return node->m_sfen;
+    }
+
+    SfenPositionTracer tracer;
+    if (!traceTo(node, tracer)) {
+        return QString();
+    }
+    return tracer.toSfenString();
+}
+
+bool KifuPositionCache::traceTo(const KifuBranchNode* node, SfenPositionTracer& tracer)
+{
+    // 起点（復元済み、またはアンカー）まで祖先を辿り、途中の指し手を集める
+    QList<const KifuBranchNode*> replay;
+    const KifuBranchNode* current = node;
+    bool fromCache = false;
+    while (current != nullptr) {
+        if (const SfenPositionTracer* decoded = m_decoded.object(current->nodeId())) {
+            tracer = *decoded;
+            fromCache = true;
+            break;
+        }
+        if (current->m_positionSource == KifuBranchNode::PositionSource::Anchor) {
+            if (!tracer.setFromSfen(current->m_sfen)) {
+                return false;
+            }
+            break;
+        }
+        if (current->m_positionSource == KifuBranchNode::PositionSource::ParentMove) {
+            replay.append(current);
+        }
+        current = current->m_parent;
+    }
+    if (current == nullptr) {
+        return false;
+    }
+
+    for (auto it = replay.crbegin(); it != replay.crend(); ++it) {
+        if (!tracer.applyUsiMove(usiMoveOf(*it))) {
+            return false;
+        }
+    }
+
+    if (!fromCache || current != node) {
+        m_decoded.insert(node->nodeId(), new SfenPositionTracer(tracer));
+    }
+    return true;
+}
+
+QStringList KifuPositionCache::sfenListForPath(const QList<KifuBranchNode*>& path) const
+{
+    QStringList result;
+    result.reserve(path.size());
+
+    // 直前の局面を保ったトレーサに指し手を1手ずつ適用する（祖先の再生を繰り返さない）
+    SfenPositionTracer tracer;
+    bool traced = false;
+    for (const KifuBranchNode* node : path) {
+        switch (node->m_positionSource) {
+        case KifuBranchNode::PositionSource::Anchor:
+            result.append(node->m_sfen);
+            traced = false;
+            break;
+        case KifuBranchNode::PositionSource::Parent:
+            result.append(result.isEmpty() ? node->sfen() : result.constLast());
+            break;
+        case KifuBranchNode::PositionSource::ParentMove:
+            if (!traced && !result.isEmpty()) {
+                traced = tracer.setFromSfen(result.constLast());
+            }
+            if (traced && tracer.applyUsiMove(usiMoveOf(node))) {
+                result.append(tracer.toSfenString());
+            } else {
+                result.append(node->sfen());
+                traced = false;
+            }
+            break;
+        }
+    }
+    return result;
+}
+
+void KifuPositionCache::clear()
+{
+    m_decoded.clear();
+}
+
+QStringView KifuPositionCache::stripPly(QStringView sfen)
+{
+    // 最後のスペース以降が数字のみなら手数部分として除去
+    const qsizetype lastSpace = sfen.lastIndexOf(QLatin1Char(' '));
+    if (lastSpace > 0) {
+        bool isNumber = false;
+        sfen.mid(lastSpace + 1).toInt(&isNumber);
+        if (isNumber) {
+            return sfen.left(lastSpace);
+        }
+    }
+    return sfen;
+}
+
+quint64 KifuPositionCache::positionKey(QStringView sfen)
+{
+    const QStringView position = stripPly(sfen);
+    if (position.isEmpty()) {
+        return 0;
+    }
+
+    quint64 hash = 14695981039346656037ULL;
+    for (const QChar ch : position) {
+        hash ^= ch.unicode();
+        hash *= 1099511628211ULL;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+QString KifuPositionCache::usiMoveOf(const KifuBranchNode* node)
+{
+    const KifuBranchNode::PackedMove& move = node->m_move;
+    if (move.movingPiece == Piece::None) {
+        return QString();
+    }
+    if (move.toX < 0 || move.toX > 8 || move.toY < 0 || move.toY > 8) {
+        return QString();
+    }
+
+    const QChar toFile = QLatin1Char(static_cast<char>('1' + move.toX));
+    const QChar toRank = QLatin1Char(static_cast<char>('a' + move.toY));
+
+    // 駒打ち: fromXが9（先手駒台）または10（後手駒台）
+    if (move.fromX == 9 || move.fromX == 10) {
+        const QChar drop[] = {pieceToChar(toBlack(move.movingPiece)), QLatin1Char('*'), toFile, toRank};
+        return QString(drop, 4);
+    }
+    if (move.fromX < 0 || move.fromX > 8 || move.fromY < 0 || move.fromY > 8) {
+        return QString();
+    }
+
+    const QChar board[] = {QLatin1Char(static_cast<char>('1' + move.fromX)),
+                           QLatin1Char(static_cast<char>('a' + move.fromY)), toFile, toRank};
+    QString usi(board, 4);
+    if (move.promotion) {
+        usi += QLatin1Char('+');
+    }
+    return usi;
+}
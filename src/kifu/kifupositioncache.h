@@ -0,0 +1,72 @@
+#ifndef KIFUPOSITIONCACHE_H
+#define KIFUPOSITIONCACHE_H
+
+/// @file kifupositioncache.h
+/// @brief 分岐ツリーノードの局面を指し手の再生で復元するキャッシュの定義
+
+#include <QCache>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "sfenpositiontracer.h"
+
+class KifuBranchNode;
+
+/**
+ * @brief 分岐ツリーノードの局面SFENを遅延生成するキャッシュ
+ *
+ * ノードは局面SFENを文字列で持たず、親局面＋自分の指し手で再現できることを
+ * attach 時に確かめて「親から再生」の印だけを付ける。再現できない局面
+ * （指し手情報がない、SFENの書式が異なる等）はそのままアンカーとして文字列を保持する。
+ *
+ * sfenOf() は最寄りのアンカーまたはキャッシュ済みの祖先から指し手を再生し、
+ * 復元した局面を最近使った順に少数だけ保持する（LRU）。
+ * KifuBranchTree が所有し、GUIスレッドからのみ使う。
+ */
+class KifuPositionCache
+{
+public:
+    /// キャッシュする復元済み局面の数の既定値
+    static constexpr int kDefaultCapacity = 64;
+
+    explicit KifuPositionCache(int capacity = kDefaultCapacity);
+
+    /**
+     * @brief ノードに局面を結び付ける
+     * @param node 対象ノード（親と指し手は設定済みであること）
+     * @param sfen この手を指した後の局面SFEN
+     *
+     * 親局面に指し手を適用した結果が sfen と完全に一致すれば文字列は保持しない。
+     */
+    void attach(KifuBranchNode* node, const QString& sfen);
+
+    /// 盤面を変化させないノード（終局手）を親と同じ局面として結び付ける
+    void attachSameAsParent(KifuBranchNode* node);
+
+    /// ノードの局面SFENを返す（必要なら祖先から再生する）
+    QString sfenOf(const KifuBranchNode* node);
+
+    /// ルートから終端までのノード列の局面SFENを、1つのトレーサで順に再生して返す
+    QStringList sfenListForPath(const QList<KifuBranchNode*>& path) const;
+
+    /// 復元済み局面をすべて破棄する
+    void clear();
+
+    /// SFENから手数フィールド（末尾の数字）を除いた部分を返す
+    static QStringView stripPly(QStringView sfen);
+
+    /// 手数を除いたSFENの64ビットハッシュ（FNV-1a）。0 は「キーなし」を表す
+    static quint64 positionKey(QStringView sfen);
+
+    /// ノードの指し手をUSI形式にする（盤面を変化させない手や不正な座標なら空文字列）
+    static QString usiMoveOf(const KifuBranchNode* node);
+
+private:
+    /// ノードの局面を復元したトレーサを得る（失敗時は false）
+    bool traceTo(const KifuBranchNode* node, SfenPositionTracer& tracer);
+
+    QCache<int, SfenPositionTracer> m_decoded;  ///< ノードID → 復元済み局面（LRU）
+};
+
+#endif // KIFUPOSITIONCACHE_H
@@ -0,0 +1,131 @@
+/// @file sortedkeyindex.cpp
+/// @brief キー順索引ファイルのマップ・検証とキーの範囲検索
+
+#include "sortedkeyindex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace SortedKeyIndexFormat;
+
+bool SortedKeyIndex::hasMagic(const QString &filePath, const char *magic)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const QByteArray head = file.read(8);
+    return head.size() == 8 && std::memcmp(head.constData(), magic, 8) == 0;
+}
+
+void SortedKeyIndex::close()
+{
+    m_file.close();
+    m_data = nullptr;
+    m_size = 0;
+    m_stringSize = 0;
+    std::fill(std::begin(m_recordCount), std::end(m_recordCount), 0);
+}
+
+bool SortedKeyIndex::open(const QString &filePath, QString *errorMessage)
+{
+    close();
+
+    const auto fail = [&](const QString &message) {
+        if (errorMessage) *errorMessage = message;
+        close();
+        return false;
+    };
+
+    const QString formatName = QString::fromUtf8(m_layout.formatName);
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail(QStringLiteral("ファイルを開けませんでした: %1").arg(filePath));
+    }
+    m_size = m_file.size();
+    const QString invalidFormat = QStringLiteral("%1の形式が正しくありません。\n\nファイル: %2").arg(formatName, filePath);
+    if (m_size < kHeaderSize) return fail(invalidFormat);
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        return fail(QStringLiteral("ファイルをメモリに割り当てられませんでした: %1").arg(filePath));
+    }
+    if (std::memcmp(m_data, m_layout.magic, 8) != 0) return fail(invalidFormat);
+    if (readLE<quint32>(m_data + kHeaderVersion) != m_layout.version) {
+        return fail(QStringLiteral("対応していない%1の版です。\n\nファイル: %2").arg(formatName, filePath));
+    }
+
+    const quint64 size = static_cast<quint64>(m_size);
+    const auto fits = [size](quint64 offset, quint64 length) {
+        return offset <= size && length <= size - offset;
+    };
+    m_bucketBits = readLE<quint32>(m_data + kHeaderBucketBits);
+    const quint64 bucketOffset = readLE<quint64>(m_data + kHeaderBucketOffset);
+    if (m_bucketBits > kMaxBucketBits || !fits(bucketOffset, bucketTableSize(m_bucketBits))) {
+        return fail(invalidFormat);
+    }
+    for (int table = 0; table < kTableCount; ++table) {
+        m_recordCount[table] = readLE<quint32>(m_data + kHeaderRecordCount + table * 4);
+        const quint64 offset = readLE<quint64>(m_data + kHeaderTableOffset + table * 8);
+        if (!fits(offset, quint64(m_recordCount[table]) * quint64(m_layout.recordSize[table]))) {
+            return fail(invalidFormat);
+        }
+        m_tables[table] = m_data + offset;
+    }
+    const quint64 stringOffset = readLE<quint64>(m_data + kHeaderStringOffset);
+    m_stringSize = readLE<quint64>(m_data + kHeaderStringSize);
+    if (!fits(stringOffset, m_stringSize)) return fail(invalidFormat);
+    m_buckets = m_data + bucketOffset;
+    m_strings = m_data + stringOffset;
+
+    // バケット表の終端は、キー順の表の件数と一致していなければならない
+    if (readLE<quint32>(m_buckets + (quint64(1) << m_bucketBits) * 4) != m_recordCount[m_layout.keyedTable]) {
+        return fail(invalidFormat);
+    }
+    return true;
+}
+
+quint64 SortedKeyIndex::keyAt(quint32 index) const
+{
+    return readLE<quint64>(record(m_layout.keyedTable, index));
+}
+
+QPair<quint32, quint32> SortedKeyIndex::keyRange(quint64 key) const
+{
+    const quint32 count = m_recordCount[m_layout.keyedTable];
+    if (!m_data || count == 0) return {0, 0};
+
+    // キー上位ビットのバケットで範囲を絞り、その中を二分探索する
+    const quint64 bucket = bucketOf(key, m_bucketBits);
+    const quint32 bucketBegin = readLE<quint32>(m_buckets + bucket * 4);
+    const quint32 bucketEnd = qMin(readLE<quint32>(m_buckets + (bucket + 1) * 4), count);
+
+    quint32 lo = bucketBegin;
+    quint32 hi = bucketEnd;
+    while (lo < hi) {
+        const quint32 mid = lo + (hi - lo) / 2;
+        if (keyAt(mid) < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    const quint32 first = lo;
+    hi = bucketEnd;
+    while (lo < hi) {
+        const quint32 mid = lo + (hi - lo) / 2;
+        if (keyAt(mid) <= key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return {first, lo};
+}
+
+QByteArrayView SortedKeyIndex::poolBytes(quint32 offset) const
+{
+    if (offset == kNoString || quint64(offset) + 4 > m_stringSize) return {};
+    const quint32 length = readLE<quint32>(m_strings + offset);
+    if (length > m_stringSize - offset - 4) return {};
+    return QByteArrayView(reinterpret_cast<const char *>(m_strings + offset + 4), length);
+}
@@ -0,0 +1,81 @@
+/// @file sortedkeyindex.h
+/// @brief キー順に並べたレコードをバケット表で引く、メモリマップの索引ファイルの定義
+
+#ifndef SORTEDKEYINDEX_H
+#define SORTEDKEYINDEX_H
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QPair>
+#include <QString>
+
+#include "sortedkeyindexformat.h"
+
+/**
+ * @brief バイナリ定跡（.jbk）と棋譜データベース（.kdb）に共通のファイル本体の読み取り専用ビュー
+ *
+ * | 領域         | 内容                                                                |
+ * |--------------|---------------------------------------------------------------------|
+ * | ヘッダー     | マジック・版数・バケットのビット数・表ごとの件数・各領域のオフセット |
+ * | バケット表   | キー上位 bucketBits ビットごとの先頭レコード番号（2^bucketBits+1 個）|
+ * | 表0・表1     | 固定長レコード。どちらか一方は先頭8バイトのキーの昇順に並ぶ          |
+ * | 文字列プール | 長さ付き UTF-8 の文字列                                             |
+ *
+ * レコードの中身は形式ごとのクラス（JosekiBook・KifuDatabase）が解釈する。
+ * open() で範囲を検証したあとは、const メンバはマップ領域を読むだけなので複数スレッドから呼んでよい。
+ */
+class SortedKeyIndex
+{
+public:
+    using Layout = SortedKeyIndexFormat::Layout;
+
+    explicit SortedKeyIndex(const Layout &layout) : m_layout(layout) {}
+    Q_DISABLE_COPY_MOVE(SortedKeyIndex)
+
+    /// 先頭がマジックかどうか
+    static bool hasMagic(const QString &filePath, const char *magic);
+
+    /**
+     * @brief ファイルを読み取り専用でマップし、ヘッダーと各領域の範囲を検証する
+     * @param filePath ファイルパス
+     * @param errorMessage エラーメッセージ（エラー時に設定される）
+     * @return 形式が正しくマップできた場合 true
+     */
+    [[nodiscard]] bool open(const QString &filePath, QString *errorMessage = nullptr);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    QString filePath() const { return m_file.fileName(); }
+    qint64 fileSize() const { return m_size; }
+    /// マップ領域の先頭（ヘッダー）。開いていなければ nullptr
+    const uchar *data() const { return m_data; }
+
+    quint32 recordCount(int table) const { return m_recordCount[table]; }
+    /// 表のレコード（番号の範囲は呼び出し側で確かめる）
+    const uchar *record(int table, quint32 index) const
+    {
+        return m_tables[table] + quint64(index) * quint64(m_layout.recordSize[table]);
+    }
+    /// キー順の表のレコードのキー
+    quint64 keyAt(quint32 index) const;
+
+    /// キー順の表でのキーの範囲 [first, last)
+    QPair<quint32, quint32> keyRange(quint64 key) const;
+
+    /// 文字列プールの長さ付き UTF-8（範囲外なら空）
+    QByteArrayView poolBytes(quint32 offset) const;
+
+private:
+    const Layout m_layout;
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    quint32 m_bucketBits = 0;
+    quint32 m_recordCount[SortedKeyIndexFormat::kTableCount] = {};
+    const uchar *m_buckets = nullptr;
+    const uchar *m_tables[SortedKeyIndexFormat::kTableCount] = {};
+    const uchar *m_strings = nullptr;
+    quint64 m_stringSize = 0;
+};
+
+#endif // SORTEDKEYINDEX_H
@@ -0,0 +1,134 @@
+/// @file sortedkeyindexformat.h
+/// @brief キー順索引ファイル（バイナリ定跡・棋譜データベース）に共通のレイアウト定数と読み書きヘルパー
+
+#ifndef SORTEDKEYINDEXFORMAT_H
+#define SORTEDKEYINDEXFORMAT_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QtEndian>
+
+#include <cstddef>
+
+/// 数値はすべてリトルエンディアン。領域の並びは SortedKeyIndex のクラスコメントを参照
+namespace SortedKeyIndexFormat {
+
+inline constexpr quint32 kMaxBucketBits = 24;
+inline constexpr quint32 kNoString = 0xFFFFFFFFu;
+
+// ヘッダー（64バイト）内のオフセット。件数とオフセットは表ごとに並べて持つ
+inline constexpr qint64 kHeaderSize = 64;
+inline constexpr int kHeaderVersion = 8;
+inline constexpr int kHeaderBucketBits = 12;
+inline constexpr int kHeaderRecordCount = 16;  ///< quint32 × 表の数
+inline constexpr int kHeaderBucketOffset = 24;
+inline constexpr int kHeaderTableOffset = 32;  ///< quint64 × 表の数
+inline constexpr int kHeaderStringOffset = 48;
+inline constexpr int kHeaderStringSize = 56;
+inline constexpr int kTableCount = 2;
+
+inline constexpr qsizetype kWriteChunkSize = 1 << 20;
+
+/// ファイル形式ごとの違い（マジック・版数・表のレコード長・キー順に並んだ表）
+struct Layout {
+    const char *magic = nullptr;          ///< 先頭8バイト
+    quint32 version = 0;
+    qint64 recordSize[kTableCount] = {};  ///< 表ごとのレコード長
+    int keyedTable = 0;                   ///< 先頭8バイトのキーで昇順に並んだ表
+    const char *formatName = nullptr;     ///< エラーメッセージに出す形式名（UTF-8）
+};
+
+template <typename T>
+inline T readLE(const uchar *p)
+{
+    return qFromLittleEndian<T>(p);
+}
+
+template <typename T>
+inline void appendLE(QByteArray &out, T value)
+{
+    uchar buf[sizeof(T)];
+    qToLittleEndian(value, buf);
+    out.append(reinterpret_cast<const char *>(buf), sizeof(T));
+}
+
+inline quint64 bucketTableSize(quint32 bucketBits)
+{
+    return ((quint64(1) << bucketBits) + 1) * 4;
+}
+
+inline quint64 bucketOf(quint64 key, quint32 bucketBits)
+{
+    return bucketBits == 0 ? 0 : key >> (64 - bucketBits);
+}
+
+/// レコード数に見合うバケットのビット数（1バケットあたり1〜2件）
+inline quint32 bucketBitsFor(std::size_t recordCount)
+{
+    quint32 bucketBits = 0;
+    while (bucketBits < kMaxBucketBits && (quint64(1) << (bucketBits + 1)) <= recordCount) ++bucketBits;
+    return bucketBits;
+}
+
+/// キー昇順に並べたレコード列からバケット表を作る
+template <typename Records, typename KeyOf>
+QByteArray bucketTable(const Records &sorted, quint32 bucketBits, KeyOf keyOf)
+{
+    QByteArray buckets;
+    buckets.reserve(static_cast<qsizetype>(bucketTableSize(bucketBits)));
+    std::size_t next = 0;
+    for (quint64 bucket = 0; bucket <= (quint64(1) << bucketBits); ++bucket) {
+        while (next < sorted.size() && bucketOf(keyOf(sorted[next]), bucketBits) < bucket) ++next;
+        appendLE<quint32>(buckets, static_cast<quint32>(next));
+    }
+    return buckets;
+}
+
+/// 64ビットハッシュの仕上げ（splitmix64）。バケットに使う上位ビットを偏らせない
+inline quint64 mixKey(quint64 h)
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+/// 文字列プールに長さ付きで追加し、そのオフセットを返す
+inline quint32 appendPoolString(QByteArray &pool, QByteArrayView utf8)
+{
+    const auto offset = static_cast<quint32>(pool.size());
+    appendLE<quint32>(pool, static_cast<quint32>(utf8.size()));
+    pool.append(utf8);
+    return offset;
+}
+
+/**
+ * @brief ヘッダー（64バイト）を作る
+ *
+ * 領域はヘッダー・バケット表・表0・表1・文字列プールの順に隙間なく並べる前提で、
+ * オフセットは件数とレコード長から求める。
+ */
+inline QByteArray headerBytes(const Layout &layout, quint32 bucketBits, const quint32 (&recordCount)[kTableCount],
+                              quint64 stringSize)
+{
+    QByteArray header(layout.magic, 8);
+    appendLE<quint32>(header, layout.version);
+    appendLE<quint32>(header, bucketBits);
+    for (const quint32 count : recordCount) appendLE<quint32>(header, count);
+    quint64 offset = kHeaderSize;
+    appendLE<quint64>(header, offset);
+    offset += bucketTableSize(bucketBits);
+    for (int table = 0; table < kTableCount; ++table) {
+        appendLE<quint64>(header, offset);
+        offset += quint64(recordCount[table]) * quint64(layout.recordSize[table]);
+    }
+    appendLE<quint64>(header, offset);
+    appendLE<quint64>(header, stringSize);
+    return header;
+}
+
+} // namespace SortedKeyIndexFormat
+
+#endif // SORTEDKEYINDEXFORMAT_H
@@ -0,0 +1,262 @@
+/// @file usilogmodel.cpp
+/// @brief USI通信ログのリングバッファ付きリストモデルクラスの実装
+
+#include "usilogmodel.h"
+#include "rotatinglogfile.h"
+
+#include <QColor>
+
+UsiLogModel::UsiLogModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(kFlushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &UsiLogModel::flush);
+}
+
+UsiLogModel::~UsiLogModel() = default;
+
+// ============================================================
+// QAbstractListModel オーバーライド
+// ============================================================
+
+int UsiLogModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_visible.size());
+}
+
+QVariant UsiLogModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const Entry& entry = entryAt(m_visible[static_cast<size_t>(index.row())]);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return entry.text;
+    case Qt::ForegroundRole:
+        switch (entry.source) {
+        case Source::Engine1: return QColor(0x20, 0x60, 0xa0);
+        case Source::Engine2: return QColor(0xa0, 0x20, 0x60);
+        case Source::Status:  return QColor(0x80, 0x80, 0x80);
+        }
+        break;
+    case SourceRole:
+        return static_cast<int>(entry.source);
+    default:
+        break;
+    }
+    return QVariant();
+}
+
+// ============================================================
+// ログ操作
+// ============================================================
+
+void UsiLogModel::append(Source source, const QString& line)
+{
+    if (line.isEmpty()) return;
+
+    m_pending.append({Entry{line, source}, QTime::currentTime()});
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void UsiLogModel::flush()
+{
+    m_flushTimer.stop();
+    if (m_pending.isEmpty()) return;
+
+    QList<PendingLine> pending;
+    pending.swap(m_pending);
+
+    // ファイルには捨てる行も含めて全て書く
+    writeSpill(pending);
+
+    // 1回で上限を超える分は表示されないまま捨てる
+    const qsizetype skip = qMax<qsizetype>(0, pending.size() - m_capacity);
+    const qint64 newNext = m_nextSeq + (pending.size() - skip);
+    const qint64 newFirst = qMax(m_firstSeq, newNext - m_capacity);
+    m_dropped += skip + (newFirst - m_firstSeq);
+
+    // 1. あふれる古い行を先頭からまとめて外す
+    size_t removeCount = 0;
+    while (removeCount < m_visible.size() && m_visible[removeCount] < newFirst) {
+        ++removeCount;
+    }
+    if (removeCount > 0) {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(removeCount) - 1);
+        m_visible.erase(m_visible.begin(), m_visible.begin() + static_cast<std::ptrdiff_t>(removeCount));
+        endRemoveRows();
+    }
+    m_firstSeq = newFirst;
+
+    // 2. 新しい行をリングに書く（上書きされるのは外し終えた行の枠だけ）
+    const qint64 firstNewSeq = m_nextSeq;
+    int accepted = 0;
+    for (qsizetype i = skip; i < pending.size(); ++i) {
+        Entry& entry = pending[i].entry;
+        if (accepts(entry.source)) ++accepted;
+
+        const size_t slot = static_cast<size_t>(m_nextSeq % m_capacity);
+        if (slot == m_ring.size()) {
+            m_ring.push_back(std::move(entry));
+        } else {
+            m_ring[slot] = std::move(entry);
+        }
+        ++m_nextSeq;
+    }
+
+    // 3. 表示対象の行を1回の挿入で追加する
+    if (accepted > 0) {
+        const int firstRow = rowCount();
+        beginInsertRows(QModelIndex(), firstRow, firstRow + accepted - 1);
+        for (qint64 seq = firstNewSeq; seq < m_nextSeq; ++seq) {
+            if (accepts(entryAt(seq).source)) m_visible.push_back(seq);
+        }
+        endInsertRows();
+    }
+
+    emit linesAppended();
+}
+
+void UsiLogModel::clear()
+{
+    m_flushTimer.stop();
+    m_pending.clear();
+
+    beginResetModel();
+    m_ring.clear();
+    m_visible.clear();
+    m_firstSeq = 0;
+    m_nextSeq = 0;
+    m_dropped = 0;
+    endResetModel();
+}
+
+int UsiLogModel::capacity() const
+{
+    return m_capacity;
+}
+
+void UsiLogModel::setCapacity(int capacity)
+{
+    capacity = qMax(1, capacity);
+    if (capacity == m_capacity) return;
+
+    flush();
+
+    // 新しい上限に収まる最新の行だけを詰め直す
+    const qint64 stored = m_nextSeq - m_firstSeq;
+    const qint64 keep = qMin<qint64>(stored, capacity);
+
+    std::vector<Entry> ring;
+    ring.reserve(static_cast<size_t>(keep));
+    for (qint64 seq = m_nextSeq - keep; seq < m_nextSeq; ++seq) {
+        ring.push_back(entryAt(seq));
+    }
+
+    beginResetModel();
+    m_dropped += stored - keep;
+    m_ring = std::move(ring);
+    m_capacity = capacity;
+    m_firstSeq = 0;
+    m_nextSeq = keep;
+    rebuildVisible();
+    endResetModel();
+}
+
+UsiLogModel::Filter UsiLogModel::filter() const
+{
+    return m_filter;
+}
+
+void UsiLogModel::setFilter(Filter filter)
+{
+    if (filter == m_filter) return;
+
+    flush();
+
+    beginResetModel();
+    m_filter = filter;
+    rebuildVisible();
+    endResetModel();
+}
+
+int UsiLogModel::storedLineCount() const
+{
+    return static_cast<int>(m_nextSeq - m_firstSeq);
+}
+
+qint64 UsiLogModel::droppedLineCount() const
+{
+    return m_dropped;
+}
+
+// ============================================================
+// ファイル書き出し
+// ============================================================
+
+bool UsiLogModel::setSpillFile(const QString& filePath)
+{
+    if (filePath.isEmpty()) {
+        m_spill.reset();
+        return true;
+    }
+    if (m_spill && m_spill->filePath() == filePath) return true;
+
+    auto file = std::make_unique<RotatingLogFile>(filePath);
+    if (!file->open()) return false;
+    m_spill = std::move(file);
+    return true;
+}
+
+QString UsiLogModel::spillFilePath() const
+{
+    return m_spill ? m_spill->filePath() : QString();
+}
+
+void UsiLogModel::writeSpill(const QList<PendingLine>& lines)
+{
+    if (!m_spill) return;
+
+    // 1回のフラッシュ分を1回の write にまとめる
+    QByteArray data;
+    for (const PendingLine& line : lines) {
+        data += line.time.toString(QStringLiteral("HH:mm:ss.zzz ")).toUtf8();
+        data += line.entry.text.toUtf8();
+        data += '\n';
+    }
+    m_spill->append(data);
+}
+
+// ============================================================
+// 内部
+// ============================================================
+
+bool UsiLogModel::accepts(Source source) const
+{
+    switch (m_filter) {
+    case Filter::Engine1: return source != Source::Engine2;
+    case Filter::Engine2: return source != Source::Engine1;
+    case Filter::All:     break;
+    }
+    return true;
+}
+
+const UsiLogModel::Entry& UsiLogModel::entryAt(qint64 seq) const
+{
+    return m_ring[static_cast<size_t>(seq % m_capacity)];
+}
+
+void UsiLogModel::rebuildVisible()
+{
+    m_visible.clear();
+    for (qint64 seq = m_firstSeq; seq < m_nextSeq; ++seq) {
+        if (accepts(entryAt(seq).source)) m_visible.push_back(seq);
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef USILOGMODEL_H
+#define USILOGMODEL_H
+
+/// @file usilogmodel.h
+/// @brief USI通信ログのリングバッファ付きリストモデルクラスの定義
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QTime>
+#include <QTimer>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class RotatingLogFile;
+
+/**
+ * @brief USI通信ログを上限付きで保持し、QListView に表示するためのモデル
+ *
+ * 行は capacity() 行のリングバッファに保持し、あふれた古い行から捨てる。
+ * append() は行を保留に積むだけで、モデルへの反映は kFlushIntervalMs ごとに
+ * まとめて1回の beginInsertRows() で行う（1行ごとに再描画しない）。
+ * エンジン別の絞り込みと、全行のローテーション付きファイルへの書き出しに対応する。
+ */
+class UsiLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /// 行の出どころ
+    enum class Source : quint8 {
+        Engine1,    ///< エンジン1の送受信
+        Engine2,    ///< エンジン2の送受信
+        Status      ///< GUIからのステータス表示（絞り込みに関係なく常に表示）
+    };
+
+    /// 表示するエンジンの絞り込み
+    enum class Filter : quint8 {
+        All,        ///< 全て
+        Engine1,    ///< エンジン1のみ
+        Engine2     ///< エンジン2のみ
+    };
+
+    /// カスタムロール
+    enum Roles {
+        SourceRole = Qt::UserRole + 1   ///< Source を int で返す
+    };
+
+    /// 既定の保持行数
+    static constexpr int kDefaultCapacity = 100000;
+    /// 保留行をモデルへ反映する間隔（約30fps）
+    static constexpr int kFlushIntervalMs = 33;
+
+    explicit UsiLogModel(QObject* parent = nullptr);
+    ~UsiLogModel() override;
+
+    // --- QAbstractListModel オーバーライド ---
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    // --- ログ操作 API ---
+
+    /// 1行を保留に積む（反映は次のフラッシュで行う）
+    void append(Source source, const QString& line);
+
+    /// 全行を消し、捨てた行数の累計も0に戻す（ファイルへの書き出し済み分はそのまま）
+    void clear();
+
+    /// 保持行数の上限（1未満は1に丸める）
+    int capacity() const;
+    void setCapacity(int capacity);
+
+    /// エンジン別の絞り込み
+    Filter filter() const;
+    void setFilter(Filter filter);
+
+    /// 保持している行数（絞り込み前）
+    int storedLineCount() const;
+
+    /// 上限を超えて捨てた行数の累計（clear() まで）
+    qint64 droppedLineCount() const;
+
+    /// 全行をローテーション付きファイルへ書き出す（空文字で停止）。開けなければ false
+    bool setSpillFile(const QString& filePath);
+    QString spillFilePath() const;
+
+public slots:
+    /// 保留中の行をまとめて反映する（タイマーから呼ばれる。すぐ反映したい時にも呼べる）
+    void flush();
+
+signals:
+    /// 保留行をまとめて反映した（→ UsiLogPanel の末尾追従）
+    void linesAppended();
+
+private:
+    struct Entry {
+        QString text;
+        Source source = Source::Status;
+    };
+
+    struct PendingLine {
+        Entry entry;
+        QTime time;     ///< ファイル書き出し用の受信時刻
+    };
+
+    bool accepts(Source source) const;
+    const Entry& entryAt(qint64 seq) const;
+    void writeSpill(const QList<PendingLine>& lines);
+    void rebuildVisible();
+
+    int m_capacity = kDefaultCapacity;
+    std::vector<Entry> m_ring;          ///< 通し番号 seq の行は m_ring[seq % m_capacity]（満杯まで伸ばす）
+    qint64 m_firstSeq = 0;              ///< 保持している最古の行の通し番号
+    qint64 m_nextSeq = 0;               ///< 次に追加する行の通し番号
+    std::deque<qint64> m_visible;       ///< 表示行 → 通し番号（絞り込み後）
+    Filter m_filter = Filter::All;
+
+    QList<PendingLine> m_pending;       ///< 未反映の行
+    QTimer m_flushTimer;                ///< 反映間隔のタイマー
+    qint64 m_dropped = 0;
+
+    std::unique_ptr<RotatingLogFile> m_spill; ///< 全行の書き出し先（無効時は nullptr）
+};
+
+#endif // USILOGMODEL_H
@@ -91,34 +91,23 @@ void KifuNavigationController::goToLast()
         return;
     }
 
-    // 優先ラインのパスを取得（allLines() に基づく高速ルックアップ用）
-    QSet<KifuBranchNode*> linePathNodes;
+    // 優先ライン（ツリーのライン範囲で所属を O(1) 判定する）
+    int lineIdx = -1;
     if (m_tree != nullptr) {
-        int lineIdx = m_state->preferredLineIndex();
+        lineIdx = m_state->preferredLineIndex();
         if (lineIdx < 0) lineIdx = m_state->currentLineIndex();
-        if (lineIdx >= 0) {
-            QList<BranchLine> lines = m_tree->allLines();
-            if (lineIdx < lines.size()) {
-                for (KifuBranchNode* n : std::as_const(lines.at(lineIdx).nodes)) {
-                    linePathNodes.insert(n);
-                }
-            }
-        }
     }
 
     // 現在のラインの終端まで進む
     while (node->childCount() > 0) {
         KifuBranchNode* nextNode = nullptr;
 
-        // 優先ラインのパスに合致する子を探す
-        if (!linePathNodes.isEmpty() && node->childCount() > 1) {
-            for (int i = 0; i < node->childCount(); ++i) {
-                if (linePathNodes.contains(node->childAt(i))) {
-                    nextNode = node->childAt(i);
-                    qCDebug(lcNavigation).noquote() << "goToLast: at ply=" << node->ply()
-                                                    << "using allLines path childIndex=" << i;
-                    break;
-                }
+        // 優先ラインに含まれる子を探す
+        if (lineIdx >= 0 && node->childCount() > 1) {
+            nextNode = m_tree->childOnLine(node, lineIdx);
+            if (nextNode != nullptr) {
+                qCDebug(lcNavigation).noquote() << "goToLast: at ply=" << node->ply()
+                                                << "using line" << lineIdx << "childPly=" << nextNode->ply();
             }
         }
 
@@ -228,21 +217,14 @@ KifuBranchNode* KifuNavigationController::findForwardNode() const
         int lineIdx = m_state->preferredLineIndex();
         if (lineIdx < 0) lineIdx = m_state->currentLineIndex();
         if (lineIdx >= 0) {
-            QList<BranchLine> lines = m_tree->allLines();
-            if (lineIdx < lines.size()) {
-                const BranchLine& line = lines.at(lineIdx);
-                const int nextPly = current->ply() + 1;
-                for (KifuBranchNode* node : std::as_const(line.nodes)) {
-                    if (node->ply() == nextPly && node->parent() == current) {
-                        qCDebug(lcNavigation).noquote() << "findForwardNode: using allLines path"
-                                                        << "lineIdx=" << lineIdx
-                                                        << "childPly=" << node->ply()
-                                                        << "childDisplayText=" << node->displayText();
-                        return node;
-                    }
-                }
-                qCDebug(lcNavigation).noquote() << "findForwardNode: allLines path did not find child on line" << lineIdx;
+            if (KifuBranchNode* node = m_tree->childOnLine(current, lineIdx)) {
+                qCDebug(lcNavigation).noquote() << "findForwardNode: using allLines path"
+                                                << "lineIdx=" << lineIdx
+                                                << "childPly=" << node->ply()
+                                                << "childDisplayText=" << node->displayText();
+                return node;
             }
+            qCDebug(lcNavigation).noquote() << "findForwardNode: allLines path did not find child on line" << lineIdx;
         }
     }
 
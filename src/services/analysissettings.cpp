@@ -134,6 +134,54 @@ void setUsiLogFontSize(int size)
     s.setValue(SettingsKeys::kFontSizeUsiLog, size);
 }
 
+int usiLogMaxLines()
+{
+    QSettings& s = SettingsCommon::openSettings();
+    return s.value(SettingsKeys::kUsiLogMaxLines, 100000).toInt();
+}
+
+void setUsiLogMaxLines(int lines)
+{
+    QSettings& s = SettingsCommon::openSettings();
+    s.setValue(SettingsKeys::kUsiLogMaxLines, lines);
+}
+
+bool usiLogSpillToFile()
+{
+    QSettings& s = SettingsCommon::openSettings();
+    return s.value(SettingsKeys::kUsiLogSpillToFile, false).toBool();
+}
+
+void setUsiLogSpillToFile(bool enabled)
+{
+    QSettings& s = SettingsCommon::openSettings();
+    s.setValue(SettingsKeys::kUsiLogSpillToFile, enabled);
+}
+
+int enginePoolIdlePerEngine()
+{
+    QSettings& s = SettingsCommon::openSettings();
+    return s.value(SettingsKeys::kEnginePoolIdlePerEngine, 1).toInt();
+}
+
+void setEnginePoolIdlePerEngine(int count)
+{
+    QSettings& s = SettingsCommon::openSettings();
+    s.setValue(SettingsKeys::kEnginePoolIdlePerEngine, count);
+}
+
+int enginePoolIdleTimeoutSec()
+{
+    QSettings& s = SettingsCommon::openSettings();
+    return s.value(SettingsKeys::kEnginePoolIdleTimeoutSec, 600).toInt();
+}
+
+void setEnginePoolIdleTimeoutSec(int sec)
+{
+    QSettings& s = SettingsCommon::openSettings();
+    s.setValue(SettingsKeys::kEnginePoolIdleTimeoutSec, sec);
+}
+
 int thinkingFontSize()
 {
     QSettings& s = SettingsCommon::openSettings();
@@ -318,6 +366,20 @@ void setConsiderationFontSize(int size)
     s.setValue(SettingsKeys::kConsiderationTabFontSize, size);
 }
 
+// --- 詰み探索 ---
+
+bool tsumeSearchBuiltinSolver()
+{
+    QSettings& s = SettingsCommon::openSettings();
+    return s.value(SettingsKeys::kTsumeSearchBuiltinSolver, false).toBool();
+}
+
+void setTsumeSearchBuiltinSolver(bool builtin)
+{
+    QSettings& s = SettingsCommon::openSettings();
+    s.setValue(SettingsKeys::kTsumeSearchBuiltinSolver, builtin);
+}
+
 // --- 読み筋盤面 ---
 
 QSize pvBoardDialogSize()
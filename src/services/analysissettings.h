@@ -46,6 +46,22 @@ void setThinkingViewColumnWidths(int viewIndex, const QList<int>& widths);
 int usiLogFontSize();
 void setUsiLogFontSize(int size);
 
+/// USI通信ログの保持行数の上限（デフォルト: 100000）
+int usiLogMaxLines();
+void setUsiLogMaxLines(int lines);
+
+/// USI通信ログをローテーション付きファイルにも書き出すか（デフォルト: false）
+bool usiLogSpillToFile();
+void setUsiLogSpillToFile(bool enabled);
+
+/// 使い終わったエンジンを待機状態で残す数（エンジン構成ごと、0で無効。デフォルト: 1）
+int enginePoolIdlePerEngine();
+void setEnginePoolIdlePerEngine(int count);
+
+/// 待機中のエンジンを終了させるまでの秒数（デフォルト: 600）
+int enginePoolIdleTimeoutSec();
+void setEnginePoolIdleTimeoutSec(int sec);
+
 /// 思考タブのフォントサイズ（デフォルト: 10）
 int thinkingFontSize();
 void setThinkingFontSize(int size);
@@ -110,6 +126,13 @@ void setConsiderationMultiPV(int multiPV);
 int considerationFontSize();
 void setConsiderationFontSize(int size);
 
+// --- 詰み探索 ---
+
+/// 詰み探索ダイアログで内蔵ソルバーを選んだか（デフォルト: false）。
+/// エンジン番号は検討ダイアログと共有するため、エンジン一覧の外にある内蔵ソルバーは別に持つ
+bool tsumeSearchBuiltinSolver();
+void setTsumeSearchBuiltinSolver(bool builtin);
+
 // --- 読み筋盤面 ---
 
 /// 読み筋表示ウィンドウのサイズ（デフォルト: 620x720）
@@ -212,6 +212,44 @@ void setSfenCollectionLastDirectory(const QString& dir)
     s.setValue(SettingsKeys::kSfenCollectionLastDirectory, dir);
 }
 
+// --- 棋譜データベース ---
+
+QSize kifuDatabaseDialogSize()
+{
+    QSettings& s = SettingsCommon::openSettings();
+    return s.value(SettingsKeys::kKifuDatabaseDialogSize, QSize(760, 560)).toSize();
+}
+
+void setKifuDatabaseDialogSize(const QSize& size)
+{
+    QSettings& s = SettingsCommon::openSettings();
+    s.setValue(SettingsKeys::kKifuDatabaseDialogSize, size);
+}
+
+QString kifuDatabasePath()
+{
+    QSettings& s = SettingsCommon::openSettings();
+    return s.value(SettingsKeys::kKifuDatabasePath, QString()).toString();
+}
+
+void setKifuDatabasePath(const QString& path)
+{
+    QSettings& s = SettingsCommon::openSettings();
+    s.setValue(SettingsKeys::kKifuDatabasePath, path);
+}
+
+QString kifuDatabaseSourceDirectory()
+{
+    QSettings& s = SettingsCommon::openSettings();
+    return s.value(SettingsKeys::kKifuDatabaseSourceDirectory, QString()).toString();
+}
+
+void setKifuDatabaseSourceDirectory(const QString& dir)
+{
+    QSettings& s = SettingsCommon::openSettings();
+    s.setValue(SettingsKeys::kKifuDatabaseSourceDirectory, dir);
+}
+
 // --- 持将棋 ---
 
 int jishogiScoreFontSize()
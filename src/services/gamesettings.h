@@ -91,6 +91,20 @@ void setSfenCollectionSquareSize(int size);
 QString sfenCollectionLastDirectory();
 void setSfenCollectionLastDirectory(const QString& dir);
 
+// --- 棋譜データベース ---
+
+/// 棋譜データベースダイアログのサイズ（デフォルト: 760x560）
+QSize kifuDatabaseDialogSize();
+void setKifuDatabaseDialogSize(const QSize& size);
+
+/// 最後に開いた棋譜データベースファイル
+QString kifuDatabasePath();
+void setKifuDatabasePath(const QString& path);
+
+/// 棋譜データベースを作成した棋譜フォルダ
+QString kifuDatabaseSourceDirectory();
+void setKifuDatabaseSourceDirectory(const QString& dir);
+
 // --- 持将棋 ---
 
 /// 持将棋の点数ダイアログのフォントサイズ（デフォルト: 10）
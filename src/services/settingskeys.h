@@ -14,6 +14,7 @@ inline constexpr char kMainWindowSize[]                  = "SizeRelated/mainWind
 inline constexpr char kSquareSize[]                      = "SizeRelated/squareSize";
 inline constexpr char kPvBoardDialogSize[]               = "SizeRelated/pvBoardDialogSize";
 inline constexpr char kSfenCollectionDialogSize[]        = "SizeRelated/sfenCollectionDialogSize";
+inline constexpr char kKifuDatabaseDialogSize[]          = "SizeRelated/kifuDatabaseDialogSize";
 inline constexpr char kStartGameDialogSize[]             = "SizeRelated/startGameDialogSize";
 inline constexpr char kKifuPasteDialogSize[]             = "SizeRelated/kifuPasteDialogSize";
 inline constexpr char kCsaLogWindowSize[]                = "SizeRelated/csaLogWindowSize";
@@ -54,6 +55,10 @@ inline constexpr char kSfenCollectionRecentFiles[]       = "SfenCollection/recen
 inline constexpr char kSfenCollectionSquareSize[]        = "SfenCollection/squareSize";
 inline constexpr char kSfenCollectionLastDirectory[]     = "SfenCollection/lastDirectory";
 
+// --- KifuDatabase ---
+inline constexpr char kKifuDatabasePath[]                = "KifuDatabase/databasePath";
+inline constexpr char kKifuDatabaseSourceDirectory[]     = "KifuDatabase/sourceDirectory";
+
 // --- EvalChart ---
 inline constexpr char kEvalChartYLimit[]                 = "EvalChart/yLimit";
 inline constexpr char kEvalChartXLimit[]                 = "EvalChart/xLimit";
@@ -78,6 +83,14 @@ inline constexpr char kKifuAnalysisFullRange[]           = "KifuAnalysis/fullRan
 inline constexpr char kKifuAnalysisStartPly[]            = "KifuAnalysis/startPly";
 inline constexpr char kKifuAnalysisEndPly[]              = "KifuAnalysis/endPly";
 
+// --- UsiLog ---
+inline constexpr char kUsiLogMaxLines[]                  = "UsiLog/maxLines";
+inline constexpr char kUsiLogSpillToFile[]               = "UsiLog/spillToFile";
+
+// --- EnginePool ---
+inline constexpr char kEnginePoolIdlePerEngine[]         = "EnginePool/idlePerEngine";
+inline constexpr char kEnginePoolIdleTimeoutSec[]        = "EnginePool/idleTimeoutSec";
+
 // --- JosekiWindow ---
 inline constexpr char kJosekiWindowFontSize[]            = "JosekiWindow/fontSize";
 inline constexpr char kJosekiWindowSfenFontSize[]        = "JosekiWindow/sfenFontSize";
@@ -113,6 +126,9 @@ inline constexpr char kConsiderationUnlimitedTime[]      = "Consideration/unlimi
 inline constexpr char kConsiderationByoyomiSec[]         = "Consideration/byoyomiSec";
 inline constexpr char kConsiderationMultiPV[]            = "Consideration/multiPV";
 
+// --- TsumeSearch ---
+inline constexpr char kTsumeSearchBuiltinSolver[]        = "TsumeSearch/builtinSolver";
+
 // --- ConsiderationTab ---
 inline constexpr char kConsiderationTabFontSize[]        = "ConsiderationTab/fontSize";
 
@@ -175,6 +191,7 @@ inline constexpr char kTsumeshogiGeneratorMaxDefendPieces[]   = "TsumeshogiGener
 inline constexpr char kTsumeshogiGeneratorAttackRange[]       = "TsumeshogiGenerator/attackRange";
 inline constexpr char kTsumeshogiGeneratorTimeoutSec[]        = "TsumeshogiGenerator/timeoutSec";
 inline constexpr char kTsumeshogiGeneratorMaxPositions[]      = "TsumeshogiGenerator/maxPositions";
+inline constexpr char kTsumeshogiGeneratorWorkerCount[]       = "TsumeshogiGenerator/workerCount";
 
 // --- Settings version ---
 inline constexpr int kCurrentSettingsVersion = 1;
@@ -128,4 +128,16 @@ void setTsumeshogiGeneratorMaxPositions(int count)
     s.setValue(SettingsKeys::kTsumeshogiGeneratorMaxPositions, count);
 }
 
+int tsumeshogiGeneratorWorkerCount()
+{
+    QSettings& s = SettingsCommon::openSettings();
+    return s.value(SettingsKeys::kTsumeshogiGeneratorWorkerCount, 1).toInt();
+}
+
+void setTsumeshogiGeneratorWorkerCount(int count)
+{
+    QSettings& s = SettingsCommon::openSettings();
+    s.setValue(SettingsKeys::kTsumeshogiGeneratorWorkerCount, count);
+}
+
 } // namespace TsumeshogiSettings
@@ -52,6 +52,10 @@ void setTsumeshogiGeneratorTimeoutSec(int sec);
 int tsumeshogiGeneratorMaxPositions();
 void setTsumeshogiGeneratorMaxPositions(int count);
 
+/// 内蔵ソルバの並列数（デフォルト: 1）
+int tsumeshogiGeneratorWorkerCount();
+void setTsumeshogiGeneratorWorkerCount(int count);
+
 } // namespace TsumeshogiSettings
 
 #endif // TSUMESHOGISETTINGS_H
@@ -0,0 +1,99 @@
+/// @file convertmain.cpp
+/// @brief 棋譜形式の一括変換ツール shogiboardq-convert のエントリーポイント
+///
+/// 使い方の例:
+///   shogiboardq-convert --to csa -o out/ -r archive/
+///   shogiboardq-convert --to usi -o - "floodgate/2024*.csa" > games.usi
+
+#include "kifubatchconverter.h"
+#include "kifuformatconverter.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QTextStream>
+
+#include <cstdio>
+
+namespace {
+
+/// 使い方の誤り
+constexpr int kExitUsage = 2;
+/// 一部のファイルの変換に失敗した
+constexpr int kExitFailed = 1;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("shogiboardq-convert"));
+    QCoreApplication::setApplicationVersion(QStringLiteral(APP_VERSION));
+
+    const QString formats = KifuFormatConverter::outputSuffixes().join(QStringLiteral(", "));
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        QStringLiteral("棋譜ファイルを別の形式へ一括変換します（出力は ShogiBoardQ の保存と同じ）。"));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption toOption({QStringLiteral("t"), QStringLiteral("to")},
+                                      QStringLiteral("出力形式（%1）").arg(formats), QStringLiteral("format"));
+    const QCommandLineOption outputOption(
+        {QStringLiteral("o"), QStringLiteral("output")},
+        QStringLiteral("出力先フォルダ（省略時は入力と同じフォルダ、\"-\" で標準出力）"), QStringLiteral("dir"));
+    const QCommandLineOption recursiveOption({QStringLiteral("r"), QStringLiteral("recursive")},
+                                             QStringLiteral("サブフォルダの棋譜も変換する"));
+    const QCommandLineOption overwriteOption(QStringLiteral("overwrite"),
+                                             QStringLiteral("既存の出力ファイルを上書きする"));
+    const QCommandLineOption jobsOption({QStringLiteral("j"), QStringLiteral("jobs")},
+                                        QStringLiteral("並列数（既定はCPUのスレッド数）"), QStringLiteral("n"));
+    const QCommandLineOption verboseOption({QStringLiteral("v"), QStringLiteral("verbose")},
+                                           QStringLiteral("ファイルごとの結果と解析ログを出す"));
+    parser.addOptions({toOption, outputOption, recursiveOption, overwriteOption, jobsOption, verboseOption});
+    parser.addPositionalArgument(QStringLiteral("inputs"),
+                                 QStringLiteral("棋譜ファイル・フォルダ・ワイルドカード"),
+                                 QStringLiteral("<input>..."));
+    parser.process(app);
+
+    QTextStream data(stdout);
+    QTextStream log(stderr);
+
+    KifuBatchConverter::Options options;
+    options.inputs = parser.positionalArguments();
+    options.outputSuffix = parser.value(toOption);
+    options.outputDir = parser.value(outputOption);
+    options.recursive = parser.isSet(recursiveOption);
+    options.overwrite = parser.isSet(overwriteOption);
+    options.verbose = parser.isSet(verboseOption);
+
+    bool jobsOk = true;
+    if (parser.isSet(jobsOption)) {
+        options.jobs = parser.value(jobsOption).toInt(&jobsOk);
+    }
+    if (options.inputs.isEmpty() || !KifuFormatConverter::isOutputSuffix(options.outputSuffix)
+        || !jobsOk || options.jobs < 0) {
+        log << QStringLiteral("入力と出力形式（--to %1）を指定してください。").arg(formats) << Qt::endl;
+        log << parser.helpText();
+        return kExitUsage;
+    }
+
+    // 解析中の警告は棋譜ごとに大量に出るので、--verbose のときだけ出す
+    if (!options.verbose) {
+        QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false\n*.info=false\n*.warning=false"));
+    }
+
+    KifuBatchConverter converter(options, data, log);
+    const KifuBatchConverter::Stats stats = converter.run();
+    for (const QString &input : converter.unmatchedInputs()) {
+        log << QStringLiteral("棋譜ファイルが見つかりません: ") << input << Qt::endl;
+    }
+    log << QStringLiteral("変換 %1 件 / スキップ %2 件 / 失敗 %3 件（%4 秒, %5 件/秒）")
+               .arg(stats.converted)
+               .arg(stats.skipped)
+               .arg(stats.failed)
+               .arg(stats.elapsedMs / 1000.0, 0, 'f', 2)
+               .arg(stats.filesPerSecond(), 0, 'f', 1)
+        << Qt::endl;
+
+    return (stats.failed > 0 || !converter.unmatchedInputs().isEmpty()) ? kExitFailed : 0;
+}
@@ -0,0 +1,167 @@
+/// @file kifubatchconverter.cpp
+/// @brief 棋譜フォルダの一括形式変換の実装
+
+#include "kifubatchconverter.h"
+#include "kifucorpusfiles.h"
+#include "kifuformatconverter.h"
+
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+
+#include <atomic>
+
+namespace {
+
+/// 進捗表示の間隔（ミリ秒）
+constexpr qint64 kProgressIntervalMs = 1000;
+
+} // namespace
+
+double KifuBatchConverter::Stats::filesPerSecond() const
+{
+    const qsizetype processed = converted + skipped + failed;
+    return elapsedMs > 0 ? processed * 1000.0 / elapsedMs : 0.0;
+}
+
+KifuBatchConverter::KifuBatchConverter(const Options &options, QTextStream &data, QTextStream &log)
+    : m_options(options)
+    , m_data(data)
+    , m_log(log)
+{
+    m_options.outputSuffix = m_options.outputSuffix.toLower();
+}
+
+bool KifuBatchConverter::writesToStdout() const
+{
+    return m_options.outputDir == QLatin1String("-");
+}
+
+QString KifuBatchConverter::outputPathFor(const QString &inputPath, const QDir &base) const
+{
+    const QFileInfo info(inputPath);
+    const QString name = info.completeBaseName() + QLatin1Char('.') + m_options.outputSuffix;
+    if (m_options.outputDir.isEmpty()) return info.dir().filePath(name);
+
+    // フォルダ指定の入力は、出力先にも同じサブフォルダ構成で書く
+    const QString relativeDir = base.relativeFilePath(info.absolutePath());
+    return QDir::cleanPath(m_options.outputDir + QLatin1Char('/') + relativeDir + QLatin1Char('/') + name);
+}
+
+QList<KifuBatchConverter::Job> KifuBatchConverter::collectJobs()
+{
+    QList<Job> jobs;
+    m_unmatchedInputs.clear();
+    for (const QString &input : std::as_const(m_options.inputs)) {
+        const QStringList files = KifuCorpusFiles::collectFiles(input, m_options.recursive);
+        if (files.isEmpty()) {
+            m_unmatchedInputs.append(input);
+            continue;
+        }
+        const QFileInfo info(input);
+        const QDir base(info.isDir() ? info.absoluteFilePath() : info.absolutePath());
+        jobs.reserve(jobs.size() + files.size());
+        for (const QString &file : files) {
+            jobs.append({file, writesToStdout() ? QString() : outputPathFor(file, base)});
+        }
+    }
+    return jobs;
+}
+
+KifuBatchConverter::Outcome KifuBatchConverter::convertJob(const Job &job, QString &message)
+{
+    if (!writesToStdout()) {
+        if (QFileInfo(job.outputPath).absoluteFilePath() == QFileInfo(job.inputPath).absoluteFilePath()) {
+            message = QStringLiteral("入力と出力が同じファイルです");
+            return Outcome::Failed;
+        }
+        if (!m_options.overwrite && QFileInfo::exists(job.outputPath)) {
+            return Outcome::Skipped;
+        }
+    }
+
+    QStringList lines;
+    if (!KifuFormatConverter::convertFile(job.inputPath, m_options.outputSuffix, lines, &message)) {
+        return Outcome::Failed;
+    }
+
+    if (writesToStdout()) {
+        const QMutexLocker locker(&m_dataMutex);
+        for (const QString &line : std::as_const(lines)) {
+            m_data << line << QLatin1Char('\n');
+        }
+        m_data.flush();
+        return Outcome::Converted;
+    }
+    return KifuFormatConverter::writeFile(job.outputPath, lines, &message) ? Outcome::Converted
+                                                                            : Outcome::Failed;
+}
+
+void KifuBatchConverter::reportJob(const Job &job, Outcome outcome, const QString &message)
+{
+    const QMutexLocker locker(&m_reportMutex);
+    switch (outcome) {
+    case Outcome::Converted:
+        ++m_stats.converted;
+        if (m_options.verbose && !writesToStdout()) {
+            m_log << job.inputPath << " -> " << job.outputPath << Qt::endl;
+        }
+        break;
+    case Outcome::Skipped:
+        ++m_stats.skipped;
+        if (m_options.verbose) {
+            m_log << QStringLiteral("スキップ（出力が既にあります）: ") << job.outputPath << Qt::endl;
+        }
+        break;
+    case Outcome::Failed:
+        ++m_stats.failed;
+        m_log << QStringLiteral("失敗: ") << job.inputPath;
+        if (!message.isEmpty()) m_log << QStringLiteral(": ") << message;
+        m_log << Qt::endl;
+        break;
+    }
+
+    // 大量のファイルでも動いていることが分かるよう、一定間隔で処理速度を出す
+    const qint64 now = m_timer.elapsed();
+    if (!m_options.verbose && now - m_lastProgressMs >= kProgressIntervalMs) {
+        m_lastProgressMs = now;
+        const qsizetype processed = m_stats.converted + m_stats.skipped + m_stats.failed;
+        m_log << QStringLiteral("%1 / %2 件 (%3 件/秒)")
+                     .arg(processed)
+                     .arg(m_stats.total)
+                     .arg(processed * 1000.0 / qMax<qint64>(now, 1), 0, 'f', 1)
+              << Qt::endl;
+    }
+}
+
+KifuBatchConverter::Stats KifuBatchConverter::run()
+{
+    m_timer.start();
+    m_lastProgressMs = 0;
+    m_stats = Stats{};
+
+    const QList<Job> jobs = collectJobs();
+    m_stats.total = jobs.size();
+
+    // スレッドごとに共有の添字から次のファイルを取る（ジョブをまとめてキューに積まない）
+    const int threads = m_options.jobs > 0 ? m_options.jobs : qMax(1, QThread::idealThreadCount());
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    std::atomic<qsizetype> next{0};
+    const auto worker = [this, &jobs, &next]() {
+        for (qsizetype i = next++; i < jobs.size(); i = next++) {
+            QString message;
+            const Outcome outcome = convertJob(jobs.at(i), message);
+            reportJob(jobs.at(i), outcome, message);
+        }
+    };
+    for (int i = 0; i < qMin<qsizetype>(threads, jobs.size()); ++i) {
+        pool.start(worker);
+    }
+    pool.waitForDone();
+
+    m_stats.elapsedMs = m_timer.elapsed();
+    return m_stats;
+}
@@ -0,0 +1,85 @@
+/// @file kifubatchconverter.h
+/// @brief 棋譜フォルダの一括形式変換（shogiboardq-convert の本体）
+
+#ifndef KIFUBATCHCONVERTER_H
+#define KIFUBATCHCONVERTER_H
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+class QTextStream;
+
+/**
+ * @brief 棋譜ファイル群をスレッドプールで別の形式へ変換する
+ *
+ * 各スレッドは共有の添字から次のファイルを取り、読み込み・変換・書き出しまでを
+ * 1ファイルずつ行う。変換結果はファイルごとにすぐ書き出すので、メモリに溜めない。
+ * 出力先を標準出力（"-"）にした場合は、1ファイル分の行をまとめて書く
+ * （並列数 1 なら入力順、それ以外は変換が終わった順）。
+ */
+class KifuBatchConverter
+{
+public:
+    struct Options {
+        QStringList inputs;        ///< 入力（棋譜ファイル・フォルダ・ワイルドカード）
+        QString outputSuffix;      ///< 出力形式の拡張子（"csa" など）
+        QString outputDir;         ///< 出力先フォルダ（空なら入力と同じフォルダ、"-" なら標準出力）
+        bool recursive = false;    ///< フォルダ指定のときサブフォルダも変換する
+        bool overwrite = false;    ///< 既存の出力ファイルを上書きする（既定はスキップ）
+        int jobs = 0;              ///< 並列数（0 ならCPUのスレッド数）
+        bool verbose = false;      ///< 1ファイルごとに結果を出す
+    };
+
+    struct Stats {
+        qsizetype total = 0;       ///< 対象ファイル数
+        qsizetype converted = 0;   ///< 変換したファイル数
+        qsizetype skipped = 0;     ///< 出力が既にあって飛ばしたファイル数
+        qsizetype failed = 0;      ///< 読み込み・書き出しに失敗したファイル数
+        qint64 elapsedMs = 0;      ///< 所要時間（ミリ秒）
+
+        /// 1秒あたりの処理ファイル数
+        double filesPerSecond() const;
+    };
+
+    /// @param data 標準出力モードでの変換結果の出力先
+    /// @param log 進捗・エラーの出力先
+    KifuBatchConverter(const Options &options, QTextStream &data, QTextStream &log);
+
+    /// 変換を実行し、終わるまで待つ
+    Stats run();
+
+    /// 入力に一致する棋譜ファイルがなかった入力の一覧（run() 後に有効）
+    const QStringList &unmatchedInputs() const { return m_unmatchedInputs; }
+
+private:
+    enum class Outcome { Converted, Skipped, Failed };
+
+    /// 1ファイル分の変換対象
+    struct Job {
+        QString inputPath;
+        QString outputPath;
+    };
+
+    QList<Job> collectJobs();
+    QString outputPathFor(const QString &inputPath, const QDir &base) const;
+    bool writesToStdout() const;
+    Outcome convertJob(const Job &job, QString &message);
+    void reportJob(const Job &job, Outcome outcome, const QString &message);
+
+    Options m_options;
+    QTextStream &m_data;
+    QTextStream &m_log;
+    QStringList m_unmatchedInputs;
+
+    QMutex m_dataMutex;            ///< m_data への書き込みを1ファイル単位にまとめる
+    QMutex m_reportMutex;          ///< m_stats・m_log・進捗表示を守る
+    Stats m_stats;
+    QElapsedTimer m_timer;
+    qint64 m_lastProgressMs = 0;
+};
+
+#endif // KIFUBATCHCONVERTER_H
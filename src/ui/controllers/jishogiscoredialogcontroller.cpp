@@ -49,10 +49,10 @@ void JishogiScoreDialogController::showDialog(QWidget* parentWidget, ShogiBoard*
     EngineMoveValidator validator;
 
     // 先手の玉が王手されているかどうかを判定
-    bool senteInCheck = validator.checkIfKingInCheck(EngineMoveValidator::BLACK, board->boardData()) > 0;
+    bool senteInCheck = validator.checkIfKingInCheck(EngineMoveValidator::BLACK, board->enginePosition()) > 0;
 
     // 後手の玉が王手されているかどうかを判定
-    bool goteInCheck = validator.checkIfKingInCheck(EngineMoveValidator::WHITE, board->boardData()) > 0;
+    bool goteInCheck = validator.checkIfKingInCheck(EngineMoveValidator::WHITE, board->enginePosition()) > 0;
 
     // 宣言条件の文字列を生成
     QString senteCondition = buildConditionString(
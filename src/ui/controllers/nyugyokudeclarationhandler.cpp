@@ -170,9 +170,9 @@ bool NyugyokuDeclarationHandler::handleDeclaration(QWidget* parentWidget, ShogiB
     const auto& score = isSenteTurn ? calcResult.sente : calcResult.gote;
 
     if (isSenteTurn) {
-        declarerInCheck = validator.checkIfKingInCheck(EngineMoveValidator::BLACK, board->boardData()) > 0;
+        declarerInCheck = validator.checkIfKingInCheck(EngineMoveValidator::BLACK, board->enginePosition()) > 0;
     } else {
-        declarerInCheck = validator.checkIfKingInCheck(EngineMoveValidator::WHITE, board->boardData()) > 0;
+        declarerInCheck = validator.checkIfKingInCheck(EngineMoveValidator::WHITE, board->enginePosition()) > 0;
     }
 
     // 宣言条件の判定
@@ -352,6 +352,7 @@ void UiStatePolicyManager::applyPolicy(UiElement element, Policy policy)
         break;
     case UiElement::EditSfenViewer:
         applyActionPolicy(ui ? ui->actionSfenCollectionViewer : nullptr, policy);
+        applyActionPolicy(ui ? ui->actionKifuDatabase : nullptr, policy);
         break;
     case UiElement::EditCopyBoardImage:
         applyActionPolicy(ui ? ui->actionCopyBoardToClipboard : nullptr, policy);
@@ -23,6 +23,7 @@
 #include "engineanalysistab.h"
 #include "kifuanalysislistmodel.h"
 #include "sfencollectiondialog.h"
+#include "kifudatabasedialog.h"
 #include "tsumeshogigeneratordialog.h"
 #include "evaluationchartwidget.h"
 #include "logcategories.h"
@@ -272,6 +273,33 @@ void DialogLaunchWiring::displaySfenCollectionViewer()
     dlg->show();
 }
 
+void DialogLaunchWiring::displayKifuDatabaseDialog()
+{
+    if (!m_deps.kifuDatabaseDialog) return;
+
+    // 既にダイアログが開いている場合は現在の局面で検索し直してアクティブにする
+    if (*m_deps.kifuDatabaseDialog) {
+        (*m_deps.kifuDatabaseDialog)->searchCurrentPosition();
+        (*m_deps.kifuDatabaseDialog)->raise();
+        (*m_deps.kifuDatabaseDialog)->activateWindow();
+        return;
+    }
+
+    auto* dlg = new KifuDatabaseDialog(m_deps.parentWidget);
+    *m_deps.kifuDatabaseDialog = dlg;
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->setCurrentSfenProvider([getSfenRecord = m_deps.getSfenRecord, activePly = m_deps.activePly]() {
+        const QStringList* record = getSfenRecord ? getSfenRecord() : nullptr;
+        if (!record || record->isEmpty()) return QString();
+        const int ply = activePly ? *activePly : 0;
+        return record->at(qBound(0, ply, static_cast<int>(record->size()) - 1));
+    });
+    connect(dlg, &KifuDatabaseDialog::gameSelected,
+            this, &DialogLaunchWiring::kifuDatabaseGameSelected);
+    dlg->show();
+    dlg->searchCurrentPosition();
+}
+
 void DialogLaunchWiring::onCsaEngineScoreUpdatedInternal(int scoreCp, int ply)
 {
     qCDebug(lcUi).noquote() << "onCsaEngineScoreUpdatedInternal: scoreCp=" << scoreCp << "ply=" << ply;
@@ -35,6 +35,7 @@ class EvaluationChartWidget;
 class KifuAnalysisListModel;
 class GameInfoPaneController;
 class SfenCollectionDialog;
+class KifuDatabaseDialog;
 class KifuDisplay;
 
 /**
@@ -43,7 +44,7 @@ class KifuDisplay;
  * 責務:
  * - バージョン情報、エンジン設定、成り確認、持将棋判定、入玉宣言、
  *   詰将棋探索/生成、メニューウィンドウ、CSA通信対局、
- *   棋譜解析、局面集ビューアの各ダイアログ起動
+ *   棋譜解析、局面集ビューア、棋譜データベースの各ダイアログ起動
  */
 class DialogLaunchWiring : public QObject
 {
@@ -92,6 +93,9 @@ public:
         // 局面集ダイアログ
         QPointer<SfenCollectionDialog>* sfenCollectionDialog = nullptr;
 
+        // 棋譜データベースダイアログ
+        QPointer<KifuDatabaseDialog>* kifuDatabaseDialog = nullptr;
+
         // CSA通信対局のエンジン評価値グラフ用
         std::function<CsaGameCoordinator*()> getCsaGameCoordinator;
 
@@ -116,9 +120,11 @@ public slots:
     void displayCsaGameDialog();
     void displayKifuAnalysisDialog();
     void displaySfenCollectionViewer();
+    void displayKifuDatabaseDialog();
 
 signals:
     void sfenCollectionPositionSelected(const QString& sfen);
+    void kifuDatabaseGameSelected(const QString& filePath);
 
 private slots:
     void onCsaEngineScoreUpdatedInternal(int scoreCp, int ply);
@@ -45,4 +45,7 @@ void EditActionsWiring::wire()
 
     // 局面集ビューア
     QObject::connect(ui->actionSfenCollectionViewer, &QAction::triggered, dlw, &DialogLaunchWiring::displaySfenCollectionViewer, Qt::UniqueConnection);
+
+    // 棋譜データベース
+    QObject::connect(ui->actionKifuDatabase,         &QAction::triggered, dlw, &DialogLaunchWiring::displayKifuDatabaseDialog,   Qt::UniqueConnection);
 }
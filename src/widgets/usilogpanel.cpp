@@ -4,21 +4,29 @@
 #include "usilogpanel.h"
 #include "logviewfontmanager.h"
 #include "buttonstyles.h"
+#include "logcategories.h"
 
 #include <QWidget>
-#include <QPlainTextEdit>
+#include <QListView>
+#include <QScrollBar>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QToolButton>
 #include <QLabel>
 #include <QLineEdit>
 #include <QComboBox>
-#include <QTextCursor>
-#include <QTextCharFormat>
+#include <QAction>
+#include <QApplication>
+#include <QClipboard>
+#include <QItemSelectionModel>
+#include <QStandardPaths>
+#include <QStringList>
 #include <QSizePolicy>
+#include <algorithm>
 
 #include "analysissettings.h"
 #include "usicommlogmodel.h"
+#include "usilogmodel.h"
 
 namespace {
 void relaxToolbarWidth(QWidget* toolbar)
@@ -33,7 +41,12 @@ void relaxToolbarWidth(QWidget* toolbar)
 
 UsiLogPanel::UsiLogPanel(QObject* parent)
     : QObject(parent)
+    , m_logModel(new UsiLogModel(this))
 {
+    m_logModel->setCapacity(AnalysisSettings::usiLogMaxLines());
+    connect(m_logModel, &UsiLogModel::linesAppended,
+            this, &UsiLogPanel::onLogLinesAppended);
+    applySpillSetting(AnalysisSettings::usiLogSpillToFile());
 }
 
 UsiLogPanel::~UsiLogPanel() = default;
@@ -51,8 +64,7 @@ QWidget* UsiLogPanel::buildUi(QWidget* parent)
     buildCommandBar();
     layout->addWidget(m_commandBar);
 
-    m_logView = new QPlainTextEdit(m_container);
-    m_logView->setReadOnly(true);
+    buildLogView();
     layout->addWidget(m_logView);
 
     initFontManager();
@@ -81,41 +93,20 @@ void UsiLogPanel::setModels(UsiCommLogModel* log1, UsiCommLogModel* log2)
     }
 }
 
-void UsiLogPanel::appendColoredLog(const QString& logLine, const QColor& lineColor)
+void UsiLogPanel::appendStatus(const QString& message)
 {
-    if (!m_logView || logLine.isEmpty()) return;
-
-    QTextCursor cursor = m_logView->textCursor();
-    cursor.movePosition(QTextCursor::End);
-
-    QTextCharFormat coloredFormat;
-    coloredFormat.setForeground(lineColor);
-    cursor.insertText(logLine + QStringLiteral("\n"), coloredFormat);
-
-    m_logView->setTextCursor(cursor);
-    m_logView->ensureCursorVisible();
+    if (message.isEmpty()) return;
+    m_logModel->append(UsiLogModel::Source::Status, QStringLiteral("⚙ ") + message);
 }
 
-void UsiLogPanel::appendStatus(const QString& message)
+void UsiLogPanel::clear()
 {
-    if (!m_logView || message.isEmpty()) return;
-
-    QTextCursor cursor = m_logView->textCursor();
-    cursor.movePosition(QTextCursor::End);
-
-    QTextCharFormat grayFormat;
-    grayFormat.setForeground(QColor(0x80, 0x80, 0x80));
-    cursor.insertText(QStringLiteral("⚙ ") + message + QStringLiteral("\n"), grayFormat);
-
-    m_logView->setTextCursor(cursor);
-    m_logView->ensureCursorVisible();
+    m_logModel->clear();
 }
 
-void UsiLogPanel::clear()
+UsiLogModel* UsiLogPanel::logModel() const
 {
-    if (m_logView) {
-        m_logView->clear();
-    }
+    return m_logModel;
 }
 
 // ===================== ツールバー構築 =====================
@@ -148,6 +139,22 @@ void UsiLogPanel::buildToolbar()
     m_engine2Label = new QLabel(QStringLiteral("E2: ---"), m_toolbar);
     m_engine2Label->setStyleSheet(QStringLiteral("QLabel { color: #a02060; font-weight: bold; }"));
 
+    m_filterCombo = new QComboBox(m_toolbar);
+    m_filterCombo->addItem(tr("全て"));
+    m_filterCombo->addItem(QStringLiteral("E1"));
+    m_filterCombo->addItem(QStringLiteral("E2"));
+    m_filterCombo->setToolTip(tr("表示するエンジンを選択"));
+    connect(m_filterCombo, &QComboBox::currentIndexChanged,
+            this, &UsiLogPanel::onFilterChanged);
+
+    m_btnSpill = new QToolButton(m_toolbar);
+    m_btnSpill->setText(tr("保存"));
+    m_btnSpill->setCheckable(true);
+    m_btnSpill->setChecked(!m_logModel->spillFilePath().isEmpty());
+    m_btnSpill->setToolTip(tr("通信ログをファイルにも保存する（%1）").arg(spillFilePath()));
+    connect(m_btnSpill, &QToolButton::toggled,
+            this, &UsiLogPanel::onSpillToggled);
+
     toolbarLayout->addWidget(m_btnFontDecrease);
     toolbarLayout->addWidget(m_btnFontIncrease);
     toolbarLayout->addSpacing(20);
@@ -155,6 +162,8 @@ void UsiLogPanel::buildToolbar()
     toolbarLayout->addSpacing(20);
     toolbarLayout->addWidget(m_engine2Label);
     toolbarLayout->addStretch();
+    toolbarLayout->addWidget(m_filterCombo);
+    toolbarLayout->addWidget(m_btnSpill);
 
     m_toolbar->setLayout(toolbarLayout);
     relaxToolbarWidth(m_toolbar);
@@ -194,6 +203,91 @@ void UsiLogPanel::buildCommandBar()
             this, &UsiLogPanel::onCommandEntered);
 }
 
+// ===================== ログ表示 =====================
+
+void UsiLogPanel::buildLogView()
+{
+    m_logView = new QListView(m_container);
+    m_logView->setModel(m_logModel);
+    // 行の高さを固定にして、見えている行だけを測って描画させる
+    m_logView->setUniformItemSizes(true);
+    m_logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_logView->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
+
+    auto* copyAction = new QAction(tr("コピー"), m_logView);
+    copyAction->setShortcut(QKeySequence::Copy);
+    copyAction->setShortcutContext(Qt::WidgetShortcut);
+    m_logView->addAction(copyAction);
+    m_logView->setContextMenuPolicy(Qt::ActionsContextMenu);
+    connect(copyAction, &QAction::triggered,
+            this, &UsiLogPanel::onCopySelection);
+
+    connect(m_logView->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &UsiLogPanel::onLogScrolled);
+    m_logView->scrollToBottom();
+}
+
+void UsiLogPanel::onLogLinesAppended()
+{
+    if (m_logView && m_followTail) {
+        m_logView->scrollToBottom();
+    }
+}
+
+void UsiLogPanel::onLogScrolled(int value)
+{
+    // 利用者が上へスクロールして読んでいる間は追記で動かさない
+    m_followTail = value >= m_logView->verticalScrollBar()->maximum();
+}
+
+void UsiLogPanel::onCopySelection()
+{
+    QModelIndexList rows = m_logView->selectionModel()->selectedRows();
+    if (rows.isEmpty()) return;
+
+    std::sort(rows.begin(), rows.end());
+    QStringList lines;
+    lines.reserve(rows.size());
+    for (const QModelIndex& index : std::as_const(rows)) {
+        lines.append(index.data(Qt::DisplayRole).toString());
+    }
+    QApplication::clipboard()->setText(lines.join(QLatin1Char('\n')));
+}
+
+void UsiLogPanel::onFilterChanged(int index)
+{
+    m_logModel->setFilter(static_cast<UsiLogModel::Filter>(index));
+    m_followTail = true;
+    if (m_logView) m_logView->scrollToBottom();
+}
+
+// ===================== ファイル保存 =====================
+
+QString UsiLogPanel::spillFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+           + QStringLiteral("/logs/usi-comm.log");
+}
+
+void UsiLogPanel::onSpillToggled(bool enabled)
+{
+    AnalysisSettings::setUsiLogSpillToFile(enabled);
+    applySpillSetting(enabled);
+}
+
+void UsiLogPanel::applySpillSetting(bool enabled)
+{
+    if (m_logModel->setSpillFile(enabled ? spillFilePath() : QString())) return;
+
+    qCWarning(lcUi) << "USI通信ログファイルを開けません:" << spillFilePath();
+    if (m_btnSpill) {
+        m_btnSpill->blockSignals(true);
+        m_btnSpill->setChecked(false);
+        m_btnSpill->blockSignals(false);
+    }
+}
+
 // ===================== フォント管理 =====================
 
 void UsiLogPanel::initFontManager()
@@ -255,14 +349,15 @@ void UsiLogPanel::onEngine2NameChanged()
 
 void UsiLogPanel::onLog1Changed()
 {
-    if (m_logView && m_log1) {
-        appendColoredLog(m_log1->usiCommLog(), QColor(0x20, 0x60, 0xa0));
+    // 積むだけで、表示への反映は UsiLogModel がフレーム間隔でまとめて行う
+    if (m_log1) {
+        m_logModel->append(UsiLogModel::Source::Engine1, m_log1->usiCommLog());
     }
 }
 
 void UsiLogPanel::onLog2Changed()
 {
-    if (m_logView && m_log2) {
-        appendColoredLog(m_log2->usiCommLog(), QColor(0xa0, 0x20, 0x60));
+    if (m_log2) {
+        m_logModel->append(UsiLogModel::Source::Engine2, m_log2->usiCommLog());
     }
 }
@@ -5,11 +5,10 @@
 /// @brief USI通信ログパネルクラスの定義
 
 #include <QObject>
-#include <QColor>
 #include <memory>
 
 class QWidget;
-class QPlainTextEdit;
+class QListView;
 class QToolButton;
 class QLabel;
 class QLineEdit;
@@ -17,13 +16,15 @@ class QComboBox;
 
 class LogViewFontManager;
 class UsiCommLogModel;
+class UsiLogModel;
 
 /**
  * @brief USI通信ログの表示・操作を担うパネル
  *
  * EngineAnalysisTab から USI通信ログ関連の責務を分離したクラス。
- * ツールバー（フォントサイズ・エンジン名表示）、コマンド入力バー、
- * ログ表示エリアを持つ。
+ * ツールバー（フォントサイズ・エンジン名表示・絞り込み・ファイル保存）、コマンド入力バー、
+ * ログ表示エリアを持つ。ログは UsiLogModel（上限付きリングバッファ）に溜め、
+ * QListView で見えている行だけを描画する。
  */
 class UsiLogPanel : public QObject
 {
@@ -39,15 +40,15 @@ public:
     /// USI通信ログモデルを設定（エンジン名・ログ表示を接続）
     void setModels(UsiCommLogModel* log1, UsiCommLogModel* log2);
 
-    /// 色付きログ行を追記
-    void appendColoredLog(const QString& logLine, const QColor& lineColor);
-
     /// ステータスメッセージを追記（グレー表示）
     void appendStatus(const QString& message);
 
     /// ログをクリア
     void clear();
 
+    /// ログの保持モデル
+    UsiLogModel* logModel() const;
+
 signals:
     /// USIコマンド送信シグナル（target: 0=E1, 1=E2, 2=両方）
     void usiCommandRequested(int target, const QString& command);
@@ -60,19 +61,33 @@ private slots:
     void onEngine2NameChanged();
     void onLog1Changed();
     void onLog2Changed();
+    void onFilterChanged(int index);
+    void onSpillToggled(bool enabled);
+    void onLogLinesAppended();
+    void onLogScrolled(int value);
+    void onCopySelection();
 
 private:
     void buildToolbar();
     void buildCommandBar();
+    void buildLogView();
     void initFontManager();
+    void applySpillSetting(bool enabled);
+
+    /// ファイル保存時の書き出し先
+    static QString spillFilePath();
 
     QWidget* m_container = nullptr;
     QWidget* m_toolbar = nullptr;
-    QPlainTextEdit* m_logView = nullptr;
+    QListView* m_logView = nullptr;
+    UsiLogModel* m_logModel = nullptr;
+    bool m_followTail = true;           ///< 末尾を表示中なら追記に合わせてスクロールする
     QLabel* m_engine1Label = nullptr;
     QLabel* m_engine2Label = nullptr;
     QToolButton* m_btnFontIncrease = nullptr;
     QToolButton* m_btnFontDecrease = nullptr;
+    QComboBox* m_filterCombo = nullptr;
+    QToolButton* m_btnSpill = nullptr;
     int m_fontSize = 10;
     std::unique_ptr<LogViewFontManager> m_fontManager;
 
@@ -7,6 +7,7 @@
 #include <cstdio>
 
 #include "enginemovevalidator.h"
+#include "fmvbitboardattacks.h"
 #include "shogiboard.h"
 #include "shogimove.h"
 
@@ -267,6 +268,45 @@ BenchResult benchMidgame(int iterations)
     return r;
 }
 
+// ============================================================
+// Benchmark 6: 走り駒の利き方式（PEXT表 vs レイ表）
+// ============================================================
+double timeGenerateLegalMoves(const QString& sfen, int iterations)
+{
+    ShogiBoard board;
+    board.setSfen(sfen);
+
+    EngineMoveValidator emv;
+    EngineMoveValidator::Context ctx;
+    (void)emv.syncContext(ctx, EngineMoveValidator::BLACK, board.boardData(), board.pieceStand());
+
+    QElapsedTimer timer;
+    timer.start();
+    volatile int count = 0;
+    for (int i = 0; i < iterations; ++i) {
+        count = emv.generateLegalMoves(ctx);
+    }
+    (void)count;
+    return static_cast<double>(timer.nsecsElapsed()) / 1e6;
+}
+
+void benchSlidingBackends(const QString& sfen, int iterations)
+{
+    using fmv::attacks::SlidingBackend;
+
+    std::printf("  %-40s  %8d iter\n", "sliding attacks backend", iterations);
+    const double classicalMs = fmv::attacks::setSlidingBackend(SlidingBackend::Classical)
+                                   ? timeGenerateLegalMoves(sfen, iterations) : 0.0;
+    std::printf("    Classical (ray + bitscan):  %8.2f ms\n", classicalMs);
+    if (fmv::attacks::setSlidingBackend(SlidingBackend::Pext)) {
+        const double pextMs = timeGenerateLegalMoves(sfen, iterations);
+        std::printf("    PEXT (BMI2 table):          %8.2f ms    [%.1fx vs classical]\n\n",
+                    pextMs, classicalMs / pextMs);
+    } else {
+        std::printf("    PEXT (BMI2 table):          unsupported on this CPU\n\n");
+    }
+}
+
 } // namespace
 
 int main()
@@ -291,5 +331,8 @@ int main()
 
     printResult(benchMidgame(N));
 
+    benchSlidingBackends(QStringLiteral(
+        "ln1g1g1nl/1ks2r3/1ppppsbpp/p4pp2/9/2P1P4/PPBP1PPPP/2G1S2R1/LN2KG1NL b Pp 1"), N);
+
     return 0;
 }
@@ -11,6 +11,7 @@ constexpr auto kPidEnvName = "SBQ_TEST_ENGINE_PID_FILE";
 constexpr auto kModeEnvName = "SBQ_TEST_ENGINE_MODE";
 constexpr auto kSlowUsiMode = "slow-usi";
 constexpr auto kSlowQuitMode = "slow-quit";
+constexpr auto kSearchMode = "search";
 
 void writePidFile()
 {
@@ -45,6 +46,19 @@ int main(int argc, char* argv[])
             continue;
         }
 
+        if (mode == QByteArray(kSearchMode)) {
+            // go は stop まで探索を続け、stop で info と bestmove を返す
+            if (line.rfind("go", 0) == 0) {
+                std::cout << "info depth 1 score cp 0 pv 7g7f" << std::endl;
+            } else if (line == "stop") {
+                std::cout << "info string stopped" << std::endl;
+                std::cout << "bestmove 7g7f" << std::endl;
+            } else if (line == "isready") {
+                std::cout << "readyok" << std::endl;
+            }
+            continue;
+        }
+
         if (mode == QByteArray(kSlowQuitMode)) {
             if (line == "usi") {
                 std::cout << "id name SlowQuitEngine" << std::endl;
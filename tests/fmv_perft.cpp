@@ -0,0 +1,228 @@
+/// @file fmv_perft.cpp
+/// @brief fmv コアの perft / divide コマンドラインツール（並列・置換表対応）
+///
+/// 使い方:
+///   fmv_perft --suite [--depth 4] [--threads N] [--hash MiB]
+///   fmv_perft --position matsuri --depth 3 --divide
+///   fmv_perft --sfen "<SFEN>" --depth 4 --scaling
+///
+/// ルートの各手を1タスクとしてスレッドプールに投入し、空いたスレッドが
+/// 次の手を取りに行く（手ごとの部分木の大きさの偏りを吸収する）。
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QList>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <cstdio>
+#include <memory>
+
+#include "fmvconverter.h"
+#include "fmvlegalcore.h"
+#include "fmvperft.h"
+#include "fmvposition.h"
+
+namespace {
+
+struct NamedPosition {
+    const char* name;
+    const char* sfen;
+    QList<quint64> expected; ///< expected[d-1] = 深さ d のノード数
+};
+
+/// 将棋 perft の標準局面（平手・祭り局面・最大合法手局面）
+const QList<NamedPosition>& standardPositions()
+{
+    static const QList<NamedPosition> positions = {
+        {"hirate", "lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL b - 1",
+         {30, 900, 25470, 719731, 19861490}},
+        {"matsuri", "l6nl/5+P1gk/2np1S3/p1p4Pp/3P2Sp1/1PPb2P1P/P5GS1/R8/LN4bKL w RGgsn5p 1",
+         {207, 28684, 4809015, 516925165}},
+        {"maxmoves", "R8/2K1S1SSk/4B4/9/9/9/9/9/1L1L1L3 b RBGSNLP3g3n17p 1",
+         {593, 105677, 53393368}},
+    };
+    return positions;
+}
+
+struct RootResult {
+    fmv::Move move = fmv::Move::none();
+    quint64 nodes = 0;
+};
+
+struct RunOptions {
+    int depth = 1;
+    int threads = 1;
+    bool divide = false;
+    fmv::PerftTable* table = nullptr;
+};
+
+/// ルートの手ごとにタスクを分けて perft を実行する
+QList<RootResult> runRoot(const fmv::EnginePosition& root, fmv::Color side, const RunOptions& opt)
+{
+    fmv::EnginePosition pos = root;
+    fmv::LegalCore core;
+    fmv::MoveList moves;
+    core.generateLegalMoves(pos, side, moves);
+
+    QList<RootResult> tasks;
+    tasks.reserve(moves.size);
+    for (int i = 0; i < moves.size; ++i) {
+        tasks.append({moves[i], 0});
+    }
+    if (opt.depth <= 1) {
+        for (RootResult& r : tasks) {
+            r.nodes = 1;
+        }
+        return tasks;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(opt.threads);
+    fmv::PerftTable* table = opt.table;
+    const int childDepth = opt.depth - 1;
+    return QtConcurrent::blockingMapped(&pool, tasks, [&root, side, table, childDepth](const RootResult& task) {
+        fmv::EnginePosition work = root;
+        const fmv::LegalCore localCore;
+        RootResult r = task;
+        fmv::UndoState undo;
+        if (work.doMove(task.move, side, undo)) {
+            r.nodes = fmv::perft(work, fmv::opposite(side), localCore, childDepth, table);
+        }
+        return r;
+    });
+}
+
+struct RunStats {
+    quint64 nodes = 0;
+    double seconds = 0.0;
+};
+
+RunStats runOnce(const fmv::EnginePosition& root, fmv::Color side, const RunOptions& opt,
+                 std::size_t hashMiB)
+{
+    std::unique_ptr<fmv::PerftTable> table;
+    if (hashMiB > 0) {
+        table = std::make_unique<fmv::PerftTable>(hashMiB);
+    }
+    RunOptions local = opt;
+    local.table = table.get();
+
+    QElapsedTimer timer;
+    timer.start();
+    const QList<RootResult> results = runRoot(root, side, local);
+    RunStats stats;
+    stats.seconds = static_cast<double>(timer.nsecsElapsed()) / 1e9;
+
+    for (const RootResult& r : results) {
+        stats.nodes += r.nodes;
+        if (opt.divide) {
+            std::printf("  %-8s %llu\n", qPrintable(fmv::Converter::toUsi(r.move)),
+                        static_cast<unsigned long long>(r.nodes));
+        }
+    }
+    return stats;
+}
+
+void printStats(const char* label, int depth, int threads, const RunStats& s, const char* verdict)
+{
+    const double nps = s.seconds > 0.0 ? static_cast<double>(s.nodes) / s.seconds : 0.0;
+    std::printf("%-10s d%-2d threads=%-3d nodes=%-12llu time=%8.3fs nps=%12.0f%s\n", label, depth,
+                threads, static_cast<unsigned long long>(s.nodes), s.seconds, nps, verdict);
+}
+
+QList<int> threadSteps(int maxThreads)
+{
+    QList<int> steps;
+    for (int n = 1; n < maxThreads; n *= 2) {
+        steps.append(n);
+    }
+    steps.append(maxThreads);
+    return steps;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("fmv_perft"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("perft / divide benchmark for the fmv move generator"));
+    parser.addHelpOption();
+    const QCommandLineOption sfenOpt(QStringLiteral("sfen"), QStringLiteral("Root position (SFEN)."),
+                                     QStringLiteral("sfen"));
+    const QCommandLineOption positionOpt(QStringLiteral("position"),
+                                         QStringLiteral("Named position: hirate, matsuri, maxmoves."),
+                                         QStringLiteral("name"), QStringLiteral("hirate"));
+    const QCommandLineOption depthOpt(QStringLiteral("depth"), QStringLiteral("Search depth (suite: max depth)."),
+                                      QStringLiteral("n"), QStringLiteral("3"));
+    const QCommandLineOption threadsOpt(QStringLiteral("threads"), QStringLiteral("Worker threads."),
+                                        QStringLiteral("n"), QString::number(QThread::idealThreadCount()));
+    const QCommandLineOption hashOpt(QStringLiteral("hash"), QStringLiteral("Transposition table size in MiB (0 = off)."),
+                                     QStringLiteral("mib"), QStringLiteral("0"));
+    const QCommandLineOption divideOpt(QStringLiteral("divide"), QStringLiteral("Print node counts per root move."));
+    const QCommandLineOption scalingOpt(QStringLiteral("scaling"),
+                                        QStringLiteral("Repeat with 1, 2, 4, ... threads up to --threads."));
+    const QCommandLineOption suiteOpt(QStringLiteral("suite"),
+                                      QStringLiteral("Verify the standard positions up to --depth."));
+    parser.addOptions({sfenOpt, positionOpt, depthOpt, threadsOpt, hashOpt, divideOpt, scalingOpt, suiteOpt});
+    parser.process(app);
+
+    RunOptions opt;
+    opt.depth = qMax(1, parser.value(depthOpt).toInt());
+    const int maxThreads = qMax(1, parser.value(threadsOpt).toInt());
+    const auto hashMiB = static_cast<std::size_t>(qMax(0, parser.value(hashOpt).toInt()));
+    opt.divide = parser.isSet(divideOpt);
+    const QList<int> steps = parser.isSet(scalingOpt) ? threadSteps(maxThreads) : QList<int>{maxThreads};
+
+    if (parser.isSet(suiteOpt)) {
+        int failures = 0;
+        for (const NamedPosition& np : standardPositions()) {
+            fmv::EnginePosition pos;
+            fmv::Color side = fmv::Color::Black;
+            fmv::Converter::fromSfen(pos, side, QString::fromLatin1(np.sfen));
+            const int lastDepth = qMin(opt.depth, static_cast<int>(np.expected.size()));
+            for (int d = 1; d <= lastDepth; ++d) {
+                for (int threads : steps) {
+                    RunOptions run = opt;
+                    run.depth = d;
+                    run.threads = threads;
+                    const RunStats s = runOnce(pos, side, run, hashMiB);
+                    const bool ok = s.nodes == np.expected.at(d - 1);
+                    failures += ok ? 0 : 1;
+                    printStats(np.name, d, threads, s, ok ? "  OK" : "  MISMATCH");
+                }
+            }
+        }
+        std::printf("%s\n", failures == 0 ? "suite passed" : "suite FAILED");
+        return failures == 0 ? 0 : 1;
+    }
+
+    QString sfen = parser.value(sfenOpt);
+    QString label = QStringLiteral("sfen");
+    if (sfen.isEmpty()) {
+        label = parser.value(positionOpt);
+        for (const NamedPosition& np : standardPositions()) {
+            if (label == QLatin1String(np.name)) {
+                sfen = QString::fromLatin1(np.sfen);
+            }
+        }
+    }
+
+    fmv::EnginePosition pos;
+    fmv::Color side = fmv::Color::Black;
+    if (sfen.isEmpty() || !fmv::Converter::fromSfen(pos, side, sfen)) {
+        std::fprintf(stderr, "invalid position: %s\n", qPrintable(sfen.isEmpty() ? label : sfen));
+        return 2;
+    }
+
+    for (int threads : steps) {
+        RunOptions run = opt;
+        run.threads = threads;
+        printStats(qPrintable(label), opt.depth, threads, runOnce(pos, side, run, hashMiB), "");
+    }
+    return 0;
+}
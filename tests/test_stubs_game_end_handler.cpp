@@ -512,6 +512,8 @@ void ThinkingInfoPresenter::logSentCommand(const QString&, const QString&) {}
 void ThinkingInfoPresenter::logReceivedData(const QString&, const QString&) {}
 void ThinkingInfoPresenter::logStderrData(const QString&, const QString&) {}
 void ThinkingInfoPresenter::onInfoReceived(const QString&) {}
+void ThinkingInfoPresenter::submitInfoBuffer() {}
+void ThinkingInfoPresenter::drainConvertedInfo() {}
 
 ShogiEngineInfoParser::ShogiEngineInfoParser() {}
 
@@ -590,10 +592,11 @@ void EngineVsEngineStrategy::startEvEFirstMoveByBlack() {}
 void EngineVsEngineStrategy::startEvEFirstMoveByWhite() {}
 
 // ============================================================
-// SennichiteDetector スタブ
+// SennichiteDetector / SennichiteTracker スタブ
 // ============================================================
 
 #include "sennichitedetector.h"
+#include "sennichitetracker.h"
 
 SennichiteDetector::Result SennichiteDetector::check(const QStringList&)
 {
@@ -607,6 +610,12 @@ QString SennichiteDetector::positionKey(const QString& sfen)
     return sfen.left(lastSpace);
 }
 
+bool SennichiteTracker::pushPosition(const QString&) { return true; }
+void SennichiteTracker::popPosition() {}
+void SennichiteTracker::clear() {}
+SennichiteTracker::Result SennichiteTracker::result() const { return Result::None; }
+SennichiteTracker::Result SennichiteTracker::syncTo(const QStringList&) { return Result::None; }
+
 // ============================================================
 // SettingsService スタブ
 // ============================================================
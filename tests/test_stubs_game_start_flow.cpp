@@ -450,6 +450,7 @@ KifuLoadCoordinator::KifuLoadCoordinator(QList<ShogiMove>& gameMoves, QStringLis
     , m_currentSelectedPly(currentSelectedPly)
     , m_currentMoveIndex(currentMoveIndex) {}
 
+KifuLoadCoordinator::~KifuLoadCoordinator() = default;
 void KifuLoadCoordinator::resetBranchTreeForNewGame() {}
 void KifuLoadCoordinator::resetBranchContext() {}
 void KifuLoadCoordinator::setBranchTreeManager(BranchTreeManager*) {}
@@ -660,6 +661,8 @@ void ThinkingInfoPresenter::logSentCommand(const QString&, const QString&) {}
 void ThinkingInfoPresenter::logReceivedData(const QString&, const QString&) {}
 void ThinkingInfoPresenter::logStderrData(const QString&, const QString&) {}
 void ThinkingInfoPresenter::onInfoReceived(const QString&) {}
+void ThinkingInfoPresenter::submitInfoBuffer() {}
+void ThinkingInfoPresenter::drainConvertedInfo() {}
 
 // ============================================================
 // ShogiEngineInfoParser スタブ
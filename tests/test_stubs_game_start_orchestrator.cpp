@@ -481,6 +481,8 @@ void ThinkingInfoPresenter::logSentCommand(const QString&, const QString&) {}
 void ThinkingInfoPresenter::logReceivedData(const QString&, const QString&) {}
 void ThinkingInfoPresenter::logStderrData(const QString&, const QString&) {}
 void ThinkingInfoPresenter::onInfoReceived(const QString&) {}
+void ThinkingInfoPresenter::submitInfoBuffer() {}
+void ThinkingInfoPresenter::drainConvertedInfo() {}
 
 ShogiEngineInfoParser::ShogiEngineInfoParser() {}
 
@@ -599,7 +599,7 @@ private slots:
         }
     }
 
-    /// loadKifuCommon が共通パイプラインを実装していること
+    /// loadKifuCommon がワーカーでの解析を起動し、完了時に共通パイプラインで反映すること
     void klc_loadKifuCommonPipeline()
     {
         const QStringList& lines = klcLines();
@@ -613,28 +613,45 @@ private slots:
         QVERIFY2(body.contains(QStringLiteral("m_loadingKifu = true")),
                   "Must set m_loadingKifu flag");
 
-        // 2) 初期局面の検出
-        QVERIFY2(body.contains(QStringLiteral("initialSfen")),
-                  "Must determine initial SFEN");
-
-        // 3) パース実行
+        // 2) 前の読み込みの取り消しとワーカーでのパース実行
+        QVERIFY2(body.contains(QStringLiteral("m_loadCancel")),
+                  "Must cancel the previous load");
+        QVERIFY2(body.contains(QStringLiteral("QtConcurrent::run")),
+                  "Must parse on a worker thread");
         QVERIFY2(body.contains(QStringLiteral("parseFunc")),
                   "Must call parseFunc");
 
-        // 4) エラー時の errorOccurred シグナル
+        // 3) 読み込み失敗時の errorOccurred シグナル
         QVERIFY2(body.contains(QStringLiteral("errorOccurred")),
+                  "Must emit errorOccurred on read failure");
+
+        const auto finished = findFunctionBody(
+            lines, QStringLiteral("KifuLoadCoordinator::onKifuParseFinished("));
+        QVERIFY2(finished.first >= 0, "onKifuParseFinished not found");
+        const QString finishedBody = bodyText(lines, finished);
+
+        // 4) 取り消された解析は反映しない
+        QVERIFY2(finishedBody.contains(QStringLiteral("cancelled")),
+                  "Must drop cancelled results");
+
+        // 5) 初期局面の決定
+        QVERIFY2(finishedBody.contains(QStringLiteral("initialSfen")),
+                  "Must determine initial SFEN");
+
+        // 6) パース失敗時の errorOccurred シグナル
+        QVERIFY2(finishedBody.contains(QStringLiteral("errorOccurred")),
                   "Must emit errorOccurred on parse failure");
 
-        // 5) ゲーム情報抽出
-        QVERIFY2(body.contains(QStringLiteral("extractGameInfoFunc")),
-                  "Must call extractGameInfoFunc");
+        // 7) ゲーム情報反映（解析結果に含まれる）
+        QVERIFY2(finishedBody.contains(QStringLiteral("res.gameInfo")),
+                  "Must apply game info from the parse result");
 
-        // 6) 結果適用
-        QVERIFY2(body.contains(QStringLiteral("applyParsedResult")),
+        // 8) 結果適用
+        QVERIFY2(finishedBody.contains(QStringLiteral("applyParsedResult")),
                   "Must call applyParsedResult");
     }
 
-    /// loadKifuCommon がパース失敗時にフラグをリセットすること
+    /// loadKifuCommon と完了処理が失敗時にフラグをリセットすること
     void klc_loadKifuCommon_resetsOnFailure()
     {
         const QStringList& lines = klcLines();
@@ -644,8 +661,16 @@ private slots:
 
         const QString body = bodyText(lines, range);
 
-        // パース失敗時に m_loadingKifu = false が設定されること
+        // 読み込み失敗時に m_loadingKifu = false が設定されること
         QVERIFY2(body.contains(QStringLiteral("m_loadingKifu = false")),
+                  "Must reset m_loadingKifu on read failure");
+
+        const auto finished = findFunctionBody(
+            lines, QStringLiteral("KifuLoadCoordinator::onKifuParseFinished("));
+        QVERIFY2(finished.first >= 0, "onKifuParseFinished not found");
+
+        // パース失敗時に m_loadingKifu = false が設定されること
+        QVERIFY2(bodyText(lines, finished).contains(QStringLiteral("m_loadingKifu = false")),
                   "Must reset m_loadingKifu on parse failure");
     }
 
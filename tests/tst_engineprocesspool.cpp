@@ -0,0 +1,220 @@
+/// @file tst_engineprocesspool.cpp
+/// @brief EngineProcessPool（待機中エンジンの貸出・返却）のユニットテスト
+///
+/// 待機エンジンには engineregistration_test_engine（標準入力が閉じるまで待機する）を使う。
+/// search モードでは go に info、stop に bestmove、isready に readyok を返す。
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QProcessEnvironment>
+
+#include "engineprocesspool.h"
+
+namespace {
+
+QString testEnginePath()
+{
+#ifdef Q_OS_WIN
+    const QString suffix = QStringLiteral(".exe");
+#else
+    const QString suffix;
+#endif
+    return QCoreApplication::applicationDirPath()
+           + QDir::separator()
+           + QStringLiteral("engineregistration_test_engine")
+           + suffix;
+}
+
+EngineProcessPool::WarmEngine startWarmEngine(const QString& engineName, const QString& mode = QString())
+{
+    EngineProcessPool::WarmEngine engine;
+    engine.enginePath = testEnginePath();
+    engine.engineName = engineName;
+    engine.process = std::make_unique<QProcess>();
+    if (!mode.isEmpty()) {
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert(QStringLiteral("SBQ_TEST_ENGINE_MODE"), mode);
+        engine.process->setProcessEnvironment(env);
+    }
+    engine.process->start(engine.enginePath, QStringList());
+    if (!engine.process->waitForStarted(5000)) {
+        engine.process.reset();
+    }
+    return engine;
+}
+
+} // namespace
+
+class TestEngineProcessPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        if (!QFile::exists(testEnginePath())) {
+            QSKIP("engineregistration_test_engine is not built");
+        }
+    }
+
+    void init()
+    {
+        EngineProcessPool& pool = EngineProcessPool::instance();
+        pool.clear();
+        pool.setMaxIdlePerEngine(1);
+        pool.setIdleTimeoutMs(EngineProcessPool::kDefaultIdleTimeoutMs);
+        pool.setSettleTimeoutMs(EngineProcessPool::kDefaultSettleTimeoutMs);
+    }
+
+    void cleanupTestCase()
+    {
+        EngineProcessPool::instance().clear();
+    }
+
+    void release_keepsUpToLimitPerEngine()
+    {
+        EngineProcessPool& pool = EngineProcessPool::instance();
+        const QString path = testEnginePath();
+
+        QVERIFY(pool.accepts(path, QStringLiteral("A")));
+        QVERIFY(pool.release(startWarmEngine(QStringLiteral("A"))));
+        QVERIFY(!pool.accepts(path, QStringLiteral("A")));
+        QVERIFY(!pool.release(startWarmEngine(QStringLiteral("A"))));
+
+        // 構成（エンジン名）が違えば別枠
+        QVERIFY(pool.release(startWarmEngine(QStringLiteral("B"))));
+        QCOMPARE(pool.idleCount(), 2);
+        QCOMPARE(pool.idleCount(path, QStringLiteral("A")), 1);
+
+        // 上限を下げると超えた分は終了させる
+        pool.setMaxIdlePerEngine(0);
+        QCOMPARE(pool.idleCount(), 0);
+        QVERIFY(!pool.accepts(path, QStringLiteral("A")));
+    }
+
+    void lease_returnsSameConfigWithAppliedOptions()
+    {
+        EngineProcessPool& pool = EngineProcessPool::instance();
+        const QString path = testEnginePath();
+
+        EngineProcessPool::WarmEngine engine = startWarmEngine(QStringLiteral("A"));
+        engine.reportedOptions = {QStringLiteral("USI_Hash")};
+        engine.appliedOptions.insert(QStringLiteral("USI_Hash"),
+                                     QStringLiteral("setoption name USI_Hash value 256"));
+        QVERIFY(pool.release(std::move(engine)));
+
+        QVERIFY(!pool.lease(path, QStringLiteral("B")).has_value());
+        QVERIFY(!pool.lease(QStringLiteral("/nonexistent/engine"), QStringLiteral("A")).has_value());
+
+        std::optional<EngineProcessPool::WarmEngine> leased = pool.lease(path, QStringLiteral("A"));
+        QVERIFY(leased.has_value());
+        QVERIFY(leased->process);
+        QCOMPARE(leased->process->state(), QProcess::Running);
+        QVERIFY(leased->reportedOptions.contains(QStringLiteral("USI_Hash")));
+        QCOMPARE(leased->appliedOptions.value(QStringLiteral("USI_Hash")),
+                 QStringLiteral("setoption name USI_Hash value 256"));
+        QCOMPARE(pool.idleCount(), 0);
+
+        QVERIFY(pool.release(std::move(*leased)));
+    }
+
+    void lease_skipsProcessThatExitedWhileIdle()
+    {
+        EngineProcessPool& pool = EngineProcessPool::instance();
+
+        EngineProcessPool::WarmEngine engine = startWarmEngine(QStringLiteral("A"));
+        QProcess* process = engine.process.get();
+        QVERIFY(process);
+        QVERIFY(pool.release(std::move(engine)));
+
+        process->closeWriteChannel();
+        QVERIFY(process->waitForFinished(5000));
+
+        QVERIFY(!pool.lease(testEnginePath(), QStringLiteral("A")).has_value());
+        QCOMPARE(pool.idleCount(), 0);
+    }
+
+    void release_settlesSearchingEngineBeforeLease()
+    {
+        EngineProcessPool& pool = EngineProcessPool::instance();
+        const QString path = testEnginePath();
+
+        // 検討（go infinite）中のエンジンを、Usi::releaseToPool() と同じく stop を送って返す
+        EngineProcessPool::WarmEngine engine = startWarmEngine(QStringLiteral("A"), QStringLiteral("search"));
+        QProcess* process = engine.process.get();
+        QVERIFY(process);
+        process->write("go infinite\n");
+        QVERIFY(process->waitForReadyRead(5000));
+        process->write("stop\n");
+        engine.settling = true;
+        QVERIFY(pool.release(std::move(engine)));
+        QCOMPARE(pool.idleCount(), 1);
+
+        // 棋譜解析が同じプロセスを借りる（bestmove を読み捨てるまでは貸し出さない）
+        std::optional<EngineProcessPool::WarmEngine> leased;
+        QTRY_VERIFY_WITH_TIMEOUT((leased = pool.lease(path, QStringLiteral("A"))).has_value(), 5000);
+        QCOMPARE(leased->process.get(), process);
+        QVERIFY(!leased->settling);
+
+        // 前の探索の出力は残っておらず、次の isready への応答が最初に読める
+        process->write("isready\n");
+        QTRY_VERIFY_WITH_TIMEOUT(process->canReadLine(), 5000);
+        QCOMPARE(process->readLine().trimmed(), QByteArray("readyok"));
+
+        QVERIFY(pool.release(std::move(*leased)));
+    }
+
+    void settleTimeout_terminatesEngineIgnoringStop()
+    {
+        EngineProcessPool& pool = EngineProcessPool::instance();
+        pool.setSettleTimeoutMs(100);
+
+        // stop に応答しないエンジンは貸し出さず、期限が来たら終了させる
+        EngineProcessPool::WarmEngine engine = startWarmEngine(QStringLiteral("A"));
+        engine.settling = true;
+        QVERIFY(pool.release(std::move(engine)));
+        QVERIFY(!pool.lease(testEnginePath(), QStringLiteral("A")).has_value());
+        QCOMPARE(pool.idleCount(), 1);
+        QTRY_COMPARE(pool.idleCount(), 0);
+    }
+
+    void release_rejectsStoppedProcess()
+    {
+        EngineProcessPool& pool = EngineProcessPool::instance();
+
+        EngineProcessPool::WarmEngine engine;
+        engine.enginePath = testEnginePath();
+        engine.engineName = QStringLiteral("A");
+        engine.process = std::make_unique<QProcess>();
+        QVERIFY(!pool.release(std::move(engine)));
+        QCOMPARE(pool.idleCount(), 0);
+    }
+
+    void idleTimeout_evictsExpiredEngines()
+    {
+        EngineProcessPool& pool = EngineProcessPool::instance();
+
+        QVERIFY(pool.release(startWarmEngine(QStringLiteral("A"))));
+        pool.setIdleTimeoutMs(60 * 1000);
+        QCOMPARE(pool.idleCount(), 1);
+
+        pool.setIdleTimeoutMs(0);
+        QCOMPARE(pool.idleCount(), 0);
+    }
+
+    void shutdown_rejectsFurtherReleases()
+    {
+        EngineProcessPool& pool = EngineProcessPool::instance();
+
+        QVERIFY(pool.release(startWarmEngine(QStringLiteral("A"))));
+        pool.shutdown();
+        QCOMPARE(pool.idleCount(), 0);
+        QCOMPARE(pool.maxIdlePerEngine(), 0);
+        QVERIFY(!pool.release(startWarmEngine(QStringLiteral("A"))));
+    }
+};
+
+QTEST_MAIN(TestEngineProcessPool)
+#include "tst_engineprocesspool.moc"
@@ -2,6 +2,7 @@
 
 #include "fmvconverter.h"
 #include "fmvlegalcore.h"
+#include "fmvperft.h"
 #include "fmvposition.h"
 #include "shogiboard.h"
 
@@ -13,30 +14,9 @@ class TestFmvPerft : public QObject
     Q_OBJECT
 
     std::int64_t perft(fmv::EnginePosition& pos, fmv::Color side,
-                       const fmv::LegalCore& core, int depth)
+                       const fmv::LegalCore& core, int depth, fmv::PerftTable* table = nullptr)
     {
-        if (depth == 0) {
-            return 1;
-        }
-
-        fmv::MoveList moves;
-        moves.clear();
-        core.generateLegalMoves(pos, side, moves);
-
-        if (depth == 1) {
-            return moves.size;
-        }
-
-        std::int64_t nodes = 0;
-        fmv::Color next = fmv::opposite(side);
-        for (int i = 0; i < moves.size; ++i) {
-            fmv::UndoState undo;
-            if (pos.doMove(moves.moves[static_cast<std::size_t>(i)], side, undo)) {
-                nodes += perft(pos, next, core, depth - 1);
-                pos.undoMove(undo, side);
-            }
-        }
-        return nodes;
+        return static_cast<std::int64_t>(fmv::perft(pos, side, core, depth, table));
     }
 
 private slots:
@@ -79,6 +59,35 @@ private slots:
         // Known value: 25470
         QCOMPARE(nodes, 25470);
     }
+
+    void perft_withTable_matchesPlain_data()
+    {
+        QTest::addColumn<QString>("sfen");
+        QTest::addColumn<int>("depth");
+        QTest::addColumn<qint64>("expected");
+        QTest::newRow("hirate-d3") << kHirateSfen << 3 << qint64(25470);
+        QTest::newRow("matsuri-d2")
+            << QStringLiteral("l6nl/5+P1gk/2np1S3/p1p4Pp/3P2Sp1/1PPb2P1P/P5GS1/R8/LN4bKL w RGgsn5p 1")
+            << 2 << qint64(28684);
+    }
+
+    void perft_withTable_matchesPlain()
+    {
+        QFETCH(QString, sfen);
+        QFETCH(int, depth);
+        QFETCH(qint64, expected);
+
+        fmv::EnginePosition pos;
+        fmv::Color side = fmv::Color::Black;
+        QVERIFY(fmv::Converter::fromSfen(pos, side, sfen));
+
+        // 同じ表で2回数える: 2回目は置換表のヒットで返るが結果は変わらない
+        fmv::LegalCore core;
+        fmv::PerftTable table(1);
+        QCOMPARE(perft(pos, side, core, depth, &table), expected);
+        QCOMPARE(perft(pos, side, core, depth, &table), expected);
+        QCOMPARE(perft(pos, side, core, depth), expected);
+    }
 };
 
 QTEST_MAIN(TestFmvPerft)
@@ -98,6 +98,15 @@ private slots:
         QVERIFY(notA.test(0));
         QVERIFY(notA.test(50));
         QCOMPARE(notA.count(), 81 - 2);
+
+        fmv::Bitboard81 xorResult = a ^ b;
+        QVERIFY(!xorResult.test(10));
+        QVERIFY(xorResult.test(50));
+        QVERIFY(xorResult.test(70));
+        QCOMPARE(xorResult.count(), 2);
+
+        xorResult ^= b;
+        QVERIFY(xorResult == a);
     }
 
     void anyNone()
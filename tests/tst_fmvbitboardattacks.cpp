@@ -0,0 +1,164 @@
+/// @file tst_fmvbitboardattacks.cpp
+/// @brief 利きビットボード表（PEXT/レイ表）のテスト
+
+#include <QtTest>
+
+#include "fmvbitboardattacks.h"
+
+namespace {
+
+using fmv::Bitboard81;
+using fmv::Square;
+
+/// 参照実装: sq から (df, dr) 方向へ1マスずつ進める
+Bitboard81 referenceSlide(Square sq, int df, int dr, const Bitboard81& occ)
+{
+    Bitboard81 result;
+    int file = fmv::squareFile(sq) + df;
+    int rank = fmv::squareRank(sq) + dr;
+    while (file >= 0 && file < fmv::kBoardSize && rank >= 0 && rank < fmv::kBoardSize) {
+        const Square to = fmv::toSquare(file, rank);
+        result.set(to);
+        if (occ.test(to)) {
+            break;
+        }
+        file += df;
+        rank += dr;
+    }
+    return result;
+}
+
+/// 決定的な擬似乱数で占有ビットボードを作る（密度は約 1/4〜1/2）
+Bitboard81 randomOccupancy(quint64& state)
+{
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+    const quint64 lo = next() & next();
+    const quint64 hi = next() & Bitboard81::kHiMask;
+    return Bitboard81(lo, hi);
+}
+
+} // namespace
+
+class TestFmvBitboardAttacks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup()
+    {
+        // テスト間で方式を既定（使えるなら PEXT）に戻す
+        if (!fmv::attacks::setSlidingBackend(fmv::attacks::SlidingBackend::Pext)) {
+            fmv::attacks::setSlidingBackend(fmv::attacks::SlidingBackend::Classical);
+        }
+    }
+
+    void slidingAttacks_matchReference_data()
+    {
+        QTest::addColumn<int>("backend");
+        QTest::newRow("pext") << static_cast<int>(fmv::attacks::SlidingBackend::Pext);
+        QTest::newRow("classical") << static_cast<int>(fmv::attacks::SlidingBackend::Classical);
+    }
+
+    void slidingAttacks_matchReference()
+    {
+        QFETCH(int, backend);
+        if (!fmv::attacks::setSlidingBackend(static_cast<fmv::attacks::SlidingBackend>(backend))) {
+            QSKIP("BMI2 not supported on this CPU");
+        }
+
+        quint64 state = 0x9E3779B97F4A7C15ULL;
+        for (int trial = 0; trial < 64; ++trial) {
+            const Bitboard81 occ = randomOccupancy(state);
+            for (int s = 0; s < fmv::kSquareNb; ++s) {
+                const auto sq = static_cast<Square>(s);
+
+                const Bitboard81 rook = referenceSlide(sq, 0, -1, occ) | referenceSlide(sq, 0, 1, occ)
+                                        | referenceSlide(sq, -1, 0, occ) | referenceSlide(sq, 1, 0, occ);
+                QCOMPARE(fmv::attacks::rookAttacks(sq, occ), rook);
+
+                const Bitboard81 bishop = referenceSlide(sq, -1, -1, occ) | referenceSlide(sq, 1, -1, occ)
+                                          | referenceSlide(sq, -1, 1, occ) | referenceSlide(sq, 1, 1, occ);
+                QCOMPARE(fmv::attacks::bishopAttacks(sq, occ), bishop);
+
+                QCOMPARE(fmv::attacks::lanceAttacks(fmv::Color::Black, sq, occ),
+                         referenceSlide(sq, 0, -1, occ));
+                QCOMPARE(fmv::attacks::lanceAttacks(fmv::Color::White, sq, occ),
+                         referenceSlide(sq, 0, 1, occ));
+            }
+        }
+    }
+
+    void stepAttacks_knight()
+    {
+        // 5五（file=4, rank=4）の先手桂は 6三・4三、後手桂は 6七・4七
+        const Square sq = fmv::toSquare(4, 4);
+        Bitboard81 black;
+        black.set(fmv::toSquare(3, 2));
+        black.set(fmv::toSquare(5, 2));
+        QCOMPARE(fmv::attacks::stepAttacks(fmv::Color::Black, fmv::PieceType::Knight, sq), black);
+
+        Bitboard81 white;
+        white.set(fmv::toSquare(3, 6));
+        white.set(fmv::toSquare(5, 6));
+        QCOMPARE(fmv::attacks::stepAttacks(fmv::Color::White, fmv::PieceType::Knight, sq), white);
+    }
+
+    void pieceAttacks_horseAndDragonIncludeStep()
+    {
+        // 盤上が全て埋まっていても馬・龍は周囲8マスに利く
+        const Bitboard81 full = ~Bitboard81();
+        const Square sq = fmv::toSquare(4, 4);
+        const Bitboard81 king = fmv::attacks::stepAttacks(fmv::Color::Black, fmv::PieceType::King, sq);
+        QCOMPARE(fmv::attacks::pieceAttacks(fmv::Color::Black, fmv::PieceType::Horse, sq, full), king);
+        QCOMPARE(fmv::attacks::pieceAttacks(fmv::Color::Black, fmv::PieceType::Dragon, sq, full), king);
+    }
+
+    void filesOf_fillsPawnFiles()
+    {
+        // 1筋（file=0, 段7 は lo/hi 境界を跨ぐ）と 9筋（file=8, 段8 は hi）
+        Bitboard81 pawns;
+        pawns.set(fmv::toSquare(0, 7));
+        pawns.set(fmv::toSquare(8, 8));
+        QCOMPARE(fmv::attacks::filesOf(pawns), fmv::attacks::fileMask(0) | fmv::attacks::fileMask(8));
+        QVERIFY(fmv::attacks::filesOf(Bitboard81()).none());
+    }
+
+    void between_linesOnly()
+    {
+        const Square a = fmv::toSquare(0, 0);
+        const Square b = fmv::toSquare(4, 4);
+        Bitboard81 diag;
+        for (int i = 1; i < 4; ++i) {
+            diag.set(fmv::toSquare(i, i));
+        }
+        QCOMPARE(fmv::attacks::between(a, b), diag);
+        QCOMPARE(fmv::attacks::between(b, a), diag);
+
+        // 隣接・桂の位置関係は空
+        QVERIFY(fmv::attacks::between(b, fmv::toSquare(5, 5)).none());
+        QVERIFY(fmv::attacks::between(b, fmv::toSquare(5, 2)).none());
+    }
+
+    void deadSquares_andPromotionZone()
+    {
+        QCOMPARE(fmv::attacks::deadSquares(fmv::Color::Black, fmv::PieceType::Knight).count(), 18);
+        QVERIFY(fmv::attacks::deadSquares(fmv::Color::White, fmv::PieceType::Pawn).test(fmv::toSquare(3, 8)));
+        QVERIFY(fmv::attacks::deadSquares(fmv::Color::Black, fmv::PieceType::Silver).none());
+        QCOMPARE(fmv::attacks::promotionZone(fmv::Color::White).count(), 27);
+        QVERIFY(fmv::attacks::promotionZone(fmv::Color::White).test(fmv::toSquare(0, 6)));
+    }
+
+    void setSlidingBackend_classicalAlwaysAvailable()
+    {
+        QVERIFY(fmv::attacks::setSlidingBackend(fmv::attacks::SlidingBackend::Classical));
+        QCOMPARE(fmv::attacks::slidingBackend(), fmv::attacks::SlidingBackend::Classical);
+    }
+};
+
+QTEST_MAIN(TestFmvBitboardAttacks)
+#include "tst_fmvbitboardattacks.moc"
@@ -2,6 +2,7 @@
 
 #include "enginemovevalidator.h"
 #include "fmvconverter.h"
+#include "fmvlegalcore.h"
 #include "fmvposition.h"
 #include "shogiboard.h"
 #include "shogimove.h"
@@ -73,11 +74,11 @@ private slots:
         bool ok = fmv::Converter::toEngineMove(cm, EngineMoveValidator::BLACK, pos, sm);
         QVERIFY(ok);
 
-        QCOMPARE(cm.nonPromote.kind, fmv::MoveKind::Board);
-        QCOMPARE(cm.nonPromote.from, fmv::toSquare(6, 6));
-        QCOMPARE(cm.nonPromote.to, fmv::toSquare(6, 5));
-        QCOMPARE(cm.nonPromote.piece, fmv::PieceType::Pawn);
-        QVERIFY(!cm.nonPromote.promote);
+        QCOMPARE(cm.nonPromote.kind(), fmv::MoveKind::Board);
+        QCOMPARE(cm.nonPromote.from(), fmv::toSquare(6, 6));
+        QCOMPARE(cm.nonPromote.to(), fmv::toSquare(6, 5));
+        QCOMPARE(cm.nonPromote.piece(), fmv::PieceType::Pawn);
+        QVERIFY(!cm.nonPromote.promote());
         QVERIFY(!cm.hasPromoteVariant); // 6段目→5段目は敵陣外
     }
 
@@ -96,9 +97,9 @@ private slots:
         bool ok = fmv::Converter::toEngineMove(cm, EngineMoveValidator::BLACK, pos, sm);
         QVERIFY(ok);
 
-        QCOMPARE(cm.nonPromote.kind, fmv::MoveKind::Drop);
-        QCOMPARE(cm.nonPromote.to, fmv::toSquare(4, 4));
-        QCOMPARE(cm.nonPromote.piece, fmv::PieceType::Silver);
+        QCOMPARE(cm.nonPromote.kind(), fmv::MoveKind::Drop);
+        QCOMPARE(cm.nonPromote.to(), fmv::toSquare(4, 4));
+        QCOMPARE(cm.nonPromote.piece(), fmv::PieceType::Silver);
         QVERIFY(!cm.hasPromoteVariant);
     }
 
@@ -117,7 +118,7 @@ private slots:
         bool ok = fmv::Converter::toEngineMove(cm, EngineMoveValidator::BLACK, pos, sm);
         QVERIFY(ok);
         QVERIFY(cm.hasPromoteVariant);
-        QVERIFY(cm.promote.promote);
+        QVERIFY(cm.promote.promote());
     }
 
     void toColor()
@@ -125,6 +126,131 @@ private slots:
         QCOMPARE(fmv::Converter::toColor(EngineMoveValidator::BLACK), fmv::Color::Black);
         QCOMPARE(fmv::Converter::toColor(EngineMoveValidator::WHITE), fmv::Color::White);
     }
+
+    void fromSfen_matchesShogiBoardPath_data()
+    {
+        QTest::addColumn<QString>("sfen");
+        QTest::newRow("hirate") << kHirateSfen;
+        QTest::newRow("matsuri")
+            << QStringLiteral("l6nl/5+P1gk/2np1S3/p1p4Pp/3P2Sp1/1PPb2P1P/P5GS1/R8/LN4bKL w RGgsn5p 1");
+        QTest::newRow("maxMoves")
+            << QStringLiteral("R8/2K1S1SSk/4B4/9/9/9/9/9/1L1L1L3 b RBGSNLP3g3n17p 1");
+    }
+
+    void fromSfen_matchesShogiBoardPath()
+    {
+        QFETCH(QString, sfen);
+
+        ShogiBoard board;
+        board.setSfen(sfen);
+        fmv::EnginePosition expected;
+        fmv::Converter::toEnginePosition(expected, board.boardData(), board.pieceStand());
+
+        fmv::EnginePosition pos;
+        fmv::Color side = fmv::Color::Black;
+        QVERIFY(fmv::Converter::fromSfen(pos, side, sfen));
+
+        const fmv::Color expectedSide = sfen.contains(QStringLiteral(" w ")) ? fmv::Color::White
+                                                                              : fmv::Color::Black;
+        QCOMPARE(side, expectedSide);
+        QCOMPARE(pos.board, expected.board);
+        QCOMPARE(pos.hand[0], expected.hand[0]);
+        QCOMPARE(pos.hand[1], expected.hand[1]);
+        QCOMPARE(pos.occupied, expected.occupied);
+        QCOMPARE(pos.zobristKey, expected.computeZobristKey(expectedSide));
+    }
+
+    void fromSfen_rejectsMalformed_data()
+    {
+        QTest::addColumn<QString>("sfen");
+        QTest::newRow("tooFewFiles") << QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSN b - 1");
+        QTest::newRow("tooFewRanks") << QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1 b - 1");
+        QTest::newRow("badTurn") << QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL x - 1");
+        QTest::newRow("promotedGold") << QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNS+GKGSNL b - 1");
+        QTest::newRow("kingInHand") << QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL b K 1");
+        QTest::newRow("noHand") << QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL b");
+    }
+
+    void fromSfen_rejectsMalformed()
+    {
+        QFETCH(QString, sfen);
+
+        fmv::EnginePosition pos;
+        fmv::Color side = fmv::Color::Black;
+        QVERIFY(!fmv::Converter::fromSfen(pos, side, sfen));
+    }
+
+    void move_packedFields()
+    {
+        const fmv::Move board =
+            fmv::Move::makeBoard(fmv::toSquare(7, 1), fmv::toSquare(2, 6), fmv::PieceType::Bishop, true);
+        QCOMPARE(board.from(), fmv::toSquare(7, 1));
+        QCOMPARE(board.to(), fmv::toSquare(2, 6));
+        QCOMPARE(board.piece(), fmv::PieceType::Bishop);
+        QCOMPARE(board.kind(), fmv::MoveKind::Board);
+        QVERIFY(board.promote());
+        QVERIFY(!board.withPromote(false).promote());
+        QCOMPARE(fmv::Move::fromRaw(board.raw()), board);
+
+        const fmv::Move drop = fmv::Move::makeDrop(fmv::PieceType::Rook, fmv::toSquare(8, 8));
+        QVERIFY(drop.isDrop());
+        QCOMPARE(drop.from(), fmv::kInvalidSquare);
+        QCOMPARE(drop.to(), fmv::toSquare(8, 8));
+        QCOMPARE(drop.piece(), fmv::PieceType::Rook);
+        QVERIFY(!drop.promote());
+    }
+
+    void moveConversions_roundTripLegalMoves_data()
+    {
+        QTest::addColumn<QString>("sfen");
+        QTest::newRow("matsuri")
+            << QStringLiteral("l6nl/5+P1gk/2np1S3/p1p4Pp/3P2Sp1/1PPb2P1P/P5GS1/R8/LN4bKL w RGgsn5p 1");
+        QTest::newRow("maxMoves")
+            << QStringLiteral("R8/2K1S1SSk/4B4/9/9/9/9/9/1L1L1L3 b RBGSNLP3g3n17p 1");
+    }
+
+    void moveConversions_roundTripLegalMoves()
+    {
+        QFETCH(QString, sfen);
+
+        fmv::EnginePosition pos;
+        fmv::Color side = fmv::Color::Black;
+        QVERIFY(fmv::Converter::fromSfen(pos, side, sfen));
+        const auto turn = (side == fmv::Color::Black) ? EngineMoveValidator::BLACK : EngineMoveValidator::WHITE;
+
+        fmv::LegalCore core;
+        fmv::MoveList moves;
+        core.generateLegalMoves(pos, side, moves);
+        QVERIFY(moves.size > 0);
+
+        for (const fmv::Move& m : moves) {
+            fmv::Move parsed = fmv::Move::none();
+            QVERIFY(fmv::Converter::fromUsi(parsed, pos, fmv::Converter::toUsi(m)));
+            QCOMPARE(parsed, m);
+
+            const ShogiMove sm = fmv::Converter::toShogiMove(pos, side, m);
+            fmv::ConvertedMove cm;
+            QVERIFY(fmv::Converter::toEngineMove(cm, turn, pos, sm));
+            QCOMPARE(m.promote() ? cm.promote : cm.nonPromote, m);
+        }
+    }
+
+    void usi_format()
+    {
+        const fmv::Move p76 =
+            fmv::Move::makeBoard(fmv::toSquare(6, 6), fmv::toSquare(6, 5), fmv::PieceType::Pawn);
+        QCOMPARE(fmv::Converter::toUsi(p76), QStringLiteral("7g7f"));
+        QCOMPARE(fmv::Converter::toUsi(fmv::Move::makeDrop(fmv::PieceType::Pawn, fmv::toSquare(4, 4))),
+                 QStringLiteral("P*5e"));
+
+        fmv::EnginePosition pos;
+        fmv::Color side = fmv::Color::Black;
+        QVERIFY(fmv::Converter::fromSfen(pos, side, kHirateSfen));
+        fmv::Move m = fmv::Move::none();
+        QVERIFY(!fmv::Converter::fromUsi(m, pos, QStringLiteral("5e5d")));   // 移動元が空
+        QVERIFY(!fmv::Converter::fromUsi(m, pos, QStringLiteral("K*5e")));   // 玉は打てない
+        QVERIFY(!fmv::Converter::fromUsi(m, pos, QStringLiteral("7g7f=")));
+    }
 };
 
 QTEST_MAIN(TestFmvConverter)
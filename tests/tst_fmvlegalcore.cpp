@@ -65,11 +65,7 @@ private slots:
         fmv::Converter::toEnginePosition(pos, board.boardData(), board.pieceStand());
 
         fmv::LegalCore core;
-        fmv::Move drop;
-        drop.kind = fmv::MoveKind::Drop;
-        drop.to = fmv::toSquare(4, 4);
-        drop.piece = fmv::PieceType::Silver;
-        drop.promote = false;
+        const fmv::Move drop = fmv::Move::makeDrop(fmv::PieceType::Silver, fmv::toSquare(4, 4));
 
         // do/undoで合法性チェック
         fmv::UndoState undo;
@@ -91,11 +87,7 @@ private slots:
 
         fmv::LegalCore core;
         // 歩を(0,1)に打つ → 相手玉(0,0)に王手
-        fmv::Move drop;
-        drop.kind = fmv::MoveKind::Drop;
-        drop.to = fmv::toSquare(0, 1);
-        drop.piece = fmv::PieceType::Pawn;
-        drop.promote = false;
+        const fmv::Move drop = fmv::Move::makeDrop(fmv::PieceType::Pawn, fmv::toSquare(0, 1));
 
         int movesWithoutDrop = core.countLegalMoves(pos, fmv::Color::Black);
         // この局面では歩打ちを含めた手がいくつあるか確認（打ち歩詰めは除外される）
@@ -115,30 +107,70 @@ private slots:
         fmv::LegalCore core;
 
         // 不成は疑似合法ではないのでtryApplyLegalMoveで却下される
-        fmv::Move nonPromote;
-        nonPromote.kind = fmv::MoveKind::Board;
-        nonPromote.from = fmv::toSquare(8, 1);
-        nonPromote.to = fmv::toSquare(8, 0);
-        nonPromote.piece = fmv::PieceType::Pawn;
-        nonPromote.promote = false;
+        const fmv::Move nonPromote =
+            fmv::Move::makeBoard(fmv::toSquare(8, 1), fmv::toSquare(8, 0), fmv::PieceType::Pawn);
 
         fmv::UndoState undo1;
         bool nonPromOk = core.tryApplyLegalMove(pos, fmv::Color::Black, nonPromote, undo1);
         QVERIFY(!nonPromOk); // 1段目不成は不可
 
         // 成りは合法
-        fmv::Move promote;
-        promote.kind = fmv::MoveKind::Board;
-        promote.from = fmv::toSquare(8, 1);
-        promote.to = fmv::toSquare(8, 0);
-        promote.piece = fmv::PieceType::Pawn;
-        promote.promote = true;
+        const fmv::Move promote =
+            fmv::Move::makeBoard(fmv::toSquare(8, 1), fmv::toSquare(8, 0), fmv::PieceType::Pawn, true);
 
         fmv::UndoState undo2;
         bool promOk = core.tryApplyLegalMove(pos, fmv::Color::Black, promote, undo2);
         QVERIFY(promOk);
         core.undoAppliedMove(pos, fmv::Color::Black, undo2);
     }
+
+    void checkMove_pinnedPiece_data()
+    {
+        QTest::addColumn<QString>("sfen");
+        // 5九玉・5八金を後手の飛車/香が5筋で狙っている
+        QTest::newRow("rookPin") << QStringLiteral("k3r4/9/9/9/9/9/9/4G4/4K4 b - 1");
+        QTest::newRow("lancePin") << QStringLiteral("k3l4/9/9/9/9/9/9/4G4/4K4 b - 1");
+    }
+
+    void checkMove_pinnedPiece()
+    {
+        QFETCH(QString, sfen);
+        ShogiBoard board;
+        board.setSfen(sfen);
+
+        fmv::EnginePosition pos;
+        fmv::Converter::toEnginePosition(pos, board.boardData(), board.pieceStand());
+
+        fmv::LegalCore core;
+        const fmv::Move sideways =
+            fmv::Move::makeBoard(fmv::toSquare(4, 7), fmv::toSquare(3, 7), fmv::PieceType::Gold);
+        QVERIFY(!core.checkMove(pos, fmv::Color::Black, sideways).nonPromotingMoveExists);
+
+        const fmv::Move forward =
+            fmv::Move::makeBoard(fmv::toSquare(4, 7), fmv::toSquare(4, 6), fmv::PieceType::Gold);
+        QVERIFY(core.checkMove(pos, fmv::Color::Black, forward).nonPromotingMoveExists);
+    }
+
+    void pawnDropMate_checkerCapturedOnlyByUnreachablePieces()
+    {
+        // 1八歩打ちで1九玉が詰む（打ち歩詰め）。王手駒に利いていない駒の「取る手」を
+        // 回避手として数えてしまうと打ち歩詰めを見逃す。
+        QString sfen = QStringLiteral(
+            "1+S1+RG1p2/Pp+S2L1Pl/lP2Ng1kn/1lPP1+b2P/p1pG5/2N1psNS1/3+B2P1+p/1g5p1/4+p3K w P2pr 1");
+        ShogiBoard board;
+        board.setSfen(sfen);
+
+        fmv::EnginePosition pos;
+        fmv::Converter::toEnginePosition(pos, board.boardData(), board.pieceStand());
+
+        fmv::LegalCore core;
+        fmv::MoveList moves;
+        core.generateLegalMoves(pos, fmv::Color::White, moves);
+        for (const fmv::Move& m : moves) {
+            QVERIFY(m != fmv::Move::makeDrop(fmv::PieceType::Pawn, fmv::toSquare(0, 7)));
+        }
+        QCOMPARE(core.countLegalMoves(pos, fmv::Color::White), moves.size);
+    }
 };
 
 QTEST_MAIN(TestFmvLegalCore)
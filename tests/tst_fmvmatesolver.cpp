@@ -0,0 +1,249 @@
+/// @file tst_fmvmatesolver.cpp
+/// @brief df-pn 詰み探索（fmv::MateSolver / TsumeMateSolver）のテスト
+
+#include <QtTest>
+
+#include "fmvconverter.h"
+#include "fmvlegalcore.h"
+#include "fmvmatesolver.h"
+#include "fmvposition.h"
+#include "tsumematesolver.h"
+
+namespace {
+
+/// 祭り局面（王手の種類が多い）
+const QString kMatsuriSfen =
+    QStringLiteral("l6nl/5+P1gk/2np1S3/p1p4Pp/3P2Sp1/1PPb2P1P/P5GS1/R8/LN4bKL w RGgsn5p 1");
+
+/// 竜と持ち飛車の3手詰（6二飛・7一玉・5一竜まで）
+const QString kMateInThreeSfen = QStringLiteral("3k5/9/4+R4/9/9/9/9/9/9 b R 1");
+
+/// 3手以内には詰まない5手詰（手数制限なしの df-pn は7手以上の手順を返しうる）
+const QString kMateInFiveSfen = QStringLiteral("k8/6+B2/7R1/9/9/9/9/9/9 b R 1");
+
+/// USI 手順を順に指し、攻方の手がすべて王手で、最後に玉方の合法手がないことを確かめる
+bool replaysToMate(const QString& sfen, const QStringList& pv)
+{
+    fmv::EnginePosition pos;
+    fmv::Color side = fmv::Color::Black;
+    if (!fmv::Converter::fromSfen(pos, side, sfen)) {
+        return false;
+    }
+    const fmv::Color attacker = side;
+    const fmv::LegalCore core;
+    for (const QString& usi : pv) {
+        fmv::Move m = fmv::Move::none();
+        fmv::UndoState undo;
+        if (!fmv::Converter::fromUsi(m, pos, usi) || !core.tryApplyLegalMove(pos, side, m, undo)) {
+            return false;
+        }
+        if (side == attacker && core.countChecksToKing(pos, fmv::opposite(attacker)) == 0) {
+            return false;
+        }
+        side = fmv::opposite(side);
+    }
+    return side != attacker && core.countLegalMoves(pos, side) == 0;
+}
+
+} // namespace
+
+class TestFmvMateSolver : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void generateCheckMoves_matchesFilteredLegalMoves()
+    {
+        fmv::EnginePosition pos;
+        fmv::Color side = fmv::Color::Black;
+        QVERIFY(fmv::Converter::fromSfen(pos, side, kMatsuriSfen));
+
+        const fmv::LegalCore core;
+        fmv::MoveList legal;
+        core.generateLegalMoves(pos, side, legal);
+        int expected = 0;
+        for (const fmv::Move& m : legal) {
+            fmv::UndoState undo;
+            QVERIFY(pos.doMove(m, side, undo));
+            expected += core.countChecksToKing(pos, fmv::opposite(side)) > 0 ? 1 : 0;
+            pos.undoMove(undo, side);
+        }
+
+        fmv::MoveList checks;
+        core.generateCheckMoves(pos, side, checks);
+        QCOMPARE(checks.size, expected);
+        for (const fmv::Move& m : checks) {
+            fmv::UndoState undo;
+            QVERIFY(pos.doMove(m, side, undo));
+            QVERIFY(core.countChecksToKing(pos, fmv::opposite(side)) > 0);
+            pos.undoMove(undo, side);
+        }
+    }
+
+    void solve_mateInOne()
+    {
+        const TsumeMateSolver::Result r =
+            TsumeMateSolver::solve(QStringLiteral("position sfen 4k4/9/4P4/9/9/9/9/9/9 b G 1"), {});
+        QCOMPARE(r.status, TsumeMateSolver::Status::Mate);
+        QCOMPARE(r.pv, QStringList{QStringLiteral("G*5b")});
+    }
+
+    void solve_mateInThree()
+    {
+        const TsumeMateSolver::Result r =
+            TsumeMateSolver::solve(QStringLiteral("position sfen ") + kMateInThreeSfen, {});
+        QCOMPARE(r.status, TsumeMateSolver::Status::Mate);
+        QCOMPARE(r.pv.size(), 3);
+        QVERIFY(replaysToMate(kMateInThreeSfen, r.pv));
+    }
+
+    void solve_maxPlyBelowMateLength_noMate()
+    {
+        TsumeMateSolver::Limits limits;
+        limits.maxPly = 1;
+        const TsumeMateSolver::Result r = TsumeMateSolver::solve(kMateInThreeSfen, limits);
+        QCOMPARE(r.status, TsumeMateSolver::Status::NoMate);
+        QVERIFY(r.pv.isEmpty());
+    }
+
+    void solve_noMate_data()
+    {
+        QTest::addColumn<QString>("sfen");
+        // 金1枚では玉に取られる
+        QTest::newRow("loneGold") << QStringLiteral("4k4/9/9/9/9/9/9/9/9 b G 1");
+        // 1二歩打ちは打ち歩詰めで指せず、ほかの王手は逃れられる
+        QTest::newRow("pawnDropMate") << QStringLiteral("7nk/9/6G2/8L/9/9/9/9/9 b P 1");
+    }
+
+    void solve_noMate()
+    {
+        QFETCH(QString, sfen);
+        const TsumeMateSolver::Result r = TsumeMateSolver::solve(sfen, {});
+        QCOMPARE(r.status, TsumeMateSolver::Status::NoMate);
+    }
+
+    void solve_repetitionReachedByTwoRoutes_data()
+    {
+        QTest::addColumn<QString>("sfen");
+        QTest::addColumn<bool>("mate");
+        // どちらも探索中に同じ局面へ別の経路から合流し、先の経路での千日手による反証が使えない
+        QTest::newRow("mate") << QStringLiteral("k6r1/8p/9/1+R1R5/9/8S/9/9/9 b - 1") << true;
+        QTest::newRow("noMate") << QStringLiteral("5k3/9/9/9/9/8R/9/9/9 b - 1") << false;
+    }
+
+    void solve_repetitionReachedByTwoRoutes()
+    {
+        // 別の経路で千日手により反証された局面に合流しても、その反証を流用せずに判定する
+        QFETCH(QString, sfen);
+        QFETCH(bool, mate);
+        const TsumeMateSolver::Result r = TsumeMateSolver::solve(sfen, {});
+        QCOMPARE(r.status, mate ? TsumeMateSolver::Status::Mate : TsumeMateSolver::Status::NoMate);
+        QVERIFY(!mate || replaysToMate(sfen, r.pv));
+    }
+
+    void solve_nodeLimit_unknown()
+    {
+        TsumeMateSolver::Limits limits;
+        limits.maxNodes = 2;
+        const TsumeMateSolver::Result r = TsumeMateSolver::solve(kMateInThreeSfen, limits);
+        QCOMPARE(r.status, TsumeMateSolver::Status::Unknown);
+        QVERIFY(r.nodes <= 2);
+    }
+
+    void solve_cancelled_unknown()
+    {
+        const CancelFlag cancel = makeCancelFlag();
+        cancel->store(true);
+        const TsumeMateSolver::Result r = TsumeMateSolver::solve(kMatsuriSfen, {}, cancel);
+        QCOMPARE(r.status, TsumeMateSolver::Status::Unknown);
+    }
+
+    void solve_invalidPosition()
+    {
+        // 玉方（後手）の玉がない局面は詰将棋として扱わない
+        QCOMPARE(TsumeMateSolver::solve(QStringLiteral("9/9/9/9/9/9/9/9/4K4 b G 1"), {}).status,
+                 TsumeMateSolver::Status::InvalidPosition);
+        QCOMPARE(TsumeMateSolver::solve(QStringLiteral("position startpos moves 7g7f 9z9y"), {}).status,
+                 TsumeMateSolver::Status::InvalidPosition);
+    }
+
+    void parsePosition_appliesMoves()
+    {
+        fmv::EnginePosition pos;
+        fmv::Color side = fmv::Color::Black;
+        QVERIFY(TsumeMateSolver::parsePosition(QStringLiteral("position startpos moves 7g7f 3c3d"), pos, side));
+        QCOMPARE(side, fmv::Color::Black);
+        QCOMPARE(pos.board[fmv::toSquare(6, 5)], 'P');
+        QCOMPARE(pos.board[fmv::toSquare(2, 3)], 'p');
+        QCOMPARE(pos.zobristKey, pos.computeZobristKey(fmv::Color::Black));
+    }
+
+    void solveExact_data()
+    {
+        QTest::addColumn<QString>("sfen");
+        QTest::addColumn<int>("maxPly");
+        QTest::addColumn<int>("expectedPvLength"); // 0 = NoMate
+        // 1手・3手は全幅探索だけで判定する
+        QTest::newRow("mateInOneAsOne") << QStringLiteral("4k4/9/4P4/9/9/9/9/9/9 b G 1") << 1 << 1;
+        QTest::newRow("mateInOneAsFive") << QStringLiteral("4k4/9/4P4/9/9/9/9/9/9 b G 1") << 5 << 1;
+        QTest::newRow("mateInThreeAsOne") << kMateInThreeSfen << 1 << 0;
+        QTest::newRow("mateInThreeAsThree") << kMateInThreeSfen << 3 << 3;
+        // 5手以上は df-pn で、目標より2手短い制限の探索を先に行う
+        QTest::newRow("mateInFiveAsThree") << kMateInFiveSfen << 3 << 0;
+        QTest::newRow("mateInFiveAsFive") << kMateInFiveSfen << 5 << 5;
+        QTest::newRow("mateInFiveAsSeven") << kMateInFiveSfen << 7 << 5;
+    }
+
+    void solveExact()
+    {
+        QFETCH(QString, sfen);
+        QFETCH(int, maxPly);
+        QFETCH(int, expectedPvLength);
+
+        TsumeMateSolver::Limits limits;
+        limits.maxPly = maxPly;
+        const TsumeMateSolver::Result r = TsumeMateSolver::solveExact(sfen, limits);
+        if (expectedPvLength == 0) {
+            QCOMPARE(r.status, TsumeMateSolver::Status::NoMate);
+            return;
+        }
+        QCOMPARE(r.status, TsumeMateSolver::Status::Mate);
+        QCOMPARE(r.pv.size(), expectedPvLength);
+        QVERIFY(replaysToMate(sfen, r.pv));
+    }
+
+    void solveExact_prefilters()
+    {
+        TsumeMateSolver::Limits limits;
+        limits.maxPly = 5;
+        // 攻方に王手が1つもなければ探索せずに不詰
+        const TsumeMateSolver::Result noCheck =
+            TsumeMateSolver::solveExact(QStringLiteral("4k4/9/9/9/9/9/9/9/P8 b - 1"), limits);
+        QCOMPARE(noCheck.status, TsumeMateSolver::Status::NoMate);
+        QCOMPARE(noCheck.nodes, quint64(0));
+        // 手番でない玉方に王手がかかっている局面は不正
+        QCOMPARE(TsumeMateSolver::solveExact(QStringLiteral("4k4/4P4/9/9/9/9/9/9/9 b - 1"), limits).status,
+                 TsumeMateSolver::Status::InvalidPosition);
+    }
+
+    void prefilter_rejectsWithoutSearch()
+    {
+        QCOMPARE(TsumeMateSolver::prefilter(QStringLiteral("position sfen 4k4/9/9/9/9/9/9/9/P8 b - 1")),
+                 TsumeMateSolver::Status::NoMate);
+        QCOMPARE(TsumeMateSolver::prefilter(QStringLiteral("position sfen 4k4/4P4/9/9/9/9/9/9/9 b - 1")),
+                 TsumeMateSolver::Status::InvalidPosition);
+        QCOMPARE(TsumeMateSolver::prefilter(QStringLiteral("position sfen ") + kMateInThreeSfen),
+                 TsumeMateSolver::Status::Unknown);
+    }
+
+    void solveAsync_returnsSameResult()
+    {
+        QFuture<TsumeMateSolver::Result> future = TsumeMateSolver::solveAsync(kMateInThreeSfen, {});
+        future.waitForFinished();
+        QCOMPARE(future.result().status, TsumeMateSolver::Status::Mate);
+        QVERIFY(replaysToMate(kMateInThreeSfen, future.result().pv));
+    }
+};
+
+QTEST_MAIN(TestFmvMateSolver)
+#include "tst_fmvmatesolver.moc"
@@ -2,6 +2,8 @@
 
 #include "fmvposition.h"
 #include "fmvconverter.h"
+#include "fmvlegalcore.h"
+#include "fmvzobrist.h"
 #include "shogiboard.h"
 
 static const QString kHirateSfen =
@@ -30,6 +32,42 @@ class TestFmvPosition : public QObject
         }
     }
 
+    /// 全合法手をdo/undoしながら、差分更新したZobristキーと全計算値の不一致数を数える
+    int countZobristMismatches(fmv::EnginePosition& pos, fmv::Color side,
+                               const fmv::LegalCore& core, int depth)
+    {
+        if (depth == 0) {
+            return 0;
+        }
+
+        fmv::MoveList moves;
+        core.generateLegalMoves(pos, side, moves);
+
+        int mismatches = 0;
+        const fmv::Color next = fmv::opposite(side);
+        const std::uint64_t keyBefore = pos.zobristKey;
+        for (int i = 0; i < moves.size; ++i) {
+            fmv::UndoState undo;
+            if (!pos.doMove(moves.moves[static_cast<std::size_t>(i)], side, undo)) {
+                continue;
+            }
+            if (pos.zobristKey != pos.computeZobristKey(next)) {
+                ++mismatches;
+            }
+            mismatches += countZobristMismatches(pos, next, core, depth - 1);
+            pos.undoMove(undo, side);
+            if (pos.zobristKey != keyBefore) {
+                ++mismatches;
+            }
+        }
+        return mismatches;
+    }
+
+    static fmv::Move boardMove(int fromX, int fromY, int toX, int toY, fmv::PieceType pt)
+    {
+        return fmv::Move::makeBoard(fmv::toSquare(fromX, fromY), fmv::toSquare(toX, toY), pt);
+    }
+
 private slots:
     void doUndo_boardMove_noCapture()
     {
@@ -41,12 +79,8 @@ private slots:
         fmv::EnginePosition original = pos;
 
         // 7六歩: from=(6,6), to=(6,5)
-        fmv::Move move;
-        move.kind = fmv::MoveKind::Board;
-        move.from = fmv::toSquare(6, 6);
-        move.to = fmv::toSquare(6, 5);
-        move.piece = fmv::PieceType::Pawn;
-        move.promote = false;
+        const fmv::Move move =
+            fmv::Move::makeBoard(fmv::toSquare(6, 6), fmv::toSquare(6, 5), fmv::PieceType::Pawn);
 
         fmv::UndoState undo;
         bool ok = pos.doMove(move, fmv::Color::Black, undo);
@@ -75,12 +109,8 @@ private slots:
         fmv::EnginePosition original = pos;
 
         // 5五歩が5四の相手歩を取る: (4,4)→(4,3)
-        fmv::Move move;
-        move.kind = fmv::MoveKind::Board;
-        move.from = fmv::toSquare(4, 4);
-        move.to = fmv::toSquare(4, 3);
-        move.piece = fmv::PieceType::Pawn;
-        move.promote = false;
+        const fmv::Move move =
+            fmv::Move::makeBoard(fmv::toSquare(4, 4), fmv::toSquare(4, 3), fmv::PieceType::Pawn);
 
         fmv::UndoState undo;
         bool ok = pos.doMove(move, fmv::Color::Black, undo);
@@ -111,12 +141,8 @@ private slots:
         fmv::EnginePosition original = pos;
 
         // (4,3)→(4,2) 成り
-        fmv::Move move;
-        move.kind = fmv::MoveKind::Board;
-        move.from = fmv::toSquare(4, 3);
-        move.to = fmv::toSquare(4, 2);
-        move.piece = fmv::PieceType::Pawn;
-        move.promote = true;
+        const fmv::Move move =
+            fmv::Move::makeBoard(fmv::toSquare(4, 3), fmv::toSquare(4, 2), fmv::PieceType::Pawn, true);
 
         fmv::UndoState undo;
         bool ok = pos.doMove(move, fmv::Color::Black, undo);
@@ -143,12 +169,7 @@ private slots:
         fmv::EnginePosition original = pos;
 
         // 銀打ち: (4,4)
-        fmv::Move move;
-        move.kind = fmv::MoveKind::Drop;
-        move.from = fmv::kInvalidSquare;
-        move.to = fmv::toSquare(4, 4);
-        move.piece = fmv::PieceType::Silver;
-        move.promote = false;
+        const fmv::Move move = fmv::Move::makeDrop(fmv::PieceType::Silver, fmv::toSquare(4, 4));
 
         fmv::UndoState undo;
         bool ok = pos.doMove(move, fmv::Color::Black, undo);
@@ -188,12 +209,7 @@ private slots:
 
         fmv::UndoState undos[3];
         for (int i = 0; i < 3; ++i) {
-            fmv::Move m;
-            m.kind = fmv::MoveKind::Board;
-            m.from = moves[i].from;
-            m.to = moves[i].to;
-            m.piece = moves[i].piece;
-            m.promote = false;
+            const fmv::Move m = fmv::Move::makeBoard(moves[i].from, moves[i].to, moves[i].piece);
             bool ok = pos.doMove(m, moves[i].side, undos[i]);
             QVERIFY(ok);
             verifyBitboardConsistency(pos);
@@ -207,6 +223,77 @@ private slots:
 
         QCOMPARE(pos.board, original.board);
     }
+
+    void zobrist_rebuildMatchesRecompute()
+    {
+        ShogiBoard board;
+        board.setSfen(kHirateSfen);
+
+        fmv::EnginePosition pos;
+        fmv::Converter::toEnginePosition(pos, board.boardData(), board.pieceStand());
+
+        QVERIFY(pos.zobristKey != 0ULL);
+        QCOMPARE(pos.zobristKey, pos.computeZobristKey(fmv::Color::Black));
+        QCOMPARE(pos.computeZobristKey(fmv::Color::White),
+                 pos.zobristKey ^ fmv::zobrist::sideKey());
+    }
+
+    void zobrist_incrementalMatchesRecompute_data()
+    {
+        QTest::addColumn<QString>("sfen");
+        QTest::addColumn<int>("depth");
+
+        QTest::newRow("hirate") << kHirateSfen << 3;
+        // 駒取り・成り・打ちが多数含まれる局面
+        QTest::newRow("matsuri")
+            << QStringLiteral("l6nl/5+P1gk/2np1S3/p1p4Pp/3P2Sp1/1PPb2P1P/P5GS1/R8/LN4bKL w RGgsn5p 1")
+            << 2;
+    }
+
+    void zobrist_incrementalMatchesRecompute()
+    {
+        QFETCH(QString, sfen);
+        QFETCH(int, depth);
+
+        ShogiBoard board;
+        board.setSfen(sfen);
+        const fmv::Color side = sfen.contains(QStringLiteral(" w ")) ? fmv::Color::White
+                                                                      : fmv::Color::Black;
+
+        fmv::EnginePosition pos;
+        fmv::Converter::toEnginePosition(pos, board.boardData(), board.pieceStand());
+        pos.zobristKey = pos.computeZobristKey(side);
+
+        fmv::LegalCore core;
+        QCOMPARE(countZobristMismatches(pos, side, core, depth), 0);
+    }
+
+    void zobrist_transpositionYieldsSameKey()
+    {
+        ShogiBoard board;
+        board.setSfen(kHirateSfen);
+
+        fmv::EnginePosition a;
+        fmv::Converter::toEnginePosition(a, board.boardData(), board.pieceStand());
+        fmv::EnginePosition b = a;
+
+        // 7六歩 → 3四歩 → 2六歩 と 2六歩 → 3四歩 → 7六歩 は同一局面
+        const fmv::Move p76 = boardMove(6, 6, 6, 5, fmv::PieceType::Pawn);
+        const fmv::Move p34 = boardMove(2, 2, 2, 3, fmv::PieceType::Pawn);
+        const fmv::Move p26 = boardMove(1, 6, 1, 5, fmv::PieceType::Pawn);
+
+        fmv::UndoState undo;
+        QVERIFY(a.doMove(p76, fmv::Color::Black, undo));
+        QVERIFY(a.doMove(p34, fmv::Color::White, undo));
+        QVERIFY(a.doMove(p26, fmv::Color::Black, undo));
+
+        QVERIFY(b.doMove(p26, fmv::Color::Black, undo));
+        QVERIFY(b.doMove(p34, fmv::Color::White, undo));
+        QVERIFY(b.doMove(p76, fmv::Color::Black, undo));
+
+        QCOMPARE(a.board, b.board);
+        QCOMPARE(a.zobristKey, b.zobristKey);
+    }
 };
 
 QTEST_MAIN(TestFmvPosition)
@@ -0,0 +1,95 @@
+/// @file tst_infolinecoalescer.cpp
+/// @brief InfoLineCoalescer（info行の間引き）のユニットテスト
+
+#include <QtTest>
+
+#include "infolinecoalescer.h"
+
+class TestInfoLineCoalescer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void scan_readsMultipvAndScoreKind()
+    {
+        using Kind = InfoLineCoalescer::ScoreKind;
+
+        auto s = InfoLineCoalescer::scan(u"info depth 12 multipv 3 score cp -40 nodes 100 pv 7g7f 3c3d");
+        QCOMPARE(s.multipv, 3);
+        QCOMPARE(s.scoreKind, Kind::Exact);
+        QVERIFY(s.hasPv);
+
+        s = InfoLineCoalescer::scan(u"info depth 12 score cp 80 lowerbound pv 2g2f");
+        QCOMPARE(s.multipv, 1);
+        QCOMPARE(s.scoreKind, Kind::LowerBound);
+
+        QCOMPARE(InfoLineCoalescer::scan(u"info score cp 80 upperbound").scoreKind, Kind::UpperBound);
+        QCOMPARE(InfoLineCoalescer::scan(u"info score mate + pv 5e5a").scoreKind, Kind::MateWin);
+        QCOMPARE(InfoLineCoalescer::scan(u"info score mate -3 pv 5e5a").scoreKind, Kind::MateLoss);
+
+        // string 以降に multipv / score の文字列があっても読まない
+        s = InfoLineCoalescer::scan(u"info string multipv 4 score cp 10");
+        QVERIFY(s.isString);
+        QCOMPARE(s.multipv, 1);
+        QCOMPARE(s.scoreKind, Kind::None);
+
+        s = InfoLineCoalescer::scan(u"info depth 3 nodes 500 nps 1000 hashfull 10");
+        QVERIFY(!s.hasPv);
+        QCOMPARE(s.scoreKind, Kind::None);
+    }
+
+    void select_keepsLatestLinePerMultipv()
+    {
+        const QStringList batch = {
+            QStringLiteral("info depth 10 multipv 1 score cp 30 pv 7g7f"),
+            QStringLiteral("info depth 10 multipv 2 score cp 10 pv 2g2f"),
+            QStringLiteral("info depth 11 multipv 1 score cp 35 pv 7g7f 3c3d"),
+            QString(),
+            QStringLiteral("info depth 11 multipv 2 score cp 12 pv 2g2f 8c8d"),
+            QStringLiteral("info depth 12 multipv 1 score cp 40 pv 7g7f 3c3d 2g2f"),
+        };
+        InfoLineCoalescer coalescer;
+        QCOMPARE(coalescer.select(batch), (QList<qsizetype>{4, 5}));
+    }
+
+    void select_keepsBoundAndMateTransitions()
+    {
+        const QStringList batch = {
+            QStringLiteral("info depth 10 score cp 30 pv 7g7f"),
+            QStringLiteral("info depth 11 score cp 60 lowerbound pv 7g7f"),
+            QStringLiteral("info depth 11 score cp 70 lowerbound pv 7g7f"),
+            QStringLiteral("info depth 11 score cp 65 pv 7g7f"),
+            QStringLiteral("info depth 12 score mate 9 pv 7g7f"),
+            QStringLiteral("info depth 13 score mate 7 pv 7g7f"),
+        };
+        InfoLineCoalescer coalescer;
+        QCOMPARE(coalescer.select(batch), (QList<qsizetype>{1, 3, 4, 5}));
+
+        // 種類の履歴はバッチをまたいで引き継ぎ、reset() で消える
+        const QStringList next = {
+            QStringLiteral("info depth 14 score cp 900 pv 7g7f"),
+            QStringLiteral("info depth 15 score cp 950 pv 7g7f"),
+        };
+        InfoLineCoalescer carried = coalescer;
+        QCOMPARE(carried.select(next), (QList<qsizetype>{0, 1}));
+        coalescer.reset();
+        QCOMPARE(coalescer.select(next), (QList<qsizetype>{1}));
+    }
+
+    void select_keepsStringsAndTrailingStatusLine()
+    {
+        const QStringList batch = {
+            QStringLiteral("info depth 10 score cp 30 pv 7g7f"),
+            QStringLiteral("info string book hit"),
+            QStringLiteral("info depth 11 score cp 32 pv 7g7f"),
+            QStringLiteral("info nodes 100000 nps 50000 hashfull 20"),
+            QStringLiteral("info nodes 200000 nps 51000 hashfull 21"),
+        };
+        InfoLineCoalescer coalescer;
+        QCOMPARE(coalescer.select(batch), (QList<qsizetype>{1, 2, 4}));
+        QVERIFY(coalescer.select({}).isEmpty());
+    }
+};
+
+QTEST_MAIN(TestInfoLineCoalescer)
+#include "tst_infolinecoalescer.moc"
@@ -4,9 +4,12 @@
 #include <QtTest>
 #include <QTemporaryDir>
 
+#include "josekibook.h"
+#include "josekicorpusbuilder.h"
 #include "josekirepository.h"
 #include "josekipresenter.h"
 #include "josekiwindow.h"  // JosekiMove 構造体
+#include "kifucorpusfiles.h"
 
 class TestJosekiRepository : public QObject
 {
@@ -29,6 +32,21 @@ private:
     static const QString kHirateSfen;
     static const QString kHirateSfenWithPly;
 
+    /// floodgate 形式の CSA 棋譜を書く
+    static bool writeCsaGame(const QString &path, const QString &black, const QString &white, int blackRate,
+                             int whiteRate, const QStringList &moves)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return false;
+        QByteArray text = "V2.2\nN+" + black.toUtf8() + "\nN-" + white.toUtf8() + "\n";
+        text += "'black_rate:" + black.toUtf8() + "+0123:" + QByteArray::number(blackRate) + ".0\n";
+        text += "'white_rate:" + white.toUtf8() + "+4567:" + QByteArray::number(whiteRate) + ".0\n";
+        text += "PI\n+\n";
+        for (const QString &move : moves) text += move.toUtf8() + "\n";
+        text += "%TORYO\n";
+        return file.write(text) == text.size();
+    }
+
 private slots:
     // --- CRUD ---
     void initialState_isEmpty();
@@ -45,12 +63,28 @@ private slots:
     // --- File I/O ---
     void saveAndLoad_roundTrip();
     void parseFromFile_invalidPath_failsGracefully();
+    void parseFromFile_chunked_mergesAcrossChunks();
+    void parseFromFile_progressAndCancel();
     void serializeToFile_writesExpectedFormat();
 
+    // --- Binary book ---
+    void bookMoveCode_roundTrip();
+    void bookConvert_textRoundTrip();
+    void bookLoad_lookupAndEditOverlay();
+    void bookSave_appendsJournalAndReplays();
+    void bookSave_compactsLargeJournal();
+    void markSaved_keepsEditsMadeDuringSave();
+
     // --- Merge ---
     void registerMergeMove_newEntry_addsWithFrequency1();
     void registerMergeMove_existing_incrementsFrequency();
     void ensureSfenWithPly_registersOnce();
+    void mergeCorpusTally_addsFrequenciesAndNewMoves();
+
+    // --- Corpus build ---
+    void corpusBuild_tallyAcrossFormats();
+    void corpusBuild_filtersByRatingPlayerAndPly();
+    void corpusBuild_cancel();
 
     // --- JosekiPresenter static ---
     void normalizeSfen_removesPlyNumber();
@@ -257,6 +291,77 @@ void TestJosekiRepository::parseFromFile_invalidPath_failsGracefully()
     QVERIFY(!result.errorMessage.isEmpty());
 }
 
+void TestJosekiRepository::parseFromFile_chunked_mergesAcrossChunks()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString filePath = tmpDir.path() + QStringLiteral("/large.db");
+
+    // チャンク分割される大きさ（数MB）にし、BOM・CRLF・コメント行・離れた位置の重複局面を含める
+    constexpr int kPositionCount = 40000;
+    const auto sfenOf = [](int i) {
+        return QStringLiteral("lnsgkgsnl/9/9/9/9/9/9/9/%1 b - %2").arg(i, 8, 10, QLatin1Char('0')).arg(i + 1);
+    };
+    QByteArray text("\xEF\xBB\xBF#YANEURAOU-DB2016 1.00\r\n");
+    for (int i = 0; i < kPositionCount; ++i) {
+        text += "sfen " + sfenOf(i).toUtf8() + "\r\n";
+        text += "7g7f none " + QByteArray::number(i) + " 0 1\r\n";
+    }
+    text += "sfen " + sfenOf(0).toUtf8() + "\r\n";
+    text += "2g2f 8c8d 5 6 7 second\r\n";
+    text += "#extra\r\n";
+    {
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(text);
+    }
+    QVERIFY(text.size() > 2 * (1 << 20));
+
+    const JosekiLoadResult result = JosekiRepository::parseFromFile(filePath);
+    QVERIFY(result.success);
+    QCOMPARE(result.positionCount, kPositionCount);
+
+    const QString first = sfenOf(0).section(QLatin1Char(' '), 0, 2);
+    QCOMPARE(result.sfenWithPlyMap.value(first), sfenOf(0));
+    const QList<JosekiMove> firstMoves = result.josekiData.value(first);
+    QCOMPARE(firstMoves.size(), 2);
+    QCOMPARE(firstMoves[0].move, QStringLiteral("7g7f"));
+    QCOMPARE(firstMoves[1].move, QStringLiteral("2g2f"));
+    QCOMPARE(firstMoves[1].nextMove, QStringLiteral("8c8d"));
+    QCOMPARE(firstMoves[1].frequency, 7);
+    QCOMPARE(firstMoves[1].comment, QStringLiteral("second extra"));
+
+    const QString last = sfenOf(kPositionCount - 1).section(QLatin1Char(' '), 0, 2);
+    QCOMPARE(result.josekiData.value(last).size(), 1);
+    QCOMPARE(result.josekiData.value(last).first().value, kPositionCount - 1);
+}
+
+void TestJosekiRepository::parseFromFile_progressAndCancel()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString filePath = tmpDir.path() + QStringLiteral("/progress.db");
+
+    JosekiRepository repo;
+    repo.addMove(kHirateSfen, makeMove(QStringLiteral("7g7f"), 30, 10, 100));
+    repo.ensureSfenWithPly(kHirateSfen, kHirateSfenWithPly);
+    QVERIFY(repo.saveToFile(filePath));
+
+    int lastPercent = -1;
+    const JosekiLoadResult loaded = JosekiRepository::parseFromFile(filePath, [&lastPercent](int percent) {
+        lastPercent = percent;
+        return true;
+    });
+    QVERIFY(loaded.success);
+    QCOMPARE(lastPercent, 100);
+
+    // 中断はエラーメッセージなしの失敗になる
+    const JosekiLoadResult cancelled = JosekiRepository::parseFromFile(filePath, [](int) { return false; });
+    QVERIFY(!cancelled.success);
+    QVERIFY(cancelled.errorMessage.isEmpty());
+    QVERIFY(cancelled.josekiData.isEmpty());
+}
+
 void TestJosekiRepository::serializeToFile_writesExpectedFormat()
 {
     QTemporaryDir tmpDir;
@@ -287,6 +392,252 @@ void TestJosekiRepository::serializeToFile_writesExpectedFormat()
     QVERIFY(content.contains(QStringLiteral("7g7f none 30 10 100")));
 }
 
+// =============================================================
+// バイナリ定跡テスト
+// =============================================================
+
+void TestJosekiRepository::bookMoveCode_roundTrip()
+{
+    const QStringList moves = {
+        QStringLiteral("7g7f"), QStringLiteral("8h2b+"), QStringLiteral("1a9i"), QStringLiteral("P*5e"),
+        QStringLiteral("R*1a"), QStringLiteral("none"), QStringLiteral("resign"), QStringLiteral("win"),
+    };
+    for (const QString &usi : moves) {
+        quint16 code = 0;
+        QVERIFY2(JosekiBook::encodeMove(usi, code), qPrintable(usi));
+        QCOMPARE(JosekiBook::decodeMove(code), usi);
+    }
+
+    quint16 code = 0;
+    QVERIFY(!JosekiBook::encodeMove(QStringLiteral("7g7g"), code));
+    QVERIFY(!JosekiBook::encodeMove(QStringLiteral("K*5e"), code));
+    QVERIFY(!JosekiBook::encodeMove(QStringLiteral("0a1b"), code));
+}
+
+void TestJosekiRepository::bookConvert_textRoundTrip()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString textPath = tmpDir.path() + QStringLiteral("/source.db");
+    const QString bookPath = tmpDir.path() + QStringLiteral("/book.jbk");
+    const QString backPath = tmpDir.path() + QStringLiteral("/back.db");
+
+    const QString secondSfen = QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/2P6/PP1PPPPPP/1B5R1/LNSGKGSNL w -");
+    QMap<QString, QList<JosekiMove>> data;
+    data[kHirateSfen] = {makeMove(QStringLiteral("7g7f"), 30, 10, 100, QStringLiteral("角道")),
+                         makeMove(QStringLiteral("2g2f"), -10, 8, 50)};
+    data[secondSfen] = {makeMove(QStringLiteral("3c3d"), 0, 5, 20), makeMove(QStringLiteral("8c8d"), 5, 5, 2)};
+    QMap<QString, QString> sfenMap;
+    sfenMap[kHirateSfen] = kHirateSfenWithPly;
+    sfenMap[secondSfen] = secondSfen + QStringLiteral(" 2");
+    QVERIFY(JosekiRepository::serializeToFile(textPath, data, sfenMap).success);
+
+    const JosekiSaveResult converted = JosekiBook::convertTextToBook(textPath, bookPath);
+    QVERIFY2(converted.success, qPrintable(converted.errorMessage));
+    QCOMPARE(converted.savedCount, 2);
+    QVERIFY(JosekiBook::isBookFile(bookPath));
+    QVERIFY(!JosekiBook::isBookFile(textPath));
+
+    JosekiBook book;
+    QVERIFY(book.open(bookPath));
+    QCOMPARE(book.positionCount(), 2);
+    QCOMPARE(book.moveCount(), 4);
+    const int hirate = book.findPosition(kHirateSfen);
+    QVERIFY(hirate >= 0);
+    QCOMPARE(book.sfenWithPlyAt(hirate), kHirateSfenWithPly);
+    const QList<JosekiMove> moves = book.movesAt(hirate);
+    QCOMPARE(moves.size(), 2);
+    QCOMPARE(moves[0].move, QStringLiteral("7g7f"));
+    QCOMPARE(moves[0].nextMove, QStringLiteral("none"));
+    QCOMPARE(moves[0].value, 30);
+    QCOMPARE(moves[0].depth, 10);
+    QCOMPARE(moves[0].frequency, 100);
+    QCOMPARE(moves[0].comment, QStringLiteral("角道"));
+    QCOMPARE(moves[1].value, -10);
+    QCOMPARE(book.findPosition(kHirateSfen.left(kHirateSfen.size() - 3) + QStringLiteral("w -")), -1);
+
+    // テキストに戻すと同じ内容になる
+    const JosekiSaveResult back = JosekiBook::convertBookToText(bookPath, backPath);
+    QVERIFY2(back.success, qPrintable(back.errorMessage));
+    const JosekiLoadResult reloaded = JosekiRepository::parseFromFile(backPath);
+    QVERIFY(reloaded.success);
+    QCOMPARE(reloaded.sfenWithPlyMap, sfenMap);
+    QCOMPARE(reloaded.josekiData.keys(), data.keys());
+    for (const QString &sfen : data.keys()) {
+        const QList<JosekiMove> &expected = data[sfen];
+        const QList<JosekiMove> &actual = reloaded.josekiData[sfen];
+        QCOMPARE(actual.size(), expected.size());
+        for (int i = 0; i < expected.size(); ++i) {
+            QCOMPARE(actual[i].move, expected[i].move);
+            QCOMPARE(actual[i].frequency, expected[i].frequency);
+            QCOMPARE(actual[i].comment, expected[i].comment);
+        }
+    }
+}
+
+void TestJosekiRepository::bookLoad_lookupAndEditOverlay()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString bookPath = tmpDir.path() + QStringLiteral("/book.jbk");
+    const QString editedPath = tmpDir.path() + QStringLiteral("/edited.jbk");
+    const QString secondSfen = QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL w -");
+
+    JosekiRepository repoSave;
+    repoSave.addMove(kHirateSfen, makeMove(QStringLiteral("7g7f"), 30, 10, 100));
+    repoSave.ensureSfenWithPly(kHirateSfen, kHirateSfenWithPly);
+    repoSave.addMove(secondSfen, makeMove(QStringLiteral("3c3d"), 0, 5, 20));
+    QVERIFY(repoSave.saveToFile(bookPath));
+
+    // バイナリ定跡は読み込まずにマップし、局面ごとに引く
+    JosekiRepository repo;
+    QVERIFY(repo.loadFromFile(bookPath));
+    QVERIFY(repo.hasBook());
+    QVERIFY(repo.josekiData().isEmpty());
+    QCOMPARE(repo.positionCount(), 2);
+    QVERIFY(repo.containsPosition(kHirateSfen));
+    QCOMPARE(repo.movesForPosition(kHirateSfen).size(), 1);
+    QCOMPARE(repo.movesForPosition(kHirateSfen)[0].frequency, 100);
+    QCOMPARE(repo.sfenWithPly(kHirateSfen), kHirateSfenWithPly);
+
+    // 編集した局面だけがインメモリに写る
+    repo.addMove(kHirateSfen, makeMove(QStringLiteral("2g2f"), -10, 8, 50));
+    repo.deleteMove(secondSfen, 0);
+    QCOMPARE(repo.josekiData().size(), 1);
+    QCOMPARE(repo.movesForPosition(kHirateSfen).size(), 2);
+    QVERIFY(!repo.containsPosition(secondSfen));
+    QCOMPARE(repo.positionCount(), 1);
+
+    QVERIFY(repo.saveToFile(editedPath));
+    JosekiRepository repoLoad;
+    QVERIFY(repoLoad.loadFromFile(editedPath));
+    QCOMPARE(repoLoad.positionCount(), 1);
+    QVERIFY(!repoLoad.containsPosition(secondSfen));
+    const QList<JosekiMove> &moves = repoLoad.movesForPosition(kHirateSfen);
+    QCOMPARE(moves.size(), 2);
+    QCOMPARE(moves[1].move, QStringLiteral("2g2f"));
+    QCOMPARE(moves[1].value, -10);
+}
+
+void TestJosekiRepository::bookSave_appendsJournalAndReplays()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString bookPath = tmpDir.path() + QStringLiteral("/book.jbk");
+    const QString secondSfen = QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL w -");
+
+    JosekiRepository repoSave;
+    repoSave.addMove(kHirateSfen, makeMove(QStringLiteral("7g7f"), 30, 10, 100));
+    repoSave.ensureSfenWithPly(kHirateSfen, kHirateSfenWithPly);
+    repoSave.addMove(secondSfen, makeMove(QStringLiteral("3c3d"), 0, 5, 20));
+    QVERIFY(repoSave.saveToFile(bookPath));
+    QVERIFY(!repoSave.hasUnsavedChanges());
+
+    QFile bookFile(bookPath);
+    QVERIFY(bookFile.open(QIODevice::ReadOnly));
+    const QByteArray bookBytes = bookFile.readAll();
+    bookFile.close();
+
+    // ブック自身への保存は変更局面をジャーナルに足すだけで、ブックは書き換えない
+    JosekiRepository repo;
+    QVERIFY(repo.loadFromFile(bookPath));
+    repo.addMove(kHirateSfen, makeMove(QStringLiteral("2g2f"), -10, 8, 50, QStringLiteral("居飛車")));
+    repo.deleteMove(secondSfen, 0);
+    QVERIFY(repo.hasUnsavedChanges());
+    QVERIFY(repo.saveToFile(bookPath));
+    QVERIFY(!repo.hasUnsavedChanges());
+    QVERIFY(QFile::exists(JosekiBook::journalPath(bookPath)));
+    QVERIFY(bookFile.open(QIODevice::ReadOnly));
+    QCOMPARE(bookFile.readAll(), bookBytes);
+    bookFile.close();
+
+    // 途中で切れたレコードは読み飛ばす
+    QFile journal(JosekiBook::journalPath(bookPath));
+    QVERIFY(journal.open(QIODevice::Append));
+    journal.write(QByteArray("\x40\x00\x00\x00garbage", 11));
+    journal.close();
+
+    JosekiRepository repoLoad;
+    QVERIFY(repoLoad.loadFromFile(bookPath));
+    QCOMPARE(repoLoad.positionCount(), 1);
+    QVERIFY(!repoLoad.containsPosition(secondSfen));
+    const QList<JosekiMove> &moves = repoLoad.movesForPosition(kHirateSfen);
+    QCOMPARE(moves.size(), 2);
+    QCOMPARE(moves[1].move, QStringLiteral("2g2f"));
+    QCOMPARE(moves[1].comment, QStringLiteral("居飛車"));
+    QCOMPARE(repoLoad.sfenWithPly(kHirateSfen), kHirateSfenWithPly);
+
+    // 続けて保存すると壊れた末尾を切り詰めてから足す
+    repoLoad.updateMove(kHirateSfen, QStringLiteral("7g7f"), 40, 12, 101, QString());
+    QVERIFY(repoLoad.saveToFile(bookPath));
+    JosekiRepository repoReload;
+    QVERIFY(repoReload.loadFromFile(bookPath));
+    QCOMPARE(repoReload.movesForPosition(kHirateSfen).size(), 2);
+    QCOMPARE(repoReload.movesForPosition(kHirateSfen)[0].value, 40);
+    QVERIFY(!repoReload.containsPosition(secondSfen));
+
+    // テキストへの変換にもジャーナルの内容が入る
+    const QString textPath = tmpDir.path() + QStringLiteral("/book.db");
+    QVERIFY(JosekiBook::convertBookToText(bookPath, textPath).success);
+    JosekiRepository repoText;
+    QVERIFY(repoText.loadFromFile(textPath));
+    QCOMPARE(repoText.positionCount(), 1);
+    QCOMPARE(repoText.movesForPosition(kHirateSfen)[0].frequency, 101);
+}
+
+void TestJosekiRepository::bookSave_compactsLargeJournal()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString bookPath = tmpDir.path() + QStringLiteral("/book.jbk");
+
+    JosekiRepository repoSave;
+    repoSave.addMove(kHirateSfen, makeMove(QStringLiteral("7g7f"), 30, 10, 100));
+    QVERIFY(repoSave.saveToFile(bookPath));
+
+    // ジャーナルが大きくなる保存はブック全体の書き直しになり、ジャーナルは消える
+    JosekiRepository repo;
+    QVERIFY(repo.loadFromFile(bookPath));
+    const QString longComment(300 * 1024, QLatin1Char('x'));
+    repo.addMove(kHirateSfen, makeMove(QStringLiteral("2g2f"), -10, 8, 50, longComment));
+    const JosekiSaveResult result = JosekiRepository::saveSnapshot(bookPath, repo.snapshot());
+    QVERIFY(result.success);
+    QVERIFY(result.compacted);
+
+    // マップ中のブックは置き換えず隣に書き、ブックを閉じてから差し替える
+    QCOMPARE(result.stagedBookPath, JosekiBook::stagedPath(bookPath));
+    QVERIFY(repo.installStagedBook(bookPath));
+    QVERIFY(!QFile::exists(JosekiBook::stagedPath(bookPath)));
+    QVERIFY(!QFile::exists(JosekiBook::journalPath(bookPath)));
+    QVERIFY(repo.hasBook());
+    QCOMPARE(repo.movesForPosition(kHirateSfen).size(), 2);
+
+    JosekiRepository repoLoad;
+    QVERIFY(repoLoad.loadFromFile(bookPath));
+    QVERIFY(repoLoad.josekiData().isEmpty());
+    QCOMPARE(repoLoad.movesForPosition(kHirateSfen).size(), 2);
+    QCOMPARE(repoLoad.movesForPosition(kHirateSfen)[1].comment, longComment);
+}
+
+void TestJosekiRepository::markSaved_keepsEditsMadeDuringSave()
+{
+    const QString secondSfen = QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL w -");
+    JosekiRepository repo;
+    QVERIFY(!repo.hasUnsavedChanges());
+    repo.addMove(kHirateSfen, makeMove(QStringLiteral("7g7f")));
+    const JosekiSnapshot saving = repo.snapshot();
+    QCOMPARE(saving.dirtyPositions, QSet<QString>{kHirateSfen});
+
+    // スナップショットのあとに編集した局面は未保存のまま残る
+    repo.addMove(secondSfen, makeMove(QStringLiteral("3c3d")));
+    repo.markSaved(QStringLiteral("unused.db"), saving.editSerial);
+    QVERIFY(repo.hasUnsavedChanges());
+    QCOMPARE(repo.snapshot().dirtyPositions, QSet<QString>{secondSfen});
+
+    repo.markSaved(QStringLiteral("unused.db"), repo.snapshot().editSerial);
+    QVERIFY(!repo.hasUnsavedChanges());
+}
+
 // =============================================================
 // マージ操作テスト
 // =============================================================
@@ -335,6 +686,134 @@ void TestJosekiRepository::ensureSfenWithPly_registersOnce()
     QCOMPARE(repo.sfenWithPly(kHirateSfen), ply1);
 }
 
+void TestJosekiRepository::mergeCorpusTally_addsFrequenciesAndNewMoves()
+{
+    JosekiRepository repo;
+    repo.addMove(kHirateSfen, makeMove(QStringLiteral("7g7f"), 30, 10, 5));
+    repo.markSaved(QStringLiteral("unused.db"), repo.snapshot().editSerial);
+
+    const QString nextSfen = QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/2P6/PP1PPPPPP/1B5R1/LNSGKGSNL w -");
+    JosekiCorpusTally tally;
+    tally[kHirateSfen].sfenWithPly = kHirateSfenWithPly;
+    tally[kHirateSfen].moveCounts = {{QStringLiteral("7g7f"), 3}, {QStringLiteral("5g5f"), 1},
+                                     {QStringLiteral("2g2f"), 4}};
+    tally[nextSfen].sfenWithPly = nextSfen + QStringLiteral(" 2");
+    tally[nextSfen].moveCounts = {{QStringLiteral("3c3d"), 2}};
+
+    QCOMPARE(repo.mergeCorpusTally(tally), 2);
+
+    // 既存の手は頻度を足し、新しい手は出現数の多い順に後ろへ並ぶ
+    const QList<JosekiMove> moves = repo.movesForPosition(kHirateSfen);
+    QCOMPARE(moves.size(), 3);
+    QCOMPARE(moves[0].move, QStringLiteral("7g7f"));
+    QCOMPARE(moves[0].frequency, 8);
+    QCOMPARE(moves[0].value, 30);
+    QCOMPARE(moves[1].move, QStringLiteral("2g2f"));
+    QCOMPARE(moves[1].frequency, 4);
+    QCOMPARE(moves[2].move, QStringLiteral("5g5f"));
+    QCOMPARE(moves[2].nextMove, QStringLiteral("none"));
+
+    QCOMPARE(repo.movesForPosition(nextSfen).first().frequency, 2);
+    QCOMPARE(repo.sfenWithPly(nextSfen), nextSfen + QStringLiteral(" 2"));
+    QCOMPARE(repo.snapshot().dirtyPositions, (QSet<QString>{kHirateSfen, nextSfen}));
+}
+
+// =============================================================
+// 棋譜フォルダからの一括集計テスト
+// =============================================================
+
+void TestJosekiRepository::corpusBuild_tallyAcrossFormats()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QVERIFY(QDir(tmpDir.path()).mkdir(QStringLiteral("sub")));
+
+    // 同じ7手の対局を6形式で置く（USI だけサブフォルダ）
+    const QString fixtures = QCoreApplication::applicationDirPath() + QStringLiteral("/fixtures/");
+    for (const QString &suffix : {QStringLiteral("kif"), QStringLiteral("ki2"), QStringLiteral("csa"),
+                                  QStringLiteral("jkf"), QStringLiteral("usen")}) {
+        QVERIFY(QFile::copy(fixtures + QStringLiteral("test_basic.") + suffix,
+                            tmpDir.path() + QStringLiteral("/game.") + suffix));
+    }
+    QVERIFY(QFile::copy(fixtures + QStringLiteral("test_basic.usi"), tmpDir.path() + QStringLiteral("/sub/game.usi")));
+    QFile note(tmpDir.path() + QStringLiteral("/readme.txt"));
+    QVERIFY(note.open(QIODevice::WriteOnly));
+    note.write("not a kifu");
+    note.close();
+
+    QCOMPARE(KifuCorpusFiles::collectFiles(tmpDir.path(), false).size(), 5);
+    QCOMPARE(KifuCorpusFiles::collectFiles(tmpDir.path() + QStringLiteral("/game.k*"), false).size(), 2);
+    const QStringList files = KifuCorpusFiles::collectFiles(tmpDir.path(), true);
+    QCOMPARE(files.size(), 6);
+
+    JosekiCorpusBuilder::Options options;
+    options.maxPly = 0;
+    int lastPercent = -1;
+    const JosekiCorpusBuilder::Result result = JosekiCorpusBuilder::build(files, options, [&lastPercent](int percent) {
+        lastPercent = percent;
+        return true;
+    });
+    QVERIFY(!result.cancelled);
+    QCOMPARE(lastPercent, 100);
+    QCOMPARE(result.stats.fileCount, 6);
+    QCOMPARE(result.stats.gameCount, 6);
+    QCOMPARE(result.stats.failedCount, 0);
+    QCOMPARE(result.stats.moveCount, qint64(6 * 7));
+    QCOMPARE(result.stats.positionCount, 7);
+
+    const JosekiPositionTally first = result.tally.value(kHirateSfen);
+    QCOMPARE(first.sfenWithPly, kHirateSfenWithPly);
+    QCOMPARE(first.moveCounts.value(QStringLiteral("7g7f")), 6);
+    QCOMPARE(first.moveCounts.size(), 1);
+}
+
+void TestJosekiRepository::corpusBuild_filtersByRatingPlayerAndPly()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QStringList moves = {QStringLiteral("+7776FU"), QStringLiteral("-3334FU"), QStringLiteral("+2726FU"),
+                               QStringLiteral("-8384FU")};
+    QVERIFY(writeCsaGame(tmpDir.filePath(QStringLiteral("a.csa")), QStringLiteral("Alpha"), QStringLiteral("Beta"),
+                         2800, 2600, moves));
+    QVERIFY(writeCsaGame(tmpDir.filePath(QStringLiteral("b.csa")), QStringLiteral("Gamma"), QStringLiteral("Alpha"),
+                         2900, 2700, moves));
+    QVERIFY(writeCsaGame(tmpDir.filePath(QStringLiteral("c.csa")), QStringLiteral("Delta"), QStringLiteral("Gamma"),
+                         1500, 2900, moves));
+    const QStringList files = KifuCorpusFiles::collectFiles(tmpDir.path(), false);
+    QCOMPARE(files.size(), 3);
+
+    // レーティングは両対局者に求める
+    JosekiCorpusBuilder::Options options;
+    options.minRating = 2500;
+    JosekiCorpusBuilder::Result result = JosekiCorpusBuilder::build(files, options);
+    QCOMPARE(result.stats.gameCount, 2);
+    QCOMPARE(result.stats.filteredCount, 1);
+    QCOMPARE(result.tally.value(kHirateSfen).moveCounts.value(QStringLiteral("7g7f")), 2);
+
+    // 対局者の指し手だけ・手数範囲
+    options = {};
+    options.players = {QStringLiteral("alpha")};
+    options.playerMovesOnly = true;
+    options.minPly = 2;
+    options.maxPly = 3;
+    result = JosekiCorpusBuilder::build(files, options);
+    QCOMPARE(result.stats.gameCount, 2);
+    QCOMPARE(result.stats.filteredCount, 1);
+    // a.csa では先手の3手目、b.csa では後手の2手目だけを数える
+    QCOMPARE(result.stats.moveCount, qint64(2));
+    QVERIFY(!result.tally.contains(kHirateSfen));
+    QCOMPARE(result.stats.positionCount, 2);
+}
+
+void TestJosekiRepository::corpusBuild_cancel()
+{
+    const QString fixture = QCoreApplication::applicationDirPath() + QStringLiteral("/fixtures/test_basic.kif");
+    const JosekiCorpusBuilder::Result result =
+        JosekiCorpusBuilder::build({fixture}, {}, [](int) { return false; });
+    QVERIFY(result.cancelled);
+    QVERIFY(result.tally.isEmpty());
+}
+
 // =============================================================
 // JosekiPresenter static メソッドテスト
 // =============================================================
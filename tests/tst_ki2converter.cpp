@@ -71,8 +71,9 @@ private slots:
         QString error;
         bool ok = Ki2ToSfenConverter::parseWithVariations(
             fixturePath(QStringLiteral("nonexistent.ki2")), result, &error);
-        // KI2 converter reads file internally; non-existent file returns ok=true with 0 moves
-        Q_UNUSED(ok);
+        // KIF 版と同じく、読めないファイルは失敗として返す
+        QVERIFY(!ok);
+        QVERIFY(!error.isEmpty());
         QCOMPARE(result.mainline.usiMoves.size(), 0);
     }
 
@@ -2,6 +2,7 @@
 #include <QCoreApplication>
 
 #include "kiftosfenconverter.h"
+#include "kifreader.h"
 #include "kifdisplayitem.h"
 #include "kifparsetypes.h"
 #include "kifubranchtree.h"
@@ -86,6 +87,48 @@ private slots:
         QCOMPARE(result.variations[1].startPly, 5);
     }
 
+    void parseLines_matchesFileApis_data()
+    {
+        QTest::addColumn<QString>("fixture");
+        QTest::newRow("basic") << QStringLiteral("test_basic.kif");
+        QTest::newRow("branch") << QStringLiteral("test_branch.kif");
+        QTest::newRow("comments") << QStringLiteral("test_comments.kif");
+    }
+
+    void parseLines_matchesFileApis()
+    {
+        QFETCH(QString, fixture);
+        const QString path = fixturePath(fixture);
+
+        QStringList lines;
+        QVERIFY(KifReader::readAllLinesAuto(path, lines));
+        KifParseResult single;
+        QString error;
+        QVERIFY2(KifToSfenConverter::parseLines(lines, single, &error), qPrintable(error));
+
+        // ファイル版の個別APIと同じ初期局面・手合割・対局情報・本譜・変化が1回の解析で得られる
+        QString teaiLabel;
+        QCOMPARE(single.mainline.baseSfen, KifToSfenConverter::detectInitialSfenFromFile(path, &teaiLabel));
+        QCOMPARE(single.teaiLabel, teaiLabel);
+        const QList<KifGameInfoItem> info = KifToSfenConverter::extractGameInfo(path);
+        QCOMPARE(single.gameInfo.size(), info.size());
+        for (qsizetype i = 0; i < info.size(); ++i) {
+            QCOMPARE(single.gameInfo.at(i).key, info.at(i).key);
+            QCOMPARE(single.gameInfo.at(i).value, info.at(i).value);
+        }
+
+        KifParseResult perFile;
+        QVERIFY(KifToSfenConverter::parseWithVariations(path, perFile, &error));
+        QCOMPARE(single.mainline.usiMoves, perFile.mainline.usiMoves);
+        QCOMPARE(single.mainline.sfenList, perFile.mainline.sfenList);
+        QCOMPARE(single.mainline.disp.size(), perFile.mainline.disp.size());
+        QCOMPARE(single.variations.size(), perFile.variations.size());
+        for (qsizetype i = 0; i < single.variations.size(); ++i) {
+            QCOMPARE(single.variations.at(i).startPly, perFile.variations.at(i).startPly);
+            QCOMPARE(single.variations.at(i).line.usiMoves, perFile.variations.at(i).line.usiMoves);
+        }
+    }
+
     void extractGameInfo()
     {
         auto info = KifToSfenConverter::extractGameInfo(
@@ -49,6 +49,34 @@ private slots:
         QCOMPARE(lines, expectedLines);
         QVERIFY2(warn.isEmpty(), qPrintable(warn));
     }
+
+    void decodeLinesAuto_matchesFileRead_data()
+    {
+        QTest::addColumn<QByteArray>("content");
+        QTest::newRow("utf8") << QStringLiteral("手合割：平手\r\n1 ７六歩(77)\r\n").toUtf8();
+        QTest::newRow("utf16le") << QByteArray::fromHex("fffe61000a0062000d000a00");
+        QTest::newRow("empty") << QByteArray();
+    }
+
+    void decodeLinesAuto_matchesFileRead()
+    {
+        QFETCH(QByteArray, content);
+
+        QTemporaryFile file(QDir::tempPath() + QStringLiteral("/kifreader_XXXXXX.txt"));
+        QVERIFY(file.open());
+        QCOMPARE(file.write(content), content.size());
+        file.close();
+
+        QStringList fileLines;
+        QString fileEncoding;
+        QVERIFY(KifReader::readAllLinesAuto(file.fileName(), fileLines, &fileEncoding));
+
+        QStringList lines;
+        QString usedEncoding;
+        KifReader::decodeLinesAuto(content, lines, &usedEncoding);
+        QCOMPARE(usedEncoding, fileEncoding);
+        QCOMPARE(lines, fileLines);
+    }
 };
 
 QTEST_MAIN(TestKifReader)
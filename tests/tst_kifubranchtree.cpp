@@ -4,6 +4,7 @@
 #include "kifubranchtree.h"
 #include "kifubranchnode.h"
 #include "shogimove.h"
+#include "sfenpositiontracer.h"
 
 static const QString kHirateSfen =
     QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL b - 1");
@@ -34,6 +35,71 @@ private:
         tree.addMove(b1, dummyMove, QStringLiteral("△８四歩"), QStringLiteral("branch_sfen2"));
     }
 
+    // Helper: grow a tree with branches at several depths, calling allLines() between edits when asked
+    static void buildBranchyTree(KifuBranchTree& tree, bool queryBetweenEdits)
+    {
+        tree.setRootSfen(kHirateSfen);
+        ShogiMove move;
+        QList<KifuBranchNode*> mainNodes = {tree.root()};
+        for (int i = 1; i <= 30; ++i) {
+            mainNodes.append(tree.addMove(mainNodes.last(), move, QStringLiteral("m%1").arg(i), QString()));
+            if (queryBetweenEdits) tree.allLines();
+        }
+        for (int b = 0; b < 20; ++b) {
+            KifuBranchNode* from = mainNodes.at((b * 7) % 29);
+            KifuBranchNode* node = from;
+            for (int d = 0; d < 3 + b % 4; ++d) {
+                node = tree.addMove(node, move, QStringLiteral("b%1_%2").arg(b).arg(d), QString());
+                if (queryBetweenEdits) tree.allLines();
+            }
+            // Sub-branch inside the previous variation
+            if (b % 3 == 0 && node->parent() != from) {
+                tree.addMove(node->parent(), move, QStringLiteral("s%1").arg(b), QString());
+                if (queryBetweenEdits) tree.allLines();
+            }
+            if (b % 5 == 0) {
+                tree.addTerminalMove(node, TerminalType::Resign, QStringLiteral("投了"));
+                if (queryBetweenEdits) tree.allLines();
+            }
+        }
+    }
+
+    // Helper: apply USI moves to sfen and return the SFEN after each move
+    static QStringList traceSfens(const QString& sfen, const QStringList& usiMoves)
+    {
+        SfenPositionTracer tracer;
+        if (!tracer.setFromSfen(sfen)) return {};
+        QStringList sfens;
+        for (const QString& usi : usiMoves) {
+            if (!tracer.applyUsiMove(usi)) return {};
+            sfens.append(tracer.toSfenString());
+        }
+        return sfens;
+    }
+
+    // Helper: ▲７六歩 △３四歩 ▲２二角成 △同銀 ▲４五角 with real moves and SFENs
+    QList<KifuBranchNode*> buildRealGame(KifuBranchTree& tree, QStringList& sfens)
+    {
+        tree.setRootSfen(kHirateSfen);
+        const QList<ShogiMove> moves = {
+            ShogiMove(QPoint(6, 6), QPoint(6, 5), Piece::BlackPawn, Piece::None, false),
+            ShogiMove(QPoint(2, 2), QPoint(2, 3), Piece::WhitePawn, Piece::None, false),
+            ShogiMove(QPoint(7, 7), QPoint(1, 1), Piece::BlackBishop, Piece::WhiteBishop, true),
+            ShogiMove(QPoint(2, 0), QPoint(1, 1), Piece::WhiteSilver, Piece::BlackHorse, false),
+            ShogiMove(QPoint(9, 0), QPoint(3, 4), Piece::BlackBishop, Piece::None, false),
+        };
+        sfens = QStringList{kHirateSfen}
+              + traceSfens(kHirateSfen, {QStringLiteral("7g7f"), QStringLiteral("3c3d"), QStringLiteral("8h2b+"),
+                                         QStringLiteral("3a2b"), QStringLiteral("B*4e")});
+
+        QList<KifuBranchNode*> nodes = {tree.root()};
+        for (int i = 0; i < moves.size(); ++i) {
+            nodes.append(tree.addMove(nodes.last(), moves.at(i), QStringLiteral("move%1").arg(i + 1),
+                                      sfens.at(i + 1)));
+        }
+        return nodes;
+    }
+
 private slots:
     void setRootSfen()
     {
@@ -152,6 +218,126 @@ private slots:
         QCOMPARE(tree.mainLine().size(), 201);
     }
 
+    void nodeAt_acrossArenaBlocks()
+    {
+        KifuBranchTree tree;
+        tree.setRootSfen(kHirateSfen);
+
+        ShogiMove move;
+        QList<KifuBranchNode*> nodes = {tree.root()};
+        for (int i = 0; i < 600; ++i) {
+            nodes.append(tree.addMove(nodes.last(), move, QStringLiteral("move%1").arg(i),
+                                      QStringLiteral("sfen%1").arg(i)));
+            QVERIFY(nodes.last() != nullptr);
+        }
+
+        // Earlier nodes keep their address while the tree grows
+        QCOMPARE(tree.nodeCount(), 601);
+        for (KifuBranchNode* node : std::as_const(nodes)) {
+            QCOMPARE(tree.nodeAt(node->nodeId()), node);
+        }
+        QCOMPARE(nodes.at(300)->parent(), nodes.at(299));
+        QCOMPARE(nodes.at(300)->sfen(), QStringLiteral("sfen299"));
+        QVERIFY(tree.nodeAt(0) == nullptr);
+        QVERIFY(tree.nodeAt(602) == nullptr);
+
+        tree.setRootSfen(kHirateSfen);
+        QCOMPARE(tree.nodeCount(), 1);
+        QCOMPARE(tree.root()->nodeId(), 1);
+        QCOMPARE(tree.root()->childCount(), 0);
+        QVERIFY(tree.nodeAt(2) == nullptr);
+    }
+
+    void children_keepInsertionOrder()
+    {
+        KifuBranchTree tree;
+        buildTestTree(tree);
+
+        auto* n2 = tree.findByPlyOnMainLine(2);
+        QVERIFY(n2 != nullptr);
+        auto* b2 = tree.addMove(n2, ShogiMove(), QStringLiteral("▲５六歩"), QStringLiteral("branch_sfen3"));
+
+        const QList<KifuBranchNode*> children = n2->children();
+        QCOMPARE(children.size(), 3);
+        QCOMPARE(n2->childCount(), 3);
+        QCOMPARE(n2->firstChild(), children.at(0));
+        QCOMPARE(children.at(0)->nextSibling(), children.at(1));
+        QCOMPARE(children.at(1)->nextSibling(), b2);
+        QVERIFY(b2->nextSibling() == nullptr);
+        QCOMPARE(n2->childAt(2), b2);
+        QVERIFY(n2->childAt(3) == nullptr);
+        QVERIFY(children.at(0)->isMainLine());
+        QVERIFY(!b2->isMainLine());
+        QCOMPARE(b2->lineIndex(), 2);
+        QCOMPARE(b2->siblings().size(), 2);
+    }
+
+    void lines_incrementalMatchesRebuild()
+    {
+        KifuBranchTree patched;
+        buildBranchyTree(patched, true);
+        KifuBranchTree rebuilt;
+        buildBranchyTree(rebuilt, false);
+
+        const QList<BranchLine> a = patched.allLines();
+        const QList<BranchLine> b = rebuilt.allLines();
+        QCOMPARE(a.size(), b.size());
+        QCOMPARE(patched.lineCount(), static_cast<int>(a.size()));
+        for (int i = 0; i < a.size(); ++i) {
+            QCOMPARE(a.at(i).lineIndex, i);
+            QCOMPARE(a.at(i).lineIndex, b.at(i).lineIndex);
+            QCOMPARE(a.at(i).name, b.at(i).name);
+            QCOMPARE(a.at(i).branchPly, b.at(i).branchPly);
+            QCOMPARE(a.at(i).branchPoint ? a.at(i).branchPoint->nodeId() : 0,
+                     b.at(i).branchPoint ? b.at(i).branchPoint->nodeId() : 0);
+            QCOMPARE(a.at(i).nodes.size(), b.at(i).nodes.size());
+            for (int j = 0; j < a.at(i).nodes.size(); ++j) {
+                QCOMPARE(a.at(i).nodes.at(j)->nodeId(), b.at(i).nodes.at(j)->nodeId());
+            }
+        }
+    }
+
+    void lines_membershipQueries_data()
+    {
+        QTest::addColumn<bool>("queryBetweenEdits");
+        QTest::newRow("rebuilt") << false;
+        QTest::newRow("patched") << true;
+    }
+
+    void lines_membershipQueries()
+    {
+        QFETCH(bool, queryBetweenEdits);
+        KifuBranchTree tree;
+        buildBranchyTree(tree, queryBetweenEdits);
+        // ライン表より先に範囲を問い合わせても正しい値になる
+        const int count = tree.lineCount();
+        const QList<BranchLine> lines = tree.allLines();
+        QCOMPARE(count, static_cast<int>(lines.size()));
+
+        for (int id = 1; id <= tree.nodeCount(); ++id) {
+            KifuBranchNode* node = tree.nodeAt(id);
+            int firstLine = -1;
+            for (const BranchLine& line : lines) {
+                const bool onLine = line.nodes.contains(node);
+                QCOMPARE(tree.isNodeOnLine(node, line.lineIndex), onLine);
+                if (onLine && firstLine < 0) firstLine = line.lineIndex;
+                if (onLine && node->childCount() > 0) {
+                    KifuBranchNode* child = tree.childOnLine(node, line.lineIndex);
+                    QVERIFY(child != nullptr);
+                    QCOMPARE(child->parent(), node);
+                    QVERIFY(line.nodes.contains(child));
+                }
+            }
+            QCOMPARE(tree.findLineIndexForNode(node).value_or(-1), firstLine);
+        }
+
+        KifuBranchTree other;
+        other.setRootSfen(kHirateSfen);
+        QVERIFY(!tree.findLineIndexForNode(other.root()).has_value());
+        QVERIFY(!tree.isNodeOnLine(other.root(), 0));
+        QVERIFY(tree.childOnLine(tree.root(), static_cast<int>(lines.size())) == nullptr);
+    }
+
     void lineCount()
     {
         KifuBranchTree tree;
@@ -168,6 +354,132 @@ private slots:
         QVERIFY(node != nullptr);
         QCOMPARE(node->ply(), 3);
     }
+
+    void packedMove_roundTrip()
+    {
+        KifuBranchTree tree;
+        tree.setRootSfen(kHirateSfen);
+
+        const ShogiMove move(QPoint(7, 7), QPoint(1, 1), Piece::BlackBishop, Piece::WhiteBishop, true);
+        auto* node = tree.addMove(tree.root(), move, QStringLiteral("▲２二角成"), QStringLiteral("sfen1"));
+        QVERIFY(node != nullptr);
+        QCOMPARE(node->move(), move);
+    }
+
+    void lazySfen_matchesGivenSfen()
+    {
+        KifuBranchTree tree;
+        QStringList sfens;
+        const QList<KifuBranchNode*> nodes = buildRealGame(tree, sfens);
+        QCOMPARE(sfens.size(), 6);
+
+        for (int i = 0; i < nodes.size(); ++i) {
+            QVERIFY(nodes.at(i) != nullptr);
+            QCOMPARE(nodes.at(i)->sfen(), sfens.at(i));
+        }
+        QCOMPARE(tree.sfenListForLine(0), sfens);
+
+        // Terminal move keeps the previous position
+        auto* resign = tree.addTerminalMove(nodes.last(), TerminalType::Resign, QStringLiteral("△投了"));
+        QVERIFY(resign != nullptr);
+        QCOMPARE(resign->sfen(), sfens.last());
+        QCOMPARE(tree.sfenListForLine(0), sfens + QStringList{sfens.last()});
+    }
+
+    void lazySfen_branchLine()
+    {
+        KifuBranchTree tree;
+        QStringList sfens;
+        const QList<KifuBranchNode*> nodes = buildRealGame(tree, sfens);
+
+        // Branch ▲２六歩 after ply 2
+        const QStringList branchSfens = traceSfens(sfens.at(2), {QStringLiteral("2g2f")});
+        auto* branch = tree.addMove(nodes.at(2),
+                                    ShogiMove(QPoint(1, 6), QPoint(1, 5), Piece::BlackPawn, Piece::None, false),
+                                    QStringLiteral("▲２六歩"), branchSfens.first());
+        QVERIFY(branch != nullptr);
+        QCOMPARE(branch->sfen(), branchSfens.first());
+        QCOMPARE(tree.sfenListForLine(1), sfens.mid(0, 3) + branchSfens);
+        QCOMPARE(tree.sfenListForLine(0), sfens);
+    }
+
+    void lazySfen_replaysAfterEviction()
+    {
+        KifuBranchTree tree;
+        tree.setRootSfen(kHirateSfen);
+
+        // Shuttle the rooks to build a line longer than the decoded-position cache
+        const QList<ShogiMove> cycle = {
+            ShogiMove(QPoint(1, 7), QPoint(2, 7), Piece::BlackRook, Piece::None, false),
+            ShogiMove(QPoint(7, 1), QPoint(6, 1), Piece::WhiteRook, Piece::None, false),
+            ShogiMove(QPoint(2, 7), QPoint(1, 7), Piece::BlackRook, Piece::None, false),
+            ShogiMove(QPoint(6, 1), QPoint(7, 1), Piece::WhiteRook, Piece::None, false),
+        };
+        const QStringList cycleUsi = {QStringLiteral("2h3h"), QStringLiteral("8b7b"), QStringLiteral("3h2h"),
+                                      QStringLiteral("7b8b")};
+        QStringList usiMoves;
+        for (int i = 0; i < 200; ++i) usiMoves.append(cycleUsi.at(i % 4));
+        const QStringList sfens = traceSfens(kHirateSfen, usiMoves);
+        QCOMPARE(sfens.size(), 200);
+
+        QList<KifuBranchNode*> nodes;
+        auto* current = tree.root();
+        for (int i = 0; i < 200; ++i) {
+            current = tree.addMove(current, cycle.at(i % 4), QStringLiteral("move%1").arg(i), sfens.at(i));
+            QVERIFY(current != nullptr);
+            nodes.append(current);
+        }
+
+        QCOMPARE(nodes.at(9)->sfen(), sfens.at(9));
+        QCOMPARE(nodes.at(150)->sfen(), sfens.at(150));
+        QCOMPARE(nodes.at(10)->sfen(), sfens.at(10));
+        QCOMPARE(tree.sfenListForLine(0).mid(1), sfens);
+    }
+
+    void lazySfen_keepsUnreproducibleSfen()
+    {
+        KifuBranchTree tree;
+        tree.setRootSfen(kHirateSfen);
+
+        // A SFEN whose ply field differs from the replayed one is kept verbatim
+        const QString givenSfen =
+            QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/2P6/PP1PPPPPP/1B5R1/LNSGKGSNL w - 10");
+        auto* n1 = tree.addMove(tree.root(),
+                                ShogiMove(QPoint(6, 6), QPoint(6, 5), Piece::BlackPawn, Piece::None, false),
+                                QStringLiteral("▲７六歩"), givenSfen);
+        QVERIFY(n1 != nullptr);
+        QCOMPARE(n1->sfen(), givenSfen);
+
+        // Its child replays from the kept SFEN
+        const QString childSfen = traceSfens(givenSfen, {QStringLiteral("3c3d")}).first();
+        auto* n2 = tree.addMove(n1, ShogiMove(QPoint(2, 2), QPoint(2, 3), Piece::WhitePawn, Piece::None, false),
+                                QStringLiteral("△３四歩"), childSfen);
+        QVERIFY(n2 != nullptr);
+        QCOMPARE(n2->sfen(), childSfen);
+        QCOMPARE(tree.sfenListForLine(0), (QStringList{kHirateSfen, givenSfen, childSfen}));
+    }
+
+    void findBySfen_ignoresPly()
+    {
+        KifuBranchTree tree;
+        QStringList sfens;
+        const QList<KifuBranchNode*> nodes = buildRealGame(tree, sfens);
+
+        QString query = sfens.at(3);
+        query = query.left(query.lastIndexOf(QLatin1Char(' '))) + QStringLiteral(" 99");
+        QCOMPARE(tree.findBySfen(query), nodes.at(3));
+        QCOMPARE(tree.findBySfen(sfens.at(0)), tree.root());
+
+        // The terminal shares the position; the earlier move node wins
+        tree.addTerminalMove(nodes.last(), TerminalType::Resign, QStringLiteral("△投了"));
+        QCOMPARE(tree.findBySfen(sfens.last()), nodes.last());
+
+        QVERIFY(tree.findBySfen(QStringLiteral("9/9/9/9/9/9/9/9/9 b - 1")) == nullptr);
+        QVERIFY(tree.findBySfen(QString()) == nullptr);
+
+        tree.clear();
+        QVERIFY(tree.findBySfen(sfens.at(3)) == nullptr);
+    }
 };
 
 QTEST_MAIN(TestKifuBranchTree)
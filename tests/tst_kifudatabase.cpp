@@ -0,0 +1,250 @@
+/// @file tst_kifudatabase.cpp
+/// @brief 棋譜データベース（局面索引）テスト
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "kifdisplayitem.h"
+#include "kifucorpusfiles.h"
+#include "kifudatabase.h"
+#include "sfenpositiontracer.h"
+
+class TestKifuDatabase : public QObject
+{
+    Q_OBJECT
+
+private:
+    static bool writeCsaGame(const QString &path, const QStringList &moves, const QByteArray &result,
+                             const QByteArray &header = {})
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return false;
+        QByteArray text = "V2.2\nN+Sente\nN-Gote\n" + header + "PI\n+\n";
+        for (const QString &move : moves) text += move.toUtf8() + "\n";
+        if (!result.isEmpty()) text += result + "\n";
+        return file.write(text) == text.size();
+    }
+
+    /// 平手から USI 指し手を進めた局面
+    static QString sfenAfter(const QStringList &moves)
+    {
+        SfenPositionTracer tracer;
+        tracer.resetToStartpos();
+        for (const QString &move : moves) {
+            if (!tracer.applyUsiMove(move)) return {};
+        }
+        return tracer.toSfenString();
+    }
+
+    static KifLine lineEndingWith(const QString &terminal)
+    {
+        KifLine line;
+        line.usiMoves = {QStringLiteral("7g7f")};
+        line.disp.append(KifDisplayItem(QStringLiteral("▲７六歩(77)")));
+        line.disp.append(KifDisplayItem(terminal));
+        return line;
+    }
+
+    /// a/b/c の CSA 3局と test_basic の KIF・CSA を置いたフォルダからデータベースを作る
+    static bool buildSample(const QTemporaryDir &dir, const QString &dbPath, KifuDatabase::BuildResult &result)
+    {
+        const QString fixtures = QCoreApplication::applicationDirPath() + QStringLiteral("/fixtures/");
+        if (!writeCsaGame(dir.filePath(QStringLiteral("a.csa")), {QStringLiteral("+7776FU"), QStringLiteral("-3334FU")},
+                          "%TORYO", "$EVENT:TestCup\n$START_TIME:2024/01/02 10:00:00\n")
+            || !writeCsaGame(dir.filePath(QStringLiteral("b.csa")),
+                             {QStringLiteral("+7776FU"), QStringLiteral("-3334FU"), QStringLiteral("+2726FU")},
+                             "%TORYO")
+            || !writeCsaGame(dir.filePath(QStringLiteral("c.csa")), {QStringLiteral("+2726FU")}, "%SENNICHITE")
+            || !QFile::copy(fixtures + QStringLiteral("test_basic.csa"), dir.filePath(QStringLiteral("game.csa")))
+            || !QFile::copy(fixtures + QStringLiteral("test_basic.kif"), dir.filePath(QStringLiteral("game.kif")))) {
+            return false;
+        }
+        result = KifuDatabase::build(KifuCorpusFiles::collectFiles(dir.path(), false), dbPath);
+        return result.success;
+    }
+
+private slots:
+    void build_indexesMainlinePositions();
+    void findGames_listsGamesReachingPosition();
+    void positionStats_countsResults();
+    void findGames_unknownOrInvalidPosition();
+    void build_cancelKeepsExistingFile();
+    void open_rejectsInvalidFile();
+    void resultOf_terminalSideMark();
+};
+
+void TestKifuDatabase::build_indexesMainlinePositions()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString dbPath = tmpDir.filePath(QStringLiteral("games.kdb"));
+    KifuDatabase::BuildResult result;
+    QVERIFY(buildSample(tmpDir, dbPath, result));
+    QCOMPARE(result.stats.fileCount, 5);
+    QCOMPARE(result.stats.gameCount, 5);
+    QCOMPARE(result.stats.failedCount, 0);
+    // 開始局面を含めて 3 + 4 + 2 + 8 + 8
+    QCOMPARE(result.stats.postingCount, qint64(25));
+
+    KifuDatabase db;
+    QVERIFY(KifuDatabase::isDatabaseFile(dbPath));
+    QVERIFY(db.open(dbPath));
+    QCOMPARE(db.gameCount(), 5);
+    QCOMPARE(db.postingCount(), qint64(25));
+
+    // 対局番号はファイル名順
+    const KifuDatabase::GameSummary first = db.gameAt(0);
+    QVERIFY(first.filePath.endsWith(QStringLiteral("a.csa")));
+    QCOMPARE(first.blackPlayer, QStringLiteral("Sente"));
+    QCOMPARE(first.whitePlayer, QStringLiteral("Gote"));
+    QCOMPARE(first.event, QStringLiteral("TestCup"));
+    QCOMPARE(first.date, QStringLiteral("2024/01/02 10:00:00"));
+    QCOMPARE(first.plyCount, 2);
+    QCOMPARE(first.result, KifuDatabase::GameResult::WhiteWin);
+    bool hasEvent = false;
+    for (const KifGameInfoItem &item : first.gameInfo) {
+        hasEvent = hasEvent || (item.key == QStringLiteral("棋戦") && item.value == QStringLiteral("TestCup"));
+    }
+    QVERIFY(hasEvent);
+
+    QCOMPARE(db.gameAt(1).result, KifuDatabase::GameResult::BlackWin);
+    QCOMPARE(db.gameAt(2).result, KifuDatabase::GameResult::Draw);
+    QCOMPARE(db.gameAt(4).plyCount, 7);
+    QVERIFY(db.gameAt(5).filePath.isEmpty());
+}
+
+void TestKifuDatabase::findGames_listsGamesReachingPosition()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString dbPath = tmpDir.filePath(QStringLiteral("games.kdb"));
+    KifuDatabase::BuildResult result;
+    QVERIFY(buildSample(tmpDir, dbPath, result));
+    KifuDatabase db;
+    QVERIFY(db.open(dbPath));
+
+    // 開始局面は全対局。"startpos" と手数なしSFEN でも引ける
+    const QList<KifuDatabase::Hit> all = db.findGames(QStringLiteral("startpos"));
+    QCOMPARE(all.size(), 5);
+    for (int i = 0; i < all.size(); ++i) {
+        QCOMPARE(all.at(i).game, i);
+        QCOMPARE(all.at(i).ply, 0);
+    }
+    QCOMPARE(db.findGames(QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL b -")).size(), 5);
+
+    // 7g7f 3c3d の局面は c.csa 以外の4局の2手目。手数フィールドは照合に使わない
+    QString sfen = sfenAfter({QStringLiteral("7g7f"), QStringLiteral("3c3d")});
+    sfen = sfen.left(sfen.lastIndexOf(QLatin1Char(' '))) + QStringLiteral(" 99");
+    const QList<KifuDatabase::Hit> hits = db.findGames(sfen);
+    QCOMPARE(hits.size(), 4);
+    QCOMPARE(hits.at(0).game, 0);
+    QCOMPARE(hits.at(1).game, 1);
+    QCOMPARE(hits.at(2).game, 3);
+    QCOMPARE(hits.at(3).game, 4);
+    for (const KifuDatabase::Hit &hit : hits) QCOMPARE(hit.ply, 2);
+
+    QCOMPARE(db.findGames(sfen, 2).size(), 2);
+
+    const QList<KifuDatabase::Hit> onlyC = db.findGames(sfenAfter({QStringLiteral("2g2f")}));
+    QCOMPARE(onlyC.size(), 1);
+    QCOMPARE(onlyC.at(0).game, 2);
+    QCOMPARE(onlyC.at(0).ply, 1);
+}
+
+void TestKifuDatabase::positionStats_countsResults()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString dbPath = tmpDir.filePath(QStringLiteral("games.kdb"));
+    KifuDatabase::BuildResult result;
+    QVERIFY(buildSample(tmpDir, dbPath, result));
+    KifuDatabase db;
+    QVERIFY(db.open(dbPath));
+
+    const KifuDatabase::PositionStats stats =
+        db.positionStats(sfenAfter({QStringLiteral("7g7f"), QStringLiteral("3c3d")}));
+    QCOMPARE(stats.games, 4);
+    QCOMPARE(stats.blackWins, 1);
+    QCOMPARE(stats.whiteWins, 1);
+    QCOMPARE(stats.draws, 0);
+    QCOMPARE(stats.unknown, 2);
+
+    const KifuDatabase::PositionStats start = db.positionStats(QStringLiteral("startpos"));
+    QCOMPARE(start.games, 5);
+    QCOMPARE(start.draws, 1);
+}
+
+void TestKifuDatabase::findGames_unknownOrInvalidPosition()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString dbPath = tmpDir.filePath(QStringLiteral("games.kdb"));
+    KifuDatabase::BuildResult result;
+    QVERIFY(buildSample(tmpDir, dbPath, result));
+    KifuDatabase db;
+    QVERIFY(db.open(dbPath));
+
+    QVERIFY(db.findGames(sfenAfter({QStringLiteral("1g1f")})).isEmpty());
+    QCOMPARE(db.positionStats(sfenAfter({QStringLiteral("1g1f")})).games, 0);
+    QVERIFY(db.findGames(QStringLiteral("garbage")).isEmpty());
+    QVERIFY(KifuDatabase::normalizedSfen(QStringLiteral("garbage")).isEmpty());
+
+    KifuDatabase closed;
+    QVERIFY(!closed.isOpen());
+    QVERIFY(closed.findGames(QStringLiteral("startpos")).isEmpty());
+}
+
+void TestKifuDatabase::build_cancelKeepsExistingFile()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString dbPath = tmpDir.filePath(QStringLiteral("games.kdb"));
+    KifuDatabase::BuildResult result;
+    QVERIFY(buildSample(tmpDir, dbPath, result));
+    const qint64 size = QFileInfo(dbPath).size();
+
+    const QString fixture = QCoreApplication::applicationDirPath() + QStringLiteral("/fixtures/test_basic.kif");
+    result = KifuDatabase::build({fixture}, dbPath, [](int) { return false; });
+    QVERIFY(result.cancelled);
+    QVERIFY(!result.success);
+    QCOMPARE(QFileInfo(dbPath).size(), size);
+
+    KifuDatabase db;
+    QVERIFY(db.open(dbPath));
+    QCOMPARE(db.gameCount(), 5);
+}
+
+void TestKifuDatabase::open_rejectsInvalidFile()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("broken.kdb"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(128, 'x'));
+    file.close();
+
+    KifuDatabase db;
+    QString error;
+    QVERIFY(!KifuDatabase::isDatabaseFile(path));
+    QVERIFY(!db.open(path, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!db.isOpen());
+    QVERIFY(!db.open(tmpDir.filePath(QStringLiteral("missing.kdb"))));
+}
+
+void TestKifuDatabase::resultOf_terminalSideMark()
+{
+    // 終局表示の手番記号は終局手を指した側
+    QCOMPARE(KifuDatabase::resultOf(lineEndingWith(QStringLiteral("△投了"))), KifuDatabase::GameResult::BlackWin);
+    QCOMPARE(KifuDatabase::resultOf(lineEndingWith(QStringLiteral("▲詰み"))), KifuDatabase::GameResult::WhiteWin);
+    QCOMPARE(KifuDatabase::resultOf(lineEndingWith(QStringLiteral("▲反則勝ち"))), KifuDatabase::GameResult::BlackWin);
+    QCOMPARE(KifuDatabase::resultOf(lineEndingWith(QStringLiteral("△切れ負け"))), KifuDatabase::GameResult::BlackWin);
+    QCOMPARE(KifuDatabase::resultOf(lineEndingWith(QStringLiteral("△持将棋"))), KifuDatabase::GameResult::Draw);
+    QCOMPARE(KifuDatabase::resultOf(lineEndingWith(QStringLiteral("△中断"))), KifuDatabase::GameResult::Unknown);
+    QCOMPARE(KifuDatabase::resultOf(lineEndingWith(QStringLiteral("投了"))), KifuDatabase::GameResult::Unknown);
+    QCOMPARE(KifuDatabase::resultOf(KifLine()), KifuDatabase::GameResult::Unknown);
+}
+
+QTEST_MAIN(TestKifuDatabase)
+#include "tst_kifudatabase.moc"
@@ -0,0 +1,226 @@
+/// @file tst_kifuformatconverter.cpp
+/// @brief 棋譜形式の変換（KifuFormatConverter）と一括変換（KifuBatchConverter）テスト
+
+#include <QtTest>
+#include <QStringEncoder>
+#include <QTemporaryDir>
+
+#include "kifparsetypes.h"
+#include "kifubatchconverter.h"
+#include "kifucorpusfiles.h"
+#include "kifuformatconverter.h"
+
+class TestKifuFormatConverter : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QString fixturePath(const QString &name)
+    {
+        return QCoreApplication::applicationDirPath() + QStringLiteral("/fixtures/") + name;
+    }
+
+    static QStringList mainlineMoves(const QString &path)
+    {
+        KifParseResult result;
+        if (!KifuCorpusFiles::parseFile(path, result)) return {};
+        return result.mainline.usiMoves;
+    }
+
+    /// in/b.kif と in/sub/a.csa を置いた入力フォルダを作る
+    static bool writeInputTree(const QTemporaryDir &dir)
+    {
+        return QDir(dir.path()).mkpath(QStringLiteral("in/sub"))
+               && QFile::copy(fixturePath(QStringLiteral("test_basic.kif")), dir.filePath(QStringLiteral("in/b.kif")))
+               && QFile::copy(fixturePath(QStringLiteral("test_basic.csa")),
+                              dir.filePath(QStringLiteral("in/sub/a.csa")));
+    }
+
+private slots:
+    void convertFile_keepsMainline_data();
+    void convertFile_keepsMainline();
+    void convertFile_keepsVariations();
+    void convertFile_rejectsUnknownFormatAndEmptyGame();
+    void writeFile_shiftJisForKif();
+    void batch_convertsFolderTree();
+    void batch_streamsToStdout();
+};
+
+void TestKifuFormatConverter::convertFile_keepsMainline_data()
+{
+    QTest::addColumn<QString>("suffix");
+    for (const QString &suffix : KifuFormatConverter::outputSuffixes()) {
+        QTest::newRow(qPrintable(suffix)) << suffix;
+    }
+}
+
+void TestKifuFormatConverter::convertFile_keepsMainline()
+{
+    QFETCH(QString, suffix);
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    const QString input = fixturePath(QStringLiteral("test_basic.kif"));
+    const QStringList expected = mainlineMoves(input);
+    QVERIFY(!expected.isEmpty());
+
+    QStringList lines;
+    QString error;
+    QVERIFY2(KifuFormatConverter::convertFile(input, suffix, lines, &error), qPrintable(error));
+    QVERIFY(!lines.isEmpty());
+
+    // 書き出した棋譜を読み直すと同じ本譜になる
+    const QString output = tmpDir.filePath(QStringLiteral("game.") + suffix);
+    if (!KifuFormatConverter::writeFile(output, lines, &error)) {
+        QSKIP(qPrintable(QStringLiteral("cannot write %1: %2").arg(suffix, error)));
+    }
+    QCOMPARE(mainlineMoves(output), expected);
+}
+
+void TestKifuFormatConverter::convertFile_keepsVariations()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    const QString input = fixturePath(QStringLiteral("test_branch.kif"));
+    KifParseResult original;
+    QVERIFY(KifuCorpusFiles::parseFile(input, original));
+    QVERIFY(!original.variations.isEmpty());
+
+    QStringList lines;
+    QVERIFY(KifuFormatConverter::convertFile(input, QStringLiteral("kifu"), lines));
+    const QString output = tmpDir.filePath(QStringLiteral("game.kifu"));
+    QVERIFY(KifuFormatConverter::writeFile(output, lines));
+
+    KifParseResult converted;
+    QVERIFY(KifuCorpusFiles::parseFile(output, converted));
+    QCOMPARE(converted.mainline.usiMoves, original.mainline.usiMoves);
+    QCOMPARE(converted.variations.size(), original.variations.size());
+}
+
+void TestKifuFormatConverter::convertFile_rejectsUnknownFormatAndEmptyGame()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    QStringList lines;
+    QString error;
+    QVERIFY(!KifuFormatConverter::convertFile(fixturePath(QStringLiteral("test_basic.kif")),
+                                              QStringLiteral("pdf"), lines, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!KifuFormatConverter::isOutputSuffix(QStringLiteral("pdf")));
+    QVERIFY(KifuFormatConverter::isOutputSuffix(QStringLiteral("CSA")));
+
+    const QString empty = tmpDir.filePath(QStringLiteral("empty.kif"));
+    QFile file(empty);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    error.clear();
+    QVERIFY(!KifuFormatConverter::convertFile(empty, QStringLiteral("csa"), lines, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestKifuFormatConverter::writeFile_shiftJisForKif()
+{
+    if (!QStringEncoder("Shift-JIS").isValid()) {
+        QSKIP("Shift_JIS encoder is not available");
+    }
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    const QStringList lines = {QStringLiteral("#KIF version=2.0 encoding=UTF-8"), QStringLiteral("先手：テスト")};
+    const QString kif = tmpDir.filePath(QStringLiteral("game.kif"));
+    const QString kifu = tmpDir.filePath(QStringLiteral("game.kifu"));
+    QVERIFY(KifuFormatConverter::writeFile(kif, lines));
+    QVERIFY(KifuFormatConverter::writeFile(kifu, lines));
+
+    QFile sjis(kif);
+    QVERIFY(sjis.open(QIODevice::ReadOnly));
+    const QByteArray sjisBytes = sjis.readAll();
+    QVERIFY(sjisBytes.startsWith("#KIF version=2.0 encoding=Shift_JIS"));
+    QVERIFY(!sjisBytes.contains(QStringLiteral("先手").toUtf8()));
+
+    QFile utf8(kifu);
+    QVERIFY(utf8.open(QIODevice::ReadOnly));
+    const QByteArray utf8Bytes = utf8.readAll();
+    QVERIFY(utf8Bytes.startsWith("#KIF version=2.0 encoding=UTF-8"));
+    QVERIFY(utf8Bytes.contains(QStringLiteral("先手").toUtf8()));
+}
+
+void TestKifuFormatConverter::batch_convertsFolderTree()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QVERIFY(writeInputTree(tmpDir));
+
+    KifuBatchConverter::Options options;
+    options.inputs = {tmpDir.filePath(QStringLiteral("in"))};
+    options.outputSuffix = QStringLiteral("usi");
+    options.outputDir = tmpDir.filePath(QStringLiteral("out"));
+    options.recursive = true;
+    options.jobs = 2;
+
+    QString data;
+    QString log;
+    QTextStream dataStream(&data);
+    QTextStream logStream(&log);
+
+    // 入力フォルダのサブフォルダ構成のまま書き出す
+    KifuBatchConverter::Stats stats = KifuBatchConverter(options, dataStream, logStream).run();
+    QCOMPARE(stats.total, qsizetype(2));
+    QCOMPARE(stats.converted, qsizetype(2));
+    QCOMPARE(stats.failed, qsizetype(0));
+    QVERIFY(QFile::exists(tmpDir.filePath(QStringLiteral("out/b.usi"))));
+    QVERIFY(QFile::exists(tmpDir.filePath(QStringLiteral("out/sub/a.usi"))));
+    QCOMPARE(mainlineMoves(tmpDir.filePath(QStringLiteral("out/b.usi"))),
+             mainlineMoves(tmpDir.filePath(QStringLiteral("in/b.kif"))));
+    QVERIFY(data.isEmpty());
+
+    // 2回目は既存の出力を飛ばし、--overwrite なら書き直す
+    stats = KifuBatchConverter(options, dataStream, logStream).run();
+    QCOMPARE(stats.skipped, qsizetype(2));
+    QCOMPARE(stats.converted, qsizetype(0));
+    options.overwrite = true;
+    stats = KifuBatchConverter(options, dataStream, logStream).run();
+    QCOMPARE(stats.converted, qsizetype(2));
+
+    // 一致するファイルがない入力は報告する
+    options.inputs = {tmpDir.filePath(QStringLiteral("missing/*.kif"))};
+    KifuBatchConverter missing(options, dataStream, logStream);
+    stats = missing.run();
+    QCOMPARE(stats.total, qsizetype(0));
+    QCOMPARE(missing.unmatchedInputs(), options.inputs);
+}
+
+void TestKifuFormatConverter::batch_streamsToStdout()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QVERIFY(writeInputTree(tmpDir));
+
+    KifuBatchConverter::Options options;
+    options.inputs = {tmpDir.filePath(QStringLiteral("in"))};
+    options.outputSuffix = QStringLiteral("usi");
+    options.outputDir = QStringLiteral("-");
+    options.recursive = true;
+    options.jobs = 1;
+
+    QString data;
+    QString log;
+    QTextStream dataStream(&data);
+    QTextStream logStream(&log);
+    const KifuBatchConverter::Stats stats = KifuBatchConverter(options, dataStream, logStream).run();
+    QCOMPARE(stats.converted, qsizetype(2));
+    QVERIFY(stats.filesPerSecond() >= 0.0);
+
+    // 並列数 1 なら入力順（名前順）に1局1行で出る
+    const QStringList lines = data.split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    QCOMPARE(lines.size(), 2);
+    for (const QString &line : lines) {
+        QVERIFY(line.startsWith(QStringLiteral("position ")));
+    }
+    QVERIFY(!QDir(tmpDir.filePath(QStringLiteral("in"))).exists(QStringLiteral("b.usi")));
+}
+
+QTEST_MAIN(TestKifuFormatConverter)
+#include "tst_kifuformatconverter.moc"
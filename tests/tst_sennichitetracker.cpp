@@ -0,0 +1,155 @@
+/// @file tst_sennichitetracker.cpp
+/// @brief 千日手トラッカー（局面ハッシュ差分判定）テスト
+
+#include <QtTest>
+
+#include "sennichitedetector.h"
+#include "sennichitetracker.h"
+
+namespace {
+
+/// 両玉が1マスずつ往復する4手周期（平手）
+QStringList kingShuffleCycle()
+{
+    return {
+        QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL b -"),
+        QStringLiteral("lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B2K2R1/LNSG1GSNL w -"),
+        QStringLiteral("lnsg1gsnl/1r2k2b1/ppppppppp/9/9/9/PPPPPPPPP/1B2K2R1/LNSG1GSNL b -"),
+        QStringLiteral("lnsg1gsnl/1r2k2b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/LNSGKGSNL w -"),
+    };
+}
+
+/// 先手の飛車が毎手王手をかけ、後手玉が逃げる4手周期
+QStringList rookCheckCycle()
+{
+    return {
+        QStringLiteral("4k4/9/9/9/9/9/9/8K/4R4 w -"),
+        QStringLiteral("3k5/9/9/9/9/9/9/8K/4R4 b -"),
+        QStringLiteral("3k5/9/9/9/9/9/9/8K/3R5 w -"),
+        QStringLiteral("4k4/9/9/9/9/9/9/8K/3R5 b -"),
+    };
+}
+
+/// 周期を繰り返して手数付きSFEN履歴を作る（plies 局面分）
+QStringList buildRecord(const QStringList& cycle, int plies)
+{
+    QStringList record;
+    for (int i = 0; i < plies; ++i) {
+        record.append(cycle.at(i % cycle.size()) + QStringLiteral(" %1").arg(i + 1));
+    }
+    return record;
+}
+
+} // namespace
+
+class TestSennichiteTracker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void thirdOccurrence_isNone()
+    {
+        SennichiteTracker tracker;
+        QCOMPARE(tracker.syncTo(buildRecord(kingShuffleCycle(), 9)),
+                 SennichiteTracker::Result::None);
+        QCOMPARE(tracker.size(), 9);
+    }
+
+    void fourthOccurrence_isDraw()
+    {
+        SennichiteTracker tracker;
+        QCOMPARE(tracker.syncTo(buildRecord(kingShuffleCycle(), 13)),
+                 SennichiteTracker::Result::Draw);
+    }
+
+    void moveNumberIsIgnored()
+    {
+        // 手数だけが異なる同一局面は同じキーになる
+        SennichiteTracker tracker;
+        const QStringList record = buildRecord(kingShuffleCycle(), 13);
+        for (const QString& sfen : record) {
+            QVERIFY(tracker.pushPosition(sfen));
+        }
+        QCOMPARE(tracker.result(), SennichiteTracker::Result::Draw);
+    }
+
+    void continuousCheckByP1()
+    {
+        SennichiteTracker tracker;
+        QCOMPARE(tracker.syncTo(buildRecord(rookCheckCycle(), 13)),
+                 SennichiteTracker::Result::ContinuousCheckByP1);
+    }
+
+    void staticCheck_matchesTracker()
+    {
+        QCOMPARE(SennichiteDetector::check(buildRecord(kingShuffleCycle(), 13)),
+                 SennichiteDetector::Result::Draw);
+        QCOMPARE(SennichiteDetector::check(buildRecord(rookCheckCycle(), 13)),
+                 SennichiteDetector::Result::ContinuousCheckByP1);
+    }
+
+    void popPosition_undoesRepetition()
+    {
+        SennichiteTracker tracker;
+        QCOMPARE(tracker.syncTo(buildRecord(kingShuffleCycle(), 13)),
+                 SennichiteTracker::Result::Draw);
+
+        tracker.popPosition();
+        tracker.popPosition();
+        QCOMPARE(tracker.size(), 11);
+        QCOMPARE(tracker.result(), SennichiteTracker::Result::None);
+    }
+
+    void syncTo_followsUndoAndRedo()
+    {
+        SennichiteTracker tracker;
+        const QStringList full = buildRecord(kingShuffleCycle(), 13);
+        QCOMPARE(tracker.syncTo(full), SennichiteTracker::Result::Draw);
+
+        // 待った（2手戻し）
+        QCOMPARE(tracker.syncTo(full.mid(0, 11)), SennichiteTracker::Result::None);
+        QCOMPARE(tracker.size(), 11);
+
+        // 指し直し
+        QCOMPARE(tracker.syncTo(full), SennichiteTracker::Result::Draw);
+        QCOMPARE(tracker.size(), 13);
+    }
+
+    void syncTo_switchesToDifferentGame()
+    {
+        SennichiteTracker tracker;
+        QCOMPARE(tracker.syncTo(buildRecord(kingShuffleCycle(), 12)),
+                 SennichiteTracker::Result::None);
+
+        // 同じ長さの別対局に切り替わっても前の対局の出現回数を引き継がない
+        QCOMPARE(tracker.syncTo(buildRecord(rookCheckCycle(), 12)),
+                 SennichiteTracker::Result::None);
+        QCOMPARE(tracker.syncTo(buildRecord(rookCheckCycle(), 13)),
+                 SennichiteTracker::Result::ContinuousCheckByP1);
+    }
+
+    void clear_dropsRecordWithSameTail()
+    {
+        // 長さと末尾局面が同じでも途中が違う履歴は、clear() してから同期し直す
+        const QStringList first = buildRecord(kingShuffleCycle(), 13);
+        QStringList second = buildRecord(rookCheckCycle(), 12);
+        second.append(first.constLast());
+
+        SennichiteTracker tracker;
+        QCOMPARE(tracker.syncTo(first), SennichiteTracker::Result::Draw);
+        tracker.clear();
+        QCOMPARE(tracker.syncTo(second), SennichiteTracker::Result::None);
+        QCOMPARE(tracker.size(), 13);
+    }
+
+    void invalidSfen_keepsPlyAlignment()
+    {
+        SennichiteTracker tracker;
+        QVERIFY(!tracker.pushPosition(QStringLiteral("invalid")));
+        QCOMPARE(tracker.size(), 1);
+        QCOMPARE(tracker.result(), SennichiteTracker::Result::None);
+    }
+};
+
+QTEST_MAIN(TestSennichiteTracker)
+#include "tst_sennichitetracker.moc"
@@ -107,6 +107,18 @@ private slots:
         AnalysisSettings::setUsiLogFontSize(11);
         QCOMPARE(AnalysisSettings::usiLogFontSize(), 11);
 
+        AnalysisSettings::setUsiLogMaxLines(5000);
+        QCOMPARE(AnalysisSettings::usiLogMaxLines(), 5000);
+
+        AnalysisSettings::setUsiLogSpillToFile(true);
+        QCOMPARE(AnalysisSettings::usiLogSpillToFile(), true);
+
+        AnalysisSettings::setEnginePoolIdlePerEngine(2);
+        QCOMPARE(AnalysisSettings::enginePoolIdlePerEngine(), 2);
+
+        AnalysisSettings::setEnginePoolIdleTimeoutSec(120);
+        QCOMPARE(AnalysisSettings::enginePoolIdleTimeoutSec(), 120);
+
         AnalysisSettings::setThinkingFontSize(13);
         QCOMPARE(AnalysisSettings::thinkingFontSize(), 13);
 
@@ -162,6 +174,9 @@ private slots:
 
         AnalysisSettings::setConsiderationMultiPV(4);
         QCOMPARE(AnalysisSettings::considerationMultiPV(), 4);
+
+        AnalysisSettings::setTsumeSearchBuiltinSolver(true);
+        QCOMPARE(AnalysisSettings::tsumeSearchBuiltinSolver(), true);
     }
 
     void analysisSettings_pvBoard()
@@ -268,6 +283,19 @@ private slots:
         QCOMPARE(GameSettings::sfenCollectionLastDirectory(), QStringLiteral("/tmp/sfen"));
     }
 
+    void gameSettings_kifuDatabase()
+    {
+        QSize dialogSize(800, 600);
+        GameSettings::setKifuDatabaseDialogSize(dialogSize);
+        QCOMPARE(GameSettings::kifuDatabaseDialogSize(), dialogSize);
+
+        GameSettings::setKifuDatabasePath(QStringLiteral("/tmp/games.kdb"));
+        QCOMPARE(GameSettings::kifuDatabasePath(), QStringLiteral("/tmp/games.kdb"));
+
+        GameSettings::setKifuDatabaseSourceDirectory(QStringLiteral("/tmp/kifu"));
+        QCOMPARE(GameSettings::kifuDatabaseSourceDirectory(), QStringLiteral("/tmp/kifu"));
+    }
+
     // ========================================
     // NetworkSettings: CSAネットワーク設定
     // ========================================
@@ -414,6 +442,9 @@ private slots:
         TsumeshogiSettings::setTsumeshogiGeneratorMaxPositions(1000);
         QCOMPARE(TsumeshogiSettings::tsumeshogiGeneratorMaxPositions(), 1000);
 
+        TsumeshogiSettings::setTsumeshogiGeneratorWorkerCount(4);
+        QCOMPARE(TsumeshogiSettings::tsumeshogiGeneratorWorkerCount(), 4);
+
         TsumeshogiSettings::setTsumeshogiGeneratorLastSaveDirectory(QStringLiteral("/tmp/tsume"));
         QCOMPARE(TsumeshogiSettings::tsumeshogiGeneratorLastSaveDirectory(), QStringLiteral("/tmp/tsume"));
     }
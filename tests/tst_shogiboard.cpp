@@ -11,6 +11,31 @@ class TestShogiBoard : public QObject
 {
     Q_OBJECT
 
+    /// enginePosition() のミラーが盤面・駒台と一致し、差分更新した値が全再計算と一致するか
+    static void verifyEngineMirror(const ShogiBoard& board)
+    {
+        const fmv::EnginePosition& pos = board.enginePosition();
+        for (int i = 0; i < fmv::kSquareNb; ++i) {
+            QCOMPARE(pos.board[static_cast<std::size_t>(i)], static_cast<char>(board.boardData().at(i)));
+        }
+        static const Piece kHandPieces[] = {Piece::BlackPawn, Piece::BlackLance, Piece::BlackKnight,
+                                            Piece::BlackSilver, Piece::BlackGold, Piece::BlackBishop,
+                                            Piece::BlackRook};
+        for (std::size_t ht = 0; ht < std::size(kHandPieces); ++ht) {
+            QCOMPARE(pos.hand[0][ht], board.pieceStandCount(kHandPieces[ht]));
+            QCOMPARE(pos.hand[1][ht], board.pieceStandCount(toWhite(kHandPieces[ht])));
+        }
+
+        fmv::EnginePosition rebuilt = pos;
+        rebuilt.rebuildBitboards();
+        QCOMPARE(pos.occupied, rebuilt.occupied);
+        QCOMPARE(pos.colorOcc[0], rebuilt.colorOcc[0]);
+        QCOMPARE(pos.colorOcc[1], rebuilt.colorOcc[1]);
+        QCOMPARE(pos.kingSq[0], rebuilt.kingSq[0]);
+        QCOMPARE(pos.kingSq[1], rebuilt.kingSq[1]);
+        QCOMPARE(pos.zobristKey, rebuilt.zobristKey);
+    }
+
 private slots:
     // === SFEN I/O ===
 
@@ -404,6 +429,35 @@ private slots:
         board.initStand();
         QCOMPARE(board.pieceStand().value(Piece::BlackPawn, 0), 0);
     }
+
+    // === enginePosition mirror ===
+
+    void enginePosition_tracksBoardAndStand()
+    {
+        ShogiBoard board;
+        verifyEngineMirror(board);
+
+        board.setSfen(QStringLiteral("l6nl/5+P1gk/2np1S3/p1p4Pp/3P2Sp1/1PPb2P1P/P5GS1/R8/LN4bKL w RGgsn5p 1"));
+        verifyEngineMirror(board);
+
+        // 後手 9九角成（香を取る）、先手 2三歩（駒を取らない）
+        board.addPieceToStand(board.pieceCharacter(9, 9));
+        board.movePieceToSquare(Piece::WhiteBishop, 6, 6, 9, 9, true);
+        verifyEngineMirror(board);
+        board.movePieceToSquare(Piece::BlackPawn, 2, 4, 2, 3, false);
+        verifyEngineMirror(board);
+
+        // 駒打ち
+        QVERIFY(board.decrementPieceOnStand(Piece::BlackRook));
+        board.movePieceToSquare(Piece::BlackRook, 10, 7, 5, 5, false);
+        verifyEngineMirror(board);
+
+        board.flipSides();
+        verifyEngineMirror(board);
+
+        board.resetGameBoard();
+        verifyEngineMirror(board);
+    }
 };
 
 QTEST_MAIN(TestShogiBoard)
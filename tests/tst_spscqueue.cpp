@@ -0,0 +1,74 @@
+/// @file tst_spscqueue.cpp
+/// @brief SpscQueue（単一生産者・単一消費者キュー）のユニットテスト
+
+#include <QtTest>
+#include <QThread>
+
+#include "spscqueue.h"
+
+class TestSpscQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pushPop_respectsCapacityAndOrder()
+    {
+        SpscQueue<QString> queue(2);
+        QVERIFY(queue.isEmpty());
+
+        QString a = QStringLiteral("a");
+        QString b = QStringLiteral("b");
+        QString c = QStringLiteral("c");
+        QVERIFY(queue.tryPush(a));
+        QVERIFY(queue.tryPush(b));
+        QVERIFY(a.isEmpty());
+
+        // 満杯なら積まず、値もムーブしない
+        QVERIFY(!queue.tryPush(c));
+        QCOMPARE(c, QStringLiteral("c"));
+
+        QString out;
+        QVERIFY(queue.tryPop(out));
+        QCOMPARE(out, QStringLiteral("a"));
+        QVERIFY(queue.tryPush(c));
+        QVERIFY(queue.tryPop(out));
+        QCOMPARE(out, QStringLiteral("b"));
+        QVERIFY(queue.tryPop(out));
+        QCOMPARE(out, QStringLiteral("c"));
+        QVERIFY(!queue.tryPop(out));
+        QVERIFY(queue.isEmpty());
+    }
+
+    void twoThreads_keepEveryItemInOrder()
+    {
+        constexpr int kCount = 100000;
+        SpscQueue<int> queue(64);
+
+        QThread* producer = QThread::create([&queue]() {
+            for (int i = 0; i < kCount; ++i) {
+                int value = i;
+                while (!queue.tryPush(value)) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        });
+        producer->start();
+
+        int expected = 0;
+        while (expected < kCount) {
+            int value = -1;
+            if (!queue.tryPop(value)) {
+                QThread::yieldCurrentThread();
+                continue;
+            }
+            QCOMPARE(value, expected);
+            ++expected;
+        }
+        QVERIFY(producer->wait(10000));
+        delete producer;
+        QVERIFY(queue.isEmpty());
+    }
+};
+
+QTEST_MAIN(TestSpscQueue)
+#include "tst_spscqueue.moc"
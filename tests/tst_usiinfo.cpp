@@ -0,0 +1,165 @@
+/// @file tst_usiinfo.cpp
+/// @brief UsiInfoParser（型付きinfo行パーサ）のユニットテスト
+
+#include <QtTest>
+
+#include "usiinfo.h"
+
+class TestUsiInfo : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void numericFields_parsedFromStringView()
+    {
+        const QString line = QStringLiteral(
+            "info depth 12 seldepth 18 multipv 2 nodes 123456789012 nps 987654 time 1500 hashfull 345");
+        UsiInfo info;
+        QVERIFY(UsiInfoParser::parse(QStringView(line), info));
+
+        QVERIFY(info.has(UsiInfo::Depth));
+        QCOMPARE(info.depth, 12);
+        QCOMPARE(info.seldepth, 18);
+        QCOMPARE(info.multipv, 2);
+        QCOMPARE(info.nodes, Q_INT64_C(123456789012));
+        QCOMPARE(info.nps, Q_INT64_C(987654));
+        QCOMPARE(info.time, Q_INT64_C(1500));
+        QCOMPARE(info.hashfull, 345);
+        QCOMPARE(info.scoreKind, UsiInfo::ScoreKind::None);
+        QCOMPARE(info.pvLength, 0);
+    }
+
+    void numericFields_parsedFromByteArrayView()
+    {
+        const QByteArray line("info depth 7 nodes 4096 score cp -35 pv 7g7f 3c3d");
+        UsiInfo info;
+        QVERIFY(UsiInfoParser::parse(QByteArrayView(line), info));
+
+        QCOMPARE(info.depth, 7);
+        QCOMPARE(info.nodes, Q_INT64_C(4096));
+        QVERIFY(!info.has(UsiInfo::Seldepth));
+        QVERIFY(!info.has(UsiInfo::Multipv));
+        QCOMPARE(info.multipv, 1);
+        QCOMPARE(info.scoreKind, UsiInfo::ScoreKind::Cp);
+        QCOMPARE(info.scoreValue, -35);
+        QCOMPARE(info.pvUsiString(), QStringLiteral("7g7f 3c3d"));
+    }
+
+    void scoreCp_bounds()
+    {
+        UsiInfo info;
+        QVERIFY(UsiInfoParser::parse(QStringView(u"info score cp 120 lowerbound depth 5"), info));
+        QCOMPARE(info.bound, UsiInfo::Bound::Lower);
+        QCOMPARE(info.depth, 5);
+
+        QVERIFY(UsiInfoParser::parse(QStringView(u"info score cp 80 upperbound"), info));
+        QCOMPARE(info.bound, UsiInfo::Bound::Upper);
+        QCOMPARE(info.scoreValue, 80);
+
+        // 次の行の解析で前の行の値は残らない
+        QVERIFY(UsiInfoParser::parse(QStringView(u"info score cp 10"), info));
+        QCOMPARE(info.bound, UsiInfo::Bound::Exact);
+    }
+
+    void scoreMate_variants()
+    {
+        UsiInfo info;
+        QVERIFY(UsiInfoParser::parse(QStringView(u"info score mate 5"), info));
+        QCOMPARE(info.scoreKind, UsiInfo::ScoreKind::Mate);
+        QCOMPARE(info.scoreValue, 5);
+        QVERIFY(!info.mateDistanceUnknown);
+        QCOMPARE(info.mateText(), QStringLiteral("5"));
+
+        QVERIFY(UsiInfoParser::parse(QStringView(u"info score mate -3"), info));
+        QCOMPARE(info.scoreValue, -3);
+        QCOMPARE(info.mateText(), QStringLiteral("-3"));
+
+        QVERIFY(UsiInfoParser::parse(QStringView(u"info score mate +"), info));
+        QVERIFY(info.mateDistanceUnknown);
+        QCOMPARE(info.scoreValue, 1);
+        QCOMPARE(info.mateText(), QStringLiteral("+"));
+
+        QVERIFY(UsiInfoParser::parse(QStringView(u"info score mate -"), info));
+        QCOMPARE(info.scoreValue, -1);
+        QCOMPARE(info.mateText(), QStringLiteral("-"));
+    }
+
+    void pv_dropsAndPromotions()
+    {
+        UsiInfo info;
+        QVERIFY(UsiInfoParser::parse(QStringView(u"info pv 8h2b+ 3a2b B*4e"), info));
+        QCOMPARE(info.pvLength, 3);
+
+        const quint32 promote = info.pv[0];
+        QCOMPARE(UsiPackedMove::fileFrom(promote), 8);
+        QCOMPARE(UsiPackedMove::rankFrom(promote), 8);
+        QCOMPARE(UsiPackedMove::fileTo(promote), 2);
+        QCOMPARE(UsiPackedMove::rankTo(promote), 2);
+        QVERIFY(UsiPackedMove::isPromotion(promote));
+        QVERIFY(!UsiPackedMove::isDrop(promote));
+
+        const quint32 drop = info.pv[2];
+        QVERIFY(UsiPackedMove::isDrop(drop));
+        QCOMPARE(UsiPackedMove::dropPiece(drop), 'B');
+        QCOMPARE(UsiPackedMove::fileTo(drop), 4);
+        QCOMPARE(UsiPackedMove::rankTo(drop), 5);
+
+        QCOMPARE(info.pvUsiString(), QStringLiteral("8h2b+ 3a2b B*4e"));
+    }
+
+    void parseMove_rejectsMalformed()
+    {
+        QCOMPARE(UsiInfoParser::parseMove(u"7g7f"), UsiPackedMove::pack(7, 7, 7, 6, false));
+        QCOMPARE(UsiInfoParser::parseMove(u"P*5e"), UsiPackedMove::packDrop('P', 5, 5));
+        QCOMPARE(UsiInfoParser::parseMove(u"0a1b"), 0u);
+        QCOMPARE(UsiInfoParser::parseMove(u"7g7j"), 0u);
+        QCOMPARE(UsiInfoParser::parseMove(u"K*5e"), 0u);
+        QCOMPARE(UsiInfoParser::parseMove(u"7g7f="), 0u);
+        QCOMPARE(UsiInfoParser::parseMove(u"resign"), 0u);
+    }
+
+    void pvTail_keptAsRange()
+    {
+        const QString line = QStringLiteral("info depth 3 pv 7g7f 3c3d (57.54%)");
+        UsiInfo info;
+        QVERIFY(UsiInfoParser::parse(QStringView(line), info));
+        QCOMPARE(info.pvLength, 2);
+        QVERIFY(info.pvTailOffset >= 0);
+        QCOMPARE(line.mid(info.pvTailOffset, info.pvTailLength), QStringLiteral("(57.54%)"));
+    }
+
+    void infoString_keptAsRange()
+    {
+        const QString line = QStringLiteral("info string  hello  world");
+        UsiInfo info;
+        QVERIFY(UsiInfoParser::parse(QStringView(line), info));
+        QVERIFY(info.has(UsiInfo::String));
+        QCOMPARE(line.mid(info.stringOffset), QStringLiteral("hello  world"));
+        QCOMPARE(info.pvLength, 0);
+    }
+
+    void pv_truncatedAtCapacity()
+    {
+        QString line = QStringLiteral("info pv");
+        for (int i = 0; i < UsiInfo::kMaxPvMoves + 10; ++i) {
+            line += (i % 2 == 0) ? QStringLiteral(" 5i5h") : QStringLiteral(" 5h5i");
+        }
+        UsiInfo info;
+        QVERIFY(UsiInfoParser::parse(QStringView(line), info));
+        QCOMPARE(info.pvLength, UsiInfo::kMaxPvMoves);
+        QVERIFY(info.pvTruncated);
+        // 残りの読み筋は元の行の位置で取り出せる
+        QCOMPARE(line.mid(info.pvRestOffset).split(QLatin1Char(' ')).size(), 10);
+    }
+
+    void emptyOrUnknown_returnsFalse()
+    {
+        UsiInfo info;
+        QVERIFY(!UsiInfoParser::parse(QStringView(u"info"), info));
+        QVERIFY(!UsiInfoParser::parse(QStringView(u"info depth abc"), info));
+        QVERIFY(!UsiInfoParser::parse(QByteArrayView(""), info));
+    }
+};
+
+QTEST_MAIN(TestUsiInfo)
+#include "tst_usiinfo.moc"
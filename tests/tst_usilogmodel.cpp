@@ -0,0 +1,168 @@
+/// @file tst_usilogmodel.cpp
+/// @brief UsiLogModel（USI通信ログのリングバッファ）と RotatingLogFile のユニットテスト
+
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "rotatinglogfile.h"
+#include "usilogmodel.h"
+
+namespace {
+
+QStringList displayedLines(const UsiLogModel& model)
+{
+    QStringList lines;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        lines.append(model.data(model.index(row), Qt::DisplayRole).toString());
+    }
+    return lines;
+}
+
+} // namespace
+
+class TestUsiLogModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void append_isBatchedUntilFlush()
+    {
+        UsiLogModel model;
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("a"));
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("b"));
+        model.append(UsiLogModel::Source::Engine2, QStringLiteral("c"));
+        model.append(UsiLogModel::Source::Engine2, QString());
+        QCOMPARE(model.rowCount(), 0);
+
+        model.flush();
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(displayedLines(model), (QStringList{"a", "b", "c"}));
+    }
+
+    void append_flushesOnTimer()
+    {
+        UsiLogModel model;
+        QSignalSpy appended(&model, &UsiLogModel::linesAppended);
+
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("x"));
+        QVERIFY(appended.wait(1000));
+        QCOMPARE(model.rowCount(), 1);
+    }
+
+    void capacity_dropsOldestLines()
+    {
+        UsiLogModel model;
+        model.setCapacity(3);
+
+        for (int i = 0; i < 5; ++i) {
+            model.append(UsiLogModel::Source::Engine1, QString::number(i));
+            model.flush();
+        }
+        QCOMPARE(displayedLines(model), (QStringList{"2", "3", "4"}));
+        QCOMPARE(model.droppedLineCount(), qint64(2));
+
+        // 1回で上限を超える分も最新だけ残る
+        for (int i = 5; i < 12; ++i) {
+            model.append(UsiLogModel::Source::Engine2, QString::number(i));
+        }
+        model.flush();
+        QCOMPARE(displayedLines(model), (QStringList{"9", "10", "11"}));
+        QCOMPARE(model.storedLineCount(), 3);
+
+        model.setCapacity(2);
+        QCOMPARE(displayedLines(model), (QStringList{"10", "11"}));
+        model.setCapacity(10);
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("12"));
+        model.flush();
+        QCOMPARE(displayedLines(model), (QStringList{"10", "11", "12"}));
+    }
+
+    void filter_keepsStatusLines()
+    {
+        UsiLogModel model;
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("e1"));
+        model.append(UsiLogModel::Source::Engine2, QStringLiteral("e2"));
+        model.append(UsiLogModel::Source::Status, QStringLiteral("status"));
+        model.flush();
+
+        model.setFilter(UsiLogModel::Filter::Engine2);
+        QCOMPARE(displayedLines(model), (QStringList{"e2", "status"}));
+
+        // 絞り込み中の追加と上限による削除
+        model.setCapacity(3);
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("e1b"));
+        model.append(UsiLogModel::Source::Engine2, QStringLiteral("e2b"));
+        model.flush();
+        QCOMPARE(displayedLines(model), (QStringList{"status", "e2b"}));
+
+        model.setFilter(UsiLogModel::Filter::All);
+        QCOMPARE(displayedLines(model), (QStringList{"status", "e1b", "e2b"}));
+        QCOMPARE(model.data(model.index(1), UsiLogModel::SourceRole).toInt(),
+                 static_cast<int>(UsiLogModel::Source::Engine1));
+    }
+
+    void clear_resetsRows()
+    {
+        UsiLogModel model;
+        model.setCapacity(1);
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("a"));
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("b"));
+        model.flush();
+        QCOMPARE(model.droppedLineCount(), qint64(1));
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("pending"));
+        model.clear();
+        model.flush();
+        QCOMPARE(model.rowCount(), 0);
+        QCOMPARE(model.storedLineCount(), 0);
+        QCOMPARE(model.droppedLineCount(), qint64(0));
+    }
+
+    void spillFile_writesEveryLine()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath(QStringLiteral("logs/usi.log"));
+
+        UsiLogModel model;
+        model.setCapacity(1);
+        QVERIFY(model.setSpillFile(path));
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("usi"));
+        model.append(UsiLogModel::Source::Engine1, QStringLiteral("usiok"));
+        model.flush();
+        QVERIFY(model.setSpillFile(QString()));
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const QList<QByteArray> lines = file.readAll().split('\n');
+        QCOMPARE(lines.size(), 3);
+        QVERIFY(lines.at(0).endsWith(" usi"));
+        QVERIFY(lines.at(1).endsWith(" usiok"));
+    }
+
+    void rotatingLogFile_rotatesGenerations()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath(QStringLiteral("rotate.log"));
+
+        RotatingLogFile log(path, 10, 2);
+        QVERIFY(log.open());
+        QVERIFY(log.append("0123456789\n"));
+        QVERIFY(log.append("abcdefghij\n"));
+        QVERIFY(log.append("ABCDEFGHIJ\n"));
+
+        QVERIFY(QFile::exists(log.backupPath(1)));
+        QVERIFY(QFile::exists(log.backupPath(2)));
+        QVERIFY(!QFile::exists(log.backupPath(3)));
+
+        QFile newest(log.backupPath(1));
+        QVERIFY(newest.open(QIODevice::ReadOnly));
+        QCOMPARE(newest.readAll(), QByteArray("ABCDEFGHIJ\n"));
+    }
+};
+
+QTEST_MAIN(TestUsiLogModel)
+#include "tst_usilogmodel.moc"
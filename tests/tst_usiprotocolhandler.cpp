@@ -353,6 +353,68 @@ private slots:
         QCOMPARE(spyBest.count(), 0);
     }
 
+    void optionCommandsToSend_skipsUnsupportedAndAlreadyApplied()
+    {
+        const QStringList commands = {
+            QStringLiteral("setoption name USI_Hash value 256"),
+            QStringLiteral("setoption name Threads value 4"),
+            QStringLiteral("setoption name EvalDir value eval"),
+            QStringLiteral("setoption name Clear Hash"),
+            QStringLiteral("setoption name Unknown value 1"),
+        };
+        const QSet<QString> reported = {
+            QStringLiteral("USI_Hash"), QStringLiteral("Threads"),
+            QStringLiteral("EvalDir"), QStringLiteral("Clear Hash"),
+        };
+
+        // 初回（送信済みなし）は対応しているものを全て送る
+        QCOMPARE(UsiProtocolHandler::optionCommandsToSend(commands, reported, {}),
+                 commands.mid(0, 4));
+
+        // 再利用時は値が変わったものと button 型だけを送る
+        const QMap<QString, QString> applied = {
+            {QStringLiteral("USI_Hash"), QStringLiteral("setoption name USI_Hash value 256")},
+            {QStringLiteral("Threads"), QStringLiteral("setoption name Threads value 8")},
+            {QStringLiteral("EvalDir"), QStringLiteral("setoption name EvalDir value eval")},
+        };
+        QCOMPARE(UsiProtocolHandler::optionCommandsToSend(commands, reported, applied),
+                 (QStringList{QStringLiteral("setoption name Threads value 4"),
+                              QStringLiteral("setoption name Clear Hash")}));
+    }
+
+    void unrestorableOptions_listsAppliedOptionsOutsideSettings()
+    {
+        const QStringList commands = {QStringLiteral("setoption name USI_Hash value 256")};
+        const QMap<QString, QString> applied = {
+            {QStringLiteral("USI_Hash"), QStringLiteral("setoption name USI_Hash value 512")},
+            {QStringLiteral("MultiPV"), QStringLiteral("setoption name MultiPV value 5")},
+        };
+        QCOMPARE(UsiProtocolHandler::unrestorableOptions(commands, applied),
+                 QStringList{QStringLiteral("MultiPV")});
+        QVERIFY(UsiProtocolHandler::unrestorableOptions(commands, {}).isEmpty());
+    }
+
+    void sendRaw_tracksOptionsAndSearch()
+    {
+        UsiProtocolHandler handler;
+
+        // sendRaw で送った setoption も送信済みとして記録する（button 型は除く）
+        handler.sendRaw(QStringLiteral("setoption name MultiPV value 3"));
+        handler.sendRaw(QStringLiteral("setoption name Clear Hash"));
+        QCOMPARE(handler.appliedOptions(),
+                 (QMap<QString, QString>{
+                     {QStringLiteral("MultiPV"), QStringLiteral("setoption name MultiPV value 3")}}));
+
+        // 探索中のエンジンは stop を送って待たずに返す（bestmove の読み捨てはプールが行う）
+        QVERIFY(handler.prepareForReuse());
+        QVERIFY(!handler.searchOutstanding());
+        handler.sendRaw(QStringLiteral("go infinite"));
+        QVERIFY(handler.prepareForReuse());
+        QVERIFY(handler.searchOutstanding());
+        handler.onDataReceived(QStringLiteral("bestmove 7g7f"));
+        QVERIFY(!handler.searchOutstanding());
+    }
+
     // ================================================================
     // 6. 不正入力への耐性
     // ================================================================